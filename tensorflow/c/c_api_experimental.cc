@@ -764,3 +764,80 @@ void TF_GraphRemoveFunction(TF_Graph* g, const char* func_name,
   tensorflow::mutex_lock l(g->mu);
   status->status = g->graph.mutable_flib_def()->RemoveFunction(func_name);
 }
+
+namespace {
+std::string CallableOutputName(const TF_Output& output) {
+  return tensorflow::strings::StrCat(output.oper->node.name(), ":",
+                                     output.index);
+}
+}  // namespace
+
+int64_t TF_SessionMakeCallable(TF_Session* session,
+                               const TF_Buffer* run_options,
+                               const TF_Output* inputs, int ninputs,
+                               const TF_Output* outputs, int noutputs,
+                               const TF_Operation* const* target_opers,
+                               int ntargets, TF_Status* status) {
+  if (session->extend_before_run &&
+      !tensorflow::ExtendSessionGraphHelper(session, status)) {
+    return 0;
+  }
+  tensorflow::CallableOptions callable_options;
+  if (run_options != nullptr &&
+      !callable_options.mutable_run_options()->ParseFromArray(
+          run_options->data, run_options->length)) {
+    status->status = InvalidArgument("Unparseable RunOptions proto");
+    return 0;
+  }
+  for (int i = 0; i < ninputs; ++i) {
+    callable_options.add_feed(CallableOutputName(inputs[i]));
+  }
+  for (int i = 0; i < noutputs; ++i) {
+    callable_options.add_fetch(CallableOutputName(outputs[i]));
+  }
+  for (int i = 0; i < ntargets; ++i) {
+    callable_options.add_target(target_opers[i]->node.name());
+  }
+  tensorflow::Session::CallableHandle handle = 0;
+  status->status = session->session->MakeCallable(callable_options, &handle);
+  return handle;
+}
+
+void TF_SessionRunCallable(TF_Session* session, int64_t handle,
+                           TF_Tensor* const* input_values, int ninputs,
+                           TF_Tensor** output_values, int noutputs,
+                           TF_Status* status) {
+  for (int i = 0; i < noutputs; ++i) {
+    output_values[i] = nullptr;
+  }
+  std::vector<tensorflow::Tensor> feeds(ninputs);
+  for (int i = 0; i < ninputs; ++i) {
+    status->status = tensorflow::TF_TensorToTensor(input_values[i], &feeds[i]);
+    if (!status->status.ok()) return;
+  }
+  std::vector<tensorflow::Tensor> fetches;
+  status->status =
+      session->session->RunCallable(handle, feeds, &fetches, nullptr);
+  if (!status->status.ok()) return;
+  if (fetches.size() != static_cast<size_t>(noutputs)) {
+    status->status = InvalidArgument("Callable returned ", fetches.size(),
+                                     " outputs, expected ", noutputs);
+    return;
+  }
+  for (int i = 0; i < noutputs; ++i) {
+    output_values[i] =
+        tensorflow::TF_TensorFromTensor(fetches[i], &status->status);
+    if (!status->status.ok()) {
+      for (int j = 0; j <= i; ++j) {
+        TF_DeleteTensor(output_values[j]);
+        output_values[j] = nullptr;
+      }
+      return;
+    }
+  }
+}
+
+void TF_SessionReleaseCallable(TF_Session* session, int64_t handle,
+                               TF_Status* status) {
+  status->status = session->session->ReleaseCallable(handle);
+}
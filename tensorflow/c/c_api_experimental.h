@@ -317,6 +317,31 @@ TF_CAPI_EXPORT extern void TF_GraphRemoveFunction(TF_Graph* g,
                                                   const char* func_name,
                                                   TF_Status* status);
 
+// Creates a callable that runs `session` with the given feeds, fetches and
+// targets, so that the feed and fetch names are resolved and the pruned
+// subgraph is created once instead of on every run. `run_options` may be NULL,
+// otherwise it must contain a serialized RunOptions proto.
+//
+// On success, returns a handle to pass to TF_SessionRunCallable and
+// TF_SessionReleaseCallable. On failure, places an error in `status`.
+TF_CAPI_EXPORT extern int64_t TF_SessionMakeCallable(
+    TF_Session* session, const TF_Buffer* run_options, const TF_Output* inputs,
+    int ninputs, const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets, TF_Status* status);
+
+// Runs the callable `handle` created by TF_SessionMakeCallable.
+// `input_values` and `output_values` are in the order of the `inputs` and
+// `outputs` the callable was created with. On success, the caller owns the
+// tensors placed in `output_values`.
+TF_CAPI_EXPORT extern void TF_SessionRunCallable(
+    TF_Session* session, int64_t handle, TF_Tensor* const* input_values,
+    int ninputs, TF_Tensor** output_values, int noutputs, TF_Status* status);
+
+// Releases the resources of the callable `handle`.
+TF_CAPI_EXPORT extern void TF_SessionReleaseCallable(TF_Session* session,
+                                                     int64_t handle,
+                                                     TF_Status* status);
+
 #ifdef __cplusplus
 } /* end extern "C" */
 #endif
@@ -361,5 +361,53 @@ TEST_F(CApiExperimentalFunctionTest, GraphRemoveNonExistentFunction) {
   TF_DeleteFunction(funcs[0]);
 }
 
+TEST(CAPI_EXPERIMENTAL, SessionRunCallable) {
+  TF_Status* s = TF_NewStatus();
+  TF_Graph* graph = TF_NewGraph();
+  TF_Operation* feed = Placeholder(graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* two = ScalarConst(2, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* add = Add(feed, two, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_SessionOptions* opts = TF_NewSessionOptions();
+  TF_Session* session = TF_NewSession(graph, opts, s);
+  TF_DeleteSessionOptions(opts);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_Output input{feed, 0};
+  TF_Output output{add, 0};
+  const int64_t handle = TF_SessionMakeCallable(
+      session, nullptr, &input, 1, &output, 1, nullptr, 0, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  for (int32_t value : {3, 40}) {
+    TF_Tensor* input_value = Int32Tensor(value);
+    TF_Tensor* output_value = nullptr;
+    TF_SessionRunCallable(session, handle, &input_value, 1, &output_value, 1,
+                          s);
+    TF_DeleteTensor(input_value);
+    ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+    ASSERT_NE(output_value, nullptr);
+    EXPECT_EQ(value + 2, *static_cast<int32_t*>(TF_TensorData(output_value)));
+    TF_DeleteTensor(output_value);
+  }
+
+  TF_SessionReleaseCallable(session, handle, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Tensor* input_value = Int32Tensor(1);
+  TF_Tensor* output_value = nullptr;
+  TF_SessionRunCallable(session, handle, &input_value, 1, &output_value, 1, s);
+  TF_DeleteTensor(input_value);
+  EXPECT_NE(TF_OK, TF_GetCode(s));
+  EXPECT_EQ(output_value, nullptr);
+
+  TF_CloseSession(session, s);
+  TF_DeleteSession(session, s);
+  TF_DeleteGraph(graph);
+  TF_DeleteStatus(s);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -244,6 +244,8 @@ class ImmediateExecutionContext : public AbstractContext {
 
   struct CacheStats {
     int64_t kernel_cache_size;
+    int64_t kernel_cache_hits;
+    int64_t kernel_cache_misses;
     int64_t device_cache_size;
     std::map<std::string, int64_t> func_kernel_cache_entries;
     int64_t local_rendezvous_cache_active_size;
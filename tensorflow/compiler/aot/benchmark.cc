@@ -23,6 +23,8 @@ limitations under the License.
 #include <sys/time.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
@@ -43,6 +45,41 @@ static uint64 NowMicros() {
   return static_cast<uint64>(tv.tv_sec) * 1000000 + tv.tv_usec;
 }
 
+// If `arg` is `--<name>=<value>` with an integer value, stores the value in
+// `value` and returns true.
+static bool ParseInt64Flag(const char* arg, const char* name, int64_t* value) {
+  const size_t name_len = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, name_len) != 0 ||
+      arg[2 + name_len] != '=') {
+    return false;
+  }
+  const char* str = arg + 2 + name_len + 1;
+  char* end = nullptr;
+  const long long parsed = strtoll(str, &end, 10);  // NOLINT
+  if (*str == '\0' || *end != '\0') {
+    return false;
+  }
+  *value = parsed;
+  return true;
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    int64_t num_threads;
+    if (ParseInt64Flag(argv[i], "max_iters", &options->max_iters) ||
+        ParseInt64Flag(argv[i], "max_micros", &options->max_micros)) {
+      continue;
+    }
+    if (ParseInt64Flag(argv[i], "num_threads", &num_threads) &&
+        num_threads > 0) {
+      options->num_threads = num_threads;
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
 void DumpStatsToStdout(const Stats& stats) {
   // Compute stats.
   std::vector<int64_t> sorted_us(stats.per_iter_us);
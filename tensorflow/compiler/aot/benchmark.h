@@ -42,8 +42,14 @@ struct Options {
 
   int64_t max_iters = 0;   // Maximum iterations to run, ignored if <= 0.
   int64_t max_micros = 0;  // Maximum microseconds to run, ignored if <= 0.
+  int num_threads = 1;     // Threads in the intra-op thread pool.
 };
 
+// ParseOptions fills in `options` from the --max_iters=N, --max_micros=N and
+// --num_threads=N flags in `argv`. Returns false on an unknown or malformed
+// flag.
+bool ParseOptions(int argc, char** argv, Options* options);
+
 // Stats holds statistics collected during benchmarking.
 struct Stats {
   std::vector<int64_t> per_iter_us;  // Per-iteration deltas in us.
@@ -40,6 +40,26 @@ TEST(Benchmark, Benchmark) {
   EXPECT_EQ(stats5.per_iter_us.size(), 5);
 }
 
+TEST(Benchmark, ParseOptions) {
+  char arg0[] = "benchmark";
+  char arg1[] = "--max_iters=3";
+  char arg2[] = "--num_threads=4";
+  char* argv[] = {arg0, arg1, arg2};
+  Options options;
+  EXPECT_TRUE(ParseOptions(3, argv, &options));
+  EXPECT_EQ(options.max_iters, 3);
+  EXPECT_EQ(options.max_micros, 0);
+  EXPECT_EQ(options.num_threads, 4);
+
+  char bad_threads[] = "--num_threads=0";
+  char* bad_threads_argv[] = {arg0, bad_threads};
+  EXPECT_FALSE(ParseOptions(2, bad_threads_argv, &options));
+
+  char unknown[] = "--max_iters";
+  char* unknown_argv[] = {arg0, unknown};
+  EXPECT_FALSE(ParseOptions(2, unknown_argv, &options));
+}
+
 }  // namespace
 }  // namespace benchmark
 }  // namespace tfcompile
@@ -21,10 +21,12 @@ limitations under the License.
 #include <utility>
 
 #include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/xla_activity.pb.h"
 #include "tensorflow/compiler/jit/xla_activity_listener.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/status.h"
 #include "tsl/platform/mutex.h"
@@ -65,8 +67,66 @@ constexpr int64_t kDefaultCompilationThreshold = 2;
 // Maximum number of ongoing compilations.
 constexpr int64_t kMaxNumOngoingCompilations = kNumAsyncDeviceCompilerThreads;
 
+// Length of the window the compile time budget applies to.
+constexpr int64_t kCompileTimeBudgetWindowUs = 3600LL * 1000 * 1000;
+
+// Compile time spent by the profilers of all devices in the current hour, so
+// that --tf_xla_compile_time_budget_us_per_hour applies to the whole process.
+class CompileTimeBudget {
+ public:
+  static CompileTimeBudget* Global() {
+    static CompileTimeBudget* budget = new CompileTimeBudget();
+    return budget;
+  }
+
+  // Adds compile time to the current hour if a budget is set.
+  void Charge(int64_t compile_time_us) {
+    if (BudgetUs() <= 0) return;
+    mutex_lock lock(mu_);
+    MaybeStartNewWindowLocked(Env::Default()->NowMicros());
+    window_compile_time_us_ += compile_time_us;
+  }
+
+  // Returns true if the compile time spent in the current hour has reached the
+  // budget.
+  bool Exhausted() {
+    const int64_t budget_us = BudgetUs();
+    if (budget_us <= 0) return false;
+    mutex_lock lock(mu_);
+    MaybeStartNewWindowLocked(Env::Default()->NowMicros());
+    return window_compile_time_us_ >= budget_us;
+  }
+
+  void Reset() {
+    mutex_lock lock(mu_);
+    window_start_us_ = 0;
+    window_compile_time_us_ = 0;
+  }
+
+ private:
+  static int64_t BudgetUs() {
+    return GetXlaOpsCommonFlags()->tf_xla_compile_time_budget_us_per_hour;
+  }
+
+  void MaybeStartNewWindowLocked(int64_t now_us)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (now_us - window_start_us_ >= kCompileTimeBudgetWindowUs) {
+      window_start_us_ = now_us;
+      window_compile_time_us_ = 0;
+    }
+  }
+
+  mutex mu_;
+  int64_t window_start_us_ TF_GUARDED_BY(mu_) = 0;
+  int64_t window_compile_time_us_ TF_GUARDED_BY(mu_) = 0;
+};
+
 }  // namespace
 
+/*static*/ void DeviceCompilationProfiler::ResetCompileTimeBudgetForTest() {
+  CompileTimeBudget::Global()->Reset();
+}
+
 DeviceCompilationProfiler::~DeviceCompilationProfiler() {
   mutex_lock lock(mu_);
   cluster_compile_stats_.clear();
@@ -110,6 +170,7 @@ Status DeviceCompilationProfiler::RegisterCompilation(
   const uint64 compile_time_s = compile_time_us / 1.0e6;
   it->second.compile_count++;
   it->second.cumulative_compile_time_us += compile_time_us;
+  CompileTimeBudget::Global()->Charge(compile_time_us);
   VLOG(1) << "Compiled " << function_name << " " << it->second.compile_count
           << " times, compile time: " << compile_time_us
           << " us, cumulative: " << it->second.cumulative_compile_time_us
@@ -166,6 +227,14 @@ bool DeviceCompilationProfiler::ShouldCompileCluster(
     return false;
   }
 
+  if (CompileTimeBudget::Global()->Exhausted()) {
+    VLOG(2) << "Not compiling cluster " << function.name()
+            << " because the compile time budget of "
+            << GetXlaOpsCommonFlags()->tf_xla_compile_time_budget_us_per_hour
+            << " us per hour is exhausted.";
+    return false;
+  }
+
   // TODO(b/255826209): Figure out if Lazy compilation is still needed given
   // that we always compile a cluster the first time it is executed (explained
   // below) regardless of compilation mode. If it is not, clean up the related
@@ -175,10 +244,11 @@ bool DeviceCompilationProfiler::ShouldCompileCluster(
   // (since they get the benefit of XLA right away without waiting for warmup)
   // and doesn't hurt much for dynamically shaped TensorFlow graphs (we "pay" at
   // most one cluster-compilation's worth of compile time).
-  if (it->second.execution_count == 1) {
-    return true;
-  }
-
+  //
+  // Asynchronous compilations are bounded even for the first execution, so
+  // that a burst of new clusters doesn't queue an unbounded number of
+  // compilations. Clusters that are turned away keep running through the TF
+  // executor and are reconsidered on their next execution.
   if (compile_mode == DeviceCompileMode::kAsync) {
     // Asynchronous compilation is enabled.
     if (num_ongoing_compilations_ >= kMaxNumOngoingCompilations) {
@@ -188,6 +258,10 @@ bool DeviceCompilationProfiler::ShouldCompileCluster(
     }
   }
 
+  if (it->second.execution_count == 1) {
+    return true;
+  }
+
   bool reached_compile_threshold = current_request_count >= *compile_threshold;
   if (!reached_compile_threshold) {
     VLOG(2) << "Not compiling cluster " << function.name()
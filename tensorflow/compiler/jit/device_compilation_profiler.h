@@ -83,6 +83,10 @@ class DeviceCompilationProfiler : public ResourceBase {
   int64_t GetNumOngoingAsyncCompilations() const;
   std::string DebugString() const override;
 
+  // Forgets the compile time charged to the process-wide compile time budget,
+  // so that tests do not depend on each other.
+  static void ResetCompileTimeBudgetForTest();
+
  private:
   mutable mutex mu_;
 
@@ -21,9 +21,11 @@ limitations under the License.
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/tests/device_compiler_test_helper.h"
 #include "tensorflow/compiler/jit/xla_activity.pb.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 
 namespace tensorflow {
 namespace {
@@ -194,13 +196,17 @@ TEST(DeviceCompilationProfilerTest, ShouldCompileClusterAsync) {
     profiler->IncrementOngoingAsyncCompilations();
   }
 
-  // Should allow compilation since this is the first execution.
+  // Should not allow compilation, even though this is the first execution,
+  // since we've already reached the maximum number of ongoing compilations
+  // allowed.
   profiler->RegisterExecution(function);
-  EXPECT_TRUE(
+  EXPECT_FALSE(
       profiler->ShouldCompileCluster(function, DeviceCompileMode::kAsync, 0));
 
-  // Should not allow compilation since this is not the first execution and
-  // we've already reached the maximum number of ongoing compilations allowed.
+  // Lazy compilation isn't bounded and still compiles the first execution.
+  EXPECT_TRUE(
+      profiler->ShouldCompileCluster(function, DeviceCompileMode::kLazy, 0));
+
   profiler->RegisterExecution(function);
   EXPECT_FALSE(
       profiler->ShouldCompileCluster(function, DeviceCompileMode::kAsync, 0));
@@ -239,5 +245,52 @@ TEST(DeviceCompilationProfilerTest, ShouldCompileClusterLazy) {
                                              kDefaultCompilationThreshold));
 }
 
+class DeviceCompilationProfilerBudgetTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    DeviceCompilationProfiler::ResetCompileTimeBudgetForTest();
+  }
+};
+
+TEST_F(DeviceCompilationProfilerBudgetTest,
+       ShouldCompileClusterBudgetExhausted) {
+  XlaOpsCommonFlags* flags = GetXlaOpsCommonFlags();
+  const int64_t old_budget_us = flags->tf_xla_compile_time_budget_us_per_hour;
+  flags->tf_xla_compile_time_budget_us_per_hour = 100;
+  auto restore_flags = gtl::MakeCleanup([flags, old_budget_us] {
+    flags->tf_xla_compile_time_budget_us_per_hour = old_budget_us;
+  });
+
+  DeviceCompilationProfiler* profiler = new DeviceCompilationProfiler();
+  core::ScopedUnref profiler_ref(profiler);
+  // The budget is shared by the profilers of all devices.
+  DeviceCompilationProfiler* other_profiler = new DeviceCompilationProfiler();
+  core::ScopedUnref other_profiler_ref(other_profiler);
+
+  NameAttrList function;
+  function.set_name("TestFunc");
+  NameAttrList other_function;
+  other_function.set_name("OtherTestFunc");
+
+  EXPECT_TRUE(profiler->RegisterCompilation(function, 60, false).ok());
+  EXPECT_TRUE(profiler->ShouldCompileCluster(other_function,
+                                             DeviceCompileMode::kLazy, 0));
+
+  // The budget is exhausted, so only clusters that must be compiled are.
+  EXPECT_TRUE(profiler->RegisterCompilation(function, 60, false).ok());
+  EXPECT_FALSE(profiler->ShouldCompileCluster(other_function,
+                                              DeviceCompileMode::kLazy, 0));
+  EXPECT_FALSE(profiler->ShouldCompileCluster(other_function,
+                                              DeviceCompileMode::kAsync, 0));
+  EXPECT_TRUE(profiler->ShouldCompileCluster(other_function,
+                                             DeviceCompileMode::kStrict, 0));
+  EXPECT_FALSE(other_profiler->ShouldCompileCluster(
+      other_function, DeviceCompileMode::kLazy, 0));
+
+  flags->tf_xla_compile_time_budget_us_per_hour = 0;
+  EXPECT_TRUE(profiler->ShouldCompileCluster(other_function,
+                                             DeviceCompileMode::kLazy, 0));
+}
+
 }  // namespace
 }  // namespace tensorflow
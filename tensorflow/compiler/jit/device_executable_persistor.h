@@ -28,6 +28,7 @@ limitations under the License.
 #include "xla/util.h"
 #include "tensorflow/core/framework/device.h"
 #include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
@@ -271,6 +272,11 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::VerifyLoadedCacheEntry(
   if (entry.executable().empty()) {
     return errors::InvalidArgument("No binary found in serialized entry.");
   }
+  if (entry.executable_fingerprint() != 0 &&
+      entry.executable_fingerprint() != Fingerprint64(entry.executable())) {
+    return errors::InvalidArgument(
+        "Serialized executable does not match its fingerprint.");
+  }
   return absl::OkStatus();
 }
 
@@ -400,6 +406,8 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::TryToPersistExecutable(
   TF_ASSIGN_OR_RETURN(XlaSerializedCacheEntry serialized_entry,
                       SerializeEntry(signature_hash, options,
                                      compilation_result, executable, client));
+  serialized_entry.set_executable_fingerprint(
+      Fingerprint64(serialized_entry.executable()));
   TF_RETURN_IF_ERROR(SaveSerializedEntry(std::move(serialized_entry)));
   return absl::OkStatus();
 }
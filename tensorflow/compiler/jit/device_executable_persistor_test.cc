@@ -577,6 +577,45 @@ TEST_F(DeviceExecutionPersistorTest, LoadSerializedExecutableEmpty) {
               testing::StatusIs(error::INVALID_ARGUMENT));
 }
 
+TEST_F(DeviceExecutionPersistorTest, LoadSerializedExecutableCorrupted) {
+  XlaDeviceExecutablePersistor::Config config(
+      /*persistent_cache_directory=*/cache_dir_,
+      /*disable_strict_signature_checks=*/false,
+      /*persistence_prefix=*/"xla");
+  XlaDeviceExecutablePersistor persistor(config,
+                                         DefaultXlaOptions().device_type);
+
+  MockXlaCompilerClient mock_client;
+  EXPECT_CALL(mock_client, SerializeExecutable(_))
+      .WillOnce(Return(StatusOr<std::string>(serialized_xla_executable_)));
+
+  TF_ASSERT_OK_AND_ASSIGN(auto executable, BuildSampleExecutable());
+  TF_ASSERT_OK(persistor.TryToPersistExecutable(
+      /*signature_hash=*/123, "signature_string", DefaultXlaOptions(),
+      compilation_result_add_, *executable, &mock_client));
+
+  auto key =
+      CreateCacheKey(/*signature_hash=*/123, compilation_result_add_,
+                     persistor.device_type(), persistor.persistence_prefix());
+  TF_ASSERT_OK_AND_ASSIGN(auto entry, ReadCacheEntryFromFile(key, cache_dir_));
+  EXPECT_NE(entry.executable_fingerprint(), 0u);
+
+  // Truncate the executable but keep its fingerprint.
+  entry.mutable_executable()->resize(entry.executable().size() / 2);
+  TF_ASSERT_OK(WriteBinaryProto(
+      Env::Default(), GetFilePath(key, persistor.persistent_cache_directory()),
+      entry));
+
+  auto loaded_executable = persistor.TryToLoadExecutable(
+      /*signature_hash=*/123, "signature", DefaultXlaOptions(),
+      compilation_result_add_, &mock_client);
+
+  EXPECT_TRUE(loaded_executable.has_value());
+  EXPECT_FALSE(loaded_executable->ok());
+  EXPECT_THAT(loaded_executable.value(),
+              testing::StatusIs(error::INVALID_ARGUMENT));
+}
+
 TEST_F(DeviceExecutionPersistorTest, PersistPjRtAndXlaExecutables) {
   // Persist PJRT executable.
   PjRtDeviceExecutablePersistor::Config pjrt_config(
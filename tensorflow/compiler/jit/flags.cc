@@ -108,6 +108,13 @@ void AppendMarkForCompilationPassFlagsInternal(std::vector<Flag>* flag_list) {
       Flag("tf_xla_max_cluster_size",
            &mark_for_compilation_flags->tf_xla_max_cluster_size,
            "Maximum number of operators in an XLA compilation."),
+      Flag("tf_xla_ignore_metadata_ops_in_cluster_size",
+           &mark_for_compilation_flags
+                ->tf_xla_ignore_metadata_ops_in_cluster_size,
+           "If true, operators that only read or rearrange tensor metadata "
+           "(like Shape, Reshape or Squeeze) don't count towards "
+           "tf_xla_min_cluster_size, so that clusters doing no real work are "
+           "not compiled."),
       Flag(
           "tf_xla_ops_to_cluster",
           &mark_for_compilation_flags->tf_xla_ops_to_cluster,
@@ -230,6 +237,8 @@ void AllocateAndParseFlags() {
   mark_for_compilation_flags->tf_xla_min_cluster_size = 4;
   mark_for_compilation_flags->tf_xla_max_cluster_size =
       std::numeric_limits<int32>::max();
+  mark_for_compilation_flags->tf_xla_ignore_metadata_ops_in_cluster_size =
+      false;
   mark_for_compilation_flags->tf_xla_clustering_debug = false;
   mark_for_compilation_flags->tf_xla_cpu_global_jit = false;
   mark_for_compilation_flags->tf_xla_clustering_fuel =
@@ -263,6 +272,7 @@ void AllocateAndParseFlags() {
   ops_flags = new XlaOpsCommonFlags;
   ops_flags->tf_xla_always_defer_compilation = false;
   ops_flags->tf_xla_async_compilation = false;
+  ops_flags->tf_xla_compile_time_budget_us_per_hour = 0;
   ops_flags->tf_xla_use_device_api.enabled_for_xla_launch_ = true;
   ops_flags->tf_xla_use_device_api.enabled_for_compile_on_demand_ = true;
   ops_flags->tf_xla_use_device_api.enabled_for_compile_and_run_ = true;
@@ -335,6 +345,13 @@ void AllocateAndParseFlags() {
             "When lazy compilation is enabled, asynchronous compilation starts "
             "the cluster compilation in the background, and the fallback path "
             "is executed until the compilation has finished."),
+       Flag("tf_xla_compile_time_budget_us_per_hour",
+            &ops_flags->tf_xla_compile_time_budget_us_per_hour,
+            "If positive, lazily or asynchronously compiled clusters are no "
+            "longer compiled, and run in the TF executor instead, once this "
+            "many microseconds have been spent compiling on all devices "
+            "within the current hour. Clusters that must be compiled are not "
+            "affected."),
        Flag("tf_xla_use_device_api_for_xla_launch",
             &ops_flags->tf_xla_use_device_api.enabled_for_xla_launch_,
             "If true, uses Device API (PjRt) for single device compilation and "
@@ -62,6 +62,10 @@ struct MarkForCompilationPassFlags {
   // Maximum number of operators in an XLA compilation.
   int32 tf_xla_max_cluster_size;
 
+  // If true, operators that only read or rearrange tensor metadata (like
+  // Shape, Reshape or Squeeze) don't count towards tf_xla_min_cluster_size.
+  bool tf_xla_ignore_metadata_ops_in_cluster_size;
+
   // If non-empty, limit XLA clustering to the following TF operations.
   string tf_xla_ops_to_cluster;
 
@@ -151,6 +155,10 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile compiles the cluster asynchronously with respect to
   // the main execution. The fallback path is taken while compilation happens.
   bool tf_xla_async_compilation;
+  // If positive, clusters that may fall back to the TF executor are not
+  // compiled once the process has spent this many microseconds compiling, on
+  // all devices, within the current hour. Defaults to 0, i.e. no budget.
+  int64_t tf_xla_compile_time_budget_us_per_hour;
 
   class PjRtForSingleDeviceCompilationRollout {
    public:
@@ -92,6 +92,15 @@ using jit::DeviceSet;
 // cluster.
 const char* kXlaAlreadyClustered = "_XlaAlreadyClustered";
 
+// Returns true if `node` only reads or rearranges tensor metadata, so that
+// compiling it with XLA does not save any work.
+bool IsMetadataOp(const Node& node) {
+  static const auto* metadata_ops = new absl::flat_hash_set<string>(
+      {"ExpandDims", "NoOp", "PreventGradient", "Reshape", "ShapeN", "Snapshot",
+       "Squeeze", "StopGradient"});
+  return IsShapeConsumerOp(node) || metadata_ops->contains(node.type_string());
+}
+
 class MarkForCompilationPassImpl {
  public:
   struct DebugOptions {
@@ -112,6 +121,9 @@ class MarkForCompilationPassImpl {
     int max_cluster_size;
     int min_cluster_size;
 
+    // If true, metadata ops don't count towards min_cluster_size.
+    bool ignore_metadata_ops_in_cluster_size;
+
     // Compiler fuel for the auto-clustering algorithm.
     //
     // We decrement this value by one on every time we choose a compilation
@@ -1135,9 +1147,13 @@ Status MarkForCompilationPassImpl::BuildInitialClusterSet() {
     // optimizations offsets XLA related overhead (for instance we add some
     // Switch/Merge nodes into the graph to implement lazy compilation).  To
     // this end, we don't count Identity and Constant nodes because they do not
-    // enable interesting optimizations by themselves.
-    int effective_cluster_size =
-        (node->IsIdentity() || node->IsConstant()) ? 0 : 1;
+    // enable interesting optimizations by themselves.  Optionally the same goes
+    // for ops that only read or rearrange tensor metadata.
+    bool is_trivial =
+        node->IsIdentity() || node->IsConstant() ||
+        (debug_options_.ignore_metadata_ops_in_cluster_size &&
+         IsMetadataOp(*node));
+    int effective_cluster_size = is_trivial ? 0 : 1;
 
     bool has_functional_control_flow = node->IsWhileNode() || node->IsIfNode();
 
@@ -1922,6 +1938,8 @@ Status MarkForCompilationPass::Run(
       flags->tf_xla_deterministic_cluster_names;
   debug_options.max_cluster_size = flags->tf_xla_max_cluster_size;
   debug_options.min_cluster_size = flags->tf_xla_min_cluster_size;
+  debug_options.ignore_metadata_ops_in_cluster_size =
+      flags->tf_xla_ignore_metadata_ops_in_cluster_size;
   debug_options.fuel = GetPointerToFuel(flags->tf_xla_clustering_fuel);
   debug_options.dump_graphs = flags->tf_xla_clustering_debug;
 
@@ -1941,6 +1959,8 @@ Status MarkForCompilationPass::RunForTest(
   debug_options.deterministic_cluster_names = deterministic_cluster_names;
   debug_options.max_cluster_size = flags->tf_xla_max_cluster_size;
   debug_options.min_cluster_size = flags->tf_xla_min_cluster_size;
+  debug_options.ignore_metadata_ops_in_cluster_size =
+      flags->tf_xla_ignore_metadata_ops_in_cluster_size;
   debug_options.fuel = GetPointerToFuel(flags->tf_xla_clustering_fuel);
   debug_options.dump_graphs = flags->tf_xla_clustering_debug;
 
@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/sendrecv_ops.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/compiler/jit/defs.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/mark_for_compilation_pass_test_helper.h"
 #include "tensorflow/compiler/jit/node_matchers.h"
 #include "tensorflow/compiler/jit/xla_cluster_util.h"
@@ -51,6 +52,7 @@ limitations under the License.
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph_def_builder.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -1638,6 +1640,37 @@ TEST(XlaCompilationTest, ClusterShapeConsumerWithProducerAndConsumer) {
   EXPECT_EQ(clusters["test/y"], clusters["test/z"]);
 }
 
+TEST(XlaCompilationTest, IgnoreMetadataOpsInClusterSize) {
+  auto build_graph = [](std::unique_ptr<Graph>* graph) {
+    Scope root = Scope::NewRootScope().ExitOnError();
+    Output a = ops::Placeholder(root.WithOpName("test/a"), DT_FLOAT);
+    Output shape = ops::Const(root.WithOpName("test/shape"), {2, 3});
+    Output axis = ops::Const(root.WithOpName("test/axis"), 0);
+    Output x = ops::Reshape(root.WithOpName("test/x"), a, shape);
+    Output y = ops::ExpandDims(root.WithOpName("test/y"), x, axis);
+    graph->reset(new Graph(OpRegistry::Global()));
+    return root.ToGraph(graph->get());
+  };
+
+  std::unique_ptr<Graph> graph;
+  TF_ASSERT_OK(build_graph(&graph));
+  TF_ASSERT_OK(MarkForCompilationPassTestHelper::MarkForCompilation(&graph));
+  std::unordered_map<string, string> clusters = GetClusters(*graph);
+  EXPECT_NE(clusters["test/x"], "");
+  EXPECT_EQ(clusters["test/x"], clusters["test/y"]);
+
+  // Reshape and ExpandDims do no real work, so the cluster is too small.
+  MarkForCompilationPassFlags* flags = GetMarkForCompilationPassFlags();
+  flags->tf_xla_ignore_metadata_ops_in_cluster_size = true;
+  auto restore_flags = gtl::MakeCleanup([flags] {
+    flags->tf_xla_ignore_metadata_ops_in_cluster_size = false;
+  });
+
+  TF_ASSERT_OK(build_graph(&graph));
+  TF_ASSERT_OK(MarkForCompilationPassTestHelper::MarkForCompilation(&graph));
+  EXPECT_TRUE(GetClusters(*graph).empty());
+}
+
 void AddCtrlEdge(const Scope& scope, Operation a, Operation b) {
   scope.graph()->AddControlEdge(a.node(), b.node());
 }
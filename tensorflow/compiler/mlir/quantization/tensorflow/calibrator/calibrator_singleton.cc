@@ -49,63 +49,52 @@ void CalibratorSingleton::ClearCollectedInformation() {
 }
 
 void CalibratorSingleton::ClearData(absl::string_view id) {
-  absl::MutexLock lock(&lock_);
-
-  CalibratorSingleton& instance = GetInstance();
+  std::shared_ptr<CollectorEntry> entry = GetOrCreateEntry(id);
 
-  const std::string id_str{id};
-  instance.id_to_collector_[id_str].reset(nullptr);
+  absl::MutexLock lock(&entry->mu);
+  entry->collector.reset(nullptr);
 }
 
 void CalibratorSingleton::Report(absl::string_view id,
                                  absl::Span<float> data_span,
                                  const CalibrationOptions& calib_opts) {
-  absl::MutexLock lock(&lock_);
-
-  CalibratorSingleton& instance = GetInstance();
+  std::shared_ptr<CollectorEntry> entry = GetOrCreateEntry(id);
 
-  const std::string id_str{id};
-  AssignIfNotExists(id_str, calib_opts);
-  instance.id_to_collector_[id_str]->Collect(data_span);
+  absl::MutexLock lock(&entry->mu);
+  AssignIfNotExists(*entry, calib_opts);
+  entry->collector->Collect(data_span);
 }
 
 void CalibratorSingleton::Report(absl::string_view id,
                                  const std::vector<float>& data_vec,
                                  const CalibrationOptions& calib_opts) {
-  absl::MutexLock lock(&lock_);
-
-  CalibratorSingleton& instance = GetInstance();
+  std::shared_ptr<CollectorEntry> entry = GetOrCreateEntry(id);
 
-  const std::string id_str{id};
-  AssignIfNotExists(id_str, calib_opts);
-  instance.id_to_collector_[id_str]->Collect(data_vec);
+  absl::MutexLock lock(&entry->mu);
+  AssignIfNotExists(*entry, calib_opts);
+  entry->collector->Collect(data_vec);
 }
 
 void CalibratorSingleton::Report(absl::string_view id,
                                  const Tensor& data_tensor,
                                  const CalibrationOptions& calib_opts) {
-  absl::MutexLock lock(&lock_);
-
-  CalibratorSingleton& instance = GetInstance();
+  std::shared_ptr<CollectorEntry> entry = GetOrCreateEntry(id);
 
-  const std::string id_str{id};
-  AssignIfNotExists(id_str, calib_opts);
-  instance.id_to_collector_[id_str]->Collect(data_tensor);
+  absl::MutexLock lock(&entry->mu);
+  AssignIfNotExists(*entry, calib_opts);
+  entry->collector->Collect(data_tensor);
 }
 
 std::optional<CalibrationStatistics> CalibratorSingleton::GetStatistics(
     absl::string_view id) {
-  absl::MutexLock lock(&lock_);
-
-  CalibratorSingleton& instance = GetInstance();
+  std::shared_ptr<CollectorEntry> entry = GetOrCreateEntry(id);
 
-  const std::string id_str{id};
-
-  if (!instance.id_to_collector_[id_str]) {
+  absl::MutexLock lock(&entry->mu);
+  if (!entry->collector) {
     return std::nullopt;
   }
 
-  return instance.id_to_collector_[id_str]->GetStatistics();
+  return entry->collector->GetStatistics();
 }
 
 int64_t CalibratorSingleton::IssueNewId() {
@@ -113,30 +102,42 @@ int64_t CalibratorSingleton::IssueNewId() {
   return instance.next_id_++;
 }
 
-void CalibratorSingleton::AssignIfNotExists(
-    std::string id_str, const CalibrationOptions& calib_opts) {
+std::shared_ptr<CalibratorSingleton::CollectorEntry>
+CalibratorSingleton::GetOrCreateEntry(absl::string_view id) {
+  absl::MutexLock lock(&lock_);
+
   CalibratorSingleton& instance = GetInstance();
 
-  if (!instance.id_to_collector_[id_str]) {
+  std::shared_ptr<CollectorEntry>& entry =
+      instance.id_to_collector_[std::string(id)];
+  if (!entry) {
+    entry = std::make_shared<CollectorEntry>();
+  }
+  return entry;
+}
+
+void CalibratorSingleton::AssignIfNotExists(
+    CollectorEntry& entry, const CalibrationOptions& calib_opts) {
+  if (!entry.collector) {
     CalibrationOptions::CalibrationMethod calib_method =
         calib_opts.calibration_method();
 
     switch (calib_method) {
       case CalibrationOptions::CALIBRATION_METHOD_AVERAGE_MIN_MAX:
-        instance.id_to_collector_[id_str] =
+        entry.collector =
             std::make_unique<CalibrationStatisticsCollectorAverageMinMax>();
         break;
       case CalibrationOptions::CALIBRATION_METHOD_HISTOGRAM_PERCENTILE:
       case CalibrationOptions::CALIBRATION_METHOD_HISTOGRAM_MSE_BRUTEFORCE:
       case CalibrationOptions::CALIBRATION_METHOD_HISTOGRAM_MSE_SYMMETRIC:
       case CalibrationOptions::CALIBRATION_METHOD_HISTOGRAM_MSE_MAX_FREQUENCY:
-        instance.id_to_collector_[id_str] =
+        entry.collector =
             std::make_unique<CalibrationStatisticsCollectorHistogram>(
                 calib_opts);
         break;
       case CalibrationOptions::CALIBRATION_METHOD_MIN_MAX:
       default:
-        instance.id_to_collector_[id_str] =
+        entry.collector =
             std::make_unique<CalibrationStatisticsCollectorMinMax>();
     }
   }
@@ -22,6 +22,7 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
@@ -74,16 +75,33 @@ class CalibratorSingleton {
 
  private:
   static CalibratorSingleton& GetInstance();
+  // Guards `id_to_collector_`, but not the collectors themselves, so that the
+  // aggregators of different ids can report concurrently.
   static absl::Mutex lock_;
-  static void AssignIfNotExists(std::string id_str,
-                                const CalibrationOptions& calib_opts);
+
+  // Collects the statistics of one id.
+  struct CollectorEntry {
+    absl::Mutex mu;
+    std::unique_ptr<CalibrationStatisticsCollectorBase> collector
+        ABSL_GUARDED_BY(mu);
+  };
+
+  // Returns the entry of `id`, creating an empty one if needed. The entry
+  // stays valid after it is removed from `id_to_collector_`.
+  static std::shared_ptr<CollectorEntry> GetOrCreateEntry(
+      absl::string_view id);
+
+  // Creates the collector of `entry` for the calibration method of
+  // `calib_opts` if it has none.
+  static void AssignIfNotExists(CollectorEntry& entry,
+                                const CalibrationOptions& calib_opts)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(entry.mu);
 
   // Indicates the next id for a set of calibration statistics. For every new ID
   // issued this will be incremented atomically.
   std::atomic<int64_t> next_id_{0};
 
-  absl::flat_hash_map<std::string,
-                      std::unique_ptr<CalibrationStatisticsCollectorBase>>
+  absl::flat_hash_map<std::string, std::shared_ptr<CollectorEntry>>
       id_to_collector_;
 
   CalibratorSingleton() = default;
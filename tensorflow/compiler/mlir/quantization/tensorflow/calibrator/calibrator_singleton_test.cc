@@ -16,6 +16,8 @@ limitations under the License.
 
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -202,6 +204,41 @@ TEST(CalibratorSingletonTest, SimpleAverageMinMax) {
   EXPECT_EQ(statistics.value().average_min_max_statistics().num_samples(), 3);
 }
 
+TEST(CalibratorSingletonTest, ConcurrentReports) {
+  CalibrationOptions calib_opts;
+  calib_opts.set_calibration_method(
+      CalibrationOptions::CALIBRATION_METHOD_AVERAGE_MIN_MAX);
+  constexpr int kNumThreadsPerId = 4;
+  constexpr int kNumReportsPerThread = 100;
+
+  std::vector<std::thread> threads;
+  for (const std::string id : {"8", "9"}) {
+    for (int i = 0; i < kNumThreadsPerId; ++i) {
+      threads.emplace_back([&calib_opts, id, i] {
+        const std::vector<float> data_vec = {-1.0f * i, 1.0f * i};
+        for (int j = 0; j < kNumReportsPerThread; ++j) {
+          CalibratorSingleton::Report(id, data_vec, calib_opts);
+        }
+      });
+    }
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (const std::string id : {"8", "9"}) {
+    std::optional<CalibrationStatistics> statistics =
+        CalibratorSingleton::GetStatistics(id);
+
+    ASSERT_TRUE(statistics.has_value());
+    EXPECT_EQ(statistics.value().average_min_max_statistics().num_samples(),
+              kNumThreadsPerId * kNumReportsPerThread);
+    // Sum of i in [0, kNumThreadsPerId) for each report of each thread.
+    EXPECT_EQ(statistics.value().average_min_max_statistics().max_sum(),
+              6.0f * kNumReportsPerThread);
+  }
+}
+
 TEST(CalibratorSingletonTest, IssueNewIdGeneratesNewId) {
   const int64_t id = CalibratorSingleton::IssueNewId();
   const int64_t next_id = CalibratorSingleton::IssueNewId();
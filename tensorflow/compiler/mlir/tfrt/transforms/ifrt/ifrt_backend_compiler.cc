@@ -42,6 +42,7 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tf2xla/api/v2/cluster_tf.h"
 #include "tensorflow/compiler/mlir/tfrt/transforms/ifrt/tf_ifrt_passes.h"
 #include "tensorflow/compiler/mlir/tfrt/transforms/tpu_passes.h"
+#include "tensorflow/core/tfrt/ifrt/ifrt_config.pb.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_executable_registry.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_model_context.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_serving_executable.h"
@@ -94,6 +95,15 @@ CompileAndRegisterIfrtPrograms(absl::string_view model_name,
         &ifrt_model_context.GetThreadPoolDevice(),
         &ifrt_model_context.GetLoadedVariableRegistry(),
         ifrt_model_context.GetShapeRepresentationFn());
+    if (const ShapeBucketingConfigProto* shape_bucketing_config =
+            ifrt_model_context.GetShapeBucketingConfig(absl::string_view(
+                entry_function_name.data(), entry_function_name.size()))) {
+      TF_ASSIGN_OR_RETURN(
+          IfrtServingExecutable::ShapeBucketing shape_bucketing,
+          IfrtServingExecutable::ShapeBucketing::FromProto(
+              *shape_bucketing_config));
+      executable->set_shape_bucketing(std::move(shape_bucketing));
+    }
 
     // Register the Ifrt program to `ServingExecutableRegistry` so that
     // the client TF program can invoke them via `IfrtCall` op.
@@ -161,6 +161,13 @@ struct TfrtCompileOptions {
 
   // Serialized BEF file under aot_packages.
   std::string aot_bef_file;
+
+  // If true, MLRT bytecode will be serialized to aot_packages, along with the
+  // fingerprint of the SavedModel it was compiled from.
+  bool serialize_mlrt_bytecode_to_aot_packages = false;
+
+  // Serialized MLRT bytecode file under aot_packages.
+  std::string aot_mlrt_bytecode_file;
 };
 
 std::ostream& operator<<(std::ostream& os, const TfrtCompileOptions& options);
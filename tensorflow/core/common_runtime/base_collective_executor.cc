@@ -19,11 +19,13 @@ limitations under the License.
 #include <utility>
 
 #include "tensorflow/core/common_runtime/copy_tensor.h"
+#include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
@@ -33,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/tracing.h"
@@ -40,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/connected_traceme.h"
 #include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/core/util/env_var.h"
 
 #define VALUE_IN_DEBUG_STRING false
 
@@ -252,6 +256,8 @@ void BaseCollectiveExecutor::StartAbort(const Status& s) {
   if (cem_->GetNcclCommunicator() != nullptr) {
     cem_->GetNcclCommunicator()->StartAbort(status);
   }
+  LaunchAllPending();
+  FailPendingBuckets(status);
 }
 
 Status BaseCollectiveExecutor::GetStatus(const Status& s) {
@@ -269,10 +275,106 @@ Status BaseCollectiveExecutor::GetStatus(const Status& s) {
   return s;
 }
 
+/*static*/
+int64_t BaseCollectiveExecutor::MaxCollectivesInFlightFromEnv() {
+  int64_t value;
+  Status status = ReadInt64FromEnvVar("TF_COLLECTIVE_MAX_IN_FLIGHT", 0, &value);
+  if (!status.ok() || value < 0) {
+    LOG(ERROR) << "Invalid TF_COLLECTIVE_MAX_IN_FLIGHT, collectives in "
+                  "flight are unbounded: "
+               << status;
+    return 0;
+  }
+  return value;
+}
+
+void BaseCollectiveExecutor::LaunchWhenSlotAvailable(
+    const string& device, const CollectiveParams& col_params,
+    std::function<void()> launch) {
+  if (max_in_flight_ == 0) {
+    launch();
+    return;
+  }
+  {
+    mutex_lock l(in_flight_mu_);
+    LaunchQueue& queue = launch_queues_[device];
+    if (queue.num_in_flight >= max_in_flight_) {
+      VLOG(2) << "Collective " << col_params.name << " with priority "
+              << col_params.priority << " waits behind "
+              << queue.num_in_flight << " collectives on " << device;
+      queue.pending.push_back({col_params.priority, next_launch_seq_++,
+                               Env::Default()->NowMicros(),
+                               col_params.instance.impl_details.collective_name,
+                               std::move(launch)});
+      std::push_heap(queue.pending.begin(), queue.pending.end());
+      return;
+    }
+    ++queue.num_in_flight;
+  }
+  metrics::RecordCollectiveLaunchWait(
+      col_params.instance.impl_details.collective_name, 0);
+  launch();
+}
+
+void BaseCollectiveExecutor::ReleaseLaunchSlot(const string& device) {
+  if (max_in_flight_ == 0) return;
+  PendingLaunch next;
+  {
+    mutex_lock l(in_flight_mu_);
+    LaunchQueue& queue = launch_queues_[device];
+    if (queue.pending.empty()) {
+      --queue.num_in_flight;
+      return;
+    }
+    // The slot passes to the next collective.
+    std::pop_heap(queue.pending.begin(), queue.pending.end());
+    next = std::move(queue.pending.back());
+    queue.pending.pop_back();
+  }
+  metrics::RecordCollectiveLaunchWait(
+      next.collective_name, Env::Default()->NowMicros() - next.enqueue_micros);
+  next.launch();
+}
+
+void BaseCollectiveExecutor::LaunchAllPending() {
+  std::vector<std::function<void()>> launches;
+  {
+    mutex_lock l(in_flight_mu_);
+    for (auto& device_and_queue : launch_queues_) {
+      LaunchQueue& queue = device_and_queue.second;
+      for (PendingLaunch& pending : queue.pending) {
+        launches.push_back(std::move(pending.launch));
+      }
+      queue.num_in_flight += queue.pending.size();
+      queue.pending.clear();
+    }
+  }
+  for (auto& launch : launches) launch();
+}
+
 void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
                                           const CollectiveParams* col_params,
                                           const string& exec_key,
                                           StatusCallback done) {
+  Tensor* output = ctx->mutable_output(0);
+  const Tensor* input =
+      (col_params->instance.type == REDUCTION_COLLECTIVE ||
+       col_params->instance.type == GATHER_COLLECTIVE ||
+       col_params->instance.type == PERMUTE_COLLECTIVE ||
+       col_params->instance.type == ALL_TO_ALL_COLLECTIVE ||
+       col_params->instance.type == REDUCE_SCATTER_COLLECTIVE ||
+       (col_params->instance.type == BROADCAST_COLLECTIVE &&
+        col_params->is_source))
+          ? &ctx->input(0)
+          : nullptr;
+  ExecuteAsync(ctx, col_params, exec_key, input, output, std::move(done));
+}
+
+void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
+                                          const CollectiveParams* col_params,
+                                          const string& exec_key,
+                                          const Tensor* input, Tensor* output,
+                                          StatusCallback done) {
   // See CompleteParamsAsync() how done() and the timeout callback interacts.
   const auto is_callback_called = std::make_shared<std::atomic<bool>>(false);
   auto done_safe = [this, done, ctx, is_callback_called](const Status& s) {
@@ -302,17 +404,6 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
         });
   }
 
-  Tensor* output = ctx->mutable_output(0);
-  const Tensor* input =
-      (col_params->instance.type == REDUCTION_COLLECTIVE ||
-       col_params->instance.type == GATHER_COLLECTIVE ||
-       col_params->instance.type == PERMUTE_COLLECTIVE ||
-       col_params->instance.type == ALL_TO_ALL_COLLECTIVE ||
-       col_params->instance.type == REDUCE_SCATTER_COLLECTIVE ||
-       (col_params->instance.type == BROADCAST_COLLECTIVE &&
-        col_params->is_source))
-          ? &ctx->input(0)
-          : nullptr;
   CollectiveImplementationInterface* col_impl = nullptr;
   Status status = CreateCollective(*col_params, &col_impl);
   if (!status.ok()) {
@@ -333,29 +424,37 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
   // starve executor threads.
   col_impl->Ref();
   profiler::TraceMeProducer producer("BaseCollectiveExecutor::ExecuteAsync");
-  RunClosure([col_impl, col_ctx, done_safe, ctx,
-              context_id = producer.GetContextId()]() {
-    core::ScopedUnref unref(col_impl);
-    profiler::TraceMeConsumer consumer(
-        [ctx, col_ctx] {
-          string op = profiler::TraceMeOp(ctx->op_kernel().name_view(),
-                                          ctx->op_kernel().type_string_view());
-          return profiler::TraceMeEncode(
-              std::move(op),
-              {{"step_id", ctx->step_id()},
-               {"iter_id", ctx->frame_iter().iter_id},
-               {"frame_id", ctx->frame_iter().frame_id},
-               {"instance_key", col_ctx->col_params->instance.instance_key},
-               {"group_key", col_ctx->col_params->group.group_key},
-               {"collective", col_ctx->col_params->instance.type}});
-        },
-        context_id);
-    col_impl->Ref();
-    col_impl->Run([col_impl, col_ctx, done_safe](const Status& s) {
+  const string device = ctx->device()->name();
+  auto launch = [this, col_impl, col_ctx, device,
+                 done_safe = std::move(done_safe), ctx,
+                 context_id = producer.GetContextId()]() {
+    RunClosure([this, col_impl, col_ctx, device, done_safe, ctx, context_id]() {
       core::ScopedUnref unref(col_impl);
-      done_safe(s);
+      profiler::TraceMeConsumer consumer(
+          [ctx, col_ctx] {
+            string op = profiler::TraceMeOp(
+                ctx->op_kernel().name_view(),
+                ctx->op_kernel().type_string_view());
+            return profiler::TraceMeEncode(
+                std::move(op),
+                {{"step_id", ctx->step_id()},
+                 {"iter_id", ctx->frame_iter().iter_id},
+                 {"frame_id", ctx->frame_iter().frame_id},
+                 {"instance_key", col_ctx->col_params->instance.instance_key},
+                 {"group_key", col_ctx->col_params->group.group_key},
+                 {"collective", col_ctx->col_params->instance.type}});
+          },
+          context_id);
+      col_impl->Ref();
+      col_impl->Run(
+          [this, col_impl, col_ctx, device, done_safe](const Status& s) {
+            core::ScopedUnref unref(col_impl);
+            ReleaseLaunchSlot(device);
+            done_safe(s);
+          });
     });
-  });
+  };
+  LaunchWhenSlotAvailable(device, *col_params, std::move(launch));
 }
 
 void BaseCollectiveExecutor::CompleteParamsAsync(
@@ -407,6 +506,269 @@ void BaseCollectiveExecutor::CompleteParamsAsync(
                                                 done_safe);
 }
 
+void BaseCollectiveExecutor::ExecuteBucketedAsync(OpKernelContext* ctx,
+                                                  CollectiveParams* col_params,
+                                                  const string& bucket,
+                                                  int bucket_size,
+                                                  StatusCallback done) {
+  if (col_params->instance.type != REDUCTION_COLLECTIVE) {
+    done(errors::InvalidArgument("Only reductions can be bucketed, but ",
+                                 col_params->name, " is not one"));
+    return;
+  }
+  // Concurrent calls of the function containing the reductions fill separate
+  // buckets.
+  const string key = strings::StrCat(
+      bucket, ":", ctx->device()->name(), ":",
+      reinterpret_cast<uintptr_t>(ctx->call_frame()), ":",
+      ctx->frame_iter().frame_id, ":", ctx->frame_iter().iter_id);
+  CancellationManager* cancel_mgr = ctx->cancellation_manager();
+  BucketMember member{ctx, col_params, std::move(done), cancel_mgr};
+  Status status;
+  std::vector<BucketMember> members;
+  {
+    mutex_lock l(bucket_mu_);
+    {
+      // The members that are pending when the executor is aborted are failed
+      // by StartAbort(), and later ones are failed here.
+      mutex_lock status_lock(status_mu_);
+      status = status_;
+    }
+    if (status.ok() && cancel_mgr != nullptr) {
+      // A cancelled member can never be reduced, so it fails its whole
+      // bucket.
+      member.cancel_token = cancel_mgr->get_cancellation_token();
+      if (!cancel_mgr->RegisterCallback(member.cancel_token,
+                                        [this, key]() { CancelBucket(key); })) {
+        status = errors::Cancelled("Collective ", col_params->name,
+                                   " was cancelled");
+      }
+    }
+    if (status.ok()) {
+      std::vector<BucketMember>& pending = pending_buckets_[key];
+      pending.push_back(std::move(member));
+      if (pending.size() < static_cast<size_t>(bucket_size)) return;
+      members = std::move(pending);
+      pending_buckets_.erase(key);
+    }
+  }
+  if (!status.ok()) {
+    member.done(status);
+    return;
+  }
+  for (BucketMember& launched : members) {
+    if (launched.cancel_mgr != nullptr) {
+      // If the step is being cancelled, CancelBucket() finds nothing to
+      // cancel, and the fused reduction is cancelled instead.
+      launched.cancel_mgr->TryDeregisterCallback(launched.cancel_token);
+    }
+  }
+  VLOG(1) << "Launching bucket " << key << " of " << members.size()
+          << " reductions";
+  // Copying the inputs blocks.
+  RunClosure([this, members = std::move(members)]() mutable {
+    LaunchBucket(std::move(members));
+  });
+}
+
+void BaseCollectiveExecutor::CancelBucket(const string& key) {
+  std::vector<BucketMember> members;
+  {
+    mutex_lock l(bucket_mu_);
+    auto it = pending_buckets_.find(key);
+    if (it == pending_buckets_.end()) return;
+    members = std::move(it->second);
+    pending_buckets_.erase(it);
+  }
+  FailBucketMembers(
+      std::move(members),
+      errors::Cancelled("Bucket ", key,
+                        " was cancelled before all of its reductions were "
+                        "issued"));
+}
+
+void BaseCollectiveExecutor::FailPendingBuckets(const Status& s) {
+  std::vector<BucketMember> members;
+  {
+    mutex_lock l(bucket_mu_);
+    for (auto& bucket : pending_buckets_) {
+      for (BucketMember& member : bucket.second) {
+        members.push_back(std::move(member));
+      }
+    }
+    pending_buckets_.clear();
+  }
+  FailBucketMembers(std::move(members), s);
+}
+
+void BaseCollectiveExecutor::FailBucketMembers(
+    std::vector<BucketMember> members, const Status& s) {
+  for (BucketMember& member : members) {
+    // This may run in a cancellation callback of the same manager, during
+    // which callbacks cannot be deregistered without blocking.
+    if (member.cancel_mgr != nullptr) {
+      member.cancel_mgr->TryDeregisterCallback(member.cancel_token);
+    }
+    member.done(s);
+  }
+}
+
+void BaseCollectiveExecutor::LaunchBucket(std::vector<BucketMember> members) {
+  std::sort(members.begin(), members.end(),
+            [](const BucketMember& a, const BucketMember& b) {
+              return a.col_params->instance.instance_key <
+                     b.col_params->instance.instance_key;
+            });
+  auto members_done = std::make_shared<std::vector<BucketMember>>(
+      std::move(members));
+  auto fail = [members_done](const Status& s) {
+    for (BucketMember& member : *members_done) member.done(s);
+  };
+  auto op_type = [](const OpKernel* op) {
+    return op == nullptr ? string() : op->type_string();
+  };
+
+  // All reductions of a bucket must be reducible together.
+  const BucketMember& leader = members_done->front();
+  const CollectiveParams& leader_cp = *leader.col_params;
+  const DataType dtype = leader_cp.instance.data_type;
+  for (int i = 1; i < members_done->size(); ++i) {
+    const CollectiveParams& cp = *(*members_done)[i].col_params;
+    if (cp.group.group_key != leader_cp.group.group_key ||
+        cp.group.group_size != leader_cp.group.group_size ||
+        cp.instance.data_type != dtype ||
+        op_type(cp.merge_op) != op_type(leader_cp.merge_op) ||
+        op_type(cp.final_op) != op_type(leader_cp.final_op) ||
+        cp.instance.instance_key ==
+            (*members_done)[i - 1].col_params->instance.instance_key) {
+      fail(errors::InvalidArgument(
+          "Collectives ", leader_cp.name, " and ", cp.name,
+          " cannot be bucketed together: they must have the same group, "
+          "dtype and reduction ops, and distinct instance keys"));
+      return;
+    }
+  }
+  const int64_t elt_bytes = DataTypeSize(dtype);
+  if (elt_bytes == 0) {
+    fail(errors::InvalidArgument("Cannot bucket collectives of type ",
+                                 DataTypeString(dtype)));
+    return;
+  }
+
+  // Pack the inputs at aligned offsets so that each output can alias its part
+  // of the reduced tensor.
+  const int64_t align_elts = EIGEN_MAX_ALIGN_BYTES > elt_bytes
+                                 ? EIGEN_MAX_ALIGN_BYTES / elt_bytes
+                                 : 1;
+  auto offsets = std::make_shared<std::vector<int64_t>>();
+  int64_t total_elts = 0;
+  for (const BucketMember& member : *members_done) {
+    offsets->push_back(total_elts);
+    const int64_t num_elts = member.ctx->input(0).NumElements();
+    total_elts += (num_elts + align_elts - 1) / align_elts * align_elts;
+  }
+  auto fused = std::make_shared<Tensor>();
+  Status status = leader.ctx->allocate_temp(dtype, TensorShape({total_elts}),
+                                            fused.get(),
+                                            leader.ctx->output_alloc_attr(0));
+  if (!status.ok()) {
+    fail(status);
+    return;
+  }
+  {
+    mutex mu;
+    condition_variable all_copied;
+    int pending = members_done->size();
+    for (int i = 0; i < members_done->size(); ++i) {
+      OpKernelContext* ctx = (*members_done)[i].ctx;
+      const Tensor& input = ctx->input(0);
+      Tensor part = fused->Slice((*offsets)[i],
+                                 (*offsets)[i] + input.NumElements());
+      auto copied = [&mu, &all_copied, &pending, &status](const Status& s) {
+        mutex_lock l(mu);
+        status.Update(s);
+        if (--pending == 0) all_copied.notify_all();
+      };
+      if (input.NumElements() == 0) {
+        copied(absl::OkStatus());
+      } else if (DeviceType(ctx->device()->attributes().device_type()) ==
+                 DEVICE_CPU) {
+        memcpy(DMAHelper::base(&part), DMAHelper::base(&input),
+               input.TotalBytes());
+        copied(absl::OkStatus());
+      } else {
+        Device* device = static_cast<Device*>(ctx->device());
+        DeviceContext* dev_ctx = ctx->op_device_context();
+        if (dev_ctx == nullptr) {
+          dev_ctx =
+              device->tensorflow_accelerator_device_info()->default_context;
+        }
+        CopyTensor::ViaDMA("", dev_ctx, dev_ctx, device, device,
+                           ctx->input_alloc_attr(0),
+                           leader.ctx->output_alloc_attr(0), &input, &part,
+                           /*dev_to_dev_stream_index=*/0, copied);
+      }
+    }
+    mutex_lock l(mu);
+    while (pending > 0) all_copied.wait(l);
+  }
+  if (!status.ok()) {
+    fail(status);
+    return;
+  }
+
+  CollectiveParams* fused_cp = new CollectiveParams();
+  fused_cp->name = strings::StrCat("Bucket(", leader_cp.name, ")");
+  fused_cp->group.device_type = leader_cp.group.device_type;
+  fused_cp->group.group_size = leader_cp.group.group_size;
+  fused_cp->group.group_key = leader_cp.group.group_key;
+  fused_cp->instance = leader_cp.instance;
+  fused_cp->instance.shape = fused->shape();
+  fused_cp->merge_op = leader_cp.merge_op;
+  fused_cp->final_op = leader_cp.final_op;
+  for (const BucketMember& member : *members_done) {
+    fused_cp->priority =
+        std::max(fused_cp->priority, member.col_params->priority);
+  }
+  const string exec_key = strings::StrCat(
+      fused_cp->group.group_key, ":", fused_cp->instance.instance_key, ":",
+      leader.ctx->frame_iter().frame_id, ":", leader.ctx->frame_iter().iter_id);
+
+  auto finish = [members_done, offsets, fused, fused_cp](const Status& s) {
+    for (int i = 0; i < members_done->size(); ++i) {
+      OpKernelContext* ctx = (*members_done)[i].ctx;
+      if (s.ok()) {
+        const TensorShape& shape = ctx->input(0).shape();
+        Tensor output;
+        CHECK(output.CopyFrom(
+            fused->Slice((*offsets)[i],
+                         (*offsets)[i] + shape.num_elements()),
+            shape));
+        ctx->set_output(0, output);
+      }
+    }
+    // The leader's context is used by the fused collective, so it is done
+    // last.
+    for (int i = members_done->size() - 1; i >= 0; --i) {
+      (*members_done)[i].done(s);
+    }
+    fused_cp->Unref();
+  };
+  OpKernelContext* leader_ctx = leader.ctx;
+  CompleteParamsAsync(
+      leader_ctx->device()->attributes(), fused_cp,
+      leader_ctx->cancellation_manager(),
+      [this, leader_ctx, fused_cp, exec_key, fused,
+       finish = std::move(finish)](const Status& s) {
+        if (!s.ok()) {
+          finish(s);
+          return;
+        }
+        ExecuteAsync(leader_ctx, fused_cp, exec_key, fused.get(), fused.get(),
+                     finish);
+      });
+}
+
 Status BaseCollectiveExecutor::CreateCollective(
     const CollectiveParams& col_params,
     CollectiveImplementationInterface** col_impl) {
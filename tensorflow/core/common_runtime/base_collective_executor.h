@@ -15,8 +15,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_BASE_COLLECTIVE_EXECUTOR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_BASE_COLLECTIVE_EXECUTOR_H_
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/buf_rendezvous.h"
 #include "tensorflow/core/framework/collective.h"
@@ -95,15 +98,19 @@ CollectiveAdapter* MakeCollectiveAdapter(Tensor* output, int num_chunks,
 // arguments and device+interconnect topology.
 class BaseCollectiveExecutor : public CollectiveExecutor {
  public:
+  // At most `max_in_flight` collectives are in flight on each device, or any
+  // number if it is 0.
   BaseCollectiveExecutor(CollectiveExecutorMgrInterface* cem,
                          CollectiveRemoteAccess* remote_access, int64_t step_id,
                          const DeviceMgr* dev_mgr,
-                         std::shared_ptr<UnboundedWorkQueue> work_queue)
+                         std::shared_ptr<UnboundedWorkQueue> work_queue,
+                         int64_t max_in_flight = 0)
       : CollectiveExecutor(cem),
         step_id_(step_id),
         dev_mgr_(dev_mgr),
         remote_access_(remote_access),
-        work_queue_(std::move(work_queue)) {}
+        work_queue_(std::move(work_queue)),
+        max_in_flight_(max_in_flight) {}
 
   ~BaseCollectiveExecutor() override;
 
@@ -116,6 +123,11 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
                            CancellationManager* cancel_mgr,
                            StatusCallback done) override;
 
+  void ExecuteBucketedAsync(OpKernelContext* ctx, CollectiveParams* col_params,
+                            const string& bucket, int bucket_size,
+                            StatusCallback done) override
+      TF_LOCKS_EXCLUDED(bucket_mu_);
+
   CollectiveRemoteAccess* remote_access() override {
     return remote_access_.get();
   }
@@ -134,6 +146,17 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
   // dependent ops.
   void UnblockDependencies(const CollectiveParams& col_params) override;
 
+  // Returns the bound on collectives in flight per device, read from
+  // TF_COLLECTIVE_MAX_IN_FLIGHT.  0, the default, means unbounded.
+  //
+  // A bound lets large, high priority collectives overtake the backlog of
+  // small ones, but it is only safe if every member of a group eventually
+  // launches the collective: a device that waits for a slot while its peers
+  // wait for it deadlocks until the collective times out.  This holds when
+  // the bound exceeds the number of collectives that can be ready at once on
+  // a device, or when their order is fixed with ordering tokens.
+  static int64_t MaxCollectivesInFlightFromEnv();
+
  protected:
   const int64_t step_id_;
   const DeviceMgr* dev_mgr_;  // Not owned.
@@ -150,6 +173,60 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
   Status status_ TF_GUARDED_BY(status_mu_);
 
  private:
+  // A reduction issued to ExecuteBucketedAsync().
+  struct BucketMember {
+    OpKernelContext* ctx;
+    const CollectiveParams* col_params;
+    StatusCallback done;
+    // Null if the member cannot be cancelled.
+    CancellationManager* cancel_mgr;
+    CancellationToken cancel_token = CancellationManager::kInvalidToken;
+  };
+
+  // A collective waiting for a launch slot.
+  struct PendingLaunch {
+    int priority;
+    int64_t seq;
+    uint64 enqueue_micros;
+    string collective_name;
+    std::function<void()> launch;
+
+    // Orders the highest priority, and then the oldest, launch first.
+    bool operator<(const PendingLaunch& other) const {
+      if (priority != other.priority) return priority < other.priority;
+      return seq > other.seq;
+    }
+  };
+
+  friend class BaseCollectiveExecutorLaunchTest;
+
+  // Runs `launch` once fewer than `max_in_flight_` collectives are in flight
+  // on `device`, ahead of any waiting collective with a lower priority.
+  void LaunchWhenSlotAvailable(const string& device,
+                               const CollectiveParams& col_params,
+                               std::function<void()> launch)
+      TF_LOCKS_EXCLUDED(in_flight_mu_);
+  // Frees the slot of a collective finished on `device` and launches the
+  // next one.
+  void ReleaseLaunchSlot(const string& device) TF_LOCKS_EXCLUDED(in_flight_mu_);
+  // Launches every waiting collective, which then fail with the abort status.
+  void LaunchAllPending() TF_LOCKS_EXCLUDED(in_flight_mu_);
+
+  // Executes the collective on `input` and `output` rather than on the input
+  // and output of `ctx`.
+  void ExecuteAsync(OpKernelContext* ctx, const CollectiveParams* col_params,
+                    const string& exec_key, const Tensor* input, Tensor* output,
+                    StatusCallback done);
+  // Packs the inputs of `members` into one tensor and reduces it.  Blocks
+  // until the inputs have been copied.
+  void LaunchBucket(std::vector<BucketMember> members);
+  // Fails the members of the pending bucket `key`, if any, because one of them
+  // has been cancelled.
+  void CancelBucket(const string& key) TF_LOCKS_EXCLUDED(bucket_mu_);
+  // Fails the members of every pending bucket with `s`.
+  void FailPendingBuckets(const Status& s) TF_LOCKS_EXCLUDED(bucket_mu_);
+  void FailBucketMembers(std::vector<BucketMember> members, const Status& s);
+
   Status CreateCollective(const CollectiveParams& col_params,
                           CollectiveImplementationInterface** col_impl);
   // Check if all ops on which this collective depends on have launched.
@@ -158,6 +235,26 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
   // Tries to return the status that is the original error. It returns the
   // aborted status if the collective executor is aborted.
   Status GetStatus(const Status& s) TF_LOCKS_EXCLUDED(status_mu_);
+
+  mutex bucket_mu_;
+  // (bucket, device, call frame, frame iteration) -> reductions issued so
+  // far.
+  std::unordered_map<string, std::vector<BucketMember>> pending_buckets_
+      TF_GUARDED_BY(bucket_mu_);
+
+  // The collectives of one device.
+  struct LaunchQueue {
+    int64_t num_in_flight = 0;
+    // A heap of the collectives waiting for a slot.
+    std::vector<PendingLaunch> pending;
+  };
+
+  const int64_t max_in_flight_;
+  mutex in_flight_mu_;
+  int64_t next_launch_seq_ TF_GUARDED_BY(in_flight_mu_) = 0;
+  // device -> collectives in flight and waiting on it.
+  std::unordered_map<string, LaunchQueue> launch_queues_
+      TF_GUARDED_BY(in_flight_mu_);
 };
 
 }  // namespace tensorflow
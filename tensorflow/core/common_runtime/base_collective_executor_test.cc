@@ -0,0 +1,143 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/lib/monitoring/test_utils.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/unbounded_work_queue.h"
+
+namespace tensorflow {
+
+using ::tensorflow::monitoring::testing::CellReader;
+using ::tensorflow::monitoring::testing::Histogram;
+
+constexpr char kLaunchWaitStreamz[] =
+    "/tensorflow/core/collective_launch_wait_usecs";
+constexpr char kCollectiveName[] = "RingReduce";
+
+class BaseCollectiveExecutorLaunchTest : public ::testing::Test {
+ protected:
+  BaseCollectiveExecutorLaunchTest()
+      : work_queue_(std::make_shared<UnboundedWorkQueue>(Env::Default(),
+                                                         "collective_test")) {}
+
+  void MakeExecutor(int64_t max_in_flight) {
+    exec_.reset(new BaseCollectiveExecutor(
+        /*cem=*/nullptr, /*remote_access=*/nullptr, /*step_id=*/1,
+        /*dev_mgr=*/nullptr, work_queue_, max_in_flight));
+  }
+
+  // Issues the collective `name` on `device`, which records its name in
+  // `launched_` once it is launched.
+  void Launch(const string& device, const string& name, int priority) {
+    core::RefCountPtr<CollectiveParams> col_params(new CollectiveParams);
+    col_params->name = name;
+    col_params->priority = priority;
+    col_params->instance.impl_details.collective_name = kCollectiveName;
+    exec_->LaunchWhenSlotAvailable(
+        device, *col_params, [this, name]() { launched_.push_back(name); });
+  }
+
+  void Release(const string& device) { exec_->ReleaseLaunchSlot(device); }
+
+  std::shared_ptr<UnboundedWorkQueue> work_queue_;
+  core::RefCountPtr<BaseCollectiveExecutor> exec_;
+  std::vector<string> launched_;
+};
+
+namespace {
+
+TEST_F(BaseCollectiveExecutorLaunchTest, UnboundedLaunchesImmediately) {
+  CellReader<Histogram> launch_wait(kLaunchWaitStreamz);
+  MakeExecutor(/*max_in_flight=*/0);
+  Launch("CPU:0", "a", /*priority=*/0);
+  Launch("CPU:0", "b", /*priority=*/0);
+  Launch("CPU:0", "c", /*priority=*/0);
+  EXPECT_EQ(launched_, std::vector<string>({"a", "b", "c"}));
+  // Unbounded launches do not wait for a slot and are not recorded.
+  EXPECT_EQ(launch_wait.Delta(kCollectiveName).num(), 0);
+}
+
+TEST_F(BaseCollectiveExecutorLaunchTest, BoundsCollectivesInFlight) {
+  MakeExecutor(/*max_in_flight=*/2);
+  Launch("CPU:0", "a", /*priority=*/0);
+  Launch("CPU:0", "b", /*priority=*/0);
+  Launch("CPU:0", "c", /*priority=*/0);
+  EXPECT_EQ(launched_, std::vector<string>({"a", "b"}));
+  Release("CPU:0");
+  EXPECT_EQ(launched_, std::vector<string>({"a", "b", "c"}));
+  // Two collectives remain in flight, so a new one waits.
+  Launch("CPU:0", "d", /*priority=*/0);
+  EXPECT_EQ(launched_.size(), 3u);
+  Release("CPU:0");
+  Release("CPU:0");
+  Release("CPU:0");
+  EXPECT_EQ(launched_, std::vector<string>({"a", "b", "c", "d"}));
+  // Every slot is free again.
+  Launch("CPU:0", "e", /*priority=*/0);
+  Launch("CPU:0", "f", /*priority=*/0);
+  EXPECT_EQ(launched_.size(), 6u);
+}
+
+TEST_F(BaseCollectiveExecutorLaunchTest, LaunchesByPriorityThenAge) {
+  MakeExecutor(/*max_in_flight=*/1);
+  Launch("CPU:0", "first", /*priority=*/0);
+  Launch("CPU:0", "low", /*priority=*/1);
+  Launch("CPU:0", "high_old", /*priority=*/5);
+  Launch("CPU:0", "high_new", /*priority=*/5);
+  Launch("CPU:0", "medium", /*priority=*/3);
+  EXPECT_EQ(launched_, std::vector<string>({"first"}));
+  for (int i = 0; i < 4; ++i) Release("CPU:0");
+  EXPECT_EQ(launched_, std::vector<string>({"first", "high_old", "high_new",
+                                            "medium", "low"}));
+}
+
+TEST_F(BaseCollectiveExecutorLaunchTest, BoundsEachDeviceSeparately) {
+  MakeExecutor(/*max_in_flight=*/1);
+  Launch("CPU:0", "a0", /*priority=*/0);
+  Launch("CPU:0", "b0", /*priority=*/0);
+  Launch("CPU:1", "a1", /*priority=*/0);
+  EXPECT_EQ(launched_, std::vector<string>({"a0", "a1"}));
+  Release("CPU:1");
+  EXPECT_EQ(launched_, std::vector<string>({"a0", "a1"}));
+  Release("CPU:0");
+  EXPECT_EQ(launched_, std::vector<string>({"a0", "a1", "b0"}));
+}
+
+TEST_F(BaseCollectiveExecutorLaunchTest, RecordsLaunchWait) {
+  CellReader<Histogram> launch_wait(kLaunchWaitStreamz);
+  MakeExecutor(/*max_in_flight=*/1);
+  Launch("CPU:0", "a", /*priority=*/0);
+  Launch("CPU:0", "b", /*priority=*/0);
+  Env::Default()->SleepForMicroseconds(20000);
+  Release("CPU:0");
+  ASSERT_EQ(launched_, std::vector<string>({"a", "b"}));
+
+  // `a` launched without waiting, and `b` waited for the slot of `a`.
+  const Histogram wait = launch_wait.Delta(kCollectiveName);
+  EXPECT_EQ(wait.num(), 2);
+  EXPECT_GE(wait.sum(), 20000);
+}
+
+}  // namespace
+}  // namespace tensorflow
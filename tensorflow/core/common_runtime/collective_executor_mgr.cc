@@ -38,7 +38,9 @@ CollectiveExecutorMgr::CollectiveExecutorMgr(
           config.gpu_options().experimental().collective_ring_order()),
       nccl_communicator_(std::move(nccl_communicator)),
       work_queue_(std::make_shared<UnboundedWorkQueue>(Env::Default(),
-                                                       "collective_ops")) {}
+                                                       "collective_ops")),
+      max_collectives_in_flight_(
+          BaseCollectiveExecutor::MaxCollectivesInFlightFromEnv()) {}
 
 CollectiveExecutorMgr::~CollectiveExecutorMgr() {
   for (auto iter : executor_table_) {
@@ -65,7 +67,8 @@ CollectiveExecutor* CollectiveExecutorMgr::FindOrCreate(int64_t step_id) {
 CollectiveExecutor* CollectiveExecutorMgr::Create(int64_t step_id) {
   CollectiveRemoteAccessLocal* rma =
       new CollectiveRemoteAccessLocal(dev_mgr_, dev_resolver_.get(), step_id);
-  return new BaseCollectiveExecutor(this, rma, step_id, dev_mgr_, work_queue_);
+  return new BaseCollectiveExecutor(this, rma, step_id, dev_mgr_, work_queue_,
+                                    max_collectives_in_flight_);
 }
 
 void CollectiveExecutorMgr::Cleanup(int64_t step_id) {
@@ -77,6 +77,8 @@ class CollectiveExecutorMgr : public CollectiveExecutorMgrInterface {
   // collective op execution.  Ownership is shared between `this` and
   // `CollectiveRemoteAccessLocal`.
   std::shared_ptr<UnboundedWorkQueue> work_queue_;
+  // The bound on collectives in flight per device of the executors, or 0.
+  const int64_t max_collectives_in_flight_;
 
  private:
   mutex exec_mu_;
@@ -22,6 +22,8 @@ namespace tensorflow {
 inline constexpr char kTpuCostName[] = "tpu";
 inline constexpr char kGcuCostName[] = "gcu";
 inline constexpr char kNoOpCostName[] = "no_op";
+// Time a request waited in a batching queue before its batch started running.
+inline constexpr char kBatchingWaitCostName[] = "batching_wait";
 
 // Each type of per-request cost could have the following versions.
 //
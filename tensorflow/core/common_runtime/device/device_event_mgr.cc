@@ -19,9 +19,11 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/platform/stacktrace.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/thread_annotations.h"
 
 namespace tensorflow {
@@ -33,6 +35,29 @@ namespace {
 //  - Should EventMgrs be shared between devices on a machine with multiple
 //  devices of the same type?
 static const int kNumThreads = 2;
+
+auto* callback_delay_usecs = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/device_event_mgr/callback_delay_usecs",
+     "The time from EventMgr::ThenExecute() until the callback is scheduled "
+     "after the stream completed its work, in microseconds.",
+     "mechanism"},
+    // Power of 2 with bucket count 24 (> 16 seconds)
+    {monitoring::Buckets::Exponential(1, 2, 24)});
+
+void RecordCallbackDelay(const char* mechanism, uint64 enqueue_time_usecs) {
+  callback_delay_usecs->GetCell(mechanism)->Add(
+      Env::Default()->NowMicros() - enqueue_time_usecs);
+}
+
+bool UseHostCallbacks() {
+  bool use_host_callbacks = false;
+  Status status = ReadBoolFromEnvVar("TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS",
+                                     false, &use_host_callbacks);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+  return use_host_callbacks;
+}
 }  // namespace
 
 namespace device_event_mgr {
@@ -100,17 +125,25 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
       polling_active_delay_usecs_(gpu_options.polling_active_delay_usecs()
                                       ? gpu_options.polling_active_delay_usecs()
                                       : 10),
+      use_host_callbacks_(UseHostCallbacks()),
       threadpool_(Env::Default(), "Device_Event_Manager", kNumThreads) {
   device_event_mgr::InitThreadpoolLabels(&threadpool_);
   StartPollingLoop();
 }
 
 EventMgr::~EventMgr() {
+  {
+    // Host callbacks refer to this EventMgr, so they must all have run.
+    mutex_lock l(mu_);
+    while (num_pending_host_callbacks_ > 0) {
+      host_callbacks_done_.wait(l);
+    }
+  }
   StopPollingLoop();
 
   for (auto& [stream, stream_callbacks] : callbacks_) {
-    for (auto& [event, callback] : stream_callbacks) {
-      threadpool_.Schedule(std::move(callback));
+    for (PendingCallback& callback : stream_callbacks) {
+      threadpool_.Schedule(std::move(callback.func));
     }
   }
   // The threadpool's destructor will block waiting for all outstanding
@@ -181,7 +214,8 @@ void EventMgr::EnqueueCallback(se::Stream* stream, std::function<void()> func) {
   stream->RecordEvent(e.get()).IgnoreError();
 
   bool was_empty = callbacks_.empty();
-  callbacks_[stream].push_back({std::move(e), std::move(func)});
+  callbacks_[stream].push_back(
+      {std::move(e), std::move(func), Env::Default()->NowMicros()});
 
   // Wake up the polling thread if it was sleeping.
   if (was_empty) {
@@ -189,6 +223,25 @@ void EventMgr::EnqueueCallback(se::Stream* stream, std::function<void()> func) {
   }
 }
 
+bool EventMgr::EnqueueHostCallback(se::Stream* stream,
+                                   const std::function<void()>& func) {
+  absl::Status status = stream->DoHostCallback(
+      [this, func, enqueue_time_usecs = Env::Default()->NowMicros()]() mutable {
+        RecordCallbackDelay("host_callback", enqueue_time_usecs);
+        threadpool_.Schedule(std::move(func));
+        mutex_lock l(mu_);
+        if (--num_pending_host_callbacks_ == 0) {
+          host_callbacks_done_.notify_all();
+        }
+      });
+  if (!status.ok()) {
+    VLOG(1) << "Falling back to polling events: " << status;
+    return false;
+  }
+  ++num_pending_host_callbacks_;
+  return true;
+}
+
 // This function must be called periodically to check whether pending
 // events have recorded, and then retire them.  Initial observations
 // suggest that typical behavior in a TensorFlow program is to have
@@ -211,9 +264,9 @@ void EventMgr::PollEvents(se::Stream* stream /*=nullptr*/) {
 
         auto it = stream_callbacks.begin();
         while (it != stream_callbacks.end()) {
-          auto& [event, callback] = *it;
+          PendingCallback& callback = *it;
 
-          se::Event::Status s = event->PollForStatus();
+          se::Event::Status s = callback.event->PollForStatus();
           bool keep_looping = true;
           switch (s) {
             case se::Event::Status::kUnknown:
@@ -228,8 +281,9 @@ void EventMgr::PollEvents(se::Stream* stream /*=nullptr*/) {
               keep_looping = false;
               break;
             case se::Event::Status::kComplete:
-              free_events_.push_back(std::move(event));
-              threadpool_.Schedule(std::move(callback));
+              RecordCallbackDelay("polling", callback.enqueue_time_usecs);
+              free_events_.push_back(std::move(callback.event));
+              threadpool_.Schedule(std::move(callback.func));
               // std::deque::erase() does invalidate iterators, so we can't
               // erase `it` here.  Instead, we'll wait until the end of the loop
               // over stream_callbacks and erase all of the completed events at
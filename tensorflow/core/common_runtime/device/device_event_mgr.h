@@ -69,6 +69,7 @@ class EventMgr {
   // such callbacks and also buffer deletions.
   void ThenExecute(se::Stream* stream, std::function<void()> func) {
     mutex_lock l(mu_);
+    if (use_host_callbacks_ && EnqueueHostCallback(stream, func)) return;
     EnqueueCallback(stream, std::move(func));
     PollEvents(stream);
   }
@@ -78,10 +79,21 @@ class EventMgr {
   friend class TEST_EventMgrHelper;
   friend class EventMgrFactory;
 
+  struct PendingCallback {
+    std::unique_ptr<se::Event> event;
+    std::function<void()> func;
+    uint64 enqueue_time_usecs;
+  };
+
   se::StreamExecutor* const exec_;
   const int32 polling_active_delay_usecs_;
+  // If true, callbacks are scheduled from host callbacks enqueued on the
+  // stream as soon as the stream reaches them, instead of by polling events.
+  // Set with the TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS environment variable.
+  const bool use_host_callbacks_;
   mutex mu_;
   condition_variable events_pending_ TF_GUARDED_BY(mu_);
+  condition_variable host_callbacks_done_ TF_GUARDED_BY(mu_);
 
   EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options);
 
@@ -90,6 +102,14 @@ class EventMgr {
   void EnqueueCallback(se::Stream* stream, std::function<void()> func)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Enqueues a host callback on `stream` that schedules `func` once `stream`
+  // completes all its outstanding work.  Returns false if the stream does not
+  // accept host callbacks, in which case `func` must be enqueued with
+  // EnqueueCallback() instead.
+  bool EnqueueHostCallback(se::Stream* stream,
+                           const std::function<void()>& func)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // This function should be called at roughly the same tempo as QueueTensors()
   // to check whether pending events have recorded, and then retire them.
   //
@@ -110,10 +130,11 @@ class EventMgr {
   std::vector<std::unique_ptr<se::Event>> free_events_ TF_GUARDED_BY(mu_);
 
   // Callbacks waiting on their events to complete.
-  absl::flat_hash_map<
-      se::Stream*,
-      std::deque<std::pair<std::unique_ptr<se::Event>, std::function<void()>>>>
-      callbacks_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<se::Stream*, std::deque<PendingCallback>> callbacks_
+      TF_GUARDED_BY(mu_);
+
+  // The number of host callbacks enqueued on streams that haven't run yet.
+  int num_pending_host_callbacks_ TF_GUARDED_BY(mu_) = 0;
 
   bool stop_polling_ TF_GUARDED_BY(mu_);
   std::unique_ptr<Notification> polling_stopped_;
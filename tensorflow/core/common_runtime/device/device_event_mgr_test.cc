@@ -134,6 +134,26 @@ TEST(EventMgr, WarnIfInCallback) {
   note.WaitForNotification();
   EXPECT_TRUE(hit);
 }
+
+// Tests that callbacks run without polling when host callbacks are enabled.
+TEST(EventMgr, HostCallbacks) {
+  setenv("TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS", "true", /*overwrite=*/1);
+  auto stream_exec = se::GPUMachineManager()->ExecutorForDevice(0).value();
+  TEST_EventMgr em(stream_exec, GPUOptions());
+  unsetenv("TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS");
+  TEST_EventMgrHelper th(&em);
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, stream_exec->CreateStream());
+  std::atomic_int count(0);
+  Notification note;
+  for (int i = 0; i < 10; ++i) {
+    em.ThenExecute(stream.get(), [&count, &note]() {
+      if (++count == 10) note.Notify();
+    });
+  }
+  EXPECT_EQ(0, th.queue_size());
+  note.WaitForNotification();
+  EXPECT_EQ(0, th.free_size());
+}
 }  // namespace
 
 // Provides access to private resources of BaseGPUDevice.
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -28,7 +29,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/constant_folding.h"
 #include "tensorflow/core/common_runtime/debugger_state_interface.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/direct_session_graph_cache.h"
 #include "tensorflow/core/common_runtime/device_resolver_local.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/executor.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/common_runtime/function.h"
@@ -40,7 +43,10 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
+#include "tensorflow/core/common_runtime/planned_step_slab.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/graph_def_util.h"
@@ -50,6 +56,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/run_handler.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph.h"
@@ -63,6 +70,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/core/threadpool_options.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -160,6 +168,22 @@ string GetRendezvousKey(const string& tensor_name,
                          frame_iter.frame_id, ":", frame_iter.iter_id);
 }
 
+// Replaces each of `tensors` whose buffer was allocated by a
+// `StepArenaAllocator` or a `PlannedStepSlab` with a copy, so that fetched
+// tensors do not keep the arena or slab of their step alive.
+void CopyOutOfStepArenas(std::vector<Tensor>* tensors) {
+  for (Tensor& tensor : *tensors) {
+    const TensorBuffer* buffer = DMAHelper::buffer(&tensor);
+    if (buffer == nullptr) continue;
+    AllocationDescription description;
+    buffer->FillAllocationDescription(&description);
+    if (description.allocator_name() == StepArenaAllocator::kName ||
+        description.allocator_name() == PlannedStepSlab::kName) {
+      tensor = tensor::DeepCopy(tensor);
+    }
+  }
+}
+
 }  // namespace
 
 class DirectSessionFactory : public SessionFactory {
@@ -447,6 +471,10 @@ Status DirectSession::ExtendLocked(GraphDef&& graph) {
   if (finalized_) {
     return errors::FailedPrecondition("Session has been finalized.");
   }
+  if (!options_.config.experimental().graph_cache_dir().empty()) {
+    graph_fingerprint_ =
+        FingerprintDirectSessionGraph(graph, graph_fingerprint_);
+  }
   if (!(flib_def_ && execution_state_)) {
     // If this is the first call, we can initialize the execution state
     // with `graph` and do not need to call `Extend()`.
@@ -718,6 +746,61 @@ Status DirectSession::RunInternal(
 
   Status run_status;
 
+  // The per-step arenas for the partitions that use one. Each item's arena
+  // is released, and its capacity for the next step updated, when this
+  // function returns.
+  std::vector<StepArenaAllocator*> step_arenas(executors_and_keys->items.size(),
+                                               nullptr);
+  auto release_step_arenas = gtl::MakeCleanup([&step_arenas,
+                                               &executors_and_keys]() {
+    for (size_t i = 0; i < step_arenas.size(); ++i) {
+      if (step_arenas[i] == nullptr) continue;
+      // Size the next step's arena to hold the most bytes that this step had
+      // reserved at once. This is monotonic per partition, so concurrent
+      // steps may race benignly.
+      std::atomic<size_t>* capacity =
+          executors_and_keys->items[i].step_arena_capacity.get();
+      const size_t requested = step_arenas[i]->peak_bytes();
+      size_t current = capacity->load(std::memory_order_relaxed);
+      while (requested > current &&
+             !capacity->compare_exchange_weak(current, requested,
+                                              std::memory_order_relaxed)) {
+      }
+      step_arenas[i]->Release();
+    }
+  });
+  // The per-step slabs for the partitions that have a static memory plan.
+  // They serve the planned tensors, and fall back to the step's arena.
+  std::vector<PlannedStepSlab*> step_slabs(executors_and_keys->items.size(),
+                                           nullptr);
+  auto release_step_slabs = gtl::MakeCleanup([&step_slabs]() {
+    for (PlannedStepSlab* slab : step_slabs) {
+      if (slab != nullptr) slab->Release();
+    }
+  });
+  for (size_t i = 0; i < executors_and_keys->items.size(); ++i) {
+    const auto& item = executors_and_keys->items[i];
+    if (item.step_arena_capacity != nullptr) {
+      Allocator* const device_allocator =
+          item.device->GetAllocator(AllocatorAttributes());
+      step_arenas[i] = new StepArenaAllocator(
+          device_allocator,
+          item.step_arena_capacity->load(std::memory_order_relaxed));
+      if (item.step_slab_plan != nullptr) {
+        step_slabs[i] = new PlannedStepSlab(item.step_slab_plan.get(),
+                                            device_allocator, step_arenas[i]);
+      }
+    }
+  }
+  auto set_step_allocators_for_item = [&step_arenas, &step_slabs](
+                                          size_t i, Executor::Args* args) {
+    args->step_allocator = step_arenas[i];
+    args->node_step_allocator = nullptr;
+    if (PlannedStepSlab* slab = step_slabs[i]) {
+      args->node_step_allocator = [slab](int id) { return slab->ForNode(id); };
+    }
+  };
+
   auto set_threadpool_args_for_item =
       [&default_runner, &handler](const PerPartitionExecutorsAndLib& item,
                                   Executor::Args* args) {
@@ -748,6 +831,7 @@ Status DirectSession::RunInternal(
 
     const auto& item = executors_and_keys->items[0];
     set_threadpool_args_for_item(item, &args);
+    set_step_allocators_for_item(0, &args);
     run_status = item.executor->Run(args);
   } else {
     core::RefCountPtr<RefCountedIntraProcessRendezvous> rendezvous(
@@ -766,8 +850,10 @@ Status DirectSession::RunInternal(
                               executors_done.Notify();
                             });
 
-    for (const auto& item : executors_and_keys->items) {
+    for (size_t i = 0; i < executors_and_keys->items.size(); ++i) {
+      const auto& item = executors_and_keys->items[i];
       set_threadpool_args_for_item(item, &args);
+      set_step_allocators_for_item(i, &args);
       item.executor->RunAsync(args, barrier->Get());
     }
 
@@ -935,6 +1021,9 @@ Status DirectSession::Run(const RunOptions& run_options,
     } else if (!s.ok()) {
       return s;
     }
+    if (executors_and_keys->uses_step_arenas) {
+      CopyOutOfStepArenas(&sorted_outputs);
+    }
     const bool unique_outputs =
         output_names.size() == executors_and_keys->output_name_to_index.size();
     // first_indices[i] = j implies that j is the smallest value for which
@@ -1447,6 +1536,20 @@ Status DirectSession::CreateExecutors(
 
     item->executor = nullptr;
     item->device = device;
+    if (options_.config.experimental().use_per_step_arena_allocator() &&
+        device->device_type() == DEVICE_CPU) {
+      item->step_arena_capacity = std::make_unique<std::atomic<size_t>>(0);
+      ek->uses_step_arenas = true;
+      auto step_slab_plan = std::make_unique<StepSlabPlan>();
+      const Status plan_status =
+          PlanStepSlab(*partition_graph, step_slab_plan.get());
+      if (plan_status.ok() && step_slab_plan->slab_size > 0) {
+        item->step_slab_plan = std::move(step_slab_plan);
+      } else if (!plan_status.ok()) {
+        VLOG(1) << "Not planning the memory of the partition on "
+                << device->name() << ": " << plan_status;
+      }
+    }
     auto executor_type = options_.config.experimental().executor_type();
     TF_RETURN_IF_ERROR(
         NewExecutor(executor_type, params, *partition_graph, &item->executor));
@@ -1619,91 +1722,178 @@ Status DirectSession::CreateGraphs(
     return errors::FailedPrecondition("Session has been finalized.");
   }
 
-  std::unique_ptr<ClientGraph> client_graph;
-
-  std::unique_ptr<GraphExecutionState> temp_exec_state_holder;
-  GraphExecutionState* execution_state = nullptr;
-  if (options_.config.graph_options().place_pruned_graph()) {
-    // Because we are placing pruned graphs, we need to create a
-    // new GraphExecutionState for every new unseen graph,
-    // and then place it.
-    GraphExecutionStateOptions prune_options;
-    prune_options.device_set = &device_set_;
-    prune_options.session_options = &options_;
-    prune_options.stateful_placements = stateful_placements_;
-    prune_options.session_handle = session_handle_;
-    TF_RETURN_IF_ERROR(GraphExecutionState::MakeForPrunedGraph(
-        *execution_state_, prune_options, subgraph_options,
-        &temp_exec_state_holder, &client_graph));
-    execution_state = temp_exec_state_holder.get();
+  const string& cache_dir = options_.config.experimental().graph_cache_dir();
+  // Partial runs need the full graph, which is not cached.
+  const bool use_graph_cache =
+      !cache_dir.empty() && !run_state_args->is_partial_run;
+  DirectSessionGraphCacheEntry cache_entry;
+  bool cache_hit = false;
+  if (use_graph_cache) {
+    const uint64_t cache_key = DirectSessionGraphCacheKey(
+        graph_fingerprint_, options_.config, subgraph_options, devices_);
+    Status s =
+        ReadDirectSessionGraphCacheEntry(cache_dir, cache_key, &cache_entry);
+    if (s.ok()) {
+      s = ValidateDirectSessionGraphCacheEntry(cache_entry, subgraph_options,
+                                               devices_);
+    }
+    if (s.ok()) {
+      // The entry must not move a stateful node that this session already
+      // placed.
+      for (const auto& placement_pair : cache_entry.stateful_placements()) {
+        auto iter = stateful_placements_.find(placement_pair.first);
+        if (iter != stateful_placements_.end() &&
+            iter->second != placement_pair.second) {
+          s = errors::DataLoss("Graph cache entry places ",
+                               placement_pair.first, " on ",
+                               placement_pair.second, " instead of ",
+                               iter->second);
+          break;
+        }
+      }
+    }
+    if (s.ok()) {
+      cache_hit = true;
+    } else {
+      if (!errors::IsNotFound(s)) {
+        LOG(WARNING) << "Ignoring graph cache entry: " << s;
+      }
+      // Rebuild the entry from scratch, dropping anything partially read.
+      cache_entry.Clear();
+    }
+    cache_entry.set_key(cache_key);
+  }
+
+  std::unique_ptr<FunctionLibraryDefinition> client_flib_def;
+  std::unordered_map<string, GraphDef> partitions;
+  if (cache_hit) {
+    VLOG(1) << "Loaded partition graphs from graph cache entry "
+            << cache_entry.key();
+    // Restore the results of BuildGraph() and Partition() from the entry.
+    for (const auto& placement_pair : cache_entry.stateful_placements()) {
+      stateful_placements_.insert(
+          std::make_pair(placement_pair.first, placement_pair.second));
+    }
+    *collective_graph_key = cache_entry.collective_graph_key();
+    input_types->clear();
+    for (int type : cache_entry.feed_types()) {
+      input_types->push_back(static_cast<DataType>(type));
+    }
+    output_types->clear();
+    for (int type : cache_entry.fetch_types()) {
+      output_types->push_back(static_cast<DataType>(type));
+    }
+    client_flib_def = std::make_unique<FunctionLibraryDefinition>(
+        OpRegistry::Global(), cache_entry.library());
+    for (auto& partition : *cache_entry.mutable_partitions()) {
+      partitions.emplace(partition.first, std::move(partition.second));
+    }
   } else {
-    execution_state = execution_state_.get();
-    TF_RETURN_IF_ERROR(
-        execution_state->BuildGraph(subgraph_options, &client_graph));
-  }
-  *collective_graph_key = client_graph->collective_graph_key;
-
-  if (subgraph_options.callable_options.feed_size() !=
-      client_graph->feed_types.size()) {
-    return errors::Internal(
-        "Graph pruning failed: requested number of feed endpoints = ",
-        subgraph_options.callable_options.feed_size(),
-        " versus number of pruned feed endpoints = ",
-        client_graph->feed_types.size());
-  }
-  if (subgraph_options.callable_options.fetch_size() !=
-      client_graph->fetch_types.size()) {
-    return errors::Internal(
-        "Graph pruning failed: requested number of fetch endpoints = ",
-        subgraph_options.callable_options.fetch_size(),
-        " versus number of pruned fetch endpoints = ",
-        client_graph->fetch_types.size());
-  }
-
-  auto current_stateful_placements = execution_state->GetStatefulPlacements();
-  // Update our current state based on the execution_state's
-  // placements.  If there are any mismatches for a node,
-  // we should fail, as this should never happen.
-  for (const auto& placement_pair : current_stateful_placements) {
-    const string& node_name = placement_pair.first;
-    const string& placement = placement_pair.second;
-    auto iter = stateful_placements_.find(node_name);
-    if (iter == stateful_placements_.end()) {
-      stateful_placements_.insert(std::make_pair(node_name, placement));
-    } else if (iter->second != placement) {
+    std::unique_ptr<ClientGraph> client_graph;
+
+    std::unique_ptr<GraphExecutionState> temp_exec_state_holder;
+    GraphExecutionState* execution_state = nullptr;
+    if (options_.config.graph_options().place_pruned_graph()) {
+      // Because we are placing pruned graphs, we need to create a
+      // new GraphExecutionState for every new unseen graph,
+      // and then place it.
+      GraphExecutionStateOptions prune_options;
+      prune_options.device_set = &device_set_;
+      prune_options.session_options = &options_;
+      prune_options.stateful_placements = stateful_placements_;
+      prune_options.session_handle = session_handle_;
+      TF_RETURN_IF_ERROR(GraphExecutionState::MakeForPrunedGraph(
+          *execution_state_, prune_options, subgraph_options,
+          &temp_exec_state_holder, &client_graph));
+      execution_state = temp_exec_state_holder.get();
+    } else {
+      execution_state = execution_state_.get();
+      TF_RETURN_IF_ERROR(
+          execution_state->BuildGraph(subgraph_options, &client_graph));
+    }
+    *collective_graph_key = client_graph->collective_graph_key;
+
+    if (subgraph_options.callable_options.feed_size() !=
+        client_graph->feed_types.size()) {
       return errors::Internal(
-          "Stateful placement mismatch. "
-          "Current assignment of ",
-          node_name, " to ", iter->second, " does not match ", placement);
+          "Graph pruning failed: requested number of feed endpoints = ",
+          subgraph_options.callable_options.feed_size(),
+          " versus number of pruned feed endpoints = ",
+          client_graph->feed_types.size());
+    }
+    if (subgraph_options.callable_options.fetch_size() !=
+        client_graph->fetch_types.size()) {
+      return errors::Internal(
+          "Graph pruning failed: requested number of fetch endpoints = ",
+          subgraph_options.callable_options.fetch_size(),
+          " versus number of pruned fetch endpoints = ",
+          client_graph->fetch_types.size());
+    }
+
+    auto current_stateful_placements = execution_state->GetStatefulPlacements();
+    // Update our current state based on the execution_state's
+    // placements.  If there are any mismatches for a node,
+    // we should fail, as this should never happen.
+    for (const auto& placement_pair : current_stateful_placements) {
+      const string& node_name = placement_pair.first;
+      const string& placement = placement_pair.second;
+      auto iter = stateful_placements_.find(node_name);
+      if (iter == stateful_placements_.end()) {
+        stateful_placements_.insert(std::make_pair(node_name, placement));
+      } else if (iter->second != placement) {
+        return errors::Internal(
+            "Stateful placement mismatch. "
+            "Current assignment of ",
+            node_name, " to ", iter->second, " does not match ", placement);
+      }
     }
-  }
 
-  stateful_placements_ = execution_state->GetStatefulPlacements();
+    stateful_placements_ = execution_state->GetStatefulPlacements();
 
-  // Remember the graph in run state if this is a partial run.
-  if (run_state_args->is_partial_run) {
-    run_state_args->graph.reset(new Graph(flib_def_.get()));
-    CopyGraph(*execution_state->full_graph(), run_state_args->graph.get());
-  }
+    // Remember the graph in run state if this is a partial run.
+    if (run_state_args->is_partial_run) {
+      run_state_args->graph.reset(new Graph(flib_def_.get()));
+      CopyGraph(*execution_state->full_graph(), run_state_args->graph.get());
+    }
 
-  // Partition the graph across devices.
-  PartitionOptions popts;
-  popts.node_to_loc = [](const Node* node) {
-    return node->assigned_device_name();
-  };
-  popts.new_name = [this](const string& prefix) {
-    return strings::StrCat(prefix, "/_", edge_name_counter_.fetch_add(1));
-  };
-  popts.get_incarnation = [](const string& name) {
-    // The direct session does not have changing incarnation numbers.
-    // Just return '1'.
-    return 1;
-  };
-  popts.flib_def = flib_def->get();
-  popts.control_flow_added = false;
+    // Partition the graph across devices.
+    PartitionOptions popts;
+    popts.node_to_loc = [](const Node* node) {
+      return node->assigned_device_name();
+    };
+    popts.new_name = [this](const string& prefix) {
+      return strings::StrCat(prefix, "/_", edge_name_counter_.fetch_add(1));
+    };
+    popts.get_incarnation = [](const string& name) {
+      // The direct session does not have changing incarnation numbers.
+      // Just return '1'.
+      return 1;
+    };
+    popts.flib_def = flib_def->get();
+    popts.control_flow_added = false;
 
-  std::unordered_map<string, GraphDef> partitions;
-  TF_RETURN_IF_ERROR(Partition(popts, &client_graph->graph, &partitions));
+    TF_RETURN_IF_ERROR(Partition(popts, &client_graph->graph, &partitions));
+
+    client_flib_def = std::move(client_graph->flib_def);
+    std::swap(*input_types, client_graph->feed_types);
+    std::swap(*output_types, client_graph->fetch_types);
+
+    if (use_graph_cache) {
+      for (const auto& partition : partitions) {
+        (*cache_entry.mutable_partitions())[partition.first] = partition.second;
+      }
+      *cache_entry.mutable_library() = client_flib_def->ToProto();
+      for (DataType type : *input_types) cache_entry.add_feed_types(type);
+      for (DataType type : *output_types) cache_entry.add_fetch_types(type);
+      cache_entry.set_collective_graph_key(*collective_graph_key);
+      cache_entry.mutable_stateful_placements()->insert(
+          stateful_placements_.begin(), stateful_placements_.end());
+      Status s = WriteDirectSessionGraphCacheEntry(cache_dir, cache_entry);
+      if (!s.ok()) {
+        LOG(WARNING) << "Failed to write graph cache entry: " << s;
+      }
+    }
+  }
 
   std::vector<string> device_names;
   device_names.reserve(devices_.size());
@@ -1727,8 +1917,7 @@ Status DirectSession::CreateGraphs(
   }
 
   for (auto& partition : partitions) {
-    std::unique_ptr<Graph> device_graph(
-        new Graph(client_graph->flib_def.get()));
+    std::unique_ptr<Graph> device_graph(new Graph(client_flib_def.get()));
     device_graph->SetConstructionContext(ConstructionContext::kDirectSession);
     GraphConstructorOptions device_opts;
     // There are internal operations (e.g., send/recv) that we now allow.
@@ -1741,7 +1930,7 @@ Status DirectSession::CreateGraphs(
 
   GraphOptimizationPassOptions optimization_options;
   optimization_options.session_options = &options_;
-  optimization_options.flib_def = client_graph->flib_def.get();
+  optimization_options.flib_def = client_flib_def.get();
   optimization_options.partition_graphs = outputs;
   TF_RETURN_IF_ERROR(OptimizationPassRegistry::Global()->RunGrouping(
       OptimizationPassRegistry::POST_PARTITIONING, optimization_options));
@@ -1763,9 +1952,7 @@ Status DirectSession::CreateGraphs(
       break;
     }
   }
-  *flib_def = std::move(client_graph->flib_def);
-  std::swap(*input_types, client_graph->feed_types);
-  std::swap(*output_types, client_graph->fetch_types);
+  *flib_def = std::move(client_flib_def);
   return s;
 }
 
@@ -1896,11 +2083,13 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
   RunCallableCallFrame(DirectSession* session,
                        ExecutorsAndKeys* executors_and_keys,
                        const std::vector<Tensor>* feed_tensors,
-                       std::vector<Tensor>* fetch_tensors)
+                       std::vector<Tensor>* fetch_tensors,
+                       const std::vector<Tensor>* fetch_buffers)
       : session_(session),
         executors_and_keys_(executors_and_keys),
         feed_tensors_(feed_tensors),
-        fetch_tensors_(fetch_tensors) {}
+        fetch_tensors_(fetch_tensors),
+        fetch_buffers_(fetch_buffers) {}
 
   size_t num_args() const override {
     return executors_and_keys_->input_types.size();
@@ -1926,11 +2115,21 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
     return absl::OkStatus();
   }
 
+  const Tensor* GetRetvalBuffer(int index) const override {
+    if (fetch_buffers_ == nullptr || index < 0 ||
+        index >= fetch_buffers_->size()) {
+      return nullptr;
+    }
+    const Tensor& buffer = (*fetch_buffers_)[index];
+    return buffer.IsInitialized() ? &buffer : nullptr;
+  }
+
  private:
-  DirectSession* const session_;                   // Not owned.
-  ExecutorsAndKeys* const executors_and_keys_;     // Not owned.
-  const std::vector<Tensor>* const feed_tensors_;  // Not owned.
-  std::vector<Tensor>* const fetch_tensors_;       // Not owned.
+  DirectSession* const session_;                    // Not owned.
+  ExecutorsAndKeys* const executors_and_keys_;      // Not owned.
+  const std::vector<Tensor>* const feed_tensors_;   // Not owned.
+  std::vector<Tensor>* const fetch_tensors_;        // Not owned.
+  const std::vector<Tensor>* const fetch_buffers_;  // Not owned.
 };
 
 ::tensorflow::Status DirectSession::RunCallable(
@@ -1944,6 +2143,55 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
     CallableHandle handle, const std::vector<Tensor>& feed_tensors,
     std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
     const thread::ThreadPoolOptions& threadpool_options) {
+  return RunCallableInternal(handle, feed_tensors, fetch_tensors,
+                             /*fetch_buffers=*/nullptr, run_metadata,
+                             threadpool_options);
+}
+
+::tensorflow::Status DirectSession::RunCallableWithBuffers(
+    CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+    std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
+    const thread::ThreadPoolOptions& threadpool_options) {
+  if (fetch_tensors == nullptr) {
+    return errors::InvalidArgument(
+        "`fetch_tensors` must be provided to RunCallableWithBuffers().");
+  }
+  // The call frame overwrites `*fetch_tensors`, so hold on to the buffers
+  // separately for the duration of the step. Holding them also keeps their
+  // reference counts above one, so that no kernel forwards (and overwrites)
+  // a buffer that holds a fetched value.
+  std::vector<Tensor> fetch_buffers;
+  fetch_buffers.swap(*fetch_tensors);
+  TF_RETURN_IF_ERROR(RunCallableInternal(handle, feed_tensors, fetch_tensors,
+                                         &fetch_buffers, run_metadata,
+                                         threadpool_options));
+
+  // Copy the values that were not produced in their buffers, e.g. because
+  // they were forwarded from an input or received from another device.
+  for (int i = 0; i < fetch_buffers.size(); ++i) {
+    Tensor& buffer = fetch_buffers[i];
+    Tensor& fetched = (*fetch_tensors)[i];
+    if (!buffer.IsInitialized() || !fetched.IsInitialized() ||
+        fetched.SharesBufferWith(buffer) || fetched.dtype() != buffer.dtype() ||
+        !DataTypeCanUseMemcpy(fetched.dtype()) ||
+        fetched.NumElements() != buffer.NumElements()) {
+      continue;
+    }
+    StringPiece src = fetched.tensor_data();
+    if (!src.empty()) {
+      std::memcpy(const_cast<char*>(buffer.tensor_data().data()), src.data(),
+                  src.size());
+    }
+    CHECK(fetched.CopyFrom(buffer, fetched.shape()));
+  }
+  return absl::OkStatus();
+}
+
+::tensorflow::Status DirectSession::RunCallableInternal(
+    CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+    std::vector<Tensor>* fetch_tensors,
+    const std::vector<Tensor>* fetch_buffers, RunMetadata* run_metadata,
+    const thread::ThreadPoolOptions& threadpool_options) {
   TF_RETURN_IF_ERROR(CheckNotClosed());
   TF_RETURN_IF_ERROR(CheckGraphCreated("RunCallable()"));
   direct_session_runs->GetCell()->IncrementBy(1);
@@ -1984,6 +2232,12 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
         "`fetch_tensors` must be provided when the callable has one or more "
         "outputs.");
   }
+  if (fetch_buffers != nullptr && !fetch_buffers->empty() &&
+      fetch_buffers->size() != executors_and_keys->output_types.size()) {
+    return errors::InvalidArgument(
+        "Expected ", executors_and_keys->output_types.size(),
+        " fetch buffers, but got ", fetch_buffers->size());
+  }
 
   size_t input_size = 0;
   bool any_resource_feeds = false;
@@ -2016,7 +2270,8 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
   // A specialized CallFrame implementation that takes advantage of the
   // optimized RunCallable interface.
   RunCallableCallFrame call_frame(this, executors_and_keys.get(),
-                                  actual_feed_tensors, fetch_tensors);
+                                  actual_feed_tensors, fetch_tensors,
+                                  fetch_buffers);
 
   if (LogMemory::IsEnabled()) {
     LogMemory::RecordStep(step_id, run_state_args.handle);
@@ -2027,6 +2282,9 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
       executors_and_keys.get(), run_metadata, threadpool_options));
 
   if (fetch_tensors != nullptr) {
+    if (executors_and_keys->uses_step_arenas) {
+      CopyOutOfStepArenas(fetch_tensors);
+    }
     size_t output_size = 0;
     for (auto& tensor : *fetch_tensors) {
       output_size += tensor.AllocatedBytes();
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_set.h"
 #include "tensorflow/core/common_runtime/executor.h"
 #include "tensorflow/core/common_runtime/graph_execution_state.h"
+#include "tensorflow/core/common_runtime/planned_step_slab.h"
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/common_runtime/session_factory.h"
@@ -131,6 +132,22 @@ class DirectSession : public Session {
       std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
       const thread::ThreadPoolOptions& threadpool_options) override;
 
+  // Like `RunCallable()`, but on entry `*fetch_tensors` may hold one
+  // caller-owned buffer per fetched output. When a buffer is aligned and has
+  // the type and number of elements of the fetched value, the kernel that
+  // produces the value writes it directly into the buffer (or, if the kernel
+  // does not allocate its output, the value is copied into the buffer), and
+  // the corresponding entry of `*fetch_tensors` shares the buffer on return.
+  // Otherwise the entry is replaced by a newly allocated tensor, as in
+  // `RunCallable()`. Uninitialized entries are treated as having no buffer.
+  //
+  // The buffers must not alias each other or any of the feeds, and must not
+  // be accessed by the caller until this method returns.
+  ::tensorflow::Status RunCallableWithBuffers(
+      CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+      std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
+      const thread::ThreadPoolOptions& threadpool_options);
+
   ::tensorflow::Status ReleaseCallable(CallableHandle handle) override;
 
   ::tensorflow::Status Finalize() override;
@@ -148,6 +165,13 @@ class DirectSession : public Session {
     Device* device = nullptr;                // not owned.
     FunctionLibraryRuntime* flib = nullptr;  // not owned.
     std::unique_ptr<Executor> executor;
+    // If not null, the capacity in bytes of the `StepArenaAllocator` to create
+    // for each step of this partition. Updated after each step from the
+    // peak number of bytes that the step's arena had reserved.
+    std::unique_ptr<std::atomic<size_t>> step_arena_capacity;
+    // If not null, the static memory plan of the tensors of this partition,
+    // from which a `PlannedStepSlab` is created for each step.
+    std::unique_ptr<StepSlabPlan> step_slab_plan;
   };
 
   // An ExecutorsAndKeys is created for a given set of feeds/fetches.
@@ -176,6 +200,10 @@ class DirectSession : public Session {
     CallableOptions callable_options;
 
     int64_t collective_graph_key = BuildGraphOptions::kNoCollectiveGraphKey;
+
+    // True iff any item uses a per-step arena, in which case the fetched
+    // tensors are copied out of it.
+    bool uses_step_arenas = false;
   };
 
   // A FunctionInfo object is created for every unique set of feeds/fetches.
@@ -368,6 +396,14 @@ class DirectSession : public Session {
       TF_GUARDED_BY(executor_lock_);
 
   class RunCallableCallFrame;
+  // Implements `RunCallable()` and `RunCallableWithBuffers()`. If
+  // `fetch_buffers` is non-null, it holds the caller-owned buffers for the
+  // fetched outputs.
+  ::tensorflow::Status RunCallableInternal(
+      CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+      std::vector<Tensor>* fetch_tensors,
+      const std::vector<Tensor>* fetch_buffers, RunMetadata* run_metadata,
+      const thread::ThreadPoolOptions& threadpool_options);
   struct Callable {
     std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
     std::shared_ptr<FunctionInfo> function_info;
@@ -396,6 +432,11 @@ class DirectSession : public Session {
   std::unordered_map<string, string> stateful_placements_
       TF_GUARDED_BY(graph_state_lock_);
 
+  // Fingerprint of the graph the session was created and extended with, used
+  // to key the entries of `ConfigProto.Experimental.graph_cache_dir`. Only
+  // computed when the graph cache is enabled.
+  uint64_t graph_fingerprint_ TF_GUARDED_BY(graph_state_lock_) = 0;
+
   // Execution_state; used when placing the entire graph.
   std::unique_ptr<GraphExecutionState> execution_state_
       TF_GUARDED_BY(graph_state_lock_);
@@ -0,0 +1,139 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/direct_session_graph_cache.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+std::string EntryPath(const std::string& dir, uint64_t key) {
+  return io::JoinPath(
+      dir, absl::StrCat("graph_", absl::Hex(key, absl::kZeroPad16), ".pb"));
+}
+
+}  // namespace
+
+uint64_t FingerprintDirectSessionGraph(const GraphDef& graph,
+                                       uint64_t previous) {
+  return FingerprintCat64(previous, DeterministicProtoHash64(graph));
+}
+
+uint64_t DirectSessionGraphCacheKey(uint64_t graph_fingerprint,
+                                    const ConfigProto& config,
+                                    const BuildGraphOptions& options,
+                                    const std::vector<Device*>& devices) {
+  // The kernels and optimizations available depend on the build, so entries
+  // are never shared between versions.
+  uint64_t key = Fingerprint64(TF_VERSION_STRING);
+  key = FingerprintCat64(key, graph_fingerprint);
+  // The location of the cache does not affect the graphs.
+  ConfigProto keyed_config = config;
+  keyed_config.mutable_experimental()->clear_graph_cache_dir();
+  key = FingerprintCat64(key, DeterministicProtoHash64(keyed_config));
+  key = FingerprintCat64(key,
+                         DeterministicProtoHash64(options.callable_options));
+  key = FingerprintCat64(key, options.use_function_convention);
+  key = FingerprintCat64(key, options.collective_graph_key);
+  key = FingerprintCat64(key, static_cast<uint64_t>(options.collective_order));
+  for (const Device* device : devices) {
+    // The incarnation of a device changes on every restart, so it is not part
+    // of the key.
+    key = FingerprintCat64(key, Fingerprint64(device->name()));
+    key = FingerprintCat64(key, Fingerprint64(device->device_type()));
+    key = FingerprintCat64(
+        key, Fingerprint64(device->attributes().physical_device_desc()));
+  }
+  return key;
+}
+
+Status ReadDirectSessionGraphCacheEntry(const std::string& dir, uint64_t key,
+                                        DirectSessionGraphCacheEntry* entry) {
+  const std::string path = EntryPath(dir, key);
+  Env* env = Env::Default();
+  TF_RETURN_IF_ERROR(env->FileExists(path));
+  TF_RETURN_IF_ERROR(ReadBinaryProto(env, path, entry));
+  if (entry->key() != key) {
+    return errors::DataLoss("Graph cache entry ", path, " has key ",
+                            entry->key(), ", expected ", key);
+  }
+  return absl::OkStatus();
+}
+
+Status ValidateDirectSessionGraphCacheEntry(
+    const DirectSessionGraphCacheEntry& entry,
+    const BuildGraphOptions& options, const std::vector<Device*>& devices) {
+  const CallableOptions& callable_options = options.callable_options;
+  if (entry.feed_types_size() != callable_options.feed_size() ||
+      entry.fetch_types_size() != callable_options.fetch_size()) {
+    return errors::DataLoss("Graph cache entry ", entry.key(), " has ",
+                            entry.feed_types_size(), " feed and ",
+                            entry.fetch_types_size(), " fetch types, expected ",
+                            callable_options.feed_size(), " and ",
+                            callable_options.fetch_size());
+  }
+  auto check_types = [&entry](const auto& types) -> Status {
+    for (int type : types) {
+      if (!DataType_IsValid(type) || type == DT_INVALID) {
+        return errors::DataLoss("Graph cache entry ", entry.key(),
+                                " has invalid type ", type);
+      }
+    }
+    return absl::OkStatus();
+  };
+  TF_RETURN_IF_ERROR(check_types(entry.feed_types()));
+  TF_RETURN_IF_ERROR(check_types(entry.fetch_types()));
+  if (entry.partitions().empty()) {
+    return errors::DataLoss("Graph cache entry ", entry.key(),
+                            " has no partitions");
+  }
+  absl::flat_hash_set<std::string> device_names;
+  for (const Device* device : devices) device_names.insert(device->name());
+  for (const auto& partition : entry.partitions()) {
+    if (!device_names.contains(partition.first)) {
+      return errors::DataLoss("Graph cache entry ", entry.key(),
+                              " has a partition for unknown device ",
+                              partition.first);
+    }
+  }
+  return absl::OkStatus();
+}
+
+Status WriteDirectSessionGraphCacheEntry(
+    const std::string& dir, const DirectSessionGraphCacheEntry& entry) {
+  Env* env = Env::Default();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(dir));
+  // Write to a temporary file first, so that readers never observe a
+  // partially written entry.
+  const std::string path = EntryPath(dir, entry.key());
+  const std::string temp_path =
+      absl::StrCat(path, ".tmp.", absl::Hex(random::New64()));
+  Status s = WriteBinaryProto(env, temp_path, entry);
+  if (s.ok()) s = env->RenameFile(temp_path, path);
+  if (!s.ok()) env->DeleteFile(temp_path).IgnoreError();
+  return s;
+}
+
+}  // namespace tensorflow
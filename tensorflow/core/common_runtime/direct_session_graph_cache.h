@@ -0,0 +1,67 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_DIRECT_SESSION_GRAPH_CACHE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_DIRECT_SESSION_GRAPH_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/build_graph_options.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/direct_session_graph_cache.pb.h"
+
+namespace tensorflow {
+
+// Helpers for the on-disk cache of the graphs that DirectSession builds for
+// each callable (see `ConfigProto.Experimental.graph_cache_dir`).
+
+// Returns a fingerprint of `graph`, which is stable across processes.
+// `previous` is the fingerprint of the graph that `graph` extends, if any.
+uint64_t FingerprintDirectSessionGraph(const GraphDef& graph,
+                                       uint64_t previous = 0);
+
+// Returns the key of the cache entry for the graphs built for `options`, in a
+// session created from a graph with fingerprint `graph_fingerprint`, with
+// configuration `config`, on `devices`.
+uint64_t DirectSessionGraphCacheKey(uint64_t graph_fingerprint,
+                                    const ConfigProto& config,
+                                    const BuildGraphOptions& options,
+                                    const std::vector<Device*>& devices);
+
+// Reads the entry with key `key` from the cache in `dir`. Returns NotFound if
+// there is no such entry.
+Status ReadDirectSessionGraphCacheEntry(const std::string& dir, uint64_t key,
+                                        DirectSessionGraphCacheEntry* entry);
+
+// Checks that `entry` can be used in place of the graphs built for
+// `options` on `devices`: it must have one feed and fetch type per feed and
+// fetch of `options.callable_options`, and a partition for one of `devices`
+// only. Returns DataLoss otherwise.
+Status ValidateDirectSessionGraphCacheEntry(
+    const DirectSessionGraphCacheEntry& entry,
+    const BuildGraphOptions& options, const std::vector<Device*>& devices);
+
+// Writes `entry` to the cache in `dir`, replacing any existing entry with the
+// same key. Concurrent readers observe either the old or the new entry.
+Status WriteDirectSessionGraphCacheEntry(
+    const std::string& dir, const DirectSessionGraphCacheEntry& entry);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_DIRECT_SESSION_GRAPH_CACHE_H_
@@ -27,11 +27,15 @@ limitations under the License.
 #include "absl/strings/match.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/direct_session_graph_cache.h"
 #include "tensorflow/core/common_runtime/function_testlib.h"
+#include "tensorflow/core/common_runtime/planned_step_slab.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/costmodel.h"
@@ -43,6 +47,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/stacktrace.h"
@@ -153,6 +158,82 @@ TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork) {
   EXPECT_FLOAT_EQ(5.0, mat(0, 0));
 }
 
+TEST(DirectSessionTest, CopiesFetchesOutOfStepArenas) {
+  Graph g(OpRegistry::Global());
+  Node* x;
+  TF_ASSERT_OK(NodeBuilder("x", "Placeholder")
+                   .Attr("shape", TensorShape({4}))
+                   .Attr("dtype", DT_FLOAT)
+                   .Finalize(&g, &x));
+  Node* y = test::graph::Unary(&g, "Neg", x);
+  GraphDef def;
+  g.ToGraphDef(&def);
+
+  SessionOptions options = DefaultSessionOptions();
+  options.config.mutable_experimental()->set_use_per_step_arena_allocator(
+      true);
+  std::unique_ptr<Session> session(NewSession(options));
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def));
+
+  Tensor x_value = test::AsTensor<float>({1, 2, 3, 4});
+  // The first step sizes the arena of the second one, which serves `y`.
+  for (int i = 0; i < 2; ++i) {
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(
+        session->Run({{"x", x_value}}, {y->name() + ":0"}, {}, &outputs));
+    ASSERT_EQ(1, outputs.size());
+    test::ExpectTensorEqual<float>(outputs[0],
+                                   test::AsTensor<float>({-1, -2, -3, -4}));
+    TensorDescription description;
+    outputs[0].FillDescription(&description);
+    EXPECT_NE(description.allocation_description().allocator_name(),
+              StepArenaAllocator::kName);
+  }
+}
+
+TEST(DirectSessionTest, ServesPlannedTensorsFromStepSlabs) {
+  // `y` has a static shape, differs in size from the tensors that it could be
+  // forwarded from or to, and does not escape the step, so it is served from
+  // the step's slab.
+  Graph g(OpRegistry::Global());
+  Node* x = test::graph::Constant(
+      &g, test::AsTensor<float>({1, 2, 3, 4, 5, 6}, TensorShape({2, 3})));
+  Node* y = test::graph::Matmul(&g, x, x, /*transpose_a=*/false,
+                                /*transpose_b=*/true);
+  Node* z = test::graph::Matmul(&g, y, x, /*transpose_a=*/false,
+                                /*transpose_b=*/false);
+  GraphDef def;
+  g.ToGraphDef(&def);
+
+  SessionOptions options = DefaultSessionOptions();
+  options.config.mutable_experimental()->set_use_per_step_arena_allocator(
+      true);
+  // Keep `y` from being folded away.
+  options.config.mutable_graph_options()
+      ->mutable_optimizer_options()
+      ->set_opt_level(OptimizerOptions::L0);
+  options.config.mutable_graph_options()
+      ->mutable_rewrite_options()
+      ->set_constant_folding(RewriterConfig::OFF);
+  std::unique_ptr<Session> session(NewSession(options));
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def));
+
+  for (int i = 0; i < 2; ++i) {
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(session->Run({}, {z->name() + ":0"}, {}, &outputs));
+    ASSERT_EQ(1, outputs.size());
+    test::ExpectTensorEqual<float>(
+        outputs[0], test::AsTensor<float>({142, 188, 234, 340, 449, 558},
+                                          TensorShape({2, 3})));
+    TensorDescription description;
+    outputs[0].FillDescription(&description);
+    EXPECT_NE(description.allocation_description().allocator_name(),
+              PlannedStepSlab::kName);
+  }
+}
+
 TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_Callable) {
   Initialize({3, 2, -1, 0});
   auto session = CreateSession();
@@ -767,6 +848,114 @@ TEST_F(DirectSessionMinusAXTest, RunSimpleNetworkWithOpts_Callable) {
   EXPECT_EQ(run_metadata.step_stats().dev_stats_size(), 2);
 }
 
+TEST_F(DirectSessionMinusAXTest, RunCallableWithBuffers) {
+  Initialize({3, 2, -1, 0});
+  auto session = CreateSession();
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+  DirectSession* direct_session = static_cast<DirectSession*>(session.get());
+
+  // `y_` is allocated by its kernel, while `z_` is an Identity of a tensor
+  // received from another device.
+  Session::CallableHandle handle;
+  TF_ASSERT_OK(session->MakeCallable(
+      MakeCallableOptions({}, {y_ + ":0", z_ + ":0", y_ + ":0"}, {}),
+      &handle));
+
+  Tensor y_buffer(DT_FLOAT, TensorShape({2, 1}));
+  Tensor z_buffer(DT_FLOAT, TensorShape({2, 1}));
+  // A buffer of the wrong size is ignored.
+  Tensor small_buffer(DT_FLOAT, TensorShape({1}));
+  for (int i = 0; i < 2; ++i) {
+    std::vector<Tensor> outputs = {y_buffer, z_buffer, small_buffer};
+    TF_ASSERT_OK(direct_session->RunCallableWithBuffers(
+        handle, {}, &outputs, nullptr, thread::ThreadPoolOptions()));
+
+    ASSERT_EQ(3, outputs.size());
+    EXPECT_TRUE(outputs[0].SharesBufferWith(y_buffer));
+    EXPECT_TRUE(outputs[1].SharesBufferWith(z_buffer));
+    EXPECT_FALSE(outputs[2].SharesBufferWith(small_buffer));
+    test::ExpectTensorEqual<float>(
+        y_buffer, test::AsTensor<float>({5, -1}, TensorShape({2, 1})));
+    test::ExpectTensorEqual<float>(
+        z_buffer, test::AsTensor<float>({-5, 1}, TensorShape({2, 1})));
+    test::ExpectTensorEqual<float>(outputs[2], y_buffer);
+  }
+
+  std::vector<Tensor> outputs = {y_buffer};
+  Status s = direct_session->RunCallableWithBuffers(
+      handle, {}, &outputs, nullptr, thread::ThreadPoolOptions());
+  EXPECT_TRUE(errors::IsInvalidArgument(s));
+  EXPECT_TRUE(absl::StrContains(s.message(), "fetch buffers"));
+  TF_ASSERT_OK(session->ReleaseCallable(handle));
+}
+
+TEST_F(DirectSessionMinusAXTest, GraphCacheAcrossSessions) {
+  const string cache_dir = io::JoinPath(testing::TmpDir(), "graph_cache");
+  SessionOptions options = DefaultSessionOptions();
+  options.config.mutable_experimental()->set_graph_cache_dir(cache_dir);
+  Env* env = Env::Default();
+
+  auto run_session = [&options](const GraphDef& def, const string& fetch,
+                                float expected) {
+    std::unique_ptr<Session> session(NewSession(options));
+    ASSERT_TRUE(session != nullptr);
+    TF_ASSERT_OK(session->Create(def));
+    Session::CallableHandle handle;
+    TF_ASSERT_OK(
+        session->MakeCallable(MakeCallableOptions({}, {fetch}, {}), &handle));
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(session->RunCallable(handle, {}, &outputs, nullptr));
+    ASSERT_EQ(1, outputs.size());
+    EXPECT_FLOAT_EQ(expected, outputs[0].matrix<float>()(0, 0));
+  };
+
+  Initialize({3, 2, -1, 0});
+  run_session(def_, z_ + ":0", -5.0);
+  std::vector<string> entries;
+  TF_ASSERT_OK(env->GetChildren(cache_dir, &entries));
+  ASSERT_EQ(1, entries.size());
+
+  // A second session with the same graph reuses the entry.
+  run_session(def_, z_ + ":0", -5.0);
+  entries.clear();
+  TF_ASSERT_OK(env->GetChildren(cache_dir, &entries));
+  ASSERT_EQ(1, entries.size());
+
+  // A corrupt entry is ignored, and replaced.
+  const string entry_path = io::JoinPath(cache_dir, entries[0]);
+  TF_ASSERT_OK(WriteStringToFile(env, entry_path, "not a graph"));
+  run_session(def_, z_ + ":0", -5.0);
+  DirectSessionGraphCacheEntry entry;
+  TF_ASSERT_OK(ReadBinaryProto(env, entry_path, &entry));
+  EXPECT_FALSE(entry.partitions().empty());
+
+  // An entry that does not match the session is ignored, and replaced.
+  const GraphDef partition = entry.partitions().begin()->second;
+  const string unknown_device = "/job:localhost/replica:0/task:0/device:FOO:0";
+  entry.clear_partitions();
+  (*entry.mutable_partitions())[unknown_device] = partition;
+  entry.add_fetch_types(DT_FLOAT);
+  TF_ASSERT_OK(WriteBinaryProto(env, entry_path, entry));
+  run_session(def_, z_ + ":0", -5.0);
+  TF_ASSERT_OK(ReadBinaryProto(env, entry_path, &entry));
+  EXPECT_EQ(1, entry.fetch_types_size());
+  for (const auto& partition_pair : entry.partitions()) {
+    EXPECT_NE(partition_pair.first, unknown_device);
+  }
+
+  // A different graph uses a different entry.
+  Initialize({1, 2, 3, 4});
+  run_session(def_, z_ + ":0", -3.0);
+  entries.clear();
+  TF_ASSERT_OK(env->GetChildren(cache_dir, &entries));
+  EXPECT_EQ(2, entries.size());
+
+  int64_t undeleted_files, undeleted_dirs;
+  TF_ASSERT_OK(
+      env->DeleteRecursively(cache_dir, &undeleted_files, &undeleted_dirs));
+}
+
 TEST_F(DirectSessionMinusAXTest, UseRunHandlerPool) {
   Initialize({3, 2, -1, 0});
   auto session = CreateSession();
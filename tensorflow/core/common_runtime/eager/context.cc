@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/context.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -68,6 +70,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/session_mgr.h"
 #endif  // !IS_MOBILE_PLATFORM
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/util/env_var.h"
@@ -101,6 +104,14 @@ auto* eager_context_created =
     monitoring::Gauge<bool, 0>::New("/tensorflow/core/eager_context_created",
                                     "True if an eager context was created.");
 
+auto* eager_kernel_cache_hits = monitoring::Counter<0>::New(
+    "/tensorflow/core/eager_kernel_cache_hits",
+    "The number of eager op dispatches that found a cached kernel.");
+
+auto* eager_kernel_cache_misses = monitoring::Counter<0>::New(
+    "/tensorflow/core/eager_kernel_cache_misses",
+    "The number of eager op dispatches that did not find a cached kernel.");
+
 }  // namespace
 
 const int64_t EagerContext::kGlobalRendezvousId = -1;
@@ -458,7 +469,10 @@ void EagerContext::ClearCachesAndDefaultExecutor() {
     // during this time as well.
     mutex_lock ml(cache_mu_);
     default_executor_.WaitForAllPendingNodes().IgnoreError();
-    kernel_cache_.clear();
+    for (KernelCacheShard& shard : kernel_cache_shards_) {
+      mutex_lock sl(shard.mu);
+      shard.kernels.clear();
+    }
     for (auto& entry : registered_functions_) {
       entry.second->cached_kernel_keys->clear();
     }
@@ -1075,7 +1089,16 @@ EagerContext::GetCacheStats() {
   CacheStats stats;
   {
     mutex_lock l(cache_mu_);
-    stats.kernel_cache_size = kernel_cache_.size();
+    stats.kernel_cache_size = 0;
+    stats.kernel_cache_hits = 0;
+    stats.kernel_cache_misses = 0;
+    for (KernelCacheShard& shard : kernel_cache_shards_) {
+      tf_shared_lock sl(shard.mu);
+      stats.kernel_cache_size += shard.kernels.size();
+      stats.kernel_cache_hits += shard.hits.load(std::memory_order_relaxed);
+      stats.kernel_cache_misses +=
+          shard.misses.load(std::memory_order_relaxed);
+    }
     for (const auto& iter : registered_functions_) {
       stats.func_kernel_cache_entries[iter.first] =
           iter.second->cached_kernel_keys->size();
@@ -1106,7 +1129,9 @@ Status EagerContext::RemoveFunction(const string& func) {
     is_last_ref = registered_function->RefCountIsOne();
     if (is_last_ref) {
       for (auto& key : *registered_function->cached_kernel_keys) {
-        kernel_cache_.erase(key);
+        KernelCacheShard& shard = GetKernelCacheShard(key);
+        mutex_lock sl(shard.mu);
+        shard.kernels.erase(key);
       }
       registered_functions_.erase(func);
     }
@@ -1189,11 +1214,18 @@ Status EagerContext::SyncExecutors() {
 
 core::RefCountPtr<KernelAndDevice> EagerContext::GetCachedKernel(
     Fprint128 cache_key) {
-  tf_shared_lock l(cache_mu_);
-  auto iter = kernel_cache_.find(cache_key);
-  if (iter == kernel_cache_.end()) {
+  static auto* hits = eager_kernel_cache_hits->GetCell();
+  static auto* misses = eager_kernel_cache_misses->GetCell();
+  KernelCacheShard& shard = GetKernelCacheShard(cache_key);
+  tf_shared_lock l(shard.mu);
+  auto iter = shard.kernels.find(cache_key);
+  if (iter == shard.kernels.end()) {
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+    misses->IncrementBy(1);
     return nullptr;
   }
+  shard.hits.fetch_add(1, std::memory_order_relaxed);
+  hits->IncrementBy(1);
   core::RefCountPtr<KernelAndDevice> new_ref(iter->second.get());
   new_ref->Ref();
   return new_ref;
@@ -1209,15 +1241,19 @@ Device* EagerContext::GetCachedDevice(Fprint128 device_cache_key) {
 core::RefCountPtr<KernelAndDevice> EagerContext::AddKernelToCache(
     Fprint128 cache_key, core::RefCountPtr<KernelAndDevice> kernel) {
   mutex_lock ml(cache_mu_);
-  auto iter = kernel_cache_.find(cache_key);
-  if (iter != kernel_cache_.end()) {
-    core::RefCountPtr<KernelAndDevice> new_ref(iter->second.get());
+  {
+    KernelCacheShard& shard = GetKernelCacheShard(cache_key);
+    mutex_lock sl(shard.mu);
+    auto iter = shard.kernels.find(cache_key);
+    if (iter != shard.kernels.end()) {
+      core::RefCountPtr<KernelAndDevice> new_ref(iter->second.get());
+      new_ref->Ref();
+      return new_ref;
+    }
+    core::RefCountPtr<KernelAndDevice> new_ref(kernel.get());
     new_ref->Ref();
-    return new_ref;
+    shard.kernels[cache_key] = std::move(new_ref);
   }
-  core::RefCountPtr<KernelAndDevice> new_ref(kernel.get());
-  new_ref->Ref();
-  kernel_cache_[cache_key] = std::move(new_ref);
   auto* registered_function =
       gtl::FindPtrOrNull(registered_functions_, kernel->name());
 
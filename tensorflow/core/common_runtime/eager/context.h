@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_CONTEXT_H_
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <functional>
@@ -770,9 +771,23 @@ class EagerContext : public ImmediateExecutionContext, public core::RefCounted {
 
     std::unique_ptr<std::vector<Fprint128>> cached_kernel_keys;
   };
-  std::unordered_map<Fprint128, core::RefCountPtr<KernelAndDevice>,
-                     Fprint128Hasher>
-      kernel_cache_ TF_GUARDED_BY(cache_mu_);
+  // The kernel cache is sharded by cache key, so that concurrent op dispatches
+  // don't contend on a single mutex. Where both are needed, `cache_mu_` is
+  // acquired before a shard's mutex. Lookups are counted per shard and summed
+  // by GetCacheStats().
+  static constexpr int kNumKernelCacheShards = 16;
+  struct alignas(64) KernelCacheShard {
+    mutex mu;
+    std::unordered_map<Fprint128, core::RefCountPtr<KernelAndDevice>,
+                       Fprint128Hasher>
+        kernels TF_GUARDED_BY(mu);
+    std::atomic<int64_t> hits{0};
+    std::atomic<int64_t> misses{0};
+  };
+  KernelCacheShard& GetKernelCacheShard(Fprint128 cache_key) {
+    return kernel_cache_shards_[cache_key.low64 % kNumKernelCacheShards];
+  }
+  std::array<KernelCacheShard, kNumKernelCacheShards> kernel_cache_shards_;
   std::unordered_map<string, RegisteredFunction*> registered_functions_
       TF_GUARDED_BY(cache_mu_);
 
@@ -15,22 +15,29 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/eager/context.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "tensorflow/core/common_runtime/eager/context_distributed_manager.h"
+#include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
 namespace {
 
+using ::tensorflow::monitoring::testing::CellReader;
 using ::testing::HasSubstr;
 
 typedef FunctionDefHelper FDH;
@@ -400,5 +407,51 @@ TEST_F(EagerContextTest, ReuseGlobalRendezvous) {
   TestGlobalRendezvous(context(), true);
 }
 
+// Returns a kernel that is only meant to be cached, not run.
+core::RefCountPtr<KernelAndDevice> CreateCacheOnlyKernel(const string& name) {
+  return core::RefCountPtr<KernelAndDevice>(new KernelAndDeviceFunc(
+      /*flr=*/nullptr, /*pflr=*/nullptr, /*input_devices=*/{},
+      /*composite_devices=*/{}, /*input_resource_dtypes_and_shapes=*/{},
+      /*runner=*/nullptr, /*collective_executor=*/nullptr,
+      /*host_cpu_device=*/nullptr, name, /*outputs_on_op_device=*/false,
+      /*allow_small_function_optimizations=*/false,
+      /*allow_control_flow_sync_execution=*/false,
+      /*shape_inference_on_tfe_dialect_import=*/true,
+      /*int_args_and_retvals_on_device=*/false,
+      /*xla_compile_device_type=*/std::nullopt,
+      /*allow_soft_placement=*/false,
+      /*rendezvous_factory=*/Rendezvous::Factory(),
+      /*get_op_id=*/nullptr));
+}
+
+TEST_F(EagerContextTest, CountsKernelCacheLookupsOfAllShards) {
+  InitContext(SessionOptions(), DEVICE_PLACEMENT_EXPLICIT);
+  CellReader<int64_t> hits("/tensorflow/core/eager_kernel_cache_hits");
+  CellReader<int64_t> misses("/tensorflow/core/eager_kernel_cache_misses");
+
+  // The low 64 bits of the keys spread them over all the shards.
+  constexpr int kNumKernels = 100;
+  for (uint64_t i = 0; i < kNumKernels; ++i) {
+    context()->AddKernelToCache(Fprint128{i, i},
+                                CreateCacheOnlyKernel(absl::StrCat("f", i)));
+  }
+  for (uint64_t i = 0; i < kNumKernels; ++i) {
+    core::RefCountPtr<KernelAndDevice> kernel =
+        context()->GetCachedKernel(Fprint128{i, i});
+    ASSERT_NE(kernel, nullptr);
+    EXPECT_EQ(kernel->name(), absl::StrCat("f", i));
+    EXPECT_EQ(context()->GetCachedKernel(Fprint128{i, i + 1}), nullptr);
+  }
+
+  const ImmediateExecutionContext::CacheStats stats =
+      context()->GetCacheStats();
+  EXPECT_EQ(stats.kernel_cache_size, kNumKernels);
+  EXPECT_EQ(stats.kernel_cache_hits, kNumKernels);
+  EXPECT_EQ(stats.kernel_cache_misses, kNumKernels);
+  // Each lookup is also exported to the monitoring counters.
+  EXPECT_EQ(hits.Delta(), kNumKernels);
+  EXPECT_EQ(misses.Delta(), kNumKernels);
+}
+
 }  // namespace
 }  // namespace tensorflow
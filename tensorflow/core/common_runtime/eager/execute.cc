@@ -1375,7 +1375,10 @@ Status GetOrCreateKernelAndDevice(
   std::unordered_map<int, DtypeAndPartialTensorShape>
       input_resource_variable_dtypes_and_shapes;
   const KernelDef* kernel_def = nullptr;
-  if (!op->is_function()) {
+  // The kernel def is only needed to find host memory arguments of ops that
+  // are wrapped in a function. Looking it up for every other op dispatch would
+  // cost a node def build and a kernel registry lookup even on cache hits.
+  if (!op->is_function() && ctx.RunEagerOpAsFunction()) {
     const NodeDef* node_def = &op->MutableAttrs()->BuildNodeDef();
     kernel_def = GetKernelDef(*op, node_def, device);
   }
@@ -1036,6 +1036,11 @@ Status TensorHandle::CopyToDevice(const EagerContext& ctx,
   if (src->dtype() == tensorflow::DT_VARIANT) {
     attr.set_on_host(true);
   }
+  if (dst_cpu && !src_cpu) {
+    // Copy into pinned host memory, which is DMA'd to at full bandwidth and
+    // can then be shared without a copy, e.g. with numpy or DLPack.
+    attr.set_gpu_compatible(true);
+  }
   const auto* dstd_info = dstd->tensorflow_accelerator_device_info();
   tensorflow::Tensor dst(dstd->GetAllocator(attr), src->dtype(), src->shape());
   if (src->shape().num_elements() == 0) {
@@ -26,9 +26,11 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/device.h"
+#include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
@@ -106,6 +108,45 @@ static std::unique_ptr<FakeDevice> CreateDevice(const char* type,
   return std::make_unique<FakeDevice>(attr, is_local);
 }
 
+// Copies float tensors of a FakeAllocatingDevice to the host.
+class FakeDeviceContext : public DeviceContext {
+ public:
+  void CopyDeviceTensorToCPU(const Tensor* device_tensor,
+                             StringPiece tensor_name, Device* device,
+                             Tensor* cpu_tensor, StatusCallback done) override {
+    cpu_tensor->flat<float>() = device_tensor->flat<float>();
+    done(absl::OkStatus());
+  }
+};
+
+// A device which allocates from the CPU allocator and counts the allocators
+// requested for GPU-compatible memory.
+class FakeAllocatingDevice : public Device {
+ public:
+  explicit FakeAllocatingDevice(const DeviceAttributes& attr)
+      : Device(nullptr, attr) {}
+  Status Sync() override { return absl::OkStatus(); }
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    if (attr.gpu_compatible()) ++num_gpu_compatible_allocators_;
+    return cpu_allocator();
+  }
+  int num_gpu_compatible_allocators() const {
+    return num_gpu_compatible_allocators_;
+  }
+
+ private:
+  int num_gpu_compatible_allocators_ = 0;
+};
+
+static std::unique_ptr<FakeAllocatingDevice> CreateAllocatingDevice(
+    const char* type, const char* name) {
+  DeviceAttributes attr;
+  attr.set_name(name);
+  attr.set_device_type(type);
+  attr.set_incarnation(random::New64() | 1);
+  return std::make_unique<FakeAllocatingDevice>(attr);
+}
+
 }  // namespace
 
 class PackedTensorHandleTest : public ::testing::Test {
@@ -756,6 +797,47 @@ TEST(TensorHandle_LocalTest, TensorFromDeviceInvalidDevice) {
               StatusIs(tensorflow::error::INTERNAL));
 }
 
+TEST(TensorHandle_LocalTest, CopyToHostAllocatesGpuCompatibleMemory) {
+  core::RefCountPtr<FakeDeviceContext> device_context(new FakeDeviceContext);
+  DeviceBase::AcceleratorDeviceInfo device_info;
+  device_info.default_context = device_context.get();
+  std::vector<std::unique_ptr<Device>> devices;
+  devices.push_back(CreateAllocatingDevice(
+      "CPU", "/job:localhost/replica:0/task:0/device:CPU:0"));
+  devices.push_back(CreateAllocatingDevice(
+      "GPU", "/job:localhost/replica:0/task:0/device:GPU:0"));
+  devices[1]->set_tensorflow_accelerator_device_info(&device_info);
+  auto* host = static_cast<FakeAllocatingDevice*>(devices[0].get());
+  Device* gpu = devices[1].get();
+  StaticDeviceMgr device_mgr(std::move(devices));
+
+  EagerContext* context = new EagerContext(
+      SessionOptions(),
+      tensorflow::ContextDevicePlacementPolicy::DEVICE_PLACEMENT_SILENT,
+      /* async= */ false, &device_mgr,
+      /* device_mgr_owned= */ false, /* rendezvous= */ nullptr,
+      /* cluster_flr= */ nullptr, /*collective_executor_mgr=*/nullptr,
+      /*run_eager_op_as_function=*/true);
+  absl::Cleanup context_cleanup = [&]() { context->Unref(); };
+
+  Tensor t0(DT_FLOAT, TensorShape({3}));
+  t0.flat<float>().setValues({1.0f, 2.0f, 3.0f});
+  TensorHandle* h =
+      TensorHandle::CreateLocalHandle(std::move(t0), gpu, gpu, gpu, context);
+  absl::Cleanup h_cleanup = [&]() { h->Unref(); };
+
+  const int num_gpu_compatible_allocators =
+      host->num_gpu_compatible_allocators();
+  tensorflow::Tensor tensor;
+  TF_ASSERT_OK(h->CopyToDevice(*context, /*d=*/nullptr, &tensor));
+  EXPECT_EQ(host->num_gpu_compatible_allocators(),
+            num_gpu_compatible_allocators + 1);
+  ASSERT_EQ(tensor.NumElements(), 3);
+  EXPECT_EQ(tensor.flat<float>()(0), 1.0f);
+  EXPECT_EQ(tensor.flat<float>()(1), 2.0f);
+  EXPECT_EQ(tensor.flat<float>()(2), 3.0f);
+}
+
 TEST(TensorHandle_ResourceShapeMirror, CreateAndCheckMirror) {
   std::vector<std::unique_ptr<Device>> devices;
   devices.push_back(
@@ -17,10 +17,12 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_join.h"
 #include "absl/time/time.h"
@@ -36,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/common_runtime/work_stealing_queue.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/collective.h"
@@ -62,11 +65,14 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/profile_utils/cpu_utils.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -80,6 +86,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 #include "tensorflow/core/util/determinism.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/managed_stack_trace.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 
@@ -90,6 +97,24 @@ namespace {
 // 1-D, 0 element tensor.
 static const Tensor* const kEmptyTensor = new Tensor;
 
+// Returns N such that the synchronous kernels of one in N steps record their
+// compute time in /tensorflow/core/op_latency_usecs, or 0 if no step does.
+int64_t OpLatencySamplingInterval() {
+  static const int64_t interval = [] {
+    int64_t value;
+    Status status =
+        ReadInt64FromEnvVar("TF_OP_LATENCY_SAMPLING_INTERVAL", 0, &value);
+    if (!status.ok() || value < 0) {
+      LOG(ERROR) << "Invalid TF_OP_LATENCY_SAMPLING_INTERVAL, op latency is "
+                    "not sampled: "
+                 << status;
+      return int64_t{0};
+    }
+    return value;
+  }();
+  return interval;
+}
+
 // Helper routines for collecting step stats.
 namespace nodestats {
 inline int64_t NowInNsec() { return EnvTime::NowNanos(); }
@@ -147,11 +172,31 @@ typedef gtl::InlinedVector<AllocatorAttributes, 4> AllocatorAttributeVec;
 
 class ExecutorImpl : public Executor {
  public:
-  explicit ExecutorImpl(const LocalExecutorParams& p) : immutable_state_(p) {}
+  struct Options {
+    // If true, ready nodes are dispatched through per-worker work-stealing
+    // queues.
+    bool use_work_stealing = false;
+    // If true, the cost of every kernel is measured, the estimates are shared
+    // with the other executors of the same graph on the same device, and
+    // inexpensive nodes that become ready together are run from one closure.
+    bool learn_kernel_costs = false;
+  };
+
+  explicit ExecutorImpl(const LocalExecutorParams& p)
+      : ExecutorImpl(p, Options()) {}
+  ExecutorImpl(const LocalExecutorParams& p, const Options& options)
+      : immutable_state_(p), learn_kernel_costs_(options.learn_kernel_costs) {
+    if (options.use_work_stealing) {
+      num_numa_nodes_ = port::NUMAEnabled() ? port::NUMANumNodes() : 1;
+      num_work_stealing_workers_ = port::MaxParallelism();
+    }
+  }
 
   Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
-    kernel_stats_.Initialize(immutable_state_.graph_view());
+    kernel_stats_.Initialize(immutable_state_.graph_view(),
+                             learn_kernel_costs_ ? GraphFingerprint() : 0,
+                             learn_kernel_costs_);
     return absl::OkStatus();
   }
 
@@ -161,20 +206,63 @@ class ExecutorImpl : public Executor {
   template <class PropagatorStateType>
   friend class ExecutorState;
 
+  // Returns a fingerprint of the kernels of the graph and of the device, which
+  // identifies the executors whose kernel cost estimates can be shared.
+  uint64 GraphFingerprint() const {
+    const GraphView& gview = immutable_state_.graph_view();
+    uint64 fingerprint =
+        Fingerprint64(immutable_state_.params().device->name());
+    for (int32_t i = 0; i < gview.num_nodes(); ++i) {
+      const NodeItem* item = gview.node(i);
+      if (item == nullptr || item->kernel == nullptr) continue;
+      fingerprint = FingerprintCat64(fingerprint,
+                                     Fingerprint64(item->kernel->name()));
+      fingerprint = FingerprintCat64(
+          fingerprint, Fingerprint64(item->kernel->type_string()));
+    }
+    return fingerprint;
+  }
+
   // Stores execution time information about the kernels in an executor's graph.
   class KernelStats {
    public:
     KernelStats() = default;
 
-    void Initialize(const GraphView& gview) {
+    // If `learn_costs` is true, the cost of every kernel is tracked, starting
+    // from an estimate based on kernel->IsExpensive(), and the estimates are
+    // shared with every other executor whose graph has the same
+    // `graph_fingerprint`. Otherwise, only the costs of kernels for which
+    // kernel->IsExpensive() returns true are tracked.
+    void Initialize(const GraphView& gview, uint64 graph_fingerprint,
+                    bool learn_costs) {
+      learn_costs_ = learn_costs;
       is_expensive_.resize(gview.num_nodes());
-      cost_estimates_ =
-          std::make_unique<std::atomic_uint_fast64_t[]>(gview.num_nodes());
+      bool initialize_estimates = true;
+      if (learn_costs) {
+        estimates_ = GetSharedCostEstimates(
+            graph_fingerprint, gview.num_nodes(), [&](CostEstimates* e) {
+              // Kernels that claim to be inexpensive start out inline, and
+              // are only dispatched to other threads once measured otherwise.
+              for (int32_t i = 0; i < gview.num_nodes(); ++i) {
+                const NodeItem* item = gview.node(i);
+                const bool marked_expensive =
+                    item && item->kernel && item->kernel->IsExpensive();
+                e->cycles[i] =
+                    marked_expensive ? kInitialCostEstimateCycles : 0;
+              }
+            });
+        initialize_estimates = false;
+      } else {
+        estimates_ = std::make_shared<CostEstimates>(gview.num_nodes());
+      }
+      cost_estimates_ = estimates_->cycles.get();
       for (int32_t i = 0; i < gview.num_nodes(); ++i) {
         if (gview.node(i)) {
-          is_expensive_[i] =
-              gview.node(i)->kernel && gview.node(i)->kernel->IsExpensive();
-          cost_estimates_[i] = kInitialCostEstimateCycles;
+          OpKernel* kernel = gview.node(i)->kernel;
+          is_expensive_[i] = kernel && (learn_costs || kernel->IsExpensive());
+          if (initialize_estimates) {
+            cost_estimates_[i] = kInitialCostEstimateCycles;
+          }
         }
       }
     }
@@ -188,11 +276,16 @@ class ExecutorImpl : public Executor {
               kOpIsExpensiveThresholdCycles);
     }
 
-    // Returns the value of kernel->IsExpensive().
-    bool HasExpensiveMarker(const NodeItem& node) const {
+    // Returns true iff the cost of the given node is tracked, i.e. if
+    // kernel->IsExpensive() is true or if every kernel's cost is learned.
+    bool TracksCost(const NodeItem& node) const {
       return is_expensive_[node.node_id];
     }
 
+    // Returns true iff the costs of all kernels are learned, in which case
+    // inexpensive nodes that become ready together are run from one closure.
+    bool learns_costs() const { return learn_costs_; }
+
     // Updates the dynamic cost estimate, which is used to determine whether the
     // given node is expensive. The new cost estimate is a weighted average of
     // the old cost estimate and the latest cost. We only update cost estimates
@@ -218,14 +311,69 @@ class ExecutorImpl : public Executor {
     static constexpr uint64 kOpIsExpensiveThresholdCycles = 8000;
     static constexpr uint64 kCostDecay = 10;
 
+    // The cost estimates of the nodes of a graph, indexed by node id.
+    struct CostEstimates {
+      explicit CostEstimates(int num_nodes)
+          : num_nodes(num_nodes),
+            cycles(std::make_unique<std::atomic_uint_fast64_t[]>(num_nodes)) {}
+      const int num_nodes;
+      std::unique_ptr<std::atomic_uint_fast64_t[]> cycles;
+    };
+
+    // Returns the cost estimates shared by the executors of graphs with the
+    // given fingerprint, creating and initializing them with `init` if no
+    // such executor exists.
+    static std::shared_ptr<CostEstimates> GetSharedCostEstimates(
+        uint64 graph_fingerprint, int num_nodes,
+        const std::function<void(CostEstimates*)>& init) {
+      static mutex* mu = new mutex;
+      // Guarded by `mu`.
+      static auto* registry =
+          new absl::flat_hash_map<uint64, std::weak_ptr<CostEstimates>>;
+      {
+        mutex_lock l(*mu);
+        auto it = registry->find(graph_fingerprint);
+        if (it != registry->end()) {
+          std::shared_ptr<CostEstimates> existing = it->second.lock();
+          if (existing && existing->num_nodes == num_nodes) return existing;
+        }
+      }
+      // Initialize the estimates before publishing them.
+      auto estimates = std::make_shared<CostEstimates>(num_nodes);
+      init(estimates.get());
+      mutex_lock l(*mu);
+      std::weak_ptr<CostEstimates>& entry = (*registry)[graph_fingerprint];
+      std::shared_ptr<CostEstimates> existing = entry.lock();
+      if (existing && existing->num_nodes == num_nodes) return existing;
+      entry = estimates;
+      // Drop the entries of graphs that no longer have an executor.
+      for (auto it = registry->begin(); it != registry->end();) {
+        if (it->second.expired()) {
+          registry->erase(it++);
+        } else {
+          ++it;
+        }
+      }
+      return estimates;
+    }
+
+    bool learn_costs_ = false;
     std::vector<bool> is_expensive_;
-    // std::unique_ptr<std::atomic<bool>[]> is_expensive_;
-    std::unique_ptr<std::atomic_uint_fast64_t[]> cost_estimates_;
+    std::shared_ptr<CostEstimates> estimates_;
+    // Points to `estimates_->cycles`.
+    std::atomic_uint_fast64_t* cost_estimates_ = nullptr;
   };
 
   ImmutableExecutorState immutable_state_;
+  const bool learn_kernel_costs_;
   KernelStats kernel_stats_;
 
+  // If positive, each step dispatches expensive nodes through a
+  // `WorkStealingQueueSet` with this many per-worker queues, partitioned
+  // across `num_numa_nodes_` NUMA nodes.
+  int num_work_stealing_workers_ = 0;
+  int num_numa_nodes_ = 1;
+
   ExecutorImpl(const ExecutorImpl&) = delete;
   void operator=(const ExecutorImpl&) = delete;
 };
@@ -284,7 +432,8 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                ExecutorImpl::KernelStats* kernel_stats_,
+                int num_work_stealing_workers = 0, int num_numa_nodes = 1);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -346,6 +495,13 @@ class ExecutorState {
   template <typename Closure>
   void RunTask(Closure&& c, int sample_rate = 0);
 
+  // Dispatches `tagged_node` to be processed by another thread. In
+  // work-stealing mode the node is pushed onto the calling worker's queue and
+  // the closure handed to `runner_` pops (or steals) a node when it runs;
+  // otherwise the closure processes `tagged_node` directly.
+  void RunNodeTask(const TaggedNode& tagged_node, int64_t scheduled_nsec,
+                   int sample_rate);
+
   // Clean up when this executor is done.
   void Finish();
   void ScheduleFinish();
@@ -359,6 +515,9 @@ class ExecutorState {
   // true if LogMemory::IsEnabled(). Used to check memory enabled cheaply.
   const bool log_memory_;
 
+  // true if the kernel latencies of this step are recorded.
+  const bool sample_op_latency_;
+
   int64_t step_id_;
   int64_t trace_id_;  // for profiler.
   int64_t start_time_usecs_ = 0;
@@ -395,12 +554,17 @@ class ExecutorState {
   absl::optional<ManagedStackTrace> stack_trace_ = absl::nullopt;
   // If not null, use this device to schedule intra-op operation
   std::unique_ptr<DeviceBase> user_device_;
+  Allocator* step_allocator_;
+  std::function<Allocator*(int)> node_step_allocator_;
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
 
   PropagatorStateType propagator_;
 
+  // Per-worker ready queues, or nullptr if work stealing is disabled.
+  std::unique_ptr<WorkStealingQueueSet<TaggedNode>> work_stealing_queues_;
+
   // Invoked when the execution finishes.
   Executor::DoneCallback done_cb_;
 
@@ -419,9 +583,12 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    ExecutorImpl::KernelStats* kernel_stats, int num_work_stealing_workers,
+    int num_numa_nodes)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
+      sample_op_latency_(OpLatencySamplingInterval() > 0 &&
+                         args.step_id % OpLatencySamplingInterval() == 0),
       step_id_(args.step_id),
       trace_id_(args.function_trace_id ? *args.function_trace_id : step_id_),
       start_time_usecs_(args.start_time_usecs),
@@ -445,6 +612,8 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       cancellation_manager_(args.cancellation_manager),
       coordination_service_agent_(args.coordination_service_agent),
       stack_trace_(args.stack_trace),
+      step_allocator_(args.step_allocator),
+      node_step_allocator_(args.node_step_allocator),
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
       run_all_kernels_inline_(args.run_all_kernels_inline),
@@ -455,6 +624,11 @@ ExecutorState<PropagatorStateType>::ExecutorState(
     user_device_ = RenamedDevice::NewRenamedDevice(
         device->name(), device, false, false, args.user_intra_op_threadpool);
   }
+  if (num_work_stealing_workers > 0 && !run_all_kernels_inline_) {
+    work_stealing_queues_ =
+        std::make_unique<WorkStealingQueueSet<TaggedNode>>(
+            num_work_stealing_workers, num_numa_nodes);
+  }
 }
 
 template <class PropagatorStateType>
@@ -489,6 +663,30 @@ void ExecutorState<PropagatorStateType>::RunTask(Closure&& c, int sample_rate) {
   });
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::RunNodeTask(
+    const TaggedNode& tagged_node, int64_t scheduled_nsec, int sample_rate) {
+  if (work_stealing_queues_ == nullptr) {
+    RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
+                      scheduled_nsec),
+            sample_rate);
+    return;
+  }
+  work_stealing_queues_->Push(work_stealing_queues_->CurrentWorker(),
+                              tagged_node);
+  RunTask(
+      [this, scheduled_nsec]() {
+        WorkStealingQueueSet<TaggedNode>* queues = work_stealing_queues_.get();
+        const int worker = queues->CurrentWorker();
+        // Every closure is paired with exactly one pushed node, and is
+        // scheduled after that push, so there is always at least one node
+        // that no other closure has claimed. This also keeps `this` alive,
+        // because the unclaimed node has not yet completed.
+        Process(queues->PopOrStealWithBackoff(worker), scheduled_nsec);
+      },
+      sample_rate);
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::RunAsync(Executor::DoneCallback done) {
   TaggedNodeSeq ready;
@@ -592,6 +790,8 @@ Status ExecutorState<PropagatorStateType>::ProcessSync(
   OpKernel* op_kernel = item.kernel;
   Device* device = immutable_state_.params().device;
   const bool is_expensive = kernel_stats_->IsExpensive(item);
+  const uint64 sample_start_nsecs =
+      sample_op_latency_ ? EnvTime::NowNanos() : 0;
 
   if (TF_PREDICT_FALSE(MightTrace(event_collector_, is_expensive))) {
     tracing::ScopedRegion region(tracing::EventCategory::kCompute,
@@ -603,7 +803,7 @@ Status ExecutorState<PropagatorStateType>::ProcessSync(
         },
         profiler::GetTFTraceMeLevel(is_expensive));
     device->Compute(op_kernel, &ctx);
-  } else if (kernel_stats_->HasExpensiveMarker(item)) {
+  } else if (kernel_stats_->TracksCost(item)) {
     KernelTimer timer;
     device->Compute(op_kernel, &ctx);
     // For expensive kernels, always update the cost estimate. For inexpensive
@@ -617,6 +817,10 @@ Status ExecutorState<PropagatorStateType>::ProcessSync(
   } else {
     device->Compute(op_kernel, &ctx);
   }
+  if (TF_PREDICT_FALSE(sample_op_latency_)) {
+    const uint64 latency_nsecs = EnvTime::NowNanos() - sample_start_nsecs;
+    metrics::RecordOpLatency(op_kernel->type_string(), latency_nsecs / 1000);
+  }
   nodestats::SetOpEnd(stats);
   if (outputs->size() < item.num_outputs) outputs->resize(item.num_outputs);
   s = ProcessOutputs(item, &ctx, outputs->data(), stats);
@@ -803,6 +1007,8 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
   NodeExecStatsInterface* stats = nullptr;
 
   EntryVector outputs(1);
+  // Caller-owned buffers for the outputs of the current node, if any.
+  gtl::InlinedVector<const Tensor*, 4> output_buffers;
 
   bool completed = false;
   int64_t last_iter_num = -1;
@@ -912,11 +1118,35 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
 
       // Set up compute params.
       params->op_kernel = item.kernel;
+      // Stateful kernels may keep the tensors that they allocate beyond the
+      // step, so they do not allocate from the step's arena.
+      params->step_allocator = nullptr;
+      if (!item.is_stateful) {
+        if (node_step_allocator_) {
+          params->step_allocator = node_step_allocator_(id);
+        }
+        if (params->step_allocator == nullptr) {
+          params->step_allocator = step_allocator_;
+        }
+      }
       params->frame_iter = propagator_.GetFrameAndIter(tagged_node);
       params->is_input_dead = is_input_dead;
       params->output_attr_array = item.output_attrs();
       params->forward_from_array = item.forward_from();
       params->outputs_required_array = item.outputs_required.get();
+      params->output_buffers = nullptr;
+      if (TF_PREDICT_FALSE(item.output_retval_index != nullptr) &&
+          call_frame_ != nullptr && !item.kernel_is_async) {
+        output_buffers.assign(item.num_outputs, nullptr);
+        bool any_output_buffers = false;
+        for (int i = 0; i < item.num_outputs; ++i) {
+          const int index = item.output_retval_index[i];
+          if (index < 0) continue;
+          output_buffers[i] = call_frame_->GetRetvalBuffer(index);
+          any_output_buffers |= (output_buffers[i] != nullptr);
+        }
+        if (any_output_buffers) params->output_buffers = output_buffers.data();
+      }
       params->inputs = *inputs;
       params->input_alloc_attrs = input_alloc_attrs;
 
@@ -1300,11 +1530,34 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   } else {
     const TaggedNode* curr_expensive_node = nullptr;
     TaggedNodeSeq expensive_nodes;
-    if (inline_ready == nullptr) {
+    if (inline_ready == nullptr && kernel_stats_->learns_costs()) {
+      // Schedule each expensive node on its own, and run all the inexpensive
+      // nodes from a single closure to save the per-closure overhead.
+      TaggedNodeSeq inexpensive_nodes;
+      for (auto& tagged_node : *ready) {
+        if (tagged_node.get_is_dead() ||
+            !kernel_stats_->IsExpensive(*tagged_node.node_item)) {
+          inexpensive_nodes.push_back(tagged_node);
+        } else {
+          RunNodeTask(tagged_node, scheduled_nsec,
+                      /*sample_rate=*/ready->size());
+        }
+      }
+      if (inexpensive_nodes.size() == 1) {
+        RunNodeTask(inexpensive_nodes.front(), scheduled_nsec,
+                    /*sample_rate=*/ready->size());
+      } else if (!inexpensive_nodes.empty()) {
+        RunTask([this, inexpensive_nodes = std::move(inexpensive_nodes),
+                 scheduled_nsec]() {
+          for (auto& tagged_node : inexpensive_nodes) {
+            Process(tagged_node, scheduled_nsec);
+          }
+        });
+      }
+    } else if (inline_ready == nullptr) {
       // Schedule to run all the ready ops in thread pool.
       for (auto& tagged_node : *ready) {
-        RunTask([=]() { Process(tagged_node, scheduled_nsec); },
-                /*sample_rate=*/ready->size());
+        RunNodeTask(tagged_node, scheduled_nsec, /*sample_rate=*/ready->size());
       }
     } else {
       for (auto& tagged_node : *ready) {
@@ -1332,9 +1585,8 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
     if (!expensive_nodes.empty()) {
       if (expensive_nodes.size() < kInlineScheduleReadyThreshold) {
         for (auto& tagged_node : expensive_nodes) {
-          RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
-                            scheduled_nsec),
-                  /*sample_rate=*/expensive_nodes.size());
+          RunNodeTask(tagged_node, scheduled_nsec,
+                      /*sample_rate=*/expensive_nodes.size());
         }
       } else {
         // There are too many ready expensive nodes. Schedule them in child
@@ -1361,9 +1613,8 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
                     },
                     profiler::GetTFTraceMeLevel(/*is_expensive=*/false));
                 for (auto& tagged_node : ready_chunk) {
-                  RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
-                                    scheduled_nsec),
-                          /*sample_rate=*/ready_chunk.size());
+                  RunNodeTask(tagged_node, scheduled_nsec,
+                              /*sample_rate=*/ready_chunk.size());
                 }
               });
           it = end;
@@ -1512,15 +1763,20 @@ void ExecutorState<PropagatorStateType>::Finish() {
 
 void ExecutorImpl::RunAsyncInternal(const Args& args, DoneCallback done) {
   if (OpOrderDeterminismRequired()) {
+    // Work stealing would reorder ready nodes, so it is not used when op
+    // order determinism is required.
     (new ExecutorState<OrderedPropagatorState>(args, immutable_state_,
                                                &kernel_stats_))
         ->RunAsync(std::move(done));
   } else if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        num_work_stealing_workers_,
+                                        num_numa_nodes_))
         ->RunAsync(std::move(done));
   } else {
-    (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+    (new ExecutorState<SimplePropagatorState>(
+         args, immutable_state_, &kernel_stats_, num_work_stealing_workers_,
+         num_numa_nodes_))
         ->RunAsync(std::move(done));
   }
 }
@@ -1539,6 +1795,26 @@ Status NewLocalExecutor(const LocalExecutorParams& params, const Graph& graph,
   return s;
 }
 
+Status NewWorkStealingLocalExecutor(const LocalExecutorParams& params,
+                                    const Graph& graph, Executor** executor) {
+  ExecutorImpl::Options options;
+  options.use_work_stealing = true;
+  auto impl = std::make_unique<ExecutorImpl>(params, options);
+  TF_RETURN_IF_ERROR(impl->Initialize(graph));
+  *executor = impl.release();
+  return absl::OkStatus();
+}
+
+Status NewCostLearningLocalExecutor(const LocalExecutorParams& params,
+                                    const Graph& graph, Executor** executor) {
+  ExecutorImpl::Options options;
+  options.learn_kernel_costs = true;
+  auto impl = std::make_unique<ExecutorImpl>(params, options);
+  TF_RETURN_IF_ERROR(impl->Initialize(graph));
+  *executor = impl.release();
+  return absl::OkStatus();
+}
+
 Status CreateNonCachedKernel(Device* device, FunctionLibraryRuntime* flib,
                              const std::shared_ptr<const NodeProperties>& props,
                              int graph_def_version, OpKernel** kernel) {
@@ -1574,6 +1850,44 @@ class DefaultExecutorRegistrar {
 };
 static DefaultExecutorRegistrar registrar;
 
+class WorkStealingExecutorRegistrar {
+ public:
+  WorkStealingExecutorRegistrar() {
+    ExecutorFactory::Register("WORK_STEALING_EXECUTOR", new Factory);
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      Executor* ret = nullptr;
+      TF_RETURN_IF_ERROR(NewWorkStealingLocalExecutor(params, graph, &ret));
+      out_executor->reset(ret);
+      return absl::OkStatus();
+    }
+  };
+};
+static WorkStealingExecutorRegistrar work_stealing_registrar;
+
+class CostLearningExecutorRegistrar {
+ public:
+  CostLearningExecutorRegistrar() {
+    ExecutorFactory::Register("COST_LEARNING_EXECUTOR", new Factory);
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      Executor* ret = nullptr;
+      TF_RETURN_IF_ERROR(NewCostLearningLocalExecutor(params, graph, &ret));
+      out_executor->reset(ret);
+      return absl::OkStatus();
+    }
+  };
+};
+static CostLearningExecutorRegistrar cost_learning_registrar;
+
 }  // namespace
 
 }  // namespace tensorflow
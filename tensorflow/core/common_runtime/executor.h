@@ -109,6 +109,13 @@ class Executor {
     ScopedStepContainer* step_container = nullptr;
     CollectiveExecutor* collective_executor = nullptr;
     thread::ThreadPoolInterface* user_intra_op_threadpool = nullptr;
+    // If not null, serves the allocations that kernels make with default
+    // `AllocatorAttributes`. See `OpKernelContext::Params::step_allocator`.
+    Allocator* step_allocator = nullptr;
+    // If set, returns the allocator that serves the default-attribute
+    // allocations of the node with the given id in place of `step_allocator`,
+    // or nullptr to use `step_allocator`.
+    std::function<Allocator*(int)> node_step_allocator;
     tsl::CoordinationServiceAgent* coordination_service_agent = nullptr;
     int64_t start_time_usecs = 0;
     // The deadline for the kernel to complete by. Empty if unspecified.
@@ -161,6 +168,27 @@ class Executor {
 ::tensorflow::Status NewLocalExecutor(const LocalExecutorParams& params,
                                       const Graph& graph, Executor** executor);
 
+// Like `NewLocalExecutor()`, but the returned executor dispatches expensive
+// nodes through per-worker ready queues with LIFO local pops and FIFO steals
+// that prefer workers on the same NUMA node, instead of handing each node
+// directly to `Args::runner`. This executor is registered with
+// `ExecutorFactory` as "WORK_STEALING_EXECUTOR", and can be selected with
+// `ConfigProto.experimental.executor_type`.
+::tensorflow::Status NewWorkStealingLocalExecutor(
+    const LocalExecutorParams& params, const Graph& graph,
+    Executor** executor);
+
+// Like `NewLocalExecutor()`, but the returned executor measures the cost of
+// every kernel (rather than only of those whose `OpKernel::IsExpensive()` is
+// true) to decide which nodes to run inline. The estimates are shared by all
+// the executors of the same graph on the same device, e.g. those created for
+// each instantiation of a function, and the inexpensive nodes that become
+// ready together are run from a single closure. This executor is registered
+// with `ExecutorFactory` as "COST_LEARNING_EXECUTOR".
+::tensorflow::Status NewCostLearningLocalExecutor(
+    const LocalExecutorParams& params, const Graph& graph,
+    Executor** executor);
+
 // A class to help run multiple executors in parallel and wait until
 // all of them are complete.
 //
@@ -325,6 +325,34 @@ TEST_P(GPUBFCAllocatorTest, AllocationsAndDeallocationsWithGrowth) {
   }
 }
 
+TEST_P(GPUBFCAllocatorTest, ReleaseFreeMemory) {
+  GPUBFCAllocator a(GetParam()(1ull << 32), 1LL << 31, "GPU_0_bfc", {});
+  // Released through the base class, as the eager context does.
+  Allocator* allocator = &a;
+
+  void* small = a.AllocateRaw(1, 1 << 20);
+  void* large = a.AllocateRaw(1, 1 << 30);
+  a.DeallocateRaw(large);
+  std::optional<AllocatorStats> stats = a.GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_GE(stats->largest_free_block_bytes, 1 << 30);
+  const int64_t pool_bytes = *stats->pool_bytes;
+
+  // Regions holding the remaining allocation are kept.
+  const size_t released = allocator->ReleaseFreeMemory();
+  stats = a.GetStats();
+  EXPECT_EQ(*stats->pool_bytes, pool_bytes - released);
+  EXPECT_GT(*stats->pool_bytes, 0);
+  EXPECT_EQ(a.RequestedSize(small), 1 << 20);
+
+  a.DeallocateRaw(small);
+  EXPECT_GT(allocator->ReleaseFreeMemory(), 0);
+  stats = a.GetStats();
+  EXPECT_EQ(*stats->pool_bytes, 0);
+  EXPECT_EQ(stats->largest_free_block_bytes, 0);
+  EXPECT_EQ(allocator->ReleaseFreeMemory(), 0);
+}
+
 TEST_P(GPUBFCAllocatorTest, DISABLED_AllocatorReceivesZeroMemory) {
   GPUBFCAllocator a(GetParam()(1ul << 62), 1UL << 60, "GPU_0_bfc", {});
   GPUBFCAllocator b(GetParam()(1ul << 62), 1UL << 60, "GPU_0_bfc", {});
@@ -698,7 +698,8 @@ const absl::flat_hash_set<std::string>* GetOpsToLogFromEnv() {
 bool ShouldLogInputsAndOutputs(OpKernel* op_kernel) {
   static const absl::flat_hash_set<std::string>& ops_to_log =
       *GetOpsToLogFromEnv();
-  return ops_to_log.count(op_kernel->type_string());
+  // Skip hashing the op type on every launch unless logging is requested.
+  return !ops_to_log.empty() && ops_to_log.contains(op_kernel->type_string());
 }
 }  // namespace
 
@@ -1329,6 +1330,7 @@ Allocator* BaseGPUDevice::GetScopedAllocator(AllocatorAttributes attr,
 
 const int BaseGPUDeviceFactory::InterconnectMap::kSameDeviceStrength = 1000;
 const int BaseGPUDeviceFactory::InterconnectMap::kStreamExecutorStrength = 1;
+const int BaseGPUDeviceFactory::InterconnectMap::kNvLinkStrength = 2;
 
 Status BaseGPUDeviceFactory::CacheDeviceIds() {
   if (!cached_device_ids_.empty()) {
@@ -1989,6 +1991,31 @@ Status BaseGPUDeviceFactory::GetInterconnectMaps(
       }
     }
   }
+#if GOOGLE_CUDA
+  // Peer-to-peer native atomics are only supported over NVLink, so use them
+  // to tell NVLink from PCIe peers. This makes e.g. the collective ring order
+  // prefer NVLink neighbors.
+  InterconnectMap nvlink_map;
+  nvlink_map.name = "NVLink";
+  nvlink_map.strength = InterconnectMap::kNvLinkStrength;
+  for (const auto& [gpu_id_i, gpu_id_j] : imap.directed_links) {
+    int native_atomics = 0;
+    cudaError_t err = cudaDeviceGetP2PAttribute(
+        &native_atomics, cudaDevP2PAttrNativeAtomicSupported, gpu_id_i.value(),
+        gpu_id_j.value());
+    if (err != cudaSuccess) {
+      VLOG(1) << "cudaDeviceGetP2PAttribute() failed: "
+              << cudaGetErrorString(err);
+      continue;
+    }
+    if (native_atomics) {
+      nvlink_map.directed_links.insert({gpu_id_i, gpu_id_j});
+    }
+  }
+  if (!nvlink_map.directed_links.empty()) {
+    maps->push_back(std::move(nvlink_map));
+  }
+#endif  // GOOGLE_CUDA
   return OkStatus();
 }
 
@@ -98,6 +98,11 @@ class BaseGPUDevice : public LocalDevice {
 
   ~BaseGPUDevice() override;
 
+  // The streams of one TF GPU device. All kernels of a device run in order on
+  // its single compute stream. Every virtual device (see
+  // GPUOptions.Experimental.virtual_devices) has a stream group of its own, so
+  // independent branches placed on different virtual devices of one physical
+  // GPU run concurrently.
   struct StreamGroup {
     se::Stream* compute = nullptr;
 #if TENSORFLOW_USE_ROCM
@@ -380,6 +385,7 @@ class BaseGPUDeviceFactory : public DeviceFactory {
     int32 strength;
     static const int kSameDeviceStrength;
     static const int kStreamExecutorStrength;
+    static const int kNvLinkStrength;
     std::set<std::pair<tsl::PlatformDeviceId, tsl::PlatformDeviceId>>
         directed_links;
   };
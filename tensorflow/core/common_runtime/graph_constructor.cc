@@ -50,9 +50,12 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/public/version.h"
 
 namespace tensorflow {
@@ -63,6 +66,10 @@ namespace {
 // can skip expensive duplicates check in 'AddControlEdge'.
 static constexpr const bool kDoNotCheckDuplicates = true;
 
+// Graphs with at least this many nodes have their NodeDefs checked against
+// their OpDefs in parallel before they are converted.
+static constexpr const int kMinNodesForParallelNodeDefPreparation = 4096;
+
 inline bool IsMerge(const NodeDef& node_def) {
   return node_def.op() == "Merge" || node_def.op() == "RefMerge" ||
          node_def.op() == "_XlaMerge";
@@ -244,6 +251,10 @@ class GraphConstructor {
   Status IsNodeFullyMapped(const NodeDef& node_def, bool* is_node_mapped);
   Status ValidateColocationConstraints(const NodeDef& node_def);
   Status MakeNode(NodeDef&& node_def, Node** node);
+  // Looks up the OpDefs of all NodeDefs, adds their default attributes and
+  // validates them on a thread pool, if the NodeDefs are mutable and would
+  // otherwise get the same treatment one at a time in Convert().
+  Status PrepareNodeDefsInParallel();
   Status MakeEdge(Node* src, int output_index, Node* dst, int input_index);
   Status ValidateShape(Node* node);
   Status ModifyNodeDefForImport(NodeDef* node_def);
@@ -300,6 +311,9 @@ class GraphConstructor {
   // possible. After calling this method, the result of get_node_def(i) is
   // undefined.
   virtual NodeDef consume_node_def(int i) = 0;
+  // Returns the i^th node in the graph for modification, or nullptr if the
+  // nodes are not owned. Must not be called after consume_node_def(i).
+  virtual NodeDef* mutable_node_def(int i) { return nullptr; }
   // Returns the version information for the graph, or nullptr if none is
   // available.
   virtual const VersionDef* versions() const = 0;
@@ -334,6 +348,10 @@ class GraphConstructor {
   // `missing_unused_input_map_keys_`.
   std::set<TensorId> used_input_map_keys_;
 
+  // Whether PrepareNodeDefsInParallel() has already looked up, completed and
+  // validated all NodeDefs.
+  bool node_defs_prepared_ = false;
+
   // Intermediate datastructure used to track the destinations of back edges.
   absl::flat_hash_set<int> merge_node_indices_;
 
@@ -472,6 +490,11 @@ class NodeDefMovingGraphConstructor : public GraphConstructor {
         << "NodeDef " << i << " accessed after it was consumed.";
     return graph_def_.node(i);
   }
+  NodeDef* mutable_node_def(int i) override {
+    CHECK(!is_consumed_[i])
+        << "NodeDef " << i << " accessed after it was consumed.";
+    return graph_def_.mutable_node(i);
+  }
   NodeDef consume_node_def(int i) override {
     CHECK(!is_consumed_[i]) << "NodeDef " << i << " consumed twice.";
     is_consumed_[i] = true;
@@ -1161,6 +1184,41 @@ GraphConstructor::CreateStackTracesForFunctionDefLibrary(
   }
 }
 
+Status GraphConstructor::PrepareNodeDefsInParallel() {
+  const int num_nodes = node_def_count();
+  if (opts_.importing || num_nodes < kMinNodesForParallelNodeDefPreparation ||
+      mutable_node_def(0) == nullptr) {
+    return absl::OkStatus();
+  }
+  std::vector<Status> statuses(num_nodes);
+  {
+    thread::ThreadPool pool(Env::Default(), "prepare_node_defs",
+                            port::MaxParallelism());
+    pool.ParallelFor(
+        num_nodes, /*cost_per_unit=*/10000,
+        [this, &statuses](int64_t start, int64_t end) {
+          for (int64_t i = start; i < end; ++i) {
+            NodeDef* node_def = mutable_node_def(i);
+            const OpDef* op_def;
+            statuses[i] =
+                g_->op_registry()->LookUpOpDef(node_def->op(), &op_def);
+            if (!statuses[i].ok()) continue;
+            if (opts_.add_default_attributes) {
+              AddDefaultsToNodeDef(*op_def, node_def);
+            }
+            if (opts_.validate_nodes) {
+              statuses[i] = ValidateNodeDef(*node_def, *op_def);
+            }
+          }
+        });
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  node_defs_prepared_ = true;
+  return absl::OkStatus();
+}
+
 Status GraphConstructor::Convert() {
   if (debug_info() != nullptr) {
     traces_ = LoadTracesFromDebugInfo(*debug_info());
@@ -1185,6 +1243,9 @@ Status GraphConstructor::Convert() {
         g_->AddFunctionLibrary(*std::move(library), library_traces));
   }
 
+  // Done after importing functions, since nodes may call them.
+  TF_RETURN_IF_ERROR(PrepareNodeDefsInParallel());
+
   std::vector<InputInfo> inputs;
   int processed = 0;
 
@@ -1297,7 +1358,7 @@ Status GraphConstructor::Convert() {
 
     if (opts_.importing) {
       TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&node_def));
-    } else {
+    } else if (!node_defs_prepared_) {
       const OpDef* op_def;
       TF_RETURN_IF_ERROR(
           g_->op_registry()->LookUpOpDef(node_def.op(), &op_def));
@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/graph.h"
@@ -1035,6 +1036,58 @@ TEST_F(GraphConstructorTest, ImportGraphDef_DefaultAttrs) {
   EXPECT_EQ(31415, value);
 }
 
+TEST_F(GraphConstructorTest, ConvertLargeGraphDef_DefaultAttrs) {
+  // Large enough for the NodeDefs to be prepared in parallel.
+  constexpr int kNumNodes = 5000;
+  GraphDef def;
+  for (int i = 0; i < kNumNodes; ++i) {
+    NodeDef* node = def.add_node();
+    node->set_name(absl::StrCat("A", i));
+    node->set_op("TestDefaultAttr");
+  }
+  TF_ASSERT_OK(ConvertGraphDefToGraph(GraphConstructorOptions(),
+                                      std::move(def), &graph_));
+  // The source and sink nodes are also in the graph.
+  EXPECT_EQ(graph_.num_nodes(), kNumNodes + 2);
+  Node* a = FindNode(absl::StrCat("A", kNumNodes - 1));
+  ASSERT_TRUE(a != nullptr);
+  int value = 0;
+  TF_ASSERT_OK(GetNodeAttr(a->attrs(), "default_int", &value));
+  EXPECT_EQ(31415, value);
+}
+
+TEST_F(GraphConstructorTest, ConvertLargeGraphDef_InvalidNode) {
+  constexpr int kNumNodes = 5000;
+  GraphDef def;
+  for (int i = 0; i < kNumNodes; ++i) {
+    NodeDef* node = def.add_node();
+    node->set_name(absl::StrCat("A", i));
+    node->set_op("TestDefaultAttr");
+  }
+  // Two nodes with a wrongly typed attr; the lowest-index one is reported.
+  AddNodeAttr("default_int", "not an int", def.mutable_node(kNumNodes / 2));
+  AddNodeAttr("default_int", "not an int", def.mutable_node(kNumNodes - 1));
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+
+  // The same invalid node converted on its own takes the serial path.
+  GraphDef serial_def;
+  *serial_def.add_node() = def.node(kNumNodes / 2);
+  Graph serial_graph(OpRegistry::Global());
+  Status serial_status =
+      ConvertGraphDefToGraph(opts, std::move(serial_def), &serial_graph);
+  ASSERT_TRUE(errors::IsInvalidArgument(serial_status)) << serial_status;
+
+  const string original_graph_description = GraphDebugString();
+  Status s = ConvertGraphDefToGraph(opts, std::move(def), &graph_);
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), "default_int")) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), absl::StrCat("A", kNumNodes / 2)))
+      << s;
+  EXPECT_EQ(serial_status.message(), s.message());
+  EXPECT_EQ(original_graph_description, GraphDebugString());
+}
+
 TEST_F(GraphConstructorTest, ImportGraphDef_Versioning) {
   GraphDef def;
   const ImportGraphDefOptions opts;
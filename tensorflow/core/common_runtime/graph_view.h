@@ -85,6 +85,7 @@ struct NodeItem {
                                     // node's input types.
   bool is_distributed_communication : 1;  // True iff the op is registered to
                                           // use distributed communication.
+  bool is_stateful : 1;                   // True iff the op is stateful.
 
   // The kernel for this node.
   OpKernel* kernel = nullptr;
@@ -111,6 +112,11 @@ struct NodeItem {
   // is true if and only if the ith output is consumed by another node.
   std::unique_ptr<bool[]> outputs_required;
 
+  // If non-null, contains an array of num_outputs ints, where the ith int is
+  // the index of the first `_Retval` node that consumes the ith output, or -1
+  // if no `_Retval` node consumes it. Only set for nodes on CPU devices.
+  std::unique_ptr<int[]> output_retval_index;
+
   gtl::MutableArraySlice<EdgeInfo> mutable_output_edges() {
     return gtl::MutableArraySlice<EdgeInfo>(output_edge_base(),
                                             num_output_edges);
@@ -0,0 +1,406 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_ring_reducer.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/collective_rma_local.h"
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/device_base.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+
+namespace {
+// Key to be used for BufRendezvous by HierarchicalRingReducer.
+string ReduceBufKey(const string& exec_key, int subdiv, const string& tag,
+                    int src_rank, int dst_rank) {
+  return strings::StrCat(exec_key, ":", subdiv, ":", tag, ":", src_rank, ":",
+                         dst_rank);
+}
+
+// Tracks a set of asynchronous transfers and accumulates their status.
+class PendingOps {
+ public:
+  // Returns the callback for one more pending transfer.
+  StatusCallback Add() {
+    mutex_lock l(mu_);
+    ++pending_;
+    return [this](const Status& s) {
+      mutex_lock l(mu_);
+      status_.Update(s);
+      if (--pending_ == 0) all_done_.notify_all();
+    };
+  }
+
+  // Blocks until all transfers have completed.
+  Status Wait() {
+    mutex_lock l(mu_);
+    while (pending_ > 0) all_done_.wait(l);
+    return status_;
+  }
+
+ private:
+  mutex mu_;
+  condition_variable all_done_;
+  int pending_ TF_GUARDED_BY(mu_) = 0;
+  Status status_ TF_GUARDED_BY(mu_);
+};
+}  // namespace
+
+HierarchicalRingReducer::HierarchicalRingReducer()
+    : col_ctx_(nullptr), col_params_(nullptr) {}
+
+Status HierarchicalRingReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  CHECK_EQ(col_params->instance.type, REDUCTION_COLLECTIVE);
+  CHECK_EQ(col_params->instance.impl_details.collective_name,
+           "HierarchicalRingReduce");
+  const string& device_name =
+      col_params->group.members[col_params->default_rank].device.name();
+  // Count the devices in each task.
+  // Precondition: devices must be sorted so that all devices in the same task
+  // are adjacent.
+  std::vector<int> dev_per_task;
+  const string* prior_task_name = &col_params->group.members[0].task;
+  int dev_count = 1;
+  for (int di = 1; di < col_params->group.group_size; ++di) {
+    if (col_params->group.members[di].task != *prior_task_name) {
+      dev_per_task.push_back(dev_count);
+      dev_count = 1;
+      prior_task_name = &col_params->group.members[di].task;
+    } else {
+      ++dev_count;
+    }
+  }
+  dev_per_task.push_back(dev_count);
+  if (col_params->group.num_tasks != dev_per_task.size()) {
+    return errors::Internal(
+        "HierarchicalRingReduce requires the devices of each task to be "
+        "adjacent in the group, found ",
+        dev_per_task.size(), " runs of devices for ",
+        col_params->group.num_tasks, " tasks");
+  }
+
+  const int num_tasks = col_params->group.num_tasks;
+  const int num_subdivs = num_tasks + (num_tasks > 1 ? 1 : 0);
+  col_params->instance.impl_details.subdiv_permutations.clear();
+  col_params->instance.impl_details.subdiv_permutations.resize(num_subdivs);
+  col_params->subdiv_rank.clear();
+  col_params->subdiv_rank.reserve(num_subdivs);
+
+  // Inter-task subdiv: the ring of task leaders, i.e. the first device of
+  // each task.
+  if (num_tasks > 1) {
+    std::vector<int>& perm =
+        col_params->instance.impl_details.subdiv_permutations[0];
+    int rank = -1;
+    int device_count = 0;
+    for (int ti = 0; ti < num_tasks; ++ti) {
+      perm.push_back(device_count);
+      if (col_params->group.members[device_count].device.name() ==
+          device_name) {
+        rank = ti;
+      }
+      device_count += dev_per_task[ti];
+    }
+    col_params->subdiv_rank.push_back(rank);
+  }
+
+  // Intra-task subdivs: all devices of task ti, in group order.
+  int abs_di = 0;
+  for (int ti = 0; ti < num_tasks; ++ti) {
+    const int sdi = ti + (num_tasks > 1 ? 1 : 0);
+    std::vector<int>& perm =
+        col_params->instance.impl_details.subdiv_permutations[sdi];
+    int rank = -1;
+    for (int di = 0; di < dev_per_task[ti]; ++di) {
+      perm.push_back(abs_di);
+      if (col_params->group.members[abs_di].device.name() == device_name) {
+        rank = di;
+      }
+      ++abs_di;
+    }
+    col_params->subdiv_rank.push_back(rank);
+  }
+
+  VLOG(2) << collective_util::SubdivPermDebugString(*col_params);
+  return absl::OkStatus();
+}
+
+Status HierarchicalRingReducer::InitializeCollectiveContext(
+    std::shared_ptr<CollectiveContext> col_ctx) {
+  CHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = col_ctx->col_params.get();
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void HierarchicalRingReducer::Run(StatusCallback done) {
+  CHECK(col_ctx_);
+  CHECK(col_params_);
+  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+  Status s = RunReduction();
+  // Unless the op was cancelled, abort the transfers of the other devices,
+  // which may be waiting on this one.
+  CancellationManager* cancel_mgr = col_ctx_->op_ctx->cancellation_manager();
+  if (!s.ok() && (cancel_mgr == nullptr || (!cancel_mgr->IsCancelled() &&
+                                            !cancel_mgr->IsCancelling()))) {
+    col_ctx_->col_exec->StartAbort(s);
+  }
+  VLOG(2) << "device=" << col_ctx_->device_name << " return status " << s;
+  done(s);
+}
+
+Status HierarchicalRingReducer::RunReduction() {
+  TF_RETURN_IF_ERROR(CopyInputToOutput());
+  const int num_tasks = col_params_->group.num_tasks;
+  const int num_subdivs =
+      col_params_->instance.impl_details.subdiv_permutations.size();
+  int local_subdiv = -1;
+  for (int sdi = (num_tasks > 1 ? 1 : 0); sdi < num_subdivs; ++sdi) {
+    if (col_params_->subdiv_rank[sdi] >= 0) {
+      local_subdiv = sdi;
+      break;
+    }
+  }
+  if (local_subdiv < 0) {
+    return errors::Internal("Device ", col_ctx_->device_name,
+                            " is not in any task of the collective group");
+  }
+
+  TF_RETURN_IF_ERROR(ReduceToLeader(local_subdiv));
+  if (col_params_->subdiv_rank[local_subdiv] == 0) {
+    TF_RETURN_IF_ERROR(AllReduceAmongLeaders());
+  }
+  return BroadcastFromLeader(local_subdiv);
+}
+
+Status HierarchicalRingReducer::CopyInputToOutput() {
+  if ((col_ctx_->input == col_ctx_->output) ||
+      (DMAHelper::base(col_ctx_->input) == DMAHelper::base(col_ctx_->output))) {
+    return absl::OkStatus();
+  }
+  Notification note;
+  Status status;
+  profiler::TraceMe activity("MemCpyAsync", profiler::TraceMeLevel::kInfo);
+  CollectiveRemoteAccessLocal::MemCpyAsync(
+      col_ctx_->op_ctx->op_device_context(),
+      col_ctx_->op_ctx->op_device_context(), col_ctx_->device,
+      col_ctx_->device, col_ctx_->op_ctx->input_alloc_attr(0),
+      col_ctx_->op_ctx->output_alloc_attr(0), col_ctx_->input,
+      col_ctx_->output, 0 /*dev_to_dev_stream_index*/,
+      [&note, &status](const Status& s) {
+        status.Update(s);
+        note.Notify();
+      });
+  note.WaitForNotification();
+  return status;
+}
+
+Status HierarchicalRingReducer::ReduceToLeader(int subdiv) {
+  const int num_devices =
+      col_params_->instance.impl_details.subdiv_permutations[subdiv].size();
+  if (num_devices == 1) return absl::OkStatus();
+  profiler::TraceMe activity("ReduceToLeader", profiler::TraceMeLevel::kInfo);
+  PendingOps ops;
+  if (col_params_->subdiv_rank[subdiv] != 0) {
+    DispatchSend(subdiv, /*dst_rank=*/0, "reduce", col_ctx_->output,
+                 ops.Add());
+    return ops.Wait();
+  }
+  Allocator* allocator = col_ctx_->device->GetAllocator(
+      col_ctx_->op_ctx->output_alloc_attr(0));
+  std::vector<Tensor> received;
+  received.reserve(num_devices - 1);
+  for (int rank = 1; rank < num_devices; ++rank) {
+    received.emplace_back(allocator, col_ctx_->output->dtype(),
+                          col_ctx_->output->shape());
+    DispatchRecv(subdiv, rank, "reduce", &received.back(), ops.Add());
+  }
+  TF_RETURN_IF_ERROR(ops.Wait());
+  for (Tensor& t : received) {
+    TF_RETURN_IF_ERROR(collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->merge_op, col_ctx_->output, &t));
+  }
+  return absl::OkStatus();
+}
+
+Status HierarchicalRingReducer::AllReduceAmongLeaders() {
+  const int num_tasks = col_params_->group.num_tasks;
+  AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+  std::unique_ptr<CollectiveAdapter> ca(
+      MakeCollectiveAdapter(col_ctx_->output, num_tasks,
+                            col_ctx_->device->GetAllocator(attr)));
+  Status s;
+  if (num_tasks > 1) s = RunRing(ca.get());
+  if (s.ok() && col_params_->final_op) s = RunFinalOp(ca.get());
+  ca->ConsumeFinalValue(col_ctx_->output);
+  return s;
+}
+
+Status HierarchicalRingReducer::RunRing(CollectiveAdapter* ca) {
+  profiler::TraceMe activity("RingAmongLeaders",
+                             profiler::TraceMeLevel::kInfo);
+  const int num_leaders =
+      col_params_->instance.impl_details.subdiv_permutations[0].size();
+  const int rank = col_params_->subdiv_rank[0];
+  const int next = (rank + 1) % num_leaders;
+  const int prev = (rank + num_leaders - 1) % num_leaders;
+
+  // Reduce-scatter: after step k, this leader has reduced k+2 contributions
+  // into chunk (rank - k - 1), and at the end chunk (rank + 1) is complete.
+  for (int step = 0; step < num_leaders - 1; ++step) {
+    const int send_chunk = (rank - step + num_leaders) % num_leaders;
+    const int recv_chunk = (rank - step - 1 + 2 * num_leaders) % num_leaders;
+    const string tag = strings::StrCat("scatter", step);
+    Tensor send_alias = ca->ChunkAlias(send_chunk);
+    Tensor recv_alias = ca->ChunkAlias(recv_chunk);
+    Tensor tmp_chunk = ca->TempChunk(recv_chunk);
+    PendingOps ops;
+    DispatchSend(0, next, tag, &send_alias, ops.Add());
+    DispatchRecv(0, prev, tag, &tmp_chunk, ops.Add());
+    TF_RETURN_IF_ERROR(ops.Wait());
+    TF_RETURN_IF_ERROR(collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->merge_op, &recv_alias, &tmp_chunk));
+  }
+
+  // All-gather: forward the complete chunks around the ring.
+  for (int step = 0; step < num_leaders - 1; ++step) {
+    const int send_chunk = (rank + 1 - step + num_leaders) % num_leaders;
+    const int recv_chunk = (rank - step + num_leaders) % num_leaders;
+    const string tag = strings::StrCat("gather", step);
+    Tensor send_alias = ca->ChunkAlias(send_chunk);
+    Tensor recv_alias = ca->ChunkAlias(recv_chunk);
+    PendingOps ops;
+    DispatchSend(0, next, tag, &send_alias, ops.Add());
+    DispatchRecv(0, prev, tag, &recv_alias, ops.Add());
+    TF_RETURN_IF_ERROR(ops.Wait());
+  }
+  return absl::OkStatus();
+}
+
+Status HierarchicalRingReducer::RunFinalOp(CollectiveAdapter* ca) {
+  Tensor group_size_val = ca->Scalar(col_params_->group.group_size);
+  Tensor group_size_tensor = group_size_val;
+  if (col_params_->group.device_type != "CPU") {
+    group_size_tensor = ca->Scalar(
+        col_ctx_->device->GetAllocator(col_ctx_->op_ctx->input_alloc_attr(0)),
+        AllocationAttributes());
+    Notification note;
+    Status status;
+    col_ctx_->op_ctx->op_device_context()->CopyCPUTensorToDevice(
+        &group_size_val, col_ctx_->device, &group_size_tensor,
+        [&note, &status](const Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+    TF_RETURN_IF_ERROR(status);
+  }
+  for (int i = 0; i < col_params_->group.num_tasks; ++i) {
+    Tensor chunk = ca->ChunkAlias(i);
+    TF_RETURN_IF_ERROR(collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->final_op, &chunk, &group_size_tensor));
+  }
+  return absl::OkStatus();
+}
+
+Status HierarchicalRingReducer::BroadcastFromLeader(int subdiv) {
+  const int num_devices =
+      col_params_->instance.impl_details.subdiv_permutations[subdiv].size();
+  if (num_devices == 1) return absl::OkStatus();
+  profiler::TraceMe activity("BroadcastFromLeader",
+                             profiler::TraceMeLevel::kInfo);
+  PendingOps ops;
+  if (col_params_->subdiv_rank[subdiv] == 0) {
+    for (int rank = 1; rank < num_devices; ++rank) {
+      DispatchSend(subdiv, rank, "broadcast", col_ctx_->output, ops.Add());
+    }
+  } else {
+    DispatchRecv(subdiv, /*src_rank=*/0, "broadcast", col_ctx_->output,
+                 ops.Add());
+  }
+  return ops.Wait();
+}
+
+void HierarchicalRingReducer::DispatchSend(int subdiv, int dst_rank,
+                                           const string& tag,
+                                           const Tensor* src_tensor,
+                                           const StatusCallback& done) {
+  const int src_rank = col_params_->subdiv_rank[subdiv];
+  string send_buf_key =
+      ReduceBufKey(col_ctx_->exec_key, subdiv, tag, src_rank, dst_rank);
+  int dst_idx =
+      col_params_->instance.impl_details.subdiv_permutations[subdiv][dst_rank];
+  VLOG(3) << "DispatchSend " << send_buf_key << " from_device "
+          << col_ctx_->device_name << " to_device "
+          << col_params_->group.members[dst_idx].device.name();
+  col_ctx_->col_exec->remote_access()->PostToPeer(
+      col_params_->group.members[dst_idx].device.name(),
+      col_params_->group.members[dst_idx].task, send_buf_key, col_ctx_->device,
+      col_ctx_->op_ctx->op_device_context(),
+      col_ctx_->op_ctx->output_alloc_attr(0), src_tensor,
+      col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
+      done);
+}
+
+void HierarchicalRingReducer::DispatchRecv(int subdiv, int src_rank,
+                                           const string& tag,
+                                           Tensor* dst_tensor,
+                                           const StatusCallback& done) {
+  const int dst_rank = col_params_->subdiv_rank[subdiv];
+  string recv_buf_key =
+      ReduceBufKey(col_ctx_->exec_key, subdiv, tag, src_rank, dst_rank);
+  int src_idx =
+      col_params_->instance.impl_details.subdiv_permutations[subdiv][src_rank];
+  VLOG(3) << "DispatchRecv " << recv_buf_key << " from_device "
+          << col_params_->group.members[src_idx].device.name() << " to_device "
+          << col_ctx_->device_name;
+  col_ctx_->col_exec->remote_access()->RecvFromPeer(
+      col_params_->group.members[src_idx].device.name(),
+      col_params_->group.members[src_idx].task,
+      col_params_->group.members[src_idx].is_local, recv_buf_key,
+      col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
+      col_ctx_->op_ctx->output_alloc_attr(0), dst_tensor,
+      col_ctx_->device_locality, 0 /*stream_index*/,
+      col_ctx_->op_ctx->cancellation_manager(), done);
+}
+
+namespace {
+REGISTER_COLLECTIVE(HierarchicalRingReduce, HierarchicalRingReducer);
+}  // namespace
+
+}  // namespace tensorflow
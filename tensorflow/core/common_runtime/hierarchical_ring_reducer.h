@@ -0,0 +1,96 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
+
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/framework/collective.h"
+
+namespace tensorflow {
+
+// Topology-aware implementation of collective all-reduce, selected with
+// communication_hint "hierarchical".
+//
+// The devices of each task first reduce into the first device of the task,
+// the task leader.  The leaders then all-reduce among themselves with a
+// ring, so that each tensor byte crosses the network 2*(n-1)/n times for n
+// tasks regardless of the number of devices per task.  Finally each leader
+// broadcasts the result to the other devices of its task.
+class HierarchicalRingReducer : public CollectiveImplementationInterface {
+ public:
+  HierarchicalRingReducer();
+  ~HierarchicalRingReducer() override = default;
+
+  // Establishes the subdivs of the hierarchical all-reduce.  If all devices
+  // are on one task, establishes a single subdiv comprising all devices.
+  // Otherwise establishes n+1 subdivs for n tasks: the first subdiv is the
+  // ring of task leaders, and subdiv i+1 comprises the devices of task i.
+  Status InitializeCollectiveParams(CollectiveParams* col_params) override;
+
+  // Initializes members of CollectiveContext not yet initialized, i.e. device
+  // and device_locality.  Also saves the CollectiveContext in this object.
+  Status InitializeCollectiveContext(
+      std::shared_ptr<CollectiveContext> col_ctx) override;
+
+  // Executes the hierarchical all-reduce.
+  // Must be called in a blockable thread.
+  void Run(StatusCallback done) override;
+
+ private:
+  // Executes the all-reduce, blocking until it completes.
+  Status RunReduction();
+
+  // Copies the input tensor to the output tensor, unless the reduction is
+  // in-place.
+  Status CopyInputToOutput();
+
+  // Reduces the output tensors of the devices in `subdiv` into the output of
+  // the device at rank 0.
+  Status ReduceToLeader(int subdiv);
+
+  // Runs the ring all-reduce among the task leaders, followed by the final
+  // op.  Called only on task leaders.
+  Status AllReduceAmongLeaders();
+  Status RunRing(CollectiveAdapter* ca);
+  Status RunFinalOp(CollectiveAdapter* ca);
+
+  // Broadcasts the output tensor of the device at rank 0 in `subdiv` to the
+  // other devices in `subdiv`.
+  Status BroadcastFromLeader(int subdiv);
+
+  // Sends `src_tensor` asynchronously from this device to the device at
+  // `dst_rank` in `subdiv`.  `tag` distinguishes the transfers of one
+  // collective between the same pair of devices.  Calls `done` upon
+  // completion.
+  void DispatchSend(int subdiv, int dst_rank, const std::string& tag,
+                    const Tensor* src_tensor, const StatusCallback& done);
+
+  // Receives a tensor into the memory buffer owned by `dst_tensor` at this
+  // device from the device at `src_rank` in `subdiv`.  Calls `done` upon
+  // completion.
+  void DispatchRecv(int subdiv, int src_rank, const std::string& tag,
+                    Tensor* dst_tensor, const StatusCallback& done);
+
+  std::shared_ptr<CollectiveContext> col_ctx_;
+  const CollectiveParams* col_params_;  // Not owned
+
+  friend class HierarchicalRingReducerTest;
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
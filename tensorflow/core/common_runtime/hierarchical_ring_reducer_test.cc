@@ -0,0 +1,240 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_ring_reducer.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/collective_test_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+std::unique_ptr<OpKernel> GetKernel(const string& op, DataType dtype,
+                                    const DeviceType& device_type,
+                                    DeviceBase* device) {
+  NodeDef node_def;
+  TF_CHECK_OK(NodeDefBuilder("op_node", op)
+                  .Attr("T", dtype)
+                  .Input(FakeInput(dtype))
+                  .Input(FakeInput(dtype))
+                  .Finalize(&node_def));
+  Status status;
+  std::unique_ptr<OpKernel> k = CreateOpKernel(
+      device_type, device, device->GetAllocator(AllocatorAttributes()),
+      node_def, TF_GRAPH_DEF_VERSION, &status);
+  TF_CHECK_OK(status);
+  return k;
+}
+
+}  // namespace
+
+class HierarchicalRingReducerTest : public ::testing::Test {
+ protected:
+  void Init(int num_workers, int num_devices, DataType dtype,
+            const TensorShape& shape, int fail_after) {
+    test_env_ = CreateCollectiveTestEnv(num_workers, num_devices, DEVICE_CPU);
+    test_env_->remote_access->set_fail_after(fail_after);
+    for (int wi = 0; wi < num_workers; ++wi) {
+      for (int di = 0; di < num_devices; ++di) {
+        int rank = wi * num_devices + di;
+        instances_.push_back(std::make_unique<DeviceInstance>(
+            rank, dtype, shape, test_env_.get()));
+      }
+    }
+  }
+
+  void Reduce() {
+    std::atomic<int> done(0);
+    for (auto& di : instances_) {
+      SchedClosure([&di, &done] {
+        di->DoReduce();
+        ++done;
+      });
+    }
+    while (done < static_cast<int>(instances_.size())) {
+      Env::Default()->SleepForMicroseconds(1000);
+    }
+  }
+
+  template <typename T>
+  void RunTest(DataType dtype, int num_workers, int num_devices,
+               int tensor_len, int fail_after) {
+    Init(num_workers, num_devices, dtype, TensorShape({tensor_len}),
+         fail_after);
+    std::vector<T> expected(tensor_len);
+    for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
+      instances_[di]->InitTensor([&expected, di](Tensor* t) {
+        for (size_t i = 0; i < t->NumElements(); ++i) {
+          // Small integral values, whose sums are exact in any order.
+          T value = static_cast<T>(di * 10 + i);
+          t->flat<T>()(i) = value;
+          expected[i] += value;
+        }
+      });
+    }
+    Reduce();
+    if (fail_after > 0) {
+      for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
+        EXPECT_NE(instances_[di]->status_.message().find("Deliberate failure"),
+                  string::npos);
+      }
+      return;
+    }
+    for (int i = 0; i < tensor_len; ++i) {
+      expected[i] /= static_cast<T>(num_workers * num_devices);
+    }
+    for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
+      TF_EXPECT_OK(instances_[di]->status_);
+      test::ExpectTensorEqual<T>(test::AsTensor<T>(expected),
+                                 instances_[di]->tensor_);
+    }
+  }
+
+  static void InitParams(CollectiveParams* cp) {
+    core::RefCountPtr<HierarchicalRingReducer> reducer(
+        new HierarchicalRingReducer());
+    TF_CHECK_OK(reducer->InitializeCollectiveParams(cp));
+  }
+
+  class DeviceInstance {
+   public:
+    DeviceInstance(int rank, DataType dtype, const TensorShape& shape,
+                   CollectiveTestEnv* test_env)
+        : test_env_(test_env), tensor_(dtype, shape) {
+      col_params_ =
+          CreateCollectiveParams(*test_env_, rank, "HierarchicalRingReduce",
+                                 REDUCTION_COLLECTIVE, dtype, shape);
+      string dev_name = col_params_->group.members[rank].device.name();
+      TF_CHECK_OK(test_env_->device_mgr->LookupDevice(dev_name, &device_))
+          << "Couldn't find device " << dev_name
+          << " existing devices: " << test_env_->device_mgr->DebugString();
+      merge_op_ = GetKernel("Add", dtype, test_env_->device_type, device_);
+      final_op_ = GetKernel("Div", dtype, test_env_->device_type, device_);
+      col_params_->merge_op = merge_op_.get();
+      col_params_->final_op = final_op_.get();
+    }
+
+    void InitTensor(const std::function<void(Tensor*)>& init_f) {
+      init_f(&tensor_);
+    }
+
+    void DoReduce() {
+      status_ = RunCollective(test_env_, col_params_.get(), device_, &tensor_,
+                              &tensor_);
+    }
+
+    CollectiveTestEnv* test_env_;
+    Tensor tensor_;
+    Device* device_;
+    core::RefCountPtr<CollectiveParams> col_params_;
+    std::unique_ptr<OpKernel> merge_op_;
+    std::unique_ptr<OpKernel> final_op_;
+    Status status_;
+  };
+
+  std::unique_ptr<CollectiveTestEnv> test_env_;
+  std::vector<std::unique_ptr<DeviceInstance>> instances_;
+};
+
+TEST_F(HierarchicalRingReducerTest, InitializeParams) {
+  auto test_env = CreateCollectiveTestEnv(/*num_workers=*/3,
+                                          /*num_devices_per_worker=*/2,
+                                          DEVICE_CPU);
+  auto cp = CreateCollectiveParams(*test_env, /*rank=*/3,
+                                   "HierarchicalRingReduce",
+                                   REDUCTION_COLLECTIVE, DT_FLOAT,
+                                   TensorShape({8}));
+  InitParams(cp.get());
+  std::vector<std::vector<int>> expected_perms = {
+      {0, 2, 4}, {0, 1}, {2, 3}, {4, 5}};
+  EXPECT_EQ(cp->instance.impl_details.subdiv_permutations, expected_perms);
+  EXPECT_EQ(cp->subdiv_rank, std::vector<int>({-1, -1, 1, -1}));
+
+  cp->default_rank = 4;
+  InitParams(cp.get());
+  EXPECT_EQ(cp->instance.impl_details.subdiv_permutations, expected_perms);
+  EXPECT_EQ(cp->subdiv_rank, std::vector<int>({2, -1, -1, 0}));
+}
+
+TEST_F(HierarchicalRingReducerTest, InitializeParamsSingleTask) {
+  auto test_env = CreateCollectiveTestEnv(/*num_workers=*/1,
+                                          /*num_devices_per_worker=*/4,
+                                          DEVICE_CPU);
+  auto cp = CreateCollectiveParams(*test_env, /*rank=*/2,
+                                   "HierarchicalRingReduce",
+                                   REDUCTION_COLLECTIVE, DT_FLOAT,
+                                   TensorShape({8}));
+  InitParams(cp.get());
+  EXPECT_EQ(cp->instance.impl_details.subdiv_permutations,
+            std::vector<std::vector<int>>({{0, 1, 2, 3}}));
+  EXPECT_EQ(cp->subdiv_rank, std::vector<int>({2}));
+}
+
+#define DEF_TEST(B, W, D, L, A)                                        \
+  TEST_F(HierarchicalRingReducerTest,                                  \
+         DaTy##B##_Wkr##W##_Dev##D##_Len##L##_Abrt##A) {               \
+    DataType dtype = DT_##B;                                           \
+    switch (dtype) {                                                   \
+      case DT_FLOAT: {                                                 \
+        RunTest<float>(dtype, W, D, L, A);                             \
+      } break;                                                         \
+      case DT_DOUBLE: {                                                \
+        RunTest<double>(dtype, W, D, L, A);                            \
+      } break;                                                         \
+      case DT_INT32: {                                                 \
+        RunTest<int32>(dtype, W, D, L, A);                             \
+      } break;                                                         \
+      case DT_INT64: {                                                 \
+        RunTest<int64_t>(dtype, W, D, L, A);                           \
+      } break;                                                         \
+      default:                                                         \
+        LOG(FATAL) << "Unimplemented";                                 \
+    }                                                                  \
+  }
+
+// Single task: reduce to and broadcast from the leader only.
+DEF_TEST(FLOAT, 1, 1, 16, 0)
+DEF_TEST(FLOAT, 1, 4, 1001, 0)
+// Single device per task: the ring among leaders only.
+DEF_TEST(FLOAT, 2, 1, 16, 0)
+DEF_TEST(FLOAT, 4, 1, 1001, 0)
+// Fewer elements than tasks leaves some ring chunks empty.
+DEF_TEST(FLOAT, 3, 2, 2, 0)
+DEF_TEST(FLOAT, 2, 4, 4096, 0)
+DEF_TEST(DOUBLE, 3, 3, 1001, 0)
+DEF_TEST(INT32, 4, 2, 128, 0)
+DEF_TEST(INT64, 2, 3, 1001, 0)
+
+// Failure cases.
+DEF_TEST(FLOAT, 2, 4, 128, 1)
+DEF_TEST(FLOAT, 3, 2, 1001, 5)
+
+}  // namespace tensorflow
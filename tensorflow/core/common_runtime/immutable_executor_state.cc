@@ -16,9 +16,11 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/immutable_executor_state.h"
 
 #include "absl/memory/memory.h"
+#include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/edgeset.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_node_util.h"
@@ -196,6 +198,7 @@ Status ImmutableExecutorState::Initialize(const Graph& graph) {
     item->is_recv_or_switch = IsRecv(n) || IsSwitch(n);
     item->is_next_iteration = IsNextIteration(n);
     item->is_distributed_communication = IsDistributedCommunication(n);
+    item->is_stateful = n->op_def().is_stateful();
 
     // Compute the maximum values we'll store for this node in the
     // pending counts data structure, and allocate a handle in
@@ -240,6 +243,25 @@ Status ImmutableExecutorState::Initialize(const Graph& graph) {
       }
       item->outputs_required = std::move(outputs_required);
     }
+
+    // Record which outputs are returned through the call frame, so that they
+    // can be allocated in buffers provided by the caller.
+    if (params_.device->device_type() == DEVICE_CPU) {
+      std::unique_ptr<int[]> output_retval_index;
+      for (const Edge* e : n->out_edges()) {
+        if (e->IsControlEdge() || !e->dst()->IsRetval()) continue;
+        if (!output_retval_index) {
+          output_retval_index.reset(new int[n->num_outputs()]);
+          std::fill(&output_retval_index[0],
+                    &output_retval_index[n->num_outputs()], -1);
+        }
+        if (output_retval_index[e->src_output()] >= 0) continue;
+        int index;
+        TF_RETURN_IF_ERROR(GetNodeAttr(e->dst()->attrs(), "index", &index));
+        output_retval_index[e->src_output()] = index;
+      }
+      item->output_retval_index = std::move(output_retval_index);
+    }
   }
 
   // Rewrite each `EdgeInfo::input_slot` member to refer directly to the input
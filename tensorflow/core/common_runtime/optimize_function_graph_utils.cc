@@ -17,6 +17,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdlib>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -47,7 +48,9 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_node_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/util/debug_data_dumper.h"
 #include "tsl/platform/env.h"
@@ -231,18 +234,58 @@ StatusOr<OptimizedFunctionGraphInfo> ReadFromCache(const string& file_name,
   return optimized_function_graph_info_restored;
 }
 
+// Returns a fingerprint of everything the optimized graph of a function
+// depends on besides the function library: the function body without its
+// name, the instantiation attributes, the session config (which includes the
+// RewriterConfig) and the devices.
+uint64 GetFunctionGraphFingerprint(
+    const FunctionDef& fdef, AttrSlice attrs,
+    const FunctionLibraryRuntime::InstantiateOptions& options,
+    const DeviceSet& dev_set) {
+  FunctionDef unnamed_fdef = fdef;
+  unnamed_fdef.mutable_signature()->clear_name();
+  string serialized;
+  SerializeToStringDeterministic(unnamed_fdef, &serialized);
+  uint64 fingerprint = Fingerprint64(serialized);
+
+  std::map<string, string> sorted_attrs;
+  for (const auto& [name, value] : attrs) {
+    SerializeToStringDeterministic(value, &sorted_attrs[name]);
+  }
+  for (const auto& [name, value] : sorted_attrs) {
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(name));
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(value));
+  }
+
+  SerializeToStringDeterministic(options.config_proto, &serialized);
+  fingerprint = FingerprintCat64(fingerprint, Fingerprint64(serialized));
+
+  std::vector<string> device_names;
+  for (const Device* device : dev_set.devices()) {
+    device_names.push_back(device->name());
+  }
+  std::sort(device_names.begin(), device_names.end());
+  for (const string& device_name : device_names) {
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(device_name));
+  }
+  return fingerprint;
+}
+
 // Gets the full path name of the file cache.
 // TODO(b/276813768) Include more runtime specific info like env/flag
-// values, or line number. An alternative is to use the fingerprint of the
-// graph once graph building cache is enabled.
+// values, or line number.
 //
 // Current file cache key components:
 // 1) Job name.
 // 2) Task ID.
 // 3) Function name (without UUID suffix).
-// 4) TF graph node count.
-string GetFileCacheName(const string& dir_name, const string& function_name,
-                        const FunctionDef* fdef) {
+// 4) Fingerprint of the function graph and its instantiation, see
+//    GetFunctionGraphFingerprint().
+string GetFileCacheName(
+    const string& dir_name, const string& function_name,
+    const FunctionDef* fdef, AttrSlice attrs,
+    const FunctionLibraryRuntime::InstantiateOptions& options,
+    const DeviceSet& dev_set) {
   string plain_func_name = function_name;
   // Remove the random UUID in the function name.
   if (absl::StrContains(function_name, "_")) {
@@ -251,9 +294,11 @@ string GetFileCacheName(const string& dir_name, const string& function_name,
     plain_func_name = absl::StrJoin(func_name_tokens, "_");
   }
 
-  return absl::StrCat(dir_name, "/", tsl::port::JobName(), "_",
-                      tsl::port::TaskId(), "_", plain_func_name, "_",
-                      fdef->node_def_size());
+  return absl::StrCat(
+      dir_name, "/", tsl::port::JobName(), "_", tsl::port::TaskId(), "_",
+      plain_func_name, "_",
+      absl::Hex(GetFunctionGraphFingerprint(*fdef, attrs, options, dev_set),
+                absl::kZeroPad16));
 }
 
 // Generates graph and return information given the input function name,
@@ -680,7 +725,8 @@ StatusOr<OptimizedFunctionGraphInfo> OptimizeFunctionGraphOrReadFromFileCache(
         "Failed to find function ", function_name,
         " in function library: ", lib_def->ToProto().DebugString()));
   }
-  const string file_name = GetFileCacheName(dir_name, function_name, fdef);
+  const string file_name =
+      GetFileCacheName(dir_name, function_name, fdef, attrs, options, dev_set);
 
   // Scenario (2): File cache exists for this function; restore from the cache.
   if (env->FileExists(file_name).ok()) {
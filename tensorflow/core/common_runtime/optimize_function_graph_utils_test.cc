@@ -194,7 +194,7 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   // Check that only one cache file exists.
   file_list.clear();
   TF_ASSERT_OK(env->GetMatchingPaths(
-      absl::StrCat(temp_dir, "/_-1_FindDevice_1"), &file_list));
+      absl::StrCat(temp_dir, "/_-1_FindDevice_*"), &file_list));
   EXPECT_EQ(file_list.size(), 1);
   EXPECT_EQ(metrics::GetFunctionGraphOptimizationSavingTimeUsecs(
                 metrics::GraphOptimizationSource::kJit),
@@ -214,7 +214,7 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   TF_ASSERT_OK(optimized_info.status());
   file_list.clear();
   TF_ASSERT_OK(env->GetMatchingPaths(
-      absl::StrCat(temp_dir, "/_-1_FindDevice_1"), &file_list));
+      absl::StrCat(temp_dir, "/_-1_FindDevice_*"), &file_list));
   EXPECT_EQ(file_list.size(), 1);
   EXPECT_GT(metrics::GetFunctionGraphOptimizationSavingTimeUsecs(
                 metrics::GraphOptimizationSource::kJit),
@@ -229,6 +229,21 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   EXPECT_EQ(optimized_info->num_return_nodes, 1);
   EXPECT_THAT(optimized_info->ret_types, ElementsAre(DT_STRING));
 
+  // Expect a second file cache after changing the session config.
+  opts.config_proto.set_inter_op_parallelism_threads(2);
+  optimized_info = OptimizeFunctionGraphOrReadFromFileCache(
+      "FindDevice_1234", {}, opts, device_set, lib_def.get(),
+      /*composite_devices=*/{}, devices[0].get(), devices[1].get(),
+      Env::Default(), /*caching_threshold_duration=*/absl::ZeroDuration());
+  TF_ASSERT_OK(optimized_info.status());
+  file_list.clear();
+  TF_ASSERT_OK(env->GetMatchingPaths(
+      absl::StrCat(temp_dir, "/_-1_FindDevice_*"), &file_list));
+  EXPECT_EQ(file_list.size(), 2);
+  EXPECT_EQ(metrics::GetFunctionGraphOptimizationCacheMissCount(
+                metrics::GraphOptimizationSource::kJit),
+            3);
+
   // Clean up the cache directory for cases when the test is run multiple times
   // in a row without clearing the filesystem where the test is running.
   int64_t undeleted_files;
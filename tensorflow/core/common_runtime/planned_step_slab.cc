@@ -0,0 +1,172 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/planned_step_slab.h"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/grappler/costs/static_memory_planner.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+Status PlanStepSlab(const Graph& graph, StepSlabPlan* plan) {
+  *plan = StepSlabPlan();
+  grappler::GrapplerItem item;
+  graph.ToGraphDef(&item.graph);
+  grappler::MemoryPlan memory_plan;
+  TF_RETURN_IF_ERROR(grappler::PlanStaticMemory(item, &memory_plan));
+
+  const auto node_index = graph.BuildNodeNameIndex();
+  plan->slab_size = memory_plan.slab_size;
+  plan->slot_index.assign(graph.num_node_ids(), -1);
+  for (const grappler::MemoryPlan::PlannedTensor& tensor :
+       memory_plan.tensors) {
+    auto it = node_index.find(tensor.node);
+    if (it == node_index.end()) {
+      return errors::Internal("Memory plan refers to unknown node ",
+                              tensor.node);
+    }
+    int& index = plan->slot_index[it->second->id()];
+    if (index < 0) {
+      index = plan->node_slots.size();
+      plan->node_slots.emplace_back();
+    }
+    plan->node_slots[index].push_back({tensor.offset, tensor.size});
+  }
+  return absl::OkStatus();
+}
+
+// Serves the allocations of one node from its slots of the slab.
+class PlannedStepSlab::NodeAllocator : public Allocator {
+ public:
+  NodeAllocator(PlannedStepSlab* slab,
+                const std::vector<StepSlabPlan::Slot>* slots)
+      : slab_(slab), slots_(slots) {}
+
+  std::string Name() override { return kName; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    // Every slot is aligned to `kAllocatorAlignment`.
+    void* ptr = alignment <= Allocator::kAllocatorAlignment
+                    ? slab_->AllocateFromSlots(*slots_, num_bytes)
+                    : nullptr;
+    if (ptr == nullptr) {
+      ptr = slab_->fallback_->AllocateRaw(alignment, num_bytes);
+      if (ptr == nullptr) return nullptr;
+    }
+    slab_->Ref();
+    return ptr;
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    if (ptr == nullptr) return;
+    if (!slab_->DeallocateFromSlab(ptr)) {
+      slab_->fallback_->DeallocateRaw(ptr);
+    }
+    slab_->Unref();
+  }
+
+  AllocatorMemoryType GetMemoryType() const override {
+    return slab_->underlying_->GetMemoryType();
+  }
+
+ private:
+  PlannedStepSlab* const slab_;
+  const std::vector<StepSlabPlan::Slot>* const slots_;
+};
+
+PlannedStepSlab::PlannedStepSlab(const StepSlabPlan* plan,
+                                 Allocator* underlying, Allocator* fallback)
+    : plan_(plan),
+      underlying_(underlying),
+      fallback_(fallback),
+      slab_size_(plan->slab_size),
+      base_(slab_size_ > 0 ? static_cast<char*>(underlying->AllocateRaw(
+                                 Allocator::kAllocatorAlignment, slab_size_))
+                           : nullptr) {
+  DCHECK(underlying_ != nullptr);
+  DCHECK(fallback_ != nullptr);
+  node_allocators_.reserve(plan_->node_slots.size());
+  for (const std::vector<StepSlabPlan::Slot>& slots : plan_->node_slots) {
+    node_allocators_.emplace_back(this, &slots);
+  }
+}
+
+PlannedStepSlab::~PlannedStepSlab() {
+  if (base_ != nullptr) {
+    underlying_->DeallocateRaw(base_);
+  }
+}
+
+Allocator* PlannedStepSlab::ForNode(int id) {
+  if (base_ == nullptr || id < 0 ||
+      static_cast<size_t>(id) >= plan_->slot_index.size()) {
+    return nullptr;
+  }
+  const int index = plan_->slot_index[id];
+  return index < 0 ? nullptr : &node_allocators_[index];
+}
+
+void* PlannedStepSlab::AllocateFromSlots(
+    const std::vector<StepSlabPlan::Slot>& slots, size_t num_bytes) {
+  if (num_bytes == 0) return nullptr;
+  const int64_t size = num_bytes;
+  mutex_lock l(mu_);
+  const StepSlabPlan::Slot* best = nullptr;
+  for (const StepSlabPlan::Slot& slot : slots) {
+    if (slot.size < size || (best != nullptr && slot.size >= best->size)) {
+      continue;
+    }
+    // `next` is the first live allocation that starts at or after the slot,
+    // and the one before it is the only other one that may overlap it.
+    auto next = live_.lower_bound(slot.offset);
+    if (next != live_.end() && next->first < slot.offset + size) continue;
+    if (next != live_.begin() && std::prev(next)->second > slot.offset) {
+      continue;
+    }
+    best = &slot;
+  }
+  if (best == nullptr) return nullptr;
+  live_.emplace(best->offset, best->offset + size);
+  bytes_served_.fetch_add(size, std::memory_order_relaxed);
+  return base_ + best->offset;
+}
+
+bool PlannedStepSlab::DeallocateFromSlab(void* ptr) {
+  const char* p = static_cast<const char*>(ptr);
+  if (base_ == nullptr || p < base_ || p >= base_ + slab_size_) {
+    return false;
+  }
+  mutex_lock l(mu_);
+  const size_t erased = live_.erase(p - base_);
+  DCHECK_EQ(erased, 1) << "Deallocating unknown slab offset " << p - base_;
+  return true;
+}
+
+void PlannedStepSlab::Release() { Unref(); }
+
+void PlannedStepSlab::Unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,129 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_PLANNED_STEP_SLAB_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_PLANNED_STEP_SLAB_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// The slots of a slab that a static memory plan assigns to the outputs of the
+// nodes of a graph.
+struct StepSlabPlan {
+  struct Slot {
+    int64_t offset;
+    int64_t size;
+  };
+
+  int64_t slab_size = 0;
+  // For every node id of the graph, the index of its slots in `node_slots`, or
+  // -1 if none of its outputs are planned.
+  std::vector<int> slot_index;
+  std::vector<std::vector<Slot>> node_slots;
+};
+
+// Plans the memory of the CPU partition `graph` with
+// `grappler::PlanStaticMemory`. Fails if the graph cannot be planned, e.g.
+// because it has control flow.
+Status PlanStepSlab(const Graph& graph, StepSlabPlan* plan);
+
+// Serves the allocations of the nodes of one step from the slots that a
+// `StepSlabPlan` assigns to them, in a single slab obtained from an underlying
+// allocator.
+//
+// The allocator of a node serves each request from the smallest of the node's
+// slots that fits it and does not overlap a live allocation from the slab.
+// Other requests are forwarded to a fallback allocator. The slab thus never
+// hands out bytes that are in use, even if a kernel does not forward an input
+// as the plan assumed, or a temporary takes the slot of an output; such
+// requests merely fall back.
+//
+// The slab is reference counted like `StepArenaAllocator`: the step holds one
+// reference, which it drops by calling `Release()`, and every live allocation
+// of the node allocators (including forwarded ones) holds another.
+class PlannedStepSlab {
+ public:
+  // Creates the slab of `plan` from `underlying`. Both `underlying` and
+  // `fallback` must outlive the slab, but `plan` only needs to outlive the
+  // calls to `ForNode()` and the allocations of the step.
+  PlannedStepSlab(const StepSlabPlan* plan, Allocator* underlying,
+                  Allocator* fallback);
+
+  PlannedStepSlab(const PlannedStepSlab&) = delete;
+  void operator=(const PlannedStepSlab&) = delete;
+
+  // The name of every node allocator.
+  static constexpr char kName[] = "planned_step_slab";
+
+  // Returns the allocator of node `id`, or nullptr if the plan assigns no
+  // slots to it. Must not be called after `Release()`.
+  Allocator* ForNode(int id);
+
+  // Drops the step's reference to this slab. It may delete itself before
+  // returning.
+  void Release();
+
+  // Returns the number of bytes served from the slab so far.
+  int64_t bytes_served() const {
+    return bytes_served_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  class NodeAllocator;
+
+  ~PlannedStepSlab();
+
+  // Returns a pointer to the smallest of `slots` that can hold `num_bytes`
+  // and does not overlap a live allocation, or nullptr if there is none.
+  void* AllocateFromSlots(const std::vector<StepSlabPlan::Slot>& slots,
+                          size_t num_bytes);
+  // Frees `ptr` if it points into the slab, and returns false otherwise.
+  bool DeallocateFromSlab(void* ptr);
+
+  void Ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void Unref();
+
+  const StepSlabPlan* const plan_;  // Not owned.
+  Allocator* const underlying_;     // Not owned.
+  Allocator* const fallback_;       // Not owned.
+  const int64_t slab_size_;
+  char* const base_;
+  std::vector<NodeAllocator> node_allocators_;
+
+  mutex mu_;
+  // The live allocations from the slab, as a map from their offset to their
+  // end. They never overlap.
+  std::map<int64_t, int64_t> live_ TF_GUARDED_BY(mu_);
+
+  std::atomic<int64_t> bytes_served_{0};
+  // One reference for the step, plus one for each live allocation.
+  std::atomic<int64_t> refs_{1};
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_PLANNED_STEP_SLAB_H_
@@ -0,0 +1,166 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/planned_step_slab.h"
+
+#include <cstdint>
+
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Counts the calls made to an underlying CPU allocator.
+class CountingAllocator : public Allocator {
+ public:
+  string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_allocations;
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    ++num_deallocations;
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+
+  int num_allocations = 0;
+  int num_deallocations = 0;
+};
+
+// Returns a plan of a 256 byte slab for three nodes: node 0 may use either
+// half of the slab, node 1 the upper half, and node 2 nothing.
+StepSlabPlan TwoSlotPlan() {
+  StepSlabPlan plan;
+  plan.slab_size = 256;
+  plan.slot_index = {0, 1, -1};
+  plan.node_slots = {{{0, 128}, {128, 128}}, {{128, 128}}};
+  return plan;
+}
+
+TEST(PlannedStepSlabTest, ServesNodesFromTheirSlots) {
+  const StepSlabPlan plan = TwoSlotPlan();
+  CountingAllocator underlying;
+  CountingAllocator fallback;
+  PlannedStepSlab* slab = new PlannedStepSlab(&plan, &underlying, &fallback);
+  EXPECT_EQ(underlying.num_allocations, 1);
+  EXPECT_EQ(slab->ForNode(2), nullptr);
+  EXPECT_EQ(slab->ForNode(3), nullptr);
+
+  Allocator* node0 = slab->ForNode(0);
+  Allocator* node1 = slab->ForNode(1);
+  ASSERT_NE(node0, nullptr);
+  ASSERT_NE(node1, nullptr);
+  EXPECT_EQ(node0->Name(), PlannedStepSlab::kName);
+  void* a = node1->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  // The upper half is taken, so node 0 gets the lower half.
+  void* b = node0->AllocateRaw(Allocator::kAllocatorAlignment, 128);
+  EXPECT_EQ(static_cast<char*>(a) - static_cast<char*>(b), 128);
+  EXPECT_EQ(fallback.num_allocations, 0);
+  EXPECT_EQ(slab->bytes_served(), 228);
+
+  node0->DeallocateRaw(b);
+  node1->DeallocateRaw(a);
+  EXPECT_EQ(fallback.num_deallocations, 0);
+  slab->Release();
+  EXPECT_EQ(underlying.num_deallocations, 1);
+}
+
+TEST(PlannedStepSlabTest, FallsBackForRequestsWithoutFreeSlot) {
+  const StepSlabPlan plan = TwoSlotPlan();
+  CountingAllocator underlying;
+  CountingAllocator fallback;
+  PlannedStepSlab* slab = new PlannedStepSlab(&plan, &underlying, &fallback);
+  Allocator* node0 = slab->ForNode(0);
+  Allocator* node1 = slab->ForNode(1);
+
+  // The slots of node 0 have the same size, so it takes them in order.
+  void* a = node0->AllocateRaw(Allocator::kAllocatorAlignment, 64);
+  void* b = node0->AllocateRaw(Allocator::kAllocatorAlignment, 64);
+  EXPECT_EQ(fallback.num_allocations, 0);
+  // Both slots of node 0 are live, and the only slot of node 1 overlaps one
+  // of them.
+  void* c = node0->AllocateRaw(Allocator::kAllocatorAlignment, 64);
+  void* d = node1->AllocateRaw(Allocator::kAllocatorAlignment, 64);
+  EXPECT_EQ(fallback.num_allocations, 2);
+  // Requests that are too large or too aligned for any slot also fall back.
+  void* e = node1->AllocateRaw(Allocator::kAllocatorAlignment, 256);
+  void* f = node1->AllocateRaw(2 * Allocator::kAllocatorAlignment, 64);
+  EXPECT_EQ(fallback.num_allocations, 4);
+
+  for (void* ptr : {c, e, f}) {
+    node1->DeallocateRaw(ptr);
+  }
+  node1->DeallocateRaw(d);
+  EXPECT_EQ(fallback.num_deallocations, 4);
+  // Once the upper half is free, node 1 gets it from the slab.
+  node0->DeallocateRaw(b);
+  void* g = node1->AllocateRaw(Allocator::kAllocatorAlignment, 128);
+  EXPECT_EQ(g, b);
+  EXPECT_EQ(fallback.num_allocations, 4);
+  node1->DeallocateRaw(g);
+  node0->DeallocateRaw(a);
+  slab->Release();
+  EXPECT_EQ(underlying.num_deallocations, 1);
+}
+
+TEST(PlannedStepSlabTest, LiveAllocationsOutliveRelease) {
+  const StepSlabPlan plan = TwoSlotPlan();
+  CountingAllocator underlying;
+  CountingAllocator fallback;
+  PlannedStepSlab* slab = new PlannedStepSlab(&plan, &underlying, &fallback);
+  Allocator* node0 = slab->ForNode(0);
+  void* a = node0->AllocateRaw(Allocator::kAllocatorAlignment, 16);
+  slab->Release();
+  EXPECT_EQ(underlying.num_deallocations, 0);
+  node0->DeallocateRaw(a);
+  EXPECT_EQ(underlying.num_deallocations, 1);
+}
+
+TEST(PlannedStepSlabTest, PlansStaticGraph) {
+  Scope root = Scope::NewRootScope();
+  auto x = ops::Const(root.WithOpName("x"), 1.0f, TensorShape({2, 4}));
+  auto y = ops::MatMul(root.WithOpName("y"), x, x,
+                       ops::MatMul::TransposeB(true));
+  auto z = ops::MatMul(root.WithOpName("z"), y, y);
+  Graph graph(OpRegistry::Global());
+  TF_ASSERT_OK(root.ToGraph(&graph));
+
+  StepSlabPlan plan;
+  TF_ASSERT_OK(PlanStepSlab(graph, &plan));
+  EXPECT_GT(plan.slab_size, 0);
+  ASSERT_EQ(plan.slot_index.size(), graph.num_node_ids());
+  // Constants are not planned.
+  EXPECT_EQ(plan.slot_index[x.node()->id()], -1);
+  const int y_index = plan.slot_index[y.node()->id()];
+  const int z_index = plan.slot_index[z.node()->id()];
+  ASSERT_GE(y_index, 0);
+  ASSERT_GE(z_index, 0);
+  ASSERT_EQ(plan.node_slots[y_index].size(), 1);
+  ASSERT_EQ(plan.node_slots[z_index].size(), 1);
+  // The 2x2 outputs are rounded up to the alignment. `z` may be computed in
+  // place of `y`, so they share a slot.
+  EXPECT_EQ(plan.node_slots[y_index][0].size, Allocator::kAllocatorAlignment);
+  EXPECT_EQ(plan.node_slots[z_index][0].offset,
+            plan.node_slots[y_index][0].offset);
+}
+
+}  // namespace
+}  // namespace tensorflow
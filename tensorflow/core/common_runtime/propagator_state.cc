@@ -331,9 +331,14 @@ void PropagatorState::DeleteFrame(FrameState* frame, TaggedNodeSeq* ready) {
         }
       };
 
+      // Nodes of the parent frame may be activated concurrently without its
+      // lock (see ActivateNodesAndAdjustOutstanding()), so the pending counts
+      // must be updated atomically even though we hold the lock here.
       auto propagate_to_non_merge = [&](PendingCounts::Handle dst_pending_id) {
-        parent_iter_state->increment_dead_count(dst_pending_id);
-        return parent_iter_state->decrement_pending(dst_pending_id, 1) == 0;
+        return parent_iter_state
+                   ->adjust_for_activation_atomic(dst_pending_id,
+                                                  /*increment_dead=*/true)
+                   .pending_count == 0;
       };
 
       for (const EdgeInfo& e : item->output_edges()) {
@@ -345,11 +350,11 @@ void PropagatorState::DeleteFrame(FrameState* frame, TaggedNodeSeq* ready) {
         bool dst_ready;
         // We know this is a dead input to dst.
         if (dst_item.is_merge) {
-          parent_iter_state->increment_dead_count(dst_pending_id);
-          const int dead_cnt = parent_iter_state->dead_count(dst_pending_id);
-          dst_dead = (dead_cnt == dst_item.num_inputs);
-          dst_ready =
-              (parent_iter_state->pending(dst_pending_id) == 1) && dst_dead;
+          const PendingCounts::AdjustResult adjust_result =
+              parent_iter_state->adjust_for_increment_dead_atomic(
+                  dst_pending_id);
+          dst_dead = (adjust_result.dead_count == dst_item.num_inputs);
+          dst_ready = (adjust_result.pending_count == 1) && dst_dead;
         } else {
           dst_ready = propagate_to_non_merge(dst_pending_id);
         }
@@ -365,10 +370,11 @@ void PropagatorState::DeleteFrame(FrameState* frame, TaggedNodeSeq* ready) {
         bool dst_ready;
         // We know this is a dead input to dst.
         if (dst_item.is_merge) {
-          parent_iter_state->decrement_pending(dst_pending_id, 2);
-          int count = parent_iter_state->pending(dst_pending_id);
-          int dead_cnt = parent_iter_state->dead_count(dst_pending_id);
-          dst_dead = (dead_cnt == dst_item.num_inputs);
+          const PendingCounts::AdjustResult adjust_result =
+              parent_iter_state->adjust_for_decrement_pending_atomic(
+                  dst_pending_id, 2);
+          const int count = adjust_result.pending_count;
+          dst_dead = (adjust_result.dead_count == dst_item.num_inputs);
           dst_ready = (count == 0) || ((count == 1) && dst_dead);
         } else {
           dst_dead = true;
@@ -409,7 +415,6 @@ void PropagatorState::CleanupFramesIterations(FrameState* frame,
   }
 }
 
-template <bool atomic>
 int PropagatorState::FrameState::ActivateNodesFastPathInternal(
     const NodeItem* item, const bool is_dead, IterationState* iter_state,
     EntryVector* outputs, TaggedNodeSeq* ready) {
@@ -452,10 +457,8 @@ int PropagatorState::FrameState::ActivateNodesFastPathInternal(
       input_tensors[dst_loc] = (*outputs)[src_slot];
     }
     const PendingCounts::AdjustResult adjust_result =
-        atomic
-            ? iter_state->adjust_for_activation_atomic(dst_pending_id,
-                                                       increment_dead)
-            : iter_state->adjust_for_activation(dst_pending_id, increment_dead);
+        iter_state->adjust_for_activation_atomic(dst_pending_id,
+                                                 increment_dead);
     MAYBE_ADD_TO_READY(dst_id, adjust_result);
   }
 
@@ -464,9 +467,7 @@ int PropagatorState::FrameState::ActivateNodesFastPathInternal(
     const PendingCounts::Handle dst_pending_id =
         immutable_state.pending_ids()[dst_id];
     const PendingCounts::AdjustResult adjust_result =
-        atomic
-            ? iter_state->adjust_for_activation_atomic(dst_pending_id, is_dead)
-            : iter_state->adjust_for_activation(dst_pending_id, is_dead);
+        iter_state->adjust_for_activation_atomic(dst_pending_id, is_dead);
     MAYBE_ADD_TO_READY(dst_id, adjust_result);
   }
 
@@ -474,7 +475,6 @@ int PropagatorState::FrameState::ActivateNodesFastPathInternal(
 #undef MAYBE_ADD_TO_READY
 }
 
-template <bool atomic>
 int PropagatorState::FrameState::ActivateNodesSlowPathInternal(
     const NodeItem* item, const bool is_dead, IterationState* iter_state,
     EntryVector* outputs, TaggedNodeSeq* ready) {
@@ -528,8 +528,7 @@ int PropagatorState::FrameState::ActivateNodesSlowPathInternal(
         }
 
         const PendingCounts::AdjustResult adjust_result =
-            atomic ? iter_state->adjust_for_mark_live_atomic(dst_pending_id)
-                   : iter_state->adjust_for_mark_live(dst_pending_id);
+            iter_state->adjust_for_mark_live_atomic(dst_pending_id);
 
         // The low bit of count is set if and only if no live input has been
         // used yet (mark_live clears it). The node should be started if and
@@ -543,9 +542,7 @@ int PropagatorState::FrameState::ActivateNodesSlowPathInternal(
         // TODO(yuanbyu): This is a bit hacky, but a good solution for
         // now.
         const PendingCounts::AdjustResult adjust_result =
-            atomic
-                ? iter_state->adjust_for_increment_dead_atomic(dst_pending_id)
-                : iter_state->adjust_for_increment_dead(dst_pending_id);
+            iter_state->adjust_for_increment_dead_atomic(dst_pending_id);
         dst_dead = (adjust_result.dead_count == dst_item->num_inputs) ||
                    item->is_enter;
         dst_ready = (adjust_result.pending_count == 1) && dst_dead;
@@ -566,10 +563,8 @@ int PropagatorState::FrameState::ActivateNodesSlowPathInternal(
       const bool increment_dead =
           (is_dead || ((*outputs)[src_slot].state == Entry::State::NO_VALUE));
       const PendingCounts::AdjustResult adjust_result =
-          atomic ? iter_state->adjust_for_activation_atomic(dst_pending_id,
-                                                            increment_dead)
-                 : iter_state->adjust_for_activation(dst_pending_id,
-                                                     increment_dead);
+          iter_state->adjust_for_activation_atomic(dst_pending_id,
+                                                   increment_dead);
       dst_dead = adjust_result.dead_count > 0;
       dst_ready = !(adjust_result.pending_count > 0);
     }
@@ -591,20 +586,15 @@ int PropagatorState::FrameState::ActivateNodesSlowPathInternal(
       // dead. For Merge, pending's LSB is set iff a live data input has
       // arrived.
       const PendingCounts::AdjustResult adjust_result =
-          atomic ? iter_state->adjust_for_decrement_pending_atomic(
-                       dst_pending_id, /*decrement_pending=*/2)
-                 : iter_state->adjust_for_decrement_pending(
-                       dst_pending_id,
-                       /*decrement_pending=*/2);
+          iter_state->adjust_for_decrement_pending_atomic(
+              dst_pending_id, /*decrement_pending=*/2);
       dst_dead = (adjust_result.dead_count == dst_item->num_inputs);
       dst_ready = (adjust_result.pending_count == 0) ||
                   ((adjust_result.pending_count == 1) && dst_dead);
     } else {
       // Handle all other (non-merge) nodes.
       const PendingCounts::AdjustResult adjust_result =
-          atomic ? iter_state->adjust_for_activation_atomic(dst_pending_id,
-                                                            is_dead)
-                 : iter_state->adjust_for_activation(dst_pending_id, is_dead);
+          iter_state->adjust_for_activation_atomic(dst_pending_id, is_dead);
       dst_dead = adjust_result.dead_count > 0;
       dst_ready = adjust_result.pending_count == 0;
     }
@@ -617,29 +607,22 @@ int PropagatorState::FrameState::ActivateNodesSlowPathInternal(
 int PropagatorState::FrameState::ActivateNodesFastPathLocked(
     const NodeItem* item, const bool is_dead, IterationState* iter_state,
     EntryVector* outputs, TaggedNodeSeq* ready) {
-  return ActivateNodesFastPathInternal<false>(item, is_dead, iter_state,
-                                              outputs, ready);
-}
-
-int PropagatorState::FrameState::ActivateNodesFastPathShared(
-    const NodeItem* item, const bool is_dead, IterationState* iter_state,
-    EntryVector* outputs, TaggedNodeSeq* ready) {
-  return ActivateNodesFastPathInternal<true>(item, is_dead, iter_state, outputs,
-                                             ready);
+  return ActivateNodesFastPathInternal(item, is_dead, iter_state, outputs,
+                                       ready);
 }
 
 int PropagatorState::FrameState::ActivateNodesSlowPathLocked(
     const NodeItem* item, const bool is_dead, IterationState* iter_state,
     EntryVector* outputs, TaggedNodeSeq* ready) {
-  return ActivateNodesSlowPathInternal<false>(item, is_dead, iter_state,
-                                              outputs, ready);
+  return ActivateNodesSlowPathInternal(item, is_dead, iter_state, outputs,
+                                       ready);
 }
 
 int PropagatorState::FrameState::ActivateNodesSlowPathShared(
     const NodeItem* item, const bool is_dead, IterationState* iter_state,
     EntryVector* outputs, TaggedNodeSeq* ready) {
-  return ActivateNodesSlowPathInternal<true>(item, is_dead, iter_state, outputs,
-                                             ready);
+  return ActivateNodesSlowPathInternal(item, is_dead, iter_state, outputs,
+                                       ready);
 }
 
 bool PropagatorState::FrameState::ActivateNodesAndAdjustOutstanding(
@@ -653,12 +636,27 @@ bool PropagatorState::FrameState::ActivateNodesAndAdjustOutstanding(
         iter_state, activated - decrement_activation);
     if (!iter_done) return false;
   } else {
-    tf_shared_lock l(mu);
-    int activated =
-        ActivateNodesFastPathShared(item, is_dead, iter_state, outputs, ready);
-    bool iter_done = AdjustOutstandingOpsFastPath(
-        iter_state, activated - decrement_activation);
-    if (!iter_done) return false;
+    // None of the destinations is a merge or control trigger node, so the
+    // activation only needs atomic updates of the pending counts and of the
+    // outstanding op count, and does not take `mu` at all. This is safe
+    // because every other writer of these counts (including those holding
+    // `mu` exclusively) also updates them atomically, and because `iter_state`
+    // cannot be deleted before this node is accounted for. The lock is only
+    // needed to clean up once the iteration may be done.
+    const int activated = ActivateNodesFastPathInternal(item, is_dead,
+                                                        iter_state, outputs,
+                                                        ready);
+    const int delta = activated - decrement_activation;
+    if (delta == 0 ||
+        iter_state->outstanding_ops.fetch_add(delta) + delta != 0) {
+      return false;
+    }
+    mutex_lock l(mu);
+    if (!IsIterationDone(iter_state)) return false;
+    if (decrement_activation > 0) {
+      return CleanupIterations(iter_state, ready);
+    }
+    return true;
   }
   if (decrement_activation > 0) {
     mutex_lock l(mu);
@@ -877,13 +875,13 @@ bool PropagatorState::FrameState::DecrementOutstandingOpsLocked(
 
 bool PropagatorState::FrameState::AdjustOutstandingOpsLocked(
     IterationState* iter_state, int delta, TaggedNodeSeq* ready) {
-  // We hold the lock, so we don't need to use an atomic modification.
-  auto cur_val = iter_state->outstanding_ops.load(std::memory_order_relaxed);
+  // Even though we hold the lock, the count may be concurrently adjusted by
+  // ActivateNodesAndAdjustOutstanding(), which does not take it.
+  auto cur_val = iter_state->outstanding_ops.fetch_add(delta);
   DCHECK(delta >= 0 || cur_val >= -delta)
       << "cannot adjust outstanding_ops by " << delta
       << " when current value is " << cur_val;
   auto new_val = cur_val + delta;
-  iter_state->outstanding_ops.store(new_val, std::memory_order_relaxed);
   if (new_val != 0) {
     return false;
   }
@@ -386,8 +386,8 @@ class PropagatorState {
     // indeterminate state after returning from this method.
     //
     // In the case that 'item' is a simple node (no merge/control outputs) this
-    // will acquire a shared lock and can run concurrently with other
-    // invocations.
+    // only takes the lock if the iteration may be done, and can otherwise run
+    // concurrently with other invocations.
     //
     // Return true if the frame is done after activation.
     bool ActivateNodesAndAdjustOutstanding(
@@ -423,20 +423,11 @@ class PropagatorState {
 
    private:
     // REQUIRES: `!item->is_any_consumer_merge_or_control_trigger`.
-    // This variant does not use atomic operations to modify the pending counts
-    // and thus must hold the exclusive lock.
     int ActivateNodesFastPathLocked(const NodeItem* item, bool is_dead,
                                     IterationState* iter_state,
                                     EntryVector* outputs, TaggedNodeSeq* ready)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu);
 
-    // REQUIRES: `!item->is_any_consumer_merge_or_control_trigger`.
-    // This variant uses atomic operations to modify the pending counts.
-    int ActivateNodesFastPathShared(const NodeItem* item, bool is_dead,
-                                    IterationState* iter_state,
-                                    EntryVector* outputs, TaggedNodeSeq* ready)
-        TF_SHARED_LOCKS_REQUIRED(mu);
-
     int ActivateNodesSlowPathLocked(const NodeItem* item, bool is_dead,
                                     IterationState* iter_state,
                                     EntryVector* outputs, TaggedNodeSeq* ready)
@@ -447,13 +438,15 @@ class PropagatorState {
                                     EntryVector* outputs, TaggedNodeSeq* ready)
         TF_SHARED_LOCKS_REQUIRED(mu);
 
-    // Implementation templates. Not for public use.
-    template <bool atomic>
+    // Implementations of the above. Not for public use.
+    //
+    // These always modify the pending counts atomically, even when `mu` is
+    // held exclusively, because simple nodes are activated without the lock
+    // (see ActivateNodesAndAdjustOutstanding()).
     int ActivateNodesFastPathInternal(const NodeItem* item, bool is_dead,
                                       IterationState* iter_state,
                                       EntryVector* outputs,
                                       TaggedNodeSeq* ready);
-    template <bool atomic>
     int ActivateNodesSlowPathInternal(const NodeItem* item, bool is_dead,
                                       IterationState* iter_state,
                                       EntryVector* outputs,
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/request_cost.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -34,6 +35,13 @@ void RequestCost::RecordCost(
   }
 }
 
+void RequestCost::RecordMaxCost(absl::string_view cost_type,
+                                absl::Duration cost) {
+  absl::MutexLock lock(&mutex_);
+  absl::Duration& recorded = cost_map_[cost_type];
+  recorded = std::max(recorded, cost);
+}
+
 absl::flat_hash_map<std::string, absl::Duration> RequestCost::GetCosts() const {
   absl::MutexLock lock(&mutex_);
   return cost_map_;
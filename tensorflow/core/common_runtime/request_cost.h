@@ -37,6 +37,11 @@ class RequestCost {
   void RecordCost(
       const std::vector<std::pair<absl::string_view, absl::Duration>>& costs);
 
+  // Records `cost` for `cost_type` unless a larger cost was recorded for it,
+  // for costs that several parts of a request measure from the same start.
+  // It's thread-safe, and can be called from different threads.
+  void RecordMaxCost(absl::string_view cost_type, absl::Duration cost);
+
   // Gets all types of costs for processing an rpc request.
   // It's thread-safe. It's expected to be called at the end of processing an
   // rpc request, when all the costs have been collected.
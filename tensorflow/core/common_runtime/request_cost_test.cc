@@ -51,6 +51,16 @@ TEST(RequestCostTest, RecordCost) {
                                    Pair("cpu_v2", absl::Milliseconds(44))));
 }
 
+TEST(RequestCostTest, RecordMaxCost) {
+  RequestCost request_cost;
+
+  request_cost.RecordMaxCost("wait", absl::Milliseconds(3));
+  request_cost.RecordMaxCost("wait", absl::Milliseconds(5));
+  request_cost.RecordMaxCost("wait", absl::Milliseconds(4));
+  EXPECT_THAT(request_cost.GetCosts(),
+              UnorderedElementsAre(Pair("wait", absl::Milliseconds(5))));
+}
+
 TEST(RequestCostTest, RecordBatchMetrics) {
   RequestCost request_cost;
 
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/single_threaded_executor.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <utility>
 
 #include "tensorflow/core/common_runtime/entry.h"
@@ -25,8 +28,11 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 namespace tensorflow {
 
@@ -67,11 +73,13 @@ typedef gtl::InlinedVector<AllocatorAttributes, 4> AllocatorAttributeVec;
 
 static const string& kSingleThreadedExecutor =
     *new string("SINGLE_THREADED_EXECUTOR");
+static const string& kStaticPlanExecutor = *new string("STATIC_PLAN_EXECUTOR");
 
 class SingleThreadedExecutorImpl : public Executor {
  public:
-  explicit SingleThreadedExecutorImpl(const LocalExecutorParams& params)
-      : params_(params) {}
+  explicit SingleThreadedExecutorImpl(const LocalExecutorParams& params,
+                                      bool use_static_plan = false)
+      : params_(params), use_static_plan_(use_static_plan) {}
 
   ~SingleThreadedExecutorImpl() override {
     for (const KernelState& kernel_state : kernels_) {
@@ -147,6 +155,8 @@ class SingleThreadedExecutorImpl : public Executor {
         kernel_state.kernel = kernel;
         kernel_state.num_inputs = n->num_inputs();
         kernel_state.num_outputs = n->num_outputs();
+        kernel_state.is_stateful = n->op_def().is_stateful();
+        kernel_state.node_id = n->id();
         node_to_index_map[n] = kernel_index;
         if (kernel_index == 0) {
           kernel_state.input_start_index = 0;
@@ -251,6 +261,10 @@ class SingleThreadedExecutorImpl : public Executor {
     } else {
       total_num_inputs_ = 0;
     }
+
+    if (use_static_plan_) {
+      BuildStaticPlan(nodes_with_kernels, node_to_index_map);
+    }
     return absl::OkStatus();
   }
 
@@ -328,7 +342,9 @@ class SingleThreadedExecutorImpl : public Executor {
     params.runner = &runner_copy;
     params.run_all_kernels_inline = args.run_all_kernels_inline;
     params.stats_collector = args.stats_collector;
-    params.executor_type = &kSingleThreadedExecutor;
+    params.step_allocator = args.step_allocator;
+    params.executor_type =
+        use_static_plan_ ? &kStaticPlanExecutor : &kSingleThreadedExecutor;
 
     // NOTE(mrry): We are assuming that the graph is loopless and condless.
     params.frame_iter = FrameAndIter(0, 0);
@@ -405,82 +421,29 @@ class SingleThreadedExecutorImpl : public Executor {
       }
     }
 
-    // Execute the kernels one-at-a-time in topological order.
-    for (size_t i = 0; i < kernels_.size(); ++i) {
-      const KernelState& kernel_state = kernels_[i];
-
-      // Prepare the per-kernel parameters.
-      const size_t input_start_index = kernel_state.input_start_index;
-      const size_t num_inputs = kernel_state.num_inputs;
-      const size_t num_outputs = kernel_state.num_outputs;
-
-      node_inputs.clear();
-      node_inputs.resize(num_inputs);
-      input_alloc_attrs.clear();
-      input_alloc_attrs.resize(num_inputs);
-      for (size_t j = 0; j < num_inputs; ++j) {
-        Entry& input = inputs[input_start_index + j];
-        switch (input.state) {
-          case Entry::State::HAS_CONST_TENSOR:
-            // NOTE(mrry): This `const_cast` is necessary because `TensorValue`
-            // stores a non-const `Tensor*`, and relies on the `OpKernelContext`
-            // accessors making dynamic checks that prevent using an immutable
-            // tensor as a mutable tensor.
-            node_inputs[j].tensor = const_cast<Tensor*>(input.const_tensor);
-            break;
-          case Entry::State::HAS_VALUE:
-            node_inputs[j].tensor = input.val.get();
-            break;
-          default:
-            DCHECK(false) << "Input did not have a valid value.";
-        }
-        input_alloc_attrs[j] = input_alloc_attrs_[input_start_index + j];
-      }
-      params.inputs = node_inputs;
-      params.input_alloc_attrs = input_alloc_attrs;
-      params.op_kernel = kernel_state.kernel;
-      params.output_attr_array = kernel_state.output_alloc_attrs.data();
-      OpKernelContext ctx(&params, num_outputs);
-
-      // Actually execute the kernel.
-      device->Compute(kernel_state.kernel, &ctx);
-      TF_RETURN_IF_ERROR(ctx.status());
-
-      // Free the inputs to the current kernel.
-      for (size_t j = 0; j < num_inputs; ++j) {
-        inputs[input_start_index + j].ClearVal();
-      }
-
-      // Forward the outputs of the kernel to the inputs of subsequent kernels.
-      for (size_t j = 0; j < num_outputs; ++j) {
-        TensorValue val = ctx.release_output(j);
-        const size_t num_destinations = kernel_state.output_locations[j].size();
-        if (num_destinations > 0) {
-          // TODO(mrry): Consider flattening the `output_locations` vector
-          // to improve the cache-friendliness of this loop.
-          for (size_t k = 0; k < num_destinations - 1; ++k) {
-            // TODO(mrry): Validate that the types match the expected values or
-            // ensure that the necessary validation has already happened.
-            Entry& input = inputs[kernel_state.output_locations[j][k]];
-            input.state = Entry::State::HAS_VALUE;
-            if (val.tensor != nullptr) {
-              input.val.Init(*val.tensor);
-            } else {
-              input.val.Init(Tensor(kernel_state.kernel->output_type(j)));
-            }
-          }
-          // Move `arg` to the last consumer to avoid the cost of copying it.
-          Entry& input =
-              inputs[kernel_state.output_locations[j][num_destinations - 1]];
-          input.state = Entry::State::HAS_VALUE;
-          if (val.tensor != nullptr) {
-            input.val.Init(std::move(*val.tensor));
-          } else {
-            input.val.Init(Tensor(kernel_state.kernel->output_type(j)));
+    if (use_static_plan_) {
+      // Execute the levels of the static plan in order. Within a level, the
+      // inline runs are independent and may execute concurrently.
+      for (const std::vector<InlineRun>& level : plan_) {
+        if (level.size() == 1) {
+          for (size_t i : level[0]) {
+            TF_RETURN_IF_ERROR(RunKernel(i, device, inputs.data(), &params,
+                                         &node_inputs, &input_alloc_attrs,
+                                         args.node_step_allocator));
           }
+        } else {
+          TF_RETURN_IF_ERROR(RunLevel(level, device, params, inputs.data(),
+                                      runner_copy, args.node_step_allocator));
         }
-        delete val.tensor;
       }
+      return absl::OkStatus();
+    }
+
+    // Execute the kernels one-at-a-time in topological order.
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      TF_RETURN_IF_ERROR(RunKernel(i, device, inputs.data(), &params,
+                                   &node_inputs, &input_alloc_attrs,
+                                   args.node_step_allocator));
     }
     return absl::OkStatus();
   }
@@ -495,8 +458,226 @@ class SingleThreadedExecutorImpl : public Executor {
     args.runner([this, args, done]() { done(Run(args)); });
   }
 
+  // A sequence of indices into `kernels_` that is executed in order by a
+  // single thread.
+  typedef std::vector<size_t> InlineRun;
+
+  // Executes `kernels_[i]`, consuming its inputs from `inputs` and forwarding
+  // its outputs to the input slots of the kernels that depend on it. The
+  // `params`, `node_inputs` and `input_alloc_attrs` buffers must not be shared
+  // with concurrent calls.
+  Status RunKernel(
+      size_t i, Device* device, Entry* inputs, OpKernelContext::Params* params,
+      TensorValueVec* node_inputs, AllocatorAttributeVec* input_alloc_attrs,
+      const std::function<Allocator*(int)>& node_step_allocator) const {
+    const KernelState& kernel_state = kernels_[i];
+
+    // Prepare the per-kernel parameters.
+    const size_t input_start_index = kernel_state.input_start_index;
+    const size_t num_inputs = kernel_state.num_inputs;
+    const size_t num_outputs = kernel_state.num_outputs;
+
+    node_inputs->clear();
+    node_inputs->resize(num_inputs);
+    input_alloc_attrs->clear();
+    input_alloc_attrs->resize(num_inputs);
+    for (size_t j = 0; j < num_inputs; ++j) {
+      Entry& input = inputs[input_start_index + j];
+      switch (input.state) {
+        case Entry::State::HAS_CONST_TENSOR:
+          // NOTE(mrry): This `const_cast` is necessary because `TensorValue`
+          // stores a non-const `Tensor*`, and relies on the `OpKernelContext`
+          // accessors making dynamic checks that prevent using an immutable
+          // tensor as a mutable tensor.
+          (*node_inputs)[j].tensor = const_cast<Tensor*>(input.const_tensor);
+          break;
+        case Entry::State::HAS_VALUE:
+          (*node_inputs)[j].tensor = input.val.get();
+          break;
+        default:
+          DCHECK(false) << "Input did not have a valid value.";
+      }
+      (*input_alloc_attrs)[j] = input_alloc_attrs_[input_start_index + j];
+    }
+    params->inputs = *node_inputs;
+    params->input_alloc_attrs = *input_alloc_attrs;
+    params->op_kernel = kernel_state.kernel;
+    params->output_attr_array = kernel_state.output_alloc_attrs.data();
+    Allocator* const step_allocator = params->step_allocator;
+    if (kernel_state.is_stateful) {
+      params->step_allocator = nullptr;
+    } else if (node_step_allocator) {
+      Allocator* const node_allocator =
+          node_step_allocator(kernel_state.node_id);
+      if (node_allocator != nullptr) params->step_allocator = node_allocator;
+    }
+    OpKernelContext ctx(params, num_outputs);
+
+    // Actually execute the kernel.
+    device->Compute(kernel_state.kernel, &ctx);
+    params->step_allocator = step_allocator;
+    TF_RETURN_IF_ERROR(ctx.status());
+
+    // Free the inputs to the current kernel.
+    for (size_t j = 0; j < num_inputs; ++j) {
+      inputs[input_start_index + j].ClearVal();
+    }
+
+    // Forward the outputs of the kernel to the inputs of subsequent kernels.
+    for (size_t j = 0; j < num_outputs; ++j) {
+      TensorValue val = ctx.release_output(j);
+      const size_t num_destinations = kernel_state.output_locations[j].size();
+      if (num_destinations > 0) {
+        // TODO(mrry): Consider flattening the `output_locations` vector
+        // to improve the cache-friendliness of this loop.
+        for (size_t k = 0; k < num_destinations - 1; ++k) {
+          // TODO(mrry): Validate that the types match the expected values or
+          // ensure that the necessary validation has already happened.
+          Entry& input = inputs[kernel_state.output_locations[j][k]];
+          input.state = Entry::State::HAS_VALUE;
+          if (val.tensor != nullptr) {
+            input.val.Init(*val.tensor);
+          } else {
+            input.val.Init(Tensor(kernel_state.kernel->output_type(j)));
+          }
+        }
+        // Move `arg` to the last consumer to avoid the cost of copying it.
+        Entry& input =
+            inputs[kernel_state.output_locations[j][num_destinations - 1]];
+        input.state = Entry::State::HAS_VALUE;
+        if (val.tensor != nullptr) {
+          input.val.Init(std::move(*val.tensor));
+        } else {
+          input.val.Init(Tensor(kernel_state.kernel->output_type(j)));
+        }
+      }
+      delete val.tensor;
+    }
+    return absl::OkStatus();
+  }
+
+  // Tracks the concurrent execution of the inline runs in one level of the
+  // static plan. Each participating thread claims runs by incrementing
+  // `next_run`. A helper closure that starts after every run has been claimed
+  // touches nothing but this object, which it keeps alive, so it may safely
+  // run after the step has finished.
+  struct LevelState {
+    explicit LevelState(size_t num_runs) : num_runs(num_runs) {}
+
+    const size_t num_runs;
+    std::atomic<size_t> next_run{0};
+    // Set when a kernel fails, so that unstarted runs may be skipped.
+    std::atomic<bool> failed{false};
+
+    mutex mu;
+    condition_variable cv;
+    size_t num_done TF_GUARDED_BY(mu) = 0;
+    Status status TF_GUARDED_BY(mu);
+  };
+
+  // Executes the inline runs in `level` on the calling thread and on up to
+  // `level.size() - 1` closures scheduled on `runner`, and blocks until they
+  // have all completed. The calling thread only waits for runs that other
+  // threads have already started, so this cannot deadlock on a saturated
+  // `runner`.
+  Status RunLevel(
+      const std::vector<InlineRun>& level, Device* device,
+      const OpKernelContext::Params& params, Entry* inputs,
+      const Args::Runner& runner,
+      const std::function<Allocator*(int)>& node_step_allocator) const {
+    auto state = std::make_shared<LevelState>(level.size());
+    auto run_claimed = [this, state, &level, device, &params, inputs,
+                        &node_step_allocator]() {
+      size_t r = state->next_run.fetch_add(1, std::memory_order_relaxed);
+      if (r >= state->num_runs) return;
+      OpKernelContext::Params local_params = params;
+      // `eigen_gpu_device` is owned by `Params`, so it must not be shared.
+      local_params.eigen_gpu_device = nullptr;
+      TensorValueVec node_inputs;
+      AllocatorAttributeVec input_alloc_attrs;
+      for (; r < state->num_runs;
+           r = state->next_run.fetch_add(1, std::memory_order_relaxed)) {
+        Status s;
+        if (!state->failed.load(std::memory_order_relaxed)) {
+          for (size_t i : level[r]) {
+            s = RunKernel(i, device, inputs, &local_params, &node_inputs,
+                          &input_alloc_attrs, node_step_allocator);
+            if (!s.ok()) {
+              state->failed.store(true, std::memory_order_relaxed);
+              break;
+            }
+          }
+        }
+        mutex_lock l(state->mu);
+        state->status.Update(s);
+        if (++state->num_done == state->num_runs) {
+          state->cv.notify_all();
+        }
+      }
+    };
+
+    const size_t num_helpers = std::min<size_t>(
+        level.size() - 1, std::max(1, port::MaxParallelism()));
+    for (size_t h = 0; h < num_helpers; ++h) {
+      runner(run_claimed);
+    }
+    run_claimed();
+
+    mutex_lock l(state->mu);
+    while (state->num_done < state->num_runs) {
+      state->cv.wait(l);
+    }
+    return state->status;
+  }
+
+  // Partitions `kernels_` into levels, such that each kernel depends (through
+  // data or control edges) only on kernels in earlier levels, and groups the
+  // kernels in each level into inline runs. Each expensive kernel gets its own
+  // run; all inexpensive kernels in a level share a single run, since
+  // dispatching them to another thread would cost more than executing them.
+  void BuildStaticPlan(
+      const std::vector<Node*>& nodes_with_kernels,
+      const absl::flat_hash_map<Node*, size_t>& node_to_index_map) {
+    std::vector<int> kernel_levels(kernels_.size(), 0);
+    int num_levels = 0;
+    // `kernels_` is in topological order, so the levels of all producers of
+    // kernel `i` are known when it is visited.
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      int level = 0;
+      for (const Edge* e : nodes_with_kernels[i]->in_edges()) {
+        auto it = node_to_index_map.find(e->src());
+        if (it != node_to_index_map.end()) {
+          level = std::max(level, kernel_levels[it->second] + 1);
+        }
+      }
+      kernel_levels[i] = level;
+      num_levels = std::max(num_levels, level + 1);
+    }
+
+    plan_.clear();
+    plan_.resize(num_levels);
+    std::vector<int> inexpensive_run_index(num_levels, -1);
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      const int level = kernel_levels[i];
+      std::vector<InlineRun>& runs = plan_[level];
+      if (kernels_[i].kernel->IsExpensive()) {
+        runs.push_back({i});
+      } else {
+        if (inexpensive_run_index[level] < 0) {
+          inexpensive_run_index[level] = runs.size();
+          runs.emplace_back();
+        }
+        runs[inexpensive_run_index[level]].push_back(i);
+      }
+    }
+  }
+
   const LocalExecutorParams params_;
 
+  // If true, kernels are executed according to `plan_`, which may run
+  // independent kernels concurrently on `Args::runner`.
+  const bool use_static_plan_;
+
   // All following members are read-only after Initialize().
 
   // The sum of the number of inputs for each node in the graph. This determines
@@ -528,9 +709,23 @@ class SingleThreadedExecutorImpl : public Executor {
     // Memory space information for each output of `kernel`.
     std::vector<AllocatorAttributes>
         output_alloc_attrs;  // Length = `num_outputs`.
+
+    // True iff `kernel`'s op is stateful. Stateful kernels may keep the
+    // tensors that they allocate beyond the step, so they do not allocate
+    // from the step's arena.
+    bool is_stateful = false;
+
+    // The id of the node of `kernel`.
+    int node_id = -1;
   };
   std::vector<KernelState> kernels_;
 
+  // The static execution plan, if `use_static_plan_` is true. `plan_[l]`
+  // contains the inline runs for level `l`. Every kernel in level `l` depends
+  // only on kernels in levels `0` to `l - 1`, so the runs in a level can be
+  // executed concurrently once the previous level has completed.
+  std::vector<std::vector<InlineRun>> plan_;
+
   // For the `i`th argument, `arg_output_locations_[i]` contains the locations
   // in the flat `inputs` vector to which that argument must be copied.
   std::vector<std::vector<size_t>>
@@ -589,6 +784,25 @@ class SingleThreadedExecutorRegistrar {
 };
 static SingleThreadedExecutorRegistrar registrar;
 
+class StaticPlanExecutorRegistrar {
+ public:
+  StaticPlanExecutorRegistrar() {
+    ExecutorFactory::Register(kStaticPlanExecutor, new Factory());
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      Executor* ret;
+      TF_RETURN_IF_ERROR(NewStaticPlanExecutor(params, graph, &ret));
+      out_executor->reset(ret);
+      return absl::OkStatus();
+    }
+  };
+};
+static StaticPlanExecutorRegistrar static_plan_registrar;
+
 }  // namespace
 
 Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
@@ -599,4 +813,13 @@ Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
   return absl::OkStatus();
 }
 
+Status NewStaticPlanExecutor(const LocalExecutorParams& params,
+                             const Graph& graph, Executor** executor) {
+  auto impl = std::make_unique<SingleThreadedExecutorImpl>(
+      params, /*use_static_plan=*/true);
+  TF_RETURN_IF_ERROR(impl->Initialize(graph));
+  *executor = impl.release();
+  return absl::OkStatus();
+}
+
 }  // namespace tensorflow
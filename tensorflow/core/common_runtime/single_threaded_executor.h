@@ -54,6 +54,22 @@ namespace tensorflow {
 Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
                                  const Graph& graph, Executor** executor);
 
+// Creates a new `Executor` for executing `graph` according to a static plan
+// that is computed once, when the executor is created.
+//
+// The plan partitions the kernels into topological levels, and groups the
+// kernels in each level into "inline runs" that execute sequentially on one
+// thread: each expensive kernel forms its own run, and the inexpensive kernels
+// in a level share a run. Each step replays the plan level by level, executing
+// the runs in a level concurrently using `Executor::Args::runner`. Unlike the
+// default executor, no per-node pending counts are maintained at runtime.
+//
+// The returned executor has the same limitations as the executor returned by
+// `NewSingleThreadedExecutor()`. It is registered with `ExecutorFactory` as
+// "STATIC_PLAN_EXECUTOR".
+Status NewStaticPlanExecutor(const LocalExecutorParams& params,
+                             const Graph& graph, Executor** executor);
+
 // Returns OkStatus() for ops which are compatible with synchronous execution,
 // and otherwise returns an error message appropriate for propagation if needed.
 // If `allow_control_flow_sync_execution` is set to `true` control
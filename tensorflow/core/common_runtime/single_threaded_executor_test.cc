@@ -41,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -104,8 +105,7 @@ class ExecutorTest : public ::testing::Test {
     params.delete_kernel = [](OpKernel* kernel) {
       DeleteNonCachedKernel(kernel);
     };
-    TF_CHECK_OK(
-        NewExecutor("SINGLE_THREADED_EXECUTOR", params, *graph, &exec_));
+    TF_CHECK_OK(NewExecutor(executor_type_, params, *graph, &exec_));
     runner_ = [](const std::function<void()>& fn) { fn(); };
     rendez_ = NewLocalRendezvous();
   }
@@ -155,6 +155,7 @@ class ExecutorTest : public ::testing::Test {
   std::unique_ptr<Executor> exec_ = nullptr;
   Executor::Args::Runner runner_;
   Rendezvous* rendez_ = nullptr;
+  string executor_type_ = "SINGLE_THREADED_EXECUTOR";
 };
 
 // A float val -> Tensor<float>
@@ -325,6 +326,41 @@ TEST_F(ExecutorTest, RandomTree) {
   EXPECT_EQ(4096.0, V(retvals[0]));
 }
 
+TEST_F(ExecutorTest, StaticPlanRandomTree) {
+  executor_type_ = "STATIC_PLAN_EXECUTOR";
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  Create(std::move(g));
+  thread::ThreadPool pool(Env::Default(), "static_plan", 4);
+  runner_ = [&pool](const std::function<void()>& fn) { pool.Schedule(fn); };
+  for (int i = 0; i < 4; ++i) {
+    FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+    TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+    TF_ASSERT_OK(Run(&call_frame));
+    std::vector<Tensor> retvals;
+    TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+    EXPECT_EQ(4096.0, V(retvals[0]));
+  }
+}
+
+TEST_F(ExecutorTest, StaticPlanOpError) {
+  executor_type_ = "STATIC_PLAN_EXECUTOR";
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto zero = test::graph::Constant(g.get(), V(0.0));
+  auto inf = test::graph::Unary(g.get(), "Reciprocal", zero);
+  auto check = test::graph::CheckNumerics(g.get(), inf, "message");
+  auto two = test::graph::Constant(g.get(), V(2.0));
+  test::graph::Binary(g.get(), "Mul", check, two);
+  // An independent branch in the same level as the failing kernel.
+  test::graph::Unary(g.get(), "Neg", two);
+  FixupSourceAndSinkEdges(g.get());
+  Create(std::move(g));
+  thread::ThreadPool pool(Env::Default(), "static_plan", 4);
+  runner_ = [&pool](const std::function<void()>& fn) { pool.Schedule(fn); };
+  FunctionCallFrame call_frame({}, {});
+  EXPECT_TRUE(absl::IsInvalidArgument(Run(&call_frame)));
+}
+
 TEST_F(ExecutorTest, OpError) {
   auto g = std::make_unique<Graph>(OpRegistry::Global());
   auto zero = test::graph::Constant(g.get(), V(0.0));
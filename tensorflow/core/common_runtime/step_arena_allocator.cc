@@ -0,0 +1,109 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+size_t RoundUp(size_t n, size_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+StepArenaAllocator::StepArenaAllocator(Allocator* underlying, size_t capacity)
+    : underlying_(underlying),
+      capacity_(std::min<uint64_t>(capacity, kOffsetMask)),
+      base_(capacity_ > 0 ? static_cast<char*>(underlying->AllocateRaw(
+                                Allocator::kAllocatorAlignment, capacity_))
+                          : nullptr) {
+  DCHECK(underlying_ != nullptr);
+}
+
+StepArenaAllocator::~StepArenaAllocator() {
+  if (base_ != nullptr) {
+    underlying_->DeallocateRaw(base_);
+  }
+}
+
+void* StepArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  // Round every request up to the default alignment, so that consecutive
+  // allocations never share a cache line.
+  const uint64_t rounded_bytes = RoundUp(std::max<size_t>(num_bytes, 1),
+                                         Allocator::kAllocatorAlignment);
+  bytes_requested_.fetch_add(rounded_bytes, std::memory_order_relaxed);
+
+  // Reserve the next `rounded_bytes` of the arena and count the allocation,
+  // even if it has to be forwarded, so that `peak_bytes()` accounts for it.
+  // The reservation starts over at the beginning of the arena if no
+  // allocation is live.
+  uint64_t state = state_.load(std::memory_order_relaxed);
+  uint64_t offset;
+  uint64_t end;
+  do {
+    offset = state < kOneAllocation ? 0 : state & kOffsetMask;
+    end = std::min(offset + rounded_bytes, kOffsetMask);
+  } while (!state_.compare_exchange_weak(
+      state, ((state & ~kOffsetMask) + kOneAllocation) | end,
+      std::memory_order_acquire, std::memory_order_relaxed));
+  DCHECK_NE(state & ~kOffsetMask, ~kOffsetMask) << "Too many live allocations";
+  size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (end > peak && !peak_bytes_.compare_exchange_weak(
+                           peak, end, std::memory_order_relaxed)) {
+  }
+  refs_.fetch_add(1, std::memory_order_relaxed);
+
+  if (base_ != nullptr && alignment <= Allocator::kAllocatorAlignment &&
+      end <= capacity_) {
+    return base_ + offset;
+  }
+
+  void* ptr = underlying_->AllocateRaw(alignment, num_bytes);
+  if (ptr == nullptr) {
+    state_.fetch_sub(kOneAllocation, std::memory_order_relaxed);
+    Unref();
+    return nullptr;
+  }
+  bytes_forwarded_.fetch_add(rounded_bytes, std::memory_order_relaxed);
+  return ptr;
+}
+
+void StepArenaAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) return;
+  if (!InArena(ptr)) {
+    underlying_->DeallocateRaw(ptr);
+  }
+  // Once no allocation is live, the next one starts at the beginning of the
+  // arena again.
+  state_.fetch_sub(kOneAllocation, std::memory_order_release);
+  Unref();
+}
+
+void StepArenaAllocator::Release() { Unref(); }
+
+void StepArenaAllocator::Unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,122 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "tensorflow/core/framework/allocator.h"
+
+namespace tensorflow {
+
+// A bump-pointer allocator that serves the allocations of a single step from
+// one contiguous region obtained from an underlying allocator.
+//
+// Allocating from the arena is a single atomic compare-and-swap, so concurrent
+// kernels in the same step never contend on the underlying allocator's lock.
+// Deallocations only decrement a count of live allocations, and the bump
+// pointer returns to the start of the arena once none are live. Requests that
+// do not fit in the remaining space are forwarded to the underlying allocator.
+//
+// The arena is reference counted. The step holds one reference, which it
+// drops by calling `Release()` when the step completes, and every live
+// allocation (including forwarded ones) holds another. The region is returned
+// to the underlying allocator, and the arena deletes itself, when the last
+// reference is dropped. Tensors that outlive the step (e.g. fetched outputs,
+// or tensors stored in resources) are therefore safe; they merely keep the
+// region alive until they are deallocated.
+class StepArenaAllocator : public Allocator {
+ public:
+  // Creates an arena of `capacity` bytes backed by `underlying`, which must
+  // outlive the arena. If `capacity` is zero, every allocation is forwarded to
+  // `underlying`.
+  StepArenaAllocator(Allocator* underlying, size_t capacity);
+
+  StepArenaAllocator(const StepArenaAllocator&) = delete;
+  void operator=(const StepArenaAllocator&) = delete;
+
+  // The name of every StepArenaAllocator.
+  static constexpr char kName[] = "step_arena";
+
+  std::string Name() override { return kName; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  AllocatorMemoryType GetMemoryType() const override {
+    return underlying_->GetMemoryType();
+  }
+
+  // Drops the step's reference to this arena. The arena must not be used for
+  // new allocations after this call; it may delete itself before returning.
+  void Release();
+
+  size_t capacity() const { return capacity_; }
+
+  // Returns the total number of bytes requested from this arena so far,
+  // including forwarded requests and alignment padding. This is the capacity
+  // that would have been required to serve every request from the arena.
+  size_t bytes_requested() const {
+    return bytes_requested_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the largest offset that the bump pointer reached, counting
+  // forwarded requests as if they had been served by the arena. This is the
+  // capacity that would have been required to serve every request from the
+  // arena, given that the bump pointer is reset whenever no allocation is
+  // live, and is bounded by the peak number of bytes live at once.
+  size_t peak_bytes() const {
+    return peak_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of bytes that were forwarded to the underlying
+  // allocator because they did not fit in the arena.
+  size_t bytes_forwarded() const {
+    return bytes_forwarded_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  ~StepArenaAllocator() override;
+
+  bool InArena(const void* ptr) const {
+    const char* p = static_cast<const char*>(ptr);
+    return base_ != nullptr && p >= base_ && p < base_ + capacity_;
+  }
+
+  void Unref();
+
+  // `state_` holds the offset of the first free byte of the arena in its low
+  // `kOffsetBits` bits, and the number of live allocations (including
+  // forwarded ones) in the remaining high bits.
+  static constexpr int kOffsetBits = 36;
+  static constexpr uint64_t kOffsetMask = (uint64_t{1} << kOffsetBits) - 1;
+  static constexpr uint64_t kOneAllocation = uint64_t{1} << kOffsetBits;
+
+  Allocator* const underlying_;  // Not owned.
+  const size_t capacity_;
+  char* const base_;
+
+  std::atomic<uint64_t> state_{0};
+  std::atomic<size_t> peak_bytes_{0};
+  std::atomic<size_t> bytes_requested_{0};
+  std::atomic<size_t> bytes_forwarded_{0};
+  // One reference for the step, plus one for each live allocation.
+  std::atomic<int64_t> refs_{1};
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
@@ -0,0 +1,147 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Counts the calls made to an underlying CPU allocator.
+class CountingAllocator : public Allocator {
+ public:
+  string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_allocations;
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    ++num_deallocations;
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+
+  int num_allocations = 0;
+  int num_deallocations = 0;
+};
+
+TEST(StepArenaAllocatorTest, ServesAllocationsFromArena) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying, 1024);
+  EXPECT_EQ(underlying.num_allocations, 1);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 4; ++i) {
+    void* ptr = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % Allocator::kAllocatorAlignment,
+              0);
+    ptrs.push_back(ptr);
+  }
+  // Each request is rounded up to 128 bytes, so all of them fit.
+  EXPECT_EQ(underlying.num_allocations, 1);
+  EXPECT_EQ(arena->bytes_requested(), 512);
+  EXPECT_EQ(arena->bytes_forwarded(), 0);
+
+  for (void* ptr : ptrs) arena->DeallocateRaw(ptr);
+  EXPECT_EQ(underlying.num_deallocations, 0);
+  arena->Release();
+  EXPECT_EQ(underlying.num_deallocations, 1);
+}
+
+TEST(StepArenaAllocatorTest, ForwardsWhenFull) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying, 256);
+  void* a = arena->AllocateRaw(Allocator::kAllocatorAlignment, 200);
+  void* b = arena->AllocateRaw(Allocator::kAllocatorAlignment, 200);
+  EXPECT_EQ(underlying.num_allocations, 2);
+  EXPECT_EQ(arena->bytes_requested(), 512);
+  EXPECT_EQ(arena->bytes_forwarded(), 256);
+  arena->DeallocateRaw(b);
+  EXPECT_EQ(underlying.num_deallocations, 1);
+  arena->DeallocateRaw(a);
+  arena->Release();
+  EXPECT_EQ(underlying.num_deallocations, 2);
+}
+
+TEST(StepArenaAllocatorTest, ReusesArenaOnceEmpty) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying, 256);
+  for (int i = 0; i < 8; ++i) {
+    void* a = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+    void* b = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+    arena->DeallocateRaw(a);
+    arena->DeallocateRaw(b);
+  }
+  // All requests fit, because the arena is empty after each iteration.
+  EXPECT_EQ(underlying.num_allocations, 1);
+  EXPECT_EQ(arena->bytes_forwarded(), 0);
+  EXPECT_EQ(arena->bytes_requested(), 2048);
+  EXPECT_EQ(arena->peak_bytes(), 256);
+  arena->Release();
+}
+
+TEST(StepArenaAllocatorTest, PeakBytesCountsForwardedRequests) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying, 0);
+  void* a = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  void* b = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  arena->DeallocateRaw(a);
+  void* c = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  EXPECT_EQ(arena->peak_bytes(), 384);
+  arena->DeallocateRaw(b);
+  arena->DeallocateRaw(c);
+  void* d = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  EXPECT_EQ(arena->peak_bytes(), 384);
+  arena->DeallocateRaw(d);
+  arena->Release();
+}
+
+TEST(StepArenaAllocatorTest, ZeroCapacityForwardsEverything) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying, 0);
+  EXPECT_EQ(underlying.num_allocations, 0);
+  void* ptr = arena->AllocateRaw(Allocator::kAllocatorAlignment, 16);
+  EXPECT_EQ(underlying.num_allocations, 1);
+  EXPECT_EQ(arena->bytes_requested(), Allocator::kAllocatorAlignment);
+  arena->DeallocateRaw(ptr);
+  EXPECT_EQ(underlying.num_deallocations, 1);
+  arena->Release();
+}
+
+TEST(StepArenaAllocatorTest, TensorsOutliveStep) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying, 4096);
+  Tensor escaped;
+  {
+    Tensor t(arena, DT_FLOAT, TensorShape({16}));
+    t.flat<float>().setConstant(42.0f);
+    escaped = t;
+  }
+  // The step ends while `escaped` is still live, so the arena must remain.
+  arena->Release();
+  EXPECT_EQ(underlying.num_deallocations, 0);
+  EXPECT_EQ(escaped.flat<float>()(15), 42.0f);
+  escaped = Tensor();
+  EXPECT_EQ(underlying.num_deallocations, 1);
+}
+
+}  // namespace
+}  // namespace tensorflow
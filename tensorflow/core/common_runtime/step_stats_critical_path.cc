@@ -0,0 +1,183 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_stats_critical_path.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace {
+
+struct ExecutedNode {
+  const NodeDef* node_def = nullptr;
+  std::string device;
+  int64_t start_micros = 0;
+  int64_t end_micros = 0;
+};
+
+bool IsSend(const NodeDef& node) {
+  return node.op() == "_Send" || node.op() == "_HostSend";
+}
+
+bool IsRecv(const NodeDef& node) {
+  return node.op() == "_Recv" || node.op() == "_HostRecv";
+}
+
+// Returns the name of the node producing the input `input` of a NodeDef.
+absl::string_view InputNodeName(absl::string_view input) {
+  if (absl::ConsumePrefix(&input, "^")) return input;
+  return input.substr(0, input.find(':'));
+}
+
+}  // namespace
+
+std::string CriticalPath::RankedSummary(int max_nodes) const {
+  std::vector<const CriticalPathNode*> ranked;
+  ranked.reserve(nodes.size());
+  for (const CriticalPathNode& node : nodes) ranked.push_back(&node);
+  auto cost = [](const CriticalPathNode* node) {
+    return node->self_micros + node->wait_micros;
+  };
+  std::stable_sort(ranked.begin(), ranked.end(),
+                   [&](const CriticalPathNode* a, const CriticalPathNode* b) {
+                     return cost(a) > cost(b);
+                   });
+  if (ranked.size() > static_cast<size_t>(std::max(max_nodes, 0))) {
+    ranked.resize(std::max(max_nodes, 0));
+  }
+
+  std::string summary = absl::StrCat(
+      "Critical path of ", nodes.size(), " nodes: compute ", compute_micros,
+      "us, transfer ", transfer_micros, "us, wait ", wait_micros, "us\n");
+  for (const CriticalPathNode* node : ranked) {
+    absl::StrAppend(&summary, node->node_name, " (", node->op, ") on ",
+                    node->device, ": ",
+                    node->is_transfer ? "transfer " : "compute ",
+                    node->self_micros, "us, wait ",
+                    node->wait_micros, "us\n");
+  }
+  return summary;
+}
+
+Status ComputeCriticalPath(const GraphDef& graph, const StepStats& step_stats,
+                           CriticalPath* path) {
+  *path = CriticalPath();
+
+  absl::flat_hash_map<absl::string_view, const NodeDef*> node_defs;
+  absl::flat_hash_map<std::string, const NodeDef*> sends;
+  for (const NodeDef& node : graph.node()) {
+    node_defs[node.name()] = &node;
+    std::string tensor_name;
+    if (IsSend(node) && TryGetNodeAttr(node, "tensor_name", &tensor_name)) {
+      sends[tensor_name] = &node;
+    }
+  }
+
+  // Nodes that run more than once, e.g. in loops, are represented by their
+  // last execution.
+  absl::flat_hash_map<absl::string_view, ExecutedNode> executed;
+  const ExecutedNode* last = nullptr;
+  for (const DeviceStepStats& device_stats : step_stats.dev_stats()) {
+    for (const NodeExecStats& stats : device_stats.node_stats()) {
+      auto node_def = node_defs.find(stats.node_name());
+      if (node_def == node_defs.end()) continue;
+      const int64_t end_micros =
+          stats.all_start_micros() + stats.all_end_rel_micros();
+      ExecutedNode& node = executed[node_def->first];
+      if (node.node_def != nullptr && node.end_micros >= end_micros) continue;
+      node.node_def = node_def->second;
+      node.device = device_stats.device();
+      node.start_micros = stats.all_start_micros();
+      node.end_micros = end_micros;
+    }
+  }
+  for (const auto& [name, node] : executed) {
+    if (last == nullptr || node.end_micros > last->end_micros) last = &node;
+  }
+  if (last == nullptr) {
+    return errors::InvalidArgument(
+        "No node in the step stats is in the graph.");
+  }
+
+  // Walks back from the last node to finish, following the input of each node
+  // that became available last.
+  std::vector<const ExecutedNode*> reversed_path;
+  absl::flat_hash_set<const ExecutedNode*> visited;
+  for (const ExecutedNode* current = last; current != nullptr;) {
+    reversed_path.push_back(current);
+    visited.insert(current);
+    std::vector<absl::string_view> inputs;
+    for (const std::string& input : current->node_def->input()) {
+      inputs.push_back(InputNodeName(input));
+    }
+    std::string tensor_name;
+    if (IsRecv(*current->node_def) &&
+        TryGetNodeAttr(*current->node_def, "tensor_name", &tensor_name)) {
+      auto send = sends.find(tensor_name);
+      if (send != sends.end()) inputs.push_back(send->second->name());
+    }
+    const ExecutedNode* previous = nullptr;
+    for (absl::string_view input : inputs) {
+      auto it = executed.find(input);
+      if (it == executed.end() || visited.contains(&it->second)) continue;
+      if (previous == nullptr || it->second.end_micros > previous->end_micros) {
+        previous = &it->second;
+      }
+    }
+    current = previous;
+  }
+
+  // Nodes on the path may overlap, e.g. a _Recv starts before its _Send and
+  // waits for it. Each node counts from where the previous one ended, so that
+  // no time is counted twice.
+  int64_t previous_end_micros = reversed_path.back()->start_micros;
+  for (auto it = reversed_path.rbegin(); it != reversed_path.rend(); ++it) {
+    const ExecutedNode& executed_node = **it;
+    CriticalPathNode& node = path->nodes.emplace_back();
+    node.node_name = executed_node.node_def->name();
+    node.op = executed_node.node_def->op();
+    node.device = executed_node.device;
+    node.start_micros = executed_node.start_micros;
+    node.end_micros = executed_node.end_micros;
+    node.is_transfer =
+        IsSend(*executed_node.node_def) || IsRecv(*executed_node.node_def);
+
+    const int64_t counted_end_micros =
+        std::max(node.end_micros, previous_end_micros);
+    const int64_t counted_start_micros = std::clamp(
+        node.start_micros, previous_end_micros, counted_end_micros);
+    node.wait_micros = counted_start_micros - previous_end_micros;
+    node.self_micros = counted_end_micros - counted_start_micros;
+    previous_end_micros = counted_end_micros;
+
+    (node.is_transfer ? path->transfer_micros : path->compute_micros) +=
+        node.self_micros;
+    path->wait_micros += node.wait_micros;
+  }
+  return OkStatus();
+}
+
+}  // namespace tensorflow
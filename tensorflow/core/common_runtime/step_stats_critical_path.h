@@ -0,0 +1,73 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_CRITICAL_PATH_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_CRITICAL_PATH_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/platform/status.h"
+
+namespace tensorflow {
+
+// A node executed on the critical path of a step.
+struct CriticalPathNode {
+  std::string node_name;
+  std::string op;
+  std::string device;
+  int64_t start_micros = 0;
+  int64_t end_micros = 0;
+  // Time between the end of the previous node on the path and the start of
+  // this node, i.e. scheduling delay after its last input became available.
+  int64_t wait_micros = 0;
+  // Time of the node that does not overlap the previous nodes on the path, so
+  // the time a _Recv spends before its _Send ends is not counted.
+  int64_t self_micros = 0;
+  // True for the _Send and _Recv nodes that transfer tensors between devices.
+  bool is_transfer = false;
+};
+
+// The chain of nodes that determined the duration of a step, and how the step
+// time divides between them.
+struct CriticalPath {
+  // The nodes in execution order. Their compute, transfer and wait times add
+  // up to the time between the start of the first one and the end of the last.
+  std::vector<CriticalPathNode> nodes;
+  int64_t compute_micros = 0;
+  int64_t transfer_micros = 0;
+  int64_t wait_micros = 0;
+
+  // Returns the `max_nodes` nodes that contributed the most time, including
+  // the time they waited, one per line and most expensive first.
+  std::string RankedSummary(int max_nodes) const;
+};
+
+// Reconstructs the critical path of a step from the `step_stats` recorded
+// while running `graph`.
+//
+// The path ends at the node that finished last. Each node is preceded by the
+// data or control input that finished last, and each _Recv by the _Send of
+// the same tensor, so the path follows transfers across devices. `graph` must
+// contain every executed node, e.g. the nodes of all partition graphs of a
+// step. Nodes without stats are not on the path.
+Status ComputeCriticalPath(const GraphDef& graph, const StepStats& step_stats,
+                           CriticalPath* path);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_CRITICAL_PATH_H_
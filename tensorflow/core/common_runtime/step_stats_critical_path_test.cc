@@ -0,0 +1,135 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_stats_critical_path.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+NodeDef* AddNode(const std::string& name, const std::string& op,
+                 std::initializer_list<std::string> inputs, GraphDef* graph) {
+  NodeDef* node = graph->add_node();
+  node->set_name(name);
+  node->set_op(op);
+  for (const std::string& input : inputs) node->add_input(input);
+  return node;
+}
+
+void AddStats(const std::string& name, int64_t start_micros,
+              int64_t end_micros, DeviceStepStats* device_stats) {
+  NodeExecStats* stats = device_stats->add_node_stats();
+  stats->set_node_name(name);
+  stats->set_all_start_micros(start_micros);
+  stats->set_all_end_rel_micros(end_micros - start_micros);
+}
+
+TEST(StepStatsCriticalPathTest, FollowsLastInput) {
+  GraphDef graph;
+  AddNode("a", "Const", {}, &graph);
+  AddNode("b", "Const", {}, &graph);
+  AddNode("c", "Add", {"a", "b:0"}, &graph);
+  AddNode("d", "NoOp", {"^c"}, &graph);
+  StepStats step_stats;
+  DeviceStepStats* cpu = step_stats.add_dev_stats();
+  cpu->set_device("/device:CPU:0");
+  AddStats("a", 0, 10, cpu);
+  AddStats("b", 0, 30, cpu);
+  AddStats("c", 35, 50, cpu);
+  AddStats("d", 50, 51, cpu);
+
+  CriticalPath path;
+  TF_ASSERT_OK(ComputeCriticalPath(graph, step_stats, &path));
+  ASSERT_EQ(path.nodes.size(), 3);
+  EXPECT_EQ(path.nodes[0].node_name, "b");
+  EXPECT_EQ(path.nodes[1].node_name, "c");
+  EXPECT_EQ(path.nodes[1].wait_micros, 5);
+  EXPECT_EQ(path.nodes[2].node_name, "d");
+  EXPECT_EQ(path.compute_micros, 46);
+  EXPECT_EQ(path.transfer_micros, 0);
+  EXPECT_EQ(path.wait_micros, 5);
+  EXPECT_EQ(path.compute_micros + path.transfer_micros + path.wait_micros,
+            51);
+}
+
+TEST(StepStatsCriticalPathTest, FollowsTransfers) {
+  GraphDef graph;
+  AddNode("a", "Const", {}, &graph);
+  AddNodeAttr("tensor_name", "edge_1_a",
+              AddNode("send", "_Send", {"a"}, &graph));
+  AddNodeAttr("tensor_name", "edge_1_a",
+              AddNode("recv", "_Recv", {}, &graph));
+  AddNode("b", "Const", {}, &graph);
+  AddNode("c", "Add", {"recv", "b"}, &graph);
+  StepStats step_stats;
+  DeviceStepStats* cpu = step_stats.add_dev_stats();
+  cpu->set_device("/device:CPU:0");
+  AddStats("a", 0, 20, cpu);
+  AddStats("send", 20, 21, cpu);
+  DeviceStepStats* gpu = step_stats.add_dev_stats();
+  gpu->set_device("/device:GPU:0");
+  AddStats("recv", 0, 40, gpu);
+  AddStats("b", 0, 5, gpu);
+  AddStats("c", 42, 50, gpu);
+
+  CriticalPath path;
+  TF_ASSERT_OK(ComputeCriticalPath(graph, step_stats, &path));
+  ASSERT_EQ(path.nodes.size(), 4);
+  EXPECT_EQ(path.nodes[0].node_name, "a");
+  EXPECT_EQ(path.nodes[1].node_name, "send");
+  EXPECT_EQ(path.nodes[2].node_name, "recv");
+  EXPECT_TRUE(path.nodes[2].is_transfer);
+  EXPECT_EQ(path.nodes[2].device, "/device:GPU:0");
+  EXPECT_EQ(path.nodes[3].node_name, "c");
+  EXPECT_EQ(path.nodes[3].wait_micros, 2);
+  // The recv started with a, and only its time after the send counts.
+  EXPECT_EQ(path.nodes[2].wait_micros, 0);
+  EXPECT_EQ(path.nodes[2].self_micros, 19);
+  EXPECT_EQ(path.compute_micros, 28);
+  EXPECT_EQ(path.transfer_micros, 20);
+  EXPECT_EQ(path.wait_micros, 2);
+  EXPECT_EQ(path.compute_micros + path.transfer_micros + path.wait_micros,
+            50);
+
+  const std::string summary = path.RankedSummary(/*max_nodes=*/2);
+  EXPECT_NE(summary.find("a (Const) on /device:CPU:0: compute 20us"),
+            std::string::npos)
+      << summary;
+  EXPECT_NE(summary.find("recv (_Recv) on /device:GPU:0: transfer 19us"),
+            std::string::npos)
+      << summary;
+  EXPECT_EQ(summary.find("send"), std::string::npos) << summary;
+}
+
+TEST(StepStatsCriticalPathTest, FailsWithoutExecutedNodes) {
+  GraphDef graph;
+  AddNode("a", "Const", {}, &graph);
+  CriticalPath path;
+  EXPECT_TRUE(errors::IsInvalidArgument(
+      ComputeCriticalPath(graph, StepStats(), &path)));
+}
+
+}  // namespace
+}  // namespace tensorflow
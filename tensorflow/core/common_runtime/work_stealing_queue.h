@@ -0,0 +1,217 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_QUEUE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_QUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// A set of per-worker double-ended queues used to dispatch ready work items.
+//
+// Each worker owns one queue. A worker pushes newly ready items onto the back
+// of its own queue and pops from the back (LIFO), so that a consumer tends to
+// run on the thread that just produced its inputs while they are still hot in
+// cache. When a worker's own queue is empty it steals from the front (FIFO) of
+// other workers' queues, first from workers on the same NUMA node and only
+// then from workers on other nodes.
+//
+// Workers are partitioned evenly across NUMA nodes: worker `w` belongs to
+// node `w / workers_per_node()`. The mapping from threads to workers is given
+// by `CurrentWorker()`.
+//
+// This class is thread-safe.
+template <typename T>
+class WorkStealingQueueSet {
+ public:
+  // Creates a queue set with (at least) `num_workers` queues, rounded up to a
+  // multiple of `num_numa_nodes`.
+  WorkStealingQueueSet(int num_workers, int num_numa_nodes)
+      : num_numa_nodes_(std::max(1, num_numa_nodes)),
+        workers_per_node_(
+            std::max(1, (num_workers + num_numa_nodes_ - 1) / num_numa_nodes_)),
+        num_workers_(workers_per_node_ * num_numa_nodes_),
+        queues_(new Queue[num_workers_]) {}
+
+  WorkStealingQueueSet(const WorkStealingQueueSet&) = delete;
+  void operator=(const WorkStealingQueueSet&) = delete;
+
+  int num_workers() const { return num_workers_; }
+  int num_numa_nodes() const { return num_numa_nodes_; }
+  int workers_per_node() const { return workers_per_node_; }
+
+  // Returns the NUMA node that `worker` belongs to.
+  int NumaNode(int worker) const { return worker / workers_per_node_; }
+
+  // Returns the worker associated with the calling thread. Threads that have
+  // a NUMA affinity are mapped onto a worker of that node; other threads are
+  // spread over all nodes.
+  int CurrentWorker() const {
+    const ThreadInfo& info = CurrentThreadInfo();
+    int node = info.numa_node;
+    if (node == port::kNUMANoAffinity || node >= num_numa_nodes_) {
+      node = info.index % num_numa_nodes_;
+    }
+    return node * workers_per_node_ + (info.index % workers_per_node_);
+  }
+
+  // Pushes `value` onto the back of `worker`'s queue.
+  void Push(int worker, T value) {
+    DCHECK_GE(worker, 0);
+    DCHECK_LT(worker, num_workers_);
+    Queue& q = queues_[worker];
+    mutex_lock l(q.mu);
+    q.items.push_back(std::move(value));
+    q.size.store(q.items.size() - q.head, std::memory_order_release);
+  }
+
+  // Pops the most recently pushed item from `worker`'s own queue. If that
+  // queue is empty, steals the least recently pushed item from another queue,
+  // preferring queues on the same NUMA node as `worker`. Returns
+  // `absl::nullopt` if every queue was observed to be empty.
+  absl::optional<T> PopOrSteal(int worker) {
+    DCHECK_GE(worker, 0);
+    DCHECK_LT(worker, num_workers_);
+    absl::optional<T> value = PopBack(&queues_[worker]);
+    if (value.has_value()) return value;
+
+    // Steal from the other workers on the same node, starting with the next
+    // worker so that thieves do not all converge on the same victim.
+    const int node = NumaNode(worker);
+    const int node_begin = node * workers_per_node_;
+    for (int i = 1; i < workers_per_node_; ++i) {
+      const int victim =
+          node_begin + (worker - node_begin + i) % workers_per_node_;
+      value = PopFront(&queues_[victim]);
+      if (value.has_value()) return value;
+    }
+
+    // Steal from the remaining nodes, nearest node index first.
+    for (int n = 1; n < num_numa_nodes_; ++n) {
+      const int victim_begin =
+          ((node + n) % num_numa_nodes_) * workers_per_node_;
+      for (int i = 0; i < workers_per_node_; ++i) {
+        value = PopFront(&queues_[victim_begin +
+                                  (worker - node_begin + i) % workers_per_node_]);
+        if (value.has_value()) return value;
+      }
+    }
+    return absl::nullopt;
+  }
+
+  // Like `PopOrSteal()`, but retries until an item is found. A scan can miss
+  // an item while concurrent pops and steals move through the queues, so the
+  // caller must know that an unclaimed item exists. Retries sleep for
+  // exponentially longer, up to 1ms, instead of spinning.
+  T PopOrStealWithBackoff(int worker) {
+    absl::optional<T> value = PopOrSteal(worker);
+    int64_t backoff_usec = 1;
+    while (!value.has_value()) {
+      Env::Default()->SleepForMicroseconds(backoff_usec);
+      backoff_usec = std::min<int64_t>(2 * backoff_usec, kMaxBackoffUsec);
+      value = PopOrSteal(worker);
+    }
+    return *std::move(value);
+  }
+
+  // Returns the approximate number of items in all queues.
+  size_t ApproximateSize() const {
+    size_t total = 0;
+    for (int i = 0; i < num_workers_; ++i) {
+      total += queues_[i].size.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+ private:
+  // A single worker's queue. Items in `[head, items.size())` are live. Items
+  // are popped from the back by the owner and from the front (by advancing
+  // `head`) by thieves. The backing vector is reset whenever it drains, so it
+  // only allocates once it is first used.
+  struct alignas(64) Queue {
+    mutex mu;
+    std::vector<T> items TF_GUARDED_BY(mu);
+    size_t head TF_GUARDED_BY(mu) = 0;
+    // Number of live items, readable without `mu` so that empty queues can be
+    // skipped without contending on their lock.
+    std::atomic<size_t> size{0};
+  };
+
+  static constexpr int64_t kMaxBackoffUsec = 1000;
+
+  struct ThreadInfo {
+    int index;
+    int numa_node;
+  };
+
+  // Returns a stable per-thread index and the thread's NUMA affinity at the
+  // time of its first call.
+  static const ThreadInfo& CurrentThreadInfo() {
+    static std::atomic<int> next_index{0};
+    thread_local const ThreadInfo info{
+        next_index.fetch_add(1, std::memory_order_relaxed),
+        port::NUMAGetThreadNodeAffinity()};
+    return info;
+  }
+
+  static absl::optional<T> PopBack(Queue* q) {
+    if (q->size.load(std::memory_order_acquire) == 0) return absl::nullopt;
+    mutex_lock l(q->mu);
+    if (q->items.size() == q->head) return absl::nullopt;
+    absl::optional<T> value(std::move(q->items.back()));
+    q->items.pop_back();
+    MaybeResetLocked(q);
+    return value;
+  }
+
+  static absl::optional<T> PopFront(Queue* q) {
+    if (q->size.load(std::memory_order_acquire) == 0) return absl::nullopt;
+    mutex_lock l(q->mu);
+    if (q->items.size() == q->head) return absl::nullopt;
+    absl::optional<T> value(std::move(q->items[q->head]));
+    ++q->head;
+    MaybeResetLocked(q);
+    return value;
+  }
+
+  static void MaybeResetLocked(Queue* q) TF_EXCLUSIVE_LOCKS_REQUIRED(q->mu) {
+    if (q->items.size() == q->head) {
+      q->items.clear();
+      q->head = 0;
+    }
+    q->size.store(q->items.size() - q->head, std::memory_order_release);
+  }
+
+  const int num_numa_nodes_;
+  const int workers_per_node_;
+  const int num_workers_;
+  std::unique_ptr<Queue[]> queues_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_WORK_STEALING_QUEUE_H_
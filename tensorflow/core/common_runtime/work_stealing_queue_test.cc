@@ -0,0 +1,136 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/work_stealing_queue.h"
+
+#include <atomic>
+#include <vector>
+
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(WorkStealingQueueSet, RoundsUpToNumaNodes) {
+  WorkStealingQueueSet<int> queues(/*num_workers=*/5, /*num_numa_nodes=*/2);
+  EXPECT_EQ(queues.num_workers(), 6);
+  EXPECT_EQ(queues.workers_per_node(), 3);
+  EXPECT_EQ(queues.NumaNode(0), 0);
+  EXPECT_EQ(queues.NumaNode(2), 0);
+  EXPECT_EQ(queues.NumaNode(3), 1);
+  EXPECT_EQ(queues.NumaNode(5), 1);
+}
+
+TEST(WorkStealingQueueSet, LocalPopIsLifo) {
+  WorkStealingQueueSet<int> queues(/*num_workers=*/2, /*num_numa_nodes=*/1);
+  queues.Push(0, 1);
+  queues.Push(0, 2);
+  queues.Push(0, 3);
+  EXPECT_EQ(queues.ApproximateSize(), 3);
+  EXPECT_EQ(*queues.PopOrSteal(0), 3);
+  EXPECT_EQ(*queues.PopOrSteal(0), 2);
+  EXPECT_EQ(*queues.PopOrSteal(0), 1);
+  EXPECT_FALSE(queues.PopOrSteal(0).has_value());
+  EXPECT_EQ(queues.ApproximateSize(), 0);
+}
+
+TEST(WorkStealingQueueSet, StealIsFifo) {
+  WorkStealingQueueSet<int> queues(/*num_workers=*/2, /*num_numa_nodes=*/1);
+  queues.Push(0, 1);
+  queues.Push(0, 2);
+  queues.Push(0, 3);
+  EXPECT_EQ(*queues.PopOrSteal(1), 1);
+  EXPECT_EQ(*queues.PopOrSteal(1), 2);
+  EXPECT_EQ(*queues.PopOrSteal(0), 3);
+  EXPECT_FALSE(queues.PopOrSteal(1).has_value());
+}
+
+TEST(WorkStealingQueueSet, StealPrefersSameNumaNode) {
+  WorkStealingQueueSet<int> queues(/*num_workers=*/4, /*num_numa_nodes=*/2);
+  // Workers 0 and 1 are on node 0; workers 2 and 3 are on node 1.
+  queues.Push(2, 20);
+  queues.Push(1, 10);
+  queues.Push(3, 30);
+  EXPECT_EQ(*queues.PopOrSteal(0), 10);
+  EXPECT_EQ(*queues.PopOrSteal(0), 20);
+  EXPECT_EQ(*queues.PopOrSteal(0), 30);
+  EXPECT_FALSE(queues.PopOrSteal(0).has_value());
+}
+
+TEST(WorkStealingQueueSet, CurrentWorkerIsStable) {
+  WorkStealingQueueSet<int> queues(/*num_workers=*/8, /*num_numa_nodes=*/2);
+  const int worker = queues.CurrentWorker();
+  EXPECT_GE(worker, 0);
+  EXPECT_LT(worker, queues.num_workers());
+  EXPECT_EQ(worker, queues.CurrentWorker());
+}
+
+TEST(WorkStealingQueueSet, PopOrStealWithBackoffWaitsForItem) {
+  WorkStealingQueueSet<int> queues(/*num_workers=*/2, /*num_numa_nodes=*/1);
+  std::atomic<int> popped{-1};
+  {
+    thread::ThreadPool pool(Env::Default(), "test", 1);
+    pool.Schedule([&]() { popped = queues.PopOrStealWithBackoff(0); });
+    Env::Default()->SleepForMicroseconds(10000);
+    EXPECT_EQ(popped.load(), -1);
+    queues.Push(1, 7);
+  }
+  EXPECT_EQ(popped.load(), 7);
+  EXPECT_EQ(queues.ApproximateSize(), 0u);
+}
+
+TEST(WorkStealingQueueSet, ConcurrentPushAndPop) {
+  constexpr int kNumThreads = 8;
+  constexpr int kItemsPerThread = 10000;
+  WorkStealingQueueSet<int> queues(kNumThreads, /*num_numa_nodes=*/2);
+  std::vector<std::atomic<int>> seen(kNumThreads * kItemsPerThread);
+  std::atomic<int> num_popped{0};
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    BlockingCounter counter(kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t) {
+      pool.Schedule([&, t]() {
+        const int worker = queues.CurrentWorker();
+        for (int i = 0; i < kItemsPerThread; ++i) {
+          queues.Push(worker, t * kItemsPerThread + i);
+          if (i % 2 == 0) {
+            absl::optional<int> value = queues.PopOrSteal(worker);
+            if (value.has_value()) {
+              seen[*value].fetch_add(1);
+              num_popped.fetch_add(1);
+            }
+          }
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  for (absl::optional<int> value = queues.PopOrSteal(0); value.has_value();
+       value = queues.PopOrSteal(0)) {
+    seen[*value].fetch_add(1);
+    num_popped.fetch_add(1);
+  }
+  EXPECT_EQ(num_popped.load(), kNumThreads * kItemsPerThread);
+  for (const auto& count : seen) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <cstring>
 #include <limits>
 #include <string>
 #include <vector>
@@ -35,6 +36,18 @@ namespace {
 // `UncompressElement` function will determine what to read according to the
 // version.
 constexpr int kCompressedElementVersion = 0;
+// The version of elements whose `data` holds the uncompressed bytes.
+constexpr int kUncompressedElementVersion = 1;
+
+// `AdaptiveElementCompressor` stops compressing once the compressed size of
+// its elements averages more than this fraction of their uncompressed size.
+constexpr double kMaxCompressedFraction = 0.9;
+// The weight of the last compressed element in the average compressed
+// fraction.
+constexpr double kCompressedFractionWeight = 0.1;
+// The number of elements that `AdaptiveElementCompressor` stores uncompressed
+// before it compresses one again to measure the compressed fraction.
+constexpr int64_t kUncompressedElementsPerProbe = 100;
 
 }  // namespace
 
@@ -61,8 +74,10 @@ class Iov {
   size_t num_bytes_;
 };
 
-Status CompressElement(const std::vector<Tensor>& element,
-                       CompressedElement* out) {
+namespace {
+
+Status CompressElementInternal(const std::vector<Tensor>& element,
+                               bool compress, CompressedElement* out) {
   // First pass: preprocess the non`memcpy`able tensors.
   size_t num_string_tensors = 0;
   size_t num_string_tensor_strings = 0;
@@ -125,6 +140,17 @@ Status CompressElement(const std::vector<Tensor>& element,
                               iov.NumBytes(),
                               ", exceeding the 4GB Snappy limit.");
   }
+  if (!compress) {
+    std::string* data = out->mutable_data();
+    data->reserve(iov.NumBytes());
+    for (size_t i = 0; i < iov.NumPieces(); ++i) {
+      if (iov.Data()[i].iov_len == 0) continue;
+      data->append(static_cast<const char*>(iov.Data()[i].iov_base),
+                   iov.Data()[i].iov_len);
+    }
+    out->set_version(kUncompressedElementVersion);
+    return absl::OkStatus();
+  }
   if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
                                       out->mutable_data())) {
     return errors::Internal("Failed to compress using snappy.");
@@ -135,9 +161,85 @@ Status CompressElement(const std::vector<Tensor>& element,
   return absl::OkStatus();
 }
 
+// Copies the uncompressed bytes in `data` into `iov`.
+Status CopyToIOVec(const std::string& data, Iov& iov) {
+  if (data.size() != iov.NumBytes()) {
+    return errors::Internal("Uncompressed size mismatch. The element has ",
+                            data.size(),
+                            " bytes whereas the tensor metadata suggests ",
+                            iov.NumBytes());
+  }
+  const char* pos = data.data();
+  for (size_t i = 0; i < iov.NumPieces(); ++i) {
+    if (iov.Data()[i].iov_len == 0) continue;
+    memcpy(iov.Data()[i].iov_base, pos, iov.Data()[i].iov_len);
+    pos += iov.Data()[i].iov_len;
+  }
+  return absl::OkStatus();
+}
+
+// Uncompresses the snappy-compressed bytes in `compressed_data` into `iov`.
+Status SnappyUncompressToIOVec(const std::string& compressed_data, Iov& iov) {
+  size_t uncompressed_size;
+  if (!port::Snappy_GetUncompressedLength(
+          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
+    return errors::Internal(
+        "Could not get snappy uncompressed length. Compressed data size: ",
+        compressed_data.size());
+  }
+  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
+    return errors::Internal(
+        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", iov.NumBytes());
+  }
+  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
+                                      compressed_data.size(), iov.Data(),
+                                      iov.NumPieces())) {
+    return errors::Internal("Failed to perform snappy decompression.");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+Status CompressElement(const std::vector<Tensor>& element,
+                       CompressedElement* out) {
+  return CompressElementInternal(element, /*compress=*/true, out);
+}
+
+Status AdaptiveElementCompressor::Compress(const std::vector<Tensor>& element,
+                                           CompressedElement* out) {
+  bool compress;
+  {
+    mutex_lock l(mu_);
+    compress = compressed_fraction_ <= kMaxCompressedFraction ||
+               ++num_uncompressed_ >= kUncompressedElementsPerProbe;
+    if (compress) num_uncompressed_ = 0;
+  }
+  TF_RETURN_IF_ERROR(CompressElementInternal(element, compress, out));
+  if (!compress) return absl::OkStatus();
+  size_t uncompressed_size = 0;
+  for (const auto& metadata : out->component_metadata()) {
+    for (int64_t bytes : metadata.uncompressed_bytes()) {
+      uncompressed_size += bytes;
+    }
+  }
+  if (uncompressed_size == 0) return absl::OkStatus();
+  const double fraction =
+      static_cast<double>(out->data().size()) / uncompressed_size;
+  mutex_lock l(mu_);
+  compressed_fraction_ = compressed_fraction_ < 0
+                             ? fraction
+                             : (1 - kCompressedFractionWeight) *
+                                       compressed_fraction_ +
+                                   kCompressedFractionWeight * fraction;
+  return absl::OkStatus();
+}
+
 Status UncompressElement(const CompressedElement& compressed,
                          std::vector<Tensor>* out) {
-  if (compressed.version() != kCompressedElementVersion) {
+  if (compressed.version() != kCompressedElementVersion &&
+      compressed.version() != kUncompressedElementVersion) {
     return errors::Internal("Unsupported compressed element version: ",
                             compressed.version());
   }
@@ -191,22 +293,10 @@ Status UncompressElement(const CompressedElement& compressed,
 
   // Step 2: Uncompress into the iovec.
   const std::string& compressed_data = compressed.data();
-  size_t uncompressed_size;
-  if (!port::Snappy_GetUncompressedLength(
-          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
-    return errors::Internal(
-        "Could not get snappy uncompressed length. Compressed data size: ",
-        compressed_data.size());
-  }
-  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
-    return errors::Internal(
-        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
-        " whereas the tensor metadata suggests ", iov.NumBytes());
-  }
-  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
-                                      compressed_data.size(), iov.Data(),
-                                      iov.NumPieces())) {
-    return errors::Internal("Failed to perform snappy decompression.");
+  if (compressed.version() == kUncompressedElementVersion) {
+    TF_RETURN_IF_ERROR(CopyToIOVec(compressed_data, iov));
+  } else {
+    TF_RETURN_IF_ERROR(SnappyUncompressToIOVec(compressed_data, iov));
   }
 
   // Third pass: deserialize nonstring, non`memcpy`able tensors.
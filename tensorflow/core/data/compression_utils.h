@@ -19,7 +19,9 @@ limitations under the License.
 
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 namespace tensorflow {
 namespace data {
@@ -33,6 +35,26 @@ namespace data {
 Status CompressElement(const std::vector<Tensor>& element,
                        CompressedElement* out);
 
+// Compresses elements like `CompressElement` while they are compressible.
+//
+// Once the compressed size of recent elements averages more than 90% of their
+// uncompressed size, as for already-compressed payloads like JPEG bytes, the
+// elements are stored uncompressed, which costs a copy instead of compression.
+// One in every 100 such elements is still compressed to notice when the
+// elements become compressible again. This class is thread-safe.
+class AdaptiveElementCompressor {
+ public:
+  Status Compress(const std::vector<Tensor>& element, CompressedElement* out);
+
+ private:
+  mutex mu_;
+  // Moving average of the compressed size of the compressed elements as a
+  // fraction of their uncompressed size, or -1 before the first element.
+  double compressed_fraction_ TF_GUARDED_BY(mu_) = -1;
+  // Number of elements stored uncompressed since the last compressed one.
+  int64_t num_uncompressed_ TF_GUARDED_BY(mu_) = 0;
+};
+
 // Uncompresses a `CompressedElement` into a vector of tensor components.
 Status UncompressElement(const CompressedElement& compressed,
                          std::vector<Tensor>* out);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -98,15 +99,65 @@ TEST_P(ParameterizedCompressionUtilsTest, VersionMismatch) {
   CompressedElement compressed;
   TF_ASSERT_OK(CompressElement(element, &compressed));
 
-  compressed.set_version(1);
+  compressed.set_version(2);
   std::vector<Tensor> round_trip_element;
   EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
               StatusIs(error::INTERNAL));
 }
 
+TEST_P(ParameterizedCompressionUtilsTest, AdaptiveRoundTrip) {
+  std::vector<Tensor> element = GetParam();
+  AdaptiveElementCompressor compressor;
+  CompressedElement compressed;
+  TF_ASSERT_OK(compressor.Compress(element, &compressed));
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  TF_EXPECT_OK(
+      ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+}
+
 INSTANTIATE_TEST_SUITE_P(Instantiation, ParameterizedCompressionUtilsTest,
                          ::testing::ValuesIn(TestCases()));
 
+// Returns an element of `size` pseudo-random, incompressible bytes.
+std::vector<Tensor> IncompressibleElement(int size) {
+  std::string bytes(size, '\0');
+  uint32_t state = 1;
+  for (char& c : bytes) {
+    state = state * 1664525 + 1013904223;
+    c = static_cast<char>(state >> 24);
+  }
+  return {CreateTensor<tstring>(TensorShape{}, {bytes})};
+}
+
+TEST(AdaptiveElementCompressorTest, StoresIncompressibleElementsUncompressed) {
+  AdaptiveElementCompressor compressor;
+  std::vector<Tensor> element = IncompressibleElement(4096);
+  CompressedElement compressed;
+  TF_ASSERT_OK(compressor.Compress(element, &compressed));
+  EXPECT_EQ(compressed.version(), 0);
+  compressed.Clear();
+  TF_ASSERT_OK(compressor.Compress(element, &compressed));
+  EXPECT_EQ(compressed.version(), 1);
+  EXPECT_EQ(compressed.data().size(), 4096);
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  TF_EXPECT_OK(DatasetOpsTestBase::ExpectEqual(element, round_trip_element,
+                                               /*compare_order=*/true));
+}
+
+TEST(AdaptiveElementCompressorTest, CompressesCompressibleElements) {
+  AdaptiveElementCompressor compressor;
+  std::vector<Tensor> element = {
+      CreateTensor<tstring>(TensorShape{}, {std::string(4096, 'a')})};
+  for (int i = 0; i < 3; ++i) {
+    CompressedElement compressed;
+    TF_ASSERT_OK(compressor.Compress(element, &compressed));
+    EXPECT_EQ(compressed.version(), 0);
+    EXPECT_LT(compressed.data().size(), 4096);
+  }
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -285,8 +285,13 @@ struct CopyBatchParams {
   std::function<void(std::function<void()>)>* runner;
   int64 runner_threadpool_size;
 
+  // Batches of iterators are allocated in GPU-compatible (pinned) host memory
+  // when a GPU is present, so that copying them to the device needs no
+  // staging copy.
   explicit CopyBatchParams(IteratorContext* ctx) {
-    allocator = ctx->allocator({});
+    AllocatorAttributes attr;
+    attr.set_gpu_compatible(true);
+    allocator = ctx->allocator(attr);
     runner = ctx->runner();
     runner_threadpool_size = ctx->runner_threadpool_size();
   }
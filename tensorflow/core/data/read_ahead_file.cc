@@ -0,0 +1,122 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/read_ahead_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tensorflow/core/data/unbounded_thread_pool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace data {
+
+ReadAheadFile::ReadAheadFile(std::unique_ptr<RandomAccessFile> file,
+                             int64_t block_size, int num_blocks,
+                             thread::ThreadPoolInterface* thread_pool)
+    : file_(std::move(file)),
+      block_size_(block_size),
+      num_blocks_(num_blocks),
+      thread_pool_(thread_pool) {}
+
+ReadAheadFile::~ReadAheadFile() {
+  mutex_lock l(mu_);
+  while (num_in_flight_ > 0) cv_.wait(l);
+}
+
+/*static*/ thread::ThreadPoolInterface* ReadAheadFile::SharedThreadPool() {
+  static auto* thread_pool =
+      new UnboundedThreadPool(Env::Default(), "tf_data_read_ahead");
+  return thread_pool;
+}
+
+Status ReadAheadFile::Name(StringPiece* result) const {
+  return file_->Name(result);
+}
+
+void ReadAheadFile::ReadAheadLocked(int64_t first) const {
+  const int64_t last =
+      end_block_ < first + num_blocks_ ? end_block_ + 1 : first + num_blocks_;
+  blocks_.erase(blocks_.begin(), blocks_.lower_bound(first));
+  blocks_.erase(blocks_.lower_bound(std::max(first, last)), blocks_.end());
+  for (int64_t index = first; index < last; ++index) {
+    if (blocks_.count(index)) continue;
+    auto block = std::make_shared<Block>();
+    blocks_[index] = block;
+    ++num_in_flight_;
+    thread_pool_->Schedule([this, index, block]() {
+      std::string data(block_size_, '\0');
+      StringPiece result;
+      Status status =
+          file_->Read(index * block_size_, block_size_, &result, &data[0]);
+      if (result.data() != data.data()) {
+        data.assign(result.data(), result.size());
+      } else {
+        data.resize(result.size());
+      }
+      mutex_lock l(mu_);
+      if (static_cast<int64_t>(data.size()) < block_size_ &&
+          (status.ok() || errors::IsOutOfRange(status))) {
+        end_block_ = std::min(end_block_, index);
+      }
+      block->status = std::move(status);
+      block->data = std::move(data);
+      block->done = true;
+      --num_in_flight_;
+      cv_.notify_all();
+    });
+  }
+}
+
+Status ReadAheadFile::Read(uint64 offset, size_t n, StringPiece* result,
+                           char* scratch) const {
+  mutex_lock l(mu_);
+  size_t copied = 0;
+  while (copied < n) {
+    const uint64 position = offset + copied;
+    const int64_t index = position / block_size_;
+    ReadAheadLocked(index);
+    auto it = blocks_.find(index);
+    if (it == blocks_.end()) break;
+    std::shared_ptr<Block> block = it->second;
+    while (!block->done) cv_.wait(l);
+    if (!block->status.ok() && !errors::IsOutOfRange(block->status)) {
+      // Read the block again if the reader retries.
+      blocks_.erase(index);
+      *result = StringPiece(scratch, copied);
+      return block->status;
+    }
+    const size_t block_offset = position - index * block_size_;
+    if (block_offset < block->data.size()) {
+      const size_t length =
+          std::min(n - copied, block->data.size() - block_offset);
+      memcpy(scratch + copied, block->data.data() + block_offset, length);
+      copied += length;
+    }
+    if (static_cast<int64_t>(block->data.size()) < block_size_) break;
+  }
+  *result = StringPiece(scratch, copied);
+  if (copied < n) {
+    return errors::OutOfRange("Read fewer bytes than requested");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,85 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_READ_AHEAD_FILE_H_
+#define TENSORFLOW_CORE_DATA_READ_AHEAD_FILE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/lib/core/threadpool_interface.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/stringpiece.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// A `RandomAccessFile` for sequential readers that keeps up to `num_blocks`
+// reads of `block_size` bytes outstanding ahead of the last read.
+//
+// Readers of sequential formats like TFRecord read one buffer at a time and
+// block on each read. Reading ahead on `thread_pool` instead keeps the device
+// busy with several requests per file, so that fewer reader threads can
+// saturate high-latency or highly parallel storage. Blocks behind the last
+// read are dropped, so reading backwards re-reads them.
+class ReadAheadFile : public RandomAccessFile {
+ public:
+  ReadAheadFile(std::unique_ptr<RandomAccessFile> file, int64_t block_size,
+                int num_blocks, thread::ThreadPoolInterface* thread_pool);
+  // Waits for the outstanding reads.
+  ~ReadAheadFile() override;
+
+  // Returns a pool shared by the files that read ahead, that grows with the
+  // number of reads blocked on storage.
+  static thread::ThreadPoolInterface* SharedThreadPool();
+
+  Status Name(StringPiece* result) const override;
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override;
+
+ private:
+  struct Block {
+    bool done = false;
+    Status status;
+    std::string data;
+  };
+
+  // Schedules the reads of the blocks from `first` up to `num_blocks_` ahead,
+  // and drops the blocks before `first`.
+  void ReadAheadLocked(int64_t first) const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const std::unique_ptr<RandomAccessFile> file_;
+  const int64_t block_size_;
+  const int num_blocks_;
+  thread::ThreadPoolInterface* const thread_pool_;
+
+  mutable mutex mu_;
+  mutable condition_variable cv_;
+  // Block index -> block being read or read.
+  mutable std::map<int64_t, std::shared_ptr<Block>> blocks_ TF_GUARDED_BY(mu_);
+  // The index of the first block that was read short, past which nothing is
+  // read ahead.
+  mutable int64_t end_block_ TF_GUARDED_BY(mu_) = INT64_MAX;
+  mutable int num_in_flight_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_READ_AHEAD_FILE_H_
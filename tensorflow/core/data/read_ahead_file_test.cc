@@ -0,0 +1,88 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/read_ahead_file.h"
+
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+class ReadAheadFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 0; i < 1000; ++i) contents_.push_back('a' + i % 26);
+    filename_ = io::JoinPath(testing::TmpDir(), "read_ahead_file");
+    TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename_, contents_));
+  }
+
+  std::unique_ptr<ReadAheadFile> Open(int64_t block_size, int num_blocks) {
+    std::unique_ptr<RandomAccessFile> file;
+    TF_CHECK_OK(Env::Default()->NewRandomAccessFile(filename_, &file));
+    return std::make_unique<ReadAheadFile>(std::move(file), block_size,
+                                           num_blocks,
+                                           ReadAheadFile::SharedThreadPool());
+  }
+
+  std::string contents_;
+  std::string filename_;
+};
+
+TEST_F(ReadAheadFileTest, ReadsSequentially) {
+  auto file = Open(/*block_size=*/64, /*num_blocks=*/4);
+  std::string read;
+  char scratch[100];
+  StringPiece result;
+  Status status;
+  while (status.ok()) {
+    status = file->Read(read.size(), sizeof(scratch), &result, scratch);
+    read.append(result.data(), result.size());
+  }
+  EXPECT_TRUE(errors::IsOutOfRange(status));
+  EXPECT_EQ(read, contents_);
+}
+
+TEST_F(ReadAheadFileTest, ReadsBackwards) {
+  auto file = Open(/*block_size=*/16, /*num_blocks=*/2);
+  char scratch[40];
+  StringPiece result;
+  for (int offset : {900, 500, 10, 0}) {
+    TF_ASSERT_OK(file->Read(offset, sizeof(scratch), &result, scratch));
+    EXPECT_EQ(result, StringPiece(contents_).substr(offset, sizeof(scratch)));
+  }
+}
+
+TEST_F(ReadAheadFileTest, ReadsPastEnd) {
+  auto file = Open(/*block_size=*/64, /*num_blocks=*/4);
+  char scratch[10];
+  StringPiece result;
+  EXPECT_TRUE(
+      errors::IsOutOfRange(file->Read(995, sizeof(scratch), &result, scratch)));
+  EXPECT_EQ(result, StringPiece(contents_).substr(995));
+  EXPECT_TRUE(errors::IsOutOfRange(
+      file->Read(2000, sizeof(scratch), &result, scratch)));
+  EXPECT_TRUE(result.empty());
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -23,9 +23,11 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "tensorflow/core/common_runtime/process_state.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/rewrite_utils.h"
+#include "tensorflow/core/data/unbounded_thread_pool.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -34,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/stringprintf.h"
@@ -56,6 +59,7 @@ constexpr char kPrivateThreadpoolSize[] = "threadpool_size";
 constexpr char kRamBudget[] = "ram_budget_megabytes";
 constexpr char kRamUsage[] = "ram_usage_megabytes";
 constexpr char kMaxBufferBytes[] = "max_buffered_megabytes";
+constexpr char kNumaNode[] = "numa_node";
 constexpr char kWarmStart[] = "warm_start";
 
 // If value `x` matches `y`, returns default value `z`. Otherwise, return `x`.
@@ -72,6 +76,20 @@ void SetRootDatasetParams(const Options& options, RootDataset::Params* params) {
     params->private_threadpool_size =
         options.threading_options().private_threadpool_size();
   }
+  if (options.threading_options().optional_numa_node_case() ==
+      ThreadingOptions::kNumaNode) {
+    const int numa_node = options.threading_options().numa_node();
+    if (!port::NUMAEnabled()) {
+      VLOG(1) << "Ignoring the NUMA node " << numa_node
+              << " of the dataset, NUMA is not supported on this host";
+    } else if (numa_node < 0 || numa_node >= port::NUMANumNodes()) {
+      LOG(WARNING) << "Ignoring the NUMA node " << numa_node
+                   << " of the dataset, the host has "
+                   << port::NUMANumNodes() << " NUMA nodes";
+    } else {
+      params->numa_node = numa_node;
+    }
+  }
   params->autotune = ShouldUseAutotuning(options);
   params->autotune_algorithm = model::AutotuneAlgorithm::DEFAULT;
   auto experiments = GetExperiments();
@@ -135,6 +153,10 @@ void AddTraceMetadata(const RootDataset::Params& params, const Options& options,
                                     params.private_threadpool_size, 0,
                                     port::MaxParallelism())))));
   }
+  if (params.numa_node != port::kNUMANoAffinity) {
+    trace_metadata->push_back(std::make_pair(
+        kNumaNode, strings::Printf("%d", params.numa_node)));
+  }
   auto experiments = GetExperiments();
   if (!experiments.empty()) {
     trace_metadata->push_back(
@@ -179,14 +201,22 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
           value_or_default(dataset()->params_.max_intra_op_parallelism, 0,
                            port::MaxParallelism());
     }
+    ThreadOptions thread_options;
+    thread_options.numa_node = dataset()->params_.numa_node;
     if (dataset()->params_.private_threadpool_size >= 0) {
       threadpool_size_ =
           value_or_default(dataset()->params_.private_threadpool_size, 0,
                            port::MaxParallelism());
       thread_pool_ = std::make_unique<thread::ThreadPool>(
-          Env::Default(), ThreadOptions{}, "data_private_threadpool",
+          Env::Default(), thread_options, "data_private_threadpool",
           threadpool_size_);
     }
+    if (dataset()->params_.numa_node != port::kNUMANoAffinity) {
+      // Replaces the pool of the iterator resource, so that the threads that
+      // the iterators start run on the NUMA node too.
+      unbounded_thread_pool_ = std::make_unique<UnboundedThreadPool>(
+          Env::Default(), "tf_data_numa_bound", thread_options);
+    }
     cancellation_manager_ = std::make_unique<CancellationManager>();
   }
 
@@ -242,12 +272,17 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
       TF_RETURN_IF_ERROR(EnsureModelThreadStarted(ctx));
     }
     IteratorContext iter_ctx(CreateParams(ctx));
+    const uint64_t start_time_usec = ctx->env()->NowMicros();
     TF_RETURN_IF_ERROR(
         input_impl_->GetNext(&iter_ctx, out_tensors, end_of_sequence));
     ctx->MergeCheckpoint(iter_ctx.checkpoint());
     {
       mutex_lock l(mu_);
-      end_time_usec_ = std::max(ctx->env()->NowMicros(), end_time_usec_);
+      const uint64_t now_usec = ctx->env()->NowMicros();
+      if (model_ != nullptr && !*end_of_sequence) {
+        model_->RecordIteratorWaitTime(now_usec - start_time_usec);
+      }
+      end_time_usec_ = std::max(now_usec, end_time_usec_);
     }
     return absl::OkStatus();
   }
@@ -336,6 +371,26 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
       params.runner =
           RunnerWithMaxParallelism(params.runner, max_intra_op_parallelism_);
     }
+    if (unbounded_thread_pool_ != nullptr) {
+      params.thread_factory = unbounded_thread_pool_->get_thread_factory();
+      params.thread_pool = unbounded_thread_pool_.get();
+      // Only plain host allocations are bound to the NUMA node. The others,
+      // e.g. GPU-compatible or NIC-compatible ones, need the allocator that
+      // the device would have used.
+      params.allocator_getter =
+          [numa_node = dataset()->params_.numa_node,
+           allocator_getter = params.allocator_getter](
+              AllocatorAttributes attrs) {
+            AllocatorAttributes host_attrs;
+            host_attrs.set_on_host(true);
+            if (allocator_getter != nullptr &&
+                (attrs.scope_id != 0 ||
+                 !attrs.IsEqualOrLessRestrictiveThan(host_attrs))) {
+              return allocator_getter(attrs);
+            }
+            return ProcessState::singleton()->GetCPUAllocator(numa_node);
+          };
+    }
     params.options = &dataset()->options();
     return params;
   }
@@ -378,6 +433,8 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
   int64_t max_intra_op_parallelism_;
   int64_t threadpool_size_;
   std::unique_ptr<thread::ThreadPool> thread_pool_;
+  // Set when the iterator is bound to a NUMA node.
+  std::unique_ptr<UnboundedThreadPool> unbounded_thread_pool_;
 
   // The end time of the previous `GetNextInternal` call.
   uint64_t end_time_usec_ TF_GUARDED_BY(mu_) = 0;
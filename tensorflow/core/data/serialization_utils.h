@@ -59,6 +59,15 @@ Status UpdateCheckpointElements(
     const std::vector<std::vector<Tensor>>& elements,
     const absl::flat_hash_set<int64_t>& checkpoint_indices);
 
+// Writes the dataset elements from `first_index` onwards to the checkpoint
+// using the given key prefix, assuming that the elements before `first_index`
+// have been checkpointed before. This lets append-only buffers write only the
+// elements added since the previous save. The elements can be read back by
+// passing the same key prefix to ReadElementsFromCheckpoint.
+Status AppendElementsToCheckpoint(
+    IteratorStateWriter* writer, StringPiece key_prefix,
+    const std::vector<std::vector<Tensor>>& elements, int64_t first_index);
+
 // Helper class for reading data from a vector of VariantTensorData objects.
 class VariantTensorDataReader : public IteratorStateReader {
  public:
@@ -26,6 +26,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -206,6 +207,19 @@ absl::Status MultipleIterationsAutoScaler::UnregisterIteration(
 
 absl::Status MultipleIterationsAutoScaler::UpdateOptimalNumberOfWorkersMetric(
     int64_t current_number_of_workers) TF_LOCKS_EXCLUDED(mu_) {
+  absl::StatusOr<int64_t> bound_optimal_number_of_workers =
+      GetBoundedOptimalNumberOfWorkers(current_number_of_workers);
+  if (!bound_optimal_number_of_workers.ok()) {
+    return bound_optimal_number_of_workers.status();
+  }
+  metrics::RecordTFDataServiceOptimalNumberOfWorkers(
+      *bound_optimal_number_of_workers);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<int64_t>
+MultipleIterationsAutoScaler::GetBoundedOptimalNumberOfWorkers(
+    int64_t current_number_of_workers) const TF_LOCKS_EXCLUDED(mu_) {
   if (current_number_of_workers <= 0)
     return absl::InvalidArgumentError(
         "The current number of workers must be positive");
@@ -235,11 +249,7 @@ absl::Status MultipleIterationsAutoScaler::UpdateOptimalNumberOfWorkersMetric(
       std::min(bound_optimal_number_of_workers, int64_t{100000});
   VLOG(3) << "Bound optimal number of workers: "
           << bound_optimal_number_of_workers;
-
-  metrics::RecordTFDataServiceOptimalNumberOfWorkers(
-      bound_optimal_number_of_workers);
-
-  return absl::OkStatus();
+  return bound_optimal_number_of_workers;
 }
 
 std::optional<int64_t> MultipleIterationsAutoScaler::GetOptimalNumberOfWorkers()
@@ -22,6 +22,7 @@ limitations under the License.
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
 #include "absl/time/time.h"
 #include "tsl/platform/mutex.h"
 #include "tsl/platform/status.h"
@@ -126,6 +127,12 @@ class MultipleIterationsAutoScaler {
   // iteration, or `current_number_of_workers` is not positive.
   absl::Status UpdateOptimalNumberOfWorkersMetric(
       int64_t current_number_of_workers) TF_LOCKS_EXCLUDED(mu_);
+  // Returns the estimated optimal number of workers, limited as described for
+  // `UpdateOptimalNumberOfWorkersMetric`. Returns an error if there are no
+  // previously reported processing and target processing times for at least
+  // one iteration, or `current_number_of_workers` is not positive.
+  absl::StatusOr<int64_t> GetBoundedOptimalNumberOfWorkers(
+      int64_t current_number_of_workers) const TF_LOCKS_EXCLUDED(mu_);
   // Returns the estimated optimal number of workers according to the current
   // observed workload. If there are no previously reported processing and
   // target processing times for at least one iteration, returns nullopt.
@@ -27,6 +27,7 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+using ::tsl::testing::IsOkAndHolds;
 using ::tsl::testing::StatusIs;
 
 TEST(AutoScalerTest, GetOptimalNumberOfWorkersInitialState) {
@@ -330,6 +331,23 @@ TEST(MultipleIterationsAutoScalerTest,
   EXPECT_THAT(status, StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(MultipleIterationsAutoScalerTest, GetBoundedOptimalNumberOfWorkers) {
+  MultipleIterationsAutoScaler auto_scaler;
+  EXPECT_THAT(auto_scaler.GetBoundedOptimalNumberOfWorkers(1),
+              StatusIs(absl::StatusCode::kUnavailable));
+
+  TF_ASSERT_OK(
+      auto_scaler.ReportTargetProcessingTime(0, 0, absl::Microseconds(1)));
+  TF_ASSERT_OK(auto_scaler.ReportProcessingTime(0, "/worker/task/0:20000",
+                                                absl::Microseconds(100)));
+  EXPECT_THAT(auto_scaler.GetBoundedOptimalNumberOfWorkers(1),
+              IsOkAndHolds(4));
+  EXPECT_THAT(auto_scaler.GetBoundedOptimalNumberOfWorkers(50),
+              IsOkAndHolds(100));
+  EXPECT_THAT(auto_scaler.GetBoundedOptimalNumberOfWorkers(0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(MultipleIterationsAutoScalerTest,
      UpdateOptimalNumberOfWorkersMetricNoReportedTimes) {
   MultipleIterationsAutoScaler auto_scaler;
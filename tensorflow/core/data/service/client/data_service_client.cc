@@ -29,6 +29,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/substitute.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/data/service/client/common.h"
@@ -52,6 +53,7 @@ limitations under the License.
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/host_info.h"
 #include "tsl/platform/retrying_utils.h"
 #include "tsl/protobuf/error_codes.pb.h"
@@ -66,6 +68,28 @@ bool IsColocatedTask(const TaskInfo& task) {
   });
 }
 
+// Returns the zone of the task's worker, or an empty string if the worker has
+// no zone tag.
+std::string GetWorkerZone(const TaskInfo& task) {
+  for (const std::string& worker_tag : task.worker_tags()) {
+    if (absl::StartsWith(worker_tag, kZoneWorkerTagPrefix)) {
+      return worker_tag.substr(kZoneWorkerTagPrefix.size());
+    }
+  }
+  return "";
+}
+
+std::string GetClientZone() {
+  std::string zone;
+  Status s = ReadStringFromEnvVar("TF_DATA_SERVICE_CLIENT_ZONE",
+                                  /*default_val=*/"", &zone);
+  if (!s.ok()) {
+    LOG(ERROR) << "Failed to read TF_DATA_SERVICE_CLIENT_ZONE: " << s;
+    return "";
+  }
+  return zone;
+}
+
 StatusOr<DataTransferServerInfo> GetTransferServer(const std::string& protocol,
                                                    const TaskInfo& task_info) {
   for (const auto& transfer_server : task_info.transfer_servers()) {
@@ -82,6 +106,7 @@ StatusOr<DataTransferServerInfo> GetTransferServer(const std::string& protocol,
 
 DataServiceClient::DataServiceClient(const DataServiceParams& params)
     : params_(params),
+      client_zone_(GetClientZone()),
       max_outstanding_requests_(params.max_outstanding_requests) {}
 
 DataServiceClient::~DataServiceClient() {
@@ -413,6 +438,8 @@ Status DataServiceClient::AddTask(const TaskInfo& task_info)
       worker->GetDataTransferProtocol(),
       /*user_specified=*/!params_.data_transfer_protocol.empty());
   tasks_.push_back(std::make_shared<Task>(task_info, std::move(worker)));
+  tasks_.back()->in_client_zone =
+      !client_zone_.empty() && GetWorkerZone(task_info) == client_zone_;
   worker_thread_cv_.notify_one();
   if (IsCoordinatedRead()) {
     VLOG(1) << "Consumer " << params_.consumer_index.value() << " adding task "
@@ -682,6 +709,14 @@ std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
     return nullptr;
   }
 
+  // Tasks outside the client's zone are only read once all tasks in the zone
+  // have finished.
+  const bool prefer_client_zone =
+      !IsCoordinatedRead() &&
+      absl::c_any_of(tasks_, [](const std::shared_ptr<Task>& task) {
+        return task->in_client_zone && !task->end_of_sequence &&
+               !task->removed;
+      });
   for (int i = 0; i < tasks_.size(); ++i) {
     std::shared_ptr<Task>& task = tasks_[next_task_index_];
     if (IsCoordinatedRead() &&
@@ -695,13 +730,15 @@ std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
       return nullptr;
     }
     if (current_round_ < task->info.starting_round() || task->in_use ||
-        task->end_of_sequence || task->removed) {
+        task->end_of_sequence || task->removed ||
+        (prefer_client_zone && !task->in_client_zone)) {
       VLOG(3) << "Skipping task " << next_task_index_
               << ". starting round: " << task->info.starting_round()
               << ". current round: " << current_round_
               << ". task->in_use: " << task->in_use
               << ". end_of_sequence: " << task->end_of_sequence
-              << ". task->removed: " << task->removed;
+              << ". task->removed: " << task->removed
+              << ". task->in_client_zone: " << task->in_client_zone;
       AdvanceTaskIndex();
       continue;
     }
@@ -731,6 +768,8 @@ Status DataServiceClient::TryGetElement(const Task& task,
     req.set_consumer_index(params_.consumer_index.value());
     req.set_round_index(task.round);
     req.set_allow_skip(true);
+  } else {
+    req.set_max_elements(MaxElementsPerRequest());
   }
   if (params_.cross_trainer_cache_options) {
     req.set_trainer_id(params_.cross_trainer_cache_options->trainer_id());
@@ -738,6 +777,18 @@ Status DataServiceClient::TryGetElement(const Task& task,
   return task.worker->GetElement(req, result);
 }
 
+int64_t DataServiceClient::MaxElementsPerRequest() const
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  // Each outstanding request already counts towards
+  // `max_outstanding_requests_`.
+  const int64_t free_slots = max_outstanding_requests_ -
+                             static_cast<int64_t>(results_.size()) -
+                             outstanding_requests_;
+  return 1 + std::max<int64_t>(free_slots, 0) /
+                 std::max<int64_t>(outstanding_requests_, 1);
+}
+
 void DataServiceClient::ProcessGetElementResponse(
     bool enqueue_result, GetElementResult& get_element_result,
     std::shared_ptr<Result> result, Task& task) TF_LOCKS_EXCLUDED(mu_) {
@@ -760,6 +811,21 @@ void DataServiceClient::ProcessGetElementResponse(
     ctx_->RecordBufferEnqueue(result->element);
     results_.push(std::move(result));
   }
+  for (GetElementResult& additional_element :
+       get_element_result.additional_elements) {
+    if (additional_element.end_of_sequence) {
+      task.end_of_sequence = true;
+      finished_tasks_++;
+      break;
+    }
+    auto additional_result = std::make_shared<Result>();
+    additional_result->ready = true;
+    additional_result->element = std::move(additional_element.components);
+    additional_result->element_index = additional_element.element_index;
+    additional_result->task_id = task.info.task_id();
+    ctx_->RecordBufferEnqueue(additional_result->element);
+    results_.push(std::move(additional_result));
+  }
   get_next_cv_.notify_all();
 }
 
@@ -106,6 +106,8 @@ class DataServiceClient {
     // deleted from `tasks_` on the next dispatcher heartbeat.
     bool removed = false;
     bool skipped_previous_round = false;
+    // Whether the task's worker is in the client's zone.
+    bool in_client_zone = false;
     // Indicates whether a worker thread is currently processing the task.
     bool in_use TF_GUARDED_BY(&DataServiceClient::mu_) = false;
     // Indicates whether the worker has returned end_of_sequence for the task.
@@ -175,6 +177,9 @@ class DataServiceClient {
   std::shared_ptr<Task> GetTaskToProcess();
   void AdvanceTaskIndex();
   Status TryGetElement(const Task& task, GetElementResult& result);
+  // Returns how many elements a request may fetch, sharing the free buffer
+  // space among the outstanding requests.
+  int64_t MaxElementsPerRequest() const;
   void ProcessGetElementResponse(bool enqueue_result,
                                  GetElementResult& get_element_result,
                                  std::shared_ptr<Result> result, Task& task);
@@ -189,6 +194,9 @@ class DataServiceClient {
   std::string DebugString() const;
 
   const DataServiceParams params_;
+  // The client's zone, which workers tagged with the same zone are preferred
+  // for. Empty if the client has no zone.
+  const std::string client_zone_;
 
   mutable mutex mu_;
   condition_variable get_next_cv_ TF_GUARDED_BY(mu_);
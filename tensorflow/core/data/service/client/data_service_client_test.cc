@@ -14,8 +14,11 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/service/client/data_service_client.h"
 
+#include <cstdint>
+#include <cstdlib>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -156,6 +159,28 @@ TEST(DataServiceClientTest, DynamicSharding) {
   client.Cancel();
 }
 
+TEST(DataServiceClientTest, PrefersWorkersInClientZone) {
+  TestCluster test_cluster(/*num_workers=*/0);
+  TF_ASSERT_OK(test_cluster.Initialize());
+  TF_ASSERT_OK(test_cluster.AddWorker(/*port=*/std::nullopt, {"zone:b"}));
+  TF_ASSERT_OK(test_cluster.AddWorker(/*port=*/std::nullopt, {"zone:a"}));
+  DatasetClient<int64_t> test_dataset(test_cluster);
+  TF_ASSERT_OK_AND_ASSIGN(std::string dataset_id,
+                          test_dataset.RegisterDataset(RangeDataset(10)));
+
+  setenv("TF_DATA_SERVICE_CLIENT_ZONE", "a", /*overwrite=*/1);
+  DataServiceParams params = GetDataServiceParams(
+      dataset_id, test_cluster.DispatcherAddress(), ProcessingModeDef::OFF);
+  DataServiceClient client(params);
+  unsetenv("TF_DATA_SERVICE_CLIENT_ZONE");
+  TF_ASSERT_OK(client.Initialize(/*allocator=*/nullptr));
+  // The worker in zone "a" is read to completion before the one in zone "b".
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_THAT(GetNext<int64_t>(client), IsOkAndHolds(i));
+  }
+  client.Cancel();
+}
+
 TEST(DataServiceClientTest, StaticSharding) {
   TestCluster test_cluster(/*num_workers=*/3);
   TF_ASSERT_OK(test_cluster.Initialize());
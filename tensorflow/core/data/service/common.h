@@ -39,6 +39,12 @@ constexpr int kDataServiceVersion = 9;
 // workers on other TF hosts when the host runs a local tf.data service worker.
 constexpr absl::string_view kColocatedWorkerTag = "COLOCATED";
 
+// Workers may be tagged with "zone:<name>" to describe their network location,
+// e.g. their rack or cloud zone. Clients whose `TF_DATA_SERVICE_CLIENT_ZONE`
+// environment variable names the same zone prefer reading from those workers
+// to avoid cross-zone traffic.
+constexpr absl::string_view kZoneWorkerTagPrefix = "zone:";
+
 // Container to hold the result of a `GetNext` call.
 struct GetNextResult final {
   explicit GetNextResult() = default;
@@ -15,7 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <limits>
@@ -26,6 +28,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
@@ -46,6 +49,13 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
+// If `max_wait_for_slow_trainers_ms` is positive, an element is only evicted
+// after every trainer that is keeping up with the cache has read it: a trainer
+// that needs the cache to grow waits for the slower trainers until they catch
+// up or until the wait times out, after which the slower trainers skip the
+// evicted elements as before. A trainer that has already been skipped is not
+// waited on until it reads from the cache again.
+//
 // The `CrossTrainerCache` class is thread-safe.
 //
 // Example usage:
@@ -98,9 +108,14 @@ class CrossTrainerCache {
   // Creates a `CrossTrainerCache` with `max_cache_size_bytes` of memory budget.
   // The cache should be able to hold at least one element, i.e.:
   // REQUIRES: `max_cache_size_bytes >= max(GetElementSizeBytes(*))`
+  //
+  // `max_wait_for_slow_trainers_ms` bounds how long a fast trainer waits for
+  // slower trainers to read an element before evicting it. If it is 0, elements
+  // are evicted as soon as the cache is full.
   explicit CrossTrainerCache(
       size_t max_cache_size_bytes,
-      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence);
+      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+      int64_t max_wait_for_slow_trainers_ms = 0);
   virtual ~CrossTrainerCache() = default;
   CrossTrainerCache(const CrossTrainerCache&) = delete;
   CrossTrainerCache& operator=(const CrossTrainerCache&) = delete;
@@ -147,7 +162,12 @@ class CrossTrainerCache {
 
   // Frees old elements to keep the cache size below `max_cache_size_bytes_`.
   // `new_element_size_bytes` is the size of the new element being inserted.
-  void FreeSpace(size_t new_element_size_bytes);
+  // Waits for slow trainers to read the oldest element if required.
+  Status FreeSpace(size_t new_element_size_bytes, mutex_lock& l);
+
+  // Returns true if a trainer that has not been skipped by the sliding window
+  // has not read the oldest cached element.
+  bool IsOldestElementUnread();
 
   // Records the cache hit rate and cache size.
   void RecordMetrics(const CacheQueryResult& result);
@@ -155,6 +175,9 @@ class CrossTrainerCache {
   // Maximum cache size in bytes.
   const size_t max_cache_size_bytes_;
 
+  // Maximum time to wait for slow trainers before evicting their unread data.
+  const int64_t max_wait_for_slow_trainers_ms_;
+
   // The element sequence over which the sliding window cache operates.
   std::unique_ptr<CachableSequence<ElementType>> cachable_sequence_;
 
@@ -183,8 +206,10 @@ class CrossTrainerCache {
 template <class ElementType>
 CrossTrainerCache<ElementType>::CrossTrainerCache(
     size_t max_cache_size_bytes,
-    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence)
+    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+    int64_t max_wait_for_slow_trainers_ms)
     : max_cache_size_bytes_(max_cache_size_bytes),
+      max_wait_for_slow_trainers_ms_(max_wait_for_slow_trainers_ms),
       cachable_sequence_(std::move(cachable_sequence)) {
   DCHECK_GT(max_cache_size_bytes, 0)
       << "CrossTrainerCache size must be greater than 0.";
@@ -218,6 +243,10 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       if (IsElementReady(trainer_id)) {
         TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
                             GetElement(trainer_id));
+        if (extending_cache_ && max_wait_for_slow_trainers_ms_ > 0) {
+          // Wakes up a trainer that may be waiting for this read to evict.
+          cv_.notify_all();
+        }
         return CacheQueryResult{element,
                                 /*is_cache_hit=*/!should_extend_cache};
       }
@@ -291,18 +320,29 @@ Status CrossTrainerCache<ElementType>::ExtendCache() TF_LOCKS_EXCLUDED(mu_) {
 
   mutex_lock l(mu_);
   TF_RETURN_IF_ERROR(status_);
-  FreeSpace(new_element_size_bytes);
+  TF_RETURN_IF_ERROR(FreeSpace(new_element_size_bytes, l));
   cache_.push_back(std::make_shared<ElementType>(std::move(element)));
   cache_size_bytes_ += new_element_size_bytes;
   return absl::OkStatus();
 }
 
 template <class ElementType>
-void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
+Status CrossTrainerCache<ElementType>::FreeSpace(
+    size_t new_element_size_bytes, mutex_lock& l)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  const uint64_t deadline_us =
+      EnvTime::NowMicros() + max_wait_for_slow_trainers_ms_ * 1000;
   size_t num_elements_discarded = 0;
   while (!cache_.empty() &&
          cache_size_bytes_ + new_element_size_bytes > max_cache_size_bytes_) {
+    const uint64_t now_us = EnvTime::NowMicros();
+    if (max_wait_for_slow_trainers_ms_ > 0 && now_us < deadline_us &&
+        IsOldestElementUnread()) {
+      WaitForMilliseconds(&l, &cv_,
+                          std::max<int64_t>((deadline_us - now_us) / 1000, 1));
+      TF_RETURN_IF_ERROR(status_);
+      continue;
+    }
     size_t free_bytes =
         cachable_sequence_->GetElementSizeBytes(*cache_.front());
     cache_.pop_front();
@@ -314,6 +354,17 @@ void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
   VLOG(3) << "Freed " << num_elements_discarded << " element(s) from "
           << "tf.data service cross-trainer cache. Memory usage: "
           << ByteSize::Bytes(cache_size_bytes_) << ".";
+  return absl::OkStatus();
+}
+
+template <class ElementType>
+bool CrossTrainerCache<ElementType>::IsOldestElementUnread()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  return std::any_of(trainer_to_element_index_map_.begin(),
+                     trainer_to_element_index_map_.end(),
+                     [this](const auto& trainer_and_index) {
+                       return trainer_and_index.second == cache_start_index_;
+                     });
 }
 
 template <class ElementType>
@@ -190,6 +190,53 @@ TEST(CrossTrainerCacheTest, SlowTrainersSkipData) {
   EXPECT_THAT(cache.Get("Slow trainer 2"), IsOkAndHolds(Pointee(Gt(94))));
 }
 
+TEST(CrossTrainerCacheTest, FastTrainerWaitsForSlowTrainer) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/2 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(),
+      /*max_wait_for_slow_trainers_ms=*/10 * 60 * 1000);
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+
+  // Caching 3 evicts 1, which the slow trainer has not read.
+  mutex mu;
+  bool fast_trainer_done = false;
+  std::unique_ptr<Thread> fast_trainer(Env::Default()->StartThread(
+      /*thread_options=*/{}, /*name=*/"fast_trainer", [&]() {
+        EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(3)));
+        mutex_lock l(mu);
+        fast_trainer_done = true;
+      }));
+  Env::Default()->SleepForMicroseconds(100 * 1000);
+  {
+    mutex_lock l(mu);
+    EXPECT_FALSE(fast_trainer_done);
+  }
+
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(1)));
+  fast_trainer.reset();
+  EXPECT_TRUE(fast_trainer_done);
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(2)));
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(3)));
+}
+
+TEST(CrossTrainerCacheTest, SlowTrainersSkipDataAfterWaitTimeout) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(),
+      /*max_wait_for_slow_trainers_ms=*/1);
+  EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(0)));
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 1; i < 20; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+
+  // When 19 is cached, 14 must have been discarded.
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(Gt(14))));
+}
+
 TEST(CrossTrainerCacheTest, NewTrainersStartLate) {
   CrossTrainerCache<int64_t> cache(
       /*max_cache_size_bytes=*/5 * sizeof(int64_t),
@@ -59,6 +59,9 @@ GetElementResult GetElementResult::Copy() const {
   copy.element_index = element_index;
   copy.end_of_sequence = end_of_sequence;
   copy.skip = skip;
+  for (const GetElementResult& additional_element : additional_elements) {
+    copy.additional_elements.push_back(additional_element.Copy());
+  }
   return copy;
 }
 
@@ -79,6 +82,9 @@ size_t GetElementResult::EstimatedMemoryUsageBytes() const {
       size_bytes += compressed->SpaceUsedLong();
     }
   }
+  for (const GetElementResult& additional_element : additional_elements) {
+    size_bytes += additional_element.EstimatedMemoryUsageBytes();
+  }
   return size_bytes;
 }
 
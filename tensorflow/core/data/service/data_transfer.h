@@ -62,6 +62,9 @@ struct GetElementResult {
   // reading from the worker. This is used for load balancing when doing round
   // robin reads.
   bool skip = false;
+  // Further elements of the same task, in order, returned by a request whose
+  // `max_elements` was greater than one.
+  std::vector<GetElementResult> additional_elements;
 };
 
 // Client for communicating with the tf.data service transfer server.
@@ -211,6 +211,10 @@ DataServiceDispatcherImpl::~DataServiceDispatcherImpl() {
 
 Status DataServiceDispatcherImpl::Start() {
   mutex_lock l(mu_);
+  if (!config_.worker_pool_controller().empty()) {
+    TF_RETURN_IF_ERROR(WorkerPoolController::Build(
+        config_.worker_pool_controller(), config_, &worker_pool_controller_));
+  }
   if (config_.job_gc_timeout_ms() >= 0) {
     maintenance_thread_ = absl::WrapUnique(env_->StartThread(
         {}, "maintenance-thread", [&] { MaintenanceThread(); }));
@@ -1405,6 +1409,7 @@ void DataServiceDispatcherImpl::MaintenanceThread() {
                      << s;
       }
     }
+    ResizeWorkerPool();
     {
       Status s = GcOldIterations();
       if (!s.ok()) {
@@ -1417,6 +1422,39 @@ void DataServiceDispatcherImpl::MaintenanceThread() {
   }
 }
 
+void DataServiceDispatcherImpl::ResizeWorkerPool()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (!worker_pool_controller_) {
+    return;
+  }
+  absl::StatusOr<int64_t> target_number_of_workers =
+      auto_scaler_.GetBoundedOptimalNumberOfWorkers(
+          state_.GetNumberOfRegisteredWorkers());
+  if (!target_number_of_workers.ok()) {
+    VLOG(3) << "Not resizing the tf.data service worker pool: "
+            << target_number_of_workers.status();
+    return;
+  }
+  if (*target_number_of_workers == requested_number_of_workers_) {
+    return;
+  }
+  std::vector<std::string> worker_addresses;
+  for (const auto& worker : state_.ListWorkers()) {
+    worker_addresses.push_back(worker->address);
+  }
+  Status s = worker_pool_controller_->ResizeWorkerPool(
+      *target_number_of_workers, worker_addresses);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to resize the tf.data service worker pool to "
+                 << *target_number_of_workers << " workers: " << s;
+    return;
+  }
+  VLOG(1) << "Requested " << *target_number_of_workers
+          << " tf.data service workers; " << worker_addresses.size()
+          << " are registered.";
+  requested_number_of_workers_ = *target_number_of_workers;
+}
+
 void DataServiceDispatcherImpl::RemoveClientFromAutoScaler(int64_t client_id)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   std::shared_ptr<const Iteration> iteration;
@@ -35,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/snapshot/snapshot_manager.h"
 #include "tensorflow/core/data/service/task_remover.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
+#include "tensorflow/core/data/service/worker_pool_controller.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
@@ -320,6 +321,9 @@ class DataServiceDispatcherImpl {
   // used when recovering state when the dispatcher starts.
   Status ApplyWithoutJournaling(const Update& update)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Asks `worker_pool_controller_` to resize the worker pool if the estimate
+  // of the optimal number of workers has changed.
+  void ResizeWorkerPool() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Removes the client with `client_id` from `auto_scaler_`
   void RemoveClientFromAutoScaler(int64_t client_id)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -396,6 +400,10 @@ class DataServiceDispatcherImpl {
   condition_variable maintenance_thread_cv_;
   std::unique_ptr<Thread> maintenance_thread_;
   MultipleIterationsAutoScaler auto_scaler_;
+  // Resizes the worker pool according to `auto_scaler_`, if configured.
+  std::unique_ptr<WorkerPoolController> worker_pool_controller_;
+  // The number of workers last requested from `worker_pool_controller_`.
+  int64_t requested_number_of_workers_ TF_GUARDED_BY(mu_) = 0;
 
   DataServiceDispatcherImpl(const DataServiceDispatcherImpl&) = delete;
   void operator=(const DataServiceDispatcherImpl&) = delete;
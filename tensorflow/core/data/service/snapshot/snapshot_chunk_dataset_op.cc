@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -29,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/tstring.h"
@@ -45,6 +47,26 @@ constexpr const char* const kOutputShapes = "output_shapes";
 constexpr const char* const kSnapshotChunkDataset = "SnapshotChunkDataset";
 
 constexpr int64_t kTFRecordReaderOutputBufferSize = 512 << 20;  // 512MB
+constexpr int64_t kDefaultReadAheadBlocks = 4;
+
+// Returns how many blocks to read ahead of each chunk reader, set by
+// TF_DATA_SNAPSHOT_READ_AHEAD_BLOCKS. Reading ahead overlaps the storage
+// latency with decompressing and parsing the chunk. 0 disables reading ahead.
+int64_t ReadAheadBlocks() {
+  static const int64_t read_ahead_blocks = [] {
+    int64_t value;
+    if (!ReadInt64FromEnvVar("TF_DATA_SNAPSHOT_READ_AHEAD_BLOCKS",
+                             kDefaultReadAheadBlocks, &value)
+             .ok() ||
+        value < 0) {
+      LOG(ERROR) << "Invalid TF_DATA_SNAPSHOT_READ_AHEAD_BLOCKS, reading "
+                 << kDefaultReadAheadBlocks << " blocks ahead.";
+      return kDefaultReadAheadBlocks;
+    }
+    return value;
+  }();
+  return read_ahead_blocks;
+}
 
 absl::string_view GetSnapshotPath(absl::string_view chunk_file) {
   // Snapshot chunks are placed in snapshot_path/chunks/chunk_x.
@@ -130,7 +152,9 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
     absl::Status Initialize(IteratorContext* ctx) override {
       reader_ = std::make_unique<snapshot_util::TFRecordReader>(
           TranslateFileName(dataset()->chunk_file_), dataset()->compression_,
-          dataset()->dtypes_, kTFRecordReaderOutputBufferSize);
+          dataset()->dtypes_, kTFRecordReaderOutputBufferSize,
+          ReadAheadBlocks());
+      start_time_us_ = ctx->env()->NowMicros();
       return reader_->Initialize(ctx->env());
     }
 
@@ -142,6 +166,7 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
       absl::Status status = reader_->ReadTensors(out_tensors);
       if (absl::IsOutOfRange(status)) {
         *end_of_sequence = true;
+        RecordReadThroughput(ctx);
         return absl::OkStatus();
       }
       TF_RETURN_WITH_CONTEXT_IF_ERROR(
@@ -163,6 +188,7 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(
           reader->ReadScalar(full_name(kStartIndex), &start_index_));
       TF_RETURN_IF_ERROR(Initialize(ctx));
+      start_time_us_ = -1;
       return AdvanceToStartIndex(ctx);
     }
 
@@ -184,8 +210,25 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
           ->IncrementBy(bytes_read);
     }
 
+    // Records the throughput of reading the chunk, once it has been read from
+    // the start.
+    void RecordReadThroughput(IteratorContext* ctx) {
+      if (start_time_us_ < 0) {
+        return;
+      }
+      const int64_t duration_us =
+          std::max<int64_t>(ctx->env()->NowMicros() - start_time_us_, 1);
+      // Bytes per microsecond are megabytes per second.
+      metrics::RecordTFDataServiceSnapshotChunkReadThroughput(
+          static_cast<double>(reader_->BytesRead()) / duration_us);
+      start_time_us_ = -1;
+    }
+
     std::unique_ptr<snapshot_util::TFRecordReader> reader_;
     int64_t start_index_ = 0;
+    // When the chunk started being read, or -1 if its throughput has been
+    // recorded or it was restored mid-chunk.
+    int64_t start_time_us_ = -1;
   };
 
   const tstring chunk_file_;
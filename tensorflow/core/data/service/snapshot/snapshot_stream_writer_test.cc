@@ -34,10 +34,15 @@ limitations under the License.
 #include "tensorflow/core/data/service/test_util.h"
 #include "tensorflow/core/data/snapshot_utils.h"
 #include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/lib/io/compression.h"
 #include "tsl/lib/monitoring/cell_reader.h"
+#include "tsl/lib/monitoring/test_utils.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/status_matchers.h"
@@ -54,6 +59,7 @@ using ::testing::SizeIs;
 using ::testing::UnorderedElementsAre;
 using ::testing::ValuesIn;
 using ::tsl::monitoring::testing::CellReader;
+using ::tsl::monitoring::testing::Histogram;
 using ::tsl::testing::IsOkAndHolds;
 using ::tsl::testing::StatusIs;
 
@@ -142,6 +148,31 @@ absl::StatusOr<std::vector<T>> ReadSnapshot(const std::string& snapshot_path,
   return result;
 }
 
+// Returns a dataset reading the int64 scalars of the snapshot chunk
+// `chunk_file`.
+absl::StatusOr<DatasetDef> SnapshotChunkDataset(
+    const std::string& chunk_file, const std::string& compression) {
+  DatasetDef dataset_def;
+  GraphDef* graph = dataset_def.mutable_graph();
+  TF_RETURN_IF_ERROR(NodeDefBuilder("chunk_file", "Const")
+                         .Attr("dtype", DT_STRING)
+                         .Attr("value", Tensor(tstring(chunk_file)))
+                         .Finalize(graph->add_node()));
+  TF_RETURN_IF_ERROR(
+      NodeDefBuilder("chunk", "SnapshotChunkDataset")
+          .Input("chunk_file", 0, DT_STRING)
+          .Attr("output_types", DataTypeVector{DT_INT64})
+          .Attr("output_shapes",
+                std::vector<PartialTensorShape>{PartialTensorShape({})})
+          .Attr("compression", compression)
+          .Finalize(graph->add_node()));
+  TF_RETURN_IF_ERROR(NodeDefBuilder("dataset", "_Retval")
+                         .Input("chunk", 0, DT_VARIANT)
+                         .Attr("index", 0)
+                         .Finalize(graph->add_node()));
+  return dataset_def;
+}
+
 absl::StatusOr<std::string> ReadStringFromFile(const std::string& filename) {
   std::string data;
   TF_RETURN_IF_ERROR(ReadFileToString(Env::Default(), filename, &data));
@@ -222,6 +253,46 @@ TEST_P(SnapshotStreamWriterParameterizedTest, WriteSnapshotChunks) {
               IsOkAndHolds(UnorderedElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9)));
 }
 
+TEST_P(SnapshotStreamWriterParameterizedTest, ReadChunksRecordsThroughput) {
+  CellReader<Histogram> throughput(
+      "/tensorflow/data/service/snapshot_chunk_read_throughput");
+  int64_t range = 10;
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<StandaloneTaskIterator> iterator,
+                          TestIterator(testing::RangeDataset(range)));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::string snapshot_path, CreateSnapshotDirectory());
+  SnapshotWriterParams writer_params{snapshot_path, /*stream_index=*/0,
+                                     Compression(), Env::Default(),
+                                     /*max_chunk_size=*/ByteSize::Bytes(1)};
+  SnapshotStreamWriter snapshot_writer(writer_params, std::move(iterator));
+  EXPECT_THAT(snapshot_writer.Wait(), IsOkAndHolds(true));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::string> chunks,
+      GetChildren(writer_params.CommittedChunksDirectory(), Env::Default()));
+  ASSERT_THAT(chunks, SizeIs(range));
+
+  std::vector<int64_t> elements;
+  for (const std::string& chunk : chunks) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        DatasetDef dataset_def,
+        SnapshotChunkDataset(
+            tsl::io::JoinPath(writer_params.CommittedChunksDirectory(), chunk),
+            Compression()));
+    TF_ASSERT_OK_AND_ASSIGN(iterator, TestIterator(dataset_def));
+    bool end_of_sequence = false;
+    while (true) {
+      std::vector<Tensor> element;
+      TF_ASSERT_OK(iterator->GetNext(element, end_of_sequence));
+      if (end_of_sequence) break;
+      elements.push_back(element[0].scalar<int64_t>()());
+    }
+  }
+  EXPECT_THAT(elements, UnorderedElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+
+  // Each chunk records its throughput once it has been read to the end.
+  EXPECT_EQ(throughput.Delta().num(), range);
+}
+
 TEST_P(SnapshotStreamWriterParameterizedTest, WriteDoneFile) {
   int64_t range = 10;
   TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<StandaloneTaskIterator> iterator,
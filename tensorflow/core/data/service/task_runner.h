@@ -98,6 +98,10 @@ class TaskRunner {
   // Gets the next element for the given request.
   virtual Status GetNext(const GetElementRequest& req,
                          GetElementResult& result) = 0;
+  // Gets the next element if it is ready without blocking. Returns false if no
+  // element is ready, or if the runner serves elements depending on the
+  // request.
+  virtual bool TryGetNext(GetElementResult& result) { return false; }
   // Cancels in-progress `GetNext` requests.
   virtual void Cancel() = 0;
   // Returns the dataset model for performance analysis.
@@ -116,6 +120,7 @@ class FirstComeFirstServedTaskRunner : public TaskRunner {
   Status GetNext(const GetElementRequest& req,
                  GetElementResult& result) override;
   Status GetNext(GetElementResult& result);
+  bool TryGetNext(GetElementResult& result) override;
 
   void Cancel() override;
 
@@ -153,7 +158,8 @@ class FirstComeFirstServedTaskRunner : public TaskRunner {
 class CachingTaskRunner : public TaskRunner {
  public:
   explicit CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
-                             size_t max_cache_size_bytes);
+                             size_t max_cache_size_bytes,
+                             int64_t max_wait_for_slow_trainers_ms = 0);
   ~CachingTaskRunner() override;
 
   // Gets the next element from the cross-trainer cache, blocking if the data is
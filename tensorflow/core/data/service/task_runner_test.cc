@@ -211,6 +211,24 @@ TEST(FirstComeFirstServedTaskRunnerTest, GetNext) {
   EXPECT_TRUE(result.end_of_sequence);
 }
 
+TEST(FirstComeFirstServedTaskRunnerTest, TryGetNext) {
+  size_t range = 10;
+  FirstComeFirstServedTaskRunner runner(
+      std::make_unique<RangeIterator>(range, /*repeat=*/false));
+  std::vector<int64_t> output;
+  while (true) {
+    GetElementResult result;
+    if (!runner.TryGetNext(result)) {
+      TF_ASSERT_OK(runner.GetNext(GetElementRequest(), result));
+    }
+    if (result.end_of_sequence) {
+      break;
+    }
+    output.push_back(result.components[0].flat<int64_t>()(0));
+  }
+  EXPECT_THAT(output, ElementsAreArray(GetRange(range)));
+}
+
 TEST(FirstComeFirstServedTaskRunnerTest, EmptyDataset) {
   FirstComeFirstServedTaskRunner runner(
       std::make_unique<RangeIterator>(/*range=*/0, /*repeat=*/false));
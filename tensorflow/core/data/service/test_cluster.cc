@@ -85,7 +85,8 @@ Status TestCluster::Initialize() {
   return absl::OkStatus();
 }
 
-Status TestCluster::AddWorker(std::optional<int> port) {
+Status TestCluster::AddWorker(std::optional<int> port,
+                              const std::vector<std::string>& worker_tags) {
   std::unique_ptr<WorkerGrpcDataServer> worker;
   experimental::WorkerConfig config;
   if (port.has_value()) {
@@ -97,6 +98,7 @@ Status TestCluster::AddWorker(std::optional<int> port) {
       port.has_value() ? absl::StrCat("localhost:", *port) : "localhost:%port%";
   config.set_worker_address(worker_address);
   config.set_heartbeat_interval_ms(config_.worker_heartbeat_interval_ms);
+  *config.mutable_worker_tags() = {worker_tags.begin(), worker_tags.end()};
   TF_RETURN_IF_ERROR(NewWorkerServer(config, worker));
   TF_RETURN_IF_ERROR(worker->Start());
   worker_addresses_.push_back(absl::StrCat("localhost:", worker->BoundPort()));
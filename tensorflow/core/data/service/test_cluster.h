@@ -67,7 +67,8 @@ class TestCluster {
   // the cluster. Initialize should be called only once.
   Status Initialize();
   // Adds a new worker to the cluster.
-  Status AddWorker(std::optional<int> port = std::nullopt);
+  Status AddWorker(std::optional<int> port = std::nullopt,
+                   const std::vector<std::string>& worker_tags = {});
   // Returns the number of workers in this cluster.
   size_t NumWorkers() const { return workers_.size(); }
   // Returns the port number of a worker.
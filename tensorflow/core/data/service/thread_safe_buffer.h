@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DATA_SERVICE_THREAD_SAFE_BUFFER_H_
 
 #include <deque>
+#include <optional>
 #include <utility>
 
 #include "tensorflow/core/platform/macros.h"
@@ -38,6 +39,11 @@ class ThreadSafeBuffer final {
   // a non-OK status was pushed or the buffer has been cancelled.
   StatusOr<T> Pop();
 
+  // Gets the next element if one is ready, without blocking. Returns
+  // `std::nullopt` if the buffer is empty or the next element is an error, so
+  // that errors are still returned by `Pop`.
+  std::optional<T> TryPop();
+
   // Writes the next element. Blocks if the buffer is full. Returns an error if
   // the buffer has been cancelled.
   Status Push(StatusOr<T> value);
@@ -83,6 +89,18 @@ StatusOr<T> ThreadSafeBuffer<T>::Pop() {
   return result;
 }
 
+template <class T>
+std::optional<T> ThreadSafeBuffer<T>::TryPop() {
+  mutex_lock l(mu_);
+  if (!status_.ok() || results_.empty() || !results_.front().ok()) {
+    return std::nullopt;
+  }
+  std::optional<T> result = std::move(results_.front()).value();
+  results_.pop_front();
+  ready_to_push_.notify_one();
+  return result;
+}
+
 template <class T>
 Status ThreadSafeBuffer<T>::Push(StatusOr<T> value) {
   mutex_lock l(mu_);
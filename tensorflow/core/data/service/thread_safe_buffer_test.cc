@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/thread_safe_buffer.h"
 
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -158,6 +159,19 @@ TEST_P(ThreadSafeBufferTest, BlockReaderWhenBufferIsEmpty) {
   ASSERT_THAT(buffer.Push(Tensor("Test tensor")), IsOk());
 }
 
+TEST_P(ThreadSafeBufferTest, TryPop) {
+  ThreadSafeBuffer<int> buffer(GetBufferSize());
+  EXPECT_EQ(buffer.TryPop(), std::nullopt);
+  ASSERT_THAT(buffer.Push(1), IsOk());
+  EXPECT_EQ(buffer.TryPop(), 1);
+  EXPECT_EQ(buffer.TryPop(), std::nullopt);
+
+  // Errors are left for `Pop`.
+  ASSERT_THAT(buffer.Push(errors::Aborted("Aborted")), IsOk());
+  EXPECT_EQ(buffer.TryPop(), std::nullopt);
+  EXPECT_THAT(buffer.Pop(), StatusIs(error::ABORTED));
+}
+
 TEST_P(ThreadSafeBufferTest, BlockWriterWhenBufferIsFull) {
   ThreadSafeBuffer<Tensor> buffer(GetBufferSize());
   // Fills the buffer to block the next `Push` call.
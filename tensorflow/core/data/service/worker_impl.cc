@@ -300,8 +300,24 @@ Status DataServiceWorkerImpl::GetElementResult(
   });
   TF_RETURN_IF_ERROR(EnsureTaskInitialized(*task));
   TF_RETURN_IF_ERROR(task->task_runner->GetNext(*request, *result));
+  bool end_of_sequence = result->end_of_sequence;
+  if (!result->end_of_sequence && !result->skip) {
+    // Amortize the request over the elements that are already prefetched.
+    while (static_cast<int64_t>(result->additional_elements.size()) + 1 <
+           request->max_elements()) {
+      struct GetElementResult additional_element;
+      if (!task->task_runner->TryGetNext(additional_element)) {
+        break;
+      }
+      end_of_sequence = additional_element.end_of_sequence;
+      result->additional_elements.push_back(std::move(additional_element));
+      if (end_of_sequence) {
+        break;
+      }
+    }
+  }
 
-  if (result->end_of_sequence) {
+  if (end_of_sequence) {
     mutex_lock l(mu_);
     VLOG(3) << "Reached end_of_sequence for task " << request->task_id();
     pending_completed_tasks_.insert(request->task_id());
@@ -488,6 +504,17 @@ Status DataServiceWorkerImpl::GetElement(const GetElementRequest* request,
         MoveElementToResponse(std::move(result.components), *response));
     VLOG(3) << "Producing an element for task " << request->task_id();
   }
+  for (struct GetElementResult& additional_element :
+       result.additional_elements) {
+    GetElementResponse* additional_response =
+        response->add_additional_elements();
+    additional_response->set_end_of_sequence(
+        additional_element.end_of_sequence);
+    if (!additional_element.end_of_sequence) {
+      TF_RETURN_IF_ERROR(MoveElementToResponse(
+          std::move(additional_element.components), *additional_response));
+    }
+  }
   return absl::OkStatus();
 }
 
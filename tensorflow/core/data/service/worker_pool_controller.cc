@@ -0,0 +1,75 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/worker_pool_controller.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/strings/str_join.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+namespace tensorflow {
+namespace data {
+
+namespace {
+mutex* get_lock() {
+  static mutex lock(LINKER_INITIALIZED);
+  return &lock;
+}
+
+using WorkerPoolControllerFactories =
+    std::unordered_map<std::string, WorkerPoolController::FactoryT>;
+WorkerPoolControllerFactories& worker_pool_controller_factories() {
+  static auto& factories = *new WorkerPoolControllerFactories();
+  return factories;
+}
+}  // namespace
+
+void WorkerPoolController::Register(std::string name, FactoryT factory) {
+  mutex_lock l(*get_lock());
+  if (!worker_pool_controller_factories().insert({name, factory}).second) {
+    LOG(ERROR)
+        << "Two worker pool controller factories are being registered with "
+        << "name " << name << ". Which one gets used is undefined.";
+  }
+}
+
+Status WorkerPoolController::Build(std::string name,
+                                   const experimental::DispatcherConfig& config,
+                                   std::unique_ptr<WorkerPoolController>* out) {
+  mutex_lock l(*get_lock());
+  auto it = worker_pool_controller_factories().find(name);
+  if (it != worker_pool_controller_factories().end()) {
+    return it->second(config, out);
+  }
+
+  std::vector<std::string> available_names;
+  for (const auto& factory : worker_pool_controller_factories()) {
+    available_names.push_back(factory.first);
+  }
+
+  return errors::NotFound(
+      "No worker pool controller factory has been registered for name ", name,
+      ". The available names are: [ ", absl::StrJoin(available_names, ", "),
+      " ]");
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,66 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_WORKER_POOL_CONTROLLER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_WORKER_POOL_CONTROLLER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+namespace tensorflow {
+namespace data {
+
+// Resizes the pool of tf.data service workers, e.g. by asking a cluster
+// manager to start or drain workers. The dispatcher asks the controller named
+// by `DispatcherConfig.worker_pool_controller` to resize the pool whenever the
+// `MultipleIterationsAutoScaler` estimate of the optimal number of workers
+// changes.
+class WorkerPoolController {
+ public:
+  using FactoryT =
+      std::function<Status(const experimental::DispatcherConfig& config,
+                           std::unique_ptr<WorkerPoolController>* out)>;
+  virtual ~WorkerPoolController() = default;
+
+  // Requests that the worker pool be resized to `target_number_of_workers`.
+  // `worker_addresses` are the addresses of the currently registered workers,
+  // from which the controller picks which workers to drain when shrinking the
+  // pool. Drained workers stop heartbeating, and the dispatcher handles them
+  // like any other missing worker.
+  //
+  // This is called from the dispatcher's maintenance thread while holding the
+  // dispatcher lock, so it must not block on the cluster manager.
+  virtual Status ResizeWorkerPool(
+      int64_t target_number_of_workers,
+      const std::vector<std::string>& worker_addresses) = 0;
+
+  // Registers a WorkerPoolController factory under `name`.
+  static void Register(std::string name, FactoryT factory);
+
+  // Builds a WorkerPoolController from the factory registered under `name`.
+  static Status Build(std::string name,
+                      const experimental::DispatcherConfig& config,
+                      std::unique_ptr<WorkerPoolController>* out);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_WORKER_POOL_CONTROLLER_H_
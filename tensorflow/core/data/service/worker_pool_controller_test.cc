@@ -0,0 +1,176 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/worker_pool_controller.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/dispatcher.pb.h"
+#include "tensorflow/core/data/service/dispatcher_impl.h"
+#include "tensorflow/core/data/service/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/status_matchers.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/error_codes.pb.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tensorflow::testing::StatusIs;
+using ::testing::ElementsAre;
+
+constexpr char kWorkerAddress[] = "localhost:20000";
+
+class TestWorkerPoolController : public WorkerPoolController {
+ public:
+  explicit TestWorkerPoolController(int64_t* target_number_of_workers)
+      : target_number_of_workers_(target_number_of_workers) {}
+
+  Status ResizeWorkerPool(
+      int64_t target_number_of_workers,
+      const std::vector<std::string>& worker_addresses) override {
+    *target_number_of_workers_ = target_number_of_workers;
+    return absl::OkStatus();
+  }
+
+ private:
+  int64_t* const target_number_of_workers_;
+};
+
+TEST(WorkerPoolControllerTest, RegisterAndBuild) {
+  int64_t target_number_of_workers = 0;
+  WorkerPoolController::Register(
+      "test", [&target_number_of_workers](
+                  const experimental::DispatcherConfig& config,
+                  std::unique_ptr<WorkerPoolController>* out) {
+        *out = std::make_unique<TestWorkerPoolController>(
+            &target_number_of_workers);
+        return absl::OkStatus();
+      });
+
+  std::unique_ptr<WorkerPoolController> controller;
+  TF_ASSERT_OK(WorkerPoolController::Build(
+      "test", experimental::DispatcherConfig(), &controller));
+  TF_ASSERT_OK(controller->ResizeWorkerPool(3, {"worker_0", "worker_1"}));
+  EXPECT_EQ(target_number_of_workers, 3);
+}
+
+// Records the last resize request, which the dispatcher sends from its
+// maintenance thread.
+class RecordingWorkerPoolController : public WorkerPoolController {
+ public:
+  struct Request {
+    mutex mu;
+    int64_t target_number_of_workers TF_GUARDED_BY(mu) = 0;
+    std::vector<std::string> worker_addresses TF_GUARDED_BY(mu);
+  };
+
+  explicit RecordingWorkerPoolController(Request* request)
+      : request_(request) {}
+
+  Status ResizeWorkerPool(
+      int64_t target_number_of_workers,
+      const std::vector<std::string>& worker_addresses) override {
+    mutex_lock l(request_->mu);
+    request_->target_number_of_workers = target_number_of_workers;
+    request_->worker_addresses = worker_addresses;
+    return absl::OkStatus();
+  }
+
+ private:
+  Request* const request_;
+};
+
+TEST(WorkerPoolControllerTest, DispatcherResizesWorkerPool) {
+  RecordingWorkerPoolController::Request request;
+  WorkerPoolController::Register(
+      "recording", [&request](const experimental::DispatcherConfig& config,
+                              std::unique_ptr<WorkerPoolController>* out) {
+        *out = std::make_unique<RecordingWorkerPoolController>(&request);
+        return absl::OkStatus();
+      });
+  experimental::DispatcherConfig config;
+  config.set_protocol("grpc");
+  config.set_job_gc_check_interval_ms(10);
+  config.set_worker_pool_controller("recording");
+  DataServiceDispatcherImpl dispatcher(config);
+  TF_ASSERT_OK(dispatcher.Start());
+
+  WorkerHeartbeatRequest worker_heartbeat;
+  worker_heartbeat.set_worker_address(kWorkerAddress);
+  WorkerHeartbeatResponse worker_response;
+  TF_ASSERT_OK(dispatcher.WorkerHeartbeat(&worker_heartbeat, &worker_response));
+
+  GetOrRegisterDatasetRequest dataset_request;
+  *dataset_request.mutable_dataset() = testing::RangeDataset(10);
+  GetOrRegisterDatasetResponse dataset_response;
+  TF_ASSERT_OK(
+      dispatcher.GetOrRegisterDataset(&dataset_request, &dataset_response));
+  GetOrCreateJobRequest job_request;
+  job_request.set_dataset_id(dataset_response.dataset_id());
+  job_request.mutable_processing_mode_def()->set_sharding_policy(
+      ProcessingModeDef::OFF);
+  GetOrCreateJobResponse job_response;
+  TF_ASSERT_OK(dispatcher.GetOrCreateJob(&job_request, &job_response));
+  GetOrCreateIterationRequest iteration_request;
+  iteration_request.set_job_id(job_response.job_id());
+  GetOrCreateIterationResponse iteration_response;
+  TF_ASSERT_OK(dispatcher.GetOrCreateIteration(&iteration_request,
+                                               &iteration_response));
+
+  // The client consumes an element every microsecond, and the only worker
+  // produces one every 100 microseconds.
+  ClientHeartbeatRequest client_heartbeat;
+  client_heartbeat.set_iteration_client_id(
+      iteration_response.iteration_client_id());
+  client_heartbeat.set_target_processing_time_nsec(1000);
+  ClientHeartbeatResponse client_response;
+  TF_ASSERT_OK(dispatcher.ClientHeartbeat(&client_heartbeat, &client_response));
+  ASSERT_EQ(client_response.task_info_size(), 1);
+  const int64_t task_id = client_response.task_info(0).task_id();
+  worker_heartbeat.add_current_tasks(task_id);
+  ActiveTask* active_task = worker_heartbeat.add_active_tasks();
+  active_task->set_task_id(task_id);
+  active_task->set_processing_time_nsec(100000);
+  TF_ASSERT_OK(dispatcher.WorkerHeartbeat(&worker_heartbeat, &worker_response));
+
+  // The estimate of 100 workers is bounded to 4 times the current pool.
+  TF_ASSERT_OK(testing::WaitWhile([&request]() -> absl::StatusOr<bool> {
+    mutex_lock l(request.mu);
+    return request.target_number_of_workers == 0;
+  }));
+  mutex_lock l(request.mu);
+  EXPECT_EQ(request.target_number_of_workers, 4);
+  EXPECT_THAT(request.worker_addresses, ElementsAre(kWorkerAddress));
+}
+
+TEST(WorkerPoolControllerTest, BuildUnregisteredController) {
+  std::unique_ptr<WorkerPoolController> controller;
+  EXPECT_THAT(WorkerPoolController::Build(
+                  "unregistered", experimental::DispatcherConfig(), &controller),
+              StatusIs(error::NOT_FOUND));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
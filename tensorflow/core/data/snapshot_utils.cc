@@ -29,6 +29,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/read_ahead_file.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -739,15 +740,21 @@ void Reader::MakeNestedDataset(const std::vector<DatasetBase*>& datasets,
 
 TFRecordReaderImpl::TFRecordReaderImpl(
     const std::string& filename, const string& compression,
-    std::optional<int64_t> output_buffer_size)
+    std::optional<int64_t> output_buffer_size, int read_ahead_blocks)
     : filename_(filename),
       offset_(0),
       bytes_read_(0),
       compression_(compression),
-      output_buffer_size_(output_buffer_size) {}
+      output_buffer_size_(output_buffer_size),
+      read_ahead_blocks_(read_ahead_blocks) {}
 
 Status TFRecordReaderImpl::Initialize(Env* env) {
   TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename_, &file_));
+  if (read_ahead_blocks_ > 0) {
+    file_ = std::make_unique<ReadAheadFile>(
+        std::move(file_), kReadAheadBlockSizeBytes, read_ahead_blocks_,
+        ReadAheadFile::SharedThreadPool());
+  }
   auto options = io::RecordReaderOptions::CreateRecordReaderOptions(
       /*compression_type=*/compression_);
 #if !defined(IS_SLIM_BUILD)
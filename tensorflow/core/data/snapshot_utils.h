@@ -248,14 +248,19 @@ class Reader {
 
 class TFRecordReaderImpl {
  public:
+  static constexpr int64_t kReadAheadBlockSizeBytes = 4 << 20;  // 4MB
+
   // Constructs a `TFRecordReaderImpl`.
   // `filename` is the file to read from.
   // `compression_type` is the compression method, as defined in
   // tensorflow/tsl/lib/io/compression.h.
   // `output_buffer_size` specifies the buffer size required by Snappy/Zlib
   // compression algorithms. Ignored if compression is not enabled.
+  // If `read_ahead_blocks` is positive, up to that many blocks of
+  // `kReadAheadBlockSizeBytes` are read ahead of the reader in the background.
   TFRecordReaderImpl(const std::string& filename, const string& compression,
-                     std::optional<int64_t> output_buffer_size = std::nullopt);
+                     std::optional<int64_t> output_buffer_size = std::nullopt,
+                     int read_ahead_blocks = 0);
 
   // Initializes the reader. Callers must initialize the reader before calling
   // `GetNext` or `GetTensors`.
@@ -282,6 +287,7 @@ class TFRecordReaderImpl {
 
   const string compression_;
   const std::optional<int64_t> output_buffer_size_;
+  const int read_ahead_blocks_;
 };
 
 // Reads snapshots previously written with `TFRecordWriter`.
@@ -289,8 +295,10 @@ class TFRecordReader : public Reader {
  public:
   TFRecordReader(const std::string& filename, const string& compression,
                  const DataTypeVector& dtypes,
-                 std::optional<int64_t> output_buffer_size = std::nullopt)
-      : reader_impl_(filename, compression, output_buffer_size),
+                 std::optional<int64_t> output_buffer_size = std::nullopt,
+                 int read_ahead_blocks = 0)
+      : reader_impl_(filename, compression, output_buffer_size,
+                     read_ahead_blocks),
         dtypes_(dtypes) {}
 
   // Initializes the reader. Callers must initialize the reader before calling
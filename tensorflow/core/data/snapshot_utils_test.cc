@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/data/snapshot_utils.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -24,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/compression.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -99,6 +101,43 @@ TEST(SnapshotUtilTest, CombinationRoundTripTest) {
   SnapshotRoundTrip(io::compression::kSnappy, 2);
 }
 
+TEST(SnapshotUtilTest, TFRecordReaderReadAhead) {
+  std::vector<Tensor> tensors;
+  tensorflow::DataTypeVector dtypes;
+  GenerateTensorVector(dtypes, tensors);
+
+  for (const std::string& compression_type :
+       {io::compression::kNone, io::compression::kGzip,
+        io::compression::kSnappy}) {
+    std::string filename;
+    EXPECT_TRUE(Env::Default()->LocalTempFilename(&filename));
+    std::unique_ptr<Writer> writer;
+    TF_ASSERT_OK(Writer::Create(Env::Default(), filename, compression_type,
+                                /*version=*/2, dtypes, &writer));
+    for (int i = 0; i < 100; ++i) {
+      TF_ASSERT_OK(writer->WriteTensors(tensors));
+    }
+    TF_ASSERT_OK(writer->Close());
+
+    TFRecordReader reader(filename, compression_type, dtypes,
+                          /*output_buffer_size=*/std::nullopt,
+                          /*read_ahead_blocks=*/2);
+    TF_ASSERT_OK(reader.Initialize(Env::Default()));
+    for (int i = 0; i < 100; ++i) {
+      std::vector<Tensor> read_tensors;
+      TF_ASSERT_OK(reader.ReadTensors(&read_tensors));
+      ASSERT_EQ(read_tensors.size(), tensors.size());
+      for (int j = 0; j < read_tensors.size(); ++j) {
+        EXPECT_EQ(read_tensors[j].scalar<tstring>()(),
+                  tensors[j].scalar<tstring>()());
+      }
+    }
+    std::vector<Tensor> read_tensors;
+    EXPECT_TRUE(errors::IsOutOfRange(reader.ReadTensors(&read_tensors)));
+    TF_ASSERT_OK(Env::Default()->DeleteFile(filename));
+  }
+}
+
 TEST(SnapshotUtilTest, MetadataFileRoundTrip) {
   experimental::DistributedSnapshotMetadata metadata_in;
   metadata_in.set_compression(io::compression::kGzip);
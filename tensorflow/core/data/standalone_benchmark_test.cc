@@ -0,0 +1,259 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks of the per-element overhead of tf.data transformations.
+//
+// Each benchmark iteration produces one element of an infinite input pipeline
+// through `standalone::Iterator::GetNext`, so the reported time per iteration
+// is the per-element latency and the items per second are the elements per
+// second of the pipeline.
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace data {
+namespace standalone {
+namespace {
+
+// Builds the graph of an input pipeline one transformation at a time.
+class PipelineBuilder {
+ public:
+  // Starts the pipeline with `range(0, int64 max)`.
+  PipelineBuilder() : output_types_({DT_INT64}), output_shapes_({{}}) {
+    dataset_ = AddNode(NodeDefBuilder(NewName("RangeDataset"), "RangeDataset")
+                           .Input(Const(test::AsScalar<int64_t>(0)))
+                           .Input(Const(test::AsScalar<int64_t>(
+                               std::numeric_limits<int64_t>::max())))
+                           .Input(Const(test::AsScalar<int64_t>(1))));
+  }
+
+  // Starts the pipeline with `tensor` repeated forever.
+  explicit PipelineBuilder(const Tensor& tensor)
+      : output_types_({tensor.dtype()}), output_shapes_({tensor.shape()}) {
+    dataset_ = AddNode(
+        NodeDefBuilder(NewName("TensorDataset"), "TensorDataset")
+            .Input(std::vector<NodeDefBuilder::NodeOut>{Const(tensor)}));
+    Repeat();
+  }
+
+  PipelineBuilder& Repeat() {
+    dataset_ = AddNode(NodeDefBuilder(NewName("RepeatDataset"), "RepeatDataset")
+                           .Input(dataset_)
+                           .Input(Const(test::AsScalar<int64_t>(-1))));
+    return *this;
+  }
+
+  // Multiplies the int64 elements by two, in parallel if `num_parallel_calls`
+  // is positive.
+  PipelineBuilder& Map(int64_t num_parallel_calls) {
+    AddFunction(test::function::XTimesTwo());
+    NameAttrList func;
+    func.set_name("XTimesTwo");
+    (*func.mutable_attr())["T"].set_type(DT_INT64);
+    NodeDefBuilder builder =
+        num_parallel_calls > 0
+            ? NodeDefBuilder(NewName("ParallelMapDatasetV2"),
+                             "ParallelMapDatasetV2")
+            : NodeDefBuilder(NewName("MapDataset"), "MapDataset");
+    builder.Input(dataset_).Input(std::vector<NodeDefBuilder::NodeOut>{});
+    if (num_parallel_calls > 0) {
+      builder.Input(Const(test::AsScalar<int64_t>(num_parallel_calls)));
+    }
+    dataset_ = AddNode(builder.Attr("f", func));
+    return *this;
+  }
+
+  // Interleaves `range(x, int64 max)` for each int64 element `x`.
+  PipelineBuilder& Interleave(int64_t cycle_length) {
+    AddFunction(test::function::MakeRangeDataset());
+    NameAttrList func;
+    func.set_name("MakeRangeDataset");
+    SetAttrValue(output_types_, &(*func.mutable_attr())["output_types"]);
+    SetAttrValue(output_shapes_, &(*func.mutable_attr())["output_shapes"]);
+    dataset_ = AddNode(
+        NodeDefBuilder(NewName("InterleaveDataset"), "InterleaveDataset")
+            .Input(dataset_)
+            .Input(std::vector<NodeDefBuilder::NodeOut>{
+                Const(test::AsScalar<int64_t>(
+                    std::numeric_limits<int64_t>::max())),
+                Const(test::AsScalar<int64_t>(1))})
+            .Input(Const(test::AsScalar<int64_t>(cycle_length)))
+            .Input(Const(test::AsScalar<int64_t>(1)))
+            .Attr("f", func));
+    return *this;
+  }
+
+  PipelineBuilder& Batch(int64_t batch_size) {
+    output_shapes_[0] =
+        PartialTensorShape({batch_size}).Concatenate(output_shapes_[0]);
+    dataset_ = AddNode(NodeDefBuilder(NewName("BatchDatasetV2"),
+                                      "BatchDatasetV2")
+                           .Input(dataset_)
+                           .Input(Const(test::AsScalar<int64_t>(batch_size)))
+                           .Input(Const(test::AsScalar<bool>(true))));
+    return *this;
+  }
+
+  PipelineBuilder& Prefetch(int64_t buffer_size) {
+    dataset_ = AddNode(
+        NodeDefBuilder(NewName("PrefetchDataset"), "PrefetchDataset")
+            .Input(dataset_)
+            .Input(Const(test::AsScalar<int64_t>(buffer_size))));
+    return *this;
+  }
+
+  GraphDef Finish() {
+    NodeDef* retval = graph_def_.add_node();
+    retval->set_name("dataset");
+    retval->set_op("_Retval");
+    retval->add_input(dataset_.node);
+    AddNodeAttr("T", DT_VARIANT, retval);
+    AddNodeAttr("index", 0, retval);
+    return graph_def_;
+  }
+
+ private:
+  std::string NewName(const std::string& op) {
+    return absl::StrCat(op, "/_", graph_def_.node_size());
+  }
+
+  NodeDefBuilder::NodeOut Const(const Tensor& value) {
+    return AddNode(NodeDefBuilder(NewName("Const"), "Const")
+                       .Attr("dtype", value.dtype())
+                       .Attr("value", value),
+                   value.dtype());
+  }
+
+  NodeDefBuilder::NodeOut AddNode(NodeDefBuilder& builder,
+                                  DataType dtype = DT_VARIANT) {
+    if (dtype == DT_VARIANT) {
+      // `TensorDataset` infers its types from its components and does not
+      // declare an `output_types` attr.
+      if (FindAttr("output_types", builder.op_def()) != nullptr) {
+        builder.Attr("output_types", output_types_);
+      }
+      builder.Attr("output_shapes", output_shapes_);
+    }
+    NodeDef* node = graph_def_.add_node();
+    TF_CHECK_OK(builder.Finalize(node));
+    return NodeDefBuilder::NodeOut(node->name(), 0, dtype);
+  }
+
+  void AddFunction(const FunctionDef& function) {
+    for (const FunctionDef& existing : graph_def_.library().function()) {
+      if (existing.signature().name() == function.signature().name()) return;
+    }
+    *graph_def_.mutable_library()->add_function() = function;
+  }
+
+  GraphDef graph_def_;
+  DataTypeVector output_types_;
+  std::vector<PartialTensorShape> output_shapes_;
+  NodeDefBuilder::NodeOut dataset_;
+};
+
+void RunPipeline(const GraphDef& graph_def, benchmark::State& state) {
+  std::unique_ptr<Dataset> dataset;
+  TF_CHECK_OK(Dataset::FromGraph({}, graph_def, &dataset));
+  std::unique_ptr<Iterator> iterator;
+  TF_CHECK_OK(dataset->MakeIterator(&iterator));
+  std::vector<Tensor> outputs;
+  bool end_of_input = false;
+  // Fills any buffers so that their start-up is not measured.
+  TF_CHECK_OK(iterator->GetNext(&outputs, &end_of_input));
+  for (auto _ : state) {
+    TF_CHECK_OK(iterator->GetNext(&outputs, &end_of_input));
+    CHECK(!end_of_input);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Range(benchmark::State& state) {
+  RunPipeline(PipelineBuilder().Finish(), state);
+}
+BENCHMARK(BM_Range)->UseRealTime();
+
+void BM_RepeatTensor(benchmark::State& state) {
+  const int64_t num_floats = state.range(0);
+  Tensor tensor(DT_FLOAT, TensorShape({num_floats}));
+  tensor.flat<float>().setZero();
+  RunPipeline(PipelineBuilder(tensor).Finish(), state);
+  state.SetBytesProcessed(state.iterations() * tensor.TotalBytes());
+}
+BENCHMARK(BM_RepeatTensor)->UseRealTime()->Arg(1)->Arg(1 << 10)->Arg(1 << 20);
+
+void BM_Map(benchmark::State& state) {
+  RunPipeline(PipelineBuilder().Map(/*num_parallel_calls=*/0).Finish(), state);
+}
+BENCHMARK(BM_Map)->UseRealTime();
+
+void BM_ParallelMap(benchmark::State& state) {
+  RunPipeline(PipelineBuilder().Map(state.range(0)).Finish(), state);
+}
+BENCHMARK(BM_ParallelMap)->UseRealTime()->Arg(1)->Arg(4)->Arg(16);
+
+void BM_Interleave(benchmark::State& state) {
+  RunPipeline(PipelineBuilder().Interleave(state.range(0)).Finish(), state);
+}
+BENCHMARK(BM_Interleave)->UseRealTime()->Arg(1)->Arg(4)->Arg(16);
+
+void BM_Batch(benchmark::State& state) {
+  const int64_t batch_size = state.range(0);
+  const int64_t num_floats = state.range(1);
+  Tensor tensor(DT_FLOAT, TensorShape({num_floats}));
+  tensor.flat<float>().setZero();
+  RunPipeline(PipelineBuilder(tensor).Batch(batch_size).Finish(), state);
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_Batch)
+    ->UseRealTime()
+    ->ArgPair(1, 1)
+    ->ArgPair(32, 1)
+    ->ArgPair(32, 1 << 10)
+    ->ArgPair(256, 1 << 10);
+
+void BM_Prefetch(benchmark::State& state) {
+  RunPipeline(PipelineBuilder()
+                  .Map(/*num_parallel_calls=*/0)
+                  .Prefetch(state.range(0))
+                  .Finish(),
+              state);
+}
+BENCHMARK(BM_Prefetch)->UseRealTime()->Arg(1)->Arg(16);
+
+}  // namespace
+}  // namespace standalone
+}  // namespace data
+}  // namespace tensorflow
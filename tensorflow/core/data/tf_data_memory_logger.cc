@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/base/call_once.h"
@@ -35,10 +36,13 @@ namespace data {
 namespace {
 const int64_t kLogFrequencyS = 30;  // How often to log.
 
+const int kNumBottleneckNodes = 3;  // How many of the slowest nodes to log.
+
 struct IteratorMemoryUsage {
   std::optional<std::string> dataset_name;
   int64_t memory_usage;
   std::string model_proto;
+  std::vector<TfDatazMetricsCollector::NodeSnapshot> bottlenecks;
 };
 
 int64_t TotalMemoryUsage(const std::vector<IteratorMemoryUsage>& usages) {
@@ -61,9 +65,14 @@ void LogDatasetMemoryUsage() {
     if (!s.ok()) {
       LOG(ERROR) << "Failed to convert model to proto: " << s;
     }
-    usages.push_back(IteratorMemoryUsage{metric_collector->DatasetName(),
-                                         total_buffered_bytes,
-                                         model_proto.ShortDebugString()});
+    std::vector<TfDatazMetricsCollector::NodeSnapshot> bottlenecks =
+        metric_collector->GetNodeSnapshots();
+    if (bottlenecks.size() > kNumBottleneckNodes) {
+      bottlenecks.resize(kNumBottleneckNodes);
+    }
+    usages.push_back(IteratorMemoryUsage{
+        metric_collector->DatasetName(), total_buffered_bytes,
+        model_proto.ShortDebugString(), std::move(bottlenecks)});
   }
   std::sort(usages.begin(), usages.end(), [](const auto& a, const auto& b) {
     return a.memory_usage > b.memory_usage;
@@ -84,6 +93,15 @@ void LogDatasetMemoryUsage() {
     } else {
       VLOG(4) << "Dataset " << i << " (no name set): " << usage_string;
     }
+    for (const auto& node : usages[i].bottlenecks) {
+      VLOG(4) << "  " << node.name << ": "
+              << node.effective_processing_time_nsec << " ns/element ("
+              << node.self_processing_time_nsec << " ns self time, "
+              << node.parallelism << " parallelism), "
+              << node.input_time_nsec << " ns/element input time, "
+              << node.buffered_elements << "/" << node.buffer_size
+              << " elements buffered";
+    }
     VLOG(5) << "Model proto: " << usages[i].model_proto;
   }
 }
@@ -20,8 +20,11 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/model.h"
@@ -138,6 +141,56 @@ std::shared_ptr<model::Model> TfDatazMetricsCollector::GetModel() {
   return model_;
 }
 
+std::vector<TfDatazMetricsCollector::NodeSnapshot>
+TfDatazMetricsCollector::GetNodeSnapshots() {
+  std::vector<NodeSnapshot> snapshots;
+  if (model_ == nullptr) return snapshots;
+  std::shared_ptr<model::Node> output = model_->output();
+  if (output == nullptr) return snapshots;
+  model::Node::NodeVector nodes = output->CollectNodes(
+      model::TraversalOrder::BFS,
+      [](const std::shared_ptr<model::Node>) { return true; });
+  nodes.insert(nodes.begin(), output);
+
+  // Inputs come after their outputs in BFS order, so the output times of the
+  // inputs of a node are known once it is reached in reverse.
+  absl::flat_hash_map<const model::Node*, double> output_times;
+  for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+    model::Node::NodeValues input_times = {{model::kModelInputTimeKey, 0.0}};
+    output_times[it->get()] = (*it)->OutputTime(&input_times, nullptr);
+  }
+
+  snapshots.reserve(nodes.size());
+  for (const std::shared_ptr<model::Node>& node : nodes) {
+    NodeSnapshot& snapshot = snapshots.emplace_back();
+    snapshot.name = node->long_name();
+    snapshot.self_processing_time_nsec = node->SelfProcessingTime();
+    absl::StatusOr<double> parallelism =
+        node->ParameterValue(model::kParallelism);
+    if (parallelism.ok() && *parallelism >= 1) {
+      snapshot.parallelism = *parallelism;
+    }
+    snapshot.effective_processing_time_nsec =
+        snapshot.self_processing_time_nsec / snapshot.parallelism;
+    snapshot.output_time_nsec = output_times[node.get()];
+    for (const std::shared_ptr<model::Node>& input : node->inputs()) {
+      snapshot.input_time_nsec += output_times[input.get()];
+    }
+    snapshot.num_elements = node->num_elements();
+    snapshot.buffered_elements = node->buffered_elements();
+    snapshot.buffered_bytes = node->buffered_bytes();
+    absl::StatusOr<double> buffer_size =
+        node->ParameterValue(model::kBufferSize);
+    if (buffer_size.ok()) snapshot.buffer_size = *buffer_size;
+  }
+  std::stable_sort(snapshots.begin(), snapshots.end(),
+                   [](const NodeSnapshot& a, const NodeSnapshot& b) {
+                     return a.effective_processing_time_nsec >
+                            b.effective_processing_time_nsec;
+                   });
+  return snapshots;
+}
+
 namespace {
 static mutex* get_tfdataz_metrics_registry_lock() {
   static mutex tfdataz_metrics_registry_lock(LINKER_INITIALIZED);
@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/time/time.h"
@@ -120,6 +121,36 @@ class TfDatazMetricsCollector {
 
   std::shared_ptr<model::Model> GetModel();
 
+  // The observed state of one node of the iterator's model. Times are per
+  // element, in nanoseconds.
+  struct NodeSnapshot {
+    std::string name;
+    // Processing time spent in the node itself, excluding the time spent in
+    // its inputs.
+    double self_processing_time_nsec = 0;
+    // The parallelism of the node, or 1 if it is not parallel.
+    double parallelism = 1;
+    // `self_processing_time_nsec` divided by `parallelism`: the time that the
+    // node adds to each element when all of its workers are busy.
+    double effective_processing_time_nsec = 0;
+    // Estimated time for the subtree rooted in the node to produce an
+    // element, assuming that its consumer is infinitely fast.
+    double output_time_nsec = 0;
+    // Estimated time that the node waits for its inputs to produce the input
+    // elements of an element: the sum of its inputs' output times.
+    double input_time_nsec = 0;
+    int64_t num_elements = 0;
+    int64_t buffered_elements = 0;
+    int64_t buffered_bytes = 0;
+    // The number of elements that the node buffers, or 0 if it has no buffer.
+    double buffer_size = 0;
+  };
+
+  // Returns the nodes of the iterator's model, slowest first by effective
+  // processing time. In an input-bound pipeline, the first node is the stage
+  // to optimize.
+  std::vector<NodeSnapshot> GetNodeSnapshots();
+
  private:
   DatasetBaseIterator* iterator_;  // not owned
   std::shared_ptr<model::Model> model_;
@@ -16,9 +16,11 @@ limitations under the License.
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/util/fake_clock_env.h"
@@ -197,6 +199,84 @@ class ScopedTfDataMetricsRegistration {
   std::shared_ptr<TfDatazMetricsCollector> collector_;
 };
 
+TEST(TfDatazMetricsNodeSnapshotsTest, SlowestNodeFirst) {
+  auto model = std::make_shared<model::Model>();
+  auto factory = [](model::Node::Args args) {
+    return model::MakeSourceNode(std::move(args));
+  };
+  std::shared_ptr<model::Node> prefetch, map;
+  model->AddNode(factory, "Prefetch", nullptr, &prefetch);
+  model->AddNode(factory, "Map", prefetch, &map);
+  for (int i = 0; i < 10; ++i) {
+    prefetch->add_processing_time(100);
+    prefetch->record_element();
+    map->add_processing_time(1000);
+    map->record_element();
+  }
+
+  TfDatazMetricsCollector collector(*Env::Default(), /*iterator=*/nullptr,
+                                    model);
+  std::vector<TfDatazMetricsCollector::NodeSnapshot> snapshots =
+      collector.GetNodeSnapshots();
+  ASSERT_EQ(snapshots.size(), 2);
+  EXPECT_EQ(snapshots[0].name, map->long_name());
+  EXPECT_EQ(snapshots[0].self_processing_time_nsec, 1000);
+  EXPECT_EQ(snapshots[0].num_elements, 10);
+  EXPECT_EQ(snapshots[1].name, prefetch->long_name());
+  EXPECT_EQ(snapshots[1].self_processing_time_nsec, 100);
+}
+
+TEST(TfDatazMetricsNodeSnapshotsTest, RanksByEffectiveProcessingTime) {
+  auto model = std::make_shared<model::Model>();
+  std::shared_ptr<model::Node> parallel_map, filter;
+  model->AddNode(
+      [](model::Node::Args args) {
+        return model::MakeAsyncKnownRatioNode(
+            std::move(args), /*ratio=*/1,
+            {model::MakeNonTunableParameter(model::kParallelism, 8),
+             model::MakeNonTunableParameter(model::kBufferSize, 16)});
+      },
+      "ParallelMap", nullptr, &parallel_map);
+  model->AddNode(
+      [](model::Node::Args args) {
+        return model::MakeSourceNode(std::move(args));
+      },
+      "Filter", parallel_map, &filter);
+  for (int i = 0; i < 10; ++i) {
+    parallel_map->add_processing_time(1600);
+    parallel_map->record_element();
+    filter->add_processing_time(400);
+    filter->record_element();
+  }
+  parallel_map->record_buffer_event(/*bytes_delta=*/64, /*elements_delta=*/4);
+
+  TfDatazMetricsCollector collector(*Env::Default(), /*iterator=*/nullptr,
+                                    model);
+  std::vector<TfDatazMetricsCollector::NodeSnapshot> snapshots =
+      collector.GetNodeSnapshots();
+  ASSERT_EQ(snapshots.size(), 2);
+  // The parallel map is slower per element, but spread over 8 workers.
+  EXPECT_EQ(snapshots[0].name, filter->long_name());
+  EXPECT_EQ(snapshots[0].parallelism, 1);
+  EXPECT_EQ(snapshots[0].effective_processing_time_nsec, 400);
+  EXPECT_EQ(snapshots[0].input_time_nsec, 0);
+  EXPECT_EQ(snapshots[0].buffer_size, 0);
+  EXPECT_EQ(snapshots[1].name, parallel_map->long_name());
+  EXPECT_EQ(snapshots[1].self_processing_time_nsec, 1600);
+  EXPECT_EQ(snapshots[1].parallelism, 8);
+  EXPECT_EQ(snapshots[1].effective_processing_time_nsec, 200);
+  EXPECT_EQ(snapshots[1].input_time_nsec, snapshots[0].output_time_nsec);
+  EXPECT_EQ(snapshots[1].buffered_elements, 4);
+  EXPECT_EQ(snapshots[1].buffered_bytes, 64);
+  EXPECT_EQ(snapshots[1].buffer_size, 16);
+}
+
+TEST(TfDatazMetricsNodeSnapshotsTest, NoModel) {
+  TfDatazMetricsCollector collector(*Env::Default(), /*iterator=*/nullptr,
+                                    /*model=*/nullptr);
+  EXPECT_TRUE(collector.GetNodeSnapshots().empty());
+}
+
 TEST(TfDatazMetricsRegistryTest, Register) {
   std::unique_ptr<DatasetBaseIterator> iterator;
   auto collector_one = std::make_shared<TfDatazMetricsCollector>(
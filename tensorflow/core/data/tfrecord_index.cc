@@ -0,0 +1,107 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tfrecord_index.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kIndexSuffix[] = ".index";
+// Buffer size of the sequential scan of the record headers.
+constexpr int64_t kScanBufferSize = 256 << 10;  // 256KB.
+
+}  // namespace
+
+std::string TFRecordIndexFilename(const std::string& filename) {
+  return absl::StrCat(filename, kIndexSuffix);
+}
+
+Status BuildTFRecordIndex(Env* env, const std::string& filename,
+                          uint64 start_offset, std::vector<uint64>* offsets) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+  io::RecordReaderOptions options;
+  options.buffer_size = kScanBufferSize;
+  io::RecordReader reader(file.get(), options);
+  offsets->clear();
+  uint64 offset = start_offset;
+  while (true) {
+    const uint64 record_offset = offset;
+    int num_skipped = 0;
+    Status s = reader.SkipRecords(&offset, 1, &num_skipped);
+    if (errors::IsOutOfRange(s)) break;
+    TF_RETURN_IF_ERROR(s);
+    offsets->push_back(record_offset);
+  }
+  return absl::OkStatus();
+}
+
+Status ReadTFRecordIndex(Env* env, const std::string& index_filename,
+                         std::vector<uint64>* offsets) {
+  std::string data;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, index_filename, &data));
+  if (data.size() % sizeof(uint64) != 0) {
+    return errors::DataLoss("Corrupted TFRecord index ", index_filename,
+                            ": size ", data.size(), " is not a multiple of ",
+                            sizeof(uint64));
+  }
+  offsets->resize(data.size() / sizeof(uint64));
+  for (size_t i = 0; i < offsets->size(); ++i) {
+    (*offsets)[i] = core::DecodeFixed64(data.data() + i * sizeof(uint64));
+    if (i > 0 && (*offsets)[i] <= (*offsets)[i - 1]) {
+      return errors::DataLoss("Corrupted TFRecord index ", index_filename,
+                              ": offsets are not increasing at record ", i);
+    }
+  }
+  return absl::OkStatus();
+}
+
+Status WriteTFRecordIndex(Env* env, const std::string& index_filename,
+                          const std::vector<uint64>& offsets) {
+  std::string data(offsets.size() * sizeof(uint64), '\0');
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    core::EncodeFixed64(&data[i * sizeof(uint64)], offsets[i]);
+  }
+  return WriteStringToFile(env, index_filename, data);
+}
+
+Status LoadOrBuildTFRecordIndex(Env* env, const std::string& filename,
+                                uint64 start_offset,
+                                std::vector<uint64>* offsets) {
+  const std::string index_filename = TFRecordIndexFilename(filename);
+  if (!env->FileExists(index_filename).ok()) {
+    VLOG(1) << "Building the record index of " << filename;
+    return BuildTFRecordIndex(env, filename, start_offset, offsets);
+  }
+  TF_RETURN_IF_ERROR(ReadTFRecordIndex(env, index_filename, offsets));
+  offsets->erase(offsets->begin(), std::lower_bound(offsets->begin(),
+                                                    offsets->end(),
+                                                    start_offset));
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
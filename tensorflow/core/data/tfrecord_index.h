@@ -0,0 +1,60 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
+#define TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data {
+
+// Record-offset indices of uncompressed TFRecord files.
+//
+// The index of a file holds the byte offset of each of its records, so that
+// the records can be read in any order with positional reads. An index costs
+// 8 bytes per record. It is stored in a sidecar file next to the TFRecord
+// file, as little-endian 64-bit offsets.
+
+// Returns the name of the sidecar index file of `filename`.
+std::string TFRecordIndexFilename(const std::string& filename);
+
+// Scans the record headers of `filename`, starting at `start_offset`, and
+// stores the offset of each record in `offsets`.
+Status BuildTFRecordIndex(Env* env, const std::string& filename,
+                          uint64 start_offset, std::vector<uint64>* offsets);
+
+// Reads the offsets written by `WriteTFRecordIndex` from `index_filename`.
+Status ReadTFRecordIndex(Env* env, const std::string& index_filename,
+                         std::vector<uint64>* offsets);
+
+// Writes `offsets` to `index_filename`.
+Status WriteTFRecordIndex(Env* env, const std::string& index_filename,
+                          const std::vector<uint64>& offsets);
+
+// Reads the offsets of the records of `filename` at or after `start_offset`
+// from its sidecar index if it exists, and builds them otherwise.
+Status LoadOrBuildTFRecordIndex(Env* env, const std::string& filename,
+                                uint64 start_offset,
+                                std::vector<uint64>* offsets);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
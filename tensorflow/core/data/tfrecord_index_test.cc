@@ -0,0 +1,96 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tfrecord_index.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+class TFRecordIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    filename_ = io::JoinPath(testing::TmpDir(), "tfrecord_index");
+    std::unique_ptr<WritableFile> file;
+    TF_ASSERT_OK(Env::Default()->NewWritableFile(filename_, &file));
+    io::RecordWriter writer(file.get());
+    for (const std::string& record : records_) {
+      TF_ASSERT_OK(writer.WriteRecord(record));
+    }
+    TF_ASSERT_OK(writer.Close());
+    TF_ASSERT_OK(file->Close());
+    Env::Default()->DeleteFile(TFRecordIndexFilename(filename_)).IgnoreError();
+  }
+
+  // Reads the record at `offset` of the test file.
+  std::string ReadAt(uint64 offset) {
+    std::unique_ptr<RandomAccessFile> file;
+    TF_CHECK_OK(Env::Default()->NewRandomAccessFile(filename_, &file));
+    io::RecordReader reader(file.get());
+    tstring record;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    return record;
+  }
+
+  const std::vector<std::string> records_ = {"a", "bb", "", "dddd"};
+  std::string filename_;
+};
+
+TEST_F(TFRecordIndexTest, BuildsOffsetsOfRecords) {
+  std::vector<uint64> offsets;
+  TF_ASSERT_OK(BuildTFRecordIndex(Env::Default(), filename_,
+                                  /*start_offset=*/0, &offsets));
+  ASSERT_EQ(offsets.size(), records_.size());
+  // Read the records backwards.
+  for (int i = records_.size() - 1; i >= 0; --i) {
+    EXPECT_EQ(ReadAt(offsets[i]), records_[i]);
+  }
+}
+
+TEST_F(TFRecordIndexTest, LoadsSidecarIndex) {
+  std::vector<uint64> offsets;
+  TF_ASSERT_OK(BuildTFRecordIndex(Env::Default(), filename_,
+                                  /*start_offset=*/0, &offsets));
+  TF_ASSERT_OK(WriteTFRecordIndex(Env::Default(),
+                                  TFRecordIndexFilename(filename_), offsets));
+  std::vector<uint64> loaded;
+  TF_ASSERT_OK(LoadOrBuildTFRecordIndex(Env::Default(), filename_,
+                                        /*start_offset=*/offsets[2],
+                                        &loaded));
+  EXPECT_EQ(loaded, std::vector<uint64>(offsets.begin() + 2, offsets.end()));
+}
+
+TEST_F(TFRecordIndexTest, RejectsCorruptedSidecarIndex) {
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(),
+                                 TFRecordIndexFilename(filename_), "abc"));
+  std::vector<uint64> offsets;
+  EXPECT_TRUE(errors::IsDataLoss(LoadOrBuildTFRecordIndex(
+      Env::Default(), filename_, /*start_offset=*/0, &offsets)));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -223,7 +223,8 @@ Status GrpcServer::Init(const GrpcServerOptions& opts) {
   worker_env_.experimental_num_shards = master_env_.experimental_num_shards;
 
   worker_env_.rendezvous_mgr = opts.rendezvous_mgr_func == nullptr
-                                   ? new RpcRendezvousMgr(&worker_env_)
+                                   ? new RpcRendezvousMgr(&worker_env_,
+                                                          config.rpc_options())
                                    : opts.rendezvous_mgr_func(&worker_env_);
   string unused;
   string default_worker_name;
@@ -74,6 +74,21 @@ struct GrpcServerOptions {
   DeviceMgr* local_device_mgr = nullptr;
 };
 
+// GrpcServer is also the base for transports that keep gRPC as the control
+// plane but move tensor data over another fabric (e.g. RDMA). Such a
+// transport subclasses GrpcServer and registers a `ServerFactory` for its own
+// protocol (e.g. "grpc+verbs"). It then overrides:
+//
+//  * `Init()`, passing a `GrpcServerOptions::rendezvous_mgr_func` whose
+//    rendezvous issues one-sided reads for large tensors and falls back to
+//    `WorkerInterface::RecvTensorAsync` otherwise;
+//  * `ExtraServices()`, to bring up the service that exchanges memory region
+//    descriptors with peers;
+//  * `WorkerCacheFactory()`, to wrap the `GrpcWorkerCache` (for example with
+//    a `WorkerCacheWrapper`) so that workers expose the transport.
+//
+// The transport's data plane, and its dependency on the NIC library, live
+// outside of this target.
 class GrpcServer : public ServerInterface {
  protected:
   GrpcServer(const ServerDef& server_def, Env* env);
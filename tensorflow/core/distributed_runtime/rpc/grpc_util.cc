@@ -15,10 +15,63 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 
+#include <utility>
+#include <vector>
+
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 
 namespace tensorflow {
 
+namespace {
+
+// A TensorBuffer pointing into a received gRPC slice, which it keeps alive.
+class GrpcSliceBuffer : public TensorBuffer {
+ public:
+  GrpcSliceBuffer(::grpc::Slice slice, const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        slice_(std::move(slice)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(static_cast<int64_t>(size_));
+    proto->set_allocator_name("GrpcSlice");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // The slice may be shared with gRPC, so it must not be written in place.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const ::grpc::Slice slice_;
+  const size_t size_;
+};
+
+}  // namespace
+
+core::RefCountPtr<TensorBuffer> GrpcByteSource::ShareContents(
+    const char* data, size_t num_bytes) {
+  // The reader yields the slices of an uncompressed buffer as they are, so
+  // `data` is found in one of them. Otherwise (e.g. for a compressed
+  // buffer), no slice matches and the contents are copied.
+  std::vector<::grpc::Slice> slices;
+  if (!buffer_->Dump(&slices).ok()) return nullptr;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(data);
+  for (::grpc::Slice& slice : slices) {
+    const uintptr_t slice_begin = reinterpret_cast<uintptr_t>(slice.begin());
+    if (begin >= slice_begin &&
+        begin + num_bytes <= slice_begin + slice.size()) {
+      return core::RefCountPtr<TensorBuffer>(
+          new GrpcSliceBuffer(std::move(slice), data, num_bytes));
+    }
+  }
+  return nullptr;
+}
+
 bool GrpcMaybeParseTensorResponse(::grpc::ByteBuffer* src,
                                   TensorResponse* dst) {
   ::tensorflow::GrpcByteSource byte_source(src);
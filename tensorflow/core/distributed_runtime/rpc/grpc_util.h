@@ -50,6 +50,11 @@ class GrpcByteSource : public TensorResponse::Source {
     return stream_;
   }
 
+  // Shares `data` if it lies within a single slice of the buffer, by
+  // keeping a reference to that slice.
+  core::RefCountPtr<TensorBuffer> ShareContents(const char* data,
+                                                size_t num_bytes) override;
+
  private:
   void DeleteStream() {
     if (stream_) {
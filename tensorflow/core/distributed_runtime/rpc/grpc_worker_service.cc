@@ -23,6 +23,7 @@ limitations under the License.
 #include "grpcpp/alarm.h"
 #include "grpcpp/server_builder.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/common_runtime/buf_rendezvous.h"
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device.h"
@@ -37,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
 #include "tensorflow/core/distributed_runtime/rpc/rpc_response_cache.h"
+#include "tensorflow/core/distributed_runtime/tensor_wire_codec.h"
 #include "tensorflow/core/distributed_runtime/worker.h"
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_session.h"
@@ -148,6 +150,7 @@ class GrpcWorkerServiceThread {
     SETUP_FOR_REQUEST(RunGraph, 100, true);
     SETUP_FOR_REQUEST(CleanupGraph, 100, false);
     SETUP_FOR_REQUEST(MarkRecvFinished, 10, false);
+    SETUP_FOR_REQUEST(RecvTensors, 100, true);
 
     // TODO(ncteisen): Determine a better policy for enqueuing the
     // appropriate number of each request type.
@@ -284,6 +287,25 @@ class GrpcWorkerServiceThread {
     EnqueueRecvTensorRequestRaw();
   }
 
+  void RecvTensorsHandler(
+      WorkerCall<RecvTensorsRequest, RecvTensorsResponse>* call) {
+    Schedule([this, call]() {
+      CallOptions* call_opts = new CallOptions;
+      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+      worker_->RecvTensorsAsync(
+          call_opts, &call->request, &call->response,
+          [call, call_opts](const Status& s) {
+            call->ClearCancelCallback();
+            delete call_opts;
+            if (!s.ok()) {
+              VLOG(3) << "Bad response from RecvTensors:" << s;
+            }
+            call->SendResponse(ToGrpcStatus(s));
+          });
+    });
+    ENQUEUE_REQUEST(RecvTensors, true);
+  }
+
   void RecvBufHandler(WorkerCall<RecvBufRequest, RecvBufResponse>* call) {
     Schedule([this, call]() {
       CallOptions* call_opts = new CallOptions;
@@ -434,6 +456,44 @@ void GrpcWorker::EnableResponseCache() {
   response_cache_ = std::make_unique<RpcResponseCache>();
 }
 
+namespace {
+// Calls `done` with `val`, after copying it to host memory if it was produced
+// on an accelerator of `src_dev`, so that it can be returned on the wire.
+void CopyRecvTensorToHostIfNeeded(
+    Device* src_dev, const Rendezvous::Args& send_args, const Tensor& val,
+    bool is_dead, int64_t step_id, const string& key,
+    std::function<void(const Tensor&, bool, const Status&)> done) {
+  const bool on_host = send_args.alloc_attrs.on_host();
+  if (!src_dev->tensorflow_accelerator_device_info() || on_host) {
+    done(val, is_dead, absl::OkStatus());
+    return;
+  }
+
+  DeviceContext* send_dev_context = send_args.device_context;
+  AllocatorAttributes alloc_attrs;
+  alloc_attrs.set_gpu_compatible(true);
+  alloc_attrs.set_on_host(true);
+  profiler::ScopedMemoryDebugAnnotation op_annotation(
+      "GrpcWorker::RecvTensorAsync::consumer_callback", step_id, "dynamic",
+      val.dtype(), [shape = val.shape()]() { return shape.DebugString(); });
+  Allocator* alloc = src_dev->GetAllocator(alloc_attrs);
+  Tensor* copy = new Tensor(alloc, val.dtype(), val.shape());
+  CHECK(send_dev_context)
+      << "send dev name: " << src_dev->name()
+      << " gpu_info: " << src_dev->tensorflow_accelerator_device_info();
+
+  StatusCallback copy_ready = [done = std::move(done), copy,
+                               is_dead](const Status& s) {
+    // The value is now ready to be returned on the wire.
+    done(*copy, is_dead, s);
+    delete copy;
+  };
+
+  CopyDeviceToHost(&val, alloc, alloc, key, src_dev, copy, send_dev_context,
+                   copy_ready);
+}
+}  // namespace
+
 // GrpcRecvTensorAsync: unlike the other Worker methods, which use protocol
 // buffers for a response object, to avoid extra protocol buffer serialization
 // overhead we generate our response directly into a ::grpc::ByteBuffer object
@@ -447,11 +507,33 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
 
   bool cache_enabled = (response_cache_ != nullptr && request_id != 0);
 
-  auto do_response = [response, done, cache_enabled](const Tensor& tensor,
-                                                     bool is_dead,
-                                                     const Status& status) {
+  const TensorWireCodec* codec = nullptr;
+  if (!request->wire_codec().empty()) {
+    codec = TensorWireCodecRegistry::Lookup(request->wire_codec());
+    if (codec == nullptr) {
+      done(errors::Unimplemented("Unknown tensor wire codec: ",
+                                 request->wire_codec()));
+      return;
+    }
+  }
+
+  auto do_response = [this, response, done, cache_enabled, codec,
+                      codec_name = request->wire_codec()](
+                         const Tensor& tensor, bool is_dead,
+                         const Status& status) {
     if (status.ok()) {
-      grpc::EncodeTensorToByteBuffer(is_dead, tensor, cache_enabled, response);
+      RecvTensorResponse proto;
+      if (codec != nullptr && !is_dead &&
+          codec->Encode(tensor, proto.mutable_tensor())) {
+        proto.set_is_dead(is_dead);
+        proto.set_send_start_micros(env_->env->NowMicros());
+        proto.set_require_ack(cache_enabled);
+        proto.set_wire_codec(codec_name);
+        grpc::EncodeRecvTensorResponseToByteBuffer(proto, response);
+      } else {
+        grpc::EncodeTensorToByteBuffer(is_dead, tensor, cache_enabled,
+                                       response);
+      }
     }
     done(status);
   };
@@ -522,36 +604,146 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
         if (!status.ok()) {
           return rendezvous_done(val, is_dead, status);
         }
+        CopyRecvTensorToHostIfNeeded(src_dev, send_args, val, is_dead,
+                                     request->step_id(),
+                                     request->rendezvous_key(),
+                                     rendezvous_done);
+      });
+}
 
-        const bool on_host = send_args.alloc_attrs.on_host();
-        if (!src_dev->tensorflow_accelerator_device_info() || on_host) {
-          return rendezvous_done(val, is_dead, status);
-        }
+void GrpcWorker::RecvTensorsAsync(CallOptions* opts,
+                                  const RecvTensorsRequest* request,
+                                  RecvTensorsResponse* response,
+                                  StatusCallback done) {
+  VLOG(3) << "RecvTensorsAsync req: " << request->DebugString();
+  const int64_t step_id = request->step_id();
+  const int num_keys = request->rendezvous_key_size();
 
-        DeviceContext* send_dev_context = send_args.device_context;
-        AllocatorAttributes alloc_attrs;
-        alloc_attrs.set_gpu_compatible(true);
-        alloc_attrs.set_on_host(true);
-        profiler::ScopedMemoryDebugAnnotation op_annotation(
-            "GrpcWorker::RecvTensorAsync::consumer_callback",
-            request->step_id(), "dynamic", val.dtype(),
-            [shape = val.shape()]() { return shape.DebugString(); });
-        Allocator* alloc = src_dev->GetAllocator(alloc_attrs);
-        Tensor* copy = new Tensor(alloc, val.dtype(), val.shape());
-        CHECK(send_dev_context)
-            << "send dev name: " << src_dev->name()
-            << " gpu_info: " << src_dev->tensorflow_accelerator_device_info();
-
-        StatusCallback copy_ready = [rendezvous_done, copy,
-                                     is_dead](const Status& s) {
-          // The value is now ready to be returned on the wire.
-          rendezvous_done(*copy, is_dead, s);
-          delete copy;
-        };
-
-        CopyDeviceToHost(&val, alloc, alloc, request->rendezvous_key(), src_dev,
-                         copy, send_dev_context, copy_ready);
-      });
+  Status s = recent_request_ids_.TrackUnique(
+      request->request_id(), "RecvTensors (GrpcWorker)", *request);
+  std::vector<Rendezvous::ParsedKey> parsed(num_keys);
+  std::vector<Device*> src_devs(num_keys, nullptr);
+  for (int i = 0; s.ok() && i < num_keys; ++i) {
+    TRACEPRINTF("RecvTensors: %lld %s", step_id,
+                request->rendezvous_key(i).c_str());
+    s = Rendezvous::ParseKey(request->rendezvous_key(i), &parsed[i]);
+    if (s.ok()) {
+      s = PrepareRecvTensor(parsed[i], &src_devs[i]);
+    }
+  }
+  if (!s.ok() || num_keys == 0) {
+    done(s);
+    return;
+  }
+
+  // See GrpcRecvTensorAsync() for why cancellation aborts the step.
+  opts->SetCancelCallback([this, step_id]() {
+    LOG(WARNING) << "RecvTensors cancelled for " << step_id;
+    AbortStep(step_id);
+  });
+
+  // Registers the request as the waiter of each of its keys, and starts
+  // receiving the keys that an earlier request has not started receiving.
+  auto waiter = std::make_shared<RecvTensorsWaiter>();
+  waiter->opts = opts;
+  waiter->request = request;
+  waiter->response = response;
+  waiter->done = std::move(done);
+  std::vector<int> keys_to_recv;
+  {
+    mutex_lock l(pending_recvs_mu_);
+    for (int i = 0; i < num_keys; ++i) {
+      std::shared_ptr<PendingRecvTensor>& pending =
+          pending_recvs_[{step_id, request->rendezvous_key(i)}];
+      if (pending == nullptr) {
+        pending = std::make_shared<PendingRecvTensor>();
+        keys_to_recv.push_back(i);
+      }
+      pending->waiter = waiter;
+    }
+  }
+  for (int i : keys_to_recv) {
+    env_->rendezvous_mgr->RecvLocalAsync(
+        step_id, parsed[i],
+        [this, step_id, src_dev = src_devs[i],
+         key = request->rendezvous_key(i)](
+            const Status& status, const Rendezvous::Args& send_args,
+            const Rendezvous::Args& recv_args, const Tensor& val,
+            const bool is_dead) {
+          if (!status.ok()) {
+            return PendingRecvTensorDone(step_id, key, val, is_dead, status);
+          }
+          CopyRecvTensorToHostIfNeeded(
+              src_dev, send_args, val, is_dead, step_id, key,
+              [this, step_id, key](const Tensor& tensor, bool is_dead,
+                                   const Status& s) {
+                PendingRecvTensorDone(step_id, key, tensor, is_dead, s);
+              });
+        });
+  }
+  // Keys that are ready already are only returned now, so that all of them
+  // are returned together.
+  {
+    mutex_lock l(pending_recvs_mu_);
+    waiter->armed = true;
+  }
+  MaybeSendRecvTensorsResponse(waiter);
+}
+
+void GrpcWorker::PendingRecvTensorDone(int64_t step_id, const string& key,
+                                       const Tensor& tensor, bool is_dead,
+                                       const Status& status) {
+  std::shared_ptr<RecvTensorsWaiter> waiter;
+  {
+    mutex_lock l(pending_recvs_mu_);
+    auto it = pending_recvs_.find({step_id, key});
+    if (it == pending_recvs_.end()) {
+      // The step has been cleaned up.
+      return;
+    }
+    PendingRecvTensor* pending = it->second.get();
+    pending->ready = true;
+    pending->status = status;
+    if (status.ok()) {
+      pending->response.set_is_dead(is_dead);
+      pending->response.set_send_start_micros(env_->env->NowMicros());
+      tensor.AsProtoTensorContent(pending->response.mutable_tensor());
+    }
+    waiter = pending->waiter;
+  }
+  if (waiter != nullptr) {
+    MaybeSendRecvTensorsResponse(waiter);
+  }
+}
+
+void GrpcWorker::MaybeSendRecvTensorsResponse(
+    const std::shared_ptr<RecvTensorsWaiter>& waiter) {
+  const RecvTensorsRequest* request = waiter->request;
+  Status s;
+  {
+    mutex_lock l(pending_recvs_mu_);
+    if (!waiter->armed || waiter->responded) return;
+    for (int i = 0; i < request->rendezvous_key_size(); ++i) {
+      auto it =
+          pending_recvs_.find({request->step_id(), request->rendezvous_key(i)});
+      if (it == pending_recvs_.end() || !it->second->ready) continue;
+      s.Update(it->second->status);
+      waiter->response->add_response()->Swap(&it->second->response);
+      waiter->response->add_key_index(i);
+      pending_recvs_.erase(it);
+    }
+    if (waiter->response->key_index_size() == 0) return;
+    waiter->responded = true;
+    // The keys that are not ready wait for the client's next request.
+    for (const string& key : request->rendezvous_key()) {
+      auto it = pending_recvs_.find({request->step_id(), key});
+      if (it != pending_recvs_.end() && it->second->waiter == waiter) {
+        it->second->waiter = nullptr;
+      }
+    }
+  }
+  waiter->opts->ClearCancelCallback();
+  waiter->done(s);
 }
 
 namespace {
@@ -736,6 +928,29 @@ void GrpcWorker::CleanupGraphAsync(const CleanupGraphRequest* request,
     // a worker crashes before acking a request.
     response_cache_->CleanEntriesForStep(request->step_id());
   }
+  // Drop the RecvTensors keys of the step that no client has received yet,
+  // and fail the requests still waiting for them.
+  absl::flat_hash_set<std::shared_ptr<RecvTensorsWaiter>> waiters;
+  {
+    mutex_lock l(pending_recvs_mu_);
+    for (auto it = pending_recvs_.begin(); it != pending_recvs_.end();) {
+      if (it->first.first != request->step_id()) {
+        ++it;
+        continue;
+      }
+      std::shared_ptr<RecvTensorsWaiter>& waiter = it->second->waiter;
+      if (waiter != nullptr && !waiter->responded) {
+        waiter->responded = true;
+        waiters.insert(waiter);
+      }
+      pending_recvs_.erase(it++);
+    }
+  }
+  for (const std::shared_ptr<RecvTensorsWaiter>& waiter : waiters) {
+    waiter->opts->ClearCancelCallback();
+    waiter->done(errors::Aborted("Step ", request->step_id(),
+                                 " was cleaned up during RecvTensors"));
+  }
   Worker::CleanupGraphAsync(request, response, done);
 }
 
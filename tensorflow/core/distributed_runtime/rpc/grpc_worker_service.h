@@ -16,13 +16,17 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_WORKER_SERVICE_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_WORKER_SERVICE_H_
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
 #include "grpcpp/server_builder.h"
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
 #include "tensorflow/core/distributed_runtime/rpc/rpc_response_cache.h"
 #include "tensorflow/core/distributed_runtime/worker.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 #include "tsl/distributed_runtime/rpc/async_service_interface.h"
 
@@ -51,6 +55,15 @@ class GrpcWorker : public Worker {
                                    ::grpc::ByteBuffer* response,
                                    StatusCallback done);
 
+  // Receives the requested tensors, copied to host memory, into
+  // RecvTensorResponse protos. Responds as soon as any tensor is ready, with
+  // every tensor that is ready by then, and keeps receiving the others for the
+  // client's next request. Responses are not cached, even if the response
+  // cache is enabled.
+  void RecvTensorsAsync(CallOptions* opts, const RecvTensorsRequest* request,
+                        RecvTensorsResponse* response,
+                        StatusCallback done) override;
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override;
 
@@ -68,8 +81,46 @@ class GrpcWorker : public Worker {
   void RemoveCacheEntryForId(int64_t request_id);
 
  private:
+  // A RecvTensors request that has not been responded to.
+  struct RecvTensorsWaiter {
+    CallOptions* opts;
+    const RecvTensorsRequest* request;
+    RecvTensorsResponse* response;
+    StatusCallback done;
+    // Whether every key of the request has been registered.
+    bool armed = false;
+    bool responded = false;
+  };
+
+  // A key of a RecvTensors request whose tensor has not been returned yet. It
+  // outlives the request if it is not ready when the request is responded
+  // to, so that the client's next request for it does not receive it again.
+  struct PendingRecvTensor {
+    bool ready = false;
+    Status status;
+    RecvTensorResponse response;
+    // The request waiting for the tensor, if any.
+    std::shared_ptr<RecvTensorsWaiter> waiter;
+  };
+
+  // Records the tensor of `key`, and responds to the request waiting for it.
+  void PendingRecvTensorDone(int64_t step_id, const string& key,
+                             const Tensor& tensor, bool is_dead,
+                             const Status& status);
+
+  // Responds to `waiter` with the tensors of its keys that are ready, if
+  // there are any.
+  void MaybeSendRecvTensorsResponse(
+      const std::shared_ptr<RecvTensorsWaiter>& waiter);
+
   std::unique_ptr<RpcResponseCache> response_cache_;
   const int32 recv_buf_max_chunk_;
+
+  // Guards `pending_recvs_` and the `RecvTensorsWaiter`s.
+  mutex pending_recvs_mu_;
+  absl::flat_hash_map<std::pair<int64_t, string>,
+                      std::shared_ptr<PendingRecvTensor>>
+      pending_recvs_ TF_GUARDED_BY(pending_recvs_mu_);
 };
 
 std::unique_ptr<GrpcWorker> NewGrpcWorker(WorkerEnv* worker_env,
@@ -15,6 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -34,12 +40,47 @@ limitations under the License.
 
 namespace tensorflow {
 
+// How remote receives are coalesced, and the workers that are known not to
+// implement the RecvTensors RPC.
+class RecvBatchingState {
+ public:
+  explicit RecvBatchingState(int64_t window_us) : window_us_(window_us) {}
+
+  int64_t window_us() const { return window_us_; }
+
+  // Returns true if receives from `worker` should be batched.
+  bool ShouldBatch(const string& worker) const {
+    if (window_us_ <= 0) return false;
+    mutex_lock l(mu_);
+    return !unsupported_workers_.contains(worker);
+  }
+
+  void MarkUnsupported(const string& worker) {
+    mutex_lock l(mu_);
+    unsupported_workers_.insert(worker);
+  }
+
+ private:
+  const int64_t window_us_;
+  mutable mutex mu_;
+  absl::flat_hash_set<string> unsupported_workers_ TF_GUARDED_BY(mu_);
+};
+
 namespace {
 
+// A receive waiting to be sent in a RecvTensors RPC.
+struct PendingRecv {
+  Rendezvous::ParsedKey parsed;
+  Rendezvous::Args recv_args;
+  Device* dst_device;
+  Rendezvous::DoneCallback done;
+};
+
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
-  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id)
-      : BaseRemoteRendezvous(env, step_id) {}
+  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id,
+                      std::shared_ptr<RecvBatchingState> batching)
+      : BaseRemoteRendezvous(env, step_id), batching_(std::move(batching)) {}
 
  protected:
   void RecvFromRemoteAsync(const Rendezvous::ParsedKey& parsed,
@@ -47,8 +88,32 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
                            DoneCallback done) override;
 
  private:
+  // Receives are batched per source worker and cancellation manager, so that
+  // a batch can be registered and aborted as a single call.
+  typedef std::pair<string, CancellationManager*> RecvBatchKey;
+
   ~RpcRemoteRendezvous() override {}
 
+  // Receives the tensor for `parsed` with a RecvTensor RPC.
+  void StartRecvTensorCall(const Rendezvous::ParsedKey& parsed,
+                           const Rendezvous::Args& recv_args,
+                           DoneCallback done);
+
+  // Sends the receives queued under `key` in a RecvTensors RPC.
+  void FlushRecvBatch(const RecvBatchKey& key);
+
+  // Receives the tensors of `recvs` from `src_worker` with a RecvTensors RPC,
+  // and requests the ones that the worker does not return with another one.
+  // `is_retry` is true if the worker has already been sent these keys.
+  void StartRecvTensorsCall(const string& src_worker,
+                            std::vector<PendingRecv> recvs, bool is_retry);
+
+  const std::shared_ptr<RecvBatchingState> batching_;
+
+  mutex batches_mu_;
+  absl::flat_hash_map<RecvBatchKey, std::vector<PendingRecv>> batches_
+      TF_GUARDED_BY(batches_mu_);
+
   RpcRemoteRendezvous(const RpcRemoteRendezvous&) = delete;
   void operator=(const RpcRemoteRendezvous&) = delete;
 };
@@ -69,6 +134,7 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     req_.set_step_id(step_id);
     req_.set_rendezvous_key(key.data(), key.size());
     req_.set_request_id(GetUniqueRequestId());
+    req_.set_wire_codec(recv_args.wire_codec);
   }
 
   void Reset() {
@@ -230,10 +296,262 @@ static RpcRecvTensorFreeList* get_call_freelist() {
   return call_freelist;
 }
 
+// Used to retrieve several tensors from one remote process in a single RPC.
+class RpcRecvTensorsCall : public BaseRecvTensorCall {
+ public:
+  RpcRecvTensorsCall(WorkerInterface* wi, const string& src_worker,
+                     int64_t step_id, std::vector<PendingRecv> recvs)
+      : src_worker_(src_worker), wi_(wi), recvs_(std::move(recvs)) {
+    req_.set_step_id(step_id);
+    for (const PendingRecv& recv : recvs_) {
+      const StringPiece key = recv.parsed.FullKey();
+      req_.add_rendezvous_key(key.data(), key.size());
+    }
+    req_.set_request_id(GetUniqueRequestId());
+  }
+
+  ~RpcRecvTensorsCall() override {
+    CHECK_EQ(static_cast<WorkerInterface*>(nullptr), wi_)
+        << "Leaking WorkerInterface in RpcRecvTensorsCall destructor.";
+  }
+
+  // See RpcRecvTensorCall::StartRTCall() for the abort checking.
+  void Start(std::function<void()> recv_done) override {
+    auto abort_checked = std::make_shared<Notification>();
+    auto cb = [this, abort_checked,
+               recv_done = std::move(recv_done)](const Status& s) {
+      abort_checked->WaitForNotification();
+      if (!s.ok()) {
+        mutex_lock l(mu_);
+        status_.Update(s);
+      }
+      recv_done();
+    };
+    wi_->RecvTensorsAsync(&opts_, &req_, &resp_, std::move(cb));
+
+    Status s;
+    {
+      mutex_lock l(mu_);
+      s = status_;
+    }
+    if (!s.ok()) {
+      opts_.StartCancel();
+    }
+    abort_checked->Notify();
+  }
+
+  void StartAbort(const Status& s) override {
+    {
+      mutex_lock l(mu_);
+      status_.Update(s);
+    }
+    opts_.StartCancel();
+  }
+
+  Status status() const override {
+    mutex_lock l(mu_);
+    return status_;
+  }
+
+  void ReleaseWorker(WorkerCacheInterface* worker_cache) {
+    DCHECK_NE(static_cast<WorkerInterface*>(nullptr), wi_)
+        << "RpcRecvTensorsCall::ReleaseWorker() called twice.";
+    worker_cache->ReleaseWorker(src_worker_, wi_);
+    wi_ = nullptr;
+  }
+
+  const string& src_worker() const { return src_worker_; }
+
+  // The batched receives share their cancellation manager, so the arguments
+  // of any of them can be used to register the call.
+  const Rendezvous::Args& recv_args() const { return recvs_[0].recv_args; }
+
+  std::vector<PendingRecv>* mutable_recvs() { return &recvs_; }
+
+  // Calls the callback of every batched receive that the worker returned,
+  // with its tensor, after passing the receives that it has not returned yet
+  // to `request_remaining`, if there are any. If `s` is not OK, calls every
+  // callback with `s`.
+  void RunCallbacks(
+      Status s,
+      const std::function<void(std::vector<PendingRecv>)>& request_remaining) {
+    std::vector<int> key_index(resp_.key_index().begin(),
+                               resp_.key_index().end());
+    if (key_index.empty()) {
+      // The worker returned every tensor, in order.
+      for (int i = 0; i < resp_.response_size(); ++i) key_index.push_back(i);
+      if (s.ok() && resp_.response_size() != recvs_.size()) {
+        s = errors::Internal("Expected ", recvs_.size(), " tensors from ",
+                             src_worker_, " but received ",
+                             resp_.response_size());
+      }
+    } else if (s.ok() && resp_.response_size() != key_index.size()) {
+      s = errors::Internal("Received ", resp_.response_size(),
+                           " tensors for ", key_index.size(), " keys from ",
+                           src_worker_);
+    }
+    std::vector<bool> returned(recvs_.size(), false);
+    for (int i = 0; s.ok() && i < key_index.size(); ++i) {
+      if (key_index[i] < 0 || key_index[i] >= recvs_.size() ||
+          returned[key_index[i]]) {
+        s = errors::Internal("Received an invalid key index ", key_index[i],
+                             " from ", src_worker_);
+      } else {
+        returned[key_index[i]] = true;
+      }
+    }
+    if (!s.ok()) {
+      for (PendingRecv& recv : recvs_) {
+        recv.done(s, Rendezvous::Args(), recv.recv_args, Tensor(), false);
+      }
+      return;
+    }
+
+    std::vector<PendingRecv> remaining;
+    for (int i = 0; i < recvs_.size(); ++i) {
+      if (!returned[i]) remaining.push_back(std::move(recvs_[i]));
+    }
+    if (!remaining.empty()) {
+      request_remaining(std::move(remaining));
+    }
+    for (int i = 0; i < key_index.size(); ++i) {
+      PendingRecv& recv = recvs_[key_index[i]];
+      TensorResponse tensor_response;
+      tensor_response.InitAlloc(recv.dst_device, recv.recv_args.alloc_attrs);
+      Status status = tensor_response.InitFrom(resp_.mutable_response(i));
+      recv.done(status, Rendezvous::Args(), recv.recv_args,
+                tensor_response.tensor(), tensor_response.metadata().is_dead());
+    }
+  }
+
+ private:
+  const string src_worker_;
+  WorkerInterface* wi_;  // Not owned.
+  std::vector<PendingRecv> recvs_;
+  CallOptions opts_;
+  RecvTensorsRequest req_;
+  RecvTensorsResponse resp_;
+
+  mutable mutex mu_;
+  Status status_ TF_GUARDED_BY(mu_);
+
+  RpcRecvTensorsCall(const RpcRecvTensorsCall&) = delete;
+  void operator=(const RpcRecvTensorsCall&) = delete;
+};
+
 void RpcRemoteRendezvous::RecvFromRemoteAsync(
     const Rendezvous::ParsedKey& parsed, const Rendezvous::Args& recv_args,
     DoneCallback done) {
   CHECK(is_initialized());
+  string src_worker;
+  string src_rel_device;
+  // RecvTensors does not support wire codecs.
+  if (!recv_args.wire_codec.empty() ||
+      !DeviceNameUtils::SplitDeviceName(parsed.src_device, &src_worker,
+                                        &src_rel_device) ||
+      !batching_->ShouldBatch(src_worker)) {
+    StartRecvTensorCall(parsed, recv_args, std::move(done));
+    return;
+  }
+
+  Device* dst_device;
+  Status s = session()->device_mgr()->LookupDevice(parsed.dst_device,
+                                                   &dst_device);
+  if (!s.ok()) {
+    done(s, Args(), recv_args, Tensor{}, false);
+    return;
+  }
+
+  RecvBatchKey key(src_worker, recv_args.cancellation_manager);
+  bool first_in_batch;
+  {
+    mutex_lock l(batches_mu_);
+    std::vector<PendingRecv>& batch = batches_[key];
+    first_in_batch = batch.empty();
+    batch.push_back({parsed, recv_args, dst_device, std::move(done)});
+  }
+  if (first_in_batch) {
+    Ref();
+    env_->env->SchedClosureAfter(batching_->window_us(), [this, key]() {
+      FlushRecvBatch(key);
+      Unref();
+    });
+  }
+}
+
+void RpcRemoteRendezvous::FlushRecvBatch(const RecvBatchKey& key) {
+  std::vector<PendingRecv> recvs;
+  {
+    mutex_lock l(batches_mu_);
+    auto it = batches_.find(key);
+    recvs = std::move(it->second);
+    batches_.erase(it);
+  }
+  if (recvs.size() == 1) {
+    StartRecvTensorCall(recvs[0].parsed, recvs[0].recv_args,
+                        std::move(recvs[0].done));
+    return;
+  }
+  StartRecvTensorsCall(key.first, std::move(recvs), /*is_retry=*/false);
+}
+
+void RpcRemoteRendezvous::StartRecvTensorsCall(const string& src_worker,
+                                               std::vector<PendingRecv> recvs,
+                                               bool is_retry) {
+  WorkerSession* sess = session();
+  std::shared_ptr<WorkerCacheInterface> worker_cache =
+      sess->GetSharedWorkerCache();
+  WorkerInterface* rwi = worker_cache->GetOrCreateWorker(src_worker);
+  if (rwi == nullptr) {
+    Status s = errors::Internal("No worker known as ", src_worker);
+    for (PendingRecv& recv : recvs) {
+      recv.done(s, Args(), recv.recv_args, Tensor{}, false);
+    }
+    return;
+  }
+
+  auto* call = new RpcRecvTensorsCall(rwi, src_worker, step_id_,
+                                      std::move(recvs));
+  RegisterCall(call, call->recv_args());
+  if (!call->status().ok()) {
+    DeregisterCall(call, call->recv_args());
+    call->ReleaseWorker(sess->worker_cache());
+    call->RunCallbacks(call->status(), nullptr);
+    delete call;
+    return;
+  }
+
+  Ref();
+  call->Start([this, call, worker_cache, is_retry]() {
+    DeregisterCall(call, call->recv_args());
+    Status s = call->status();
+    // NOTE: `*session()` can potentially be deleted before we return from
+    // the callbacks, so we must release the worker before calling them.
+    call->ReleaseWorker(session()->worker_cache());
+    if (errors::IsUnimplemented(s) && !is_retry) {
+      // The worker predates RecvTensors: receive each tensor on its own.
+      VLOG(1) << "Worker " << call->src_worker()
+              << " does not support RecvTensors";
+      batching_->MarkUnsupported(call->src_worker());
+      for (PendingRecv& recv : *call->mutable_recvs()) {
+        StartRecvTensorCall(recv.parsed, recv.recv_args, std::move(recv.done));
+      }
+    } else {
+      // The worker keeps receiving the keys that it did not return, so they
+      // are requested again with RecvTensors rather than RecvTensor.
+      call->RunCallbacks(s, [this, call](std::vector<PendingRecv> remaining) {
+        StartRecvTensorsCall(call->src_worker(), std::move(remaining),
+                             /*is_retry=*/true);
+      });
+    }
+    delete call;
+    Unref();
+  });
+}
+
+void RpcRemoteRendezvous::StartRecvTensorCall(
+    const Rendezvous::ParsedKey& parsed, const Rendezvous::Args& recv_args,
+    DoneCallback done) {
   Status s;
 
   // Prepare a RecvTensor call that can handle being aborted.
@@ -308,12 +626,18 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
 }  // namespace
 
 RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env)
-    : BaseRendezvousMgr(env) {}
+    : RpcRendezvousMgr(env, RPCOptions()) {}
+
+RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env,
+                                   const RPCOptions& rpc_options)
+    : BaseRendezvousMgr(env),
+      batching_(std::make_shared<RecvBatchingState>(
+          rpc_options.recv_tensor_batch_window_us())) {}
 
 tsl::core::RefCountPtr<BaseRemoteRendezvous> RpcRendezvousMgr::Create(
     int64_t step_id, const WorkerEnv* worker_env) {
   return tsl::core::RefCountPtr<BaseRemoteRendezvous>(
-      new RpcRemoteRendezvous(worker_env, step_id));
+      new RpcRemoteRendezvous(worker_env, step_id, batching_));
 }
 
 }  // end namespace tensorflow
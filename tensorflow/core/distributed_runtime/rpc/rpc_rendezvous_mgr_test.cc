@@ -15,13 +15,22 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <atomic>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/test_utils.h"
 #include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/control_flow.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
@@ -68,6 +77,84 @@ class DummyWorker : public TestWorkerInterface {
   }
 };
 
+// A worker that also implements RecvTensors, and returns each requested key as
+// the tensor received for it.
+class BatchingWorker : public DummyWorker {
+ public:
+  void RecvTensorsAsync(CallOptions* opts, const RecvTensorsRequest* request,
+                        RecvTensorsResponse* response,
+                        StatusCallback done) override {
+    num_batches_.fetch_add(1);
+    for (const string& key : request->rendezvous_key()) {
+      V(key).AsProtoField(response->add_response()->mutable_tensor());
+    }
+    SchedClosure([done = std::move(done)]() { done(absl::OkStatus()); });
+  }
+
+  int num_batches() const { return num_batches_.load(); }
+
+ private:
+  std::atomic<int> num_batches_{0};
+};
+
+// A worker that implements RecvTensors like GrpcWorker: it responds as soon as
+// any requested key has been produced, with every produced key.
+class DependentWorker : public DummyWorker {
+ public:
+  // Produces the tensor of `key`, which holds the key.
+  void Produce(const string& key) {
+    StatusCallback done;
+    {
+      mutex_lock l(mu_);
+      produced_.insert(key);
+      done = MaybeRespondLocked();
+    }
+    if (done) done(absl::OkStatus());
+  }
+
+  void RecvTensorsAsync(CallOptions* opts, const RecvTensorsRequest* request,
+                        RecvTensorsResponse* response,
+                        StatusCallback done) override {
+    {
+      mutex_lock l(mu_);
+      ++num_batches_;
+      request_ = request;
+      response_ = response;
+      done_ = std::move(done);
+      done = MaybeRespondLocked();
+    }
+    if (done) done(absl::OkStatus());
+  }
+
+  int num_batches() {
+    mutex_lock l(mu_);
+    return num_batches_;
+  }
+
+ private:
+  // Fills in the response to the waiting request and returns its callback,
+  // if any of its keys has been produced.
+  StatusCallback MaybeRespondLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (!done_) return nullptr;
+    for (int i = 0; i < request_->rendezvous_key_size(); ++i) {
+      const string& key = request_->rendezvous_key(i);
+      if (produced_.erase(key) > 0) {
+        V(key).AsProtoField(response_->add_response()->mutable_tensor());
+        response_->add_key_index(i);
+      }
+    }
+    if (response_->key_index_size() == 0) return nullptr;
+    return std::exchange(done_, nullptr);
+  }
+
+  mutex mu_;
+  std::set<string> produced_ TF_GUARDED_BY(mu_);
+  const RecvTensorsRequest* request_ TF_GUARDED_BY(mu_) = nullptr;
+  RecvTensorsResponse* response_ TF_GUARDED_BY(mu_) = nullptr;
+  StatusCallback done_ TF_GUARDED_BY(mu_);
+  int num_batches_ TF_GUARDED_BY(mu_) = 0;
+};
+
 // Fake cache implementation for WorkerEnv.
 class DummyWorkerCache : public WorkerCacheInterface {
   void ListWorkers(std::vector<string>* workers) const override {}
@@ -104,7 +191,9 @@ static Device* CreateDevice(const char* type, const char* name) {
    public:
     explicit FakeDevice(const DeviceAttributes& attr) : Device(nullptr, attr) {}
     Status Sync() override { return absl::OkStatus(); }
-    Allocator* GetAllocator(AllocatorAttributes) override { return nullptr; }
+    Allocator* GetAllocator(AllocatorAttributes) override {
+      return cpu_allocator();
+    }
   };
   DeviceAttributes attr;
   attr.set_name(name);
@@ -121,6 +210,37 @@ static DeviceMgr* CreateDeviceMgr() {
 }
 }  // namespace
 
+// A cache in which "task:3" workers do not implement RecvTensors, "task:4"
+// workers are `DependentWorker`s, and all the other workers are
+// `BatchingWorker`s.
+class BatchingWorkerCache : public DummyWorkerCache {
+ public:
+  BatchingWorkerCache()
+      : batching_worker_(new BatchingWorker),
+        plain_worker_(new DummyWorker),
+        dependent_worker_(new DependentWorker) {}
+  ~BatchingWorkerCache() override {
+    WorkerCacheInterface::ReleaseWorker("", batching_worker_);
+    WorkerCacheInterface::ReleaseWorker("", plain_worker_);
+    WorkerCacheInterface::ReleaseWorker("", dependent_worker_);
+  }
+
+  WorkerInterface* GetOrCreateWorker(const string& target) override {
+    if (absl::StrContains(target, "task:3")) return plain_worker_;
+    if (absl::StrContains(target, "task:4")) return dependent_worker_;
+    return batching_worker_;
+  }
+  void ReleaseWorker(const string& target, WorkerInterface* worker) override {}
+
+  BatchingWorker* batching_worker() const { return batching_worker_; }
+  DependentWorker* dependent_worker() const { return dependent_worker_; }
+
+ private:
+  BatchingWorker* batching_worker_;
+  DummyWorker* plain_worker_;
+  DependentWorker* dependent_worker_;
+};
+
 class RpcRendezvousMgrTest : public ::testing::Test {
  protected:
   RpcRendezvousMgrTest()
@@ -342,4 +462,123 @@ TEST_F(RpcRendezvousMgrTest, RemoteRecvAsyncMany) {
   rmgr_.Cleanup(step_id);
 }
 
+class RpcRendezvousMgrBatchingTest : public ::testing::Test {
+ protected:
+  RpcRendezvousMgrBatchingTest()
+      : cache_(new BatchingWorkerCache),
+        worker_session_("rpc_session", "/job:mnist/replica:1/task:2",
+                        std::unique_ptr<WorkerCacheInterface>(cache_),
+                        std::unique_ptr<DeviceMgr>(CreateDeviceMgr()),
+                        std::unique_ptr<GraphMgr>(), nullptr,
+                        [](WorkerSession* worker_session, bool called,
+                           DeviceMgr* remote_device_mgr) { return nullptr; }),
+        rmgr_(&env, BatchingOptions()) {
+    env.env = Env::Default();
+  }
+
+  static RPCOptions BatchingOptions() {
+    RPCOptions options;
+    options.set_recv_tensor_batch_window_us(10000);
+    return options;
+  }
+
+  // Receives `num_requests` distinct tensors from `src_device`. If
+  // `check_values`, checks that each one holds its key.
+  void RecvMany(int64_t step_id, const string& src_device, int num_requests,
+                bool check_values) {
+    tsl::core::RefCountPtr<RemoteRendezvous> rendez = rmgr_.Find(step_id);
+    TF_ASSERT_OK(rendez->Initialize(&worker_session_));
+    Rendezvous::Args args;
+    std::vector<string> keys(num_requests);
+    std::vector<Tensor> vals(num_requests);
+    mutex mu;
+    Status status = absl::OkStatus();
+    BlockingCounter counter(num_requests);
+    for (int i = 0; i < num_requests; ++i) {
+      keys[i] = Rendezvous::CreateKey(src_device, 7890,
+                                      "/job:mnist/replica:1/task:2/cpu:1",
+                                      strings::StrCat("foo", i),
+                                      FrameAndIter(0, 0));
+      rendez->RecvAsync(
+          MakeKey(keys[i]), args,
+          [i, &vals, &mu, &status, &counter](
+              const Status& s, const Rendezvous::Args&,
+              const Rendezvous::Args&, const Tensor& val, const bool) {
+            {
+              mutex_lock l(mu);
+              status.Update(s);
+              vals[i] = val;
+            }
+            counter.DecrementCount();
+          });
+    }
+    counter.Wait();
+    rmgr_.Cleanup(step_id);
+    TF_ASSERT_OK(status);
+    for (int i = 0; check_values && i < num_requests; ++i) {
+      EXPECT_EQ(keys[i], V(vals[i]));
+    }
+  }
+
+  BatchingWorkerCache* cache_;  // Managed by worker_session.
+  WorkerEnv env;
+
+  WorkerSession worker_session_;
+  RpcRendezvousMgr rmgr_;
+};
+
+TEST_F(RpcRendezvousMgrBatchingTest, RemoteRecvBatched) {
+  const int num_requests = 100;
+  RecvMany(123, "/job:worker/replica:1/task:2/cpu:0", num_requests,
+           /*check_values=*/true);
+  EXPECT_GT(cache_->batching_worker()->num_batches(), 0);
+  EXPECT_LT(cache_->batching_worker()->num_batches(), num_requests);
+}
+
+TEST_F(RpcRendezvousMgrBatchingTest, RemoteRecvFallsBackToRecvTensor) {
+  // The receives still succeed, with the tensors returned by RecvTensor.
+  RecvMany(123, "/job:worker/replica:1/task:3/cpu:0", 100,
+           /*check_values=*/false);
+  EXPECT_EQ(cache_->batching_worker()->num_batches(), 0);
+}
+
+TEST_F(RpcRendezvousMgrBatchingTest, RemoteRecvDependentKeys) {
+  // The source worker only produces "foo1" after this worker has received
+  // "foo0", as when the sender of "foo1" consumes a tensor that this worker
+  // computes from "foo0". Both keys are in the same batch, which must not
+  // wait for "foo1" before returning "foo0".
+  const int64_t step_id = 123;
+  DependentWorker* worker = cache_->dependent_worker();
+  tsl::core::RefCountPtr<RemoteRendezvous> rendez = rmgr_.Find(step_id);
+  TF_ASSERT_OK(rendez->Initialize(&worker_session_));
+  std::vector<string> keys;
+  for (int i = 0; i < 2; ++i) {
+    keys.push_back(Rendezvous::CreateKey(
+        "/job:worker/replica:1/task:4/cpu:0", 7890,
+        "/job:mnist/replica:1/task:2/cpu:1", strings::StrCat("foo", i),
+        FrameAndIter(0, 0)));
+  }
+  worker->Produce(keys[0]);
+
+  std::vector<Tensor> vals(2);
+  BlockingCounter counter(2);
+  for (int i = 0; i < 2; ++i) {
+    rendez->RecvAsync(
+        MakeKey(keys[i]), Rendezvous::Args(),
+        [i, worker, &keys, &vals, &counter](
+            const Status& s, const Rendezvous::Args&, const Rendezvous::Args&,
+            const Tensor& val, const bool) {
+          TF_EXPECT_OK(s);
+          vals[i] = val;
+          if (i == 0) worker->Produce(keys[1]);
+          counter.DecrementCount();
+        });
+  }
+  counter.Wait();
+  rmgr_.Cleanup(step_id);
+  EXPECT_EQ(keys[0], V(vals[0]));
+  EXPECT_EQ(keys[1], V(vals[1]));
+  EXPECT_EQ(worker->num_batches(), 2);
+}
+
 }  // namespace tensorflow
@@ -52,7 +52,8 @@ CollectiveExecutor* RpcCollectiveExecutorMgr::Create(int64_t step_id) {
       new CollectiveRemoteAccessDistributed(dev_mgr_, dev_resolver_.get(),
                                             work_queue_, worker_cache_, step_id,
                                             task_name_);
-  return new BaseCollectiveExecutor(this, rma, step_id, dev_mgr_, work_queue_);
+  return new BaseCollectiveExecutor(this, rma, step_id, dev_mgr_, work_queue_,
+                                    max_collectives_in_flight_);
 }
 
 namespace {
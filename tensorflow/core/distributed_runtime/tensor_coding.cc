@@ -18,18 +18,28 @@ limitations under the License.
 #include "google/protobuf/any.pb.h"
 
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/distributed_runtime/tensor_wire_codec.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/platform/notification.h"
 
 namespace tensorflow {
 
 TensorResponse::Source::~Source() {}
 
+core::RefCountPtr<TensorBuffer> TensorResponse::Source::ShareContents(
+    const char* data, size_t num_bytes) {
+  return nullptr;
+}
+
 void TensorResponse::Clear() {
   on_host_ = false;
   device_ = nullptr;
   alloc_attrs_ = AllocatorAttributes();
   allocator_ = nullptr;
+  parse_allocator_ = nullptr;
+  device_context_ = nullptr;
+  share_contents_ = false;
   already_used_ = false;
   ClearTensor();
 }
@@ -48,11 +58,31 @@ void TensorResponse::InitAlloc(DeviceBase* d, const AllocatorAttributes& aa) {
     on_host_ = true;
   }
   allocator_ = device_->GetAllocator(alloc_attrs_);
+  if (on_host_) {
+    parse_allocator_ = allocator_;
+    // Memory with placement requirements must come from allocator_.
+    share_contents_ =
+        !alloc_attrs_.gpu_compatible() && !alloc_attrs_.nic_compatible();
+  } else {
+    const DeviceBase::AcceleratorDeviceInfo* device_info =
+        device_->tensorflow_accelerator_device_info();
+    if (device_info != nullptr) {
+      device_context_ = device_info->default_context;
+    }
+    AllocatorAttributes host_attrs;
+    host_attrs.set_on_host(true);
+    host_attrs.set_gpu_compatible(true);
+    parse_allocator_ = device_->GetAllocator(host_attrs);
+    share_contents_ = true;
+  }
 }
 
 Status TensorResponse::InitFrom(RecvTensorResponse* response) {
   Status s;
   meta_.Swap(response);
+  if (!meta_.wire_codec().empty()) {
+    return DecodeWireTensor();
+  }
   if (on_host_) {
     if (!tensor_.FromProto(allocator_, meta_.tensor())) {
       s = errors::InvalidArgument("Cannot parse tensor from response");
@@ -80,6 +110,16 @@ void TensorResponse::InitPartial(const RecvTensorResponse& response,
 }
 
 Status TensorResponse::ParseFrom(Source* source) {
+  if (already_used_) {
+    ClearTensor();
+  }
+  already_used_ = true;
+  if (!on_host_ && device_context_ != nullptr) {
+    // Decode straight from the received chunks into host memory, and copy
+    // that to the device, instead of materializing a TensorProto first.
+    if (ParseFast(source)) return CopyTensorToDevice();
+    meta_.Clear();
+  }
   if (!on_host_) {
     protobuf::io::CodedInputStream input(source->contents());
 
@@ -87,6 +127,9 @@ Status TensorResponse::ParseFrom(Source* source) {
     if (!meta_.ParseFromCodedStream(&input) || !input.ConsumedEntireMessage()) {
       return errors::InvalidArgument("Cannot parse tensor from response");
     }
+    if (!meta_.wire_codec().empty()) {
+      return DecodeWireTensor();
+    }
     Status s =
         device_->MakeTensorFromProto(meta_.tensor(), alloc_attrs_, &tensor_);
     // Reduce memory usage for big tensors.
@@ -97,14 +140,54 @@ Status TensorResponse::ParseFrom(Source* source) {
     meta_.clear_tensor();
     return s;
   }
-  if (already_used_) {
-    ClearTensor();
-  }
-  already_used_ = true;
   if (ParseFast(source)) return absl::OkStatus();
   meta_.Clear();
-  if (ParseSlow(source)) return absl::OkStatus();
-  return errors::InvalidArgument("Cannot parse tensor from response");
+  return ParseSlow(source);
+}
+
+Status TensorResponse::DecodeWireTensor() {
+  const TensorWireCodec* codec =
+      TensorWireCodecRegistry::Lookup(meta_.wire_codec());
+  Status s;
+  Tensor decoded;
+  if (codec == nullptr) {
+    s = errors::Unimplemented("Unknown tensor wire codec: ",
+                              meta_.wire_codec());
+  } else {
+    s = codec->Decode(meta_.tensor(), parse_allocator_, &decoded);
+  }
+  // Reduce memory usage for big tensors.
+  {
+    TensorProto empty;
+    meta_.mutable_tensor()->Swap(&empty);
+  }
+  meta_.clear_tensor();
+  if (!s.ok()) return s;
+
+  tensor_ = std::move(decoded);
+  if (on_host_) return absl::OkStatus();
+  if (device_context_ != nullptr) return CopyTensorToDevice();
+  TensorProto proto;
+  tensor_.AsProtoTensorContent(&proto);
+  return device_->MakeTensorFromProto(proto, alloc_attrs_, &tensor_);
+}
+
+Status TensorResponse::CopyTensorToDevice() {
+  Tensor host_tensor = std::move(tensor_);
+  Tensor device_tensor(allocator_, host_tensor.dtype(), host_tensor.shape());
+  Notification n;
+  Status status;
+  device_context_->CopyCPUTensorToDevice(&host_tensor,
+                                         static_cast<Device*>(device_),
+                                         &device_tensor,
+                                         [&n, &status](const Status& s) {
+                                           status = s;
+                                           n.Notify();
+                                         });
+  n.WaitForNotification();
+  TF_RETURN_IF_ERROR(status);
+  tensor_ = std::move(device_tensor);
+  return absl::OkStatus();
 }
 
 // Define some helper routines for decoding protocol buffer wire format data
@@ -115,6 +198,11 @@ enum WireType {
   WIRETYPE_LENGTH_DELIMITED = 2,
 };
 inline int GetTagFieldNumber(uint32 tag) { return tag >> 3; }
+
+// Tensor contents smaller than this are always copied, so that a small
+// tensor does not keep a large received chunk alive.
+constexpr int kMinSharedContentBytes = 1024;
+
 inline WireType GetTagWireType(uint32 tag) {
   return static_cast<WireType>(tag & 0x7);
 }
@@ -144,7 +232,8 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
 }  // namespace
 
 bool TensorResponse::ParseTensorSubmessage(
-    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
+    Source* source, protobuf::io::CodedInputStream* input,
+    TensorProto* tensor_meta) {
   bool seen_tensor_content = false;
   while (true) {
     auto p = input->ReadTagWithCutoff(127);
@@ -155,7 +244,7 @@ bool TensorResponse::ParseTensorSubmessage(
       if (ok && !seen_tensor_content) {
         // No tensor content: could be because it's a zero-length tensor
         TensorShape shape(tensor_meta->tensor_shape());
-        Tensor t(allocator_, tensor_meta->dtype(), shape);
+        Tensor t(parse_allocator_, tensor_meta->dtype(), shape);
         tensor_ = std::move(t);
       }
       return ok;
@@ -195,12 +284,26 @@ bool TensorResponse::ParseTensorSubmessage(
         if (!ReadVarintSizeAsInt(input, &num_bytes)) return false;
         seen_tensor_content = true;
         TensorShape shape(tensor_meta->tensor_shape());
-        Tensor t(allocator_, tensor_meta->dtype(), shape);
+        const DataType dtype = tensor_meta->dtype();
+        // Adopt the received bytes as the tensor buffer if they are
+        // contiguous in the current chunk and suitably aligned.
+        const void* data;
+        int size;
+        if (share_contents_ && num_bytes >= kMinSharedContentBytes &&
+            num_bytes == shape.num_elements() * DataTypeSize(dtype) &&
+            input->GetDirectBufferPointer(&data, &size) && size >= num_bytes &&
+            reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES == 0) {
+          core::RefCountPtr<TensorBuffer> shared = source->ShareContents(
+              static_cast<const char*>(data), num_bytes);
+          if (shared) {
+            if (!input->Skip(num_bytes)) return false;
+            tensor_ = Tensor(dtype, shape, std::move(shared));
+            break;
+          }
+        }
+        Tensor t(parse_allocator_, dtype, shape);
         StringPiece buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
-        // TODO(jeff,sanjay): Figure out a way to avoid this copy if
-        // the underlying ZeroCopyInputStream data is properly aligned
-        // and compatible with what allocator_ wants.
         if (!input->ReadRaw(const_cast<char*>(buf.data()), num_bytes))
           return false;
         tensor_ = std::move(t);
@@ -233,7 +336,7 @@ bool TensorResponse::ParseFast(Source* source) {
         std::pair<protobuf::io::CodedInputStream::Limit, int> p =
             input.IncrementRecursionDepthAndPushLimit(length);
         if (p.second < 0 ||
-            !ParseTensorSubmessage(&input, meta_.mutable_tensor())) {
+            !ParseTensorSubmessage(source, &input, meta_.mutable_tensor())) {
           return false;
         }
         if (!input.DecrementRecursionDepthAndPopLimit(p.first)) {
@@ -275,14 +378,17 @@ bool TensorResponse::ParseFast(Source* source) {
   return false;
 }
 
-bool TensorResponse::ParseSlow(Source* source) {
+Status TensorResponse::ParseSlow(Source* source) {
   if (!meta_.ParseFromZeroCopyStream(source->contents())) {
-    return false;
+    return errors::InvalidArgument("Cannot parse tensor from response");
+  }
+  if (!meta_.wire_codec().empty()) {
+    return DecodeWireTensor();
   }
 
   Tensor parsed(meta_.tensor().dtype());
   if (!parsed.FromProto(allocator_, meta_.tensor())) {
-    return false;
+    return errors::InvalidArgument("Cannot parse tensor from response");
   }
   tensor_ = std::move(parsed);
 
@@ -293,7 +399,7 @@ bool TensorResponse::ParseSlow(Source* source) {
   }
   meta_.clear_tensor();
 
-  return true;
+  return absl::OkStatus();
 }
 
 }  // namespace tensorflow
@@ -20,12 +20,14 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace tensorflow {
 
 class DeviceBase;
+class DeviceContext;
 class TensorProto;
 
 // TensorResponse can be used as the destination of an RPC that returns
@@ -63,6 +65,13 @@ class TensorResponse {
     // Ownership of the returned stream is retained by the Source and
     // should not be deleted by the caller.
     virtual ::tensorflow::protobuf::io::ZeroCopyInputStream* contents() = 0;
+
+    // Returns a buffer that shares the `num_bytes` bytes at `data` without
+    // copying them and keeps them alive, or nullptr if they cannot be
+    // shared. `data` points into a chunk yielded by the stream most recently
+    // returned by contents(). The default implementation returns nullptr.
+    virtual core::RefCountPtr<TensorBuffer> ShareContents(const char* data,
+                                                          size_t num_bytes);
   };
 
   // Parse the RecvTensorResponse encoded in the data yielded by
@@ -91,15 +100,29 @@ class TensorResponse {
   DeviceBase* device() const { return device_; }
 
  private:
-  bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
+  bool ParseTensorSubmessage(Source* source,
+                             protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
   bool ParseFast(Source* source);
-  bool ParseSlow(Source* source);
+  Status ParseSlow(Source* source);
+  // Copies tensor_, which ParseFast() decoded into host memory, to device_.
+  Status CopyTensorToDevice();
+  // Decodes meta_.tensor(), which was encoded with the TensorWireCodec named
+  // by meta_.wire_codec(), into tensor_.
+  Status DecodeWireTensor();
 
   bool on_host_ = false;
   DeviceBase* device_ = nullptr;
   AllocatorAttributes alloc_attrs_;
   Allocator* allocator_ = nullptr;
+  // Allocator used by ParseFast() for the decoded tensor. Equal to
+  // allocator_ on the host, and a host allocator otherwise.
+  Allocator* parse_allocator_ = nullptr;
+  // Context used to copy decoded tensors to a non-host device_, if any.
+  DeviceContext* device_context_ = nullptr;
+  // Whether ParseFast() may share the received bytes instead of copying
+  // them into memory from parse_allocator_.
+  bool share_contents_ = false;
   bool already_used_ = false;
   Tensor tensor_;
   RecvTensorResponse meta_;
@@ -15,13 +15,20 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include <memory>
+
+#include "tensorflow/core/distributed_runtime/tensor_wire_codec.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -156,6 +163,133 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+// A TensorBuffer over memory owned by the test.
+class UnownedBuffer : public TensorBuffer {
+ public:
+  UnownedBuffer(const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)), size_(size) {}
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {}
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  size_t size_;
+};
+
+// A Source over a single chunk, whose contents can be shared.
+class SharingSource : public TensorResponse::Source {
+ public:
+  SharingSource(const char* data, int size) : data_(data), size_(size) {}
+
+  protobuf::io::ZeroCopyInputStream* contents() override {
+    stream_ = std::make_unique<protobuf::io::ArrayInputStream>(data_, size_);
+    return stream_.get();
+  }
+
+  core::RefCountPtr<TensorBuffer> ShareContents(const char* data,
+                                                size_t num_bytes) override {
+    ++num_shared_;
+    return core::RefCountPtr<TensorBuffer>(new UnownedBuffer(data, num_bytes));
+  }
+
+  int num_shared() const { return num_shared_; }
+
+ private:
+  const char* data_;
+  int size_;
+  std::unique_ptr<protobuf::io::ArrayInputStream> stream_;
+  int num_shared_ = 0;
+};
+
+// Parses `src`, encoded at an offset that leaves its contents `misalignment`
+// bytes past an aligned address, and returns whether they were shared.
+bool ParseFromSharingSource(const Tensor& src, int misalignment) {
+  RecvTensorResponse proto;
+  src.AsProtoTensorContent(proto.mutable_tensor());
+  string encoded;
+  proto.AppendToString(&encoded);
+  const size_t offset = encoded.find(string(src.tensor_data()));
+  CHECK_NE(offset, string::npos);
+  const size_t pad =
+      EIGEN_MAX_ALIGN_BYTES - offset % EIGEN_MAX_ALIGN_BYTES + misalignment;
+  char* storage = static_cast<char*>(
+      port::AlignedMalloc(pad + encoded.size(), EIGEN_MAX_ALIGN_BYTES));
+  memcpy(storage + pad, encoded.data(), encoded.size());
+
+  bool shared;
+  {
+    SharingSource source(storage + pad, encoded.size());
+    TensorResponse response;
+    DummyDevice cpu_device(Env::Default());
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    EXPECT_TRUE(response.ParseFrom(&source).ok());
+    test::ExpectTensorEqual<float>(src, response.tensor());
+    shared = response.tensor().tensor_data().data() == storage + pad + offset;
+    EXPECT_EQ(shared, source.num_shared() == 1);
+  }
+  port::AlignedFree(storage);
+  return shared;
+}
+
+TEST(TensorResponseShareTest, SharesAlignedContents) {
+  Tensor src(DT_FLOAT, TensorShape({1024}));
+  test::FillIota<float>(&src, 0.0f);
+  EXPECT_TRUE(ParseFromSharingSource(src, 0));
+}
+
+TEST(TensorResponseShareTest, CopiesMisalignedContents) {
+  Tensor src(DT_FLOAT, TensorShape({1024}));
+  test::FillIota<float>(&src, 0.0f);
+  EXPECT_FALSE(ParseFromSharingSource(src, 4));
+}
+
+TEST(TensorResponseShareTest, CopiesSmallContents) {
+  Tensor src(DT_FLOAT, TensorShape({16}));
+  test::FillIota<float>(&src, 0.0f);
+  EXPECT_FALSE(ParseFromSharingSource(src, 0));
+}
+
+// Parses a response whose tensor was encoded with `codec_name`, using
+// `encoder` (or leaving it unencoded if null).
+Status ParseWireCodecResponse(const Tensor& src, const string& codec_name,
+                              const TensorWireCodec* encoder,
+                              TensorResponse* response) {
+  RecvTensorResponse proto;
+  proto.set_send_start_micros(123456);
+  proto.set_wire_codec(codec_name);
+  if (encoder == nullptr) {
+    src.AsProtoTensorContent(proto.mutable_tensor());
+  } else {
+    EXPECT_TRUE(encoder->Encode(src, proto.mutable_tensor()));
+  }
+  string encoded;
+  proto.AppendToString(&encoded);
+  StringSource source(&encoded, 1024);
+  static DummyDevice* cpu_device = new DummyDevice(Env::Default());
+  response->InitAlloc(cpu_device, AllocatorAttributes());
+  return response->ParseFrom(&source);
+}
+
+TEST(TensorResponseWireCodecTest, DecodesTensor) {
+  Tensor src(DT_FLOAT, TensorShape({4, 8}));
+  test::FillIota<float>(&src, 1.0f);
+  TensorResponse response;
+  TF_ASSERT_OK(ParseWireCodecResponse(
+      src, "bf16", TensorWireCodecRegistry::Lookup("bf16"), &response));
+  EXPECT_EQ(response.metadata().send_start_micros(), 123456);
+  // Small integers are exact in bfloat16.
+  test::ExpectTensorEqual<float>(response.tensor(), src);
+}
+
+TEST(TensorResponseWireCodecTest, UnknownCodec) {
+  Tensor src(DT_FLOAT, TensorShape({4}));
+  test::FillIota<float>(&src, 1.0f);
+  TensorResponse response;
+  EXPECT_TRUE(errors::IsUnimplemented(
+      ParseWireCodecResponse(src, "no_such_codec", nullptr, &response)));
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
@@ -0,0 +1,148 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/tensor_wire_codec.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/bfloat16.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/snappy.h"
+
+namespace tensorflow {
+
+namespace {
+
+struct CodecMap {
+  mutex mu;
+  absl::flat_hash_map<std::string, std::unique_ptr<TensorWireCodec>> codecs
+      TF_GUARDED_BY(mu);
+};
+
+CodecMap* GlobalCodecMap() {
+  static CodecMap* map = new CodecMap;
+  return map;
+}
+
+// Losslessly compresses the contents of tensors with memcpy-able dtypes.
+class SnappyCodec : public TensorWireCodec {
+ public:
+  bool Encode(const Tensor& tensor, TensorProto* proto) const override {
+    // Smaller tensors are not worth the compression latency.
+    static constexpr size_t kMinCompressedBytes = 1024;
+    if (!DataTypeCanUseMemcpy(tensor.dtype()) ||
+        tensor.TotalBytes() < kMinCompressedBytes) {
+      return false;
+    }
+    const StringPiece data = tensor.tensor_data();
+    std::string compressed;
+    // Snappy_Compress() fails if snappy is not linked in.
+    if (!port::Snappy_Compress(data.data(), data.size(), &compressed) ||
+        compressed.size() >= data.size()) {
+      return false;
+    }
+    proto->set_dtype(tensor.dtype());
+    tensor.shape().AsProto(proto->mutable_tensor_shape());
+    proto->set_tensor_content(std::move(compressed));
+    return true;
+  }
+
+  Status Decode(const TensorProto& proto, Allocator* allocator,
+                Tensor* tensor) const override {
+    if (!DataTypeCanUseMemcpy(proto.dtype())) {
+      return errors::InvalidArgument(
+          "Snappy-encoded tensor has unsupported dtype ",
+          DataTypeString(proto.dtype()));
+    }
+    TensorShape shape;
+    TF_RETURN_IF_ERROR(TensorShape::BuildTensorShape(proto.tensor_shape(),
+                                                     &shape));
+    Tensor decoded(allocator, proto.dtype(), shape);
+    const std::string& content = proto.tensor_content();
+    const StringPiece buf = decoded.tensor_data();
+    size_t length;
+    if (!port::Snappy_GetUncompressedLength(content.data(), content.size(),
+                                            &length) ||
+        length != buf.size() ||
+        !port::Snappy_Uncompress(content.data(), content.size(),
+                                 const_cast<char*>(buf.data()))) {
+      return errors::DataLoss("Cannot decode snappy-encoded tensor of shape ",
+                              shape.DebugString());
+    }
+    *tensor = std::move(decoded);
+    return absl::OkStatus();
+  }
+};
+
+// Sends float tensors as the narrower floating point type `T`, rounding to
+// nearest.
+template <typename T>
+class NarrowFloatCodec : public TensorWireCodec {
+ public:
+  bool Encode(const Tensor& tensor, TensorProto* proto) const override {
+    if (tensor.dtype() != DT_FLOAT) return false;
+    Tensor narrow(DataTypeToEnum<T>::value, tensor.shape());
+    narrow.flat<T>() = tensor.flat<float>().template cast<T>();
+    narrow.AsProtoTensorContent(proto);
+    return true;
+  }
+
+  Status Decode(const TensorProto& proto, Allocator* allocator,
+                Tensor* tensor) const override {
+    Tensor narrow;
+    if (proto.dtype() != DataTypeToEnum<T>::value || !narrow.FromProto(proto)) {
+      return errors::InvalidArgument("Cannot decode ",
+                                     DataTypeString(DataTypeToEnum<T>::value),
+                                     "-encoded tensor");
+    }
+    Tensor decoded(allocator, DT_FLOAT, narrow.shape());
+    decoded.flat<float>() = narrow.flat<T>().template cast<float>();
+    *tensor = std::move(decoded);
+    return absl::OkStatus();
+  }
+};
+
+}  // namespace
+
+void TensorWireCodecRegistry::Register(const std::string& name,
+                                       TensorWireCodec* codec) {
+  CodecMap* map = GlobalCodecMap();
+  mutex_lock l(map->mu);
+  const bool inserted =
+      map->codecs.emplace(name, std::unique_ptr<TensorWireCodec>(codec))
+          .second;
+  CHECK(inserted) << "Tensor wire codec " << name << " registered twice";
+}
+
+const TensorWireCodec* TensorWireCodecRegistry::Lookup(
+    const std::string& name) {
+  CodecMap* map = GlobalCodecMap();
+  mutex_lock l(map->mu);
+  auto it = map->codecs.find(name);
+  return it == map->codecs.end() ? nullptr : it->second.get();
+}
+
+REGISTER_TENSOR_WIRE_CODEC("snappy", SnappyCodec);
+REGISTER_TENSOR_WIRE_CODEC("bf16", NarrowFloatCodec<bfloat16>);
+REGISTER_TENSOR_WIRE_CODEC("fp16", NarrowFloatCodec<Eigen::half>);
+
+}  // namespace tensorflow
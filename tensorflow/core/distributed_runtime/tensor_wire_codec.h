@@ -0,0 +1,73 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_WIRE_CODEC_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_WIRE_CODEC_H_
+
+#include <string>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/platform/status.h"
+
+namespace tensorflow {
+
+// A TensorWireCodec encodes tensors that are sent between workers, e.g. to
+// compress them. The receiver picks the codec of an edge, and the sender
+// encodes the tensor with it if it applies to the tensor.
+//
+// Codecs are stateless, and must be thread-safe.
+//
+// Built-in codecs:
+//   "snappy": lossless compression of tensors with memcpy-able contents.
+//   "bf16":   lossy round-to-nearest conversion of float tensors to bfloat16.
+//   "fp16":   lossy round-to-nearest conversion of float tensors to half.
+class TensorWireCodec {
+ public:
+  virtual ~TensorWireCodec() = default;
+
+  // Encodes `tensor` into `proto`, whose dtype and contents need not match
+  // `tensor`. Returns false, leaving `proto` unspecified, if the codec does
+  // not apply to `tensor`, in which case it is sent unencoded.
+  virtual bool Encode(const Tensor& tensor, TensorProto* proto) const = 0;
+
+  // Decodes a `proto` produced by Encode() into `tensor`, with memory from
+  // `allocator`.
+  virtual Status Decode(const TensorProto& proto, Allocator* allocator,
+                        Tensor* tensor) const = 0;
+};
+
+class TensorWireCodecRegistry {
+ public:
+  // Registers `codec` under `name`, and takes ownership of it. `name` must
+  // not already be registered.
+  static void Register(const std::string& name, TensorWireCodec* codec);
+
+  // Returns the codec registered under `name`, or nullptr if there is none.
+  static const TensorWireCodec* Lookup(const std::string& name);
+};
+
+#define REGISTER_TENSOR_WIRE_CODEC(name, codec) \
+  REGISTER_TENSOR_WIRE_CODEC_UNIQ_HELPER(__COUNTER__, name, codec)
+#define REGISTER_TENSOR_WIRE_CODEC_UNIQ_HELPER(ctr, name, codec) \
+  REGISTER_TENSOR_WIRE_CODEC_UNIQ(ctr, name, codec)
+#define REGISTER_TENSOR_WIRE_CODEC_UNIQ(ctr, name, codec)                 \
+  static bool tensor_wire_codec_registered_##ctr TF_ATTRIBUTE_UNUSED = \
+      (::tensorflow::TensorWireCodecRegistry::Register(name, new codec), true)
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_WIRE_CODEC_H_
@@ -0,0 +1,88 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/tensor_wire_codec.h"
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+const TensorWireCodec* GetCodec(const string& name) {
+  const TensorWireCodec* codec = TensorWireCodecRegistry::Lookup(name);
+  CHECK(codec != nullptr) << name;
+  return codec;
+}
+
+TEST(TensorWireCodecTest, UnknownCodec) {
+  EXPECT_EQ(TensorWireCodecRegistry::Lookup("no_such_codec"), nullptr);
+}
+
+TEST(TensorWireCodecTest, NarrowFloatRoundTrip) {
+  Tensor src(DT_FLOAT, TensorShape({3, 100}));
+  test::FillFn<float>(&src, [](int i) { return 0.37f * i - 50.0f; });
+  for (const char* name : {"bf16", "fp16"}) {
+    const TensorWireCodec* codec = GetCodec(name);
+    TensorProto proto;
+    ASSERT_TRUE(codec->Encode(src, &proto));
+    EXPECT_EQ(proto.dtype(), string(name) == "bf16" ? DT_BFLOAT16 : DT_HALF);
+    EXPECT_EQ(proto.tensor_content().size(), src.NumElements() * 2);
+
+    Tensor decoded;
+    TF_ASSERT_OK(codec->Decode(proto, cpu_allocator(), &decoded));
+    EXPECT_EQ(decoded.dtype(), DT_FLOAT);
+    test::ExpectTensorNear<float>(decoded, src, 0.5);
+  }
+}
+
+TEST(TensorWireCodecTest, NarrowFloatSkipsOtherTypes) {
+  Tensor src(DT_INT32, TensorShape({8}));
+  test::FillIota<int32>(&src, 0);
+  TensorProto proto;
+  EXPECT_FALSE(GetCodec("bf16")->Encode(src, &proto));
+  EXPECT_FALSE(GetCodec("fp16")->Encode(src, &proto));
+}
+
+TEST(TensorWireCodecTest, SnappyRoundTrip) {
+  // Sparse indices compress well.
+  Tensor src(DT_INT64, TensorShape({4096, 2}));
+  test::FillFn<int64_t>(&src, [](int i) { return i / 64; });
+  const TensorWireCodec* codec = GetCodec("snappy");
+  TensorProto proto;
+  if (!codec->Encode(src, &proto)) {
+    GTEST_SKIP() << "Snappy is not available";
+  }
+  EXPECT_EQ(proto.dtype(), DT_INT64);
+  EXPECT_LT(proto.tensor_content().size(), src.TotalBytes());
+
+  Tensor decoded;
+  TF_ASSERT_OK(codec->Decode(proto, cpu_allocator(), &decoded));
+  test::ExpectTensorEqual<int64_t>(decoded, src);
+
+  proto.mutable_tensor_content()->resize(proto.tensor_content().size() / 2);
+  EXPECT_FALSE(codec->Decode(proto, cpu_allocator(), &decoded).ok());
+}
+
+TEST(TensorWireCodecTest, SnappySkipsSmallTensors) {
+  Tensor src(DT_INT64, TensorShape({16}));
+  test::FillIota<int64_t>(&src, 0);
+  TensorProto proto;
+  EXPECT_FALSE(GetCodec("snappy")->Encode(src, &proto));
+}
+
+}  // namespace
+}  // namespace tensorflow
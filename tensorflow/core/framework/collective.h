@@ -159,6 +159,9 @@ struct CollectiveParams : public core::RefCounted {
   string ToString() const;
   bool run_group_initialization = true;
   bool is_stateless = false;
+  // Collectives with a higher priority are launched first when the executor
+  // bounds the number of collectives in flight.
+  int priority = 0;
 };
 
 class CollectiveExecutor;
@@ -313,6 +316,15 @@ class CollectiveRemoteAccess {
   virtual void StartAbort(const Status& s) = 0;
 };
 
+// Attributes of a CollectiveReduceV2 node that make it one of the
+// `kCollectiveBucketSizeAttr` reductions of the bucket named by
+// `kCollectiveBucketAttr`.  See CollectiveExecutor::ExecuteBucketedAsync().
+inline constexpr char kCollectiveBucketAttr[] = "_collective_bucket";
+inline constexpr char kCollectiveBucketSizeAttr[] = "_collective_bucket_size";
+
+// Attribute of a V2 collective node holding CollectiveParams::priority.
+inline constexpr char kCollectivePriorityAttr[] = "_collective_priority";
+
 // A step-specific object that can execute a collective operation completely
 // described by a CollectiveParams object.
 class CollectiveExecutor : public core::RefCounted {
@@ -327,6 +339,23 @@ class CollectiveExecutor : public core::RefCounted {
         "a CollectiveExecutor has not been provided."));
   }
 
+  // Runs the reduction described by `col_params`, which has not been
+  // completed, as one of the `bucket_size` reductions of the bucket named
+  // `bucket` on the device of `ctx`.  Once every reduction of the bucket has
+  // been issued in the same frame iteration, their inputs are packed in order
+  // of instance key into one tensor, which is reduced by a single collective
+  // with the instance key of the first reduction.  Output 0 of each `ctx` is
+  // then set to its part of the result, before its `done` is called.
+  virtual void ExecuteBucketedAsync(OpKernelContext* ctx,
+                                    CollectiveParams* col_params,
+                                    const string& bucket, int bucket_size,
+                                    StatusCallback done) {
+    done(errors::Internal(
+        "A bucketed collective Op has been called in a context in which "
+        "a CollectiveExecutor that supports bucketing has not been "
+        "provided."));
+  }
+
   virtual void CompleteParamsAsync(const DeviceAttributes& device,
                                    CollectiveParams* cp,
                                    CancellationManager* cancel_mgr,
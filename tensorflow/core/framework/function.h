@@ -313,6 +313,12 @@ class CallFrameInterface {
   virtual bool CanConsumeArg(int index) const { return false; }
 
   virtual Status SetRetval(int index, const Tensor& val) = 0;
+
+  // Optionally returns a caller-owned buffer into which the kernel that
+  // produces the value of retval `index` may write that value, or nullptr.
+  // The buffer is only a hint: the value passed to `SetRetval()` may or may
+  // not share it.
+  virtual const Tensor* GetRetvalBuffer(int index) const { return nullptr; }
 };
 
 // Represents a function call frame. I.e., the data structure used to
@@ -40,6 +40,11 @@ auto* aot_bef_mlir_load_count = tsl::monitoring::Counter<0>::New(
     "The number of times BEF and MLIR are deserialized instead of generated "
     "and used.");
 
+auto* aot_mlrt_mlir_load_count = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/aot_mlrt_mlir_load_count",
+    "The number of times MLRT bytecode and MLIR are deserialized instead of "
+    "generated and used.");
+
 auto* graph_runs = tsl::monitoring::Counter<0>::New(
     "/tensorflow/core/graph_runs",
     "The number of graph executions used to collect "
@@ -61,6 +66,21 @@ auto* graph_pending_queue_length_histogram = tsl::monitoring::Sampler<0>::New(
     // Power of 1.5 with bucket count 30 (> 191k)
     {tsl::monitoring::Buckets::Exponential(1, 1.5, 30)});
 
+auto* collective_launch_wait_usecs = tsl::monitoring::Sampler<1>::New(
+    {"/tensorflow/core/collective_launch_wait_usecs",
+     "The time collectives waited for a launch slot in their executor.",
+     "collective"},
+    // Power of 2 with bucket count 24 (> 16s)
+    {tsl::monitoring::Buckets::Exponential(1, 2, 24)});
+
+auto* op_latency_usecs = tsl::monitoring::Sampler<1>::New(
+    {"/tensorflow/core/op_latency_usecs",
+     "The compute time of synchronous kernels in the steps sampled by "
+     "TF_OP_LATENCY_SAMPLING_INTERVAL.",
+     "op"},
+    // Power of 2 with bucket count 24 (> 16s)
+    {tsl::monitoring::Buckets::Exponential(1, 2, 24)});
+
 auto* graph_run_input_tensor_bytes = tsl::monitoring::Sampler<0>::New(
     {"/tensorflow/core/graph_run_input_tensor_bytes",
      "The size of input tensors in bytes."},
@@ -228,6 +248,14 @@ auto* tf_data_service_snapshot_bytes_committed =
         "/tensorflow/data/service/snapshot_bytes_committed",
         "tf.data service distributed snapshot committed bytes.");
 
+auto* tf_data_service_snapshot_chunk_read_throughput =
+    tsl::monitoring::Sampler<0>::New(
+        {"/tensorflow/data/service/snapshot_chunk_read_throughput",
+         "Megabytes per second read from each tf.data service distributed "
+         "snapshot chunk."},
+        // Power of 2 with bucket count 16 (1 MB/s to about 32 GB/s).
+        {tsl::monitoring::Buckets::Exponential(1, 2, 16)});
+
 auto* tf_data_service_snapshot_ops_counter = tsl::monitoring::Counter<2>::New(
     "/tensorflow/data/service/snapshot_ops",
     "Number times a tf.data snapshot is saved/loaded.", "path", "op");
@@ -648,6 +676,11 @@ void RecordTFDataServiceSnapshotBytesCommitted(int64_t bytes) {
   tf_data_service_snapshot_bytes_committed->GetCell()->IncrementBy(bytes);
 }
 
+void RecordTFDataServiceSnapshotChunkReadThroughput(double mb_per_second) {
+  tf_data_service_snapshot_chunk_read_throughput->GetCell()->Add(
+      mb_per_second);
+}
+
 void RecordTFDataServiceSnapshotOp(const std::string& path,
                                    const std::string& op) {
   tf_data_service_snapshot_ops_counter->GetCell(path, op)->IncrementBy(1);
@@ -742,6 +775,12 @@ void UpdateAotBefMlirLoadCount() {
   aot_bef_mlir_load_count_cell->IncrementBy(1);
 }
 
+void UpdateAotMlrtMlirLoadCount() {
+  static auto* aot_mlrt_mlir_load_count_cell =
+      aot_mlrt_mlir_load_count->GetCell();
+  aot_mlrt_mlir_load_count_cell->IncrementBy(1);
+}
+
 void UpdateGraphExecTime(const uint64 running_time_usecs) {
   if (running_time_usecs > 0) {
     static auto* graph_runs_cell = graph_runs->GetCell();
@@ -760,6 +799,15 @@ void UpdateGraphPendingQueueLength(uint64 len) {
   graph_pending_queue_length_cell->Add(len);
 }
 
+void RecordCollectiveLaunchWait(const string& collective_name,
+                                uint64 wait_usecs) {
+  collective_launch_wait_usecs->GetCell(collective_name)->Add(wait_usecs);
+}
+
+void RecordOpLatency(const string& op_type, uint64 latency_usecs) {
+  op_latency_usecs->GetCell(op_type)->Add(latency_usecs);
+}
+
 void UpdateGraphBuildTime(const uint64 running_time_usecs) {
   if (running_time_usecs > 0) {
     static auto* build_graph_calls_cell = build_graph_calls->GetCell();
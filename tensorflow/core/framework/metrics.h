@@ -184,6 +184,10 @@ void RecordTFDataServiceCrossTrainerCacheSizeBytes(size_t bytes);
 // Records tf.data distributed snapshot bytes committed.
 void RecordTFDataServiceSnapshotBytesCommitted(int64_t bytes);
 
+// Records the throughput of reading one tf.data distributed snapshot chunk,
+// in megabytes per second.
+void RecordTFDataServiceSnapshotChunkReadThroughput(double mb_per_second);
+
 // Records tf.data distributed snapshot save/load ops.
 void RecordTFDataServiceSnapshotOp(const std::string& path,
                                    const std::string& op);
@@ -246,6 +250,15 @@ void RecordTPUXlaSpmdCoresPerReplica(int64_t cores_per_replica);
 void UpdateGraphExecTime(const uint64 running_time_usecs);
 void UpdateGraphPendingQueueLength(uint64 len);
 
+// Records how long a collective implemented by `collective_name` waited for
+// one of the bounded launch slots of its collective executor.
+void RecordCollectiveLaunchWait(const string& collective_name,
+                                uint64 wait_usecs);
+
+// Records the time a kernel of op type `op_type` took to compute in a step
+// sampled by the graph executor.
+void RecordOpLatency(const string& op_type, uint64 latency_usecs);
+
 // Records that one output of an op of type `op_name` was unused.
 void RecordUnusedOutput(const string& op_name);
 
@@ -259,6 +272,9 @@ void UpdatePersistentCacheLoadCount();
 // Increments the count of BEF and MLIR deserialized.
 void UpdateAotBefMlirLoadCount();
 
+// Increments the count of MLRT bytecode and MLIR deserialized.
+void UpdateAotMlrtMlirLoadCount();
+
 // Updates the metrics stored about time spent building graphs.
 //
 // By "GraphBuild", we refer to building a client graph, which is a sub-graph of
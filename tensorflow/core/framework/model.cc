@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <queue>
 
@@ -63,6 +64,14 @@ constexpr double kBufferDownsizeMultipliter = 0.9;
 // Threshold of low buffer watermark before a buffer is a candidate for
 // upsizing.
 constexpr int64_t kBufferLowWatermarkThreshold = 2;
+// The consumer-wait-based optimization increases parallelism when the consumer
+// waits for more than this fraction of its time in `GetNext()`, and only
+// decreases it when the consumer waits for less than the second fraction.
+constexpr double kConsumerWaitUpsizeFraction = 0.05;
+constexpr double kConsumerWaitDownsizeFraction = 0.01;
+// When decreasing parallelism, the consumer-wait-based optimization keeps the
+// time of every stage below this fraction of the target time.
+constexpr double kConsumerWaitDownsizeTargetFraction = 0.9;
 
 constexpr char kDataService[] = "DataService";
 constexpr char kFlatMap[] = "FlatMap";
@@ -2385,6 +2394,10 @@ void Model::Optimize(AutotuneAlgorithm algorithm,
       OptimizeStageBased(snapshot, optimization_params, cancellation_manager,
                          ram_budget_manager);
       break;
+    case AutotuneAlgorithm::CONSUMER_WAIT:
+      OptimizeConsumerWait(snapshot, optimization_params, cancellation_manager,
+                           ram_budget_manager);
+      break;
     default:
       VLOG(2) << "Autotuning algorithm was not recognized. Aborting "
                  "optimization.";
@@ -2556,11 +2569,13 @@ Status Model::OptimizeLoop(AutotuneAlgorithm algorithm,
     int64_t start_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
     double model_input_time = 0.0;
     // Model input time is set to 0 for all optimization algorithms except for
-    // stage-based optimization algorithm for historical reason. In stage-based
-    // optimization algorithm, the model input time is used as a target
+    // stage-based and consumer wait optimization algorithms for historical
+    // reason. In these algorithms, the model input time is used as a target
     // optimization time of all stages in the pipeline.
     if (algorithm == AutotuneAlgorithm::STAGE_BASED) {
       model_input_time = ComputeTargetTimeNsec();
+    } else if (algorithm == AutotuneAlgorithm::CONSUMER_WAIT) {
+      model_input_time = ComputeExperimentalTargetTimeNsec();
     }
     Optimize(algorithm, cpu_budget_func, ram_budget_share, fixed_ram_budget,
              model_input_time, ram_budget_manager, cancellation_manager);
@@ -2754,6 +2769,17 @@ void Model::RecordIteratorGapTime(uint64_t duration_usec) {
   }
 }
 
+void Model::RecordIteratorWaitTime(uint64_t duration_usec) {
+  mutex_lock l(gap_mu_);
+  if (duration_usec >= absl::ToInt64Microseconds(kGapDurationUpperThreshold)) {
+    return;
+  }
+  wait_times_usec_.push_back(duration_usec);
+  while (wait_times_usec_.size() > kGapTimeWindow) {
+    wait_times_usec_.pop_front();
+  }
+}
+
 double Model::ComputeTargetTimeNsec() {
   tf_shared_lock l(gap_mu_);
   if (gap_times_usec_.size() < kGapTimeWindow) {
@@ -2785,6 +2811,22 @@ double Model::ComputeExperimentalTargetTimeNsec() {
          1.0e3;
 }
 
+double Model::ComputeConsumerWaitFraction() {
+  tf_shared_lock l(gap_mu_);
+  if (gap_times_usec_.size() < kGapTimeWindow ||
+      wait_times_usec_.size() < kGapTimeWindow) {
+    return -1.0;
+  }
+  const double gap_usec =
+      std::accumulate(gap_times_usec_.begin(), gap_times_usec_.end(), 0.0);
+  const double wait_usec =
+      std::accumulate(wait_times_usec_.begin(), wait_times_usec_.end(), 0.0);
+  if (gap_usec + wait_usec <= 0.0) {
+    return -1.0;
+  }
+  return wait_usec / (gap_usec + wait_usec);
+}
+
 double Model::ComputeSnapshotProcessingTimeNsec() const {
   std::unique_ptr<ModelTiming> model_timing = nullptr;
   {
@@ -3002,6 +3044,119 @@ void Model::OptimizeStageBasedNonAsyncInterleaveManyNodes(
   }
 }
 
+void Model::OptimizeConsumerWait(std::shared_ptr<Node> snapshot,
+                                 const OptimizationParams& optimization_params,
+                                 CancellationManager* cancellation_manager,
+                                 RamBudgetManager& ram_budget_manager) {
+  const double wait_fraction = ComputeConsumerWaitFraction();
+  const double target_time_nsec = optimization_params.model_input_time();
+  VLOG(2) << "Starting optimization of tunable parameters with consumer wait "
+             "optimization with a wait fraction of "
+          << wait_fraction << " and a target time of " << target_time_nsec
+          << " nanoseconds.";
+  if (wait_fraction < 0.0 || target_time_nsec <= 0.0) {
+    // Keep the current parameters until the consumer has been measured.
+    metrics::RecordTFDataAutotuneStoppingCriteria("not_enough_measurements");
+    return;
+  }
+  Node::NodeVector all_nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  all_nodes.push_back(snapshot);
+  Node::ModelParameters tunable_parameters;
+  int64_t total_parallelism = 0;
+  for (const auto& node : all_nodes) {
+    for (auto& pair : node->CollectNodeTunableParameters()) {
+      if (pair.second->name != kParallelism) {
+        continue;
+      }
+      total_parallelism += std::round(pair.second->value);
+      tunable_parameters.push_back(std::move(pair));
+    }
+  }
+  ModelTiming model_timing(snapshot);
+  NodeParallelismParameters node_parallelism;
+  if (wait_fraction > kConsumerWaitUpsizeFraction) {
+    // The consumer is starving: speed up the slowest stages as long as the
+    // threads they add fit in the CPU budget.
+    ModelTimingPriorityQueue priority_queue(model_timing);
+    while (!cancellation_manager->IsCancelled()) {
+      absl::StatusOr<std::pair<double, Node*>> critical_root_status =
+          priority_queue.PopSlowestStageRoot();
+      if (!critical_root_status.ok()) {
+        metrics::RecordTFDataAutotuneStoppingCriteria("empty_critical_queue");
+        break;
+      }
+      std::pair<double, Node*> critical_root = critical_root_status.value();
+      if (critical_root.first <= target_time_nsec) {
+        break;
+      }
+      if (total_parallelism >= optimization_params.cpu_budget()) {
+        metrics::RecordTFDataAutotuneStoppingCriteria("cpu_budget_reached");
+        break;
+      }
+      Parameter* parallelism_parameter =
+          node_parallelism.Get(critical_root.second);
+      if (parallelism_parameter == nullptr ||
+          parallelism_parameter->value >= parallelism_parameter->max) {
+        metrics::RecordTFDataAutotuneStoppingCriteria(strings::StrCat(
+            "parameter_max_exceeded:",
+            RemoveArrayIndices(critical_root.second->long_name())));
+        break;
+      }
+      parallelism_parameter->value += 1.0;
+      if (TotalMaximumBufferedBytes(snapshot) >
+          optimization_params.ram_budget()) {
+        parallelism_parameter->value -= 1.0;
+        metrics::RecordTFDataAutotuneStoppingCriteria(strings::StrCat(
+            "ram_budget_exceeded:",
+            RemoveArrayIndices(critical_root.second->long_name())));
+        break;
+      }
+      ++total_parallelism;
+      model_timing.ComputeNodeTotalTime(*critical_root.second);
+      const ModelTiming::NodeTiming* root_timing =
+          model_timing.GetTiming(critical_root.second);
+      if (critical_root.first <=
+          root_timing->total_time_nsec * root_timing->pipeline_ratio) {
+        parallelism_parameter->value -= 1.0;
+        metrics::RecordTFDataAutotuneStoppingCriteria(strings::StrCat(
+            "total_time_not_improved:",
+            RemoveArrayIndices(critical_root.second->long_name())));
+        break;
+      }
+      priority_queue.Push(critical_root.second, *root_timing);
+    }
+  } else if (wait_fraction < kConsumerWaitDownsizeFraction) {
+    // The consumer rarely waits: give back the threads that stages do not
+    // need to keep up with the consumer.
+    const double max_stage_time_nsec =
+        target_time_nsec * kConsumerWaitDownsizeTargetFraction;
+    for (const auto& root : model_timing.GetStageRoots()) {
+      Parameter* parallelism_parameter = node_parallelism.Get(root.get());
+      if (parallelism_parameter == nullptr) {
+        continue;
+      }
+      while (!cancellation_manager->IsCancelled() &&
+             parallelism_parameter->value > parallelism_parameter->min) {
+        parallelism_parameter->value -= 1.0;
+        model_timing.ComputeNodeTotalTime(*root);
+        const ModelTiming::NodeTiming* root_timing =
+            model_timing.GetTiming(root.get());
+        if (root_timing->total_time_nsec * root_timing->pipeline_ratio >
+            max_stage_time_nsec) {
+          parallelism_parameter->value += 1.0;
+          model_timing.ComputeNodeTotalTime(*root);
+          break;
+        }
+      }
+    }
+  }
+  if (ram_budget_manager.RequestModelAllocation(
+          TotalMaximumBufferedBytes(snapshot))) {
+    UpdateStateValues(&tunable_parameters);
+  }
+}
+
 void Model::OptimizeBuffers(std::shared_ptr<Node> snapshot,
                             int64_t ram_budget) {
   VLOG(2) << "Starting optimization of buffer_size parameters.";
@@ -1009,6 +1009,9 @@ class Model {
   // Records gap time between consecutive `GetNext()` calls.
   void RecordIteratorGapTime(uint64_t duration_usec);
 
+  // Records the time the consumer waited in a `GetNext()` call.
+  void RecordIteratorWaitTime(uint64_t duration_usec);
+
   // Computes the target time in nsecs to use for `STAGE_BASED` autotune
   // algorithm. Returns 0 if there if there are not sufficient recorded iterator
   // gap times to produce a good estimate.
@@ -1019,6 +1022,11 @@ class Model {
   // produce a good estimate.
   double ComputeExperimentalTargetTimeNsec();
 
+  // Returns the fraction of its time that the consumer spends waiting in
+  // `GetNext()`, or a negative value if there are not sufficient recorded
+  // gap and wait times.
+  double ComputeConsumerWaitFraction();
+
   // Returns the time in nanoseconds it takes the pipeline to produce an
   // element, according to the latest model snapshot obtained from optimization.
   // Returns 0 if the model snapshot is empty or null. This may be caused by not
@@ -1134,6 +1142,17 @@ class Model {
       CancellationManager* cancellation_manager,
       RamBudgetManager& ram_budget_manager);
 
+  // This optimization treats the time the consumer waits in `GetNext()` as the
+  // objective and the parallelism of the pipeline as its CPU cost. Starting
+  // from the current parameter values, it increases the parallelism of the
+  // slowest stage by 1 while the consumer is starving and the total
+  // parallelism is within the CPU budget, and decreases the parallelism of
+  // stages that stay faster than the consumer when the consumer rarely waits.
+  void OptimizeConsumerWait(std::shared_ptr<Node> snapshot,
+                            const OptimizationParams& optimization_params,
+                            CancellationManager* cancellation_manager,
+                            RamBudgetManager& ram_budget_manager);
+
   // Determines if we should stop the gradient descent optimization iterations
   // based on number of increasable parameters, CPU budget, RAM budget and
   // current resource usage.
@@ -1194,6 +1213,8 @@ class Model {
   mutable mutex gap_mu_;
   // Stores the latest gap times between consecutive `GetNext()`.
   std::deque<uint64_t> gap_times_usec_ TF_GUARDED_BY(gap_mu_);
+  // Stores the latest times the consumer waited in `GetNext()`.
+  std::deque<uint64_t> wait_times_usec_ TF_GUARDED_BY(gap_mu_);
   // The experiment that this job is part of.
   absl::flat_hash_set<std::string> experiments_;
   // Stores the optimization snapshot of the Model.
@@ -377,6 +377,9 @@ Allocator* OpKernelContext::get_allocator(AllocatorAttributes attr) {
   if (TF_PREDICT_FALSE(attr.scope_id > 0)) {
     allocator = params_->device->GetScopedAllocator(attr, step_id());
     CHECK(allocator);
+  } else if (TF_PREDICT_FALSE(params_->step_allocator != nullptr) &&
+             attr.value == 0) {
+    allocator = params_->step_allocator;
   } else {
     allocator = params_->device->GetAllocator(attr);
   }
@@ -819,6 +822,17 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
       op_kernel().name_view().data(), step_id(), "output", type,
       [&shape]() { return shape.DebugString(); });
   auto output_tensor = std::make_unique<Tensor>();
+  const Tensor* buffer = params_->output_buffers != nullptr
+                             ? params_->output_buffers[index]
+                             : nullptr;
+  if (buffer != nullptr && buffer->dtype() == type &&
+      DataTypeCanUseMemcpy(type) && buffer->IsAligned() &&
+      buffer->NumElements() == shape.num_elements() &&
+      output_tensor->CopyFrom(*buffer, shape)) {
+    outputs_[index] = TensorValue(output_tensor.release());
+    *output = outputs_[index].tensor;
+    return OkStatus();
+  }
   Status s = allocate_tensor(type, shape, output_tensor.get(), attr);
   if (s.ok()) {
     outputs_[index] = TensorValue(output_tensor.release());
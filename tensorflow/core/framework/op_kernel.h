@@ -619,6 +619,11 @@ class OpKernelContext {
     bool track_allocations = false;
     bool log_memory = false;
 
+    // If not null, allocations with default `AllocatorAttributes` are served
+    // by this allocator instead of by the device's allocator. This is used to
+    // serve the tensors of a step from a per-step arena.
+    Allocator* step_allocator = nullptr;
+
     // Array indexed by output number for this node
     const AllocatorAttributes* output_attr_array = nullptr;
 
@@ -696,6 +701,13 @@ class OpKernelContext {
     // outputs are required.
     bool* outputs_required_array = nullptr;
 
+    // If non-null, contains an array of num_outputs pointers, where a non-null
+    // ith entry is a caller-owned buffer into which `allocate_output()` places
+    // the ith output when the buffer is aligned and has the requested
+    // (memcpy-able) type and number of elements. Used to write fetched outputs
+    // directly into caller memory.
+    const Tensor* const* output_buffers = nullptr;
+
     // For access to distributed coordination service.
     tsl::CoordinationServiceAgent* coordination_service_agent = nullptr;
   };
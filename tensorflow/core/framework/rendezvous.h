@@ -31,6 +31,12 @@ namespace tensorflow {
 
 class DeviceMgr;
 
+// The attribute of a node whose output should be encoded with the named
+// TensorWireCodec when it is received from another worker. Graph
+// partitioning copies it from the producer to the "_Recv" node of each
+// edge.
+inline constexpr char kWireCodecAttr[] = "_wire_codec";
+
 // A Rendezvous is an abstraction for passing tensors from producers
 // to consumers. A rendezvous is a table of channels. Each channel is
 // keyed by a rendezvous key. The key encodes a pair of <producer,
@@ -53,6 +59,9 @@ class RendezvousInterface {
     DeviceContext* device_context = nullptr;
     AllocatorAttributes alloc_attrs;
     CancellationManager* cancellation_manager = nullptr;  // not owned.
+    // Optional name of the TensorWireCodec with which a remote tensor is
+    // received. Ignored by local rendezvous.
+    std::string wire_codec;
   };
 
   // Parses the key constructed by CreateKey and parse src/dst device
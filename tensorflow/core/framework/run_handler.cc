@@ -43,6 +43,13 @@ static constexpr int32_t kMaxConcurrentHandlers = 128;
 typedef typename internal::RunHandlerEnvironment::Task Task;
 typedef Eigen::RunQueue<Task, 1024> Queue;
 
+auto* task_queueing_time = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/run_handler/task_queueing_time",
+     "Time in microseconds that tasks wait in the queues of a RunHandler, by "
+     "request priority.",
+     "priority"},
+    monitoring::Buckets::Exponential(1, 2, 24));
+
 }  // namespace
 
 namespace internal {
@@ -76,6 +83,7 @@ RunHandlerEnvironment::Task RunHandlerEnvironment::CreateTask(
           std::move(f),
           Context(ContextKind::kThread),
           id,
+          EnvTime::NowMicros(),
       }),
   };
 }
@@ -130,6 +138,7 @@ ThreadWorkSource::ThreadWorkSource()
       blocking_inflight_(0),
       non_blocking_inflight_(0),
       traceme_id_(0),
+      queueing_time_cell_(nullptr),
       version_(0),
       sub_thread_pool_waiter_(nullptr) {
   queue_waiters_.next = &queue_waiters_;
@@ -259,6 +268,18 @@ int64_t ThreadWorkSource::GetTracemeId() {
 
 void ThreadWorkSource::SetTracemeId(int64_t value) { traceme_id_ = value; }
 
+void ThreadWorkSource::SetPriority(int64_t priority) {
+  queueing_time_cell_.store(
+      task_queueing_time->GetCell(strings::StrCat(priority)),
+      std::memory_order_relaxed);
+}
+
+void ThreadWorkSource::RecordQueueingTime(const Task& t) {
+  auto* cell = queueing_time_cell_.load(std::memory_order_relaxed);
+  if (cell == nullptr) return;
+  cell->Add(EnvTime::NowMicros() - t.f->enqueue_time_us);
+}
+
 void ThreadWorkSource::SetWaiter(uint64 version, Waiter* waiter, mutex* mutex) {
   {
     tf_shared_lock lock(run_handler_waiter_mu_);
@@ -324,6 +345,8 @@ RunHandlerThreadPool::RunHandlerThreadPool(
       queue_waiters_(queue_waiters),
       use_sub_thread_pool_(ParamFromEnvBoolWithDefault(
           "TF_RUN_HANDLER_USE_SUB_THREAD_POOL", false)),
+      strict_priority_(ParamFromEnvBoolWithDefault(
+          "TF_RUN_HANDLER_STRICT_PRIORITY", false)),
       num_threads_in_sub_thread_pool_(ParamFromEnvWithDefault(
           "TF_RUN_HANDLER_NUM_THREADS_IN_SUB_THREAD_POOL",
           std::vector<int>({num_blocking_threads / 2,
@@ -415,6 +438,8 @@ void RunHandlerThreadPool::SetThreadWorkSources(
     return;
   }
   thread_data_[tid].new_thread_work_sources->resize(0);
+  // Keep the priority order instead of spreading the threads over requests.
+  if (strict_priority_) start_request_idx = 0;
   if (use_sub_thread_pool_) {
     for (int i = 0; i < thread_work_sources.size(); ++i) {
       thread_data_[tid].new_thread_work_sources->emplace_back(
@@ -492,7 +517,11 @@ Task RunHandlerThreadPool::FindTask(
     const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources,
     bool* task_from_blocking_queue, ThreadWorkSource** tws) {
   Task t;
-  int current_index = thread_data_[thread_id].current_index;
+  // The work sources are sorted by priority, so starting from the beginning of
+  // the range serves the highest priority requests first.
+  int current_index = strict_priority_
+                          ? searching_range_start
+                          : thread_data_[thread_id].current_index;
   *task_from_blocking_queue = false;
 
   for (int i = 0; i < searching_range_end - searching_range_start; ++i) {
@@ -631,6 +660,7 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
           profiler::TraceMeLevel::kInfo);
       VLOG(2) << "Running " << (task_from_blocking_queue ? "inter" : "intra")
               << " work from " << tws->GetTracemeId();
+      tws->RecordQueueingTime(t);
       tws->IncrementInflightTaskCount(task_from_blocking_queue);
       env_.ExecuteTask(t);
       tws->DecrementInflightTaskCount(task_from_blocking_queue);
@@ -1081,6 +1111,7 @@ void RunHandler::Impl::Reset(
   step_id_ = step_id;
   options_ = options;
   tws_.SetTracemeId(step_id);
+  tws_.SetPriority(options.priority());
 }
 
 RunHandlerPool::RunHandlerPool(int num_inter_op_threads)
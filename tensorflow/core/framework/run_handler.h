@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/histogram/histogram.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -82,7 +83,10 @@ class RunHandlerPool {
 // RunHandler can be used to schedule inter/intra-op closures to run on a global
 // pool shared across all Session::Run(s). The closures are enqueued to a
 // handler specific queue, from which the work is stolen in a priority order
-// (time of the Get() call).
+// (`RunHandlerPoolOptions::priority`, then time of the Get() call). If the
+// TF_RUN_HANDLER_STRICT_PRIORITY environment variable is true, threads always
+// look for work from the highest priority handlers first, so that lower
+// priority requests yield to higher priority ones between tasks.
 //
 // It can only be created via RunHandlerPool::Get().
 //
@@ -116,6 +120,7 @@ class RunHandlerEnvironment {
     std::function<void()> f;
     Context context;
     uint64 trace_id;
+    uint64 enqueue_time_us;
   };
   Env* const env_;
   const ThreadOptions thread_options_;
@@ -174,6 +179,12 @@ class ThreadWorkSource {
 
   void SetTracemeId(int64_t value);
 
+  // Sets the priority of the request, which labels the queueing time metric.
+  void SetPriority(int64_t priority);
+
+  // Records the time `t` spent in the queues.
+  void RecordQueueingTime(const Task& t);
+
   void SetWaiter(uint64 version, Waiter* waiter, mutex* mutex);
 
   int64_t GetInflightTaskCount(bool is_blocking);
@@ -205,6 +216,7 @@ class ThreadWorkSource {
   mutex waiters_mu_;
   Waiter queue_waiters_ TF_GUARDED_BY(waiters_mu_);
   std::atomic<int64_t> traceme_id_;
+  std::atomic<monitoring::SamplerCell*> queueing_time_cell_;
 
   mutex run_handler_waiter_mu_;
   uint64 version_ TF_GUARDED_BY(run_handler_waiter_mu_);
@@ -299,6 +311,8 @@ class RunHandlerThreadPool {
   Eigen::MaxSizeVector<Waiter>* queue_waiters_;
 
   bool use_sub_thread_pool_;
+  // If true, threads search the work sources in priority order every time.
+  bool strict_priority_;
   std::vector<int> num_threads_in_sub_thread_pool_;
 
   // Threads in each sub thread pool will search tasks from the given
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/memory_types.h"
 #include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/versions.pb.h"
@@ -290,6 +291,12 @@ NodeDef* AddRecv(const PartitionOptions& opts, const GraphInfo& g_info,
   SetSendRecvAttrs(opts, edge, tensor_name_attr, &recv_builder);
   recv_builder.Device(dst->assigned_device_name())
       .Attr("tensor_type", cast_dtype);
+  // Let the producer choose how its output is encoded on the wire.
+  string wire_codec;
+  if (!edge->IsControlEdge() &&
+      TryGetNodeAttr(src->attrs(), kWireCodecAttr, &wire_codec)) {
+    recv_builder.Attr(kWireCodecAttr, wire_codec);
+  }
   NodeDef* recv = gdef->add_node();
   *status = recv_builder.Finalize(recv, /*consume=*/true);
   if (!status->ok()) return nullptr;
@@ -34,7 +34,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_debug_info_builder.h"
@@ -563,6 +565,31 @@ TEST_F(GraphPartitionTest, SetIncarnation) {
   }
 }
 
+TEST_F(GraphPartitionTest, WireCodec) {
+  auto a1 = FloatInput(in_.WithOpName("A1"));
+  auto b1 = FloatInput(in_.WithOpName("B1"));
+  Combine(in_.WithOpName("B2"), a1, b1);
+  GraphDef gdef = ToGraphDef();
+  for (NodeDef& ndef : *gdef.mutable_node()) {
+    if (ndef.name() == "A1") {
+      AddNodeAttr(kWireCodecAttr, "snappy", &ndef);
+    }
+  }
+
+  Partition(gdef, &partitions_);
+  EXPECT_EQ(2, partitions_.size());
+  int num_recvs = 0;
+  for (const NodeDef& ndef :
+       partitions_["/job:a/replica:0/task:0/cpu:1"].node()) {
+    if (ndef.op() != "_Recv") continue;
+    ++num_recvs;
+    string wire_codec;
+    TF_EXPECT_OK(GetNodeAttr(ndef, kWireCodecAttr, &wire_codec));
+    EXPECT_EQ(wire_codec, "snappy");
+  }
+  EXPECT_EQ(num_recvs, 1);
+}
+
 TEST_F(GraphPartitionTest, GraphDebugInfo) {
   GraphDef graph_def;
   Output a1 = FloatInput(in_.WithOpName("A1"));
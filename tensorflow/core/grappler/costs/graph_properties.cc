@@ -893,6 +893,12 @@ class SymbolicShapeRefiner {
     for (const auto& output_arg : grappler_function_item.outputs()) {
       output_nodes[output_arg.node_name] = gv.GetNode(output_arg.node_name);
     }
+    // ReplaceInputWithConst() also removes the replaced inputs, so keep the
+    // argument node of each function input.
+    std::vector<std::string> arg_node_names;
+    for (const auto& input_arg : grappler_function_item.inputs()) {
+      arg_node_names.push_back(input_arg.node_name);
+    }
 
     // Replace input nodes with Consts, if values are known. Note that
     // we don't check exceptions here as it's done in the above loop.
@@ -943,6 +949,25 @@ class SymbolicShapeRefiner {
         /*aggressive_shape_inference=*/aggressive_shape_inference_,
         /*include_tensor_values=*/true));
 
+    // Map the symbolic dimensions of the arguments in the function body back
+    // to the dimensions of the function inputs, so that the function outputs
+    // keep the identity of unknown input dimensions (e.g. the batch size).
+    absl::flat_hash_map<int64_t, DimensionHandle> arg_dims;
+    for (int i = 0, end = arg_node_names.size(); i < end; ++i) {
+      const auto& arg_props = gp.GetOutputProperties(arg_node_names[i]);
+      if (arg_props.empty() || !ic->RankKnown(ic->input(i))) continue;
+      const TensorShapeProto& arg_shape = arg_props[0].shape();
+      if (arg_shape.unknown_rank() ||
+          arg_shape.dim_size() != ic->Rank(ic->input(i))) {
+        continue;
+      }
+      for (int d = 0; d < arg_shape.dim_size(); ++d) {
+        if (arg_shape.dim(d).size() < -1) {
+          arg_dims.emplace(arg_shape.dim(d).size(), ic->Dim(ic->input(i), d));
+        }
+      }
+    }
+
     // Add return nodes for output shapes.
     int output = 0;
     ctx->output_tensors_as_shapes.resize(grappler_function_item.output_size());
@@ -969,9 +994,22 @@ class SymbolicShapeRefiner {
       }
       auto& outprop = output_properties[out_tensor.index()];
       TensorShapeProto shape = outprop.shape();
-      NormalizeShapeForOutput(&shape);
       ShapeHandle out;
-      TF_RETURN_IF_ERROR(ic->MakeShapeFromShapeProto(shape, &out));
+      if (shape.unknown_rank()) {
+        out = ic->UnknownShape();
+      } else {
+        std::vector<DimensionHandle> dims;
+        for (const auto& dim : shape.dim()) {
+          auto arg_dim = arg_dims.find(dim.size());
+          if (arg_dim != arg_dims.end()) {
+            dims.push_back(arg_dim->second);
+          } else {
+            // There may be dim.size < -1 in SymbolicShapeRefiner.
+            dims.push_back(ic->MakeDim(std::max<int64_t>(dim.size(), -1)));
+          }
+        }
+        out = ic->MakeShape(dims);
+      }
       ic->set_output(output, out);
       if (outprop.has_value()) {
         // Forward tensor value to output_tensors_as_shape.
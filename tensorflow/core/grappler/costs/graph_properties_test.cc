@@ -1711,6 +1711,39 @@ TEST_F(GraphPropertiesTest, FunctionWithScalarInput) {
   EXPECT_FALSE(out_prop0.shape().unknown_rank());
 }
 
+TEST_F(GraphPropertiesTest, FunctionKeepsSymbolicInputDims) {
+  // MyFunc(x) = Relu(x) keeps the unknown batch dimension of its input.
+  FunctionDefLibrary library;
+  *library.add_function() = FunctionDefHelper::Create(
+      "MyFunc",                                               // Name
+      {"x: float"},                                           // Inputs
+      {"out: float"},                                         // Outputs
+      {},                                                     // Attrs
+      {{{"a"}, "Relu", {"x"}, {{"T", DataType::DT_FLOAT}}}},  // Nodes
+      {{"out", "a:activations:0"}});                          // Returns
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  TF_ASSERT_OK(s.graph()->AddFunctionLibrary(library));
+  Output placeholder =
+      ops::Placeholder(s.WithOpName("Placeholder"), DataType::DT_FLOAT,
+                       ops::Placeholder::Shape(PartialTensorShape({-1, 3})));
+  auto _placeholder = tensorflow::ops::AsNodeOut(s, placeholder);
+  auto builder =
+      tensorflow::NodeBuilder("MyFunc", "MyFunc", s.graph()->op_registry());
+  tensorflow::Node* func_op;
+  TF_ASSERT_OK(builder.Input(_placeholder).Finalize(s.graph(), &func_op));
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  GraphProperties properties(item);
+  TF_ASSERT_OK(properties.InferStatically(true));
+  const auto in_prop = properties.GetOutputProperties("Placeholder")[0];
+  const auto out_prop = properties.GetOutputProperties("MyFunc")[0];
+  ASSERT_EQ(2, out_prop.shape().dim_size());
+  EXPECT_LT(in_prop.shape().dim(0).size(), -1);
+  EXPECT_EQ(in_prop.shape().dim(0).size(), out_prop.shape().dim(0).size());
+  EXPECT_EQ(3, out_prop.shape().dim(1).size());
+}
+
 TEST_F(GraphPropertiesTest, SimpleFunctionStaticShapeInference) {
   // Test graph produced in python using:
   /*
@@ -0,0 +1,321 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/static_memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+// The transitive closure of the graph is quadratic in the number of nodes, so
+// larger graphs are not planned.
+constexpr int kMaxNodes = 1 << 14;
+
+int64_t RoundUp(int64_t n) {
+  constexpr int64_t kAlignment = Allocator::kAllocatorAlignment;
+  return (n + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+bool IsOnCpu(const NodeDef& node) {
+  return node.device().empty() || NodeIsOnCpu(&node);
+}
+
+// Returns true if `node` may return views of (parts of) its inputs.
+bool MayReturnInputView(const NodeDef& node) {
+  return IsIdentity(node) || IsIdentityN(node) || IsSnapshot(node) ||
+         IsStopGradient(node) || IsReshape(node) || IsSqueeze(node) ||
+         node.op() == "ExpandDims" || IsBitcast(node) || IsSlice(node) ||
+         IsStridedSlice(node) || IsSplit(node) || IsSplitV(node) ||
+         IsUnpack(node);
+}
+
+// Returns true if `node` may keep a reference to its inputs beyond its own
+// execution.
+bool MayRetainInputs(const NodeDef& node) {
+  if (IsRetval(node) || IsSend(node) || !IsOnCpu(node)) return true;
+  const OpDef* op_def = nullptr;
+  if (!OpRegistry::Global()->LookUpOpDef(node.op(), &op_def).ok()) {
+    // Functions and unknown ops may do anything with their inputs.
+    return true;
+  }
+  return op_def->is_stateful();
+}
+
+// Returns true if `a` and `b` may share a buffer through input forwarding.
+bool MayForward(const OpInfo::TensorProperties& a,
+                const OpInfo::TensorProperties& b) {
+  if (a.dtype() != b.dtype()) return false;
+  const PartialTensorShape a_shape(a.shape());
+  const PartialTensorShape b_shape(b.shape());
+  if (!a_shape.IsFullyDefined() || !b_shape.IsFullyDefined()) return true;
+  return a_shape.num_elements() == b_shape.num_elements();
+}
+
+class DisjointSets {
+ public:
+  explicit DisjointSets(int n) : parent_(n) {
+    std::iota(parent_.begin(), parent_.end(), 0);
+  }
+  int Find(int x) {
+    while (parent_[x] != x) {
+      parent_[x] = parent_[parent_[x]];
+      x = parent_[x];
+    }
+    return x;
+  }
+  void Union(int a, int b) { parent_[Find(a)] = Find(b); }
+
+ private:
+  std::vector<int> parent_;
+};
+
+// A set of possibly aliased tensors that is planned as one buffer.
+struct Buffer {
+  bool plannable = true;
+  int64_t size = 0;
+  // The nodes that produce the tensors of the buffer, and the nodes that
+  // produce or consume them, by topological index.
+  std::vector<int> producers;
+  std::vector<int> users;
+  std::vector<int> tensors;
+  int64_t offset = -1;
+};
+
+}  // namespace
+
+Status PlanStaticMemory(const GrapplerItem& item,
+                        const GraphProperties& properties, MemoryPlan* plan) {
+  *plan = MemoryPlan();
+  const GraphDef& graph = item.graph;
+
+  for (const NodeDef& node : graph.node()) {
+    if (IsControlFlow(node)) {
+      return errors::Unimplemented(
+          "Static memory planning does not support control flow, found ",
+          node.name(), " (", node.op(), ")");
+    }
+  }
+
+  std::vector<const NodeDef*> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(graph, &topo_order));
+  const int num_nodes = topo_order.size();
+  if (num_nodes > kMaxNodes) {
+    return errors::Unimplemented("Static memory planning supports at most ",
+                                 kMaxNodes, " nodes, graph has ", num_nodes);
+  }
+
+  absl::flat_hash_map<string, int> node_index;
+  node_index.reserve(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) {
+    node_index[topo_order[i]->name()] = i;
+  }
+
+  // Number the outputs of every node. Nodes without output properties have
+  // no tensors that can be planned.
+  std::vector<int> first_tensor(num_nodes + 1, 0);
+  std::vector<int> tensor_node;
+  for (int i = 0; i < num_nodes; ++i) {
+    first_tensor[i] = tensor_node.size();
+    if (properties.HasOutputProperties(topo_order[i]->name())) {
+      const int num_outputs =
+          properties.GetOutputProperties(topo_order[i]->name()).size();
+      tensor_node.insert(tensor_node.end(), num_outputs, i);
+    }
+  }
+  first_tensor[num_nodes] = tensor_node.size();
+  const int num_tensors = tensor_node.size();
+  auto tensor_props = [&](int t) -> const OpInfo::TensorProperties& {
+    const int node = tensor_node[t];
+    return properties.GetOutputProperties(
+        topo_order[node]->name())[t - first_tensor[node]];
+  };
+
+  absl::flat_hash_set<string> fed;
+  for (const auto& feed : item.feed) {
+    fed.insert(NodeName(feed.first));
+  }
+  absl::flat_hash_set<string> fetched;
+  for (const string& fetch : item.fetch) {
+    fetched.insert(NodeName(fetch));
+  }
+
+  std::vector<bool> plannable(num_tensors, false);
+  std::vector<int64_t> tensor_size(num_tensors, 0);
+  for (int t = 0; t < num_tensors; ++t) {
+    const NodeDef& producer = *topo_order[tensor_node[t]];
+    const OpInfo::TensorProperties& props = tensor_props(t);
+    const PartialTensorShape shape(props.shape());
+    if (!shape.IsFullyDefined() || !DataTypeCanUseMemcpy(props.dtype()) ||
+        !IsOnCpu(producer) || IsConstant(producer) || IsPlaceholder(producer) ||
+        IsArg(producer) || fed.contains(producer.name()) ||
+        fetched.contains(producer.name()) || MayRetainInputs(producer)) {
+      continue;
+    }
+    tensor_size[t] = RoundUp(shape.num_elements() * DataTypeSize(props.dtype()));
+    plannable[t] = tensor_size[t] > 0;
+  }
+
+  // Ancestors of every node, as bitsets indexed by topological index.
+  const int words = (num_nodes + 63) / 64;
+  std::vector<uint64_t> ancestors(static_cast<size_t>(num_nodes) * words, 0);
+  auto ancestors_of = [&](int node) { return &ancestors[node * words]; };
+  auto is_ancestor = [&](int a, int b) {
+    return (ancestors_of(b)[a / 64] >> (a % 64)) & 1;
+  };
+
+  // Group the tensors that may alias each other, and record the consumers of
+  // each tensor.
+  DisjointSets aliases(num_tensors);
+  std::vector<std::vector<int>> consumers(num_tensors);
+  for (int i = 0; i < num_nodes; ++i) {
+    const NodeDef& node = *topo_order[i];
+    uint64_t* node_ancestors = ancestors_of(i);
+    const bool retains_inputs = MayRetainInputs(node);
+    const bool has_output_props = properties.HasOutputProperties(node.name());
+    for (const string& input : node.input()) {
+      const TensorId input_id = ParseTensorName(input);
+      auto it = node_index.find(input_id.node());
+      if (it == node_index.end()) {
+        return errors::InvalidArgument("Node ", node.name(),
+                                       " has an unknown input ", input);
+      }
+      const int producer = it->second;
+      const uint64_t* producer_ancestors = ancestors_of(producer);
+      for (int w = 0; w < words; ++w) {
+        node_ancestors[w] |= producer_ancestors[w];
+      }
+      node_ancestors[producer / 64] |= uint64_t{1} << (producer % 64);
+
+      if (input_id.index() < 0) continue;
+      const int t = first_tensor[producer] + input_id.index();
+      if (t >= first_tensor[producer + 1]) continue;
+      consumers[t].push_back(i);
+      if (retains_inputs || !has_output_props) {
+        plannable[t] = false;
+        continue;
+      }
+      const bool returns_view = MayReturnInputView(node);
+      for (int out = first_tensor[i]; out < first_tensor[i + 1]; ++out) {
+        if (returns_view || MayForward(tensor_props(t), tensor_props(out))) {
+          aliases.Union(t, out);
+        }
+      }
+    }
+  }
+
+  absl::flat_hash_map<int, int> buffer_index;
+  std::vector<Buffer> buffers;
+  for (int t = 0; t < num_tensors; ++t) {
+    auto inserted = buffer_index.emplace(aliases.Find(t), buffers.size());
+    if (inserted.second) buffers.emplace_back();
+    Buffer& buffer = buffers[inserted.first->second];
+    buffer.plannable &= plannable[t];
+    buffer.size = std::max(buffer.size, tensor_size[t]);
+    buffer.producers.push_back(tensor_node[t]);
+    buffer.users.push_back(tensor_node[t]);
+    buffer.users.insert(buffer.users.end(), consumers[t].begin(),
+                        consumers[t].end());
+    buffer.tensors.push_back(t);
+  }
+
+  // Returns true if every use of `a` happens before `b` is produced.
+  auto happens_before = [&](const Buffer& a, const Buffer& b) {
+    for (int producer : b.producers) {
+      for (int user : a.users) {
+        if (!is_ancestor(user, producer)) return false;
+      }
+    }
+    return true;
+  };
+
+  // Greedily place the largest buffers first, each one in the smallest gap
+  // left between the already placed buffers whose lifetimes overlap with it,
+  // as TFLite's ArenaPlanner does.
+  std::vector<Buffer*> order;
+  for (Buffer& buffer : buffers) {
+    if (buffer.plannable) order.push_back(&buffer);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const Buffer* a, const Buffer* b) {
+                     return a->size > b->size;
+                   });
+  std::vector<const Buffer*> placed;
+  std::vector<std::pair<int64_t, int64_t>> conflicts;
+  for (Buffer* buffer : order) {
+    conflicts.clear();
+    for (const Buffer* other : placed) {
+      if (!happens_before(*buffer, *other) &&
+          !happens_before(*other, *buffer)) {
+        conflicts.emplace_back(other->offset, other->offset + other->size);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+    int64_t best_offset = -1;
+    int64_t best_gap = std::numeric_limits<int64_t>::max();
+    int64_t current = 0;
+    for (const auto& conflict : conflicts) {
+      const int64_t gap = conflict.first - current;
+      if (gap >= buffer->size && gap < best_gap) {
+        best_offset = current;
+        best_gap = gap;
+      }
+      current = std::max(current, conflict.second);
+    }
+    buffer->offset = best_offset >= 0 ? best_offset : current;
+    plan->slab_size = std::max(plan->slab_size, buffer->offset + buffer->size);
+    placed.push_back(buffer);
+  }
+
+  for (int t = 0; t < num_tensors; ++t) {
+    const Buffer& buffer = buffers[buffer_index[aliases.Find(t)]];
+    if (!buffer.plannable) continue;
+    MemoryPlan::PlannedTensor tensor;
+    tensor.node = topo_order[tensor_node[t]]->name();
+    tensor.output_id = t - first_tensor[tensor_node[t]];
+    tensor.offset = buffer.offset;
+    tensor.size = tensor_size[t];
+    plan->total_tensor_bytes += tensor.size;
+    plan->tensors.push_back(std::move(tensor));
+  }
+  return OkStatus();
+}
+
+Status PlanStaticMemory(const GrapplerItem& item, MemoryPlan* plan) {
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(properties.InferStatically(
+      /*assume_valid_feeds=*/false, /*aggressive_shape_inference=*/false,
+      /*include_tensor_values=*/false));
+  return PlanStaticMemory(item, properties, plan);
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,76 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_STATIC_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_STATIC_MEMORY_PLANNER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// A static, offset-based memory plan for the CPU tensors of a graph, in the
+// spirit of TFLite's ArenaPlanner: every planned tensor is assigned a fixed
+// offset into a single slab of `slab_size` bytes, and two tensors share bytes
+// of the slab only if their lifetimes can never overlap.
+struct MemoryPlan {
+  struct PlannedTensor {
+    string node;
+    int output_id;
+    // Offset of the tensor in the slab. Always a multiple of
+    // Allocator::kAllocatorAlignment.
+    int64_t offset;
+    int64_t size;
+  };
+
+  // Size of the slab needed to hold every planned tensor.
+  int64_t slab_size = 0;
+  // Sum of the sizes of the planned tensors, i.e. the memory they would need
+  // if every one of them was given its own buffer.
+  int64_t total_tensor_bytes = 0;
+  std::vector<PlannedTensor> tensors;
+};
+
+// Computes a MemoryPlan for `item`.
+//
+// Lifetimes are derived from the data and control dependencies of the graph
+// rather than from a simulated schedule, so that the plan is valid for every
+// order in which the (parallel) executor may run the nodes: the buffers of two
+// tensors only overlap if all the uses of one of them are ancestors of the
+// producers of the other.
+//
+// A tensor is planned only if its shape is fully defined, its type can be
+// copied with memcpy, it lives on the CPU, and it does not escape the step,
+// i.e. it is not fetched and is not consumed by a stateful op (which may hold
+// on to it). Since outputs may alias their inputs (through input forwarding,
+// or ops such as Identity, Reshape or Slice that return views), possibly
+// aliased tensors are planned as a single buffer that lives as long as the
+// longest lived of them.
+//
+// Graphs with control flow are not supported.
+Status PlanStaticMemory(const GrapplerItem& item,
+                        const GraphProperties& properties, MemoryPlan* plan);
+
+// As above, but infers the properties of `item` statically.
+Status PlanStaticMemory(const GrapplerItem& item, MemoryPlan* plan);
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_STATIC_MEMORY_PLANNER_H_
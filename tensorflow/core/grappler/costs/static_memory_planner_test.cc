@@ -0,0 +1,127 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/static_memory_planner.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+const MemoryPlan::PlannedTensor* FindTensor(const MemoryPlan& plan,
+                                            const string& node) {
+  for (const auto& tensor : plan.tensors) {
+    if (tensor.node == node && tensor.output_id == 0) return &tensor;
+  }
+  return nullptr;
+}
+
+TEST(StaticMemoryPlannerTest, ReusesBuffersOfDeadTensors) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output c = ops::Const(s.WithOpName("c"), 1.0f, {16, 16});
+  Output a = ops::Tile(s.WithOpName("a"), c, {4, 1});           // 4096 bytes
+  Output b = ops::Sum(s.WithOpName("b"), a, 0);                 // 64 bytes
+  Output e = ops::Tile(s.WithOpName("e"), b, {256});            // 16384 bytes
+  Output f = ops::Sum(s.WithOpName("f"), e, 0);
+  GrapplerItem item;
+  item.fetch.push_back("f");
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  MemoryPlan plan;
+  TF_ASSERT_OK(PlanStaticMemory(item, &plan));
+
+  const MemoryPlan::PlannedTensor* planned_a = FindTensor(plan, "a");
+  const MemoryPlan::PlannedTensor* planned_b = FindTensor(plan, "b");
+  const MemoryPlan::PlannedTensor* planned_e = FindTensor(plan, "e");
+  ASSERT_NE(planned_a, nullptr);
+  ASSERT_NE(planned_b, nullptr);
+  ASSERT_NE(planned_e, nullptr);
+  // Constants and fetched tensors are never planned.
+  EXPECT_EQ(FindTensor(plan, "c"), nullptr);
+  EXPECT_EQ(FindTensor(plan, "f"), nullptr);
+
+  EXPECT_EQ(planned_a->size, 4096);
+  EXPECT_EQ(planned_b->size, 64);
+  EXPECT_EQ(planned_e->size, 16384);
+  // `a` is dead by the time `e` is produced, so they share the same bytes,
+  // but `b` is live at the same time as both of them.
+  EXPECT_EQ(planned_e->offset, 0);
+  EXPECT_EQ(planned_a->offset, 0);
+  EXPECT_EQ(planned_b->offset, 16384);
+  EXPECT_EQ(plan.slab_size, 16384 + 64);
+  EXPECT_EQ(plan.total_tensor_bytes, 4096 + 64 + 16384);
+}
+
+TEST(StaticMemoryPlannerTest, ConcurrentTensorsDoNotOverlap) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output c = ops::Const(s.WithOpName("c"), 1.0f, {16, 16});
+  Output a = ops::Tile(s.WithOpName("a"), c, {4, 1});
+  Output b = ops::Tile(s.WithOpName("b"), c, {8, 1});
+  Output ra = ops::Sum(s.WithOpName("ra"), a, 0);
+  Output rb = ops::Sum(s.WithOpName("rb"), b, 0);
+  Output out = ops::Add(s.WithOpName("out"), ra, rb);
+  GrapplerItem item;
+  item.fetch.push_back("out");
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  MemoryPlan plan;
+  TF_ASSERT_OK(PlanStaticMemory(item, &plan));
+
+  // The two branches may run in any order, or concurrently.
+  const MemoryPlan::PlannedTensor* planned_a = FindTensor(plan, "a");
+  const MemoryPlan::PlannedTensor* planned_b = FindTensor(plan, "b");
+  ASSERT_NE(planned_a, nullptr);
+  ASSERT_NE(planned_b, nullptr);
+  EXPECT_TRUE(planned_a->offset + planned_a->size <= planned_b->offset ||
+              planned_b->offset + planned_b->size <= planned_a->offset);
+  // `ra` and `rb` may be forwarded to the fetched output of `out`.
+  EXPECT_EQ(FindTensor(plan, "ra"), nullptr);
+  EXPECT_EQ(FindTensor(plan, "rb"), nullptr);
+}
+
+TEST(StaticMemoryPlannerTest, AliasesOfFetchedTensorsAreNotPlanned) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output c = ops::Const(s.WithOpName("c"), 1.0f, {16, 16});
+  Output a = ops::Tile(s.WithOpName("a"), c, {4, 1});
+  Output b = ops::Slice(s.WithOpName("b"), a, {0, 0}, {1, 16});
+  GrapplerItem item;
+  item.fetch.push_back("b");
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  MemoryPlan plan;
+  TF_ASSERT_OK(PlanStaticMemory(item, &plan));
+  EXPECT_TRUE(plan.tensors.empty());
+  EXPECT_EQ(plan.slab_size, 0);
+}
+
+TEST(StaticMemoryPlannerTest, ControlFlowIsUnsupported) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output c = ops::Const(s.WithOpName("c"), 1.0f, {16});
+  Output pred = ops::Const(s.WithOpName("pred"), true);
+  ops::Switch sw(s.WithOpName("switch"), c, pred);
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  MemoryPlan plan;
+  EXPECT_TRUE(errors::IsUnimplemented(PlanStaticMemory(item, &plan)));
+}
+
+}  // namespace
+}  // end namespace grappler
+}  // end namespace tensorflow
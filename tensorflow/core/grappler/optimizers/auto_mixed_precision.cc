@@ -47,6 +47,7 @@ limitations under the License.
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/util.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -2305,6 +2306,17 @@ Status AutoMixedPrecision::Optimize(Cluster* cluster, const GrapplerItem& item,
     return absl::OkStatus();
   }
 
+#if defined(INTEL_MKL)
+  // Without bfloat16 support in oneDNN, the converted ops fall back to the much
+  // slower Eigen kernels.
+  if (mode_ == AutoMixedPrecisionMode::BF16 && !ShouldIgnorePerformance() &&
+      !IsDataTypeSupportedByOneDNNOnThisCPU(DT_BFLOAT16)) {
+    LOG(WARNING) << "This CPU does not support bfloat16 in oneDNN, skipping "
+                 << name() << " graph optimizer";
+    return absl::OkStatus();
+  }
+#endif  // INTEL_MKL
+
   if (num_gpus >= 1 && mode_ == AutoMixedPrecisionMode::BF16) {
     LOG(WARNING) << "Note: GPUs detected. Using " << name()
                  << " graph optimizer configured for BFloat16 on CPUs";
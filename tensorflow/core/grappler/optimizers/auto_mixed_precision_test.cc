@@ -1462,6 +1462,9 @@ TEST_F(AutoMixedPrecisionSimulateGpuTest, Simple_SimulatedGpu_CpuScope) {
 class AutoMixedPrecisionMklTest : public GrapplerTest {
  protected:
   void SetUp() override {
+    if (!IsDataTypeSupportedByOneDNNOnThisCPU(DT_BFLOAT16)) {
+      GTEST_SKIP() << "This CPU does not support bfloat16 in oneDNN.";
+    }
     virtual_cluster_.reset(new SingleMachine(/* timeout_s = */ 10, 1, 0));
     TF_CHECK_OK(virtual_cluster_->Provision());
   }
@@ -1719,6 +1722,32 @@ TEST_F(AutoMixedPrecisionMklTest, InferFollowUpStreamDeny) {
     test::ExpectClose(tensors_expected[i], tensors[i]);
   }
 }
+
+TEST(AutoMixedPrecisionMklUnsupportedCpuTest, SkipsWithoutBf16Support) {
+  if (IsDataTypeSupportedByOneDNNOnThisCPU(DT_BFLOAT16)) {
+    GTEST_SKIP() << "This CPU supports bfloat16 in oneDNN.";
+  }
+  SingleMachine cluster(/* timeout_s = */ 10, 1, 0);
+  TF_ASSERT_OK(cluster.Provision());
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice(
+      "/job:localhost/replica:0/task:0/device:CPU:0");
+  Output input = ops::Const(s.WithOpName("input"), 1.f / 32, {32, 32});
+  Output allow1 = ops::MatMul(s.WithOpName("allow1"), input, input);
+  Output fetch = ops::Identity(s.WithOpName("fetch"), allow1);
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  AutoMixedPrecision optimizer{AutoMixedPrecisionMode::BF16};
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(&cluster, item, &output));
+
+  GraphView output_view(&output);
+  EXPECT_EQ(output.node_size(), item.graph.node_size());
+  EXPECT_EQ(output_view.GetNode("allow1")->attr().at("T").type(), DT_FLOAT);
+  TF_ASSERT_OK(cluster.Shutdown());
+}
 #endif  // INTEL_MKL
 
 }  // namespace
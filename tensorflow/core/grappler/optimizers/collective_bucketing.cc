@@ -0,0 +1,198 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/collective_bucketing.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+// Reductions with the same key can be bucketed together.
+class BucketKeyBuilder {
+ public:
+  explicit BucketKeyBuilder(const NodeMap& node_map) : node_map_(node_map) {}
+
+  string Key(const NodeDef& node) const {
+    string key = strings::StrCat(node.device(), "|", InputKey(node.input(1)),
+                                 "|", InputKey(node.input(2)));
+    for (const char* attr_name :
+         {"T", "merge_op", "final_op", "communication_hint", "timeout_seconds",
+          "is_stateless", "max_subdivs_per_device"}) {
+      auto it = node.attr().find(attr_name);
+      strings::StrAppend(
+          &key, "|",
+          it == node.attr().end() ? "" : SummarizeAttrValue(it->second));
+    }
+    return key;
+  }
+
+ private:
+  // Identifies a scalar int32 input by its value if it is a constant, since
+  // each collective typically gets its own group constants.
+  string InputKey(const string& input) const {
+    const NodeDef* producer = node_map_.GetNode(input);
+    if (producer != nullptr && IsConstant(*producer) &&
+        producer->attr().count("value")) {
+      Tensor value;
+      if (value.FromProto(producer->attr().at("value").tensor()) &&
+          value.dtype() == DT_INT32 && value.NumElements() == 1) {
+        return strings::StrCat("=", value.flat<int32>()(0));
+      }
+    }
+    return input;
+  }
+
+  const NodeMap& node_map_;
+};
+
+bool HasOrderingToken(const NodeDef& node) {
+  auto it = node.attr().find("Nordering_token");
+  return it != node.attr().end() && it->second.i() > 0;
+}
+
+// A bucket being filled.
+struct OpenBucket {
+  std::vector<NodeDef*> members;
+  int64_t bytes = 0;
+  // The nodes that depend on a member, which cannot join the bucket.
+  absl::flat_hash_set<const NodeDef*> descendants;
+};
+
+void AddDescendants(const NodeMap& node_map, const NodeDef* node,
+                    absl::flat_hash_set<const NodeDef*>* descendants) {
+  std::vector<const NodeDef*> stack = {node};
+  while (!stack.empty()) {
+    const NodeDef* current = stack.back();
+    stack.pop_back();
+    for (const NodeDef* fanout : node_map.GetOutputs(current->name())) {
+      if (descendants->insert(fanout).second) stack.push_back(fanout);
+    }
+  }
+}
+
+void CloseBucket(OpenBucket* bucket, int* num_buckets) {
+  if (bucket->members.size() > 1) {
+    const string name =
+        strings::StrCat(bucket->members.front()->name(), "/bucket");
+    VLOG(2) << "Bucketing " << bucket->members.size() << " reductions of "
+            << bucket->bytes << " bytes into " << name;
+    for (NodeDef* member : bucket->members) {
+      auto* attr = member->mutable_attr();
+      (*attr)[kCollectiveBucketAttr].set_s(name);
+      (*attr)[kCollectiveBucketSizeAttr].set_i(bucket->members.size());
+    }
+    ++*num_buckets;
+  }
+  *bucket = OpenBucket();
+}
+
+}  // namespace
+
+Status CollectiveBucketing::Init(
+    const tensorflow::RewriterConfig_CustomGraphOptimizer* config) {
+  if (config == nullptr) return absl::OkStatus();
+  const auto& params = config->parameter_map();
+  auto it = params.find("bucket_bytes");
+  if (it != params.end()) {
+    if (it->second.i() <= 0) {
+      return errors::InvalidArgument(
+          "bucket_bytes must be positive, got ", it->second.i());
+    }
+    bucket_bytes_ = it->second.i();
+  }
+  return absl::OkStatus();
+}
+
+Status CollectiveBucketing::Optimize(Cluster* cluster,
+                                     const GrapplerItem& item,
+                                     GraphDef* optimized_graph) {
+  *optimized_graph = item.graph;
+  for (const NodeDef& node : optimized_graph->node()) {
+    // Reductions in untaken branches would never fill their bucket.
+    if (IsSwitch(node)) return absl::OkStatus();
+  }
+
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(properties.InferStatically(
+      /*assume_valid_feeds=*/false, /*aggressive_shape_inference=*/false,
+      /*include_tensor_values=*/false));
+  NodeMap node_map(optimized_graph);
+  std::vector<const NodeDef*> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(*optimized_graph, &topo_order));
+
+  const BucketKeyBuilder key_builder(node_map);
+  std::map<string, OpenBucket> buckets;
+  int num_buckets = 0;
+  for (const NodeDef* node : topo_order) {
+    if (node->op() != "CollectiveReduceV2" ||
+        node->attr().count(kCollectiveBucketAttr) ||
+        HasOrderingToken(*node) ||
+        !properties.HasInputProperties(node->name())) {
+      continue;
+    }
+    const auto& input_props = properties.GetInputProperties(node->name());
+    if (input_props.empty()) continue;
+    const PartialTensorShape shape(input_props[0].shape());
+    if (!shape.IsFullyDefined()) continue;
+    const int64_t bytes =
+        shape.num_elements() * DataTypeSize(node->attr().at("T").type());
+    if (bytes >= bucket_bytes_) continue;
+
+    // A bucket runs once all of its members are ready, so no member may
+    // depend on a bucket that is still open. Closing every such bucket also
+    // orders the dependencies between buckets, which rules out cycles.
+    for (auto& open : buckets) {
+      if (open.second.descendants.contains(node)) {
+        CloseBucket(&open.second, &num_buckets);
+      }
+    }
+    OpenBucket& bucket = buckets[key_builder.Key(*node)];
+    if (bucket.bytes + bytes > bucket_bytes_) {
+      CloseBucket(&bucket, &num_buckets);
+    }
+    bucket.members.push_back(node_map.GetNode(node->name()));
+    bucket.bytes += bytes;
+    AddDescendants(node_map, node, &bucket.descendants);
+  }
+  for (auto& bucket : buckets) CloseBucket(&bucket.second, &num_buckets);
+  VLOG(1) << "Created " << num_buckets << " collective buckets";
+  return absl::OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(CollectiveBucketing, "collective_bucketing");
+
+}  // end namespace grappler
+}  // end namespace tensorflow
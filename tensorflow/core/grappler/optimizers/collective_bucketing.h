@@ -0,0 +1,66 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_BUCKETING_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_BUCKETING_H_
+
+#include <cstdint>
+#include <string>
+
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Assigns small CollectiveReduceV2 nodes to buckets, each of which the
+// collective executor packs into a single all-reduce at runtime (see
+// CollectiveExecutor::ExecuteBucketedAsync()). This amortizes the
+// per-collective latency over the many small gradients of a model.
+//
+// Reductions are bucketed together if they have the same device, group,
+// dtype, reduction ops, communication hint and timeout, and none of them
+// depends on another. Buckets are filled in topological order up to
+// "bucket_bytes" (25 MiB by default). Reductions with ordering tokens or
+// without a static shape, and graphs with v1 control flow, are left alone.
+//
+// All members of a collective group must run graphs bucketed by the same
+// optimizer configuration.
+//
+// The optimizer is registered as the custom optimizer "collective_bucketing",
+// and is enabled by adding it to `RewriterConfig.custom_optimizers`.
+class CollectiveBucketing : public CustomGraphOptimizer {
+ public:
+  CollectiveBucketing() = default;
+  ~CollectiveBucketing() override = default;
+
+  std::string name() const override { return "collective_bucketing"; }
+
+  bool UsesFunctionLibrary() const override { return false; }
+
+  Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override;
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* optimized_graph) override;
+
+ private:
+  int64_t bucket_bytes_ = 25 << 20;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_BUCKETING_H_
@@ -0,0 +1,177 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/collective_bucketing.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+NodeDef Placeholder(const string& name, const TensorShape& shape) {
+  return NDef(name, "Placeholder", {}, {{"dtype", DT_FLOAT}, {"shape", shape}});
+}
+
+NodeDef Int32Const(const string& name, int32 value) {
+  return NDef(name, "Const", {},
+              {{"dtype", DT_INT32}, {"value", test::AsScalar<int32>(value)}});
+}
+
+// A reduction in group 1, with its own group and instance constants.
+std::vector<NodeDef> Reduce(const string& name, const string& input,
+                            int32 instance_key, int32 group_key = 1) {
+  return {Int32Const(name + "/group_size", 2),
+          Int32Const(name + "/group_key", group_key),
+          Int32Const(name + "/instance_key", instance_key),
+          NDef(name, "CollectiveReduceV2",
+               {input, name + "/group_size", name + "/group_key",
+                name + "/instance_key"},
+               {{"T", DT_FLOAT},
+                {"merge_op", "Add"},
+                {"final_op", "Id"},
+                {"communication_hint", "auto"},
+                {"timeout_seconds", 0.0f},
+                {"is_stateless", false},
+                {"Nordering_token", 0},
+                {"max_subdivs_per_device", -1}})};
+}
+
+class CollectiveBucketingTest : public ::testing::Test {
+ protected:
+  void AddNodes(const std::vector<NodeDef>& nodes) {
+    for (const NodeDef& node : nodes) *item_.graph.add_node() = node;
+  }
+
+  GraphDef Optimize(int64_t bucket_bytes = 0) {
+    CollectiveBucketing optimizer;
+    RewriterConfig_CustomGraphOptimizer config;
+    if (bucket_bytes > 0) {
+      (*config.mutable_parameter_map())["bucket_bytes"].set_i(bucket_bytes);
+    }
+    TF_CHECK_OK(optimizer.Init(&config));
+    GraphDef output;
+    TF_CHECK_OK(optimizer.Optimize(nullptr, item_, &output));
+    return output;
+  }
+
+  // Returns the bucket of each reduction, or "" if it is not bucketed.
+  static std::map<string, string> Buckets(const GraphDef& graph) {
+    std::map<string, string> buckets;
+    for (const NodeDef& node : graph.node()) {
+      if (node.op() != "CollectiveReduceV2") continue;
+      auto it = node.attr().find(kCollectiveBucketAttr);
+      buckets[node.name()] = it == node.attr().end() ? "" : it->second.s();
+    }
+    return buckets;
+  }
+
+  static int BucketSize(const GraphDef& graph, const string& name) {
+    for (const NodeDef& node : graph.node()) {
+      if (node.name() == name) {
+        return node.attr().at(kCollectiveBucketSizeAttr).i();
+      }
+    }
+    return 0;
+  }
+
+  GrapplerItem item_;
+};
+
+TEST_F(CollectiveBucketingTest, BucketsIndependentReductions) {
+  AddNodes({Placeholder("a", TensorShape({4})),
+            Placeholder("b", TensorShape({8, 2})),
+            Placeholder("c", TensorShape({}))});
+  AddNodes(Reduce("ra", "a", 1));
+  AddNodes(Reduce("rb", "b", 2));
+  AddNodes(Reduce("rc", "c", 3));
+
+  const GraphDef output = Optimize();
+  const auto buckets = Buckets(output);
+  ASSERT_EQ(buckets.size(), 3);
+  EXPECT_NE(buckets.at("ra"), "");
+  EXPECT_EQ(buckets.at("rb"), buckets.at("ra"));
+  EXPECT_EQ(buckets.at("rc"), buckets.at("ra"));
+  EXPECT_EQ(BucketSize(output, "ra"), 3);
+}
+
+TEST_F(CollectiveBucketingTest, DependentReductionsAreNotBucketed) {
+  AddNodes({Placeholder("a", TensorShape({4}))});
+  AddNodes(Reduce("r1", "a", 1));
+  AddNodes({NDef("neg", "Neg", {"r1"}, {{"T", DT_FLOAT}})});
+  AddNodes(Reduce("r2", "neg", 2));
+
+  const auto buckets = Buckets(Optimize());
+  EXPECT_EQ(buckets.at("r1"), "");
+  EXPECT_EQ(buckets.at("r2"), "");
+}
+
+TEST_F(CollectiveBucketingTest, DifferentGroupsAreNotBucketed) {
+  AddNodes({Placeholder("a", TensorShape({4})),
+            Placeholder("b", TensorShape({4}))});
+  AddNodes(Reduce("ra", "a", 1, /*group_key=*/1));
+  AddNodes(Reduce("rb", "b", 2, /*group_key=*/2));
+
+  const auto buckets = Buckets(Optimize());
+  EXPECT_EQ(buckets.at("ra"), "");
+  EXPECT_EQ(buckets.at("rb"), "");
+}
+
+TEST_F(CollectiveBucketingTest, BucketBytes) {
+  // 16 bytes each, and 64 bytes which is never bucketed.
+  AddNodes({Placeholder("a", TensorShape({4})),
+            Placeholder("b", TensorShape({4})),
+            Placeholder("c", TensorShape({4})),
+            Placeholder("d", TensorShape({16}))});
+  AddNodes(Reduce("ra", "a", 1));
+  AddNodes(Reduce("rb", "b", 2));
+  AddNodes(Reduce("rc", "c", 3));
+  AddNodes(Reduce("rd", "d", 4));
+
+  const GraphDef output = Optimize(/*bucket_bytes=*/40);
+  const auto buckets = Buckets(output);
+  EXPECT_EQ(buckets.at("rd"), "");
+  int num_bucketed = 0;
+  for (const string& name : {"ra", "rb", "rc"}) {
+    if (!buckets.at(name).empty()) {
+      ++num_bucketed;
+      EXPECT_EQ(BucketSize(output, name), 2);
+    }
+  }
+  EXPECT_EQ(num_bucketed, 2);
+}
+
+TEST_F(CollectiveBucketingTest, InvalidBucketBytes) {
+  CollectiveBucketing optimizer;
+  RewriterConfig_CustomGraphOptimizer config;
+  (*config.mutable_parameter_map())["bucket_bytes"].set_i(0);
+  EXPECT_FALSE(optimizer.Init(&config).ok());
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
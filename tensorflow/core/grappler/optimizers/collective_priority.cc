@@ -0,0 +1,75 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/collective_priority.h"
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+bool IsCollectiveV2(const NodeDef& node) {
+  return node.op() == "CollectiveReduceV2" ||
+         node.op() == "CollectiveGatherV2" ||
+         node.op() == "CollectiveBcastSendV2" ||
+         node.op() == "CollectiveBcastRecvV2" ||
+         node.op() == "CollectiveAllToAllV2" ||
+         node.op() == "CollectiveReduceScatterV2";
+}
+
+}  // namespace
+
+Status CollectivePriority::Optimize(Cluster* cluster, const GrapplerItem& item,
+                                    GraphDef* optimized_graph) {
+  *optimized_graph = item.graph;
+  std::vector<const NodeDef*> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(*optimized_graph, &topo_order));
+  absl::flat_hash_map<string, int> position;
+  for (int i = 0; i < topo_order.size(); ++i) {
+    position[topo_order[i]->name()] = i;
+  }
+
+  int num_prioritized = 0;
+  for (NodeDef& node : *optimized_graph->mutable_node()) {
+    if (!IsCollectiveV2(node) || node.attr().count(kCollectivePriorityAttr)) {
+      continue;
+    }
+    // BcastRecv has no data input, so it goes by its own position.
+    int priority = position[node.name()];
+    if (node.op() != "CollectiveBcastRecvV2" && node.input_size() > 0) {
+      priority = position[NodeName(node.input(0))];
+    }
+    (*node.mutable_attr())[kCollectivePriorityAttr].set_i(priority);
+    ++num_prioritized;
+  }
+  VLOG(1) << "Set the priority of " << num_prioritized << " collectives";
+  return absl::OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(CollectivePriority, "collective_priority");
+
+}  // end namespace grappler
+}  // end namespace tensorflow
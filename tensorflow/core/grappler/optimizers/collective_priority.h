@@ -0,0 +1,61 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_PRIORITY_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_PRIORITY_H_
+
+#include <string>
+
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Sets the launch priority of each V2 collective (see
+// CollectiveParams::priority) to the topological position of the node that
+// produces its input. In a backward pass the gradients of the first layers
+// are produced last, and the next step needs them first, so their
+// collectives overtake those of the later layers that are still waiting for
+// a launch slot.
+//
+// Priorities only take effect when the collective executor bounds the
+// collectives in flight with TF_COLLECTIVE_MAX_IN_FLIGHT. Collectives that
+// already have a priority are left alone.
+//
+// The optimizer is registered as the custom optimizer "collective_priority",
+// and is enabled by adding it to `RewriterConfig.custom_optimizers`.
+class CollectivePriority : public CustomGraphOptimizer {
+ public:
+  CollectivePriority() = default;
+  ~CollectivePriority() override = default;
+
+  std::string name() const override { return "collective_priority"; }
+
+  bool UsesFunctionLibrary() const override { return false; }
+
+  Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override {
+    return absl::OkStatus();
+  }
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* optimized_graph) override;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_PRIORITY_H_
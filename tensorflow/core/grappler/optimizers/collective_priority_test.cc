@@ -0,0 +1,113 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/collective_priority.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+std::vector<NodeDef> Reduce(const string& name, const string& input,
+                            int32 instance_key) {
+  auto int32_const = [](const string& name, int32 value) {
+    return NDef(name, "Const", {},
+                {{"dtype", DT_INT32}, {"value", test::AsScalar<int32>(value)}});
+  };
+  return {int32_const(name + "/group_size", 2),
+          int32_const(name + "/group_key", 1),
+          int32_const(name + "/instance_key", instance_key),
+          NDef(name, "CollectiveReduceV2",
+               {input, name + "/group_size", name + "/group_key",
+                name + "/instance_key"},
+               {{"T", DT_FLOAT},
+                {"merge_op", "Add"},
+                {"final_op", "Id"},
+                {"communication_hint", "auto"},
+                {"timeout_seconds", 0.0f},
+                {"Nordering_token", 0}})};
+}
+
+// Returns the priority of each collective, or -1 if it has none.
+std::map<string, int> Priorities(const GraphDef& graph) {
+  std::map<string, int> priorities;
+  for (const NodeDef& node : graph.node()) {
+    if (node.op() != "CollectiveReduceV2") continue;
+    auto it = node.attr().find(kCollectivePriorityAttr);
+    priorities[node.name()] = it == node.attr().end() ? -1 : it->second.i();
+  }
+  return priorities;
+}
+
+TEST(CollectivePriorityTest, LaterProducersGetHigherPriorities) {
+  // A chain x -> g2 -> g1 -> g0, like the backward pass of three layers.
+  GrapplerItem item;
+  std::vector<NodeDef> nodes = {
+      NDef("x", "Placeholder", {},
+           {{"dtype", DT_FLOAT}, {"shape", TensorShape({4})}}),
+      NDef("g2", "Neg", {"x"}, {{"T", DT_FLOAT}}),
+      NDef("g1", "Neg", {"g2"}, {{"T", DT_FLOAT}}),
+      NDef("g0", "Neg", {"g1"}, {{"T", DT_FLOAT}})};
+  for (const char* layer : {"0", "1", "2"}) {
+    for (NodeDef& node : Reduce(strings::StrCat("r", layer),
+                                strings::StrCat("g", layer), 1)) {
+      nodes.push_back(node);
+    }
+  }
+  for (const NodeDef& node : nodes) *item.graph.add_node() = node;
+
+  CollectivePriority optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  const auto priorities = Priorities(output);
+  EXPECT_GT(priorities.at("r0"), priorities.at("r1"));
+  EXPECT_GT(priorities.at("r1"), priorities.at("r2"));
+}
+
+TEST(CollectivePriorityTest, KeepsExistingPriority) {
+  GrapplerItem item;
+  *item.graph.add_node() =
+      NDef("x", "Placeholder", {},
+           {{"dtype", DT_FLOAT}, {"shape", TensorShape({4})}});
+  for (NodeDef& node : Reduce("r", "x", 1)) {
+    if (node.name() == "r") {
+      (*node.mutable_attr())[kCollectivePriorityAttr].set_i(42);
+    }
+    *item.graph.add_node() = node;
+  }
+
+  CollectivePriority optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_EQ(Priorities(output).at("r"), 42);
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -19,11 +19,14 @@ limitations under the License.
 #include "tensorflow/cc/ops/array_ops.h"
 #include "tensorflow/cc/ops/math_ops.h"
 #include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/function_testlib.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/inputs/trivial_test_graph_input_yielder.h"
 #include "tensorflow/core/grappler/optimizers/arithmetic_optimizer_test_utils.h"
+#include "tensorflow/core/grappler/optimizers/function_optimizer.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -174,5 +177,75 @@ TEST_F(CommonSubgraphEliminationTest, OpDedupCommutative) {
   test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
 }
 
+TEST_F(CommonSubgraphEliminationTest, DedupInlinedFunctionTrunks) {
+  using test::function::NDef;
+  using FDH = FunctionDefHelper;
+  constexpr char kDevice[] = "/job:localhost/replica:0/task:0/device:CPU:0";
+
+  // Two signatures of a SavedModel that share their trunk and only differ in
+  // their heads. RunMultipleSignatures fetches both from one joined graph, in
+  // which the signature calls are inlined before CSE runs.
+  auto make_signature = [](const string& name, const string& head_op) {
+    return FDH::Create(
+        name, {"x: float"}, {"y: float"}, {},
+        {{{"w"},
+          "Const",
+          {},
+          {{"value", test::AsTensor<float>({1.0f, 2.0f, 3.0f, 4.0f},
+                                           TensorShape({2, 2}))},
+           {"dtype", DT_FLOAT}}},
+         {{"matmul"}, "MatMul", {"x", "w:output:0"}, {{"T", DT_FLOAT}}},
+         {{"relu"}, "Relu", {"matmul:product:0"}, {{"T", DT_FLOAT}}},
+         {{"head"}, head_op, {"relu:activations:0"}, {{"T", DT_FLOAT}}}},
+        {{"y", "head:y:0"}});
+  };
+  auto call = [&](const string& name, const string& signature) {
+    return NDef(name, "PartitionedCall", {"x"},
+                {{"Tin", DataTypeSlice{DT_FLOAT}},
+                 {"Tout", DataTypeSlice{DT_FLOAT}},
+                 {"f", FDH::FunctionRef(signature)}},
+                kDevice);
+  };
+
+  GrapplerItem item;
+  TF_ASSERT_OK(item.AddDevice(kDevice));
+  item.fetch = {"out0", "out1"};
+  item.graph = test::function::GDef(
+      {NDef("x", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice),
+       call("predict", "Predict"), call("classify", "Classify"),
+       NDef("out0", "Identity", {"predict"}, {{"T", DT_FLOAT}}, kDevice),
+       NDef("out1", "Identity", {"classify"}, {{"T", DT_FLOAT}}, kDevice)},
+      {make_signature("Predict", "Sigmoid"),
+       make_signature("Classify", "Tanh")});
+  Tensor x_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2, 2}));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(tensors_expected.size(), 2);
+
+  FunctionOptimizer inliner(RewriterConfig::AGGRESSIVE, true);
+  GraphDef inlined;
+  TF_ASSERT_OK(inliner.Optimize(nullptr, item, &inlined));
+  item.graph = std::move(inlined);
+
+  CommonSubgraphElimination optimizer;
+  GraphDef output;
+  OptimizeTwice(&optimizer, &item, &output);
+
+  int num_calls = 0, num_matmuls = 0, num_relus = 0;
+  for (const NodeDef& node : output.node()) {
+    num_calls += node.op() == "PartitionedCall";
+    num_matmuls += node.op() == "MatMul";
+    num_relus += node.op() == "Relu";
+  }
+  EXPECT_EQ(num_calls, 0);
+  EXPECT_EQ(num_matmuls, 1);
+  EXPECT_EQ(num_relus, 1);
+
+  auto tensors = EvaluateNodes(output, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(tensors.size(), 2);
+  for (int i = 0; i < 2; ++i) {
+    test::ExpectTensorNear<float>(tensors[i], tensors_expected[i], 1e-6);
+  }
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
@@ -0,0 +1,216 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/inject_cache.h"
+
+#include <array>
+#include <cstdint>
+
+#include "absl/algorithm/container.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/function_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/platform/mem.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kCacheDataset[] = "CacheDataset";
+constexpr char kRepeatDataset[] = "RepeatDataset";
+
+// The share of the available memory that an injected cache may use.
+constexpr double kMaxCacheRamShare = 0.1;
+
+// Transformations between a subpipeline and its `repeat()` that do not change
+// the elements of the subpipeline.
+constexpr std::array<const char*, 2> kPassThroughDatasets = {
+    "PrefetchDataset", "ShuffleDataset"};
+
+// Deterministic transformations of their first input.
+constexpr std::array<const char*, 12> kDeterministicDatasets = {
+    "BatchDataset",         "FilterDataset",
+    "InterleaveDataset",    "MapAndBatchDataset",
+    "MapDataset",           "PaddedBatchDataset",
+    "ParallelBatchDataset", "ParallelInterleaveDataset",
+    "ParallelMapDataset",   "PrefetchDataset",
+    "SkipDataset",          "TakeDataset"};
+
+// Deterministic sources.
+constexpr std::array<const char*, 6> kSourceDatasets = {
+    "FixedLengthRecordDataset", "RangeDataset",    "TensorDataset",
+    "TensorSliceDataset",       "TextLineDataset", "TFRecordDataset"};
+
+template <size_t N>
+bool IsDatasetOfType(const NodeDef& node,
+                     const std::array<const char*, N>& types) {
+  return absl::c_any_of(types, [&](const char* type) {
+    return data::MatchesAnyVersion(type, node.op());
+  });
+}
+
+bool IsDeterministic(const NodeDef& node) {
+  if (node.attr().contains("deterministic") &&
+      node.attr().at("deterministic").s() == "false") {
+    return false;
+  }
+  return !(node.attr().contains("sloppy") && node.attr().at("sloppy").b());
+}
+
+// Returns the number of user-defined functions that `node` applies, or -1 if
+// one of them is stateful or missing.
+int NumStatelessFunctions(const NodeDef& node,
+                          const FunctionLibraryDefinition& library) {
+  int num_functions = 0;
+  for (const auto& attr : node.attr()) {
+    if (!attr.second.has_func()) continue;
+    const FunctionDef* function = library.Find(attr.second.func().name());
+    if (function == nullptr ||
+        function_utils::IsFunctionStateful(library, *function)) {
+      return -1;
+    }
+    ++num_functions;
+  }
+  return num_functions;
+}
+
+// Returns the number of bytes of the elements of `node`, or -1 if it is not
+// known statically.
+int64_t TotalBytes(const NodeDef& node) {
+  int64_t cardinality;
+  if (!TryGetNodeAttr(node, data::kCardinalityAttrForRewrite, &cardinality) ||
+      cardinality < 0 || !node.attr().contains("output_shapes")) {
+    return -1;
+  }
+  DataTypeVector types;
+  if (!graph_utils::GetDatasetOutputTypesAttr(node, &types).ok()) return -1;
+  const auto& shapes = node.attr().at("output_shapes").list().shape();
+  if (shapes.size() != types.size()) return -1;
+  int64_t element_bytes = 0;
+  for (int i = 0; i < types.size(); ++i) {
+    const PartialTensorShape shape(shapes[i]);
+    if (!shape.IsFullyDefined() || DataTypeSize(types[i]) == 0) return -1;
+    element_bytes += shape.num_elements() * DataTypeSize(types[i]);
+  }
+  return cardinality * element_bytes;
+}
+
+// Returns whether the subpipeline that ends at `node` is worth caching: it
+// starts at a deterministic source, only applies deterministic transformations
+// with stateless functions, at least one of which is user-defined.
+bool IsCacheable(const NodeDef& node, const MutableGraphView& graph,
+                 const FunctionLibraryDefinition& library) {
+  int num_functions = 0;
+  const NodeDef* current = &node;
+  while (current != nullptr) {
+    if (IsDatasetOfType(*current, kSourceDatasets)) {
+      return num_functions > 0;
+    }
+    if (!IsDatasetOfType(*current, kDeterministicDatasets) ||
+        !IsDeterministic(*current)) {
+      return false;
+    }
+    const int node_functions = NumStatelessFunctions(*current, library);
+    if (node_functions < 0) return false;
+    num_functions += node_functions;
+    current = graph_utils::GetInputNode(*current, graph);
+  }
+  return false;
+}
+
+// Returns whether `repeat_node` repeats its input more than once.
+bool RepeatsMoreThanOnce(const NodeDef& repeat_node,
+                         const MutableGraphView& graph) {
+  const NodeDef* count_node =
+      graph_utils::GetInputNode(repeat_node, graph, /*i=*/1);
+  int64_t count;
+  return count_node != nullptr &&
+         graph_utils::GetScalarConstNodeValue(*count_node, &count).ok() &&
+         (count < 0 || count > 1);
+}
+
+}  // namespace
+
+Status InjectCache::OptimizeAndCollectStats(Cluster* cluster,
+                                            const GrapplerItem& item,
+                                            GraphDef* output,
+                                            OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item.graph.library());
+  const double max_cache_bytes = kMaxCacheRamShare * port::AvailableRam();
+
+  for (const NodeDef& node : item.graph.node()) {
+    if (node.op() != kRepeatDataset || !RepeatsMoreThanOnce(node, graph)) {
+      continue;
+    }
+    const NodeDef* output_node = &node;
+    NodeDef* input_node = graph_utils::GetInputNode(node, graph);
+    while (input_node != nullptr &&
+           IsDatasetOfType(*input_node, kPassThroughDatasets)) {
+      output_node = input_node;
+      input_node = graph_utils::GetInputNode(*input_node, graph);
+    }
+    if (input_node == nullptr ||
+        !IsCacheable(*input_node, graph, function_library)) {
+      continue;
+    }
+    const int64_t total_bytes = TotalBytes(*input_node);
+    if (total_bytes < 0 || total_bytes > max_cache_bytes) {
+      VLOG(2) << "Not caching " << input_node->name() << " of "
+              << total_bytes << " bytes.";
+      continue;
+    }
+
+    // Adding nodes to `graph` invalidates the pointers into it.
+    const string output_name = output_node->name();
+    NodeDef cache_node;
+    graph_utils::SetUniqueGraphNodeName(
+        absl::StrCat("inject/cache_", input_node->name()), graph.graph(),
+        &cache_node);
+    cache_node.set_op(kCacheDataset);
+    cache_node.add_input(input_node->name());
+    if (!graph_utils::CopyShapesAndTypesAttrs(*input_node, &cache_node)) {
+      continue;
+    }
+    TF_RETURN_IF_ERROR(
+        graph_utils::SetMetadataName(cache_node.name(), &cache_node));
+    NodeDef* filename = graph_utils::AddScalarConstNode(StringPiece(""), &graph);
+    cache_node.add_input(filename->name());
+    NodeDef* added_cache = graph.AddNode(std::move(cache_node));
+    TF_RETURN_IF_ERROR(graph.UpdateRegularFaninByPort(
+        output_name, /*port=*/0, {added_cache->name(), 0}));
+    stats->num_changes++;
+  }
+  return absl::OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(InjectCache, "inject_cache");
+
+}  // namespace grappler
+}  // namespace tensorflow
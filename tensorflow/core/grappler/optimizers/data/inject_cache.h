@@ -0,0 +1,53 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_INJECT_CACHE_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_INJECT_CACHE_H_
+
+#include "tensorflow/core/grappler/optimizers/data/optimizer_base.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// This optimization inserts an in-memory `cache()` below the `repeat()` of a
+// pipeline, so that the work of the first epoch is not repeated in later ones.
+//
+// The cache is inserted above the longest deterministic subpipeline that
+// starts at a source, applies at least one user-defined function, and whose
+// output, computed from the cardinality recorded for the rewrite and the static
+// element shapes, fits in a fraction of the available memory. Shuffles and
+// prefetches between the subpipeline and the `repeat()` stay above the cache.
+class InjectCache : public TFDataOptimizerBase {
+ public:
+  InjectCache() = default;
+  ~InjectCache() override = default;
+
+  string name() const override { return "inject_cache"; };
+
+  bool UsesFunctionLibrary() const override { return false; }
+
+  Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override {
+    return absl::OkStatus();
+  }
+
+  Status OptimizeAndCollectStats(Cluster* cluster, const GrapplerItem& item,
+                                 GraphDef* output,
+                                 OptimizationStats* stats) override;
+};
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_INJECT_CACHE_H_
@@ -0,0 +1,128 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/inject_cache.h"
+
+#include <cstdint>
+#include <string>
+
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+// A pipeline of `range(10).map(function)`, optionally shuffled, and repeated.
+GrapplerItem MakeMapAndRepeatItem(const FunctionDef& function,
+                                  int64_t map_cardinality, bool shuffle) {
+  const auto shapes = absl::Span<const TensorShape>{{}};
+  const auto types = absl::Span<const DataType>{DT_INT64};
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT64}}),
+       NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT64}}),
+       NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT64}}),
+       NDef("range", "RangeDataset", {"start", "stop", "step"},
+            {{"output_shapes", shapes},
+             {"output_types", types},
+             {data::kCardinalityAttrForRewrite, int64_t{10}}}),
+       NDef("map", "MapDataset", {"range"},
+            {{"f", FunctionDefHelper::FunctionRef(
+                       function.signature().name(), {{"T", DT_INT64}})},
+             {"Targuments", absl::Span<const DataType>{}},
+             {"output_shapes", shapes},
+             {"output_types", types},
+             {data::kCardinalityAttrForRewrite, map_cardinality}}),
+       NDef("buffer_size", "Const", {}, {{"value", 10}, {"dtype", DT_INT64}}),
+       NDef("seed", "Const", {}, {{"value", 0}, {"dtype", DT_INT64}}),
+       NDef("shuffle", "ShuffleDataset", {"map", "buffer_size", "seed", "seed"},
+            {{"output_shapes", shapes}, {"output_types", types}}),
+       NDef("count", "Const", {}, {{"value", -1}, {"dtype", DT_INT64}}),
+       NDef("repeat", "RepeatDataset", {shuffle ? "shuffle" : "map", "count"},
+            {{"output_shapes", shapes}, {"output_types", types}}),
+       NDef("Sink", "Identity", {"repeat"}, {})},
+      {function});
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+TEST(InjectCacheTest, CachesMapBelowRepeat) {
+  const GrapplerItem item = MakeMapAndRepeatItem(
+      test::function::XTimesTwo(), /*map_cardinality=*/10, /*shuffle=*/false);
+
+  InjectCache optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  const NodeDef& repeat =
+      output.node(graph_utils::FindGraphNodeWithName("repeat", output));
+  const NodeDef& cache =
+      output.node(graph_utils::FindGraphNodeWithName(repeat.input(0), output));
+  EXPECT_EQ(cache.op(), "CacheDataset");
+  EXPECT_EQ(cache.input(0), "map");
+  const NodeDef& filename =
+      output.node(graph_utils::FindGraphNodeWithName(cache.input(1), output));
+  EXPECT_EQ(filename.attr().at("value").tensor().string_val(0), "");
+}
+
+TEST(InjectCacheTest, CachesBelowShuffle) {
+  const GrapplerItem item = MakeMapAndRepeatItem(
+      test::function::XTimesTwo(), /*map_cardinality=*/10, /*shuffle=*/true);
+
+  InjectCache optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  const NodeDef& shuffle =
+      output.node(graph_utils::FindGraphNodeWithName("shuffle", output));
+  const NodeDef& cache =
+      output.node(graph_utils::FindGraphNodeWithName(shuffle.input(0), output));
+  EXPECT_EQ(cache.op(), "CacheDataset");
+  EXPECT_EQ(cache.input(0), "map");
+}
+
+TEST(InjectCacheTest, DoesNotCacheStatefulFunctions) {
+  const GrapplerItem item =
+      MakeMapAndRepeatItem(test::function::RandomUniform(),
+                           /*map_cardinality=*/10, /*shuffle=*/false);
+
+  InjectCache optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("CacheDataset", output));
+}
+
+TEST(InjectCacheTest, DoesNotCacheUnknownCardinality) {
+  const GrapplerItem item = MakeMapAndRepeatItem(
+      test::function::XTimesTwo(), data::kUnknownCardinality,
+      /*shuffle=*/false);
+
+  InjectCache optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_FALSE(graph_utils::ContainsNodeWithOp("CacheDataset", output));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
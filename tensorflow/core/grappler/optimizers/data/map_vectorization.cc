@@ -0,0 +1,289 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include <optional>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/function.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kMapDataset[] = "MapDataset";
+constexpr char kParallelMapDatasetV2[] = "ParallelMapDatasetV2";
+constexpr char kOutputShapesAttr[] = "_output_shapes";
+
+// Element-wise ops that do not fail on any input.
+const absl::flat_hash_set<string>& UnaryOps() {
+  static const auto* ops = new absl::flat_hash_set<string>{
+      "Abs", "Cast", "Ceil", "Exp", "Floor", "Identity", "IsFinite", "IsInf",
+      "IsNan", "Log", "Log1p", "LogicalNot", "Neg", "Relu", "Round", "Rsqrt",
+      "Sigmoid", "Sign", "Sqrt", "Square", "StringToHashBucketFast", "Tanh"};
+  return *ops;
+}
+
+const absl::flat_hash_set<string>& BinaryOps() {
+  static const auto* ops = new absl::flat_hash_set<string>{
+      "Add", "AddV2", "Equal", "Greater", "GreaterEqual", "Less", "LessEqual",
+      "LogicalAnd", "LogicalOr", "Maximum", "Minimum", "Mul", "NotEqual",
+      "SquaredDifference", "Sub"};
+  return *ops;
+}
+
+// The shape of a value computed by the map function on one element.
+// Constants are the same for every element, and broadcast against batches
+// as they do against elements only if they are scalars.
+struct ValueShape {
+  bool constant = false;
+  PartialTensorShape shape;
+};
+
+std::optional<ValueShape> OutputShape(
+    const NodeDef& node, const std::vector<const ValueShape*>& inputs) {
+  if (node.op() == "Const") {
+    const auto& value = node.attr().at("value").tensor();
+    if (value.tensor_shape().dim_size() != 0) return std::nullopt;
+    return ValueShape{/*constant=*/true, PartialTensorShape({})};
+  }
+  if (UnaryOps().contains(node.op()) && inputs.size() == 1) {
+    return *inputs[0];
+  }
+  if (BinaryOps().contains(node.op()) && inputs.size() == 2) {
+    if (inputs[0]->constant) return *inputs[1];
+    if (inputs[1]->constant) return *inputs[0];
+    // Operands that differ in shape would broadcast against each other
+    // differently once batched.
+    if (inputs[0]->shape.IsFullyDefined() &&
+        inputs[0]->shape.IsIdenticalTo(inputs[1]->shape)) {
+      return *inputs[0];
+    }
+  }
+  return std::nullopt;
+}
+
+// Returns the node or argument that produces `input` in a function body.
+string ValueName(const string& input) {
+  return input.substr(0, input.find(':'));
+}
+
+// Returns whether `function` computes on a batch of elements whose components
+// have shapes `arg_shapes` the batch of its results on each element.
+bool IsVectorizable(const FunctionDef& function,
+                    const std::vector<PartialTensorShape>& arg_shapes) {
+  const auto& signature = function.signature();
+  if (signature.is_stateful() ||
+      signature.input_arg_size() != arg_shapes.size()) {
+    return false;
+  }
+  absl::flat_hash_map<string, ValueShape> values;
+  for (int i = 0; i < arg_shapes.size(); ++i) {
+    values[signature.input_arg(i).name()] = {false, arg_shapes[i]};
+  }
+
+  // The nodes of a function body are not sorted.
+  std::vector<const NodeDef*> pending;
+  for (const NodeDef& node : function.node_def()) pending.push_back(&node);
+  while (!pending.empty()) {
+    std::vector<const NodeDef*> blocked;
+    for (const NodeDef* node : pending) {
+      std::vector<const ValueShape*> inputs;
+      bool ready = true;
+      for (const string& input : node->input()) {
+        if (IsControlInput(input)) continue;
+        auto it = values.find(ValueName(input));
+        if (it == values.end()) {
+          ready = false;
+          break;
+        }
+        inputs.push_back(&it->second);
+      }
+      if (!ready) {
+        blocked.push_back(node);
+        continue;
+      }
+      std::optional<ValueShape> shape = OutputShape(*node, inputs);
+      if (!shape.has_value()) {
+        VLOG(2) << "Cannot vectorize " << signature.name() << " because of "
+                << node->op() << " node " << node->name();
+        return false;
+      }
+      values[node->name()] = *std::move(shape);
+    }
+    if (blocked.size() == pending.size()) return false;
+    pending.swap(blocked);
+  }
+
+  for (const auto& ret : function.ret()) {
+    auto it = values.find(ValueName(ret.second));
+    if (it == values.end() || it->second.constant) return false;
+  }
+  return true;
+}
+
+// Returns a copy of `function` without the per-element shapes recorded when
+// it was traced.
+FunctionDef MakeVectorizedFunction(const FunctionDef& function,
+                                   const FunctionDefLibrary& library) {
+  FunctionDef vectorized = function;
+  graph_utils::SetUniqueGraphFunctionName(
+      strings::StrCat("vectorized_", function.signature().name()), &library,
+      &vectorized);
+  for (auto& arg_attr : *vectorized.mutable_arg_attr()) {
+    arg_attr.second.mutable_attr()->erase(kOutputShapesAttr);
+  }
+  for (NodeDef& node : *vectorized.mutable_node_def()) {
+    node.mutable_attr()->erase(kOutputShapesAttr);
+  }
+  return vectorized;
+}
+
+bool IsMapWithoutCapturedInputs(const NodeDef& node) {
+  if (node.op() == kMapDataset) return node.input_size() == 1;
+  if (node.op() == kParallelMapDatasetV2) return node.input_size() == 2;
+  return false;
+}
+
+// Returns the batch dimension of the output of `batch_node`, or -1 if it is
+// unknown.
+int64_t BatchDimension(const NodeDef& batch_node) {
+  const auto& shapes = batch_node.attr().at("output_shapes").list().shape();
+  if (shapes.empty() || shapes[0].unknown_rank() ||
+      shapes[0].dim_size() == 0) {
+    return -1;
+  }
+  return shapes[0].dim(0).size();
+}
+
+NodeDef MakeBatchNode(const NodeDef& batch_node, const NodeDef& map_node,
+                      const NodeDef& input_node,
+                      const DataTypeVector& input_types,
+                      MutableGraphView* graph) {
+  NodeDef new_batch = batch_node;
+  graph_utils::SetUniqueGraphNodeName(batch_node.op(), graph->graph(),
+                                      &new_batch);
+  new_batch.set_input(0, map_node.input(0));
+
+  const PartialTensorShape batch_shape({BatchDimension(batch_node)});
+  auto* shapes = (*new_batch.mutable_attr())["output_shapes"].mutable_list();
+  shapes->clear_shape();
+  for (const auto& shape :
+       input_node.attr().at("output_shapes").list().shape()) {
+    batch_shape.Concatenate(PartialTensorShape(shape))
+        .AsProto(shapes->add_shape());
+  }
+  auto* types = (*new_batch.mutable_attr())["output_types"].mutable_list();
+  types->clear_type();
+  for (DataType type : input_types) types->add_type(type);
+  return new_batch;
+}
+
+NodeDef MakeMapNode(const NodeDef& map_node, const NodeDef& batch_node,
+                    const NodeDef& new_batch_node,
+                    const FunctionDef& vectorized_function,
+                    MutableGraphView* graph) {
+  NodeDef new_map = map_node;
+  graph_utils::SetUniqueGraphNodeName(map_node.op(), graph->graph(), &new_map);
+  new_map.set_input(0, new_batch_node.name());
+  (*new_map.mutable_attr())["f"].mutable_func()->set_name(
+      vectorized_function.signature().name());
+  graph_utils::CopyShapesAndTypesAttrs(batch_node, &new_map);
+  return new_map;
+}
+
+}  // namespace
+
+Status MapVectorization::OptimizeAndCollectStats(Cluster* cluster,
+                                                 const GrapplerItem& item,
+                                                 GraphDef* output,
+                                                 OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  absl::flat_hash_set<string> nodes_to_delete;
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item.graph.library());
+
+  for (const NodeDef& node : item.graph.node()) {
+    if (node.op() != "BatchDataset" && node.op() != "BatchDatasetV2") {
+      continue;
+    }
+    const NodeDef& batch_node = node;
+    const NodeDef* map_node = graph_utils::GetInputNode(batch_node, graph);
+    if (map_node == nullptr || !IsMapWithoutCapturedInputs(*map_node) ||
+        graph.GetFanouts(*map_node, /*include_controlled_nodes=*/true)
+                .size() != 1) {
+      continue;
+    }
+    const NodeDef* input_node = graph_utils::GetInputNode(*map_node, graph);
+    DataTypeVector input_types;
+    if (input_node == nullptr || !input_node->attr().count("output_shapes") ||
+        !graph_utils::GetDatasetOutputTypesAttr(*input_node, &input_types)
+             .ok()) {
+      continue;
+    }
+    std::vector<PartialTensorShape> input_shapes;
+    for (const auto& shape :
+         input_node->attr().at("output_shapes").list().shape()) {
+      input_shapes.emplace_back(shape);
+    }
+    const FunctionDef* function =
+        function_library.Find(map_node->attr().at("f").func().name());
+    if (function == nullptr || !IsVectorizable(*function, input_shapes)) {
+      continue;
+    }
+
+    const FunctionDef vectorized_function =
+        MakeVectorizedFunction(*function, output->library());
+    *output->mutable_library()->add_function() = vectorized_function;
+    TF_RETURN_IF_ERROR(function_library.AddFunctionDef(vectorized_function));
+
+    auto* new_batch_node = graph.AddNode(
+        MakeBatchNode(batch_node, *map_node, *input_node, input_types, &graph));
+    auto* new_map_node =
+        graph.AddNode(MakeMapNode(*map_node, batch_node, *new_batch_node,
+                                  vectorized_function, &graph));
+    TF_RETURN_IF_ERROR(
+        graph.UpdateFanouts(batch_node.name(), new_map_node->name()));
+
+    nodes_to_delete.insert(map_node->name());
+    nodes_to_delete.insert(batch_node.name());
+    stats->num_changes++;
+  }
+
+  TF_RETURN_IF_ERROR(graph.DeleteNodes(nodes_to_delete));
+  return absl::OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(MapVectorization, "map_vectorization");
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,119 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+
+// A pipeline of `range.map(function).batch(4)` over scalar int64 elements.
+GrapplerItem MakeMapAndBatchItem(const FunctionDef& function) {
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT64}}),
+       NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT64}}),
+       NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT64}}),
+       NDef("range", "RangeDataset", {"start", "stop", "step"},
+            {{"output_shapes", absl::Span<const TensorShape>{{}}},
+             {"output_types", absl::Span<const DataType>{DT_INT64}}}),
+       NDef("map", "MapDataset", {"range"},
+            {{"f", FunctionDefHelper::FunctionRef(
+                       function.signature().name(), {{"T", DT_INT64}})},
+             {"Targuments", absl::Span<const DataType>{}},
+             {"output_shapes", absl::Span<const TensorShape>{{}}},
+             {"output_types", absl::Span<const DataType>{DT_INT64}}}),
+       NDef("batch_size", "Const", {}, {{"value", 4}, {"dtype", DT_INT64}}),
+       NDef("drop_remainder", "Const", {},
+            {{"value", true}, {"dtype", DT_BOOL}}),
+       NDef("batch", "BatchDatasetV2", {"map", "batch_size", "drop_remainder"},
+            {{"parallel_copy", false},
+             {"output_shapes", absl::Span<const TensorShape>{{4}}},
+             {"output_types", absl::Span<const DataType>{DT_INT64}}}),
+       NDef("Sink", "Identity", {"batch"}, {})},
+      {function});
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+TEST(MapVectorizationTest, MovesElementwiseMapAfterBatch) {
+  const GrapplerItem item = MakeMapAndBatchItem(test::function::XTimesTwo());
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("batch", output));
+  const NodeDef& sink =
+      output.node(graph_utils::FindGraphNodeWithName("Sink", output));
+  const NodeDef& map =
+      output.node(graph_utils::FindGraphNodeWithName(sink.input(0), output));
+  ASSERT_EQ(map.op(), "MapDataset");
+  EXPECT_EQ(map.attr().at("f").func().attr().at("T").type(), DT_INT64);
+  EXPECT_TRUE(graph_utils::ContainsGraphFunctionWithName(
+      map.attr().at("f").func().name(), output.library()));
+  const NodeDef& old_batch = item.graph.node(
+      graph_utils::FindGraphNodeWithName("batch", item.graph));
+  EXPECT_TRUE(AreAttrValuesEqual(map.attr().at("output_shapes"),
+                                 old_batch.attr().at("output_shapes")));
+
+  const NodeDef& batch =
+      output.node(graph_utils::FindGraphNodeWithName(map.input(0), output));
+  ASSERT_EQ(batch.op(), "BatchDatasetV2");
+  EXPECT_EQ(batch.input(0), "range");
+  EXPECT_EQ(batch.input(1), "batch_size");
+  EXPECT_EQ(batch.input(2), "drop_remainder");
+  ASSERT_EQ(batch.attr().at("output_shapes").list().shape_size(), 1);
+  EXPECT_EQ(
+      PartialTensorShape(batch.attr().at("output_shapes").list().shape(0)),
+      PartialTensorShape({4}));
+}
+
+TEST(MapVectorizationTest, DoesNotVectorizeFunctionCalls) {
+  const GrapplerItem item = MakeMapAndBatchItem(test::function::XTimesFour());
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+TEST(MapVectorizationTest, DoesNotVectorizeStatefulFunctions) {
+  const GrapplerItem item =
+      MakeMapAndBatchItem(test::function::RandomUniform());
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
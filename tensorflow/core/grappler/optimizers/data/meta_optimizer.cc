@@ -39,11 +39,13 @@ using ConfigMap =
 
 // tf.data optimizations, in the order we want to perform them.
 // clang-format off
-constexpr std::array<const char*, 22> kTFDataOptimizations = {
+constexpr std::array<const char*, 24> kTFDataOptimizations = {
     "noop_elimination",
     "disable_intra_op_parallelism",
     "use_private_thread_pool",
+    "inject_cache",
     "shuffle_and_repeat_fusion",
+    "map_vectorization",
     "map_parallelization",
     "map_fusion",
     "filter_fusion",
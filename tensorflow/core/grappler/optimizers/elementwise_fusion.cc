@@ -0,0 +1,289 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/elementwise_fusion.h"
+
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/symbolic_shapes.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+// Upper bound on the number of ops in a fused node, which bounds the scratch
+// memory that the kernel needs per tile.
+constexpr int kMaxFusedOps = 32;
+
+// The ops supported by the _FusedElementwise kernel, and their arity.
+const absl::flat_hash_map<string, int>& SupportedOps() {
+  static const auto* const kSupportedOps =
+      new absl::flat_hash_map<string, int>({
+          {"Abs", 1},     {"Exp", 1},     {"Log", 1},
+          {"Neg", 1},     {"Relu", 1},    {"Relu6", 1},
+          {"Rsqrt", 1},   {"Sigmoid", 1}, {"Sqrt", 1},
+          {"Square", 1},  {"Tanh", 1},    {"Add", 2},
+          {"AddV2", 2},   {"Maximum", 2}, {"Minimum", 2},
+          {"Mul", 2},     {"RealDiv", 2}, {"SquaredDifference", 2},
+          {"Sub", 2},
+      });
+  return *kSupportedOps;
+}
+
+class ElementwiseFuser {
+ public:
+  ElementwiseFuser(const GrapplerItem& item, const GraphProperties& properties,
+                   GraphDef* graph)
+      : properties_(properties),
+        graph_(graph),
+        nodes_to_preserve_(item.NodesToPreserve()) {}
+
+  Status Run() {
+    for (int i = 0; i < graph_->node_size(); ++i) {
+      const NodeDef& node = graph_->node(i);
+      node_index_[node.name()] = i;
+      for (const string& input : node.input()) {
+        const TensorId id = ParseTensorName(input);
+        if (IsControlInput(id)) {
+          has_control_fanouts_.insert(string(id.node()));
+        } else {
+          ++num_data_fanouts_[string(id.node())];
+          data_consumer_[string(id.node())] = i;
+        }
+      }
+    }
+    for (int i = 0; i < graph_->node_size(); ++i) {
+      is_candidate_.push_back(IsCandidate(graph_->node(i)));
+    }
+
+    std::set<int> nodes_to_delete;
+    for (int i = 0; i < graph_->node_size(); ++i) {
+      if (!is_candidate_[i] || IsAbsorbedByConsumer(i)) continue;
+      TF_RETURN_IF_ERROR(FuseTreeRootedAt(i, &nodes_to_delete));
+    }
+    EraseNodesFromGraph(nodes_to_delete, graph_);
+    return absl::OkStatus();
+  }
+
+ private:
+  // Returns the index of the producer of the data input `input`, or -1.
+  int ProducerIndex(const string& input) const {
+    const TensorId id = ParseTensorName(input);
+    if (id.index() != 0) return -1;
+    auto it = node_index_.find(id.node());
+    return it == node_index_.end() ? -1 : it->second;
+  }
+
+  const TensorShapeProto* OutputShape(const NodeDef& node) const {
+    if (!properties_.HasOutputProperties(node.name())) return nullptr;
+    const auto& outputs = properties_.GetOutputProperties(node.name());
+    if (outputs.size() != 1 || outputs[0].shape().unknown_rank()) {
+      return nullptr;
+    }
+    return &outputs[0].shape();
+  }
+
+  bool IsCandidate(const NodeDef& node) const {
+    auto it = SupportedOps().find(node.op());
+    if (it == SupportedOps().end()) return false;
+    if (!node.device().empty() && !NodeIsOnCpu(&node)) return false;
+    DataType dtype;
+    if (!GetNodeAttr(node, "T", &dtype).ok() ||
+        (dtype != DT_FLOAT && dtype != DT_DOUBLE)) {
+      return false;
+    }
+    const TensorShapeProto* shape = OutputShape(node);
+    if (shape == nullptr) return false;
+    // Every input must be a scalar, or have the shape of the output.
+    const auto& inputs = properties_.GetInputProperties(node.name());
+    if (inputs.size() != it->second) return false;
+    for (const auto& input : inputs) {
+      if (input.shape().unknown_rank()) return false;
+      if (input.shape().dim_size() != 0 &&
+          !ShapesSymbolicallyEqual(input.shape(), *shape)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns true if the candidate at `index` can be fused into its only
+  // consumer.
+  bool IsAbsorbedByConsumer(int index) {
+    auto it = consumer_.find(index);
+    if (it == consumer_.end()) {
+      it = consumer_.emplace(index, FindAbsorbingConsumer(index)).first;
+    }
+    return it->second >= 0;
+  }
+
+  int FindAbsorbingConsumer(int index) const {
+    const NodeDef& node = graph_->node(index);
+    if (nodes_to_preserve_.count(node.name()) > 0 ||
+        has_control_fanouts_.contains(node.name())) {
+      return -1;
+    }
+    auto fanouts = num_data_fanouts_.find(node.name());
+    if (fanouts == num_data_fanouts_.end() || fanouts->second != 1) return -1;
+    const int consumer_index = data_consumer_.at(node.name());
+    const NodeDef& consumer = graph_->node(consumer_index);
+    if (!is_candidate_[consumer_index] || consumer.device() != node.device() ||
+        consumer.attr().at("T").type() != node.attr().at("T").type() ||
+        !ShapesSymbolicallyEqual(*OutputShape(node), *OutputShape(consumer))) {
+      return -1;
+    }
+    // The only fanout must come from output 0.
+    for (const string& input : consumer.input()) {
+      if (!IsControlInput(input) && ProducerIndex(input) == index) {
+        return consumer_index;
+      }
+    }
+    return -1;
+  }
+
+  // An operand of a fused op: either an input of the fused node, or the
+  // result of an earlier fused op.
+  struct Operand {
+    bool is_op;
+    int index;
+  };
+
+  // Appends the ops of the tree rooted at `index` to `ops`, in post-order,
+  // and returns the operand holding its result.
+  Operand EmitTree(int index, std::vector<int>* tree,
+                   std::vector<std::pair<string, std::vector<Operand>>>* ops,
+                   std::vector<string>* inputs,
+                   absl::flat_hash_map<string, int>* input_index) {
+    const NodeDef& node = graph_->node(index);
+    std::vector<Operand> operands;
+    for (const string& input : node.input()) {
+      if (IsControlInput(input)) continue;
+      const int producer = ProducerIndex(input);
+      if (producer >= 0 && is_candidate_[producer] &&
+          tree->size() + 1 < kMaxFusedOps && IsAbsorbedByConsumer(producer)) {
+        tree->push_back(producer);
+        operands.push_back(
+            EmitTree(producer, tree, ops, inputs, input_index));
+        continue;
+      }
+      auto it = input_index->find(input);
+      if (it == input_index->end()) {
+        it = input_index->emplace(input, inputs->size()).first;
+        inputs->push_back(input);
+      }
+      operands.push_back({/*is_op=*/false, it->second});
+    }
+    ops->emplace_back(node.op(), std::move(operands));
+    return {/*is_op=*/true, static_cast<int>(ops->size()) - 1};
+  }
+
+  Status FuseTreeRootedAt(int root, std::set<int>* nodes_to_delete) {
+    // The members of the tree other than its root.
+    std::vector<int> tree;
+    std::vector<std::pair<string, std::vector<Operand>>> ops;
+    std::vector<string> inputs;
+    absl::flat_hash_map<string, int> input_index;
+    EmitTree(root, &tree, &ops, &inputs, &input_index);
+    if (tree.empty()) return absl::OkStatus();
+
+    NodeDef* fused = graph_->mutable_node(root);
+    VLOG(2) << "Fusing " << ops.size() << " elementwise ops into "
+            << fused->name();
+    std::vector<string> control_inputs;
+    absl::flat_hash_set<string> seen_control_inputs;
+    for (int index : tree) nodes_to_delete->insert(index);
+    for (int index : tree) {
+      for (const string& input : graph_->node(index).input()) {
+        if (IsControlInput(input) && seen_control_inputs.insert(input).second) {
+          control_inputs.push_back(input);
+        }
+      }
+    }
+    for (const string& input : fused->input()) {
+      if (IsControlInput(input) && seen_control_inputs.insert(input).second) {
+        control_inputs.push_back(input);
+      }
+    }
+
+    const int num_inputs = inputs.size();
+    AttrValue op_names;
+    AttrValue operands;
+    for (const auto& op : ops) {
+      op_names.mutable_list()->add_s(op.first);
+      for (int i = 0; i < 2; ++i) {
+        if (i >= op.second.size()) {
+          operands.mutable_list()->add_i(-1);
+        } else {
+          const Operand& operand = op.second[i];
+          operands.mutable_list()->add_i(
+              operand.is_op ? num_inputs + operand.index : operand.index);
+        }
+      }
+    }
+    const DataType dtype = fused->attr().at("T").type();
+    fused->set_op("_FusedElementwise");
+    fused->clear_input();
+    for (const string& input : inputs) fused->add_input(input);
+    for (const string& input : control_inputs) fused->add_input(input);
+    fused->clear_attr();
+    (*fused->mutable_attr())["T"].set_type(dtype);
+    (*fused->mutable_attr())["N"].set_i(num_inputs);
+    (*fused->mutable_attr())["ops"] = std::move(op_names);
+    (*fused->mutable_attr())["operands"] = std::move(operands);
+    return absl::OkStatus();
+  }
+
+  const GraphProperties& properties_;
+  GraphDef* const graph_;
+  const std::unordered_set<string> nodes_to_preserve_;
+
+  absl::flat_hash_map<string, int> node_index_;
+  absl::flat_hash_map<string, int> num_data_fanouts_;
+  absl::flat_hash_set<string> has_control_fanouts_;
+  // For each node, the last node that consumes one of its outputs.
+  absl::flat_hash_map<string, int> data_consumer_;
+  std::vector<bool> is_candidate_;
+  // Memoized results of FindAbsorbingConsumer().
+  absl::flat_hash_map<int, int> consumer_;
+};
+
+}  // namespace
+
+Status ElementwiseFusion::Optimize(Cluster* cluster, const GrapplerItem& item,
+                                   GraphDef* optimized_graph) {
+  *optimized_graph = item.graph;
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(properties.InferStatically(
+      /*assume_valid_feeds=*/false, /*aggressive_shape_inference=*/false,
+      /*include_tensor_values=*/false));
+  return ElementwiseFuser(item, properties, optimized_graph).Run();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(ElementwiseFusion, "elementwise_fusion");
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,60 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_ELEMENTWISE_FUSION_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_ELEMENTWISE_FUSION_H_
+
+#include <string>
+
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Fuses trees of elementwise ops on the CPU (e.g. Mul -> AddV2 -> Relu) into
+// a single _FusedElementwise node, whose kernel evaluates the whole tree one
+// cache-sized tile at a time instead of materializing every intermediate
+// tensor in memory.
+//
+// An op is fused into its consumer if it is the only consumer of its output,
+// the output is not preserved, and both have the same dtype, device and
+// (possibly symbolic) output shape. Ops whose inputs need broadcasting, other
+// than from scalars, are never fused.
+//
+// The optimizer is registered as the custom optimizer "elementwise_fusion",
+// and is enabled by adding it to `RewriterConfig.custom_optimizers`.
+class ElementwiseFusion : public CustomGraphOptimizer {
+ public:
+  ElementwiseFusion() = default;
+  ~ElementwiseFusion() override = default;
+
+  std::string name() const override { return "elementwise_fusion"; }
+
+  bool UsesFunctionLibrary() const override { return false; }
+
+  Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override {
+    return absl::OkStatus();
+  }
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* optimized_graph) override;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_ELEMENTWISE_FUSION_H_
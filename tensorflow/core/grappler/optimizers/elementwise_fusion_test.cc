@@ -0,0 +1,152 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/elementwise_fusion.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class ElementwiseFusionTest : public GrapplerTest {};
+
+TEST_F(ElementwiseFusionTest, FuseChain) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                            ops::Placeholder::Shape({8, 8}));
+  auto b = ops::Placeholder(s.WithOpName("b"), DT_FLOAT,
+                            ops::Placeholder::Shape({8, 8}));
+  auto c = ops::Const(s.WithOpName("c"), -20.0f);
+  auto m = ops::Mul(s.WithOpName("m"), a, b);
+  auto add = ops::AddV2(s.WithOpName("s"), m, c);
+  auto r = ops::Relu(s.WithOpName("r"), add);
+  auto out = ops::Identity(s.WithOpName("out"), r);
+
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out"};
+
+  GraphDef output;
+  ElementwiseFusion optimizer;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(CountOpNodes(output, "_FusedElementwise"), 1);
+  EXPECT_EQ(CountOpNodes(output, "Mul"), 0);
+  EXPECT_EQ(CountOpNodes(output, "AddV2"), 0);
+  EXPECT_EQ(CountOpNodes(output, "Relu"), 0);
+  for (const NodeDef& node : output.node()) {
+    if (node.name() != "r") continue;
+    EXPECT_EQ(node.op(), "_FusedElementwise");
+    ASSERT_EQ(node.input_size(), 3);
+    EXPECT_EQ(node.input(0), "a");
+    EXPECT_EQ(node.input(1), "b");
+    EXPECT_EQ(node.input(2), "c");
+    const auto& ops = node.attr().at("ops").list();
+    ASSERT_EQ(ops.s_size(), 3);
+    EXPECT_EQ(ops.s(0), "Mul");
+    EXPECT_EQ(ops.s(1), "AddV2");
+    EXPECT_EQ(ops.s(2), "Relu");
+    const auto& operands = node.attr().at("operands").list();
+    ASSERT_EQ(operands.i_size(), 6);
+    EXPECT_EQ(operands.i(0), 0);
+    EXPECT_EQ(operands.i(1), 1);
+    EXPECT_EQ(operands.i(2), 3);
+    EXPECT_EQ(operands.i(3), 2);
+    EXPECT_EQ(operands.i(4), 4);
+    EXPECT_EQ(operands.i(5), -1);
+  }
+
+  auto a_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({8, 8}));
+  auto b_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({8, 8}));
+  std::vector<std::pair<string, Tensor>> feeds = {{"a", a_t}, {"b", b_t}};
+  auto expected = EvaluateNodes(item.graph, item.fetch, feeds);
+  auto tensors = EvaluateNodes(output, item.fetch, feeds);
+  ASSERT_EQ(expected.size(), 1);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], expected[0], 1e-6);
+}
+
+TEST_F(ElementwiseFusionTest, PreservedIntermediateIsNotFused) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                            ops::Placeholder::Shape({8, 8}));
+  auto b = ops::Placeholder(s.WithOpName("b"), DT_FLOAT,
+                            ops::Placeholder::Shape({8, 8}));
+  auto m = ops::Mul(s.WithOpName("m"), a, b);
+  auto add = ops::AddV2(s.WithOpName("s"), m, a);
+  auto r = ops::Relu(s.WithOpName("r"), add);
+
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"s", "r"};
+
+  GraphDef output;
+  ElementwiseFusion optimizer;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  // "m" is fused into the fetched "s", which is not fused into "r".
+  EXPECT_EQ(CountOpNodes(output, "Mul"), 0);
+  EXPECT_EQ(CountOpNodes(output, "Relu"), 1);
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "s") {
+      EXPECT_EQ(node.op(), "_FusedElementwise");
+      EXPECT_EQ(node.attr().at("ops").list().s_size(), 2);
+    }
+  }
+
+  auto a_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({8, 8}));
+  auto b_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({8, 8}));
+  std::vector<std::pair<string, Tensor>> feeds = {{"a", a_t}, {"b", b_t}};
+  auto expected = EvaluateNodes(item.graph, item.fetch, feeds);
+  auto tensors = EvaluateNodes(output, item.fetch, feeds);
+  ASSERT_EQ(expected.size(), 2);
+  ASSERT_EQ(tensors.size(), 2);
+  for (int i = 0; i < 2; ++i) {
+    test::ExpectTensorNear<float>(tensors[i], expected[i], 1e-6);
+  }
+}
+
+TEST_F(ElementwiseFusionTest, BroadcastIsNotFused) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                            ops::Placeholder::Shape({8, 8}));
+  auto bias = ops::Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                               ops::Placeholder::Shape({8}));
+  auto m = ops::Mul(s.WithOpName("m"), a, a);
+  auto add = ops::AddV2(s.WithOpName("s"), m, bias);
+  auto r = ops::Relu(s.WithOpName("r"), add);
+
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"r"};
+
+  GraphDef output;
+  ElementwiseFusion optimizer;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(CountOpNodes(output, "_FusedElementwise"), 0);
+  CompareGraphs(item.graph, output);
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
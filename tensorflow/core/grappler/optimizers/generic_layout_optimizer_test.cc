@@ -34,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/tensor_float_32_utils.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/util.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -775,6 +776,73 @@ TEST_F(GenericLayoutOptimizerTest, OptimizeSimpleConv3DGraph_CPU) {
 #endif
 }
 
+#if !(GOOGLE_CUDA || TENSORFLOW_USE_ROCM)
+TEST_F(GenericLayoutOptimizerTest, NHWCToNCHWOnCPU) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output input = ops::Const(s.WithOpName("Input"), 1.0f, {8, 4, 4, 3});
+  Output filter = ops::Const(s.WithOpName("Filter"), 1.0f, {2, 2, 3, 2});
+  Output conv = ops::Conv2D(s.WithOpName("Conv2D").WithDevice("/CPU:0"),
+                            input, filter, {1, 1, 1, 1}, "VALID");
+  Output fetch = ops::Identity(s.WithOpName("Fetch"), {conv});
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  GenericLayoutOptimizer optimizer(RewriterConfig::DEFAULT,
+                                   RewriterConfig::NHWC_TO_NCHW);
+  GraphDef output;
+  Status status = optimizer.Optimize(virtual_cluster_.get(), item, &output);
+  if (!IsMKLEnabled()) {
+    EXPECT_TRUE(errors::IsAborted(status));
+    return;
+  }
+  TF_ASSERT_OK(status);
+
+  utils::GraphView graph_view(&output, &status);
+  TF_ASSERT_OK(status);
+  auto* conv_node = graph_view.GetNode("Conv2D");
+  ASSERT_NE(conv_node, nullptr);
+  VerifyDataFormatAttributeMatch(conv_node, "NCHW");
+  auto* input_transpose_node =
+      graph_view.GetNode("Conv2D-0-TransposeNHWCToNCHW-LayoutOptimizer");
+  ASSERT_NE(input_transpose_node, nullptr);
+  VerifyRegularFaninMatch(conv_node, 0, input_transpose_node->GetName(), 0);
+}
+
+TEST_F(GenericLayoutOptimizerTest, NHWCToNCHWOnCPUKeepsOpsWithoutNCHWKernel) {
+  if (!IsMKLEnabled()) GTEST_SKIP() << "Conversion requires oneDNN.";
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output input = ops::Const(s.WithOpName("Input"), 1.0f, {8, 4, 4, 4});
+  Output depth_to_space = ops::DepthToSpace(
+      s.WithOpName("DepthToSpace").WithDevice("/CPU:0"), input, 2);
+  Output int_input = ops::Const(s.WithOpName("IntInput"), 1, {8, 4, 4, 3});
+  Output max_pool =
+      ops::MaxPool(s.WithOpName("MaxPool").WithDevice("/CPU:0"), int_input,
+                   {1, 2, 2, 1}, {1, 2, 2, 1}, "VALID");
+  Output fetch = ops::Identity(s.WithOpName("Fetch"), {depth_to_space});
+  Output int_fetch = ops::Identity(s.WithOpName("IntFetch"), {max_pool});
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  GenericLayoutOptimizer optimizer(RewriterConfig::DEFAULT,
+                                   RewriterConfig::NHWC_TO_NCHW);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(virtual_cluster_.get(), item, &output));
+
+  Status status;
+  utils::GraphView graph_view(&output, &status);
+  TF_ASSERT_OK(status);
+  // oneDNN has no NCHW kernel of DepthToSpace, nor of int32 MaxPool.
+  auto* depth_to_space_node = graph_view.GetNode("DepthToSpace");
+  ASSERT_NE(depth_to_space_node, nullptr);
+  VerifyDataFormatAttributeMatch(depth_to_space_node, "NHWC");
+  VerifyRegularFaninMatch(depth_to_space_node, 0, "Input", 0);
+  auto* max_pool_node = graph_view.GetNode("MaxPool");
+  ASSERT_NE(max_pool_node, nullptr);
+  VerifyDataFormatAttributeMatch(max_pool_node, "NHWC");
+  VerifyRegularFaninMatch(max_pool_node, 0, "IntInput", 0);
+}
+#endif  // !(GOOGLE_CUDA || TENSORFLOW_USE_ROCM)
+
 // TODO(yanzha): Add more complex Graph for test.
 
 }  // namespace grappler
@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
@@ -40,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/protobuf/device_properties.pb.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/util.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -97,6 +99,45 @@ bool IsNonFloatingConv2D(const utils::MutableNodeView& node) {
   return false;
 }
 
+// Returns true if a CPU kernel of layout sensitive `node` supports NCHW. The
+// Eigen kernels only do so for BiasAdd and BiasAddGrad, and the oneDNN kernels
+// for convolutions, pooling and batch norm in the data types oneDNN supports
+// on this CPU.
+bool HasCpuNchwKernel(const utils::MutableNodeView& node) {
+  const NodeDef& node_def = *node.node();
+  if (IsBiasAddV2(node_def) || IsBiasAddGrad(node_def)) return true;
+  if (!IsMKLEnabled()) return false;
+  static const auto* onednn_nchw_ops = new absl::flat_hash_set<std::string>(
+      {"AvgPool",
+       "AvgPoolGrad",
+       "Conv2D",
+       "Conv2DBackpropFilter",
+       "Conv2DBackpropInput",
+       "Conv3D",
+       "Conv3DBackpropFilterV2",
+       "Conv3DBackpropInputV2",
+       "DepthwiseConv2dNative",
+       "DepthwiseConv2dNativeBackpropFilter",
+       "DepthwiseConv2dNativeBackpropInput",
+       "FusedBatchNorm",
+       "FusedBatchNormGrad",
+       "FusedBatchNormGradV2",
+       "FusedBatchNormGradV3",
+       "FusedBatchNormV2",
+       "FusedBatchNormV3",
+       "MaxPool",
+       "MaxPool3D",
+       "MaxPoolGrad",
+       "_FusedBatchNormEx"});
+  if (!onednn_nchw_ops->contains(node_def.op())) return false;
+  const auto* attr = node.GetAttr(kAttrT);
+  if (attr == nullptr) return false;
+  const DataType dtype = attr->type();
+  return dtype == DT_FLOAT ||
+         ((dtype == DT_BFLOAT16 || dtype == DT_HALF) &&
+          IsDataTypeSupportedByOneDNNOnThisCPU(dtype));
+}
+
 bool IsNonFloatingConv3D(const utils::MutableNodeView& node) {
   if (IsConv3D(*node.node())) {
     const auto* attr = node.GetAttr(kAttrT);
@@ -293,8 +334,14 @@ bool Transposer::ShouldProcess(const TransposeContext& context,
   const bool is_integer_conv2d = IsNonFloatingConv2D(node);
   const bool is_integer_conv3d = IsNonFloatingConv3D(node);
 
+  // Most CPU kernels of layout sensitive ops only support NHWC.
+  const bool has_dst_format_kernel =
+      !IsLayoutSensitiveOp(*node_def) || context.target_device != kCPU ||
+      (context.dst_format != "NCHW" && context.dst_format != "NCDHW") ||
+      HasCpuNchwKernel(node);
+
   return is_on_target_device && data_format_match && !is_integer_conv2d &&
-         !is_integer_conv3d &&
+         !is_integer_conv3d && has_dst_format_kernel &&
          !context.nodes_to_preserve.contains(node_def->name()) &&
          !(node.NumRegularFanouts() == 0 && node.NumControlledFanouts() == 0);
 }
@@ -1052,8 +1052,12 @@ static bool IdentifySwappingCandidates(
         // Don't bother with small tensors.
         continue;
       }
+      // The tensor must live long enough to be copied to the host and back,
+      // assuming PCIe runs at 16 GBps as in SwappingPass().
+      const Costs::Duration time_to_swap(
+          std::max<int64_t>(1e6, 2 * live_tensor.memory_used / 16));
       if (live_tensor.deallocation_time - live_tensor.allocation_time <=
-          Costs::Duration(1e6)) {
+          time_to_swap) {
         // Not enough time to swap.
         VLOG(1) << "Not enough time to swap: skipping " << live_tensor.node;
         continue;
@@ -1265,6 +1269,7 @@ bool SwappingPass(RewriterConfig::MemOptType optimization_level,
       // Make sure we won't try to swap the swap nodes in subsequent passes.
       skip_list->insert(swap_nodes.first->name());
       skip_list->insert(swap_nodes.second->name());
+      updated_graph = true;
     }
   }
   return updated_graph;
@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
+#include "tensorflow/core/grappler/costs/graph_memory.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/grappler_test.h"
@@ -203,7 +204,8 @@ TEST_F(RecomputeSubgraphTest, MultiNode) {
 
 class MemoryOptimizerTest : public GrapplerTest {
  public:
-  static std::unique_ptr<VirtualCluster> CreateVirtualCluster() {
+  static std::unique_ptr<VirtualCluster> CreateVirtualCluster(
+      int64_t gpu_memory_size = 1024 * 1024, int64_t gpu_bandwidth = 128) {
     DeviceProperties cpu_device;
     cpu_device.set_type("CPU");
     cpu_device.set_frequency(1000);
@@ -214,14 +216,46 @@ class MemoryOptimizerTest : public GrapplerTest {
     gpu_device.set_type("GPU");
     gpu_device.set_frequency(1000);
     gpu_device.set_num_cores(24);
-    gpu_device.set_bandwidth(128);
-    gpu_device.set_memory_size(1024 * 1024);
+    gpu_device.set_bandwidth(gpu_bandwidth);
+    gpu_device.set_memory_size(gpu_memory_size);
     gpu_device.mutable_environment()->insert({"architecture", "6"});
     std::unordered_map<string, DeviceProperties> devices;
     devices["/job:localhost/replica:0/task:0/cpu:0"] = cpu_device;
     devices["/job:localhost/replica:0/task:0/gpu:0"] = gpu_device;
     return std::unique_ptr<VirtualCluster>(new VirtualCluster(devices));
   }
+
+  // Returns the graph of the SwappingHeuristics test, with variables of shape
+  // `shape` and without their initialization.
+  static GrapplerItem SwappingHeuristicsItem(const TensorShape& shape) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"), shape,
+                             DT_FLOAT);
+    Output a = ops::Identity(s.WithOpName("a").WithDevice("/gpu:0"), v);
+    Output b = ops::Square(s.WithOpName("b").WithDevice("/gpu:0"), v);
+    Output c = ops::Sqrt(s.WithOpName("c").WithDevice("/gpu:0"), a);
+    Output d = ops::Identity(s.WithOpName("d").WithDevice("/gpu:0"), b);
+    Output axis = ops::Const(s.WithOpName("axis"), 0);
+    Output e =
+        ops::Concat(s.WithOpName("e").WithDevice("/gpu:0"), {a, b, c, d}, axis);
+    Output f = ops::Square(s.WithOpName("f").WithDevice("/gpu:0"), a);
+    Output g = ops::Sqrt(s.WithOpName("g").WithDevice("/gpu:0"), b);
+    Output h = ops::Exp(s.WithOpName("h").WithDevice("/gpu:0"), c);
+    Output i = ops::Log(s.WithOpName("i").WithDevice("/gpu:0"), d);
+
+    GrapplerItem item;
+    TF_CHECK_OK(s.ToGraphDef(&item.graph));
+    item.fetch = {"e", "f", "g", "h", "i"};
+    return item;
+  }
+
+  static int NumSwapOuts(const GraphDef& graph) {
+    int num_swap_outs = 0;
+    for (const auto& node : graph.node()) {
+      if (node.op() == "_CopyFromGpuToHost") ++num_swap_outs;
+    }
+    return num_swap_outs;
+  }
 };
 
 TEST_F(MemoryOptimizerTest, SimpleSwapping) {
@@ -346,6 +380,45 @@ TEST_F(MemoryOptimizerTest, SwappingHeuristics) {
 #endif
 }
 
+TEST_F(MemoryOptimizerTest, SwappingHeuristicsIterateUntilPeakFits) {
+  const GrapplerItem item = SwappingHeuristicsItem({128, 128, 8});
+  const string gpu = "/job:localhost/replica:0/task:0/gpu:0";
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+  GraphMemory memory(item);
+  TF_ASSERT_OK(memory.InferStatically(cluster->GetDevices()));
+  const int64_t peak_memory = memory.GetPeakMemoryUsage(gpu).used_memory;
+
+  // The peak is just over the memory of the device, so the first pass swaps a
+  // single tensor.
+  cluster = CreateVirtualCluster(/*gpu_memory_size=*/peak_memory - 1);
+  MemoryOptimizer optimizer(RewriterConfig::SWAPPING_HEURISTICS);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(cluster.get(), item, &output));
+  ASSERT_GT(NumSwapOuts(output), 0);
+
+  // Tensors are swapped until the peak fits or no candidate is left.
+  GrapplerItem optimized = item.WithGraph(std::move(output));
+  GraphMemory optimized_memory(optimized);
+  TF_ASSERT_OK(optimized_memory.InferStatically(cluster->GetDevices()));
+  EXPECT_TRUE(
+      optimized_memory.GetPeakMemoryUsage(gpu).used_memory < peak_memory ||
+      NumSwapOuts(optimized.graph) > 1);
+}
+
+TEST_F(MemoryOptimizerTest, SwappingHeuristicsSkipTensorsTooBigToSwapInTime) {
+  // 1GB tensors live for tens of milliseconds on this device, more than the
+  // 1ms lower bound but less than the 125ms it takes to swap them out and back
+  // in at 16 GBps.
+  const GrapplerItem item = SwappingHeuristicsItem({1024, 1024, 256});
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster(
+      /*gpu_memory_size=*/1024 * 1024, /*gpu_bandwidth=*/1000 * 1000 * 1000));
+
+  MemoryOptimizer optimizer(RewriterConfig::SWAPPING_HEURISTICS);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(cluster.get(), item, &output));
+  EXPECT_EQ(NumSwapOuts(output), 0);
+}
+
 TEST_F(MemoryOptimizerTest, UnswappableInputs) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"),
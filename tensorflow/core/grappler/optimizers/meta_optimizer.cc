@@ -17,9 +17,11 @@ limitations under the License.
 
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
@@ -54,6 +56,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 #include "tensorflow/core/grappler/optimizers/scoped_allocator_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/shape_optimizer.h"
+#include "tensorflow/core/grappler/optimizers/static_schedule.h"
 #include "tensorflow/core/grappler/utils/canonicalizer.h"
 #include "tensorflow/core/grappler/utils/colocation.h"
 #include "tensorflow/core/grappler/utils/functions.h"
@@ -61,9 +64,12 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/tpu.h"
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
 #include "tensorflow/core/util/xla_config_registry.h"
 
@@ -186,6 +192,36 @@ Status GetGraphDevice(const GraphDef& g_def, std::set<std::string>* devices) {
   return absl::OkStatus();
 }
 
+// Sorts the optimized graph in topological order. If
+// TF_GRAPPLER_MEMORY_AWARE_TOPOLOGICAL_ORDER is set, picks an order that keeps
+// the estimated peak memory low. Node ids follow the order of the graph, so the
+// executor runs ready nodes in this order when TF_DETERMINISTIC_ORDER is set.
+Status SortOptimizedGraph(const GrapplerItem& item, GraphDef* optimized_graph) {
+  bool memory_aware = false;
+  Status env_status =
+      ReadBoolFromEnvVar("TF_GRAPPLER_MEMORY_AWARE_TOPOLOGICAL_ORDER",
+                         /*default_val=*/false, &memory_aware);
+  if (!env_status.ok()) {
+    LOG(ERROR) << "Invalid TF_GRAPPLER_MEMORY_AWARE_TOPOLOGICAL_ORDER, the "
+                  "default topological order is used: "
+               << env_status;
+    memory_aware = false;
+  }
+  if (memory_aware) {
+    std::vector<int> order;
+    Status status = ComputeMemoryAwareTopologicalOrder(
+        item.WithGraph(GraphDef(*optimized_graph)), &order);
+    if (status.ok()) {
+      PermuteNodesInPlace(optimized_graph, &order,
+                          /*invert_permutation=*/true);
+      return absl::OkStatus();
+    }
+    VLOG(1) << "Failed to compute a memory-aware topological order: "
+            << status;
+  }
+  return TopologicalSort(optimized_graph);
+}
+
 }  // namespace
 
 #define MK_OPT(NAME, CONFIG, VALUE)                                    \
@@ -884,10 +920,13 @@ Status MetaOptimizer::OptimizeGraph(
                                    }) != optimization_result.results.end();
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.push_back(optimization_result);
+  }
 
   if (is_optimized) {
-    TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
+    TF_RETURN_IF_ERROR(SortOptimizedGraph(item, optimized_graph));
     ReassignColocation(optimized_graph);
     // Make sure that the optimizers preserved the graph version.
     DCHECK_EQ(optimized_graph->versions().producer(), original_producer);
@@ -1051,7 +1090,10 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       {kGrapplerCategory, "*"});
 
   VLOG(1) << "Starting optimization for grappler item: " << item.id;
-  optimization_results_.clear();
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.clear();
+  }
 
   // Constructs a FunctionLibraryDefinition with functions that are reachable
   // from the nodes of the graph.
@@ -1160,12 +1202,92 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
   // True if this is a TPU graph using the old bridge.
   bool is_tpu_graph = IsLegacyTPUBridgeGraphDef(*optimized_graph);
 
+  // Optimizes the body of `func` into `optimized_func_graph`. This only reads
+  // `flib`, so that several functions can be optimized concurrently.
+  const auto optimize_function =
+      [&](const FunctionDef& func, GrapplerFunctionItem* func_item,
+          GraphDef* optimized_func_graph) -> Status {
+    const string& func_name = func.signature().name();
+
+    // Make a GrapplerItem from a FunctionDef.
+    TF_RETURN_IF_ERROR(
+        MakeGrapplerFunctionItem(func, flib, producer, func_item));
+
+    // If we need to compute the gradient of optimized function at runtime, we
+    // can't perform non-differentiable rewrites.
+    func_item->optimization_options().allow_non_differentiable_rewrites =
+        !differentiable_functions.contains(func_name);
+
+    // Device set available to the function is defined only by the runtime,
+    // when we instantiate and execute the function. We can't use all devices
+    // available to the main graph, because after partitioning the function
+    // call node might execute on a remote worker.
+    if (!func_item->devices().empty()) {
+      return errors::Internal("GrapplerFunctionItem devices must be empty.");
+    }
+
+    // We are not allowed to prune certain types of ops from the graph
+    // instantiated by the function definition, because we must guarantee
+    // function execution semantics wrt side effects (see
+    // function_optimizer.cc).
+    func_item->optimization_options().allow_pruning_stateful_and_dataset_ops =
+        false;
+
+    // Optimize function body graph.
+    if (is_tpu_graph) {
+      // Skip optimizing functions if this is a TPU graph. Currently, Grappler
+      // passes do not handle TPU functions correctly in a variety of ways
+      // (Note that due to the pre-placement TPU graph rewriting passes, the
+      // TPU-related ops are encapsulated away into functions). For example,
+      // TPU graphs contain TPUReplicateMetadata node that carries relevant
+      // TPU metadata and Grappler passes could prune that away. Grappler
+      // passes could also cause issues around shape inference. Since the
+      // desired and existing behavior is to not optimize TPU functions with
+      // Grappler, this check preserves that. The only exception is
+      // implementation selector what is required to swap in some TPU specific
+      // lowering code and is verified the work correctly on TPUs.
+      ImplementationSelector implementation_selector;
+
+      // Implementation selector needs to have access to valid function
+      // signature and attributes, and it doesn't need actual function body.
+      std::unique_ptr<FunctionDefLibrary> func_item_function_library(
+          func_item->graph.release_library());
+      *func_item->graph.mutable_library() =
+          GetFunctionDefLibraryStub(*func_item_function_library);
+
+      return implementation_selector.Optimize(cluster, *func_item,
+                                              optimized_func_graph);
+    }
+    GrapplerFunctionItem func_item_copy = *func_item;
+    return OptimizeGraph(cluster, std::move(func_item_copy),
+                         optimized_func_graph);
+  };
+
+  // Functions in one pass over the library are optimized concurrently if
+  // TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS is greater than one. Their
+  // results are still added to the library in order.
+  int64_t num_function_threads = 1;
+  Status threads_status = ReadInt64FromEnvVar(
+      "TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS", 1, &num_function_threads);
+  if (!threads_status.ok()) {
+    LOG(ERROR) << "Invalid TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS, "
+                  "functions are optimized sequentially: "
+               << threads_status;
+    num_function_threads = 1;
+  }
+  std::unique_ptr<thread::ThreadPool> function_thread_pool;
+  if (num_function_threads > 1) {
+    function_thread_pool = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "grappler_function_optimization", num_function_threads);
+  }
+
   // Optimize each function only once.
   absl::flat_hash_set<string> optimized_funcs;
   while (optimize_function_library) {
     optimize_function_library = false;
 
     int function_idx = 0;
+    std::vector<const FunctionDef*> funcs_to_optimize;
     for (const FunctionDef& func : optimized_graph->library().function()) {
       GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
 
@@ -1196,61 +1318,35 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
       // have to reset the flag and do at least one more pass over the library.
       optimize_function_library = true;
       optimized_funcs.insert(func_name);
+      funcs_to_optimize.push_back(&func);
+    }
 
-      // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
-      TF_RETURN_IF_ERROR(
-          MakeGrapplerFunctionItem(func, flib, producer, &func_item));
-
-      // If we need to compute the gradient of optimized function at runtime, we
-      // can't perform non-differentiable rewrites.
-      func_item.optimization_options().allow_non_differentiable_rewrites =
-          !differentiable_functions.contains(func_name);
-
-      // Device set available to the function is defined only by the runtime,
-      // when we instantiate and execute the function. We can't use all devices
-      // available to the main graph, because after partitioning the function
-      // call node might execute on a remote worker.
-      if (!func_item.devices().empty()) {
-        return errors::Internal("GrapplerFunctionItem devices must be empty.");
+    const int num_funcs = funcs_to_optimize.size();
+    std::vector<GrapplerFunctionItem> func_items(num_funcs);
+    std::vector<GraphDef> optimized_func_graphs(num_funcs);
+    std::vector<Status> statuses(num_funcs);
+    if (function_thread_pool != nullptr) {
+      BlockingCounter counter(num_funcs);
+      for (int i = 0; i < num_funcs; ++i) {
+        function_thread_pool->Schedule([&, i]() {
+          statuses[i] = optimize_function(*funcs_to_optimize[i], &func_items[i],
+                                          &optimized_func_graphs[i]);
+          counter.DecrementCount();
+        });
       }
+      counter.Wait();
+    }
 
-      // We are not allowed to prune certain types of ops from the graph
-      // instantiated by the function definition, because we must guarantee
-      // function execution semantics wrt side effects (see
-      // function_optimizer.cc).
-      func_item.optimization_options().allow_pruning_stateful_and_dataset_ops =
-          false;
-
-      // Optimize function body graph.
-      GraphDef optimized_func_graph;
-      if (is_tpu_graph) {
-        // Skip optimizing functions if this is a TPU graph. Currently, Grappler
-        // passes do not handle TPU functions correctly in a variety of ways
-        // (Note that due to the pre-placement TPU graph rewriting passes, the
-        // TPU-related ops are encapsulated away into functions). For example,
-        // TPU graphs contain TPUReplicateMetadata node that carries relevant
-        // TPU metadata and Grappler passes could prune that away. Grappler
-        // passes could also cause issues around shape inference. Since the
-        // desired and existing behavior is to not optimize TPU functions with
-        // Grappler, this check preserves that. The only exception is
-        // implementation selector what is required to swap in some TPU specific
-        // lowering code and is verified the work correctly on TPUs.
-        ImplementationSelector implementation_selector;
-
-        // Implementation selector needs to have access to valid function
-        // signature and attributes, and it doesn't need actual function body.
-        std::unique_ptr<FunctionDefLibrary> func_item_function_library(
-            func_item.graph.release_library());
-        *func_item.graph.mutable_library() =
-            GetFunctionDefLibraryStub(*func_item_function_library);
-
-        TF_RETURN_IF_ERROR(implementation_selector.Optimize(
-            cluster, func_item, &optimized_func_graph));
+    for (int i = 0; i < num_funcs; ++i) {
+      const string& func_name = funcs_to_optimize[i]->signature().name();
+      GrapplerFunctionItem& func_item = func_items[i];
+      GraphDef& optimized_func_graph = optimized_func_graphs[i];
+      if (function_thread_pool != nullptr) {
+        TF_RETURN_IF_ERROR(statuses[i]);
       } else {
-        GrapplerFunctionItem func_item_copy = func_item;
-        TF_RETURN_IF_ERROR(OptimizeGraph(cluster, std::move(func_item_copy),
-                                         &optimized_func_graph));
+        GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+        TF_RETURN_IF_ERROR(optimize_function(
+            *funcs_to_optimize[i], &func_item, &optimized_func_graph));
       }
 
       // Function body optimization might have created new specialized
@@ -1317,6 +1413,7 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
 
 string MetaOptimizer::GetResultString() const {
   std::string result_string;
+  tf_shared_lock l(optimization_results_mu_);
   for (const GraphOptimizationResult& graph_result : optimization_results_) {
     absl::StrAppend(&result_string,
                     "Optimization results for grappler item: ", graph_result.id,
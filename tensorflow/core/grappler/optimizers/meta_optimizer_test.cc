@@ -194,6 +194,42 @@ TEST_F(MetaOptimizerTest, RunsCustomOptimizerAndCustomGraphOptimizer) {
   EXPECT_TRUE(TestGraphOptimizer::IsOptimized());
 }
 
+TEST_F(MetaOptimizerTest, RunsElementwiseFusion) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                            ops::Placeholder::Shape({8, 8}));
+  auto b = ops::Placeholder(s.WithOpName("b"), DT_FLOAT,
+                            ops::Placeholder::Shape({8, 8}));
+  auto c = ops::Const(s.WithOpName("c"), -20.0f);
+  auto m = ops::Mul(s.WithOpName("m"), a, b);
+  auto add = ops::AddV2(s.WithOpName("add"), m, c);
+  auto r = ops::Relu(s.WithOpName("r"), add);
+  auto out = ops::Identity(s.WithOpName("out"), r);
+
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out"};
+
+  // The pass is registered by the meta optimizer's own dependencies.
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.add_optimizers("elementwise_fusion");
+  rewriter_config.set_min_graph_nodes(-1);
+
+  MetaOptimizer optimizer(nullptr, config_proto);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  int num_fused = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.op(), "Mul");
+    EXPECT_NE(node.op(), "AddV2");
+    EXPECT_NE(node.op(), "Relu");
+    if (node.op() == "_FusedElementwise") ++num_fused;
+  }
+  EXPECT_EQ(num_fused, 1);
+}
+
 TEST_F(MetaOptimizerTest, RunsPluginOptimizer) {
   TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {"/device:GPU:0"});
   GrapplerItem item;
@@ -420,6 +456,76 @@ TEST_F(MetaOptimizerTest, OptimizeFunctionLibrary) {
   test::ExpectTensorEqual<int>(tensors_expected[1], tensors[1]);
 }
 
+TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryInParallel) {
+  using test::function::NDef;
+
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::TWO);
+  rewriter_config.set_function_optimization(RewriterConfig::ON);
+  rewriter_config.add_optimizers("function");
+  rewriter_config.set_min_graph_nodes(-1);
+
+  //   MySquare(x) = x * x, marked as noinline.
+  FunctionDef square_func = FunctionDefHelper::Create(
+      "MySquare", {"x:T"}, {"z:T"}, {"T: {float, int32}"},
+      {{{"mul"}, "Mul", {"x", "x"}, {{"T", "$T"}}}},
+      /*ret_def=*/
+      {{"z", "mul:z:0"}});
+  (*square_func.mutable_attr())["_noinline"].set_b(true);
+
+  // Each call is specialized into its own function, and the specializations
+  // are optimized concurrently.
+  GrapplerItem item;
+  item.id = "tf_graph";
+  item.graph = test::function::GDef(
+      {NDef("a", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice),
+       NDef("b", "Placeholder", {}, {{"dtype", DT_INT32}}, kDevice),
+       NDef("square_a", "MySquare", {"a"}, {{"T", DT_FLOAT}}, kDevice),
+       NDef("square_b", "MySquare", {"b"}, {{"T", DT_INT32}}, kDevice),
+       NDef("out_a", "Identity", {"square_a:0"}, {{"T", DT_FLOAT}}, kDevice),
+       NDef("out_b", "Identity", {"square_b:0"}, {{"T", DT_INT32}}, kDevice)},
+      /*funcs=*/
+      {square_func});
+
+  GraphDef sequential_output;
+  {
+    MetaOptimizer optimizer(nullptr, config_proto);
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &sequential_output));
+  }
+  GraphDef parallel_output;
+  {
+    setenv("TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS", "4", /*overwrite=*/1);
+    MetaOptimizer optimizer(nullptr, config_proto);
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &parallel_output));
+    unsetenv("TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS");
+  }
+
+  FunctionLibraryDefinition sequential_flib(OpRegistry::Global(),
+                                            sequential_output.library());
+  FunctionLibraryDefinition parallel_flib(OpRegistry::Global(),
+                                          parallel_output.library());
+  EXPECT_EQ(2, parallel_flib.num_functions());
+  for (const string& name : sequential_flib.ListFunctionNames()) {
+    const FunctionDef* sequential_func = sequential_flib.Find(name);
+    const FunctionDef* parallel_func = parallel_flib.Find(name);
+    ASSERT_NE(parallel_func, nullptr) << name;
+    EXPECT_TRUE(FunctionDefsEqual(*sequential_func, *parallel_func)) << name;
+  }
+
+  item.fetch = {"out_a", "out_b"};
+  item.feed.emplace_back("a", test::AsScalar<float>(2.0f));
+  item.feed.emplace_back("b", test::AsScalar<int>(4));
+  auto tensors_expected = EvaluateFetchNodes(item);
+
+  GrapplerItem optimized = item.WithGraph(std::move(parallel_output));
+  auto tensors = EvaluateFetchNodes(optimized);
+
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+  test::ExpectTensorEqual<int>(tensors_expected[1], tensors[1]);
+}
+
 TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryPruneUnusedOutputs) {
   using test::function::NDef;
 
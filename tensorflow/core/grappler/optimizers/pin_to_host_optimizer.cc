@@ -46,16 +46,19 @@ bool IsDenylisted(const NodeDef& node) {
       IsNoOp(node);
 }
 
-// Check if Tensor is either a string or is integer and small size
+// Check if Tensor is either a string or is integer, float or bool and small
+// size
 bool IsTensorSmall(const OpInfo::TensorProperties& prop) {
   if (prop.dtype() == DataType::DT_STRING) {
     return true;
   }
 
-  // Check type to be int32 or int64.
+  // Check type to be int32, int64, float or bool. Small bool tensors are
+  // typically masks and predicates computed from small host tensors, and
+  // keeping them on the host avoids a copy to the device and back.
   if (prop.dtype() != DataType::DT_INT32 &&
       prop.dtype() != DataType::DT_INT64 &&
-      prop.dtype() != DataType::DT_FLOAT) {
+      prop.dtype() != DataType::DT_FLOAT && prop.dtype() != DataType::DT_BOOL) {
     return false;
   }
 
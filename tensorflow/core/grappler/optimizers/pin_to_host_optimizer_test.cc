@@ -122,6 +122,34 @@ TEST_F(PinToHostOptimizerTest, OptimizeSmallFloatOpsToHost) {
   }
 }
 
+TEST_F(PinToHostOptimizerTest, OptimizeSmallBoolOpsToHost) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a = ops::Const(s.WithOpName("a"), {1, 2, 3});
+  Output b = ops::Const(s.WithOpName("b"), {1, 0, 3});
+  Output c = ops::Equal(s.WithOpName("c"), a, b);
+
+  GrapplerItem item;
+  item.fetch = {"c"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+
+  GraphDef output;
+  PinToHostOptimizer optimizer(RewriterConfig::ON);
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(tensors_expected.size(), tensors.size());
+  test::ExpectTensorEqual<bool>(tensors[0], tensors_expected[0]);
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_EQ(node.device(), "/device:CPU:0") << node.name();
+    ++found;
+  }
+  EXPECT_EQ(found, 3);
+}
+
 TEST_F(PinToHostOptimizerTest, TopologicalSort) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output a = ops::Const(s.WithOpName("a"), 1, {1024, 1024});
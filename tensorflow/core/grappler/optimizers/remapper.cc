@@ -756,6 +756,36 @@ void AddInputShapesAttr(const RemapperContext& ctx, int node_index) {
   }
 }
 
+// Marks a half or bfloat16 CPU MatMul whose right operand is a constant, so
+// that the kernel converts the operand to float only once.
+void AddRhsIsConstAttr(const RemapperContext& ctx, int node_index) {
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  if (!NodeIsOnCpu(node_def) || node_view->NumRegularFanins() != 2) return;
+  const DataType dtype = GetDataTypeFromAttr(*node_def, "T");
+  if (dtype != DT_HALF && dtype != DT_BFLOAT16) return;
+  if (!IsConstant(*node_view->GetRegularFanin(1).node_view()->node())) return;
+
+  auto* mutable_node = ctx.graph_view.graph()->mutable_node(node_index);
+  (*mutable_node->mutable_attr())["_rhs_is_const"].set_b(true);
+}
+
+// Marks a float CPU _FusedConv2D whose filter is a constant, so that the
+// kernel may keep the transformed filter between its invocations.
+void AddFilterIsConstAttr(const RemapperContext& ctx, int node_index) {
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  if (node_def->op() != kFusedConv2D || !NodeIsOnCpu(node_def) ||
+      node_view->NumRegularFanins() < 2) {
+    return;
+  }
+  if (GetDataTypeFromAttr(*node_def, "T") != DT_FLOAT) return;
+  if (!IsConstant(*node_view->GetRegularFanin(1).node_view()->node())) return;
+
+  auto* mutable_node = ctx.graph_view.graph()->mutable_node(node_index);
+  (*mutable_node->mutable_attr())["_filter_is_const"].set_b(true);
+}
+
 bool FindContractionWithBias(const RemapperContext& ctx, int node_index,
                              ContractionWithBiasAdd* matched,
                              bool check_device_compatible = true) {
@@ -1578,10 +1608,10 @@ bool FindMatMulBiasAddAndGelu(RemapperContext* ctx, int node_index,
                               std::map<string, int>* matched_nodes_map,
                               std::set<int>* remove_node_indices,
                               bool* is_gelu_approximate) {
-  // Gelu fusion is enabled with oneDNN or cublasLt or cuDNN library.
-  if (!IsMKLEnabled() && !BlasLtMatmulEnabled() &&
-      !RuntimeFusionEnabled(cluster))
-    return false;
+  // Gelu fusion is enabled with oneDNN or the Eigen CPU kernel, and on GPU with
+  // cuDNN library for GeluExact or cublasLt library for GeluApproximate. All
+  // Gelu patterns end with a Mul.
+  if (!IsMul(*ctx->graph_view.GetNode(node_index)->node())) return false;
 
   using utils::MatchingDirection;
   using utils::NodeStatus;
@@ -1697,7 +1727,7 @@ bool FindMatMulBiasAddAndGelu(RemapperContext* ctx, int node_index,
         ctx->graph_view.GetNode(matched_nodes_map->at("matmul"))->node();
     DataType matmul_dtype = GetDataTypeFromAttr(*matmul_node, "T");
 
-    bool cpu_ok = IsMKLEnabled() && IsCpuCompatibleMatMul(*ctx, matmul_node);
+    bool cpu_ok = IsCpuCompatibleMatMul(*ctx, matmul_node);
     // Currently, the fusion is not supported on CPU for transpose_a in the
     // MatMul op.
     cpu_ok = cpu_ok && matmul_node->attr().contains("transpose_a") &&
@@ -1734,7 +1764,10 @@ bool FindMatMulBiasAddAndGelu(RemapperContext* ctx, int node_index,
 
     // matmul_node is already the _FusedMatMul and we don't need to check its
     // data type again.
-    if (!IsMKLEnabled() && !NodeIsOnGpu(matmul_node)) return false;
+    if (NodeIsOnGpu(matmul_node) && !BlasLtMatmulEnabled() &&
+        !RuntimeFusionEnabled(cluster)) {
+      return false;
+    }
 
     // Currently, the fusion is not supported on CPU for transpose_a in the
     // MatMul op.
@@ -4838,6 +4871,10 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       AddInputShapesAttr(ctx, i);
     }
 
+    if (!IsMKLEnabled() && IsMatMul(ctx.graph_view.graph()->node(i))) {
+      AddRhsIsConstAttr(ctx, i);
+    }
+
     if (IsMKLEnabled()) {
       const auto* node_view = ctx.graph_view.GetNode(i);
       const auto* node_def = node_view->node();
@@ -5140,6 +5177,12 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
   }
   TF_RETURN_IF_ERROR(mutation->Apply());
 
+  if (!IsMKLEnabled()) {
+    for (int i = 0; i < ctx.graph_view.NumNodes(); ++i) {
+      AddFilterIsConstAttr(ctx, i);
+    }
+  }
+
   *optimized_graph = std::move(mutable_item.graph);
 
   return absl::OkStatus();
@@ -1870,6 +1870,118 @@ TEST_F(RemapperFuseMatMulWithBiasTest, Bf16) {
   RunTest<DT_BFLOAT16>();  // NOLINT
 }
 
+TEST_F(RemapperTest, MarkMatMulWithConstantRhs) {
+  if (IsMKLEnabled()) GTEST_SKIP() << "Not marked with oneDNN.";
+  using ::tensorflow::ops::Placeholder;
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto lhs_t = GenerateTensorWithSetRandom<DT_BFLOAT16>({1, 32});
+  auto rhs_t = GenerateTensorWithSetRandom<DT_BFLOAT16>({32, 16});
+
+  auto lhs = Placeholder(s.WithOpName("lhs"), DT_BFLOAT16,
+                         ops::Placeholder::Shape({1, 32}));
+  auto const_rhs = ops::Const(s.WithOpName("const_rhs"), rhs_t);
+  auto rhs = Placeholder(s.WithOpName("rhs"), DT_BFLOAT16,
+                         ops::Placeholder::Shape({16, 32}));
+  auto const_matmul = ops::MatMul(s.WithOpName("const_matmul"), lhs, const_rhs);
+  auto matmul = ops::MatMul(s.WithOpName("matmul"), const_matmul, rhs);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), matmul);
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"lhs", lhs_t},
+               {"rhs", GenerateTensorWithSetRandom<DT_BFLOAT16>({16, 32})}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "const_matmul") {
+      ASSERT_EQ(node.attr().count("_rhs_is_const"), 1);
+      EXPECT_TRUE(node.attr().at("_rhs_is_const").b());
+      found++;
+    } else if (node.name() == "matmul") {
+      EXPECT_EQ(node.attr().count("_rhs_is_const"), 0);
+      found++;
+    }
+  }
+  EXPECT_EQ(2, found);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectClose(tensors[0], tensors_expected[0], 1e-2, 1e-2);
+}
+
+TEST_F(RemapperTest, MarkFusedConv2DWithConstantFilter) {
+  if (IsMKLEnabled()) GTEST_SKIP() << "Not marked with oneDNN.";
+  using ::tensorflow::ops::Placeholder;
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto input_t = GenerateRandomTensor<DT_FLOAT>({1, 8, 8, 16});
+  auto filter_t = GenerateRandomTensor<DT_FLOAT>({3, 3, 16, 16});
+  auto bias_t = GenerateRandomTensor<DT_FLOAT>({16});
+
+  auto input = Placeholder(s.WithOpName("input"), DT_FLOAT,
+                           ops::Placeholder::Shape({1, 8, 8, 16}));
+  auto const_filter = ops::Const(s.WithOpName("const_filter"), filter_t);
+  auto filter = Placeholder(s.WithOpName("filter"), DT_FLOAT,
+                            ops::Placeholder::Shape({3, 3, 16, 16}));
+  auto bias = ops::Const(s.WithOpName("bias"), bias_t);
+
+  std::vector<int> strides = {1, 1, 1, 1};
+  auto const_conv = ops::Conv2D(s.WithOpName("const_conv"), input,
+                                const_filter, strides, "SAME");
+  auto const_bias_add =
+      ops::BiasAdd(s.WithOpName("const_bias_add"), const_conv, bias);
+  auto conv = ops::Conv2D(s.WithOpName("conv"), const_bias_add, filter,
+                          strides, "SAME");
+  auto bias_add = ops::BiasAdd(s.WithOpName("bias_add"), conv, bias);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), bias_add);
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"input", input_t}, {"filter", filter_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "const_bias_add") {
+      EXPECT_EQ(node.op(), "_FusedConv2D");
+      ASSERT_EQ(node.attr().count("_filter_is_const"), 1);
+      EXPECT_TRUE(node.attr().at("_filter_is_const").b());
+      found++;
+    } else if (node.name() == "bias_add") {
+      EXPECT_EQ(node.op(), "_FusedConv2D");
+      EXPECT_EQ(node.attr().count("_filter_is_const"), 0);
+      found++;
+    }
+  }
+  EXPECT_EQ(2, found);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-4);
+}
+
 // TODO(b/161005848): Fix flaky test.
 TEST_F(RemapperTest, DISABLED_FuseConv2DWithBiasAndActivationOnGPU) {
 #if !(GOOGLE_CUDA)
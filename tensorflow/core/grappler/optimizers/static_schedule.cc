@@ -16,10 +16,16 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/static_schedule.h"
 
 #include <deque>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
 
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/utils.h"
 #include "tensorflow/core/grappler/costs/virtual_placer.h"
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/utils.h"
@@ -199,5 +205,123 @@ Status EstimateRequiredTimes(
   return absl::OkStatus();
 }
 
+Status ComputeMemoryAwareTopologicalOrder(const GrapplerItem& item,
+                                          std::vector<int>* order) {
+  const GraphDef& graph = item.graph;
+  const int num_nodes = graph.node_size();
+  std::unordered_map<string, int> name_map;
+  for (int i = 0; i < num_nodes; ++i) {
+    name_map[graph.node(i).name()] = i;
+  }
+
+  // Deduplicated fanins and fanouts of each node, and the subsets of them that
+  // carry data rather than control dependencies.
+  std::vector<std::vector<int>> fanouts(num_nodes);
+  std::vector<std::vector<int>> data_fanins(num_nodes);
+  std::vector<std::vector<int>> data_fanouts(num_nodes);
+  std::vector<int> pending_inputs(num_nodes, 0);
+  for (int i = 0; i < num_nodes; ++i) {
+    const NodeDef& node = graph.node(i);
+    std::unordered_set<int> fanins, data_fanin_set;
+    for (const string& input : node.input()) {
+      auto it = name_map.find(NodeName(input));
+      if (it == name_map.end()) {
+        return errors::InvalidArgument(
+            strings::StrCat("Unknown input node ", input));
+      }
+      const int fanin = it->second;
+      if (fanins.insert(fanin).second) {
+        fanouts[fanin].push_back(i);
+        // The back edges of loops don't have to be scheduled first.
+        if (!IsMerge(node) || !IsNextIteration(graph.node(fanin))) {
+          ++pending_inputs[i];
+        }
+      }
+      if (!IsControlInput(input) && data_fanin_set.insert(fanin).second) {
+        data_fanins[i].push_back(fanin);
+        data_fanouts[fanin].push_back(i);
+      }
+    }
+  }
+
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(
+      properties.InferStatically(/*assume_valid_feeds=*/false,
+                                 /*aggressive_shape_inference=*/false,
+                                 /*include_tensor_values=*/false));
+  std::vector<int64_t> output_bytes(num_nodes, 0);
+  for (int i = 0; i < num_nodes; ++i) {
+    for (const auto& output :
+         properties.GetOutputProperties(graph.node(i).name())) {
+      output_bytes[i] += CalculateTensorSize(output);
+    }
+  }
+
+  std::vector<int> remaining_consumers(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) {
+    remaining_consumers[i] = data_fanouts[i].size();
+  }
+  auto net_allocated_bytes = [&](int node) {
+    int64_t bytes = output_bytes[node];
+    for (int fanin : data_fanins[node]) {
+      if (remaining_consumers[fanin] == 1) bytes -= output_bytes[fanin];
+    }
+    return bytes;
+  };
+
+  // Ready nodes by increasing net allocation and position. The net allocation
+  // of a ready node can only decrease, so an entry is stale if the node has
+  // been pushed again with a lower one since.
+  using Candidate = std::tuple<int64_t, int>;
+  std::priority_queue<Candidate, std::vector<Candidate>,
+                      std::greater<Candidate>>
+      ready_nodes;
+  std::vector<int64_t> scores(num_nodes, 0);
+  std::vector<bool> scheduled(num_nodes, false);
+  auto push_ready = [&](int node) {
+    scores[node] = net_allocated_bytes(node);
+    ready_nodes.emplace(scores[node], node);
+  };
+  for (int i = 0; i < num_nodes; ++i) {
+    if (pending_inputs[i] == 0) push_ready(i);
+  }
+
+  order->clear();
+  order->reserve(num_nodes);
+  int64_t allocated_bytes = 0;
+  int64_t peak_bytes = 0;
+  while (!ready_nodes.empty()) {
+    const auto [score, node] = ready_nodes.top();
+    ready_nodes.pop();
+    if (scheduled[node] || score != scores[node]) continue;
+    scheduled[node] = true;
+    order->push_back(node);
+    peak_bytes = std::max(peak_bytes, allocated_bytes + output_bytes[node]);
+    allocated_bytes += score;
+
+    for (int fanin : data_fanins[node]) {
+      if (--remaining_consumers[fanin] != 1) continue;
+      // The last consumer of `fanin` now frees it once it runs.
+      for (int consumer : data_fanouts[fanin]) {
+        if (!scheduled[consumer] && pending_inputs[consumer] == 0) {
+          push_ready(consumer);
+        }
+      }
+    }
+    for (int fanout : fanouts[node]) {
+      if (scheduled[fanout] || pending_inputs[fanout] == 0) continue;
+      if (--pending_inputs[fanout] == 0) push_ready(fanout);
+    }
+  }
+
+  if (order->size() != static_cast<size_t>(num_nodes)) {
+    return errors::InvalidArgument(
+        "The graph couldn't be sorted in topological order.");
+  }
+  VLOG(1) << "Estimated peak memory of the memory-aware order of " << item.id
+          << ": " << peak_bytes << " bytes";
+  return absl::OkStatus();
+}
+
 }  // end namespace grappler
 }  // end namespace tensorflow
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_STATIC_SCHEDULE_H_
 
 #include <unordered_map>
+#include <vector>
 
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
@@ -44,6 +45,15 @@ Status EstimateRequiredTimes(
         execution_times,
     std::unordered_map<const NodeDef*, Costs::NanoSeconds>* required_times);
 
+// Compute a topological ordering of the nodes in the graph that keeps the
+// estimated peak memory low, and output the indices of the nodes in that order.
+// Among the nodes that are ready to run, each step picks the one that allocates
+// the fewest bytes net of the inputs it is the last consumer of, breaking ties
+// by the position of the node in the graph. Output sizes are derived from the
+// statically inferred shapes.
+Status ComputeMemoryAwareTopologicalOrder(const GrapplerItem& item,
+                                          std::vector<int>* order);
+
 }  // namespace grappler
 }  // end namespace tensorflow
 
@@ -196,6 +196,33 @@ TEST_F(StaticScheduleTest, RequiredTimes) {
                                       "Sign_2", "Sign_3", "y"}));
 }
 
+TEST_F(StaticScheduleTest, MemoryAwareTopologicalOrder) {
+  // Two branches that each expand the input and reduce it again. Running both
+  // expansions before the reductions would keep both large tensors alive.
+  Scope s = Scope::NewRootScope();
+  Output x = ops::Const(s.WithOpName("x"), 1.0f, {10});
+  Output multiples = ops::Const(s.WithOpName("multiples"), {100}, {1});
+  Output axis = ops::Const(s.WithOpName("axis"), 0);
+  Output tile1 = ops::Tile(s.WithOpName("tile1"), x, multiples);
+  Output tile2 = ops::Tile(s.WithOpName("tile2"), x, multiples);
+  Output sum1 = ops::Sum(s.WithOpName("sum1"), tile1, axis);
+  Output sum2 = ops::Sum(s.WithOpName("sum2"), tile2, axis);
+  Output out = ops::Add(s.WithOpName("out"), sum1, sum2);
+  GrapplerItem item;
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out"};
+
+  std::vector<int> order;
+  TF_ASSERT_OK(ComputeMemoryAwareTopologicalOrder(item, &order));
+  std::vector<std::string> ordered_node_names;
+  for (int node : order) {
+    ordered_node_names.push_back(item.graph.node(node).name());
+  }
+  EXPECT_EQ(ordered_node_names,
+            (std::vector<std::string>{"multiples", "axis", "x", "tile1",
+                                      "sum1", "tile2", "sum2", "out"}));
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
@@ -0,0 +1,173 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/async_checkpoint.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+#if !defined(IS_MOBILE_PLATFORM)
+#include "tsl/distributed_runtime/coordination/coordination_service_agent.h"
+#endif  // !defined(IS_MOBILE_PLATFORM)
+
+namespace tensorflow {
+namespace checkpoint {
+
+namespace {
+
+constexpr int kNumWriterThreads = 4;
+
+#if !defined(IS_MOBILE_PLATFORM)
+// The coordination service key holding the status of the write of `prefix`.
+std::string StatusKey(const std::string& prefix) {
+  return absl::StrCat("async_checkpoint:", prefix);
+}
+
+// Statuses are published as "<code>:<message>".
+std::string EncodeStatus(const Status& status) {
+  return absl::StrCat(static_cast<int>(status.code()), ":", status.message());
+}
+
+Status DecodeStatus(const std::string& value) {
+  std::pair<std::string, std::string> code_and_message =
+      absl::StrSplit(value, absl::MaxSplits(':', 1));
+  int code;
+  if (!absl::SimpleAtoi(code_and_message.first, &code)) {
+    return errors::Internal("Malformed async checkpoint status: ", value);
+  }
+  return Status(static_cast<absl::StatusCode>(code), code_and_message.second);
+}
+
+void PublishStatus(tsl::CoordinationServiceAgent* agent,
+                   const std::string& prefix, const Status& status) {
+  Status s = agent->InsertKeyValue(StatusKey(prefix), EncodeStatus(status));
+  if (!s.ok()) {
+    LOG(ERROR) << "Failed to publish the status of the async save of "
+               << prefix << ": " << s;
+  }
+}
+#endif  // !defined(IS_MOBILE_PLATFORM)
+
+}  // namespace
+
+AsyncSaveMode GetAsyncSaveMode() {
+  std::string mode;
+  Status s = ReadStringFromEnvVar("TF_ASYNC_CHECKPOINT_SAVE", "", &mode);
+  if (!s.ok() || mode.empty()) return AsyncSaveMode::kOff;
+  if (mode == "reference") return AsyncSaveMode::kReference;
+  if (mode == "copy") return AsyncSaveMode::kCopy;
+  LOG_FIRST_N(ERROR, 1) << "Unknown TF_ASYNC_CHECKPOINT_SAVE=" << mode
+                        << ", expected \"reference\" or \"copy\". "
+                        << "Checkpoints are saved synchronously.";
+  return AsyncSaveMode::kOff;
+}
+
+/*static*/ AsyncCheckpointWriter* AsyncCheckpointWriter::Global() {
+  static AsyncCheckpointWriter* writer =
+      new AsyncCheckpointWriter(kNumWriterThreads);
+  return writer;
+}
+
+AsyncCheckpointWriter::AsyncCheckpointWriter(int num_threads)
+    : thread_pool_(std::make_unique<thread::ThreadPool>(
+          Env::Default(), "async_checkpoint", num_threads)) {}
+
+void AsyncCheckpointWriter::Schedule(const std::string& prefix,
+                                     std::function<Status()> write,
+                                     tsl::CoordinationServiceAgent* agent) {
+  std::shared_ptr<Writes> writes;
+  {
+    mutex_lock l(mu_);
+    std::shared_ptr<Writes>& entry = writes_[prefix];
+    if (entry == nullptr) entry = std::make_shared<Writes>();
+    ++entry->num_pending;
+    writes = entry;
+  }
+  thread_pool_->Schedule([this, prefix, writes = std::move(writes),
+                          write = std::move(write), agent]() {
+    Status status = write();
+    VLOG(1) << "Finished the async save of " << prefix << ": " << status;
+#if !defined(IS_MOBILE_PLATFORM)
+    if (agent != nullptr) PublishStatus(agent, prefix, status);
+#endif  // !defined(IS_MOBILE_PLATFORM)
+    mutex_lock l(mu_);
+    writes->status.Update(status);
+    if (--writes->num_pending > 0) return;
+    auto it = writes_.find(prefix);
+    if (it != writes_.end() && it->second == writes) writes_.erase(it);
+    if (writes->num_waiters > 0) {
+      cv_.notify_all();
+    } else if (!writes->status.ok()) {
+      LOG(ERROR) << "The async save of " << prefix
+                 << " failed: " << writes->status;
+      unreported_status_.Update(writes->status);
+    }
+  });
+}
+
+Status AsyncCheckpointWriter::Wait(const std::string& prefix) {
+  mutex_lock l(mu_);
+  auto it = writes_.find(prefix);
+  if (it == writes_.end()) return absl::OkStatus();
+  std::shared_ptr<Writes> writes = it->second;
+  ++writes->num_waiters;
+  while (writes->num_pending > 0) cv_.wait(l);
+  --writes->num_waiters;
+  return writes->status;
+}
+
+Status AsyncCheckpointWriter::WaitForAnyTask(
+    const std::string& prefix, tsl::CoordinationServiceAgent* agent) {
+  bool local;
+  {
+    mutex_lock l(mu_);
+    local = writes_.contains(prefix);
+  }
+  if (local || agent == nullptr) {
+    Status status = Wait(prefix);
+#if !defined(IS_MOBILE_PLATFORM)
+    if (agent != nullptr) {
+      agent->DeleteKeyValue(StatusKey(prefix)).IgnoreError();
+    }
+#endif  // !defined(IS_MOBILE_PLATFORM)
+    return status;
+  }
+#if !defined(IS_MOBILE_PLATFORM)
+  VLOG(1) << "Waiting for another task to save " << prefix;
+  absl::StatusOr<std::string> value = agent->GetKeyValue(StatusKey(prefix));
+  if (!value.ok()) return value.status();
+  agent->DeleteKeyValue(StatusKey(prefix)).IgnoreError();
+  return DecodeStatus(*value);
+#else
+  return absl::OkStatus();
+#endif  // !defined(IS_MOBILE_PLATFORM)
+}
+
+Status AsyncCheckpointWriter::ConsumeErrors() {
+  mutex_lock l(mu_);
+  Status status = std::move(unreported_status_);
+  unreported_status_ = absl::OkStatus();
+  return status;
+}
+
+}  // namespace checkpoint
+}  // namespace tensorflow
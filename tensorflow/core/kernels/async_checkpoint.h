@@ -0,0 +1,113 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_ASYNC_CHECKPOINT_H_
+#define TENSORFLOW_CORE_KERNELS_ASYNC_CHECKPOINT_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tsl {
+class CoordinationServiceAgent;
+}  // namespace tsl
+
+namespace tensorflow {
+namespace checkpoint {
+
+// How SaveV2 writes its bundle, read from TF_ASYNC_CHECKPOINT_SAVE on every
+// save.
+enum class AsyncSaveMode {
+  // Unset: SaveV2 writes the bundle before it returns.
+  kOff,
+  // "reference": SaveV2 holds references to its inputs and writes them in
+  // the background.  Resource variables copy their buffer on the next write
+  // while it is referenced, so this is a copy-on-write snapshot of them; it
+  // is not one of legacy reference variables, which are updated in place.
+  kReference,
+  // "copy": SaveV2 copies its inputs to (pinned, if a GPU is present) host
+  // memory and writes the copies in the background.
+  kCopy,
+};
+AsyncSaveMode GetAsyncSaveMode();
+
+// Runs the bundle writes of asynchronous saves on a thread pool, and tracks
+// their status by checkpoint prefix.
+//
+// The checkpoint is committed by MergeV2Checkpoints, which waits for the
+// writes of all of its input prefixes and writes the merged metadata file
+// only if all of them succeeded.  Writes on other tasks are waited for
+// through the coordination service, where each task publishes the status of
+// its writes; all tasks must then use the same AsyncSaveMode.  Without a
+// coordination service agent, only the writes of this task are waited for.
+// Checkpoints that are not merged are complete once Wait() returns for their
+// prefix.
+//
+// Errors of writes that finish while nobody waits for their prefix are kept
+// until the next ConsumeErrors(), which SaveV2 and MergeV2Checkpoints call.
+class AsyncCheckpointWriter {
+ public:
+  static AsyncCheckpointWriter* Global();
+
+  explicit AsyncCheckpointWriter(int num_threads);
+
+  // Runs `write` for `prefix` in the background.  If `agent` is not null,
+  // its status is published to the coordination service once it finishes.
+  void Schedule(const std::string& prefix, std::function<Status()> write,
+                tsl::CoordinationServiceAgent* agent) TF_LOCKS_EXCLUDED(mu_);
+
+  // Blocks until the writes of `prefix` scheduled on this writer have
+  // finished, and returns the first error among them.  Returns OK if no
+  // write of `prefix` is pending.
+  Status Wait(const std::string& prefix) TF_LOCKS_EXCLUDED(mu_);
+
+  // Like Wait(), but if no write of `prefix` was scheduled on this writer
+  // and `agent` is not null, blocks until a task publishes the status of
+  // its write to the coordination service, and then removes it.
+  Status WaitForAnyTask(const std::string& prefix,
+                        tsl::CoordinationServiceAgent* agent)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the first error of the writes that finished with nobody waiting
+  // for them since the last call, and clears it.
+  Status ConsumeErrors() TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct Writes {
+    int num_pending = 0;
+    int num_waiters = 0;
+    Status status;
+  };
+
+  mutex mu_;
+  condition_variable cv_;
+  // prefix -> writes that have not finished yet.  Entries are erased as soon
+  // as their last write finishes; waiters keep their own reference.
+  absl::flat_hash_map<std::string, std::shared_ptr<Writes>> writes_
+      TF_GUARDED_BY(mu_);
+  // First error of the finished writes that were not waited for.
+  Status unreported_status_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
+};
+
+}  // namespace checkpoint
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_ASYNC_CHECKPOINT_H_
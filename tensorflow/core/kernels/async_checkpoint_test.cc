@@ -0,0 +1,110 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/async_checkpoint.h"
+
+#include <atomic>
+#include <cstdlib>
+
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace checkpoint {
+namespace {
+
+TEST(AsyncCheckpointWriterTest, WaitBlocksUntilWritesFinish) {
+  AsyncCheckpointWriter writer(/*num_threads=*/2);
+  Notification start;
+  std::atomic<int> num_written(0);
+  for (int i = 0; i < 2; ++i) {
+    writer.Schedule(
+        "/tmp/ckpt",
+        [&start, &num_written]() {
+          start.WaitForNotification();
+          ++num_written;
+          return absl::OkStatus();
+        },
+        /*agent=*/nullptr);
+  }
+  start.Notify();
+  TF_EXPECT_OK(writer.Wait("/tmp/ckpt"));
+  EXPECT_EQ(num_written, 2);
+}
+
+TEST(AsyncCheckpointWriterTest, ReturnsFirstErrorOnce) {
+  AsyncCheckpointWriter writer(/*num_threads=*/1);
+  writer.Schedule(
+      "/tmp/ckpt", []() { return errors::DataLoss("disk full"); },
+      /*agent=*/nullptr);
+  writer.Schedule(
+      "/tmp/other", []() { return absl::OkStatus(); }, /*agent=*/nullptr);
+  // The write may finish before Wait() is called, in which case its error is
+  // kept for ConsumeErrors().
+  Status status = writer.Wait("/tmp/ckpt");
+  status.Update(writer.ConsumeErrors());
+  EXPECT_TRUE(errors::IsDataLoss(status)) << status;
+  TF_EXPECT_OK(writer.WaitForAnyTask("/tmp/other", /*agent=*/nullptr));
+  // The error has been reported.
+  TF_EXPECT_OK(writer.Wait("/tmp/ckpt"));
+  TF_EXPECT_OK(writer.ConsumeErrors());
+}
+
+TEST(AsyncCheckpointWriterTest, KeepsErrorsThatWereNotWaitedFor) {
+  AsyncCheckpointWriter writer(/*num_threads=*/1);
+  writer.Schedule(
+      "/tmp/ckpt", []() { return errors::DataLoss("disk full"); },
+      /*agent=*/nullptr);
+  // The single thread runs the writes in order, so the first one has
+  // finished once the second one runs.
+  Notification done;
+  writer.Schedule(
+      "/tmp/other",
+      [&done]() {
+        done.Notify();
+        return absl::OkStatus();
+      },
+      /*agent=*/nullptr);
+  done.WaitForNotification();
+  TF_EXPECT_OK(writer.Wait("/tmp/other"));
+  // The finished write is no longer tracked by prefix.
+  TF_EXPECT_OK(writer.Wait("/tmp/ckpt"));
+  Status status = writer.ConsumeErrors();
+  EXPECT_TRUE(errors::IsDataLoss(status)) << status;
+  TF_EXPECT_OK(writer.ConsumeErrors());
+}
+
+TEST(AsyncCheckpointWriterTest, WaitWithoutWrites) {
+  AsyncCheckpointWriter writer(/*num_threads=*/1);
+  TF_EXPECT_OK(writer.Wait("/tmp/ckpt"));
+  TF_EXPECT_OK(writer.WaitForAnyTask("/tmp/ckpt", /*agent=*/nullptr));
+}
+
+TEST(AsyncSaveModeTest, ReadsEnvironment) {
+  unsetenv("TF_ASYNC_CHECKPOINT_SAVE");
+  EXPECT_EQ(GetAsyncSaveMode(), AsyncSaveMode::kOff);
+  setenv("TF_ASYNC_CHECKPOINT_SAVE", "reference", 1);
+  EXPECT_EQ(GetAsyncSaveMode(), AsyncSaveMode::kReference);
+  setenv("TF_ASYNC_CHECKPOINT_SAVE", "copy", 1);
+  EXPECT_EQ(GetAsyncSaveMode(), AsyncSaveMode::kCopy);
+  setenv("TF_ASYNC_CHECKPOINT_SAVE", "sometimes", 1);
+  EXPECT_EQ(GetAsyncSaveMode(), AsyncSaveMode::kOff);
+  unsetenv("TF_ASYNC_CHECKPOINT_SAVE");
+}
+
+}  // namespace
+}  // namespace checkpoint
+}  // namespace tensorflow
@@ -303,6 +303,25 @@ BatchFunctionKernel::BatchFunctionKernel(OpKernelConstruction* c)
                                  &enable_large_batch_splitting_));
     has_attribute_enable_large_batch_splitting_ = true;
   }
+  if (c->HasAttr("sequence_length_buckets")) {
+    OP_REQUIRES_OK(c, c->GetAttr("sequence_length_buckets",
+                                 &sequence_length_buckets_));
+    OP_REQUIRES_OK(c, c->GetAttr("sequence_input_indices",
+                                 &sequence_input_indices_));
+    OP_REQUIRES_OK(c, c->GetAttr("sequence_output_indices",
+                                 &sequence_output_indices_));
+    OP_REQUIRES_OK(c, c->GetAttr("sequence_mask", &sequence_mask_));
+  }
+  if (c->HasAttr("max_func_batch_shards")) {
+    OP_REQUIRES_OK(c, c->GetAttr("max_func_batch_shards",
+                                 &max_func_batch_shards_));
+    OP_REQUIRES_OK(c, c->GetAttr("min_func_batch_shard_size",
+                                 &min_func_batch_shard_size_));
+    OP_REQUIRES(c, max_func_batch_shards_ > 0 && min_func_batch_shard_size_ > 0,
+                errors::InvalidArgument(
+                    "max_func_batch_shards and min_func_batch_shard_size must "
+                    "be positive"));
+  }
 
   // Helper function `SetAdaptiveBatchSchedulerOptions` calls
   // `OP_REQUIRES_OK`, which exits the current function upon error.
@@ -328,6 +347,7 @@ BatchFunctionKernel::BatchFunctionKernel(OpKernelConstruction* c)
   }
 
   OP_REQUIRES_OK(c, ValidateAllowedBatchSizes());
+  OP_REQUIRES_OK(c, ValidateSequenceLengthBuckets());
 }
 
 bool BatchFunctionKernel::IsExpensive() { return false; }
@@ -410,6 +430,11 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
       if (session_metadata) {
         new_resource->set_session_metadata(*session_metadata);
       }
+      new_resource->set_sequence_length_bucketing(
+          {sequence_length_buckets_, sequence_input_indices_,
+           sequence_output_indices_, sequence_mask_});
+      new_resource->set_func_batch_sharding(
+          {max_func_batch_shards_, min_func_batch_shard_size_});
       *r = new_resource.release();
       return absl::OkStatus();
     };
@@ -427,6 +452,11 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
       if (session_metadata) {
         new_resource->set_session_metadata(*session_metadata);
       }
+      new_resource->set_sequence_length_bucketing(
+          {sequence_length_buckets_, sequence_input_indices_,
+           sequence_output_indices_, sequence_mask_});
+      new_resource->set_func_batch_sharding(
+          {max_func_batch_shards_, min_func_batch_shard_size_});
       *r = new_resource.release();
       return absl::OkStatus();
     };
@@ -557,6 +587,44 @@ Status BatchFunctionKernel::ValidateAllowedBatchSizes() const {
   return absl::OkStatus();
 }
 
+Status BatchFunctionKernel::ValidateSequenceLengthBuckets() const {
+  int32_t last_length = 0;
+  for (const int32_t length : sequence_length_buckets_) {
+    if (length <= last_length) {
+      return errors::InvalidArgument(
+          "sequence_length_buckets entries must be positive and monotonically "
+          "increasing");
+    }
+    last_length = length;
+  }
+  if (sequence_length_buckets_.empty()) {
+    if (!sequence_input_indices_.empty() ||
+        !sequence_output_indices_.empty() || sequence_mask_) {
+      return errors::InvalidArgument(
+          "sequence_input_indices, sequence_output_indices and sequence_mask "
+          "require sequence_length_buckets");
+    }
+    return absl::OkStatus();
+  }
+  if (sequence_input_indices_.empty()) {
+    return errors::InvalidArgument(
+        "sequence_length_buckets requires sequence_input_indices");
+  }
+  for (const int32_t index : sequence_input_indices_) {
+    if (index < 0) {
+      return errors::InvalidArgument(
+          "sequence_input_indices entries must be non-negative");
+    }
+  }
+  for (const int32_t index : sequence_output_indices_) {
+    if (index < 0) {
+      return errors::InvalidArgument(
+          "sequence_output_indices entries must be non-negative");
+    }
+  }
+  return absl::OkStatus();
+}
+
 // Initialize vars by reading from op-kernel-construction.
 // Vars
 // - enable_adaptive_batch_threads_
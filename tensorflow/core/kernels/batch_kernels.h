@@ -79,6 +79,11 @@ class BatchFunctionKernel : public AsyncOpKernel {
   // to `max_batch_size_`.
   Status ValidateAllowedBatchSizes() const;
 
+  // Validates 'sequence_length_buckets_' and the sequence inputs and outputs.
+  // The buckets must be positive and increase monotonically, and there must be
+  // sequence inputs if there are buckets.
+  Status ValidateSequenceLengthBuckets() const;
+
   // Creates the function handle if it isn't initialized yet; and re-use it
   // afterwards.
   Status GetOrCreateFunctionHandle(OpKernelContext* c,
@@ -109,6 +114,12 @@ class BatchFunctionKernel : public AsyncOpKernel {
   int32 low_priority_batch_timeout_micros_;
   int32 low_priority_max_enqueued_batches_;
   std::vector<int32> low_priority_allowed_batch_sizes_;
+  std::vector<int32> sequence_length_buckets_;
+  std::vector<int32> sequence_input_indices_;
+  std::vector<int32> sequence_output_indices_;
+  bool sequence_mask_ = false;
+  int32 max_func_batch_shards_ = 1;
+  int32 min_func_batch_shard_size_ = 32;
   NameAttrList func_;
   absl::optional<FunctionLibraryRuntime::Handle> fhandle_ TF_GUARDED_BY(mu_);
   bool enable_large_batch_splitting_ = false;
@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/framework/device_factory.h"
@@ -200,5 +201,247 @@ TEST_P(BatchFunctionKernelParallelWarmupTest, ParallelWarmup) {
 INSTANTIATE_TEST_SUITE_P(BatchFunctionKernelParallelWarmupTestSuite,
                          BatchFunctionKernelParallelWarmupTest,
                          ::testing::Bool());
+
+class BatchFunctionKernelShardingTest : public OpsTestBase {
+ protected:
+  // Init test fixture with a batch kernel whose function checks that each
+  // shard has two elements.
+  Status Init(const std::string &name) {
+    NameAttrList f;
+    f.set_name("BatchFunctionKernelShardingTestFunc");
+    FunctionDef func = FunctionDefHelper::Create(
+        // function_name
+        f.name(),
+        // in_def
+        {"x:int64"},
+        // out_def
+        {"o:int64"},
+        // attr_def
+        {},
+        // node_def
+        {{{"o"},
+          "EnsureShape",
+          {"x"},
+          {{"T", DataType::DT_INT64}, {"shape", TensorShape({2})}}}},
+        // ret_def
+        {{"o", "o:output"}});
+    TF_RETURN_IF_ERROR(flib_def_->AddFunctionDef(func));
+
+    pflr_ = std::make_unique<ProcessFunctionLibraryRuntime>(
+        device_mgr_.get(), Env::Default(), /*config=*/nullptr,
+        TF_GRAPH_DEF_VERSION, flib_def_.get(), OptimizerOptions(),
+        /*thread_pool=*/nullptr, /*parent=*/nullptr,
+        /*session_metadata=*/nullptr,
+        Rendezvous::Factory{[](const int64_t, const DeviceMgr *device_mgr,
+                               tsl::core::RefCountPtr<Rendezvous> *r) {
+          *r = tsl::core::RefCountPtr<Rendezvous>(
+              new IntraProcessRendezvous(device_mgr));
+          return absl::OkStatus();
+        }});
+
+    std::vector<NodeDefBuilder::NodeOut> inputs(
+        {NodeDefBuilder::NodeOut({"n1", 0, DataType::DT_INT64})});
+    TF_CHECK_OK(NodeDefBuilder(name, "BatchFunction")
+                    .Attr("max_batch_size", 8)
+                    .Attr("num_batch_threads", 1)
+                    .Attr("batch_timeout_micros", 1000)
+                    .Attr("max_enqueued_batches", 10)
+                    .Attr("enable_large_batch_splitting", true)
+                    .Attr("max_func_batch_shards", 4)
+                    .Attr("min_func_batch_shard_size", 2)
+                    .Attr("Tin", {DataType::DT_INT64})
+                    .Input(inputs)
+                    .Attr("Tcaptured", std::vector<DataType>{})
+                    .Input(std::vector<NodeDefBuilder::NodeOut>{})
+                    .Attr("Tout", std::vector<DataType>{DT_INT64})
+                    .Attr("f", f)
+                    .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(BatchFunctionKernelShardingTest, ConcatenatesShardsInOrder) {
+  TF_ASSERT_OK(Init("ConcatenatesShardsInOrder"));
+  AddInputFromList<int64_t>(TensorShape({8}), {1, 2, 3, 4, 5, 6, 7, 8});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0), test::AsTensor<int64_t>({1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+TEST_F(BatchFunctionKernelShardingTest, PropagatesShardErrors) {
+  TF_ASSERT_OK(Init("PropagatesShardErrors"));
+  // Five elements are cut into shards of 3 and 2 elements, and the function
+  // fails for the first one only.
+  AddInputFromList<int64_t>(TensorShape({5}), {1, 2, 3, 4, 5});
+  const Status status = RunOpKernel();
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+}
+
+class BatchFunctionKernelSequenceLengthTest : public OpsTestBase {
+ protected:
+  // Init test fixture with a batch kernel that batches by the sequence length
+  // buckets {2, 4, 8}. Its function returns the padded sequence input twice,
+  // once as a sequence output, and then the mask of the sequence.
+  Status Init(const std::string &name) {
+    NameAttrList f;
+    f.set_name("BatchFunctionKernelSequenceLengthTestFunc");
+    FunctionDef func = FunctionDefHelper::Create(
+        // function_name
+        f.name(),
+        // in_def
+        {"x:int64", "mask:int32"},
+        // out_def
+        {"trimmed:int64", "padded:int64", "o_mask:int32"},
+        // attr_def
+        {},
+        // node_def
+        {{{"x_copy"}, "Identity", {"x"}, {{"T", DataType::DT_INT64}}},
+         {{"mask_copy"}, "Identity", {"mask"}, {{"T", DataType::DT_INT32}}}},
+        // ret_def
+        {{"trimmed", "x_copy:output:0"},
+         {"padded", "x_copy:output:0"},
+         {"o_mask", "mask_copy:output:0"}});
+    TF_RETURN_IF_ERROR(flib_def_->AddFunctionDef(func));
+
+    pflr_ = std::make_unique<ProcessFunctionLibraryRuntime>(
+        device_mgr_.get(), Env::Default(), /*config=*/nullptr,
+        TF_GRAPH_DEF_VERSION, flib_def_.get(), OptimizerOptions(),
+        /*thread_pool=*/nullptr, /*parent=*/nullptr,
+        /*session_metadata=*/nullptr,
+        Rendezvous::Factory{[](const int64_t, const DeviceMgr *device_mgr,
+                               tsl::core::RefCountPtr<Rendezvous> *r) {
+          *r = tsl::core::RefCountPtr<Rendezvous>(
+              new IntraProcessRendezvous(device_mgr));
+          return absl::OkStatus();
+        }});
+
+    std::vector<NodeDefBuilder::NodeOut> inputs(
+        {NodeDefBuilder::NodeOut({"n1", 0, DataType::DT_INT64})});
+    TF_CHECK_OK(NodeDefBuilder(name, "BatchFunction")
+                    .Attr("max_batch_size", 8)
+                    .Attr("num_batch_threads", 1)
+                    .Attr("batch_timeout_micros", 1000)
+                    .Attr("max_enqueued_batches", 10)
+                    .Attr("sequence_length_buckets", {2, 4, 8})
+                    .Attr("sequence_input_indices", {0})
+                    .Attr("sequence_output_indices", {0})
+                    .Attr("sequence_mask", true)
+                    .Attr("Tin", {DataType::DT_INT64})
+                    .Input(inputs)
+                    .Attr("Tcaptured", std::vector<DataType>{})
+                    .Input(std::vector<NodeDefBuilder::NodeOut>{})
+                    .Attr("Tout", std::vector<DataType>{DT_INT64, DT_INT64,
+                                                        DT_INT32})
+                    .Attr("f", f)
+                    .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(BatchFunctionKernelSequenceLengthTest, PadsToBucketAndTrimsOutputs) {
+  TF_ASSERT_OK(Init("PadsToBucketAndTrimsOutputs"));
+  // A sequence length of 3 is padded to the bucket 4.
+  AddInputFromList<int64_t>(TensorShape({2, 3}), {1, 2, 3, 4, 5, 6});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>({1, 2, 3, 4, 5, 6}, TensorShape({2, 3})));
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(1), test::AsTensor<int64_t>({1, 2, 3, 0, 4, 5, 6, 0},
+                                             TensorShape({2, 4})));
+  test::ExpectTensorEqual<int32_t>(
+      *GetOutput(2), test::AsTensor<int32_t>({1, 1, 1, 0, 1, 1, 1, 0},
+                                             TensorShape({2, 4})));
+}
+
+TEST_F(BatchFunctionKernelSequenceLengthTest, KeepsLengthOfBucket) {
+  TF_ASSERT_OK(Init("KeepsLengthOfBucket"));
+  AddInputFromList<int64_t>(TensorShape({1, 2}), {1, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0), test::AsTensor<int64_t>({1, 2}, TensorShape({1, 2})));
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(1), test::AsTensor<int64_t>({1, 2}, TensorShape({1, 2})));
+  test::ExpectTensorEqual<int32_t>(
+      *GetOutput(2), test::AsTensor<int32_t>({1, 1}, TensorShape({1, 2})));
+}
+
+TEST_F(BatchFunctionKernelSequenceLengthTest, FailsBeyondLargestBucket) {
+  TF_ASSERT_OK(Init("FailsBeyondLargestBucket"));
+  AddInputFromList<int64_t>(TensorShape({1, 9}),
+                            {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  const Status status = RunOpKernel();
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(absl::StrContains(status.message(), "sequence length bucket"))
+      << status;
+}
+
+class BatchFunctionKernelPassThroughTest : public OpsTestBase {
+ protected:
+  // Init test fixture with a batch kernel whose function returns its input.
+  Status Init(const std::string &name) {
+    NameAttrList f;
+    f.set_name("BatchFunctionKernelPassThroughTestFunc");
+    FunctionDef func = FunctionDefHelper::Create(
+        // function_name
+        f.name(),
+        // in_def
+        {"x:int64"},
+        // out_def
+        {"o:int64"},
+        // attr_def
+        {},
+        // node_def
+        {{{"x_copy"}, "Identity", {"x"}, {{"T", DataType::DT_INT64}}}},
+        // ret_def
+        {{"o", "x_copy:output:0"}});
+    TF_RETURN_IF_ERROR(flib_def_->AddFunctionDef(func));
+
+    pflr_ = std::make_unique<ProcessFunctionLibraryRuntime>(
+        device_mgr_.get(), Env::Default(), /*config=*/nullptr,
+        TF_GRAPH_DEF_VERSION, flib_def_.get(), OptimizerOptions(),
+        /*thread_pool=*/nullptr, /*parent=*/nullptr,
+        /*session_metadata=*/nullptr,
+        Rendezvous::Factory{[](const int64_t, const DeviceMgr *device_mgr,
+                               tsl::core::RefCountPtr<Rendezvous> *r) {
+          *r = tsl::core::RefCountPtr<Rendezvous>(
+              new IntraProcessRendezvous(device_mgr));
+          return absl::OkStatus();
+        }});
+
+    std::vector<NodeDefBuilder::NodeOut> inputs(
+        {NodeDefBuilder::NodeOut({"n1", 0, DataType::DT_INT64})});
+    TF_CHECK_OK(NodeDefBuilder(name, "BatchFunction")
+                    .Attr("max_batch_size", 8)
+                    .Attr("num_batch_threads", 1)
+                    .Attr("batch_timeout_micros", 1000)
+                    .Attr("max_enqueued_batches", 10)
+                    .Attr("Tin", {DataType::DT_INT64})
+                    .Input(inputs)
+                    .Attr("Tcaptured", std::vector<DataType>{})
+                    .Input(std::vector<NodeDefBuilder::NodeOut>{})
+                    .Attr("Tout", std::vector<DataType>{DT_INT64})
+                    .Attr("f", f)
+                    .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(BatchFunctionKernelPassThroughTest, SingleUnpaddedTaskIsNotCopied) {
+  TF_ASSERT_OK(Init("SingleUnpaddedTaskIsNotCopied"));
+  AddInputFromList<int64_t>(TensorShape({4}), {1, 2, 3, 4});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Neither the batched input nor the split output is a copy.
+  test::ExpectTensorEqual<int64_t>(*GetOutput(0),
+                                   test::AsTensor<int64_t>({1, 2, 3, 4}));
+  EXPECT_TRUE(GetOutput(0)->SharesBufferWith(GetInput(0)));
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -18,10 +18,13 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <random>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/types/optional.h"
@@ -74,6 +77,14 @@ class ASBSQueue;
 // CPU utilization - If the batch processing is cpu dominated, you can reap
 //   latency gains when underutilized by increasing the processing rate, but
 //   back the rate off when the load increases to avoid overload.
+//
+// When many models share one device, age-based prioritization lets a heavily
+// loaded model crowd out the others. With `weighted_fair_scheduling`, ASBS
+// instead picks the next batch by deficit round-robin over the queues: each
+// queue with schedulable batches earns credit, in batch elements, in proportion
+// to its weight (or its minimum share, if that is larger), and the next batch
+// comes from the first queue, in round-robin order, that can pay for its
+// oldest batch.
 
 template <typename TaskType>
 class AdaptiveSharedBatchScheduler
@@ -132,6 +143,19 @@ class AdaptiveSharedBatchScheduler
     // full_batch_scheduling_boost_micros==zero) for backward compatibility of
     // API.
     bool fifo_scheduling = false;
+
+    // If true, schedule batches using deficit round-robin over the queues,
+    // weighted by `QueueOptions::weight` and `QueueOptions::min_share` (see
+    // above). Within a queue, batches are scheduled oldest first.
+    // Requires that `fifo_scheduling` is false and that
+    // `full_batch_scheduling_boost_micros` is zero.
+    bool weighted_fair_scheduling = false;
+
+    // If positive, the maximum number of batches, including early scheduled
+    // full batches, processed concurrently. Together with a `thread_pool`
+    // shared by the schedulers of several devices, this caps the number of
+    // batches in flight on each device.
+    int64_t max_concurrent_batches = 0;
   };
 
   // Ownership is shared between the caller of Create() and any queues created
@@ -171,6 +195,15 @@ class AdaptiveSharedBatchScheduler
 
     // If true, the padding will not be appended.
     bool disable_padding = false;
+
+    // Only used with `Options::weighted_fair_scheduling`. Relative share of
+    // the processed batch elements among the queues with schedulable batches.
+    double weight = 1.0;
+    // Only used with `Options::weighted_fair_scheduling`. Fraction of the
+    // processed batch elements guaranteed to this queue while it has
+    // schedulable batches, whatever the weights of the other queues. The
+    // minimum shares of all queues of a scheduler must not exceed 1 in total.
+    double min_share = 0.0;
   };
 
   using BatchProcessor = std::function<void(std::unique_ptr<Batch<TaskType>>)>;
@@ -201,6 +234,9 @@ class AdaptiveSharedBatchScheduler
   // Schedules batch using FIFO policy if in_flight_batches_limit_ is not met.
   void MaybeScheduleNextBatchFIFO() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Schedules the next batch according to `weighted_fair_scheduling`.
+  void MaybeScheduleNextBatchWeightedFair() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Schedules all closed batches in batches_ for which an idle thread is
   // available in batch_thread_pool_.
   // Batches scheduled this way are called express batches.
@@ -214,6 +250,13 @@ class AdaptiveSharedBatchScheduler
 
   void MaybeAdjustInflightLimit() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Number of closed batches which may be scheduled as express batches.
+  int64_t NumExpressBatchSlots() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Charges a batch scheduled outside of deficit round-robin to its queue.
+  void ChargeWeightedFairDeficit(const internal::ASBSBatch<TaskType>* batch)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Notifies scheduler of non-empty batch which is eligible for processing.
   void AddBatch(const internal::ASBSBatch<TaskType>* batch);
 
@@ -237,6 +280,23 @@ class AdaptiveSharedBatchScheduler
   std::unordered_map<const internal::ASBSQueue<TaskType>*, BatchProcessor>
       queues_and_callbacks_ TF_GUARDED_BY(mu_);
 
+  // Deficit round-robin state of a queue.
+  struct WeightedFairQueue {
+    const internal::ASBSQueue<TaskType>* queue;
+    double weight;
+    double min_share;
+    // Batch elements the queue may still have processed before it has to wait
+    // for other queues. Negative if the queue had express batches processed.
+    double deficit = 0;
+  };
+
+  // Queues added by AddQueue, in the order they were added. Only maintained
+  // with `weighted_fair_scheduling`.
+  std::vector<WeightedFairQueue> weighted_fair_queues_ TF_GUARDED_BY(mu_);
+
+  // Index in weighted_fair_queues_ of the queue which was served last.
+  size_t weighted_fair_cursor_ TF_GUARDED_BY(mu_) = 0;
+
   mutex mu_;
 
   // Responsible for running the batch processing callbacks.
@@ -423,6 +483,18 @@ Status AdaptiveSharedBatchScheduler<TaskType>::Create(
         "greater than or equal to 1; was ",
         options.batches_to_average_over);
   }
+  if (options.weighted_fair_scheduling &&
+      (options.fifo_scheduling ||
+       options.full_batch_scheduling_boost_micros != 0)) {
+    return errors::InvalidArgument(
+        "weighted_fair_scheduling can't be combined with fifo_scheduling or "
+        "full_batch_scheduling_boost_micros");
+  }
+  if (options.max_concurrent_batches < 0) {
+    return errors::InvalidArgument(
+        "max_concurrent_batches can't be negative; was ",
+        options.max_concurrent_batches);
+  }
   scheduler->reset(new AdaptiveSharedBatchScheduler<TaskType>(options));
   return absl::OkStatus();
 }
@@ -467,11 +539,37 @@ Status AdaptiveSharedBatchScheduler<TaskType>::AddQueue(
           options.max_batch_size);
     }
   }
-  internal::ASBSQueue<TaskType>* asbs_queue_raw;
-  queue->reset(asbs_queue_raw = new internal::ASBSQueue<TaskType>(
-                   this->shared_from_this(), options));
-  mutex_lock l(mu_);
-  queues_and_callbacks_[asbs_queue_raw] = process_batch_callback;
+  if (options.weight <= 0) {
+    return errors::InvalidArgument("weight must be positive; was ",
+                                   options.weight);
+  }
+  if (options.min_share < 0 || options.min_share > 1) {
+    return errors::InvalidArgument("min_share must be in [0, 1]; was ",
+                                   options.min_share);
+  }
+  auto asbs_queue = std::make_unique<internal::ASBSQueue<TaskType>>(
+      this->shared_from_this(), options);
+  {
+    // Check the minimum shares and add the queue under one lock, so that
+    // concurrent calls can't exceed a total of 1. On error, `asbs_queue` is
+    // destroyed after `l` is released, as its destructor takes `mu_`.
+    mutex_lock l(mu_);
+    if (options_.weighted_fair_scheduling) {
+      double total_min_share = options.min_share;
+      for (const WeightedFairQueue& fair_queue : weighted_fair_queues_) {
+        total_min_share += fair_queue.min_share;
+      }
+      if (total_min_share > 1) {
+        return errors::InvalidArgument(
+            "The minimum shares of the queues add up to ", total_min_share,
+            ", which is more than 1");
+      }
+      weighted_fair_queues_.push_back(
+          {asbs_queue.get(), options.weight, options.min_share});
+    }
+    queues_and_callbacks_[asbs_queue.get()] = process_batch_callback;
+  }
+  *queue = std::move(asbs_queue);
   return absl::OkStatus();
 }
 
@@ -507,6 +605,16 @@ void AdaptiveSharedBatchScheduler<TaskType>::RemoveQueue(
     const internal::ASBSQueue<TaskType>* queue) {
   mutex_lock l(mu_);
   queues_and_callbacks_.erase(queue);
+  for (auto it = weighted_fair_queues_.begin();
+       it != weighted_fair_queues_.end(); ++it) {
+    if (it->queue == queue) {
+      weighted_fair_queues_.erase(it);
+      break;
+    }
+  }
+  if (weighted_fair_cursor_ >= weighted_fair_queues_.size()) {
+    weighted_fair_cursor_ = 0;
+  }
 }
 
 template <typename TaskType>
@@ -528,9 +636,7 @@ template <typename TaskType>
 void AdaptiveSharedBatchScheduler<
     TaskType>::MaybeScheduleClosedBatchesLockedFIFO() {
   // Only schedule closed batches if we have spare capacity.
-  int available_threads =
-      static_cast<int>(options_.num_batch_threads - in_flight_batches_ -
-                       in_flight_express_batches_);
+  int64_t available_threads = NumExpressBatchSlots();
   for (auto it = fifo_batches_.begin();
        it != fifo_batches_.end() && available_threads > 0;
        it = fifo_batches_.begin()) {
@@ -556,6 +662,11 @@ void AdaptiveSharedBatchScheduler<TaskType>::MaybeScheduleNextBatch() {
   bool batch_empty =
       options_.fifo_scheduling ? fifo_batches_.empty() : batches_.empty();
   if (batch_empty || in_flight_batches_ >= in_flight_batches_limit_) return;
+  if (options_.max_concurrent_batches > 0 &&
+      in_flight_batches_ + in_flight_express_batches_ >=
+          options_.max_concurrent_batches) {
+    return;
+  }
   // Non-integer limit handled probabilistically.
   if (in_flight_batches_limit_ - in_flight_batches_ < 1 &&
       rand_double_(rand_engine_) >
@@ -568,6 +679,11 @@ void AdaptiveSharedBatchScheduler<TaskType>::MaybeScheduleNextBatch() {
     return;
   }
 
+  if (options_.weighted_fair_scheduling) {
+    MaybeScheduleNextBatchWeightedFair();
+    return;
+  }
+
   auto best_it = batches_.end();
   double best_score = (std::numeric_limits<double>::max)();
   int64_t now_micros = GetEnv()->NowMicros();
@@ -594,6 +710,134 @@ void AdaptiveSharedBatchScheduler<TaskType>::MaybeScheduleNextBatch() {
   in_flight_batches_++;
 }
 
+template <typename TaskType>
+void AdaptiveSharedBatchScheduler<
+    TaskType>::MaybeScheduleNextBatchWeightedFair() {
+  const size_t num_queues = weighted_fair_queues_.size();
+  std::unordered_map<const internal::ASBSQueue<TaskType>*, size_t>
+      queue_indices;
+  for (size_t i = 0; i < num_queues; ++i) {
+    queue_indices[weighted_fair_queues_[i].queue] = i;
+  }
+  // Oldest schedulable batch of each queue.
+  std::vector<typename std::vector<
+      const internal::ASBSBatch<TaskType>*>::iterator>
+      heads(num_queues, batches_.end());
+  const int64_t now_micros = GetEnv()->NowMicros();
+  for (auto it = batches_.begin(); it != batches_.end(); ++it) {
+    if ((*it)->schedulable_time_micros() > now_micros) continue;
+    auto index_it = queue_indices.find((*it)->queue());
+    if (index_it == queue_indices.end()) continue;
+    if (heads[index_it->second] == batches_.end()) {
+      heads[index_it->second] = it;
+    }
+  }
+
+  // Queues without schedulable batches don't accumulate credit, so that an
+  // idle queue can't burst ahead of the others later.
+  double quantum = 0;
+  for (size_t i = 0; i < num_queues; ++i) {
+    if (heads[i] == batches_.end()) {
+      weighted_fair_queues_[i].deficit = 0;
+    } else {
+      quantum =
+          std::max<double>(quantum, (*heads[i])->queue()->max_task_size());
+    }
+  }
+  // No schedulable batches.
+  if (quantum == 0) return;
+
+  // Splits the processed batch elements by weight, except that the queues
+  // whose weighted share is below their minimum share get the minimum share.
+  std::vector<double> shares(num_queues, 0);
+  std::vector<bool> guaranteed(num_queues, false);
+  for (bool changed = true; changed;) {
+    changed = false;
+    double free_share = 1;
+    double free_weight = 0;
+    for (size_t i = 0; i < num_queues; ++i) {
+      if (heads[i] == batches_.end()) continue;
+      if (guaranteed[i]) {
+        free_share -= weighted_fair_queues_[i].min_share;
+      } else {
+        free_weight += weighted_fair_queues_[i].weight;
+      }
+    }
+    for (size_t i = 0; i < num_queues; ++i) {
+      if (heads[i] == batches_.end()) continue;
+      const WeightedFairQueue& fair_queue = weighted_fair_queues_[i];
+      if (guaranteed[i]) {
+        shares[i] = fair_queue.min_share;
+        continue;
+      }
+      shares[i] = free_share * fair_queue.weight / free_weight;
+      if (shares[i] < fair_queue.min_share) {
+        guaranteed[i] = true;
+        changed = true;
+      }
+    }
+  }
+
+  // Serves the first queue, starting with the one served last, that can pay
+  // for its oldest batch. If there is none, grants all queues with schedulable
+  // batches as many rounds of credit as the first of them needs to pay.
+  size_t next = num_queues;
+  double min_rounds = (std::numeric_limits<double>::max)();
+  for (size_t k = 0; k < num_queues; ++k) {
+    const size_t i = (weighted_fair_cursor_ + k) % num_queues;
+    if (heads[i] == batches_.end()) continue;
+    const double cost = (*heads[i])->size();
+    const double rounds =
+        std::max(0.0, std::ceil((cost - weighted_fair_queues_[i].deficit) /
+                                (shares[i] * quantum)));
+    if (rounds < min_rounds) {
+      min_rounds = rounds;
+      next = i;
+      if (rounds == 0) break;
+    }
+  }
+  if (min_rounds > 0) {
+    for (size_t i = 0; i < num_queues; ++i) {
+      if (heads[i] == batches_.end()) continue;
+      weighted_fair_queues_[i].deficit += min_rounds * shares[i] * quantum;
+    }
+  }
+
+  const internal::ASBSBatch<TaskType>* batch = *heads[next];
+  weighted_fair_queues_[next].deficit -= batch->size();
+  weighted_fair_cursor_ = next;
+  batches_.erase(heads[next]);
+  // Queue may destroy itself after ReleaseBatch is called.
+  batch->queue()->ReleaseBatch(batch);
+  batch_thread_pool_->Schedule(
+      std::bind(&AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper, this,
+                batch, queues_and_callbacks_[batch->queue()], false));
+  in_flight_batches_++;
+}
+
+template <typename TaskType>
+int64_t AdaptiveSharedBatchScheduler<TaskType>::NumExpressBatchSlots() const {
+  int64_t num_slots = options_.num_batch_threads - in_flight_batches_ -
+                      in_flight_express_batches_;
+  if (options_.max_concurrent_batches > 0) {
+    num_slots = std::min(num_slots, options_.max_concurrent_batches -
+                                        in_flight_batches_ -
+                                        in_flight_express_batches_);
+  }
+  return num_slots;
+}
+
+template <typename TaskType>
+void AdaptiveSharedBatchScheduler<TaskType>::ChargeWeightedFairDeficit(
+    const internal::ASBSBatch<TaskType>* batch) {
+  for (WeightedFairQueue& fair_queue : weighted_fair_queues_) {
+    if (fair_queue.queue == batch->queue()) {
+      fair_queue.deficit -= batch->size();
+      return;
+    }
+  }
+}
+
 template <typename TaskType>
 void AdaptiveSharedBatchScheduler<TaskType>::MaybeScheduleClosedBatches() {
   mutex_lock l(mu_);
@@ -608,14 +852,13 @@ void AdaptiveSharedBatchScheduler<
     return;
   }
   // Only schedule closed batches if we have spare capacity.
-  int available_threads =
-      static_cast<int>(options_.num_batch_threads - in_flight_batches_ -
-                       in_flight_express_batches_);
+  int64_t available_threads = NumExpressBatchSlots();
   for (auto it = batches_.begin();
        it != batches_.end() && available_threads > 0;) {
     if ((*it)->IsClosed()) {
       const internal::ASBSBatch<TaskType>* batch = *it;
       it = batches_.erase(it);
+      ChargeWeightedFairDeficit(batch);
       batch->queue()->ReleaseBatch(batch);
       batch_thread_pool_->Schedule(
           std::bind(&AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper,
@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/batching_util/adaptive_shared_batch_scheduler.h"
 
+#include <algorithm>
+#include <vector>
+
+#include <gmock/gmock.h>
 #include "tensorflow/core/kernels/batching_util/fake_clock_env.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -517,6 +521,143 @@ TEST(AdaptiveSharedBatchSchedulerTest, MaxTasksPerBatch) {
     if (processed_batches == 3) break;
   }
 }
+
+// Schedules a blocking batch to the first queue, then `num_batches` full
+// batches to each of two queues, and returns the indices of the queues in the
+// order the latter batches were processed.
+std::vector<int> ProcessWeightedFairBatches(
+    const AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions& queue_options1,
+    const AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions& queue_options2,
+    int num_batches) {
+  AdaptiveSharedBatchScheduler<FakeTask>::Options options;
+  options.initial_in_flight_batches_limit = 1;
+  options.num_batch_threads = 1;
+  options.weighted_fair_scheduling = true;
+  mutex mu;
+  std::vector<int> processed_queues;
+  Notification finish_processing;
+  auto queue_callback = [&](int queue_index) {
+    return [&, queue_index](std::unique_ptr<Batch<FakeTask>> batch) {
+      finish_processing.WaitForNotification();
+      mutex_lock l(mu);
+      processed_queues.push_back(queue_index);
+    };
+  };
+  std::shared_ptr<AdaptiveSharedBatchScheduler<FakeTask>> scheduler;
+  TF_CHECK_OK(
+      AdaptiveSharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+  std::unique_ptr<BatchScheduler<FakeTask>> queue1;
+  std::unique_ptr<BatchScheduler<FakeTask>> queue2;
+  TF_CHECK_OK(scheduler->AddQueue(queue_options1, queue_callback(1), &queue1));
+  TF_CHECK_OK(scheduler->AddQueue(queue_options2, queue_callback(2), &queue2));
+
+  TF_CHECK_OK(ScheduleTask(queue_options1.max_batch_size, queue1.get()));
+  for (int i = 0; i < num_batches; ++i) {
+    TF_CHECK_OK(ScheduleTask(queue_options1.max_batch_size, queue1.get()));
+  }
+  for (int i = 0; i < num_batches; ++i) {
+    TF_CHECK_OK(ScheduleTask(queue_options2.max_batch_size, queue2.get()));
+  }
+  finish_processing.Notify();
+  while (true) {
+    mutex_lock l(mu);
+    if (processed_queues.size() == 2 * num_batches + 1) break;
+  }
+  processed_queues.erase(processed_queues.begin());
+  return processed_queues;
+}
+
+TEST(AdaptiveSharedBatchSchedulerTest, WeightedFairScheduling) {
+  AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options1;
+  queue_options1.max_batch_size = 10;
+  queue_options1.weight = 3;
+  AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options2;
+  queue_options2.max_batch_size = 10;
+  queue_options2.weight = 1;
+  // While both queues have batches, the first queue gets three quarters of
+  // the processed batches.
+  EXPECT_THAT(ProcessWeightedFairBatches(queue_options1, queue_options2, 4),
+              ::testing::ElementsAre(1, 1, 1, 2, 1, 2, 2, 2));
+}
+
+TEST(AdaptiveSharedBatchSchedulerTest, WeightedFairSchedulingMinShare) {
+  AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options1;
+  queue_options1.max_batch_size = 10;
+  queue_options1.weight = 3;
+  AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options2;
+  queue_options2.max_batch_size = 10;
+  queue_options2.weight = 1;
+  queue_options2.min_share = 0.5;
+  std::vector<int> processed_queues =
+      ProcessWeightedFairBatches(queue_options1, queue_options2, 4);
+  // While both queues have batches, each gets half of the processed batches.
+  EXPECT_EQ(std::count(processed_queues.begin(), processed_queues.begin() + 4,
+                       2),
+            2);
+}
+
+TEST(AdaptiveSharedBatchSchedulerTest, BadWeightedFairOptions) {
+  using Scheduler = AdaptiveSharedBatchScheduler<FakeTask>;
+  std::shared_ptr<Scheduler> scheduler;
+  Scheduler::Options options;
+  options.weighted_fair_scheduling = true;
+  options.fifo_scheduling = true;
+  EXPECT_FALSE(Scheduler::Create(options, &scheduler).ok());
+  options = Scheduler::Options();
+  options.max_concurrent_batches = -1;
+  EXPECT_FALSE(Scheduler::Create(options, &scheduler).ok());
+
+  options = Scheduler::Options();
+  options.weighted_fair_scheduling = true;
+  TF_ASSERT_OK(Scheduler::Create(options, &scheduler));
+  auto queue_callback = [](std::unique_ptr<Batch<FakeTask>> batch) {};
+  std::unique_ptr<BatchScheduler<FakeTask>> queue1;
+  std::unique_ptr<BatchScheduler<FakeTask>> queue2;
+  Scheduler::QueueOptions queue_options;
+  queue_options.weight = 0;
+  EXPECT_FALSE(
+      scheduler->AddQueue(queue_options, queue_callback, &queue1).ok());
+  queue_options = Scheduler::QueueOptions();
+  queue_options.min_share = 0.6;
+  TF_ASSERT_OK(scheduler->AddQueue(queue_options, queue_callback, &queue1));
+  // The minimum shares would add up to more than 1.
+  EXPECT_FALSE(
+      scheduler->AddQueue(queue_options, queue_callback, &queue2).ok());
+}
+
+TEST(AdaptiveSharedBatchSchedulerTest, MaxConcurrentBatches) {
+  AdaptiveSharedBatchScheduler<FakeTask>::Options options;
+  options.num_batch_threads = 4;
+  options.initial_in_flight_batches_limit = 4;
+  options.max_concurrent_batches = 1;
+  mutex mu;
+  int in_flight_batches = 0;
+  int processed_batches = 0;
+  auto queue_callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+    {
+      mutex_lock l(mu);
+      EXPECT_EQ(++in_flight_batches, 1);
+    }
+    Env::Default()->SleepForMicroseconds(1000);
+    mutex_lock l(mu);
+    --in_flight_batches;
+    ++processed_batches;
+  };
+  std::shared_ptr<AdaptiveSharedBatchScheduler<FakeTask>> scheduler;
+  TF_ASSERT_OK(
+      AdaptiveSharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+  AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+  queue_options.max_batch_size = 10;
+  std::unique_ptr<BatchScheduler<FakeTask>> queue;
+  TF_ASSERT_OK(scheduler->AddQueue(queue_options, queue_callback, &queue));
+  for (int i = 0; i < 4; ++i) {
+    TF_ASSERT_OK(ScheduleTask(10, queue.get()));
+  }
+  while (true) {
+    mutex_lock l(mu);
+    if (processed_batches == 4) break;
+  }
+}
 }  // namespace anonymous
 }  // namespace serving
 }  // namespace tensorflow
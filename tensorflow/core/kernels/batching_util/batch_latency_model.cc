@@ -0,0 +1,77 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_latency_model.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// Weight of the newest measurement in the moving average.
+constexpr double kNewMeasurementWeight = 0.2;
+
+}  // namespace
+
+BatchLatencyModel::BatchLatencyModel(int64_t max_batch_size)
+    : latency_micros_(std::max<int64_t>(max_batch_size, 1) + 1, -1.0) {}
+
+int64_t BatchLatencyModel::ClampBatchSize(int64_t batch_size) const {
+  return std::clamp<int64_t>(batch_size, 1, latency_micros_.size() - 1);
+}
+
+void BatchLatencyModel::Record(int64_t batch_size, int64_t latency_micros) {
+  double& latency = latency_micros_[ClampBatchSize(batch_size)];
+  if (latency < 0) {
+    latency = latency_micros;
+  } else {
+    latency += kNewMeasurementWeight * (latency_micros - latency);
+  }
+  empty_ = false;
+}
+
+std::optional<int64_t> BatchLatencyModel::PredictMicros(
+    int64_t batch_size) const {
+  if (empty_) {
+    return std::nullopt;
+  }
+  const int64_t size = ClampBatchSize(batch_size);
+  if (latency_micros_[size] >= 0) {
+    return static_cast<int64_t>(latency_micros_[size]);
+  }
+  int64_t lower = size - 1;
+  while (lower > 0 && latency_micros_[lower] < 0) --lower;
+  int64_t upper = size + 1;
+  while (upper < latency_micros_.size() && latency_micros_[upper] < 0) ++upper;
+  if (upper == latency_micros_.size()) {
+    // `lower` is observed since the model is not empty.
+    return static_cast<int64_t>(latency_micros_[lower] * size / lower);
+  }
+  if (lower == 0) {
+    // Batches are assumed to be at least as fast as larger batches.
+    return static_cast<int64_t>(latency_micros_[upper]);
+  }
+  const double weight = static_cast<double>(size - lower) / (upper - lower);
+  return static_cast<int64_t>(latency_micros_[lower] +
+                              weight *
+                                  (latency_micros_[upper] -
+                                   latency_micros_[lower]));
+}
+
+}  // namespace serving
+}  // namespace tensorflow
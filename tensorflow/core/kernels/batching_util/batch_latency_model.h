@@ -0,0 +1,60 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_LATENCY_MODEL_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_LATENCY_MODEL_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace tensorflow {
+namespace serving {
+
+// Predicts the time to process a batch from its size, based on the measured
+// processing times of earlier batches.
+//
+// The latency of each observed batch size is a moving average of its recent
+// measurements. The latency of an unobserved size is interpolated linearly
+// between the nearest observed sizes, or extrapolated proportionally to the
+// batch size from the largest observed size below it.
+//
+// Not thread-safe.
+class BatchLatencyModel {
+ public:
+  // Batch sizes above `max_batch_size` are recorded and predicted as
+  // `max_batch_size`.
+  explicit BatchLatencyModel(int64_t max_batch_size);
+
+  // Records that a batch of `batch_size` took `latency_micros` to process.
+  void Record(int64_t batch_size, int64_t latency_micros);
+
+  // Returns the predicted time to process a batch of `batch_size`, or nullopt
+  // if no batch has been recorded yet.
+  std::optional<int64_t> PredictMicros(int64_t batch_size) const;
+
+ private:
+  int64_t ClampBatchSize(int64_t batch_size) const;
+
+  // Moving average latency of each batch size, indexed by batch size. Negative
+  // for sizes that have not been observed.
+  std::vector<double> latency_micros_;
+  bool empty_ = true;
+};
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_LATENCY_MODEL_H_
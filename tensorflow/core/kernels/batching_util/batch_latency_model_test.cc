@@ -0,0 +1,68 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_latency_model.h"
+
+#include <optional>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+TEST(BatchLatencyModelTest, NoPredictionBeforeFirstRecord) {
+  BatchLatencyModel model(/*max_batch_size=*/8);
+  EXPECT_EQ(model.PredictMicros(4), std::nullopt);
+}
+
+TEST(BatchLatencyModelTest, PredictsRecordedLatency) {
+  BatchLatencyModel model(/*max_batch_size=*/8);
+  model.Record(4, 100);
+  EXPECT_EQ(model.PredictMicros(4), 100);
+}
+
+TEST(BatchLatencyModelTest, AveragesRecentMeasurements) {
+  BatchLatencyModel model(/*max_batch_size=*/8);
+  model.Record(4, 100);
+  model.Record(4, 200);
+  EXPECT_EQ(model.PredictMicros(4), 120);
+}
+
+TEST(BatchLatencyModelTest, InterpolatesBetweenObservedSizes) {
+  BatchLatencyModel model(/*max_batch_size=*/8);
+  model.Record(2, 100);
+  model.Record(6, 300);
+  EXPECT_EQ(model.PredictMicros(3), 150);
+  EXPECT_EQ(model.PredictMicros(5), 250);
+}
+
+TEST(BatchLatencyModelTest, ExtrapolatesAboveLargestObservedSize) {
+  BatchLatencyModel model(/*max_batch_size=*/8);
+  model.Record(2, 100);
+  EXPECT_EQ(model.PredictMicros(4), 200);
+  // Sizes above the maximum are predicted as the maximum.
+  EXPECT_EQ(model.PredictMicros(100), 400);
+}
+
+TEST(BatchLatencyModelTest, PredictsSmallerSizesFromSmallestObservedSize) {
+  BatchLatencyModel model(/*max_batch_size=*/8);
+  model.Record(4, 100);
+  EXPECT_EQ(model.PredictMicros(1), 100);
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -27,6 +28,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/match.h"
@@ -61,13 +63,16 @@ limitations under the License.
 #include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/monitoring/types.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/incremental_barrier.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
@@ -76,6 +81,18 @@ namespace tensorflow {
 namespace serving {
 namespace {
 
+// Returns whether batches are scheduled by the deadlines of their requests; see
+// `QueueOptions::enable_deadline_aware_batching`.
+bool EnableDeadlineAwareBatching() {
+  static const bool enabled = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_BATCHING_ENABLE_DEADLINE_AWARE_BATCHING",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return enabled;
+}
+
 // TODO(b/181883417): Replace with RecordPaddingSizeV2.
 void RecordPaddingSize(int32_t padding_size, const string& model_name,
                        int32_t execution_batch_size, const string& op_name) {
@@ -118,6 +135,19 @@ void RecordPaddingSizeV2(int32_t padding_size, const string& model_name,
       ->Add(static_cast<double>(padding_size));
 }
 
+void RecordSequencePaddingFraction(double padding_fraction,
+                                   const string& model_name,
+                                   const string& op_name) {
+  static auto* cell = tensorflow::monitoring::Sampler<2>::New(
+      {"/tensorflow/serving/batching/sequence_padding_fraction",
+       "Tracks the fraction of the sequence length of inputs that is padding "
+       "when batching by sequence length, by model_name (if available).",
+       "model_name", "op_name"},
+      monitoring::Buckets::Explicit(
+          {0.0, 0.05, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9}));
+  cell->GetCell(model_name, op_name)->Add(padding_fraction);
+}
+
 // TODO(b/181883417): Replace with RecordInputBatchSizeV2.
 void RecordInputBatchSize(int32_t batch_size, const string& model_name,
                           const string& op_name) {
@@ -272,6 +302,53 @@ const string& GetModelName(OpKernelContext* ctx) {
   return ctx->session_metadata()->name();
 }
 
+// Copies `input` into `output` with dimension 1 resized to `length`, dropping
+// the positions of `input` past `length` and filling the positions past the
+// length of `input` with zeros or empty strings.
+Status ResizeSequenceDimension(OpKernelContext* context, const Tensor& input,
+                               int64_t length, Tensor* output) {
+  TensorShape shape = input.shape();
+  const int64_t input_length = shape.dim_size(1);
+  shape.set_dim(1, length);
+  AllocatorAttributes attr;
+  attr.set_on_host(true);
+  TF_RETURN_IF_ERROR(
+      context->allocate_temp(input.dtype(), shape, output, attr));
+
+  int64_t inner_size = 1;
+  for (int i = 2; i < input.dims(); ++i) {
+    inner_size *= input.dim_size(i);
+  }
+  const int64_t num_rows = input.dim_size(0);
+  const int64_t input_row_size = input_length * inner_size;
+  const int64_t output_row_size = length * inner_size;
+  const int64_t copied_size = std::min(input_length, length) * inner_size;
+  if (DataTypeCanUseMemcpy(input.dtype())) {
+    const int64_t element_size = DataTypeSize(input.dtype());
+    const char* from = input.tensor_data().data();
+    char* to = const_cast<char*>(output->tensor_data().data());
+    memset(to, 0, output->tensor_data().size());
+    for (int64_t row = 0; row < num_rows; ++row) {
+      memcpy(to + row * output_row_size * element_size,
+             from + row * input_row_size * element_size,
+             copied_size * element_size);
+    }
+  } else if (input.dtype() == DT_STRING) {
+    const auto from = input.flat<tstring>();
+    auto to = output->flat<tstring>();
+    for (int64_t row = 0; row < num_rows; ++row) {
+      for (int64_t i = 0; i < copied_size; ++i) {
+        to(row * output_row_size + i) = from(row * input_row_size + i);
+      }
+    }
+  } else {
+    return errors::InvalidArgument("Cannot batch sequences of type ",
+                                   DataTypeString(input.dtype()),
+                                   " by sequence length.");
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 std::unique_ptr<BatchResourceBase::BatchTask>
@@ -290,6 +367,9 @@ BatchResourceBase::BatchTask::CreateSplitTask(
   task->status = this->status;
   task->is_partial = true;
   task->start_time = this->start_time;
+  task->deadline_micros = this->deadline_micros;
+  task->unpadded_sequence_length = this->unpadded_sequence_length;
+  task->padded_sequence_length = this->padded_sequence_length;
   task->request_cost = this->request_cost;
   task->forced_warmup_batch_size = this->forced_warmup_batch_size;
 
@@ -354,6 +434,10 @@ Status BatchResourceBase::RegisterInput(
   TF_ASSIGN_OR_RETURN(std::unique_ptr<BatchTask> batch_components,
                       create_batch_task_fn());
   batch_components->start_time = EnvTime::NowNanos();
+  if (context->deadline().has_value()) {
+    batch_components->deadline_micros =
+        absl::ToUnixMicros(*context->deadline());
+  }
   batch_components->guid = guid;
   batch_components->propagated_context = Context(ContextKind::kThread);
 
@@ -459,9 +543,18 @@ Status BatchResourceBase::RegisterInput(
     batch_components->request_cost = request_cost_accessor->GetRequestCost();
   }
 
+  string queue_name = batcher_queue_name;
+  if (!sequence_length_bucketing_.buckets.empty()) {
+    TF_RETURN_IF_ERROR(
+        PadToSequenceLengthBucket(context, batch_components.get()));
+    if (batch_components->padded_sequence_length >= 0) {
+      queue_name = absl::StrCat(batcher_queue_name, "/sequence_length_",
+                                batch_components->padded_sequence_length);
+    }
+  }
+
   BatcherQueueT* batcher_queue;
-  TF_RETURN_IF_ERROR(
-      LookupOrCreateBatcherQueue(batcher_queue_name, &batcher_queue));
+  TF_RETURN_IF_ERROR(LookupOrCreateBatcherQueue(queue_name, &batcher_queue));
 
   if (!session_metadata().name().empty()) {
     absl::MutexLock lock(&outstanding_batch_mu_);
@@ -479,6 +572,63 @@ Status BatchResourceBase::RegisterInput(
   return batcher_queue->Schedule(&batch_components);
 }
 
+Status BatchResourceBase::PadToSequenceLengthBucket(OpKernelContext* context,
+                                                    BatchTask* task) const {
+  const std::vector<int32>& buckets = sequence_length_bucketing_.buckets;
+  int64_t length = 0;
+  for (const int32 index : sequence_length_bucketing_.input_indices) {
+    if (static_cast<size_t>(index) >= task->inputs.size()) {
+      return errors::InvalidArgument("Sequence input index ", index,
+                                     " is out of range for ",
+                                     task->inputs.size(), " batched inputs.");
+    }
+    const Tensor& input = task->inputs[index];
+    if (input.dims() < 2) {
+      return errors::InvalidArgument(
+          "Sequence input ", index, " must have at least two dimensions, got ",
+          input.shape().DebugString());
+    }
+    length = std::max(length, input.dim_size(1));
+  }
+  auto bucket = std::lower_bound(buckets.begin(), buckets.end(), length);
+  if (bucket == buckets.end()) {
+    return errors::InvalidArgument(
+        "Sequence length ", length,
+        " of the batching inputs exceeds the largest sequence length bucket ",
+        buckets.back(), ".");
+  }
+  for (const int32 index : sequence_length_bucketing_.input_indices) {
+    Tensor& input = task->inputs[index];
+    if (input.dim_size(1) != *bucket) {
+      Tensor padded;
+      TF_RETURN_IF_ERROR(
+          ResizeSequenceDimension(context, input, *bucket, &padded));
+      input = std::move(padded);
+    }
+  }
+  if (sequence_length_bucketing_.append_mask) {
+    const int64_t batch_size = task->inputs[0].dim_size(0);
+    AllocatorAttributes attr;
+    attr.set_on_host(true);
+    Tensor mask;
+    TF_RETURN_IF_ERROR(context->allocate_temp(
+        DT_INT32, TensorShape({batch_size, *bucket}), &mask, attr));
+    auto mask_matrix = mask.matrix<int32>();
+    for (int64_t row = 0; row < batch_size; ++row) {
+      for (int64_t i = 0; i < *bucket; ++i) {
+        mask_matrix(row, i) = i < length ? 1 : 0;
+      }
+    }
+    task->inputs.push_back(std::move(mask));
+  }
+  task->unpadded_sequence_length = length;
+  task->padded_sequence_length = *bucket;
+  RecordSequencePaddingFraction(
+      static_cast<double>(*bucket - length) / *bucket, GetModelName(context),
+      context->op_kernel().name());
+  return absl::OkStatus();
+}
+
 /*static*/ BatchResourceBase::BatcherT::QueueOptions
 BatchResourceBase::GetBatcherQueueOptions(
     int32_t num_batch_threads, int32_t max_batch_size,
@@ -555,6 +705,11 @@ BatchResourceBase::GetBatcherQueueOptions(
     }
   }
   batcher_queue_options.disable_padding = disable_padding;
+  if (EnableDeadlineAwareBatching()) {
+    batcher_queue_options.enable_deadline_aware_batching = true;
+    batcher_queue_options.get_task_deadline_micros =
+        [](const BatchTask& task) { return task.deadline_micros; };
+  }
 
   return batcher_queue_options;
 }
@@ -691,6 +846,12 @@ Status BatchResourceBase::ConcatInputTensors(
       }
     }
 
+    // A single task without padding is passed through without a copy.
+    if (to_concatenate.size() == 1) {
+      concatenated_tensors->push_back(std::move(to_concatenate[0]));
+      continue;
+    }
+
     Tensor concatenated_tensor;
     Status concat_status =
         Concat(context, to_concatenate, &concatenated_tensor);
@@ -797,6 +958,23 @@ Status BatchResourceBase::ConcatInputTensors(
   return absl::OkStatus();
 }
 
+/*static*/ Status BatchResourceBase::SplitWithoutCopy(
+    const Tensor& tensor, const std::vector<int64_t>& sizes,
+    std::vector<Tensor>* splits) {
+  splits->reserve(sizes.size());
+  int64_t position = 0;
+  for (const int64_t size : sizes) {
+    Tensor split = tensor.Slice(position, position + size);
+    if (!split.IsAligned()) {
+      splits->clear();
+      return tensor::Split(tensor, sizes, splits);
+    }
+    splits->push_back(std::move(split));
+    position += size;
+  }
+  return absl::OkStatus();
+}
+
 Status BatchResourceBase::SplitOutputTensors(
     const std::vector<Tensor>& combined_outputs, BatchT* batch) const {
   DCHECK_GE(batch->num_tasks(), 1);
@@ -828,6 +1006,8 @@ Status BatchResourceBase::SplitOutputTensors(
   // within the batch, and use this to populate context outputs.
   for (int i = 0, iter_limit = combined_outputs.size(); i < iter_limit; ++i) {
     const Tensor& output_tensor = combined_outputs[i];
+    const bool is_sequence_output =
+        absl::c_linear_search(sequence_length_bucketing_.output_indices, i);
     if (output_tensor.shape().dims() == 0) {
       return errors::FailedPrecondition(
           "Batched output tensor has 0 dimensions");
@@ -840,7 +1020,7 @@ Status BatchResourceBase::SplitOutputTensors(
     }
 
     std::vector<Tensor> split_tensor;
-    const Status split_status = tensor::Split(
+    const Status split_status = SplitWithoutCopy(
         output_tensor, task_sizes_plus_optional_padding, &split_tensor);
     DCHECK(split_status.ok()) << split_status;
     if (!split_status.ok()) {
@@ -858,6 +1038,22 @@ Status BatchResourceBase::SplitOutputTensors(
     // Ignore a possible final split_tensors entry containing the padding.
     for (int j = 0; j < batch->num_tasks(); ++j) {
       BatchTask& task = *(batch->mutable_task(j));
+      // Sequence outputs are trimmed to the original length.
+      if (is_sequence_output &&
+          task.padded_sequence_length > task.unpadded_sequence_length) {
+        if (split_tensor[j].dims() < 2 ||
+            split_tensor[j].dim_size(1) != task.padded_sequence_length) {
+          return errors::InvalidArgument(
+              "Sequence output ", i, " must have dimension 1 equal to the "
+              "sequence length bucket ", task.padded_sequence_length,
+              ", got shape ", split_tensor[j].shape().DebugString());
+        }
+        Tensor trimmed;
+        TF_RETURN_IF_ERROR(ResizeSequenceDimension(
+            task.context, split_tensor[j], task.unpadded_sequence_length,
+            &trimmed));
+        split_tensor[j] = std::move(trimmed);
+      }
       if (task.is_partial) {
         std::vector<Tensor>& tensor_vector = (*task.output)[task.split_index];
         tensor_vector[i] = std::move(split_tensor[j]);
@@ -945,6 +1141,7 @@ void BatchResourceBase::ProcessFuncBatch(std::unique_ptr<BatchT> batch) const {
   args.insert(args.end(), captured_inputs.begin(), captured_inputs.end());
 
   uint64 current_time = EnvTime::NowNanos();
+  RecordBatchingWaitCosts(current_time, *batch);
   for (int i = 0; i < batch->num_tasks(); ++i) {
     RecordBatchDelayUs((current_time - batch->task(i).start_time) * 1e-3,
                        model_name, last_task_context->op_kernel().name(),
@@ -956,26 +1153,141 @@ void BatchResourceBase::ProcessFuncBatch(std::unique_ptr<BatchT> batch) const {
   // Releases the cleanup method here, because the callback of the function
   // library runtime will handle it now.
   finally.release();
-  ProcessFuncBatchImpl(
-      last_task, args, &combined_outputs, [&](const Status& run_status) {
-        Status final_status;
-        auto run_finally = gtl::MakeCleanup([&]() {
-          // We do the cleanup here as an optimization, so that
-          // it runs in the underlying TF inter-op threadpool.
-          // Running it in the threadpool, let's the ensuing
-          // ops be scheduled faster, because the executor will
-          // add them to the front of the threadpool's task
-          // queue rather than the end.
-          cleanup_fn(final_status);
-        });
-        final_status = run_status;
-        if (!final_status.ok()) {
-          return;
-        }
-        if (last_task.forced_warmup_batch_size == 0) {
-          final_status = SplitOutputTensors(combined_outputs, batch.get());
-        }
-      });
+  auto done = [&](const Status& run_status) {
+    Status final_status;
+    auto run_finally = gtl::MakeCleanup([&]() {
+      // We do the cleanup here as an optimization, so that
+      // it runs in the underlying TF inter-op threadpool.
+      // Running it in the threadpool, let's the ensuing
+      // ops be scheduled faster, because the executor will
+      // add them to the front of the threadpool's task
+      // queue rather than the end.
+      cleanup_fn(final_status);
+    });
+    final_status = run_status;
+    if (!final_status.ok()) {
+      return;
+    }
+    if (last_task.forced_warmup_batch_size == 0) {
+      final_status = SplitOutputTensors(combined_outputs, batch.get());
+    }
+  };
+  const int num_shards =
+      concatenated_tensors.empty() || func_batch_shard_threads_ == nullptr
+          ? 1
+          : std::min(NumFuncBatchShards(processed_size),
+                     func_batch_sharding_.max_shards);
+  if (num_shards > 1) {
+    ProcessFuncBatchShards(last_task, concatenated_tensors, num_shards,
+                           &combined_outputs, std::move(done));
+  } else {
+    ProcessFuncBatchImpl(last_task, args, &combined_outputs, std::move(done));
+  }
+}
+
+void BatchResourceBase::set_func_batch_sharding(FuncBatchSharding sharding) {
+  sharding.max_shards = std::max<int32>(sharding.max_shards, 1);
+  sharding.min_shard_size = std::max<int32>(sharding.min_shard_size, 1);
+  func_batch_sharding_ = sharding;
+  func_batch_shard_threads_.reset();
+  if (sharding.max_shards > 1) {
+    func_batch_shard_threads_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "func_batch_shards", sharding.max_shards - 1);
+  }
+}
+
+int BatchResourceBase::NumFuncBatchShards(int batch_size) const {
+  const bool large_batch_splitting =
+      batcher_ ? batcher_queue_options_.enable_large_batch_splitting
+               : adaptive_batcher_queue_options_.split_input_task_func !=
+                     nullptr;
+  if (!large_batch_splitting) {
+    return 1;
+  }
+  return std::max<int32>(
+      1, std::min<int32>(func_batch_sharding_.max_shards,
+                         batch_size / func_batch_sharding_.min_shard_size));
+}
+
+void BatchResourceBase::ProcessFuncBatchShards(
+    const BatchTask& last_task, const std::vector<Tensor>& batched_inputs,
+    int num_shards, std::vector<Tensor>* combined_outputs,
+    std::function<void(const Status&)> done) const {
+  const int64_t batch_size = batched_inputs[0].dim_size(0);
+  std::vector<int64_t> shard_sizes(num_shards, batch_size / num_shards);
+  for (int64_t i = 0; i < batch_size % num_shards; ++i) {
+    ++shard_sizes[i];
+  }
+  std::vector<std::vector<Tensor>> shard_args(num_shards);
+  for (const Tensor& input : batched_inputs) {
+    std::vector<Tensor> splits;
+    const Status split_status = SplitWithoutCopy(input, shard_sizes, &splits);
+    if (!split_status.ok()) {
+      done(split_status);
+      return;
+    }
+    for (int i = 0; i < num_shards; ++i) {
+      shard_args[i].push_back(std::move(splits[i]));
+    }
+  }
+  for (std::vector<Tensor>& args : shard_args) {
+    args.insert(args.end(), last_task.captured_inputs.begin(),
+                last_task.captured_inputs.end());
+  }
+
+  std::vector<std::vector<Tensor>> shard_outputs(num_shards);
+  ThreadSafeStatus shards_status;
+  absl::BlockingCounter shards_done(num_shards);
+  auto process_shard = [&](int i) {
+    profiler::TraceMe trace_me([i] {
+      return profiler::TraceMeEncode("ProcessFuncBatchShard", {{"shard", i}});
+    });
+    ProcessFuncBatchImpl(last_task, shard_args[i], &shard_outputs[i],
+                         [&](const Status& status) {
+                           shards_status.Update(status);
+                           shards_done.DecrementCount();
+                         });
+  };
+  // `ProcessFuncBatchImpl` blocks until the function is done, so every shard
+  // but the first one runs on a thread of its own. There are
+  // `max_shards - 1` threads, so the shards of a batch never wait for each
+  // other, though they may wait for the shards of a concurrent batch.
+  for (int i = 1; i < num_shards; ++i) {
+    func_batch_shard_threads_->Schedule(
+        [&process_shard, i] { process_shard(i); });
+  }
+  process_shard(0);
+  shards_done.Wait();
+  if (!shards_status.status().ok()) {
+    done(shards_status.status());
+    return;
+  }
+
+  const size_t num_outputs = shard_outputs[0].size();
+  combined_outputs->clear();
+  combined_outputs->reserve(num_outputs);
+  for (size_t i = 0; i < num_outputs; ++i) {
+    std::vector<Tensor> output_shards;
+    output_shards.reserve(num_shards);
+    for (const std::vector<Tensor>& outputs : shard_outputs) {
+      if (outputs.size() != num_outputs) {
+        done(errors::Internal("Batch function shards returned ",
+                              outputs.size(), " and ", num_outputs,
+                              " outputs"));
+        return;
+      }
+      output_shards.push_back(outputs[i]);
+    }
+    Tensor combined_output;
+    const Status concat_status =
+        tensor::Concat(output_shards, &combined_output);
+    if (!concat_status.ok()) {
+      done(concat_status);
+      return;
+    }
+    combined_outputs->push_back(std::move(combined_output));
+  }
+  done(absl::OkStatus());
 }
 
 // Processes a batch of one or more BatchTask entries.
@@ -1010,6 +1322,7 @@ void BatchResourceBase::ProcessBatch(std::unique_ptr<BatchT> batch) const {
 
   OP_REQUIRES_OK_ASYNC(last_task_context, ValidateBatch(*batch),
                        last_task_callback);
+  RecordBatchingWaitCosts(EnvTime::NowNanos(), *batch);
 
   // All tasks should have the same number of input edges.
   const int num_input_edges = batch->task(0).inputs.size();
@@ -1195,5 +1508,20 @@ void BatchResourceBase::SplitBatchCostsAndRecordMetrics(
   }
 }
 
+void BatchResourceBase::RecordBatchingWaitCosts(uint64 now_nanos,
+                                                BatchT& batch) {
+  for (int i = 0; i < batch.num_tasks(); ++i) {
+    RequestCost* request_cost = batch.task(i).request_cost;
+    if (!request_cost) continue;
+    const uint64 start_time = batch.task(i).start_time;
+    if (start_time > now_nanos) continue;
+    // The splits of a request share its request_cost and start_time, and
+    // may be processed in several batches. The request waited until its last
+    // split was processed.
+    request_cost->RecordMaxCost(kBatchingWaitCostName,
+                                absl::Nanoseconds(now_nanos - start_time));
+  }
+}
+
 }  // namespace serving
 }  // namespace tensorflow
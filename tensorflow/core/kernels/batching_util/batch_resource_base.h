@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tsl/platform/criticality.h"
 
@@ -95,6 +96,16 @@ class BatchResourceBase : public ResourceBase {
 
     uint64 start_time;
 
+    // The deadline of the request that created this task, in microseconds
+    // since the Unix epoch, or 0 if the request has no deadline.
+    uint64 deadline_micros = 0;
+
+    // The sequence length of the inputs before and after they were padded to a
+    // sequence length bucket, or -1 if they were not padded. See
+    // `set_sequence_length_bucketing`.
+    int64_t unpadded_sequence_length = -1;
+    int64_t padded_sequence_length = -1;
+
     size_t size() const override { return inputs[0].shape().dim_size(0); }
 
     // Create a split task from this one. The caller needs to setup the inputs
@@ -160,6 +171,43 @@ class BatchResourceBase : public ResourceBase {
 
   const SessionMetadata& session_metadata() const { return session_metadata_; }
 
+  struct SequenceLengthBucketing {
+    // The sequence length buckets, in increasing order.
+    std::vector<int32> buckets;
+    // The batched inputs that are sequences along dimension 1.
+    std::vector<int32> input_indices;
+    // The outputs that are sequences along dimension 1.
+    std::vector<int32> output_indices;
+    // Whether to append a mask of the sequence to the batched inputs.
+    bool append_mask = false;
+  };
+
+  // If `bucketing.buckets` is non-empty, inputs are batched only with inputs
+  // of the same sequence length bucket. The sequence length of an invocation
+  // is the largest dimension 1 of its `input_indices` inputs, and its bucket is
+  // the smallest bucket that is at least the sequence length. These inputs are
+  // padded along dimension 1 to the bucket, and the `output_indices` outputs
+  // are trimmed back to the sequence length. If `append_mask` is true, an
+  // int32 [batch_size, bucket] input is appended to the batched inputs, which
+  // is 1 along the sequence and 0 along the padding.
+  void set_sequence_length_bucketing(SequenceLengthBucketing bucketing) {
+    sequence_length_bucketing_ = std::move(bucketing);
+  }
+
+  struct FuncBatchSharding {
+    // The maximum number of shards of a batch. 1 disables sharding.
+    int32 max_shards = 1;
+    // The minimum number of elements, including padding, of a shard.
+    int32 min_shard_size = 32;
+  };
+
+  // If `sharding.max_shards` is greater than 1, batch function batches of
+  // queues with large batch splitting enabled are cut along the 0th
+  // dimension into up to `max_shards` shards of at least `min_shard_size`
+  // elements. The shards are processed concurrently, on a thread pool owned by
+  // this resource, and their outputs are concatenated in order.
+  void set_func_batch_sharding(FuncBatchSharding sharding);
+
   using CreateBatchTaskFn =
       std::function<StatusOr<std::unique_ptr<BatchTask>>()>;
 
@@ -246,6 +294,17 @@ class BatchResourceBase : public ResourceBase {
           batch_cost_measurements,
       int64_t processed_size, BatchT& batch);
 
+  // Records in the request_cost of each task of `batch` how long the task
+  // waited to be processed, given the current time `now_nanos`.
+  static void RecordBatchingWaitCosts(uint64 now_nanos, BatchT& batch);
+
+  // Splits `tensor` along its 0th dimension into tensors of `sizes`. If all of
+  // the splits are aligned, they are views of the buffer of `tensor`, which is
+  // then kept alive until all of them are released. Otherwise, they are copies.
+  static Status SplitWithoutCopy(const Tensor& tensor,
+                                 const std::vector<int64_t>& sizes,
+                                 std::vector<Tensor>* splits);
+
  private:
   // Implementation of calling the process batch function.
   virtual void ProcessFuncBatchImpl(
@@ -253,6 +312,23 @@ class BatchResourceBase : public ResourceBase {
       absl::Span<const Tensor> inputs, std::vector<Tensor>* combined_outputs,
       std::function<void(const Status&)> done) const = 0;
 
+  // Returns the number of shards into which a batch function batch of
+  // `batch_size` elements, including padding, is cut. The shards are
+  // processed concurrently by separate `ProcessFuncBatchImpl` calls, each
+  // of which the runtime places on a device of its own choosing (e.g. the
+  // least loaded GPU according to `GpuServingDeviceSelector`). By default,
+  // follows `set_func_batch_sharding`. Overrides may not return more than
+  // `FuncBatchSharding::max_shards` shards.
+  virtual int NumFuncBatchShards(int batch_size) const;
+
+  // Processes `num_shards` slices of `batched_inputs` along the 0th dimension
+  // concurrently and concatenates their outputs into `combined_outputs`.
+  void ProcessFuncBatchShards(const BatchTask& last_task,
+                              const std::vector<Tensor>& batched_inputs,
+                              int num_shards,
+                              std::vector<Tensor>* combined_outputs,
+                              std::function<void(const Status&)> done) const;
+
   // Validates that it's legal to combine the tasks in 'batch' into a batch.
   // Assumes the batch is non-empty.
   static Status ValidateBatch(const BatchT& batch);
@@ -283,6 +359,11 @@ class BatchResourceBase : public ResourceBase {
   static Status EmitIndexTensor(OpKernelContext* context, const BatchT& batch,
                                 int output_index);
 
+  // Pads the inputs of `task` to their sequence length bucket, and appends the
+  // mask if requested. See `set_sequence_length_bucketing`.
+  Status PadToSequenceLengthBucket(OpKernelContext* context,
+                                   BatchTask* task) const;
+
   // Looks up the batcher queue for 'queue_name'. If it did't previously exist,
   // creates it.
   Status LookupOrCreateBatcherQueue(const string& queue_name,
@@ -314,6 +395,13 @@ class BatchResourceBase : public ResourceBase {
   // A concatenated string of <allowed_batch_sizes_>, separated by ",". This is
   // used to record batching parameter.
   string allowed_batch_sizes_str_;
+
+  SequenceLengthBucketing sequence_length_bucketing_;
+
+  FuncBatchSharding func_batch_sharding_;
+  // Runs all shards of a batch function batch but the first one, which runs
+  // on the batch thread. Null if sharding is disabled.
+  std::unique_ptr<thread::ThreadPool> func_batch_shard_threads_;
 };
 
 }  // namespace serving
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -28,7 +29,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/request_cost.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 
 namespace tensorflow {
 namespace serving {
@@ -241,6 +244,87 @@ TEST(SplitBatchCostsAndRecordMetricsTest, SplitOnlyNonZeroCostTypes) {
           UnorderedElementsAre(Pair("test_tpu", absl::Milliseconds(100))))));
 }
 
+TEST(RecordBatchingWaitCostsTest, RecordsWaitOfEachTask) {
+  BatchResourceBase::BatchT batch;
+  RequestCost cost1, cost2;
+  auto task1 = MakeBatchTask(/*task_size=*/1, &cost1);
+  task1->start_time = 1000000;
+  batch.AddTask(std::move(task1));
+  auto task2 = MakeBatchTask(/*task_size=*/1, &cost2);
+  task2->start_time = 4000000;
+  batch.AddTask(std::move(task2));
+  auto task3 = MakeBatchTask(/*task_size=*/1, /*request_cost=*/nullptr);
+  task3->start_time = 4000000;
+  batch.AddTask(std::move(task3));
+  batch.Close();
+
+  BatchResourceBase::RecordBatchingWaitCosts(/*now_nanos=*/5000000, batch);
+
+  EXPECT_THAT(cost1.GetCosts(), UnorderedElementsAre(Pair(
+                                    "batching_wait", absl::Milliseconds(4))));
+  EXPECT_THAT(cost2.GetCosts(), UnorderedElementsAre(Pair(
+                                    "batching_wait", absl::Milliseconds(1))));
+}
+
+TEST(RecordBatchingWaitCostsTest, RecordsSplitsOfARequestOnce) {
+  // Two splits of one request, both in this batch.
+  BatchResourceBase::BatchT batch;
+  RequestCost cost;
+  for (int i = 0; i < 2; ++i) {
+    auto task = MakeBatchTask(/*task_size=*/1, &cost);
+    task->start_time = 1000000;
+    batch.AddTask(std::move(task));
+  }
+  batch.Close();
+  BatchResourceBase::RecordBatchingWaitCosts(/*now_nanos=*/5000000, batch);
+  EXPECT_THAT(cost.GetCosts(), UnorderedElementsAre(Pair(
+                                   "batching_wait", absl::Milliseconds(4))));
+
+  // A later split of the request, in another batch.
+  BatchResourceBase::BatchT later_batch;
+  auto task = MakeBatchTask(/*task_size=*/1, &cost);
+  task->start_time = 1000000;
+  later_batch.AddTask(std::move(task));
+  later_batch.Close();
+  BatchResourceBase::RecordBatchingWaitCosts(/*now_nanos=*/7000000,
+                                             later_batch);
+  EXPECT_THAT(cost.GetCosts(), UnorderedElementsAre(Pair(
+                                   "batching_wait", absl::Milliseconds(6))));
+}
+
+TEST(SplitWithoutCopyTest, AlignedSplitsShareTheBuffer) {
+  // Rows of 64 bytes keep every split aligned.
+  Tensor tensor(DT_FLOAT, TensorShape({4, 16}));
+  test::FillIota<float>(&tensor, 0);
+  std::vector<Tensor> splits;
+  TF_ASSERT_OK(
+      BatchResourceBase::SplitWithoutCopy(tensor, {1, 3}, &splits));
+
+  ASSERT_EQ(splits.size(), 2u);
+  EXPECT_EQ(splits[0].tensor_data().data(), tensor.tensor_data().data());
+  EXPECT_EQ(splits[1].tensor_data().data(),
+            tensor.tensor_data().data() + 16 * sizeof(float));
+  test::ExpectTensorEqual<float>(splits[0], tensor.Slice(0, 1));
+  test::ExpectTensorEqual<float>(splits[1], tensor.Slice(1, 4));
+}
+
+TEST(SplitWithoutCopyTest, UnalignedSplitsAreCopies) {
+  // The second split starts 4 bytes into the buffer.
+  Tensor tensor = test::AsTensor<float>({1, 2, 3, 4}, TensorShape({4, 1}));
+  std::vector<Tensor> splits;
+  TF_ASSERT_OK(
+      BatchResourceBase::SplitWithoutCopy(tensor, {1, 3}, &splits));
+
+  ASSERT_EQ(splits.size(), 2u);
+  for (const Tensor& split : splits) {
+    EXPECT_FALSE(split.SharesBufferWith(tensor));
+  }
+  test::ExpectTensorEqual<float>(
+      splits[0], test::AsTensor<float>({1}, TensorShape({1, 1})));
+  test::ExpectTensorEqual<float>(
+      splits[1], test::AsTensor<float>({2, 3, 4}, TensorShape({3, 1})));
+}
+
 }  // namespace
 }  // namespace serving
 }  // namespace tensorflow
@@ -18,12 +18,14 @@ limitations under the License.
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <deque>
 #include <functional>
 #include <list>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -32,6 +34,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/time/clock.h"
 #include "tensorflow/core/kernels/batching_util/batch_input_task.h"
+#include "tensorflow/core/kernels/batching_util/batch_latency_model.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -231,6 +234,23 @@ class SharedBatchScheduler
     // If true, the padding will not be appended.
     bool disable_padding = false;
 
+    // If true, the open batch is scheduled once waiting for one more task
+    // would make its earliest task miss the deadline returned by
+    // `get_task_deadline_micros`, instead of after `batch_timeout_micros`.
+    //
+    // Whether a task would miss its deadline is predicted from the processing
+    // times of earlier batches of the queue and the interval between task
+    // arrivals. `batch_timeout_micros` still applies while the open batch has
+    // no task with a deadline, or before the first batch has been processed.
+    //
+    // Must be false if `enable_lazy_split` is true.
+    bool enable_deadline_aware_batching = false;
+
+    // Returns the deadline of `task`, in microseconds of the queue's `Env`
+    // clock, or 0 if the task has no deadline. Required iff
+    // `enable_deadline_aware_batching` is true.
+    std::function<uint64(const TaskType& task)> get_task_deadline_micros;
+
     // If true, queue implementation would split high priority and low priority
     // inputs into two sub queues.
     bool enable_priority_queue = false;
@@ -439,6 +459,21 @@ class Queue {
   bool IsOpenBatchSchedulableAfterEagerSplit() const
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Determines whether the open batch of `open_batch_size` has waited long
+  // enough for more tasks, according to `batch_timeout_micros` or, with
+  // `enable_deadline_aware_batching`, to the deadline of its earliest task.
+  bool HasOpenBatchWaitedEnough(size_t open_batch_size) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Updates the interval between task arrivals used by
+  // `enable_deadline_aware_batching`.
+  void RecordTaskArrival() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Updates the open batch deadline used by `enable_deadline_aware_batching`
+  // for a task with `deadline_micros` that is added to the open batch.
+  void UpdateOpenBatchDeadline(uint64 deadline_micros, bool new_batch)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Same as SchedulingCapacity(), but assumes the caller already holds a
   // lock on 'mu_'.
   size_t SchedulingCapacityInternal() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -521,6 +556,20 @@ class Queue {
   // task.
   uint64 open_batch_start_time_micros_ TF_GUARDED_BY(mu_);
 
+  // The earliest deadline of the tasks in the open batch, or 0 if none of them
+  // has a deadline. Used iff `enable_deadline_aware_batching` is true.
+  uint64 open_batch_deadline_micros_ TF_GUARDED_BY(mu_) = 0;
+
+  // The arrival time of the latest task, and the moving average of the
+  // interval between task arrivals. Used iff `enable_deadline_aware_batching`
+  // is true.
+  uint64 last_task_arrival_micros_ TF_GUARDED_BY(mu_) = 0;
+  double mean_task_interval_micros_ TF_GUARDED_BY(mu_) = 0;
+
+  // Predicts the processing time of batches from the processing time of
+  // earlier batches. Used iff `enable_deadline_aware_batching` is true.
+  BatchLatencyModel latency_model_ TF_GUARDED_BY(mu_);
+
   // Whether this queue contains a batch that is eligible to be scheduled.
   // Used to keep track of when to call 'schedulable_batch_callback_'.
   bool schedulable_batch_ TF_GUARDED_BY(mu_) = false;
@@ -657,6 +706,19 @@ Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
         "enable_large_batch_splitting is enabled.");
   }
 
+  if (options.enable_deadline_aware_batching &&
+      options.get_task_deadline_micros == nullptr) {
+    return errors::InvalidArgument(
+        "get_task_deadline_micros must be specified when "
+        "enable_deadline_aware_batching is true.");
+  }
+
+  if (options.enable_deadline_aware_batching && options.enable_lazy_split) {
+    return errors::InvalidArgument(
+        "enable_deadline_aware_batching cannot be used with "
+        "enable_lazy_split.");
+  }
+
   if (options.enable_large_batch_splitting &&
       (options.input_batch_size_limit < options.max_execution_batch_size)) {
     return errors::InvalidArgument(
@@ -815,7 +877,8 @@ Queue<TaskType>::Queue(
       env_(env),
       max_execution_batch_size_(GetMaxExecutionBatchSize(options_)),
       process_batch_callback_(process_batch_callback),
-      schedulable_batch_callback_(schedulable_batch_callback) {
+      schedulable_batch_callback_(schedulable_batch_callback),
+      latency_model_(max_execution_batch_size_) {
   // Set the higher 32 bits of traceme_context_id_counter_ to be the creation
   // time of the queue. This prevents the batches in different queues to have
   // the same traceme_context_id_counter_.
@@ -951,6 +1014,12 @@ Status Queue<TaskType>::ScheduleWithoutOrEagerSplit(
         max_execution_batch_size() - batches.back()->size();
 
     const int64_t input_task_size = (*task)->size();
+    // Split tasks have the deadline of their input task.
+    uint64 deadline_micros = 0;
+    if (options_.enable_deadline_aware_batching) {
+      RecordTaskArrival();
+      deadline_micros = options_.get_task_deadline_micros(**task);
+    }
 
     std::vector<std::unique_ptr<TaskType>> output_tasks;
 
@@ -967,9 +1036,13 @@ Status Queue<TaskType>::ScheduleWithoutOrEagerSplit(
           max_execution_batch_size()) {
         StartNewBatch();
       }
-      if (batches.back()->empty()) {
+      const bool new_batch = batches.back()->empty();
+      if (new_batch) {
         open_batch_start_time_micros_ = env_->NowMicros();
       }
+      if (options_.enable_deadline_aware_batching) {
+        UpdateOpenBatchDeadline(deadline_micros, new_batch);
+      }
       profiler::TraceMeProducer trace_me(
           [&output_tasks, i] {
             return profiler::TraceMeEncode("ScheduleOutputTask",
@@ -1144,10 +1217,16 @@ void Queue<TaskType>::ProcessBatch(std::unique_ptr<Batch<TaskType>> batch) {
       },
       profiler::ContextType::kSharedBatchScheduler,
       batch->traceme_context_id());
+  const size_t batch_size = batch->size();
+  const uint64 start_time_micros = env_->NowMicros();
   process_batch_callback_(std::move(batch));
+  const uint64 end_time_micros = env_->NowMicros();
 
   {
     mutex_lock l(mu_);
+    if (options_.enable_deadline_aware_batching) {
+      latency_model_.Record(batch_size, end_time_micros - start_time_micros);
+    }
     --num_batches_being_processed_;
     if (empty_notification_ != nullptr && IsEmptyInternal()) {
       empty_notification_->Notify();
@@ -1220,8 +1299,48 @@ bool Queue<TaskType>::IsOpenBatchSchedulableAfterEagerSplit() const {
     return false;
   }
   return closed_ || open_batch->size() >= max_execution_batch_size() ||
-         env_->NowMicros() >=
-             open_batch_start_time_micros_ + options_.batch_timeout_micros;
+         HasOpenBatchWaitedEnough(open_batch->size());
+}
+
+template <typename TaskType>
+bool Queue<TaskType>::HasOpenBatchWaitedEnough(size_t open_batch_size) const {
+  const uint64 now_micros = env_->NowMicros();
+  if (options_.enable_deadline_aware_batching &&
+      open_batch_deadline_micros_ > 0) {
+    // Assumes that the next task has a single element.
+    const std::optional<int64_t> latency_micros =
+        latency_model_.PredictMicros(open_batch_size + 1);
+    if (latency_micros.has_value()) {
+      return now_micros + mean_task_interval_micros_ + *latency_micros >=
+             open_batch_deadline_micros_;
+    }
+  }
+  return now_micros >=
+         open_batch_start_time_micros_ + options_.batch_timeout_micros;
+}
+
+template <typename TaskType>
+void Queue<TaskType>::RecordTaskArrival() {
+  // Weight of the newest interval in the moving average.
+  constexpr double kNewIntervalWeight = 0.2;
+  const uint64 now_micros = env_->NowMicros();
+  if (last_task_arrival_micros_ > 0) {
+    const double interval_micros = now_micros - last_task_arrival_micros_;
+    mean_task_interval_micros_ +=
+        kNewIntervalWeight * (interval_micros - mean_task_interval_micros_);
+  }
+  last_task_arrival_micros_ = now_micros;
+}
+
+template <typename TaskType>
+void Queue<TaskType>::UpdateOpenBatchDeadline(uint64 deadline_micros,
+                                              bool new_batch) {
+  if (new_batch || open_batch_deadline_micros_ == 0) {
+    open_batch_deadline_micros_ = deadline_micros;
+  } else if (deadline_micros > 0) {
+    open_batch_deadline_micros_ =
+        std::min(open_batch_deadline_micros_, deadline_micros);
+  }
 }
 
 template <typename TaskType>
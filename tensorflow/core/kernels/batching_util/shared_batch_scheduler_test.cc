@@ -794,6 +794,80 @@ TEST_P(SharedBatchSchedulerTest, ZeroQueueRewrittenToOneQueue) {
   }
 }
 
+TEST(SharedBatchSchedulerDeadlineTest, SchedulesBatchBeforeDeadline) {
+  test_util::FakeClockEnv env(Env::Default());
+  env.AdvanceByMicroseconds(1000);
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    Notification first_batch_processed, second_batch_processed;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      if (!first_batch_processed.HasBeenNotified()) {
+        // Simulates processing a batch of 4 in 400 microseconds.
+        EXPECT_EQ(batch->size(), 4);
+        env.AdvanceByMicroseconds(400);
+        first_batch_processed.Notify();
+        return;
+      }
+      EXPECT_EQ(batch->size(), 1);
+      second_batch_processed.Notify();
+    };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    uint64 deadline_micros = 0;
+    QueueOptions options = CreateQueueOptions(
+        /*max_execution_batch_size=*/4, /*input_batch_size_limit=*/4,
+        /*batch_timeout_micros=*/1000 * 1000, /*max_enqueued_batches=*/2,
+        /*enable_large_batch_splitting=*/false, /*enable_lazy_split=*/false,
+        /*split_func=*/nullptr);
+    options.enable_deadline_aware_batching = true;
+    options.get_task_deadline_micros = [&deadline_micros](const FakeTask&) {
+      return deadline_micros;
+    };
+    auto queue = CreateQueue(scheduler, options, callback);
+
+    // A full batch is processed right away and its latency is recorded.
+    TF_ASSERT_OK(ScheduleTask(4, queue.get()));
+    first_batch_processed.WaitForNotification();
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+
+    // The second task arrives 400 microseconds after the first one, and a
+    // batch of 2 is predicted to take 200 microseconds, so the batch is
+    // scheduled 80 + 200 microseconds before the deadline.
+    deadline_micros = env.NowMicros() + 1000;
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    env.AdvanceByMicroseconds(700);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(second_batch_processed.HasBeenNotified());
+    env.AdvanceByMicroseconds(20);
+    second_batch_processed.WaitForNotification();
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerDeadlineTest, InvalidDeadlineAwareBatchingOptions) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(1);
+  QueueOptions options = CreateQueueOptions(
+      /*max_execution_batch_size=*/10, /*input_batch_size_limit=*/10,
+      /*batch_timeout_micros=*/0, /*max_enqueued_batches=*/2,
+      /*enable_large_batch_splitting=*/false, /*enable_lazy_split=*/false,
+      /*split_func=*/nullptr);
+  options.enable_deadline_aware_batching = true;
+  std::unique_ptr<Queue> queue;
+  EXPECT_THAT(scheduler->AddQueue(options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                HasSubstr("get_task_deadline_micros")));
+}
+
 // TODO(b/161857471):
 // Add test coverage when input-split and no-split returns differently.
 INSTANTIATE_TEST_SUITE_P(
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/op_requires.h"
 #include "tensorflow/core/framework/resource_handle.h"
@@ -588,6 +589,8 @@ class CollectiveOpV2Kernel : public AsyncOpKernel {
     OP_REQUIRES_OK(c, c->GetAttr("T", &data_type_));
     OP_REQUIRES_OK(c, c->GetAttr("communication_hint", &communication_hint_));
     OP_REQUIRES_OK(c, c->GetAttr("timeout_seconds", &timeout_seconds_));
+    // Set by the "collective_priority" graph optimizer.
+    TryGetNodeAttr(c->def(), kCollectivePriorityAttr, &priority_);
     device_type_ = c->device_type();
   }
 
@@ -638,6 +641,7 @@ class CollectiveOpV2Kernel : public AsyncOpKernel {
     col_params->instance.instance_key = instance_key.unaligned_flat<int32>()(0);
     col_params->instance.impl_details.communication_hint = communication_hint_;
     col_params->instance.impl_details.timeout_seconds = timeout_seconds_;
+    col_params->priority = priority_;
     return absl::OkStatus();
   }
 
@@ -757,6 +761,7 @@ class CollectiveOpV2Kernel : public AsyncOpKernel {
   DataType data_type_ = DT_INVALID;
   string communication_hint_;
   float timeout_seconds_ = 0;
+  int32 priority_ = 0;
   DeviceType device_type_;
 };
 
@@ -786,6 +791,11 @@ class CollectiveReduceV2OpKernel : public CollectiveOpV2Kernel {
     final_op_ = BuildOpKernel(c, final_op_name, &sub_node);
     name_ = strings::StrCat(c->def().name(), ": ReduceV2(", merge_op_name, ",",
                             final_op_name, ")");
+    // Set by the "collective_bucketing" graph optimizer.
+    if (TryGetNodeAttr(c->def(), kCollectiveBucketAttr, &bucket_)) {
+      OP_REQUIRES_OK(
+          c, c->GetAttr(kCollectiveBucketSizeAttr, &bucket_size_));
+    }
     VLOG(2) << "CollectiveReduceV2 " << this << " name " << name_
             << " communication_hint " << communication_hint_;
   }
@@ -814,6 +824,23 @@ class CollectiveReduceV2OpKernel : public CollectiveOpV2Kernel {
             << col_params->instance.step_id << " shape "
             << c->input(0).shape().DebugString() << " device "
             << c->device()->name();
+    if (bucket_size_ > 1) {
+      // The output is set once the whole bucket has been reduced.
+      CollectiveExecutor* col_exec = c->collective_executor();
+      OP_REQUIRES_ASYNC(
+          c, col_exec,
+          errors::Internal(
+              "Failed to get CollectiveExecutor from OpKernelContext for Op ",
+              name_),
+          done_with_cleanup);
+      col_exec->ExecuteBucketedAsync(
+          c, col_params, bucket_, bucket_size_,
+          [c, done = std::move(done_with_cleanup)](const Status& s) {
+            if (!s.ok()) c->SetStatus(s);
+            done();
+          });
+      return;
+    }
     // Allocate the output tensor.
     Tensor* output = nullptr;
     OP_REQUIRES_OK_ASYNC(c,
@@ -825,6 +852,8 @@ class CollectiveReduceV2OpKernel : public CollectiveOpV2Kernel {
 
  private:
   int max_subdivs_per_device_;
+  string bucket_;
+  int bucket_size_ = 0;
   std::unique_ptr<OpKernel> merge_op_;
   std::unique_ptr<OpKernel> final_op_;
 };
@@ -24,6 +24,10 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/constant_op.h"
 
+#include <memory>
+#include <tuple>
+
+#include "absl/container/flat_hash_map.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -37,9 +41,13 @@ limitations under the License.
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/graph/graph_node_util.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -71,6 +79,73 @@ NodeDef StripTensorDataFromNodeDef(OpKernelConstruction* ctx) {
   return ret;
 }
 
+// A process-wide cache of the tensors of constant kernels, so that sessions
+// that load the same constants (e.g. two versions of a model that is being
+// hot-swapped) share a single copy of them. Entries are keyed by the
+// fingerprint of the constant's TensorProto and by the allocator that holds
+// the tensor, and live for as long as one of the kernels that use them.
+class SharedConstantCache {
+ public:
+  static SharedConstantCache* Global() {
+    static SharedConstantCache* cache = new SharedConstantCache;
+    return cache;
+  }
+
+  // Returns the tensor parsed from `proto` by `device`, parsing it only if no
+  // live kernel holds an identical tensor from the same allocator.
+  Status GetOrCreate(const TensorProto& proto, DeviceBase* device,
+                     std::shared_ptr<const Tensor>* tensor) {
+    string serialized;
+    if (!SerializeToStringDeterministic(proto, &serialized)) {
+      return errors::InvalidArgument("Cannot serialize tensor proto");
+    }
+    const Fprint128 fingerprint = Fingerprint128(serialized);
+    const Key key(fingerprint.low64, fingerprint.high64,
+                  device->GetAllocator(AllocatorAttributes()));
+
+    // Declared before the locks, so that dropping a reference never runs the
+    // deleter below while `mu_` is held.
+    std::shared_ptr<const Tensor> result;
+    {
+      mutex_lock l(mu_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) result = it->second.lock();
+    }
+    if (result == nullptr) {
+      auto parsed = std::make_unique<Tensor>(proto.dtype());
+      TF_RETURN_IF_ERROR(device->MakeTensorFromProto(
+          proto, AllocatorAttributes(), parsed.get()));
+      mutex_lock l(mu_);
+      std::weak_ptr<const Tensor>& entry = entries_[key];
+      result = entry.lock();
+      if (result == nullptr) {
+        // The deleter drops the entry once the last kernel is destroyed.
+        result = std::shared_ptr<const Tensor>(
+            parsed.release(), [this, key](const Tensor* t) {
+              delete t;
+              Erase(key);
+            });
+        entry = result;
+      }
+    }
+    *tensor = std::move(result);
+    return OkStatus();
+  }
+
+ private:
+  typedef std::tuple<uint64, uint64, const Allocator*> Key;
+
+  void Erase(const Key& key) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end() && it->second.expired()) entries_.erase(it);
+  }
+
+  mutex mu_;
+  absl::flat_hash_map<Key, std::weak_ptr<const Tensor>> entries_
+      TF_GUARDED_BY(mu_);
+};
+
 }  // namespace
 
 ConstantOp::ConstantOp(OpKernelConstruction* ctx)
@@ -79,8 +154,17 @@ ConstantOp::ConstantOp(OpKernelConstruction* ctx)
   const TensorProto* proto = nullptr;
   profiler::ScopedMemoryDebugAnnotation op_annotation(name_view().data());
   OP_REQUIRES_OK(ctx, ctx->GetAttr("value", &proto));
-  OP_REQUIRES_OK(ctx, ctx->device()->MakeTensorFromProto(
-                          *proto, AllocatorAttributes(), &tensor_));
+  bool share_constants = false;
+  OP_REQUIRES_OK(ctx, ReadBoolFromEnvVar("TF_SHARE_CONSTANTS_ACROSS_SESSIONS",
+                                         false, &share_constants));
+  if (share_constants && ctx->device_type() == DEVICE_CPU) {
+    OP_REQUIRES_OK(ctx, SharedConstantCache::Global()->GetOrCreate(
+                            *proto, ctx->device(), &shared_tensor_));
+    tensor_ = *shared_tensor_;
+  } else {
+    OP_REQUIRES_OK(ctx, ctx->device()->MakeTensorFromProto(
+                            *proto, AllocatorAttributes(), &tensor_));
+  }
   OP_REQUIRES(
       ctx, ctx->output_type(0) == tensor_.dtype(),
       errors::InvalidArgument("Type mismatch between value (",
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_CONSTANT_OP_H_
 #define TENSORFLOW_CORE_KERNELS_CONSTANT_OP_H_
 
+#include <memory>
+
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor_types.h"
@@ -34,6 +36,10 @@ class ConstantOp : public OpKernel {
 
  private:
   Tensor tensor_;
+  // If TF_SHARE_CONSTANTS_ACROSS_SESSIONS is set, the entry of the
+  // process-wide constant cache that `tensor_` was taken from. Holding it
+  // keeps the entry alive for other kernels with the same value.
+  std::shared_ptr<const Tensor> shared_tensor_;
   ConstantOp(const ConstantOp&) = delete;
   void operator=(const ConstantOp&) = delete;
 };
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -96,6 +97,42 @@ TEST_F(ConstantOpTest, PersistentMemoryTracking) {
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 }
 
+TEST_F(ConstantOpTest, SharesConstantsAcrossDevicesWhenEnabled) {
+  Tensor tensor(DT_FLOAT, TensorShape({16, 16}));
+  tensor.flat<float>().setConstant(1.0f);
+  NodeDef const_node;
+  TF_ASSERT_OK(NodeDefBuilder("some_node", "Const")
+                   .Attr("dtype", DT_FLOAT)
+                   .Attr("value", tensor)
+                   .Finalize(&const_node));
+
+  // Each session has its own devices, so use one device per kernel.
+  std::vector<std::unique_ptr<Device>> devices;
+  auto make_kernel = [&]() {
+    devices.push_back(
+        DeviceFactory::NewDevice("CPU", {}, "/job:worker/replica:0/task:0"));
+    Status status;
+    std::unique_ptr<OpKernel> op(
+        CreateOpKernel(DEVICE_CPU, devices.back().get(), cpu_allocator(),
+                       const_node, TF_GRAPH_DEF_VERSION, &status));
+    TF_CHECK_OK(status);
+    return op;
+  };
+
+  std::unique_ptr<OpKernel> unshared_a = make_kernel();
+  std::unique_ptr<OpKernel> unshared_b = make_kernel();
+  EXPECT_NE(unshared_a->const_tensor()->data(),
+            unshared_b->const_tensor()->data());
+
+  setenv("TF_SHARE_CONSTANTS_ACROSS_SESSIONS", "1", /*overwrite=*/1);
+  std::unique_ptr<OpKernel> shared_a = make_kernel();
+  std::unique_ptr<OpKernel> shared_b = make_kernel();
+  unsetenv("TF_SHARE_CONSTANTS_ACROSS_SESSIONS");
+  EXPECT_EQ(shared_a->const_tensor()->data(),
+            shared_b->const_tensor()->data());
+  test::ExpectTensorEqual<float>(tensor, *shared_b->const_tensor());
+}
+
 // Returns graph containing "num" const nodes.  If 'sequential' is
 // true, make sure all constants are executed sequentially in the
 // graph by adding control dependencies.
@@ -44,6 +44,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -52,6 +53,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/conv_ops.h"
 #include "tensorflow/core/kernels/fused_eigen_output_kernels.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/kernels/winograd_conv2d.h"
 #include "tensorflow/core/profiler/lib/scoped_annotation.h"
 #include "tensorflow/core/util/tensor_format.h"
 #include "tensorflow/core/util/use_cudnn.h"
@@ -95,13 +97,15 @@ class LaunchFusedConv2DWithOutputKernel {
   LaunchFusedConv2DWithOutputKernel(
       int row_stride, int col_stride,      //
       int row_dilation, int col_dilation,  //
-      Padding padding, const std::vector<int64_t>& explicit_paddings)
+      Padding padding, const std::vector<int64_t>& explicit_paddings,
+      WinogradFilterCache* winograd_filter_cache = nullptr)
       : row_stride_(row_stride),
         col_stride_(col_stride),
         row_dilation_(row_dilation),
         col_dilation_(col_dilation),
         padding_(padding),
-        explicit_paddings_(explicit_paddings) {}
+        explicit_paddings_(explicit_paddings),
+        winograd_filter_cache_(winograd_filter_cache) {}
 
   template <typename OutputKernel>
   void operator()(const OutputKernel& output_kernel, OpKernelContext* ctx,
@@ -116,6 +120,28 @@ class LaunchFusedConv2DWithOutputKernel {
           output_kernel(output_mapper, params, i, j, num_rows, num_cols);
         });
 
+    if constexpr (std::is_same<T, float>::value) {
+      if (filter.dim_size(0) == 3 && filter.dim_size(1) == 3 &&
+          row_stride_ == 1 && col_stride_ == 1 && row_dilation_ == 1 &&
+          col_dilation_ == 1 &&
+          CanUseWinogradConv2D(filter.dim_size(2), filter.dim_size(3),
+                               output->dim_size(1), output->dim_size(2))) {
+        // With stride 1 the output size determines the padding at the bottom
+        // and right, and SAME padding puts the smaller half at the top left.
+        const int64_t pad_rows =
+            padding_ == EXPLICIT
+                ? explicit_paddings_[2]
+                : (output->dim_size(1) + 2 - input.dim_size(1)) / 2;
+        const int64_t pad_cols =
+            padding_ == EXPLICIT
+                ? explicit_paddings_[4]
+                : (output->dim_size(2) + 2 - input.dim_size(2)) / 2;
+        WinogradConv2D(ctx, input, filter, pad_rows, pad_cols,
+                       output_kernel_wrapper, winograd_filter_cache_, output);
+        return;
+      }
+    }
+
     if (filter.dim_size(0) == 1 && filter.dim_size(1) == 1 &&
         row_stride_ == 1 && col_stride_ == 1 && padding_ != EXPLICIT) {
       int conv_width = 1;  // Width for the convolution step.
@@ -202,6 +228,7 @@ class LaunchFusedConv2DWithOutputKernel {
   int col_dilation_;
   const Padding padding_;
   const std::vector<int64_t>& explicit_paddings_;
+  WinogradFilterCache* winograd_filter_cache_;
 };
 
 template <typename T>
@@ -246,10 +273,17 @@ struct LaunchFusedConv2DOp<CPUDevice, T> {
       }
     }
 
+    // Set by the remapper when the filter is a constant. Any other filter may
+    // be updated in place, so its transform is not kept.
+    bool filter_is_const = false;
+    TryGetNodeAttr(context->op_kernel().def(), "_filter_is_const",
+                   &filter_is_const);
+
     LaunchFusedConv2DWithOutputKernel<T> conv2d(
         dimensions.stride_rows, dimensions.stride_cols,
         dimensions.dilation_rows, dimensions.dilation_cols, params.padding,
-        params.explicit_paddings);
+        params.explicit_paddings,
+        filter_is_const ? &winograd_filter_cache_ : nullptr);
 
     switch (fusion) {
       case FusedComputationType::kUndefined:
@@ -304,6 +338,9 @@ struct LaunchFusedConv2DOp<CPUDevice, T> {
         break;
     }
   }
+
+ private:
+  WinogradFilterCache winograd_filter_cache_;
 };
 
 template <>
@@ -791,10 +828,9 @@ class FusedConv2DOp : public OpKernel {
       return;
     }
 
-    LaunchFusedConv2DOp<Device, T>()(context, use_cudnn_, cudnn_use_autotune_,
-                                     input, filter, fused_computation_,
-                                     fused_computation_args_, params_,
-                                     dimensions, output);
+    launcher_(context, use_cudnn_, cudnn_use_autotune_, input, filter,
+              fused_computation_, fused_computation_args_, params_, dimensions,
+              output);
   }
 
  private:
@@ -805,6 +841,8 @@ class FusedConv2DOp : public OpKernel {
   FusedComputationType fused_computation_ = FusedComputationType::kUndefined;
   FusedComputationArgs fused_computation_args_;
 
+  LaunchFusedConv2DOp<Device, T> launcher_;
+
   FusedConv2DOp(const FusedConv2DOp&) = delete;
   void operator=(const FusedConv2DOp&) = delete;
 };
@@ -1361,5 +1361,41 @@ using FusedBatchNormDataTypes = ::testing::Types<float>;
 INSTANTIATE_TYPED_TEST_SUITE_P(Test, FusedConv2DWithBatchNormOpTest,
                                FusedBatchNormDataTypes);
 
+#ifndef INTEL_MKL
+// Deep 3x3 float convolutions use Winograd F(4x4, 3x3), which is less precise
+// than the spatial convolution.
+class FusedConv2DWinogradOpTest : public FusedConv2DOpTest<float> {};
+
+TEST_F(FusedConv2DWinogradOpTest, BiasAddAndActivation) {
+  const int depth = 32;
+  const int filter_count = 24;
+  // The output size is not a multiple of the tile size.
+  Tensor image(DT_FLOAT, {2, 18, 15, depth});
+  image.flat<float>().setRandom();
+  Tensor filter(DT_FLOAT, {3, 3, depth, filter_count});
+  filter.flat<float>().setRandom();
+  filter.flat<float>() -= filter.flat<float>().constant(0.5f);
+  Tensor bias(DT_FLOAT, {filter_count});
+  bias.flat<float>().setRandom();
+  bias.flat<float>() -= bias.flat<float>().constant(0.5f);
+
+  const std::vector<int> explicit_paddings = {0, 0, 2, 0, 1, 2, 0, 0};
+  for (const std::string& padding : {"SAME", "VALID", "EXPLICIT"}) {
+    const std::vector<int> paddings =
+        padding == "EXPLICIT" ? explicit_paddings : std::vector<int>();
+    for (const std::string& activation : activations) {
+      Tensor conv_2d;
+      Tensor fused_conv_2d;
+      RunConv2DWithBiasAndActivation(image, filter, bias, activation, padding,
+                                     paddings, &conv_2d);
+      RunFusedConv2DOp(image, filter, {bias}, {"BiasAdd", activation},
+                       padding, paddings, &fused_conv_2d);
+      ASSERT_EQ(conv_2d.shape(), fused_conv_2d.shape());
+      test::ExpectClose(conv_2d, fused_conv_2d, /*atol=*/1e-4, /*rtol=*/1e-4);
+    }
+  }
+}
+#endif
+
 #endif  // TENSORFLOW_USE_ROCM
 }  // namespace tensorflow
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/cache_dataset_ops.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -22,6 +23,8 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -35,7 +38,10 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/host_info.h"
+#include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
@@ -62,6 +68,9 @@ constexpr char kIterationCompleted[] = "iteration_completed";
 constexpr char kCurIndex[] = "cur_index";
 constexpr char kShardId[] = "shard_id";
 constexpr char kCreatedAt[] = "Created at";
+constexpr char kLockOwnerHost[] = "Host";
+constexpr char kLockOwnerPid[] = "Pid";
+constexpr char kLockOwnerId[] = "Owner id";
 constexpr char kMemoryDatasetPrefix[] = "Memory";
 constexpr char kMemoryCache[] = "MemoryCache";
 constexpr char kCacheCompleted[] = "cache_completed";
@@ -74,6 +83,72 @@ constexpr char kIncompleteCacheErrorMessage[] =
     "contents of the dataset  will be discarded. This can happen if you have "
     "an input pipeline similar to `dataset.cache().take(k).repeat()`. You "
     "should use `dataset.take(k).cache().repeat()` instead.";
+
+// Whether file caches are shared by the processes of a host, from
+// TF_DATA_SHARED_FILE_CACHE.
+bool SharedFileCache() {
+  bool shared;
+  Status s = ReadBoolFromEnvVar("TF_DATA_SHARED_FILE_CACHE",
+                                /*default_val=*/false, &shared);
+  if (!s.ok()) {
+    LOG(ERROR) << s;
+    return false;
+  }
+  return shared;
+}
+
+// The contents of a lockfile: when and by which process it was created.
+string LockFileContents(Env* env) {
+  return strings::StrCat(kCreatedAt, ": ", EnvTime::NowSeconds(), "\n",
+                         kLockOwnerHost, ": ", port::Hostname(), "\n",
+                         kLockOwnerPid, ": ", env->GetProcessId(), "\n",
+                         kLockOwnerId, ": ", random::New64(), "\n");
+}
+
+// Whether the lockfile with `contents` was created by a process of this host
+// that no longer runs. Lockfiles of other hosts, and lockfiles without an
+// owner, are never considered stale.
+bool IsStaleLockFile(Env* env, StringPiece contents) {
+  string host;
+  int64_t pid = -1;
+  for (StringPiece line : absl::StrSplit(contents, '\n')) {
+    std::pair<StringPiece, StringPiece> key_value =
+        absl::StrSplit(line, absl::MaxSplits(": ", 1));
+    if (key_value.first == kLockOwnerHost) {
+      host = string(key_value.second);
+    } else if (key_value.first == kLockOwnerPid &&
+               !absl::SimpleAtoi(key_value.second, &pid)) {
+      return false;
+    }
+  }
+  if (pid < 0 || host != port::Hostname() || pid == env->GetProcessId()) {
+    return false;
+  }
+  // Only procfs tells whether a process is running.
+  if (!env->FileExists("/proc/self").ok()) return false;
+  return !env->FileExists(strings::StrCat("/proc/", pid)).ok();
+}
+
+// Creates `lockfile` holding `contents`. The contents are written to a
+// temporary file that is then renamed, so other processes never read a
+// partial lockfile. Since `Env` cannot create a file exclusively, the
+// lockfile is read back, and `*acquired` is set to false if another process
+// renamed its own lockfile over it.
+Status CreateLockFile(Env* env, const string& lockfile, const string& contents,
+                      bool* acquired) {
+  const string tmp_lockfile = strings::StrCat(
+      lockfile, ".tmp_", env->GetProcessId(), "_", random::New64());
+  TF_RETURN_IF_ERROR(WriteStringToFile(env, tmp_lockfile, contents));
+  Status s = env->RenameFile(tmp_lockfile, lockfile);
+  if (!s.ok()) {
+    env->DeleteFile(tmp_lockfile).IgnoreError();
+    return s;
+  }
+  string actual_contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, lockfile, &actual_contents));
+  *acquired = actual_contents == contents;
+  return absl::OkStatus();
+}
 }  // namespace
 
 class PartialCache {
@@ -144,6 +219,7 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         input_(input),
         filename_(std::move(filename)),
         env_(env),
+        shared_(SharedFileCache()),
         num_tensors_(input->output_dtypes().size()),
         tensor_index_padding_size_(StringPaddingSize(num_tensors_)),
         item_index_padding_size_(StringPaddingSize(kMaxItems)),
@@ -205,6 +281,15 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
                            tensor_index);
   }
 
+  std::unique_ptr<BundleWriter> MakeWriter(const string& prefix) const {
+    BundleWriter::Options options;
+    if (shared_) {
+      // Lets readers map the tensors, see `FileReaderIterator`.
+      options.data_alignment = std::max(EIGEN_MAX_ALIGN_BYTES, 1);
+    }
+    return std::make_unique<BundleWriter>(env_, prefix, options);
+  }
+
   class FileIterator : public DatasetIterator<FileDatasetBase> {
    public:
     explicit FileIterator(const Params& params)
@@ -299,7 +384,10 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
             iteration_completed_(false) {}
 
       ~FileWriterIterator() override {
-        if (!dataset()->env_->FileExists(MetaFilename(filename_)).ok()) {
+        mutex_lock l(mu_);
+        // In a shared cache, the files may belong to another process.
+        if (!pass_through_ &&
+            !dataset()->env_->FileExists(MetaFilename(filename_)).ok()) {
           LOG(WARNING) << kIncompleteCacheErrorMessage;
           std::vector<string> cache_files;
           Status s = dataset()->env_->GetMatchingPaths(
@@ -332,6 +420,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         if (*end_of_sequence) {
           return absl::OkStatus();
         }
+        if (pass_through_) {
+          return input_impl_->GetNext(ctx, out_tensors, end_of_sequence);
+        }
         TF_RETURN_IF_ERROR(writer_->status());
         if (cur_index_ >= kMaxItems) {
           // As a courtesy, close the [truncated] cache file.
@@ -445,7 +536,7 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         }
         filename_ = strings::StrCat(dataset()->filename_, "_", shard_id_);
         lockfile_ = strings::StrCat(filename_, kLockFileSuffix);
-        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        writer_ = dataset()->MakeWriter(filename_);
         return absl::OkStatus();
       }
 
@@ -456,12 +547,35 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
           *end_of_sequence = true;
           return absl::OkStatus();
         }
-        if (lockfile_created_) {
+        if (lockfile_created_ || pass_through_) {
           return absl::OkStatus();
         }
 
         // Perform rudimentary locking to help catch concurrent writes to the
         // same cache files.
+        Env* env = dataset()->env_;
+        bool lockfile_exists = env->FileExists(lockfile_).ok();
+        string lockfile_contents;
+        if (lockfile_exists) {
+          ReadFileToString(env, lockfile_, &lockfile_contents).IgnoreError();
+          if (IsStaleLockFile(env, lockfile_contents)) {
+            LOG(WARNING) << "Removing the cache lockfile " << lockfile_
+                         << " of a process that no longer runs: "
+                         << lockfile_contents;
+            TF_RETURN_IF_ERROR(env->DeleteFile(lockfile_));
+            lockfile_exists = false;
+          }
+        }
+
+        // In a shared cache, another process may be writing the cache, or
+        // merging its shards. Pass the input through in the meantime, and
+        // read the cache on the next epoch.
+        if (dataset()->shared_ &&
+            (env->FileExists(MetaFilename(filename_)).ok() ||
+             lockfile_exists)) {
+          StartPassThrough();
+          return absl::OkStatus();
+        }
 
         // 1. Check that a checkpoint for the shard has not already been
         // written.
@@ -474,29 +588,23 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
 
         // 2. Check that there isn't a concurrent iterator that is writing
         // to cache.
-        if (dataset()->env_->FileExists(lockfile_).ok()) {
-          // Attempt to read the contents of the lockfile.
-          char contents_scratch[151] = {0};  // Initialize all to 0.
-          StringPiece contents;
-          std::unique_ptr<RandomAccessFile> file;
-          if (dataset()->env_->NewRandomAccessFile(lockfile_, &file).ok()) {
-            file->Read(0, 150, &contents, contents_scratch).IgnoreError();
-          }
-          return errors::AlreadyExists(
-              "There appears to be a concurrent caching iterator running - "
-              "cache lockfile already exists ('",
-              lockfile_,
-              "'). If you are sure no other running TF computations are "
-              "using this cache prefix, delete the lockfile and "
-              "re-initialize the iterator. Lockfile contents: ",
-              contents);
+        if (lockfile_exists) {
+          return ConcurrentWriterError(lockfile_contents);
         }
-        // Create the file, and write some basic contents.
-        std::unique_ptr<WritableFile> lockfile;
+        // Create the file, and record its owner.
+        const string contents = LockFileContents(env);
+        bool acquired;
         TF_RETURN_IF_ERROR(
-            dataset()->env_->NewWritableFile(lockfile_, &lockfile));
-        TF_RETURN_IF_ERROR(lockfile->Append(
-            strings::StrCat(kCreatedAt, ": ", EnvTime::NowSeconds())));
+            CreateLockFile(env, lockfile_, contents, &acquired));
+        if (!acquired) {
+          string other_contents;
+          ReadFileToString(env, lockfile_, &other_contents).IgnoreError();
+          if (!dataset()->shared_) {
+            return ConcurrentWriterError(other_contents);
+          }
+          StartPassThrough();
+          return absl::OkStatus();
+        }
 
         // At this point we know that
         // 1. There is no conflicting checkpoint with prefix `filename_`.
@@ -507,11 +615,30 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         // conditions are not met since BundleWriter's constructor creates
         // new temp files which can delete the temp files created by a
         // BundleWriter in another Session.
-        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        writer_ = dataset()->MakeWriter(filename_);
         lockfile_created_ = true;
         return absl::OkStatus();
       }
 
+      void StartPassThrough() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        LOG(INFO) << "Another process is writing the cache "
+                  << dataset()->filename_
+                  << ", reading its input without caching.";
+        pass_through_ = true;
+      }
+
+      Status ConcurrentWriterError(StringPiece lockfile_contents)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        return errors::AlreadyExists(
+            "There appears to be a concurrent caching iterator running - "
+            "cache lockfile already exists ('",
+            lockfile_,
+            "'). If you are sure no other running TF computations are "
+            "using this cache prefix, delete the lockfile and "
+            "re-initialize the iterator. Lockfile contents: ",
+            lockfile_contents);
+      }
+
       Status Finish() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         iteration_completed_ = true;
         // Flush the current bundle.
@@ -554,6 +681,8 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
       string lockfile_ TF_GUARDED_BY(mu_);
       bool lockfile_created_ TF_GUARDED_BY(mu_);
       bool iteration_completed_ TF_GUARDED_BY(mu_);
+      // Whether another process is writing the shared cache.
+      bool pass_through_ TF_GUARDED_BY(mu_) = false;
     };  // FileWriterIterator
 
     class FileReaderIterator : public DatasetIterator<FileDatasetBase> {
@@ -593,7 +722,16 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
           }
           StringPiece key = reader_.key();
           DCHECK_EQ(key, dataset()->FormatName(cur_index_, i));
-          TF_RETURN_IF_ERROR(reader_.ReadCurrent(&(*out_tensors)[i]));
+          bool mapped = false;
+          if (dataset()->shared_) {
+            // The processes reading a shared cache share its pages, instead
+            // of each having a copy.
+            TF_RETURN_IF_ERROR(reader_.LookupMapped(
+                string(key), &(*out_tensors)[i], &mapped));
+          }
+          if (!mapped) {
+            TF_RETURN_IF_ERROR(reader_.ReadCurrent(&(*out_tensors)[i]));
+          }
           TF_RETURN_IF_ERROR(reader_.status());
         }
         cur_index_++;
@@ -677,6 +815,7 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
   };  // FileIterator
 
   Env* const env_;
+  const bool shared_;
   const size_t num_tensors_;
   const size_t tensor_index_padding_size_;
   static constexpr size_t kMaxItems = 10000000;  // 10 million
@@ -802,6 +941,8 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
     explicit MemoryIterator(const Params& params, MemoryCache* cache)
         : DatasetIterator<MemoryDatasetBase>(params), cache_(cache) {}
 
+    bool SymbolicCheckpointCompatible() const override { return true; }
+
     Status Initialize(IteratorContext* ctx) override {
       mutex_lock l(mu_);
       return InitializeIterator(ctx);
@@ -824,10 +965,13 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
     Status SaveInternal(SerializationContext* ctx,
                         IteratorStateWriter* writer) override {
       mutex_lock l(mu_);
-      if (cache_->IsCompleted()) {
+      // With symbolic checkpointing, `writer` already contains the completed
+      // cache if it was written by a previous save.
+      if (cache_->IsCompleted() && !completed_cache_checkpointed_) {
         TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCacheCompleted, ""));
         TF_RETURN_IF_ERROR(
             WriteElementsToCheckpoint(writer, prefix(), cache_->data()));
+        completed_cache_checkpointed_ = ctx->symbolic_checkpoint();
       }
       return SaveInput(ctx, writer, iterator_);
     }
@@ -837,6 +981,7 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       iterator_.reset();
       cache_->Reset();
+      completed_cache_checkpointed_ = false;
       if (reader->Contains(prefix(), kCacheCompleted)) {
         std::vector<std::vector<Tensor>> temp_cache;
         TF_RETURN_IF_ERROR(
@@ -853,6 +998,8 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       explicit MemoryWriterIterator(const Params& params, MemoryCache* cache)
           : DatasetIterator<MemoryDatasetBase>(params), cache_(cache) {}
 
+      bool SymbolicCheckpointCompatible() const override { return true; }
+
       ~MemoryWriterIterator() override {
         mutex_lock l(mu_);
         if (!temp_cache_.empty() && !cache_->IsCompleted()) {
@@ -900,8 +1047,16 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                           IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
         if (!cache_->IsCompleted()) {
-          TF_RETURN_IF_ERROR(
-              WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+          if (ctx->symbolic_checkpoint()) {
+            // `writer` already contains the elements checkpointed by the
+            // previous saves, so only the new elements are written.
+            TF_RETURN_IF_ERROR(AppendElementsToCheckpoint(
+                writer, prefix(), temp_cache_, num_checkpointed_elements_));
+            num_checkpointed_elements_ = temp_cache_.size();
+          } else {
+            TF_RETURN_IF_ERROR(
+                WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+          }
         }
         return SaveInput(ctx, writer, input_impl_);
       }
@@ -909,6 +1064,7 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       Status RestoreInternal(IteratorContext* ctx,
                              IteratorStateReader* reader) override {
         mutex_lock l(mu_);
+        num_checkpointed_elements_ = 0;
         if (!reader->Contains(prefix(), kCacheCompleted)) {
           TF_RETURN_IF_ERROR(
               ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache_));
@@ -921,6 +1077,9 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
       MemoryCache* const cache_ TF_GUARDED_BY(mu_);  // not owned.
       std::vector<std::vector<Tensor>> temp_cache_ TF_GUARDED_BY(mu_);
+      // Number of elements of `temp_cache_` written by the previous symbolic
+      // checkpoint saves.
+      size_t num_checkpointed_elements_ TF_GUARDED_BY(mu_) = 0;
     };  // MemoryWriterIterator
 
     class MemoryReaderIterator : public DatasetIterator<MemoryDatasetBase> {
@@ -930,6 +1089,8 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
             cache_(cache),
             index_(0) {}
 
+      bool SymbolicCheckpointCompatible() const override { return true; }
+
       Status Initialize(IteratorContext* ctx) override {
         // The memory allocated for the cache is owned by the parent
         // dataset but performance modeling uses the iterator abstraction and
@@ -1015,6 +1176,8 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
     mutex mu_;
     MemoryCache* cache_ TF_GUARDED_BY(mu_);  // not owned.
     std::unique_ptr<IteratorBase> iterator_ TF_GUARDED_BY(mu_);
+    // Whether the completed cache has been written to the symbolic checkpoint.
+    bool completed_cache_checkpointed_ TF_GUARDED_BY(mu_) = false;
   };  // MemoryIterator
 
   mutable mutex mu_;
@@ -11,13 +11,16 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/cache_dataset_ops.h"
 
+#include <cstdlib>
 #include <string>
 #include <utility>
 
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/tensor_bundle/naming.h"
 
 namespace tensorflow {
 namespace data {
@@ -204,6 +207,93 @@ TEST_P(ParameterizedGetNextTest, GetNext) {
 INSTANTIATE_TEST_SUITE_P(CacheDatasetOpTest, ParameterizedGetNextTest,
                          ::testing::ValuesIn(GetNextTestCases()));
 
+TEST_F(CacheDatasetOpTest, SharedFileCache) {
+  setenv("TF_DATA_SHARED_FILE_CACHE", "true", /*overwrite=*/1);
+  auto dataset_params = CacheDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  // Makes a new writer for each pass below.
+  iterator_.reset();
+  const std::vector<Tensor> expected_outputs = CreateTensors<int64_t>(
+      TensorShape({3, 1}), {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}});
+  auto get_all = [this, &dataset_params]() {
+    TF_CHECK_OK(dataset_->MakeIterator(iterator_ctx_.get(), /*parent=*/nullptr,
+                                       dataset_params.iterator_prefix(),
+                                       &iterator_));
+    std::vector<Tensor> out_tensors;
+    bool end_of_sequence = false;
+    while (!end_of_sequence) {
+      std::vector<Tensor> next;
+      TF_CHECK_OK(
+          iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+      out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+    }
+    return out_tensors;
+  };
+
+  // Another process is writing the cache, so the input is passed through.
+  const string lockfile = strings::StrCat(cache_filename_, "_0.lockfile");
+  TF_ASSERT_OK(WriteStringToFile(device_->env(), lockfile, "other"));
+  TF_EXPECT_OK(ExpectEqual(get_all(), expected_outputs,
+                           /*compare_order=*/true));
+  TF_EXPECT_OK(device_->env()->FileExists(lockfile));
+  EXPECT_FALSE(
+      device_->env()->FileExists(MetaFilename(cache_filename_)).ok());
+  TF_ASSERT_OK(device_->env()->DeleteFile(lockfile));
+
+  // Writes the cache, then reads it.
+  TF_EXPECT_OK(ExpectEqual(get_all(), expected_outputs,
+                           /*compare_order=*/true));
+  TF_EXPECT_OK(device_->env()->FileExists(MetaFilename(cache_filename_)));
+  TF_EXPECT_OK(ExpectEqual(get_all(), expected_outputs,
+                           /*compare_order=*/true));
+  unsetenv("TF_DATA_SHARED_FILE_CACHE");
+}
+
+TEST_F(CacheDatasetOpTest, StaleLockFile) {
+  if (!device_->env()->FileExists("/proc/self").ok()) {
+    GTEST_SKIP() << "Stale lockfiles are only detected through procfs.";
+  }
+  auto dataset_params = CacheDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  // No process can have this id, since pid_max is at most 2^22.
+  const string lockfile = strings::StrCat(cache_filename_, "_0.lockfile");
+  TF_ASSERT_OK(WriteStringToFile(
+      device_->env(), lockfile,
+      strings::StrCat("Created at: 0\nHost: ", port::Hostname(),
+                      "\nPid: 999999999\n")));
+  std::vector<Tensor> out_tensors;
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+    out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+  }
+  TF_EXPECT_OK(ExpectEqual(out_tensors,
+                           CreateTensors<int64_t>(
+                               TensorShape({3, 1}),
+                               {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}}),
+                           /*compare_order=*/true));
+  TF_EXPECT_OK(device_->env()->FileExists(MetaFilename(cache_filename_)));
+}
+
+TEST_F(CacheDatasetOpTest, LockFileOfRunningProcess) {
+  auto dataset_params = CacheDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  const string lockfile = strings::StrCat(cache_filename_, "_0.lockfile");
+  TF_ASSERT_OK(WriteStringToFile(
+      device_->env(), lockfile,
+      strings::StrCat("Created at: 0\nHost: ", port::Hostname(),
+                      "\nPid: ", device_->env()->GetProcessId(), "\n")));
+  std::vector<Tensor> out_tensors;
+  bool end_of_sequence = false;
+  Status s =
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence);
+  EXPECT_TRUE(errors::IsAlreadyExists(s)) << s;
+  TF_EXPECT_OK(device_->env()->FileExists(lockfile));
+  TF_ASSERT_OK(device_->env()->DeleteFile(lockfile));
+}
+
 TEST_F(CacheDatasetOpTest, DatasetNodeName) {
   auto dataset_params = CacheDatasetParams1();
   TF_ASSERT_OK(Initialize(dataset_params));
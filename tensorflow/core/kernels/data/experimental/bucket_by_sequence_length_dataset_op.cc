@@ -0,0 +1,511 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/bucket_by_sequence_length_dataset_op.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/util/batch_util.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+
+// See documentation in ../../ops/experimental_dataset_ops.cc for a high-level
+// description of the following op.
+
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kDatasetType;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kInputDataset;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kBucketBoundaries;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kBucketBatchSizes;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kPaddedShapes;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kPaddingValues;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kDropRemainder;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kLengthComponent;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kToutputTypes;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kOutputShapes;
+/* static */ constexpr const char* const
+    BucketBySequenceLengthDatasetOp::kNumPaddedShapes;
+
+namespace {
+
+constexpr char kInputExhausted[] = "input_exhausted";
+constexpr char kFlushIndex[] = "flush_index";
+constexpr char kBucket[] = "bucket";
+
+// Pads the `batch` elements to a common shape and copies them into one output
+// tensor per tuple component.
+Status CopyPaddedBatch(IteratorContext* ctx,
+                       const std::vector<std::vector<Tensor>>& batch,
+                       const DataTypeVector& output_dtypes,
+                       const std::vector<PartialTensorShape>& padded_shapes,
+                       const std::vector<Tensor>& padding_values,
+                       std::vector<Tensor>* out_tensors) {
+  const int64_t num_batch_elements = batch.size();
+  for (size_t component_index = 0; component_index < padded_shapes.size();
+       ++component_index) {
+    const PartialTensorShape& padded_shape = padded_shapes[component_index];
+    TensorShape component_shape;
+    for (int dim = 0; dim < padded_shape.dims(); ++dim) {
+      TF_RETURN_IF_ERROR(component_shape.AddDimWithStatus(
+          std::max<int64_t>(padded_shape.dim_size(dim), 0)));
+    }
+    for (const std::vector<Tensor>& element : batch) {
+      const TensorShape& element_shape = element[component_index].shape();
+      if (element_shape.dims() != padded_shape.dims()) {
+        return errors::InvalidArgument(
+            "All elements must have the same rank as the padded shape for "
+            "component ",
+            component_index, ": expected rank ", padded_shape.dims(),
+            " but got element with rank ", element_shape.dims());
+      }
+      for (int dim = 0; dim < padded_shape.dims(); ++dim) {
+        if (padded_shape.dim_size(dim) == -1) {
+          component_shape.set_dim(
+              dim,
+              std::max(component_shape.dim_size(dim),
+                       element_shape.dim_size(dim)));
+        } else if (element_shape.dim_size(dim) > padded_shape.dim_size(dim)) {
+          return errors::DataLoss(
+              "Attempted to pad to a smaller size than the input element.");
+        }
+      }
+    }
+
+    TensorShape batch_component_shape({num_batch_elements});
+    batch_component_shape.AppendShape(component_shape);
+    AllocatorAttributes attr;
+    attr.set_gpu_compatible(true);
+    out_tensors->emplace_back(ctx->allocator(attr),
+                              output_dtypes[component_index],
+                              batch_component_shape);
+    Tensor& batch_component = out_tensors->back();
+    TF_RETURN_IF_ERROR(batch_util::SetElementZero(
+        &batch_component, padding_values[component_index]));
+    for (int64_t i = 0; i < num_batch_elements; ++i) {
+      const Tensor& element = batch[i][component_index];
+      if (element.shape() == component_shape) {
+        TF_RETURN_IF_ERROR(
+            batch_util::CopyElementToSlice(element, &batch_component, i));
+      } else {
+        TF_RETURN_IF_ERROR(
+            batch_util::CopyElementToLargerSlice(element, &batch_component, i));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+class BucketBySequenceLengthDatasetOp::Dataset : public DatasetBase {
+ public:
+  Dataset(OpKernelContext* ctx, const DatasetBase* input,
+          std::vector<int64_t> bucket_boundaries,
+          std::vector<int64_t> bucket_batch_sizes, int64_t length_component,
+          bool drop_remainder, std::vector<PartialTensorShape> padded_shapes,
+          std::vector<Tensor> padding_values)
+      : DatasetBase(DatasetContext(ctx)),
+        input_(input),
+        bucket_boundaries_(std::move(bucket_boundaries)),
+        bucket_batch_sizes_(std::move(bucket_batch_sizes)),
+        length_component_(length_component),
+        drop_remainder_(drop_remainder),
+        padded_shapes_(std::move(padded_shapes)),
+        padding_values_(std::move(padding_values)) {
+    input_->Ref();
+    output_shapes_.reserve(padded_shapes_.size());
+    for (const PartialTensorShape& padded_shape : padded_shapes_) {
+      output_shapes_.push_back(
+          PartialTensorShape({-1}).Concatenate(padded_shape));
+    }
+  }
+
+  ~Dataset() override { input_->Unref(); }
+
+  std::unique_ptr<IteratorBase> MakeIteratorInternal(
+      const string& prefix) const override {
+    return std::make_unique<Iterator>(Iterator::Params{
+        this, name_utils::IteratorPrefix(kDatasetType, prefix)});
+  }
+
+  const DataTypeVector& output_dtypes() const override {
+    return input_->output_dtypes();
+  }
+
+  const std::vector<PartialTensorShape>& output_shapes() const override {
+    return output_shapes_;
+  }
+
+  string DebugString() const override {
+    return name_utils::DatasetDebugString(kDatasetType);
+  }
+
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    int64_t n = input_->Cardinality(options);
+    if (n == kInfiniteCardinality) {
+      return n;
+    }
+    return kUnknownCardinality;
+  }
+
+  Status InputDatasets(std::vector<const DatasetBase*>* inputs) const override {
+    inputs->push_back(input_);
+    return absl::OkStatus();
+  }
+
+  Status CheckExternalState() const override {
+    return input_->CheckExternalState();
+  }
+
+ protected:
+  Status AsGraphDefInternal(SerializationContext* ctx,
+                            DatasetGraphDefBuilder* b,
+                            Node** output) const override {
+    Node* input_graph_node = nullptr;
+    TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_graph_node));
+    Node* bucket_boundaries = nullptr;
+    TF_RETURN_IF_ERROR(b->AddVector(bucket_boundaries_, &bucket_boundaries));
+    Node* bucket_batch_sizes = nullptr;
+    TF_RETURN_IF_ERROR(b->AddVector(bucket_batch_sizes_, &bucket_batch_sizes));
+
+    std::vector<Node*> padded_shapes;
+    padded_shapes.reserve(padded_shapes_.size());
+    for (const PartialTensorShape& padded_shape : padded_shapes_) {
+      Node* node;
+      Tensor t(DT_INT64, TensorShape({padded_shape.dims()}));
+      for (int j = 0; j < padded_shape.dims(); ++j) {
+        t.vec<int64_t>()(j) = padded_shape.dim_size(j);
+      }
+      TF_RETURN_IF_ERROR(b->AddTensor(t, &node));
+      padded_shapes.push_back(node);
+    }
+
+    std::vector<Node*> padding_values;
+    padding_values.reserve(padding_values_.size());
+    for (const Tensor& t : padding_values_) {
+      Node* node;
+      TF_RETURN_IF_ERROR(b->AddTensor(t, &node));
+      padding_values.push_back(node);
+    }
+
+    Node* drop_remainder = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(drop_remainder_, &drop_remainder));
+
+    AttrValue length_component;
+    b->BuildAttrValue(length_component_, &length_component);
+    AttrValue output_types;
+    b->BuildAttrValue(output_dtypes(), &output_types);
+    AttrValue N;
+    b->BuildAttrValue<int64_t>(padded_shapes_.size(), &N);
+
+    TF_RETURN_IF_ERROR(b->AddDataset(
+        this,
+        {{0, input_graph_node},
+         {1, bucket_boundaries},
+         {2, bucket_batch_sizes},
+         {5, drop_remainder}},
+        {{3, padded_shapes}, {4, padding_values}},
+        {{kLengthComponent, length_component},
+         {kToutputTypes, output_types},
+         {kNumPaddedShapes, N}},
+        output));
+    return absl::OkStatus();
+  }
+
+ private:
+  class Iterator : public DatasetIterator<Dataset> {
+   public:
+    explicit Iterator(const Params& params)
+        : DatasetIterator<Dataset>(params),
+          buckets_(params.dataset->bucket_batch_sizes_.size()) {}
+
+    Status Initialize(IteratorContext* ctx) override {
+      return dataset()->input_->MakeIterator(ctx, this, prefix(), &input_impl_);
+    }
+
+    Status GetNextInternal(IteratorContext* ctx,
+                           std::vector<Tensor>* out_tensors,
+                           bool* end_of_sequence) override {
+      std::vector<std::vector<Tensor>> batch;
+      {
+        mutex_lock l(mu_);
+        TF_RETURN_IF_ERROR(GetNextBatch(ctx, batch));
+      }
+      if (batch.empty()) {
+        *end_of_sequence = true;
+        return absl::OkStatus();
+      }
+      for (const std::vector<Tensor>& element : batch) {
+        RecordBufferDequeue(ctx, element);
+      }
+      *end_of_sequence = false;
+      return CopyPaddedBatch(ctx, batch, dataset()->output_dtypes(),
+                             dataset()->padded_shapes_,
+                             dataset()->padding_values_, out_tensors);
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeUnknownRatioNode(std::move(args));
+    }
+
+    Status SaveInternal(SerializationContext* ctx,
+                        IteratorStateWriter* writer) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          prefix(), kInputExhausted, static_cast<int64_t>(!input_impl_)));
+      if (input_impl_) {
+        TF_RETURN_IF_ERROR(SaveInput(ctx, writer, input_impl_));
+      }
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kFlushIndex,
+                                             static_cast<int64_t>(flush_index_)));
+      for (size_t i = 0; i < buckets_.size(); ++i) {
+        TF_RETURN_IF_ERROR(WriteElementsToCheckpoint(
+            writer, absl::StrCat(prefix(), "::", kBucket, "_", i),
+            buckets_[i]));
+      }
+      return absl::OkStatus();
+    }
+
+    Status RestoreInternal(IteratorContext* ctx,
+                           IteratorStateReader* reader) override {
+      mutex_lock l(mu_);
+      int64_t input_exhausted;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kInputExhausted, &input_exhausted));
+      if (static_cast<bool>(input_exhausted)) {
+        input_impl_.reset();
+      } else {
+        TF_RETURN_IF_ERROR(
+            dataset()->input_->MakeIterator(ctx, this, prefix(), &input_impl_));
+        TF_RETURN_IF_ERROR(RestoreInput(ctx, reader, input_impl_));
+      }
+      int64_t flush_index;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kFlushIndex, &flush_index));
+      flush_index_ = flush_index;
+      for (size_t i = 0; i < buckets_.size(); ++i) {
+        buckets_[i].clear();
+        TF_RETURN_IF_ERROR(ReadElementsFromCheckpoint(
+            ctx, reader, absl::StrCat(prefix(), "::", kBucket, "_", i),
+            &buckets_[i]));
+        for (const std::vector<Tensor>& element : buckets_[i]) {
+          RecordBufferEnqueue(ctx, element);
+        }
+      }
+      return absl::OkStatus();
+    }
+
+   private:
+    // Reads input elements into their buckets until a bucket is full and
+    // moves that bucket into `batch`. After the input is exhausted, moves the
+    // remaining partial batches into `batch` in bucket order. `batch` is left
+    // empty at the end of the sequence.
+    Status GetNextBatch(IteratorContext* ctx,
+                        std::vector<std::vector<Tensor>>& batch)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      while (input_impl_) {
+        std::vector<Tensor> element;
+        bool end_of_input = false;
+        TF_RETURN_IF_ERROR(input_impl_->GetNext(ctx, &element, &end_of_input));
+        if (end_of_input) {
+          input_impl_.reset();
+          break;
+        }
+        TF_ASSIGN_OR_RETURN(size_t bucket, GetBucket(element));
+        RecordBufferEnqueue(ctx, element);
+        buckets_[bucket].push_back(std::move(element));
+        if (buckets_[bucket].size() ==
+            dataset()->bucket_batch_sizes_[bucket]) {
+          batch.swap(buckets_[bucket]);
+          return absl::OkStatus();
+        }
+      }
+      while (flush_index_ < buckets_.size()) {
+        std::vector<std::vector<Tensor>>& bucket = buckets_[flush_index_++];
+        if (dataset()->drop_remainder_) {
+          for (const std::vector<Tensor>& element : bucket) {
+            RecordBufferDequeue(ctx, element);
+          }
+          bucket.clear();
+        } else if (!bucket.empty()) {
+          batch.swap(bucket);
+          return absl::OkStatus();
+        }
+      }
+      return absl::OkStatus();
+    }
+
+    // Returns the bucket of `element`, based on the size of the first
+    // dimension of its `length_component` component.
+    StatusOr<size_t> GetBucket(const std::vector<Tensor>& element) const {
+      const Tensor& component = element[dataset()->length_component_];
+      if (component.dims() < 1) {
+        return errors::InvalidArgument(
+            "Component ", dataset()->length_component_,
+            " must have rank of at least 1 to determine the sequence length, "
+            "but got shape ",
+            component.shape().DebugString());
+      }
+      const std::vector<int64_t>& boundaries = dataset()->bucket_boundaries_;
+      return std::upper_bound(boundaries.begin(), boundaries.end(),
+                              component.dim_size(0)) -
+             boundaries.begin();
+    }
+
+    mutex mu_;
+    std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
+    // The elements buffered for each bucket.
+    std::vector<std::vector<std::vector<Tensor>>> buckets_ TF_GUARDED_BY(mu_);
+    // The next bucket to flush after the input is exhausted.
+    size_t flush_index_ TF_GUARDED_BY(mu_) = 0;
+  };
+
+  const DatasetBase* const input_;
+  const std::vector<int64_t> bucket_boundaries_;
+  const std::vector<int64_t> bucket_batch_sizes_;
+  const int64_t length_component_;
+  const bool drop_remainder_;
+  const std::vector<PartialTensorShape> padded_shapes_;
+  const std::vector<Tensor> padding_values_;
+  std::vector<PartialTensorShape> output_shapes_;
+};
+
+BucketBySequenceLengthDatasetOp::BucketBySequenceLengthDatasetOp(
+    OpKernelConstruction* ctx)
+    : UnaryDatasetOpKernel(ctx) {
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kLengthComponent, &length_component_));
+}
+
+void BucketBySequenceLengthDatasetOp::MakeDataset(OpKernelContext* ctx,
+                                                  DatasetBase* input,
+                                                  DatasetBase** output) {
+  const size_t num_components = input->output_shapes().size();
+  OP_REQUIRES(ctx, length_component_ < static_cast<int64_t>(num_components),
+              errors::InvalidArgument(
+                  "`length_component` must be smaller than the number of "
+                  "components in the input dataset's elements (",
+                  num_components, "), got ", length_component_));
+
+  std::vector<int64_t> bucket_boundaries;
+  OP_REQUIRES_OK(ctx, ParseVectorArgument<int64_t>(ctx, kBucketBoundaries,
+                                                   &bucket_boundaries));
+  for (size_t i = 1; i < bucket_boundaries.size(); ++i) {
+    OP_REQUIRES(ctx, bucket_boundaries[i - 1] < bucket_boundaries[i],
+                errors::InvalidArgument(
+                    "`bucket_boundaries` must be strictly increasing."));
+  }
+  std::vector<int64_t> bucket_batch_sizes;
+  OP_REQUIRES_OK(ctx, ParseVectorArgument<int64_t>(ctx, kBucketBatchSizes,
+                                                   &bucket_batch_sizes));
+  OP_REQUIRES(ctx, bucket_batch_sizes.size() == bucket_boundaries.size() + 1,
+              errors::InvalidArgument(
+                  "`bucket_batch_sizes` must have one more element than "
+                  "`bucket_boundaries`, got ",
+                  bucket_batch_sizes.size(), " and ",
+                  bucket_boundaries.size()));
+  for (int64_t batch_size : bucket_batch_sizes) {
+    OP_REQUIRES(ctx, batch_size > 0,
+                errors::InvalidArgument(
+                    "Bucket batch sizes must be greater than zero."));
+  }
+
+  bool drop_remainder = false;
+  OP_REQUIRES_OK(
+      ctx, ParseScalarArgument<bool>(ctx, kDropRemainder, &drop_remainder));
+
+  OpInputList padded_shape_tensors;
+  OP_REQUIRES_OK(ctx, ctx->input_list(kPaddedShapes, &padded_shape_tensors));
+  OP_REQUIRES(ctx, padded_shape_tensors.size() == num_components,
+              errors::InvalidArgument("Number of padded shapes (",
+                                      padded_shape_tensors.size(),
+                                      ") must match the number of components "
+                                      "in the input dataset's elements (",
+                                      num_components, ")"));
+  std::vector<PartialTensorShape> padded_shapes;
+  padded_shapes.reserve(num_components);
+  for (const Tensor& padded_shape_t : padded_shape_tensors) {
+    OP_REQUIRES(ctx, TensorShapeUtils::IsVector(padded_shape_t.shape()),
+                errors::InvalidArgument("All padded shapes must be vectors"));
+    PartialTensorShape padded_shape;
+    OP_REQUIRES_OK(ctx, PartialTensorShape::MakePartialShape(
+                            padded_shape_t.vec<int64_t>().data(),
+                            padded_shape_t.NumElements(), &padded_shape));
+    padded_shapes.push_back(std::move(padded_shape));
+  }
+
+  OpInputList padding_values_list;
+  OP_REQUIRES_OK(ctx, ctx->input_list(kPaddingValues, &padding_values_list));
+  OP_REQUIRES(ctx, padding_values_list.size() == num_components,
+              errors::InvalidArgument(
+                  "Number of padding values (", padding_values_list.size(),
+                  ") must match the number of components in the input "
+                  "dataset's elements (",
+                  num_components, ")"));
+  std::vector<Tensor> padding_values;
+  padding_values.reserve(num_components);
+  for (int i = 0; i < padding_values_list.size(); ++i) {
+    const Tensor& padding_value_t = padding_values_list[i];
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(padding_value_t.shape()),
+                errors::InvalidArgument("All padding values must be scalars"));
+    OP_REQUIRES(ctx, padding_value_t.dtype() == input->output_dtypes()[i],
+                errors::InvalidArgument(
+                    "Mismatched type between padding value ", i,
+                    " and input dataset's component ", i, ": ",
+                    DataTypeString(padding_value_t.dtype()), " vs. ",
+                    DataTypeString(input->output_dtypes()[i])));
+    padding_values.push_back(tensor::DeepCopy(padding_value_t));
+  }
+
+  *output = new Dataset(ctx, input, std::move(bucket_boundaries),
+                        std::move(bucket_batch_sizes), length_component_,
+                        drop_remainder, std::move(padded_shapes),
+                        std::move(padding_values));
+}
+
+namespace {
+REGISTER_KERNEL_BUILDER(
+    Name("BucketBySequenceLengthDataset").Device(DEVICE_CPU),
+    BucketBySequenceLengthDatasetOp);
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,222 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/bucket_by_sequence_length_dataset_op.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/dataset_test_base.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+namespace {
+
+constexpr char kNodeName[] = "bucket_by_sequence_length_dataset";
+
+class BucketBySequenceLengthDatasetParams : public DatasetParams {
+ public:
+  template <typename T>
+  BucketBySequenceLengthDatasetParams(
+      T input_dataset_params, std::vector<int64_t> bucket_boundaries,
+      std::vector<int64_t> bucket_batch_sizes,
+      std::vector<Tensor> padded_shapes, std::vector<Tensor> padding_values,
+      bool drop_remainder, int64_t length_component,
+      DataTypeVector output_dtypes,
+      std::vector<PartialTensorShape> output_shapes, string node_name)
+      : DatasetParams(std::move(output_dtypes), std::move(output_shapes),
+                      std::move(node_name)),
+        bucket_boundaries_(std::move(bucket_boundaries)),
+        bucket_batch_sizes_(std::move(bucket_batch_sizes)),
+        padded_shapes_(std::move(padded_shapes)),
+        padding_values_(std::move(padding_values)),
+        drop_remainder_(drop_remainder),
+        length_component_(length_component) {
+    input_dataset_params_.push_back(std::make_unique<T>(input_dataset_params));
+    iterator_prefix_ =
+        name_utils::IteratorPrefix(input_dataset_params.dataset_type(),
+                                   input_dataset_params.iterator_prefix());
+  }
+
+  std::vector<Tensor> GetInputTensors() const override {
+    std::vector<Tensor> input_tensors = {
+        CreateTensor<int64_t>(
+            TensorShape({static_cast<int64_t>(bucket_boundaries_.size())}),
+            bucket_boundaries_),
+        CreateTensor<int64_t>(
+            TensorShape({static_cast<int64_t>(bucket_batch_sizes_.size())}),
+            bucket_batch_sizes_)};
+    for (const Tensor& padded_shape : padded_shapes_) {
+      input_tensors.push_back(padded_shape);
+    }
+    for (const Tensor& padding_value : padding_values_) {
+      input_tensors.push_back(padding_value);
+    }
+    input_tensors.push_back(
+        CreateTensor<bool>(TensorShape({}), {drop_remainder_}));
+    return input_tensors;
+  }
+
+  Status GetInputNames(std::vector<string>* input_names) const override {
+    *input_names = {BucketBySequenceLengthDatasetOp::kInputDataset,
+                    BucketBySequenceLengthDatasetOp::kBucketBoundaries,
+                    BucketBySequenceLengthDatasetOp::kBucketBatchSizes};
+    for (int i = 0; i < padded_shapes_.size(); ++i) {
+      input_names->push_back(
+          absl::StrCat(BucketBySequenceLengthDatasetOp::kPaddedShapes, "_", i));
+    }
+    for (int i = 0; i < padding_values_.size(); ++i) {
+      input_names->push_back(absl::StrCat(
+          BucketBySequenceLengthDatasetOp::kPaddingValues, "_", i));
+    }
+    input_names->push_back(BucketBySequenceLengthDatasetOp::kDropRemainder);
+    return absl::OkStatus();
+  }
+
+  Status GetAttributes(AttributeVector* attr_vector) const override {
+    *attr_vector = {{"length_component", length_component_},
+                    {"Toutput_types", output_dtypes_},
+                    {"output_shapes", output_shapes_},
+                    {"N", static_cast<int64_t>(padded_shapes_.size())},
+                    {"metadata", ""}};
+    return absl::OkStatus();
+  }
+
+  string dataset_type() const override {
+    return BucketBySequenceLengthDatasetOp::kDatasetType;
+  }
+
+ private:
+  std::vector<int64_t> bucket_boundaries_;
+  std::vector<int64_t> bucket_batch_sizes_;
+  std::vector<Tensor> padded_shapes_;
+  std::vector<Tensor> padding_values_;
+  bool drop_remainder_;
+  int64_t length_component_;
+};
+
+class BucketBySequenceLengthDatasetOpTest : public DatasetOpsTestBase {};
+
+// Returns the sequences [0, 1], [2, 3], [4, 5], [6], [7], [8], and [9].
+ConcatenateDatasetParams VariableLengthParams() {
+  auto tensor_slice_dataset_params_0 = TensorSliceDatasetParams(
+      /*components=*/CreateTensors<int64_t>(TensorShape{3, 2},
+                                            {{0, 1, 2, 3, 4, 5}}),
+      /*node_name=*/"tensor_slice_0");
+  auto tensor_slice_dataset_params_1 = TensorSliceDatasetParams(
+      /*components=*/CreateTensors<int64_t>(TensorShape{4, 1}, {{6, 7, 8, 9}}),
+      /*node_name=*/"tensor_slice_1");
+  return ConcatenateDatasetParams(std::move(tensor_slice_dataset_params_0),
+                                  std::move(tensor_slice_dataset_params_1),
+                                  /*output_dtypes=*/{DT_INT64},
+                                  /*output_shapes=*/{PartialTensorShape({-1})},
+                                  /*node_name=*/"concatenate");
+}
+
+BucketBySequenceLengthDatasetParams BucketParams(
+    bool drop_remainder, std::vector<int64_t> bucket_batch_sizes = {3, 2}) {
+  return BucketBySequenceLengthDatasetParams(
+      VariableLengthParams(),
+      /*bucket_boundaries=*/{2},
+      /*bucket_batch_sizes=*/std::move(bucket_batch_sizes),
+      /*padded_shapes=*/{CreateTensor<int64_t>(TensorShape{1}, {-1})},
+      /*padding_values=*/{CreateTensor<int64_t>(TensorShape{}, {-1})},
+      drop_remainder,
+      /*length_component=*/0,
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({-1, -1})}, kNodeName);
+}
+
+// Elements of length 1 go to the first bucket and elements of length 2 go to
+// the second bucket.
+std::vector<Tensor> ExpectedOutputs(bool drop_remainder) {
+  std::vector<Tensor> outputs = {
+      CreateTensor<int64_t>(TensorShape{2, 2}, {0, 1, 2, 3}),
+      CreateTensor<int64_t>(TensorShape{3, 1}, {6, 7, 8})};
+  if (!drop_remainder) {
+    outputs.push_back(CreateTensor<int64_t>(TensorShape{1, 1}, {9}));
+    outputs.push_back(CreateTensor<int64_t>(TensorShape{1, 2}, {4, 5}));
+  }
+  return outputs;
+}
+
+std::vector<GetNextTestCase<BucketBySequenceLengthDatasetParams>>
+GetNextTestCases() {
+  return {{/*dataset_params=*/BucketParams(/*drop_remainder=*/false),
+           /*expected_outputs=*/ExpectedOutputs(/*drop_remainder=*/false),
+           /*compare_order=*/true},
+          {/*dataset_params=*/BucketParams(/*drop_remainder=*/true),
+           /*expected_outputs=*/ExpectedOutputs(/*drop_remainder=*/true),
+           /*compare_order=*/true}};
+}
+
+ITERATOR_GET_NEXT_TEST_P(BucketBySequenceLengthDatasetOpTest,
+                         BucketBySequenceLengthDatasetParams,
+                         GetNextTestCases())
+
+TEST_F(BucketBySequenceLengthDatasetOpTest, FlushesBucketsAtEndOfInput) {
+  auto dataset_params = BucketParams(/*drop_remainder=*/false,
+                                     /*bucket_batch_sizes=*/{7, 7});
+  TF_ASSERT_OK(Initialize(dataset_params));
+  // Neither bucket fills up, so both are flushed in bucket order. Elements in
+  // the first bucket are not padded to the length of the second bucket.
+  TF_ASSERT_OK(CheckIteratorGetNext(
+      {CreateTensor<int64_t>(TensorShape{4, 1}, {6, 7, 8, 9}),
+       CreateTensor<int64_t>(TensorShape{3, 2}, {0, 1, 2, 3, 4, 5})},
+      /*compare_order=*/true));
+}
+
+TEST_F(BucketBySequenceLengthDatasetOpTest, DatasetNodeName) {
+  auto dataset_params = BucketParams(/*drop_remainder=*/false);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetNodeName(dataset_params.node_name()));
+}
+
+TEST_F(BucketBySequenceLengthDatasetOpTest, DatasetOutputShapes) {
+  auto dataset_params = BucketParams(/*drop_remainder=*/false);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetOutputShapes({PartialTensorShape({-1, -1})}));
+}
+
+TEST_F(BucketBySequenceLengthDatasetOpTest, Cardinality) {
+  auto dataset_params = BucketParams(/*drop_remainder=*/false);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetCardinality(kUnknownCardinality));
+}
+
+std::vector<IteratorSaveAndRestoreTestCase<BucketBySequenceLengthDatasetParams>>
+IteratorSaveAndRestoreTestCases() {
+  return {{/*dataset_params=*/BucketParams(/*drop_remainder=*/false),
+           /*breakpoints=*/{0, 1, 3, 5},
+           /*expected_outputs=*/ExpectedOutputs(/*drop_remainder=*/false)}};
+}
+
+ITERATOR_SAVE_AND_RESTORE_TEST_P(BucketBySequenceLengthDatasetOpTest,
+                                 BucketBySequenceLengthDatasetParams,
+                                 IteratorSaveAndRestoreTestCases())
+
+TEST_F(BucketBySequenceLengthDatasetOpTest, InvalidBucketBatchSizes) {
+  auto dataset_params = BucketParams(/*drop_remainder=*/false,
+                                     /*bucket_batch_sizes=*/{3});
+  EXPECT_EQ(Initialize(dataset_params).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
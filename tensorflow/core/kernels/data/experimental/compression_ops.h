@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_EXPERIMENTAL_COMPRESSION_OPS_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_EXPERIMENTAL_COMPRESSION_OPS_H_
 
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/framework/dataset.h"
 
 namespace tensorflow {
@@ -26,6 +27,11 @@ class CompressElementOp : public OpKernel {
   explicit CompressElementOp(OpKernelConstruction* ctx);
 
   void Compute(OpKernelContext* ctx) override;
+
+ private:
+  // Skips compressing the elements of pipelines whose elements don't
+  // compress, such as JPEG bytes.
+  AdaptiveElementCompressor compressor_;
 };
 
 class UncompressElementOp : public OpKernel {
@@ -120,6 +120,12 @@ constexpr int kDefaultCyclePrefetchFactor = 2;
 // match the behavior of the original implementation.
 constexpr double kDefaultPerIteratorPrefetchFactor = 2.0L;
 
+// When the `deterministic_interleave_readahead` experiment is enabled,
+// `kReorderBufferFactor * cycle_length * buffer_output_elements` is the number
+// of results that deterministic current cycle elements may buffer beyond
+// `buffer_output_elements` while the iterator is blocked on a slow element.
+constexpr int kReorderBufferFactor = 1;
+
 // Period between reporting dataset statistics.
 constexpr int kStatsReportingPeriodMillis = 1000;
 
@@ -365,6 +371,13 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
               params.dataset->num_parallel_calls_, mu_,
               num_parallel_calls_cond_var_)),
           deterministic_(deterministic),
+          reorder_buffer_capacity_(
+              deterministic &&
+                      GetExperiments().contains(
+                          "deterministic_interleave_readahead")
+                  ? kReorderBufferFactor * params.dataset->cycle_length_ *
+                        params.dataset->buffer_output_elements_
+                  : 0),
           current_elements_(params.dataset->cycle_length_) {}
 
     ~ParallelInterleaveIterator() override { CancelThreads(/*wait=*/true); }
@@ -431,12 +444,14 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           if (deterministic_) {
             VLOG(3) << "Blocked waiting for element "
                     << current_elements_[cycle_index_]->id;
+            StartReadahead();
             current_elements_[cycle_index_]->cond_var.wait(l);
           } else {
             any_element_available_cond_var_.wait(l);
           }
           RecordStart(ctx);
         }
+        blocked_ = false;
         if (cancelled_) {
           return errors::Cancelled("Iterator was cancelled");
         }
@@ -1109,7 +1124,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         mutex_lock l(*mu_);
         element->results.push_back(std::move(result));
         NotifyElementUpdate(*element);
-        if (element->results.size() == dataset()->buffer_output_elements_) {
+        if (!HasBufferSpace(*element)) {
           break;
         }
       }
@@ -1202,8 +1217,50 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       if (!element->initialized) {
         return true;
       }
-      return element->iterator &&
-             element->results.size() < dataset()->buffer_output_elements_;
+      return element->iterator && HasBufferSpace(*element);
+    }
+
+    // Returns true if `element` may buffer another result. Besides its own
+    // `buffer_output_elements` results, a current cycle element may use the
+    // shared reorder buffer while `GetNext` is blocked on another element, so
+    // that a slow element does not stall the reads of the rest of the cycle.
+    bool HasBufferSpace(const Element& element)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (element.results.size() < dataset()->buffer_output_elements_) {
+        return true;
+      }
+      return blocked_ && element.cycle_index != -1 &&
+             ReorderBufferSize() < reorder_buffer_capacity_;
+    }
+
+    // Returns the number of results buffered by current cycle elements beyond
+    // their `buffer_output_elements`.
+    int64_t ReorderBufferSize() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      int64_t size = 0;
+      for (int64_t i = 0; i <= last_valid_current_element_; ++i) {
+        const std::shared_ptr<Element>& element = current_elements_[i];
+        if (element && element->results.size() >
+                           dataset()->buffer_output_elements_) {
+          size += element->results.size() - dataset()->buffer_output_elements_;
+        }
+      }
+      return size;
+    }
+
+    // Wakes up current workers to read ahead into the reorder buffer while
+    // `GetNext` is blocked on the element at `cycle_index_`.
+    void StartReadahead() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (reorder_buffer_capacity_ == 0 || blocked_) {
+        return;
+      }
+      blocked_ = true;
+      for (int64_t i = 0; i <= last_valid_current_element_; ++i) {
+        if (i != cycle_index_ && NeedsProcessing(current_elements_[i]) &&
+            !current_elements_[i]->active) {
+          elements_to_process_.push_back(i);
+        }
+      }
+      current_workers_cond_var_.notify_all();
     }
 
     inline void IncrementCurrentWorkers() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -1672,6 +1729,14 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
     // Determines whether outputs can be produced in deterministic order.
     const bool deterministic_;
 
+    // Maximum number of results current cycle elements may buffer beyond
+    // `buffer_output_elements` while `GetNext` is blocked. Results are still
+    // returned in deterministic order. 0 disables reading ahead.
+    const int64_t reorder_buffer_capacity_;
+
+    // Whether `GetNext` is blocked waiting for a deterministic result.
+    bool blocked_ TF_GUARDED_BY(mu_) = false;
+
     // Controls cancellation of `input_impl_`. Must be ordered before
     // `input_impl_` so that `input_impl_` is destroyed first.
     std::unique_ptr<CancellationManager> cancellation_manager_;
@@ -729,6 +729,25 @@ TEST_F(ParallelInterleaveDatasetOpTest, InputCycleLengthPreservedInGraphDef) {
   unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
 }
 
+// Test that reading ahead into the reorder buffer preserves the deterministic
+// output order.
+TEST_F(ParallelInterleaveDatasetOpTest, DeterministicReadaheadPreservesOrder) {
+  setenv("TF_JOB_NAME", "test_job", /*overwrite=*/1);
+  setenv("TF_TASK_ID", "0", /*overwrite=*/1);
+  setenv("TF_DATA_EXPERIMENT_OPT_IN", "deterministic_interleave_readahead",
+         /*overwrite=*/1);
+  auto dataset_params = LongCycleDeterministicParams();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_EXPECT_OK(CheckIteratorGetNext(
+      CreateTensors<tstring>(
+          TensorShape{1},
+          {{"a"}, {"d"}, {"g"}, {"b"}, {"e"}, {"h"}, {"c"}, {"f"}, {"i"}}),
+      /*compare_order=*/true));
+  unsetenv("TF_JOB_NAME");
+  unsetenv("TF_TASK_ID");
+  unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
+}
+
 TEST_F(ParallelInterleaveDatasetOpTest, DatasetNodeName) {
   auto dataset_params = ParallelInterleaveDatasetParams1();
   TF_ASSERT_OK(Initialize(dataset_params));
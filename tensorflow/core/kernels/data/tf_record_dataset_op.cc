@@ -14,7 +14,17 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/read_ahead_file.h"
+#include "tensorflow/core/data/tfrecord_index.h"
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
@@ -25,6 +35,8 @@ limitations under the License.
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -45,6 +57,42 @@ constexpr char kGcsFsPrefix[] = "gs://";
 constexpr char kS3FsPrefix[] = "s3://";
 constexpr int64_t kCloudTpuBlockSize = 127LL << 20;  // 127MB.
 constexpr int64_t kS3BlockSize = kCloudTpuBlockSize;
+// The maximum number of files whose record index is built in parallel.
+constexpr int kMaxIndexThreads = 16;
+// The maximum number of files kept open for random access.
+constexpr size_t kMaxOpenFiles = 16;
+
+// The number of buffers each reader keeps reading ahead, from
+// TF_DATA_RECORD_READ_AHEAD_BUFFERS. 0, the default, reads each buffer when
+// it is needed.
+int64_t RecordReadAheadBuffers() {
+  static const int64_t buffers = [] {
+    int64_t value;
+    if (!ReadInt64FromEnvVar("TF_DATA_RECORD_READ_AHEAD_BUFFERS", 0, &value)
+             .ok() ||
+        value < 0) {
+      LOG(ERROR) << "Invalid TF_DATA_RECORD_READ_AHEAD_BUFFERS, reading "
+                    "without read-ahead";
+      value = 0;
+    }
+    return value;
+  }();
+  return buffers;
+}
+
+// Whether datasets of uncompressed files support random access through a
+// record-offset index, from TF_DATA_TFRECORD_INDEX. The index of each file is
+// read from its sidecar file `<filename>.index` if it exists, and built by
+// scanning the record headers of the file otherwise. This is read for each
+// dataset, since it decides whether the dataset has a known cardinality.
+bool UseRecordIndex() {
+  bool value;
+  if (!ReadBoolFromEnvVar("TF_DATA_TFRECORD_INDEX", false, &value).ok()) {
+    LOG(ERROR) << "Invalid TF_DATA_TFRECORD_INDEX, reading without an index";
+    value = false;
+  }
+  return value;
+}
 
 bool is_cloud_tpu_gcs_fs() {
 #if (defined(PLATFORM_CLOUD_TPU) && defined(TPU_GCS_FS)) || \
@@ -58,19 +106,37 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<string> filenames,
                    const string& compression_type, int64_t buffer_size,
-                   std::vector<int64_t> byte_offsets, int op_version)
+                   std::vector<int64_t> byte_offsets, int op_version,
+                   bool use_index)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
             compression_type)),
         byte_offsets_(std::move(byte_offsets)),
-        op_version_(op_version) {
+        op_version_(op_version),
+        use_index_(use_index) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
   }
 
+  absl::Status RandomIndexingCompatible() const override {
+    if (!use_index_) {
+      return absl::FailedPreconditionError(
+          absl::StrCat(type_string(),
+                       " supports random access only with a record index. "
+                       "Set TF_DATA_TFRECORD_INDEX=true to use one."));
+    }
+    if (options_.compression_type != io::RecordReaderOptions::NONE) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          type_string(), " does not support random access of compressed "
+                         "files, got compression type ",
+          std::string(compression_type_)));
+    }
+    return absl::OkStatus();
+  }
+
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
       const string& prefix) const override {
     name_utils::IteratorPrefixParams params;
@@ -102,6 +168,25 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
   Status CheckExternalState() const override { return absl::OkStatus(); }
 
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    if (!RandomIndexingCompatible().ok()) {
+      return kUnknownCardinality;
+    }
+    Status s = EnsureIndex(Env::Default());
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to index the records of " << DebugString()
+                   << ": " << s;
+      return kUnknownCardinality;
+    }
+    return record_starts_.back();
+  }
+
+  Status Get(OpKernelContext* ctx, int64 index,
+             std::vector<Tensor>* out_tensors) const override {
+    TF_RETURN_IF_ERROR(CheckRandomAccessCompatible(index));
+    return GetRecord(ctx->env(), index, out_tensors);
+  }
+
  protected:
   Status AsGraphDefInternal(SerializationContext* ctx,
                             DatasetGraphDefBuilder* b,
@@ -130,11 +215,17 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     Status GetNextInternal(IteratorContext* ctx,
                            std::vector<Tensor>* out_tensors,
                            bool* end_of_sequence) override {
+      if (ctx->index_mapper() != nullptr) {
+        return Get(ctx, out_tensors, end_of_sequence);
+      }
       out_tensors->reserve(1);
       mutex_lock l(mu_);
       do {
         // We are currently processing a file, so try to read the next record.
         if (reader_) {
+          // The record is copied out of the read buffer rather than viewed in
+          // place: copies of a `tstring` view are views too, so a record
+          // batched or cached downstream would outlive the buffer.
           out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
                                     TensorShape({}));
           Status s =
@@ -214,6 +305,29 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       } while (true);
     }
 
+    Status Get(IteratorContext* ctx, std::vector<Tensor>* out_tensors,
+               bool* end_of_sequence) {
+      int64_t element_count;
+      {
+        mutex_lock l(mu_);
+        if (element_count_ >= dataset()->Cardinality()) {
+          *end_of_sequence = true;
+          return absl::OkStatus();
+        }
+        element_count = element_count_++;
+      }
+      std::optional<int64_t> output_index =
+          ctx->index_mapper()(element_count);
+      if (!output_index.has_value()) {
+        *end_of_sequence = true;
+        return absl::OkStatus();
+      }
+      *end_of_sequence = false;
+      // The record is read outside of `mu_` so that the positional reads of
+      // concurrent callers overlap.
+      return dataset()->GetRecord(ctx->env(), *output_index, out_tensors);
+    }
+
    protected:
     std::shared_ptr<model::Node> CreateNode(
         IteratorContext* ctx, model::Node::Args args) const override {
@@ -236,6 +350,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     Status RestoreInternal(IteratorContext* ctx,
                            IteratorStateReader* reader) override {
       mutex_lock l(mu_);
+      if (ctx->element_count().has_value()) {
+        element_count_ = *(ctx->element_count());
+        return absl::OkStatus();
+      }
       ResetStreamsLocked();
       int64_t current_file_index;
       TF_RETURN_IF_ERROR(
@@ -263,6 +381,11 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
           TranslateFileName(dataset()->filenames_[current_file_index_]),
           &file_));
+      if (RecordReadAheadBuffers() > 0 && dataset()->options_.buffer_size > 0) {
+        file_ = std::make_unique<ReadAheadFile>(
+            std::move(file_), dataset()->options_.buffer_size,
+            RecordReadAheadBuffers(), ReadAheadFile::SharedThreadPool());
+      }
       reader_ = std::make_unique<io::SequentialRecordReader>(
           file_.get(), dataset()->options_);
       if (!dataset()->byte_offsets_.empty()) {
@@ -280,6 +403,9 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
     mutex mu_;
     size_t current_file_index_ TF_GUARDED_BY(mu_) = 0;
+    // Count of elements produced by this iterator when it runs in the random
+    // access mode.
+    int64_t element_count_ TF_GUARDED_BY(mu_) = 0;
 
     // `reader_` will borrow the object that `file_` points to, so
     // we must destroy `reader_` before `file_`.
@@ -287,11 +413,141 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
   };
 
+  // Builds or loads the record index of each file the first time it is
+  // called. The index is not modified afterwards.
+  Status EnsureIndex(Env* env) const {
+    mutex_lock l(index_mu_);
+    if (index_built_) {
+      return index_status_;
+    }
+    index_built_ = true;
+    std::vector<std::vector<uint64>> offsets(filenames_.size());
+    std::vector<Status> statuses(filenames_.size());
+    {
+      thread::ThreadPool pool(
+          env, ThreadOptions(), "tf_record_index",
+          std::max(1, std::min<int>(kMaxIndexThreads, filenames_.size())),
+          /*low_latency_hint=*/false);
+      for (size_t i = 0; i < filenames_.size(); ++i) {
+        pool.Schedule([this, env, i, &offsets, &statuses]() {
+          const uint64 start_offset =
+              byte_offsets_.empty() ? 0 : byte_offsets_[i];
+          statuses[i] = LoadOrBuildTFRecordIndex(
+              env, TranslateFileName(filenames_[i]), start_offset,
+              &offsets[i]);
+        });
+      }
+    }
+    for (const Status& status : statuses) {
+      index_status_.Update(status);
+    }
+    if (!index_status_.ok()) {
+      return index_status_;
+    }
+    record_starts_.reserve(filenames_.size() + 1);
+    record_starts_.push_back(0);
+    for (const std::vector<uint64>& file_offsets : offsets) {
+      record_starts_.push_back(record_starts_.back() + file_offsets.size());
+    }
+    record_offsets_ = std::move(offsets);
+    return absl::OkStatus();
+  }
+
+  // Reads the record at `index` with a positional read, so that any number of
+  // callers may read records concurrently.
+  Status GetRecord(Env* env, int64_t index,
+                   std::vector<Tensor>* out_tensors) const {
+    TF_RETURN_IF_ERROR(EnsureIndex(env));
+    if (index < 0 || index >= record_starts_.back()) {
+      return errors::OutOfRange("Index out of range [0, ",
+                                record_starts_.back(), "): ", index);
+    }
+    const size_t file_index =
+        std::upper_bound(record_starts_.begin(), record_starts_.end(), index) -
+        record_starts_.begin() - 1;
+    std::shared_ptr<RandomAccessFile> file;
+    TF_RETURN_IF_ERROR(GetFile(env, file_index, &file));
+    uint64 offset =
+        record_offsets_[file_index][index - record_starts_[file_index]];
+    io::RecordReader reader(file.get());
+    Tensor record(DT_STRING, TensorShape({}));
+    TF_RETURN_IF_ERROR(reader.ReadRecord(&offset, &record.scalar<tstring>()()));
+    static monitoring::CounterCell* bytes_counter =
+        metrics::GetTFDataBytesReadCounter(kDatasetType);
+    bytes_counter->IncrementBy(record.scalar<tstring>()().size());
+    out_tensors->clear();
+    out_tensors->push_back(std::move(record));
+    return absl::OkStatus();
+  }
+
+  // Returns the file at `file_index` for random access. The `kMaxOpenFiles`
+  // most recently used files are kept open; an evicted file stays open until
+  // the reads holding it finish.
+  Status GetFile(Env* env, size_t file_index,
+                 std::shared_ptr<RandomAccessFile>* file) const {
+    if (FindOpenFile(file_index, file)) {
+      return absl::OkStatus();
+    }
+    // Opening may be slow, e.g. on remote file systems, so it doesn't hold
+    // `files_mu_`. If a concurrent read opened the same file meanwhile, its
+    // file is kept and `new_file` is dropped.
+    std::unique_ptr<RandomAccessFile> new_file;
+    TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
+        TranslateFileName(filenames_[file_index]), &new_file));
+    mutex_lock l(files_mu_);
+    if (FindOpenFileLocked(file_index, file)) {
+      return absl::OkStatus();
+    }
+    open_files_.emplace_front(file_index, std::move(new_file));
+    if (open_files_.size() > kMaxOpenFiles) {
+      open_files_.pop_back();
+    }
+    *file = open_files_.front().second;
+    return absl::OkStatus();
+  }
+
+  // Sets `file` to the open file at `file_index` and marks it as the most
+  // recently used. Returns false if the file isn't open.
+  bool FindOpenFile(size_t file_index,
+                    std::shared_ptr<RandomAccessFile>* file) const {
+    mutex_lock l(files_mu_);
+    return FindOpenFileLocked(file_index, file);
+  }
+
+  bool FindOpenFileLocked(size_t file_index,
+                          std::shared_ptr<RandomAccessFile>* file) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(files_mu_) {
+    for (auto it = open_files_.begin(); it != open_files_.end(); ++it) {
+      if (it->first == file_index) {
+        open_files_.splice(open_files_.begin(), open_files_, it);
+        *file = it->second;
+        return true;
+      }
+    }
+    return false;
+  }
+
   const std::vector<string> filenames_;
   const tstring compression_type_;
   io::RecordReaderOptions options_;
   const std::vector<int64_t> byte_offsets_;
   const int op_version_;
+  const bool use_index_;
+
+  mutable mutex index_mu_;
+  mutable bool index_built_ TF_GUARDED_BY(index_mu_) = false;
+  mutable Status index_status_ TF_GUARDED_BY(index_mu_);
+  // The offsets of the records of each file, and the index of the first
+  // record of each file followed by the number of records. Set once by
+  // `EnsureIndex`.
+  mutable std::vector<std::vector<uint64>> record_offsets_;
+  mutable std::vector<int64_t> record_starts_;
+
+  mutable mutex files_mu_;
+  // The files opened for random access, shared by concurrent reads, from the
+  // most to the least recently used.
+  mutable std::list<std::pair<size_t, std::shared_ptr<RandomAccessFile>>>
+      open_files_ TF_GUARDED_BY(files_mu_);
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
@@ -362,7 +618,8 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
   }
 
   *output = new Dataset(ctx, std::move(filenames), compression_type,
-                        buffer_size, std::move(byte_offsets), op_version_);
+                        buffer_size, std::move(byte_offsets), op_version_,
+                        UseRecordIndex());
 }
 
 namespace {
@@ -11,8 +11,10 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
+#include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/lib/io/record_reader.h"
@@ -300,6 +302,35 @@ TEST_F(TFRecordDatasetOpTest, Cardinality) {
   TF_ASSERT_OK(CheckDatasetCardinality(kUnknownCardinality));
 }
 
+TEST_F(TFRecordDatasetOpTest, RandomAccessWithRecordIndex) {
+  setenv("TF_DATA_TFRECORD_INDEX", "true", /*overwrite=*/1);
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  unsetenv("TF_DATA_TFRECORD_INDEX");
+  TF_ASSERT_OK(dataset_->RandomIndexingCompatible());
+  TF_ASSERT_OK(CheckDatasetCardinality(6));
+  std::vector<std::string> expected = {"1", "22", "333", "a", "bb", "ccc"};
+  for (int i = expected.size() - 1; i >= 0; --i) {
+    std::vector<Tensor> out_tensors;
+    TF_ASSERT_OK(dataset_->Get(dataset_ctx_.get(), i, &out_tensors));
+    ASSERT_EQ(out_tensors.size(), 1);
+    EXPECT_EQ(out_tensors[0].scalar<tstring>()(), expected[i]);
+  }
+  std::vector<Tensor> out_tensors;
+  EXPECT_TRUE(errors::IsOutOfRange(
+      dataset_->Get(dataset_ctx_.get(), expected.size(), &out_tensors)));
+}
+
+TEST_F(TFRecordDatasetOpTest, NoRandomAccessOfCompressedFiles) {
+  setenv("TF_DATA_TFRECORD_INDEX", "true", /*overwrite=*/1);
+  auto dataset_params = TFRecordDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  unsetenv("TF_DATA_TFRECORD_INDEX");
+  EXPECT_TRUE(
+      errors::IsFailedPrecondition(dataset_->RandomIndexingCompatible()));
+  TF_ASSERT_OK(CheckDatasetCardinality(kUnknownCardinality));
+}
+
 TEST_F(TFRecordDatasetOpTest, IteratorOutputDtypes) {
   auto dataset_params = TFRecordDatasetParams1();
   TF_ASSERT_OK(Initialize(dataset_params));
@@ -20,6 +20,7 @@ limitations under the License.
 #define EIGEN_USE_THREADS
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/function.h"
@@ -28,10 +29,12 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/platform/casts.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 typedef Eigen::GpuDevice GPUDevice;
@@ -41,6 +44,30 @@ typedef std::vector<Tensor> TensorVec;
 
 namespace {
 
+auto* branches_taken = monitoring::Counter<2>::New(
+    "/tensorflow/core/functional_ops/branches_taken",
+    "The number of times each branch of an If or Case op was taken.", "node",
+    "branch");
+
+// Returns true if the branches taken by If and Case ops are counted per node.
+// This is meant to profile which branches a deployment actually takes over a
+// warmup period, and is off by default since it adds a metric cell per node.
+bool ShouldProfileBranches() {
+  static const bool profile_branches = [] {
+    bool profile = false;
+    Status status = ReadBoolFromEnvVar("TF_PROFILE_FUNCTIONAL_BRANCHES",
+                                       /*default_val=*/false, &profile);
+    if (!status.ok()) {
+      LOG(ERROR) << "Invalid TF_PROFILE_FUNCTIONAL_BRANCHES, branches are not "
+                    "profiled: "
+                 << status;
+      return false;
+    }
+    return profile;
+  }();
+  return profile_branches;
+}
+
 // Helper to instantiate function "func" in the library "lib".
 Status Instantiate(FunctionLibraryRuntime* lib, const NameAttrList& func,
                    FunctionLibraryRuntime::Handle* handle) {
@@ -132,6 +159,10 @@ class IfOp : public AsyncOpKernel {
                 errors::Internal("No function library"));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("then_branch", &then_func_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("else_branch", &else_func_));
+    if (ShouldProfileBranches()) {
+      then_taken_ = branches_taken->GetCell(name(), "then");
+      else_taken_ = branches_taken->GetCell(name(), "else");
+    }
   }
 
   ~IfOp() override {
@@ -161,12 +192,16 @@ class IfOp : public AsyncOpKernel {
                          done);
     bool cond;
     OP_REQUIRES_OK(ctx, ToBool({ctx->input(0)}, &cond));
+    monitoring::CounterCell* taken = cond ? then_taken_ : else_taken_;
+    if (taken != nullptr) taken->IncrementBy(1);
     (new State(this, ctx, cond, then_handle, else_handle, done))->Start();
   }
 
  private:
   NameAttrList then_func_;
   NameAttrList else_func_;
+  monitoring::CounterCell* then_taken_ = nullptr;
+  monitoring::CounterCell* else_taken_ = nullptr;
 
   mutex mu_;
 
@@ -273,6 +308,12 @@ class CaseOp : public AsyncOpKernel {
     OP_REQUIRES(ctx, ctx->function_library() != nullptr,
                 errors::Internal("No function library"));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("branches", &branch_funcs_));
+    if (ShouldProfileBranches()) {
+      for (int i = 0; i < branch_funcs_.size(); ++i) {
+        branches_taken_.push_back(
+            branches_taken->GetCell(name(), absl::StrCat(i)));
+      }
+    }
   }
 
   ~CaseOp() override {
@@ -300,6 +341,13 @@ class CaseOp : public AsyncOpKernel {
                       errors::InvalidArgument("branch_index must be scalar"),
                       done);
     int32_t branch = branch_index.scalar<int32>()();
+    if (!branches_taken_.empty()) {
+      // The last branch is the default branch.
+      const bool is_default =
+          branch < 0 || branch >= static_cast<int32_t>(branches_taken_.size());
+      branches_taken_[is_default ? branches_taken_.size() - 1 : branch]
+          ->IncrementBy(1);
+    }
 
     std::vector<FHandle> branch_handles(branch_funcs_.size());
     OP_REQUIRES_OK_ASYNC(ctx, GetHandles(ctx, branch_handles), done);
@@ -308,6 +356,7 @@ class CaseOp : public AsyncOpKernel {
 
  private:
   std::vector<NameAttrList> branch_funcs_;
+  std::vector<monitoring::CounterCell*> branches_taken_;
   mutex mu_;
   std::unordered_map<FunctionLibraryRuntime*,
                      std::pair<std::vector<FHandle>,
@@ -13,8 +13,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
 
 #define EIGEN_USE_THREADS
 
@@ -38,11 +42,11 @@ limitations under the License.
 #include "tensorflow/core/kernels/cast_op.h"
 #include "tensorflow/core/kernels/fill_functor.h"
 #include "tensorflow/core/kernels/fused_batch_norm_op.h"
-#include "tensorflow/core/kernels/redux_functor.h"
 #include "tensorflow/core/kernels/transpose_functor.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_format.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 using CPUDevice = Eigen::ThreadPoolDevice;
@@ -91,6 +95,142 @@ struct FusedBatchNorm;
 template <typename Device, typename T, typename U>
 struct FusedBatchNormGrad;
 
+// The CPU functors view the input in NHWC format as a [rest_size, depth]
+// matrix. Per channel reductions are computed over fixed blocks of rows, so
+// that the result does not depend on the number of threads, and the blocks are
+// merged in order.
+constexpr int64_t kBatchNormBlockSize = 1 << 14;
+constexpr int64_t kBatchNormMinBlockRows = 64;
+
+inline int64_t BatchNormRowsPerBlock(int64_t depth) {
+  return std::max(kBatchNormMinBlockRows, kBatchNormBlockSize / depth);
+}
+
+// Runs `fn(start_row, limit_row)` over blocks of rows on the intra-op threads.
+template <typename Fn>
+void ForEachRowBlock(OpKernelContext* context, int64_t rest_size,
+                     int64_t depth, int64_t cost_per_element, const Fn& fn) {
+  const int64_t block_rows = BatchNormRowsPerBlock(depth);
+  const int64_t num_blocks = (rest_size + block_rows - 1) / block_rows;
+  auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+        block_rows * depth * cost_per_element,
+        [&](int64_t start, int64_t limit) {
+          for (int64_t block = start; block < limit; ++block) {
+            fn(block, block * block_rows,
+               std::min(rest_size, (block + 1) * block_rows));
+          }
+        });
+}
+
+// Computes the per channel mean and (biased) variance of `x` in a single pass
+// with Welford's algorithm.
+template <typename T, typename U>
+void ComputeChannelMoments(OpKernelContext* context, const T* x,
+                           int64_t rest_size, int64_t depth, U* mean,
+                           U* variance) {
+  const int64_t block_rows = BatchNormRowsPerBlock(depth);
+  const int64_t num_blocks = (rest_size + block_rows - 1) / block_rows;
+  std::vector<U> block_mean(num_blocks * depth, U(0));
+  std::vector<U> block_m2(num_blocks * depth, U(0));
+  ForEachRowBlock(
+      context, rest_size, depth, /*cost_per_element=*/6,
+      [&](int64_t block, int64_t start_row, int64_t limit_row) {
+        U* m = &block_mean[block * depth];
+        U* m2 = &block_m2[block * depth];
+        for (int64_t row = start_row; row < limit_row; ++row) {
+          const U inv_count = U(1) / static_cast<U>(row - start_row + 1);
+          const T* x_row = x + row * depth;
+          for (int64_t c = 0; c < depth; ++c) {
+            const U value = static_cast<U>(x_row[c]);
+            const U delta = value - m[c];
+            m[c] += delta * inv_count;
+            m2[c] += delta * (value - m[c]);
+          }
+        }
+      });
+
+  // Merges the blocks with the pairwise update of Chan et al.
+  std::vector<U> m2(depth, U(0));
+  std::fill_n(mean, depth, U(0));
+  int64_t count = 0;
+  for (int64_t block = 0; block < num_blocks; ++block) {
+    const int64_t block_count =
+        std::min(rest_size, (block + 1) * block_rows) - block * block_rows;
+    const int64_t new_count = count + block_count;
+    const U weight = static_cast<U>(block_count) / static_cast<U>(new_count);
+    const U m2_weight = static_cast<U>(count) * weight;
+    const U* m = &block_mean[block * depth];
+    const U* bm2 = &block_m2[block * depth];
+    for (int64_t c = 0; c < depth; ++c) {
+      const U delta = m[c] - mean[c];
+      mean[c] += delta * weight;
+      m2[c] += bm2[c] + delta * delta * m2_weight;
+    }
+    count = new_count;
+  }
+  const U inv_rest_size = U(1) / static_cast<U>(rest_size);
+  for (int64_t c = 0; c < depth; ++c) variance[c] = m2[c] * inv_rest_size;
+}
+
+// Computes the per channel `sum(y_backprop)` and
+// `sum(y_backprop * (x - mean))` in a single pass.
+template <typename T, typename U>
+void ComputeChannelBackpropSums(OpKernelContext* context, const T* y_backprop,
+                                const T* x, const U* mean, int64_t rest_size,
+                                int64_t depth, U* sum_y_backprop,
+                                U* sum_y_backprop_x_centered) {
+  const int64_t block_rows = BatchNormRowsPerBlock(depth);
+  const int64_t num_blocks = (rest_size + block_rows - 1) / block_rows;
+  std::vector<U> block_sums(2 * num_blocks * depth, U(0));
+  ForEachRowBlock(
+      context, rest_size, depth, /*cost_per_element=*/5,
+      [&](int64_t block, int64_t start_row, int64_t limit_row) {
+        U* sum_dy = &block_sums[2 * block * depth];
+        U* sum_dy_xc = sum_dy + depth;
+        for (int64_t row = start_row; row < limit_row; ++row) {
+          const T* dy_row = y_backprop + row * depth;
+          const T* x_row = x + row * depth;
+          for (int64_t c = 0; c < depth; ++c) {
+            const U dy = static_cast<U>(dy_row[c]);
+            sum_dy[c] += dy;
+            sum_dy_xc[c] += dy * (static_cast<U>(x_row[c]) - mean[c]);
+          }
+        }
+      });
+
+  std::fill_n(sum_y_backprop, depth, U(0));
+  std::fill_n(sum_y_backprop_x_centered, depth, U(0));
+  for (int64_t block = 0; block < num_blocks; ++block) {
+    const U* sum_dy = &block_sums[2 * block * depth];
+    const U* sum_dy_xc = sum_dy + depth;
+    for (int64_t c = 0; c < depth; ++c) {
+      sum_y_backprop[c] += sum_dy[c];
+      sum_y_backprop_x_centered[c] += sum_dy_xc[c];
+    }
+  }
+}
+
+// Computes `y = x * channel_scale + channel_offset` in a single pass.
+template <typename T, typename U>
+void ScaleAndShiftChannels(OpKernelContext* context, const T* x,
+                           const U* channel_scale, const U* channel_offset,
+                           int64_t rest_size, int64_t depth, T* y) {
+  auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers, rest_size,
+        depth * 3, [&](int64_t start_row, int64_t limit_row) {
+          for (int64_t row = start_row; row < limit_row; ++row) {
+            const T* x_row = x + row * depth;
+            T* y_row = y + row * depth;
+            for (int64_t c = 0; c < depth; ++c) {
+              y_row[c] = static_cast<T>(static_cast<U>(x_row[c]) *
+                                            channel_scale[c] +
+                                        channel_offset[c]);
+            }
+          }
+        });
+}
+
 template <typename T, typename U>
 struct FusedBatchNorm<CPUDevice, T, U, /* is_training= */ true> {
   void operator()(OpKernelContext* context, const Tensor& x_input,
@@ -158,70 +298,50 @@ struct FusedBatchNorm<CPUDevice, T, U, /* is_training= */ true> {
       transformed_x = x_input;
       transformed_y = *y_output;
     }
-    typename TTypes<T, 4>::Tensor x(transformed_x.tensor<T, 4>());
     typename TTypes<U>::ConstVec scale(scale_input.vec<U>());
     typename TTypes<U>::ConstVec offset(offset_input.vec<U>());
     typename TTypes<U>::ConstVec old_mean(running_mean_input.vec<U>());
     typename TTypes<U>::ConstVec old_variance(running_variance_input.vec<U>());
-    typename TTypes<T, 4>::Tensor y(transformed_y.tensor<T, 4>());
     typename TTypes<U>::Vec new_mean(running_mean_output->vec<U>());
     typename TTypes<U>::Vec new_variance(running_var_output->vec<U>());
     typename TTypes<U>::Vec saved_batch_mean(saved_batch_mean_output->vec<U>());
     typename TTypes<U>::Vec saved_batch_var(saved_batch_var_output->vec<U>());
 
-    const CPUDevice& d = context->eigen_device<CPUDevice>();
-
-    const int depth = x.dimension(3);
-    const int size = x.size();
-    const int rest_size = size / depth;
-    Eigen::DSizes<Eigen::Index, 2> rest_by_depth(rest_size, depth);
-
-    Eigen::IndexList<Eigen::type2index<1>, Eigen::Index> one_by_depth;
-    one_by_depth.set(1, depth);
-    Eigen::IndexList<Eigen::type2index<0>> reduce_dims;
-    Eigen::IndexList<Eigen::Index, Eigen::type2index<1>> bcast_spec;
-    bcast_spec.set(0, rest_size);
-
-    auto x_rest_by_depth = x.reshape(rest_by_depth).template cast<U>();
-    const int rest_size_minus_one = (rest_size > 1) ? (rest_size - 1) : 1;
-    U rest_size_inv = static_cast<U>(1.0f / static_cast<U>(rest_size));
+    const int64_t depth = GetTensorDim(transformed_x, FORMAT_NHWC, 'C');
+    const int64_t rest_size = transformed_x.NumElements() / depth;
+    const int64_t rest_size_minus_one = (rest_size > 1) ? (rest_size - 1) : 1;
     // This adjustment is for Bessel's correction
     U rest_size_adjust =
         static_cast<U>(rest_size) / static_cast<U>(rest_size_minus_one);
 
-    Eigen::Tensor<U, 1, Eigen::RowMajor> batch_mean(depth);
-    Eigen::Tensor<U, 1, Eigen::RowMajor> batch_variance(depth);
-
-    batch_mean.device(d) = (x_rest_by_depth.sum(reduce_dims) * rest_size_inv);
-    auto x_centered = x_rest_by_depth -
-                      batch_mean.reshape(one_by_depth).broadcast(bcast_spec);
-
-    batch_variance.device(d) =
-        x_centered.square().sum(reduce_dims) * rest_size_inv;
-    auto scaling_factor = ((batch_variance + epsilon).rsqrt() * scale)
-                              .eval()
-                              .reshape(one_by_depth)
-                              .broadcast(bcast_spec);
-    auto x_scaled = x_centered * scaling_factor;
-    auto x_shifted =
-        (x_scaled + offset.reshape(one_by_depth).broadcast(bcast_spec))
-            .template cast<T>();
-
-    y.reshape(rest_by_depth).device(d) = x_shifted;
-    if (exponential_avg_factor == U(1.0)) {
-      saved_batch_var.device(d) = batch_variance;
-      saved_batch_mean.device(d) = batch_mean;
-      new_variance.device(d) = batch_variance * rest_size_adjust;
-      new_mean.device(d) = batch_mean;
-    } else {
-      U one_minus_factor = U(1) - exponential_avg_factor;
-      saved_batch_var.device(d) = batch_variance;
-      saved_batch_mean.device(d) = batch_mean;
-      new_variance.device(d) =
-          one_minus_factor * old_variance +
-          (exponential_avg_factor * rest_size_adjust) * batch_variance;
-      new_mean.device(d) =
-          one_minus_factor * old_mean + exponential_avg_factor * batch_mean;
+    // The batch statistics take one pass over `x`, and normalization another.
+    U* batch_mean = saved_batch_mean.data();
+    U* batch_variance = saved_batch_var.data();
+    ComputeChannelMoments(context, transformed_x.flat<T>().data(), rest_size,
+                          depth, batch_mean, batch_variance);
+
+    std::vector<U> channel_scale(depth);
+    std::vector<U> channel_offset(depth);
+    for (int64_t c = 0; c < depth; ++c) {
+      channel_scale[c] = scale(c) / std::sqrt(batch_variance[c] + epsilon);
+      channel_offset[c] = offset(c) - batch_mean[c] * channel_scale[c];
+    }
+    ScaleAndShiftChannels(context, transformed_x.flat<T>().data(),
+                          channel_scale.data(), channel_offset.data(),
+                          rest_size, depth, transformed_y.flat<T>().data());
+
+    const U one_minus_factor = U(1) - exponential_avg_factor;
+    for (int64_t c = 0; c < depth; ++c) {
+      if (exponential_avg_factor == U(1.0)) {
+        new_variance(c) = batch_variance[c] * rest_size_adjust;
+        new_mean(c) = batch_mean[c];
+      } else {
+        new_variance(c) =
+            one_minus_factor * old_variance(c) +
+            (exponential_avg_factor * rest_size_adjust) * batch_variance[c];
+        new_mean(c) = one_minus_factor * old_mean(c) +
+                      exponential_avg_factor * batch_mean[c];
+      }
     }
 
     if (tensor_format == FORMAT_NCHW) {
@@ -303,46 +423,33 @@ struct FusedBatchNorm<CPUDevice, T, U, /* is_training= */ false> {
       transformed_x = x_input;
       transformed_y = *y_output;
     }
-    typename TTypes<T, 4>::Tensor x(transformed_x.tensor<T, 4>());
     typename TTypes<U>::ConstVec scale(scale_input.vec<U>());
     typename TTypes<U>::ConstVec offset(offset_input.vec<U>());
     typename TTypes<U>::ConstVec estimated_mean(estimated_mean_input.vec<U>());
     typename TTypes<U>::ConstVec estimated_variance(
         estimated_variance_input.vec<U>());
-    typename TTypes<T, 4>::Tensor y(transformed_y.tensor<T, 4>());
     typename TTypes<U>::Vec batch_mean(batch_mean_output->vec<U>());
     typename TTypes<U>::Vec batch_variance(batch_var_output->vec<U>());
 
-    const CPUDevice& d = context->eigen_device<CPUDevice>();
-
-    const int depth = x.dimension(3);
+    const int64_t depth = GetTensorDim(transformed_x, FORMAT_NHWC, 'C');
     OP_REQUIRES(
         context, depth != 0,
         errors::Internal("The 4th element in the input shape cannot be 0."));
-    const int size = x.size();
-    const int rest_size = size / depth;
-    Eigen::DSizes<Eigen::Index, 2> rest_by_depth(rest_size, depth);
-    Eigen::IndexList<Eigen::type2index<1>, Eigen::Index> one_by_depth;
-    one_by_depth.set(1, depth);
-    Eigen::IndexList<Eigen::Index, Eigen::type2index<1>> bcast_spec;
-    bcast_spec.set(0, rest_size);
-
-    auto x_rest_by_depth = x.reshape(rest_by_depth).template cast<U>();
-    auto x_centered =
-        x_rest_by_depth -
-        estimated_mean.reshape(one_by_depth).broadcast(bcast_spec);
-    auto scaling_factor = ((estimated_variance + epsilon).rsqrt() * scale)
-                              .eval()
-                              .reshape(one_by_depth)
-                              .broadcast(bcast_spec);
-    auto x_scaled = x_centered * scaling_factor;
-    auto x_shifted =
-        (x_scaled + offset.reshape(one_by_depth).broadcast(bcast_spec))
-            .template cast<T>();
-
-    y.reshape(rest_by_depth).device(d) = x_shifted;
-    batch_mean.device(d) = estimated_mean;
-    batch_variance.device(d) = estimated_variance;
+    const int64_t rest_size = transformed_x.NumElements() / depth;
+
+    // Folds the estimated statistics into one multiply-add per element.
+    std::vector<U> channel_scale(depth);
+    std::vector<U> channel_offset(depth);
+    for (int64_t c = 0; c < depth; ++c) {
+      channel_scale[c] =
+          scale(c) / std::sqrt(estimated_variance(c) + epsilon);
+      channel_offset[c] = offset(c) - estimated_mean(c) * channel_scale[c];
+    }
+    ScaleAndShiftChannels(context, transformed_x.flat<T>().data(),
+                          channel_scale.data(), channel_offset.data(),
+                          rest_size, depth, transformed_y.flat<T>().data());
+    batch_mean = estimated_mean;
+    batch_variance = estimated_variance;
 
     if (tensor_format == FORMAT_NCHW) {
       // Perform NHWC to NCHW
@@ -424,14 +531,10 @@ struct FusedBatchNormGrad<CPUDevice, T, U> {
       transformed_x_input = x_input;
       transformed_x_backprop_output = *x_backprop_output;
     }
-    typename TTypes<T, 4>::Tensor y_backprop(
-        transformed_y_backprop_input.tensor<T, 4>());
-    typename TTypes<T, 4>::Tensor x(transformed_x_input.tensor<T, 4>());
     typename TTypes<U>::ConstVec scale(scale_input.vec<U>());
     typename TTypes<U>::ConstVec mean(mean_input.vec<U>());
     typename TTypes<U>::ConstVec variance(variance_input.vec<U>());
-    typename TTypes<T, 4>::Tensor x_backprop(
-        transformed_x_backprop_output.tensor<T, 4>());
+    typename TTypes<U>::Vec scale_backprop(scale_backprop_output->vec<U>());
     typename TTypes<U>::Vec offset_backprop(offset_backprop_output->vec<U>());
 
     // Note: the following formulas are used to compute the gradients for
@@ -442,100 +545,48 @@ struct FusedBatchNormGrad<CPUDevice, T, U> {
     // scale_backprop = sum(y_backprop *
     //                  (x - mean(x)) * rsqrt(variance + epsilon))
     // offset_backprop = sum(y_backprop)
-
-    const CPUDevice& d = context->eigen_device<CPUDevice>();
-    const int depth = x.dimension(3);
-    const int size = x.size();
-    const int rest_size = size / depth;
-    Eigen::DSizes<Eigen::Index, 2> rest_by_depth(rest_size, depth);
-    Eigen::IndexList<Eigen::type2index<1>, Eigen::Index> one_by_depth;
-    one_by_depth.set(1, depth);
-    Eigen::IndexList<Eigen::Index, Eigen::type2index<1>> bcast_spec;
-    bcast_spec.set(0, rest_size);
-
-    auto x_rest_by_depth = x.reshape(rest_by_depth).template cast<U>();
-    U rest_size_inv = static_cast<U>(1.0f / static_cast<U>(rest_size));
-
-    // Eigen is notoriously bad at reducing outer dimension, so we materialize
-    // all temporary tensors that require reduction, and then use Eigen redux
-    // functor, that is optimized for this particular task.
     //
-    // All reductions are of this type: [rest_size, depth] -> [depth].
-    using ScalarSum = Eigen::internal::scalar_sum_op<U>;
-    const functor::ReduceOuterDimensions<T, U, U, ScalarSum> redux_sum_t;
-    const functor::ReduceOuterDimensions<U, U, U, ScalarSum> redux_sum_u;
-
-    auto scratch_dtype = DataTypeToEnum<U>::value;
-
-    // Allocate a temporary workspace of [depth] shape.
-    Tensor scratch_one_by_depth;
-    OP_REQUIRES_OK(context, context->allocate_temp(scratch_dtype, {depth},
-                                                   &scratch_one_by_depth));
-
-    // Maybe allocate a temporary workspace of [rest_size, depth] shape.
-    Tensor scratch_rest_by_depth;
-    if (std::is_same<T, U>::value) {
-      OP_REQUIRES(context,
-                  scratch_rest_by_depth.CopyFrom(transformed_x_backprop_output,
-                                                 {rest_size, depth}),
-                  errors::Internal("Failed to copy a tensor"));
-    } else {
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(scratch_dtype, {rest_size, depth},
-                                            &scratch_rest_by_depth));
+    // Both sums take one pass over `y_backprop` and `x`, and `x_backprop`
+    // another.
+    const int64_t depth = GetTensorDim(transformed_x_input, FORMAT_NHWC, 'C');
+    const int64_t rest_size = transformed_x_input.NumElements() / depth;
+    const T* y_backprop = transformed_y_backprop_input.flat<T>().data();
+    const T* x = transformed_x_input.flat<T>().data();
+    std::vector<U> sum_y_backprop_x_centered(depth);
+    ComputeChannelBackpropSums(context, y_backprop, x, mean.data(), rest_size,
+                               depth, offset_backprop.data(),
+                               sum_y_backprop_x_centered.data());
+
+    const U rest_size_inv = U(1) / static_cast<U>(rest_size);
+    std::vector<U> coef1(depth);
+    std::vector<U> coef2(depth);
+    std::vector<U> y_backprop_mean(depth);
+    for (int64_t c = 0; c < depth; ++c) {
+      const U inv_std = U(1) / std::sqrt(variance(c) + epsilon);
+      scale_backprop(c) = sum_y_backprop_x_centered[c] * inv_std;
+      coef1[c] = scale(c) * inv_std;
+      coef2[c] = inv_std * inv_std * sum_y_backprop_x_centered[c] *
+                 rest_size_inv;
+      y_backprop_mean[c] = offset_backprop(c) * rest_size_inv;
     }
 
-    typename TTypes<U, 2>::Tensor scratch_tensor(
-        scratch_rest_by_depth.tensor<U, 2>());
-    typename TTypes<U>::Vec scratch_vector(scratch_one_by_depth.vec<U>());
-
-    auto x_mean_rest_by_depth =
-        mean.reshape(one_by_depth).broadcast(bcast_spec);
-    auto x_centered = (x_rest_by_depth - x_mean_rest_by_depth);
-    auto coef0_one_by_depth =
-        (variance.reshape(one_by_depth) + epsilon).rsqrt();
-    auto coef0_rest_by_depth = coef0_one_by_depth.broadcast(bcast_spec);
-    auto x_scaled = x_centered * coef0_rest_by_depth;
-
-    auto y_backprop_rest_by_depth =
-        y_backprop.reshape(rest_by_depth).template cast<U>();
-
-    // Compute `scale_backprop_output`:
-    //   scale_backprop =
-    //     (y_backprop_rest_by_depth * x_scaled).sum(reduce_dims)
-    scratch_tensor.device(d) = y_backprop_rest_by_depth * x_scaled;
-    redux_sum_u(d, rest_by_depth, scratch_rest_by_depth, scale_backprop_output);
-
-    // Compute 'offset_backprop_output':
-    //   offset_backprop =
-    //     y_backprop_rest_by_depth.sum(reduce_dims)
-    redux_sum_t(d, rest_by_depth, transformed_y_backprop_input,
-                offset_backprop_output);
-    auto y_backprop_sum = offset_backprop;
-
-    auto y_backprop_sum_one_by_depth = y_backprop_sum.reshape(one_by_depth);
-    auto y_backprop_mean_one_by_depth =
-        y_backprop_sum_one_by_depth * rest_size_inv;
-    auto y_backprop_mean_rest_by_depth =
-        y_backprop_mean_one_by_depth.broadcast(bcast_spec);
-    auto y_backprop_centered =
-        y_backprop_rest_by_depth - y_backprop_mean_rest_by_depth;
-
-    // Compute expression:
-    //   y_backprop_centered_mean =
-    //     (y_backprop_rest_by_depth * x_centered).mean(reduce_dims)
-    scratch_tensor.device(d) = y_backprop_rest_by_depth * x_centered;
-    redux_sum_u(d, rest_by_depth, scratch_rest_by_depth, &scratch_one_by_depth);
-    auto y_backprop_centered_mean =
-        scratch_vector.reshape(one_by_depth) / static_cast<U>(rest_size);
-
-    auto coef1 = (scale.reshape(one_by_depth) * coef0_one_by_depth)
-                     .broadcast(bcast_spec);
-    auto coef2 = (coef0_one_by_depth.square() * y_backprop_centered_mean)
-                     .broadcast(bcast_spec);
-
-    x_backprop.reshape(rest_by_depth).device(d) =
-        (coef1 * (y_backprop_centered - x_centered * coef2)).template cast<T>();
+    T* x_backprop = transformed_x_backprop_output.flat<T>().data();
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, rest_size,
+          depth * 6, [&](int64_t start_row, int64_t limit_row) {
+            for (int64_t row = start_row; row < limit_row; ++row) {
+              const int64_t offset = row * depth;
+              for (int64_t c = 0; c < depth; ++c) {
+                const U y_backprop_centered =
+                    static_cast<U>(y_backprop[offset + c]) -
+                    y_backprop_mean[c];
+                const U x_centered =
+                    static_cast<U>(x[offset + c]) - mean(c);
+                x_backprop[offset + c] = static_cast<T>(
+                    coef1[c] * (y_backprop_centered - x_centered * coef2[c]));
+              }
+            }
+          });
 
     if (tensor_format == FORMAT_NCHW) {
       // Perform NHWC to NCHW
@@ -556,85 +607,35 @@ struct FusedBatchNormFreezeGrad<CPUDevice, T, U> {
                   const Tensor& pop_variance_input, U epsilon,
                   Tensor* x_backprop_output, Tensor* scale_backprop_output,
                   Tensor* offset_backprop_output) {
-    typename TTypes<T, 4>::ConstTensor y_backprop(
-        y_backprop_input.tensor<T, 4>());
-    typename TTypes<T, 4>::ConstTensor input(x_input.tensor<T, 4>());
     typename TTypes<U>::ConstVec scale(scale_input.vec<U>());
     typename TTypes<U>::ConstVec pop_mean(pop_mean_input.vec<U>());
     typename TTypes<U>::ConstVec pop_var(pop_variance_input.vec<U>());
-    typename TTypes<T, 4>::Tensor x_backprop(x_backprop_output->tensor<T, 4>());
     typename TTypes<U>::Vec scale_backprop(scale_backprop_output->vec<U>());
+    typename TTypes<U>::Vec offset_backprop(offset_backprop_output->vec<U>());
 
-    const int depth = pop_mean.dimension(0);
-    const int rest_size = input.size() / depth;
-
-    const CPUDevice& d = context->eigen_device<CPUDevice>();
-
-    // Allocate two temporary workspaces of [depth] shape.
-    Tensor scratch1_vec, scratch2_vec;
-    OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<U>::value,
-                                                   {depth}, &scratch1_vec));
-    OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<U>::value,
-                                                   {depth}, &scratch2_vec));
-
-    // Maybe allocate a temporary workspace of [rest_size, depth] shape.
-    Tensor scratch3_tensor;
-    if (std::is_same<T, U>::value) {
-      OP_REQUIRES(
-          context,
-          scratch3_tensor.CopyFrom(*x_backprop_output, {rest_size, depth}),
-          errors::Internal("Failed to copy a tensor"));
-    } else {
-      OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<U>::value,
-                                                     {rest_size, depth},
-                                                     &scratch3_tensor));
-    }
-
-    typename TTypes<U>::Vec scratch1(scratch1_vec.vec<U>());
-    typename TTypes<U>::Vec scratch2(scratch2_vec.vec<U>());
-    typename TTypes<U, 2>::Tensor scratch3(scratch3_tensor.tensor<U, 2>());
-
-    Eigen::DSizes<Eigen::Index, 2> rest_by_depth(rest_size, depth);
-    Eigen::IndexList<Eigen::type2index<1>, Eigen::Index> one_by_depth;
-    one_by_depth.set(1, depth);
-    Eigen::IndexList<Eigen::Index, Eigen::type2index<1>> rest_by_one;
-    rest_by_one.set(0, rest_size);
-
-    // Sum reduction along the 0th dimension using custom CPU functor.
-    using ScalarSum = Eigen::internal::scalar_sum_op<U>;
-    const functor::ReduceOuterDimensions<T, U, U, ScalarSum> redux_sum_t;
-    const functor::ReduceOuterDimensions<U, U, U, ScalarSum> redux_sum_u;
+    const int64_t depth = pop_mean.dimension(0);
+    const int64_t rest_size = x_input.NumElements() / depth;
 
     // offset_backprop  = sum(y_backprop)
     // scale_backprop = y_backprop * ((x - pop_mean) * rsqrt(pop_var + epsilon))
     // x_backprop = y_backprop * (scale * rsqrt(pop_var + epsilon))
-
-    // NOTE: DEFAULT DEVICE comment is added to expression assignments that
-    // we don't want to be executed in a thread pool.
-
-    auto y_backprop_rest_by_depth =
-        y_backprop.reshape(rest_by_depth).template cast<U>();
-    auto input_rest_by_depth = input.reshape(rest_by_depth).template cast<U>();
-
-    // offset_backprop  = sum(y_backprop)
-    redux_sum_t(d, rest_by_depth, y_backprop_input, offset_backprop_output);
-
-    // scratch1 = rsqrt(pop_var + epsilon)
-    scratch1 = (pop_var + pop_var.constant(epsilon)).rsqrt();  // DEFAULT DEVICE
-
-    // scratch2 = sum(y_backprop * (x - mean))
-    scratch3.device(d) =
-        y_backprop_rest_by_depth *
-        (input_rest_by_depth -
-         pop_mean.reshape(one_by_depth).broadcast(rest_by_one));
-    redux_sum_u(d, rest_by_depth, scratch3_tensor, &scratch2_vec);
-
-    x_backprop.reshape(rest_by_depth).device(d) =
-        (y_backprop_rest_by_depth *
-         ((scratch1.reshape(one_by_depth) * scale.reshape(one_by_depth))
-              .broadcast(rest_by_one)))
-            .template cast<T>();
-    scale_backprop = scratch2 * scratch1;  // DEFAULT DEVICE
+    const T* y_backprop = y_backprop_input.flat<T>().data();
+    std::vector<U> sum_y_backprop_x_centered(depth);
+    ComputeChannelBackpropSums(context, y_backprop, x_input.flat<T>().data(),
+                               pop_mean.data(), rest_size, depth,
+                               offset_backprop.data(),
+                               sum_y_backprop_x_centered.data());
+
+    std::vector<U> coef(depth);
+    const std::vector<U> zeros(depth, U(0));
+    for (int64_t c = 0; c < depth; ++c) {
+      const U inv_std = U(1) / std::sqrt(pop_var(c) + epsilon);
+      scale_backprop(c) = sum_y_backprop_x_centered[c] * inv_std;
+      coef[c] = scale(c) * inv_std;
+    }
+    ScaleAndShiftChannels(context, y_backprop, coef.data(), zeros.data(),
+                          rest_size, depth,
+                          x_backprop_output->flat<T>().data());
   }
 };
 
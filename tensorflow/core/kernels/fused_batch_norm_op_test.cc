@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cmath>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
@@ -103,6 +104,56 @@ TEST_F(FusedBatchNormOpTest, TrainingRunningMean) {
   test::ExpectTensorNear<float>(expected_variance, *GetOutput(2), 0.01);
 }
 
+TEST_F(FusedBatchNormOpTest, TrainingManyBlocks) {
+  TF_EXPECT_OK(NodeDefBuilder("batch_norm_op", "FusedBatchNorm")
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Attr("exponential_avg_factor", 1.0)
+                   .Attr("epsilon", 0.001)
+                   .Attr("is_training", true)
+                   .Finalize(node_def()));
+  TF_EXPECT_OK(InitOp());
+  // Large enough for the batch statistics to be merged from several blocks,
+  // with a channel offset that would lose precision in a sum of squares.
+  constexpr int kRows = 20000;
+  std::vector<float> x(kRows * 2);
+  for (int i = 0; i < kRows; ++i) {
+    x[2 * i] = 1000 + (i % 4);
+    x[2 * i + 1] = (i % 2) ? -1 : 1;
+  }
+  AddInputFromArray<float>(TensorShape({1, 1, kRows, 2}), x);
+  AddInputFromArray<float>(TensorShape({2}), {1.0, 2.0});
+  AddInputFromArray<float>(TensorShape({2}), {0.0, 1.0});
+  AddInputFromArray<float>(TensorShape({0}), {});
+  AddInputFromArray<float>(TensorShape({0}), {});
+
+  TF_ASSERT_OK(RunOpKernel());
+
+  const auto y = GetOutput(0)->flat<float>();
+  const float inv_std0 = 1 / std::sqrt(1.25f + 0.001f);
+  const float inv_std1 = 1 / std::sqrt(1.0f + 0.001f);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NEAR(y(2 * i), ((i % 4) - 1.5f) * inv_std0, 1e-3);
+    EXPECT_NEAR(y(2 * i + 1), 2 * x[2 * i + 1] * inv_std1 + 1, 1e-3);
+  }
+
+  Tensor expected_mean(allocator(), DT_FLOAT, TensorShape({2}));
+  test::FillValues<float>(&expected_mean, {1001.5, 0});
+  test::ExpectTensorNear<float>(expected_mean, *GetOutput(1), 1e-3);
+
+  // The running variance has Bessel's correction, the saved one does not.
+  Tensor expected_variance(allocator(), DT_FLOAT, TensorShape({2}));
+  const float bessel = static_cast<float>(kRows) / (kRows - 1);
+  test::FillValues<float>(&expected_variance, {1.25f * bessel, bessel});
+  test::ExpectTensorNear<float>(expected_variance, *GetOutput(2), 1e-3);
+  Tensor expected_saved_variance(allocator(), DT_FLOAT, TensorShape({2}));
+  test::FillValues<float>(&expected_saved_variance, {1.25, 1.0});
+  test::ExpectTensorNear<float>(expected_saved_variance, *GetOutput(4), 1e-3);
+}
+
 TEST_F(FusedBatchNormOpTest, Inference) {
   TF_EXPECT_OK(NodeDefBuilder("batch_norm_op", "FusedBatchNorm")
                    .Input(FakeInput(DT_FLOAT))
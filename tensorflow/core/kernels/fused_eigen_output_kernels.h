@@ -136,6 +136,38 @@ struct Elu {
   };
 };
 
+// Applies the tanh approximation of `Gelu` to the passed input expression:
+// 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))).
+struct GeluApproximate {
+  template <typename XprType>
+  static auto apply(XprType expr) {
+    using Scalar = typename XprType::Scalar;
+    // sqrt(2 / pi) and sqrt(2 / pi) * 0.044715.
+    const Scalar inner_scale = static_cast<Scalar>(0.7978845608028654);
+    const Scalar cube_scale = static_cast<Scalar>(0.035677408136300125);
+    const Scalar one_half = static_cast<Scalar>(0.5);
+    return expr * ((expr * expr.constant(inner_scale) +
+                    expr * expr.square() * expr.constant(cube_scale))
+                           .tanh() *
+                       expr.constant(one_half) +
+                   expr.constant(one_half));
+  };
+};
+
+// Applies `Gelu` to the passed input expression:
+// 0.5 * x * (1 + erf(x / sqrt(2))).
+struct GeluExact {
+  template <typename XprType>
+  static auto apply(XprType expr) {
+    using Scalar = typename XprType::Scalar;
+    const Scalar sqrt_one_half = static_cast<Scalar>(0.7071067811865476);
+    const Scalar one_half = static_cast<Scalar>(0.5);
+    return expr * ((expr * expr.constant(sqrt_one_half)).erf() *
+                       expr.constant(one_half) +
+                   expr.constant(one_half));
+  };
+};
+
 // Applies `LeakyRelu` to the passed input expression.
 struct LeakyRelu {
   template <typename XprType>
@@ -163,7 +195,9 @@ struct BiasAddArgs {
            fusion == FusedComputationType::kBiasAddWithTanh ||
            fusion == FusedComputationType::kBiasAddWithSigmoid ||
            fusion == FusedComputationType::kBiasAddWithElu ||
-           fusion == FusedComputationType::kBiasAddWithLeakyRelu;
+           fusion == FusedComputationType::kBiasAddWithLeakyRelu ||
+           fusion == FusedComputationType::kBiasAddWithGeluApproximate ||
+           fusion == FusedComputationType::kBiasAddWithGeluExact;
   }
 };
 
@@ -398,6 +432,10 @@ using WithBiasAddAndElu = BiasAddOutputKernel<T, Elu>;
 template <typename T>
 using WithBiasAddAndLeakyRelu = BiasAddOutputKernel<T, LeakyRelu>;
 template <typename T>
+using WithBiasAddAndGeluApproximate = BiasAddOutputKernel<T, GeluApproximate>;
+template <typename T>
+using WithBiasAddAndGeluExact = BiasAddOutputKernel<T, GeluExact>;
+template <typename T>
 using WithFusedBatchNorm = FusedBatchNormOutputKernel<T>;
 template <typename T>
 using WithFusedBatchNormAndRelu = FusedBatchNormOutputKernel<T, Relu>;
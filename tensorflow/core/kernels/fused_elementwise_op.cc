@@ -0,0 +1,308 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Eigen/Core"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+namespace {
+
+enum class Opcode {
+  // Unary.
+  kAbs,
+  kExp,
+  kLog,
+  kNeg,
+  kRelu,
+  kRelu6,
+  kRsqrt,
+  kSigmoid,
+  kSqrt,
+  kSquare,
+  kTanh,
+  // Binary.
+  kAdd,
+  kMaximum,
+  kMinimum,
+  kMul,
+  kRealDiv,
+  kSquaredDifference,
+  kSub,
+};
+
+bool ParseOpcode(const string& op, Opcode* opcode, bool* is_binary) {
+  static const auto* const kOpcodes =
+      new std::vector<std::tuple<string, Opcode, bool>>({
+          {"Abs", Opcode::kAbs, false},
+          {"Exp", Opcode::kExp, false},
+          {"Log", Opcode::kLog, false},
+          {"Neg", Opcode::kNeg, false},
+          {"Relu", Opcode::kRelu, false},
+          {"Relu6", Opcode::kRelu6, false},
+          {"Rsqrt", Opcode::kRsqrt, false},
+          {"Sigmoid", Opcode::kSigmoid, false},
+          {"Sqrt", Opcode::kSqrt, false},
+          {"Square", Opcode::kSquare, false},
+          {"Tanh", Opcode::kTanh, false},
+          {"Add", Opcode::kAdd, true},
+          {"AddV2", Opcode::kAdd, true},
+          {"Maximum", Opcode::kMaximum, true},
+          {"Minimum", Opcode::kMinimum, true},
+          {"Mul", Opcode::kMul, true},
+          {"RealDiv", Opcode::kRealDiv, true},
+          {"SquaredDifference", Opcode::kSquaredDifference, true},
+          {"Sub", Opcode::kSub, true},
+      });
+  for (const auto& entry : *kOpcodes) {
+    if (std::get<0>(entry) == op) {
+      *opcode = std::get<1>(entry);
+      *is_binary = std::get<2>(entry);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// Evaluates an expression DAG of elementwise ops, described by the `ops` and
+// `operands` attributes, over inputs of the same shape (or scalars).
+//
+// The output is computed one tile of kTileSize elements at a time, keeping
+// the intermediate results of the tile in a small scratch buffer that stays
+// in cache, instead of materializing every intermediate tensor in memory.
+template <typename T>
+class FusedElementwiseOp : public OpKernel {
+ public:
+  explicit FusedElementwiseOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::vector<string> ops;
+    std::vector<int> operands;
+    OP_REQUIRES_OK(context, context->GetAttr("ops", &ops));
+    OP_REQUIRES_OK(context, context->GetAttr("operands", &operands));
+    OP_REQUIRES(context, !ops.empty(),
+                errors::InvalidArgument("`ops` must not be empty"));
+    OP_REQUIRES(context, operands.size() == 2 * ops.size(),
+                errors::InvalidArgument(
+                    "`operands` must have two entries per op, got ",
+                    operands.size(), " for ", ops.size(), " ops"));
+    const int num_inputs = context->num_inputs();
+    instructions_.resize(ops.size());
+    for (int i = 0; i < ops.size(); ++i) {
+      Instruction& instruction = instructions_[i];
+      bool is_binary;
+      OP_REQUIRES(context,
+                  ParseOpcode(ops[i], &instruction.opcode, &is_binary),
+                  errors::Unimplemented("Unsupported fused op: ", ops[i]));
+      instruction.a = operands[2 * i];
+      instruction.b = is_binary ? operands[2 * i + 1] : -1;
+      // Operands refer to an input, or to the result of an earlier op.
+      for (int operand : {instruction.a, instruction.b}) {
+        if (operand == -1 && !is_binary) continue;
+        OP_REQUIRES(context, operand >= 0 && operand < num_inputs + i,
+                    errors::InvalidArgument("Invalid operand ", operand,
+                                            " for fused op ", i, " (",
+                                            ops[i], ")"));
+      }
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const int num_inputs = context->num_inputs();
+    // The output has the shape of the non-scalar inputs.
+    TensorShape shape;
+    gtl::InlinedVector<int, 4> forwardable_inputs;
+    for (int i = 0; i < num_inputs; ++i) {
+      const Tensor& input = context->input(i);
+      if (TensorShapeUtils::IsScalar(input.shape())) continue;
+      if (forwardable_inputs.empty()) {
+        shape = input.shape();
+      } else {
+        OP_REQUIRES(context, input.shape() == shape,
+                    errors::InvalidArgument(
+                        "Inputs of _FusedElementwise must be scalars or have "
+                        "the same shape, got ",
+                        shape.DebugString(), " and ",
+                        input.shape().DebugString()));
+      }
+      forwardable_inputs.push_back(i);
+    }
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                forwardable_inputs, 0, shape, &output));
+    const int64_t num_elements = shape.num_elements();
+    if (num_elements == 0) return;
+
+    std::vector<const T*> input_data(num_inputs);
+    std::vector<bool> input_is_scalar(num_inputs);
+    for (int i = 0; i < num_inputs; ++i) {
+      const Tensor& input = context->input(i);
+      input_data[i] = input.flat<T>().data();
+      input_is_scalar[i] =
+          TensorShapeUtils::IsScalar(input.shape()) && num_elements != 1;
+    }
+    T* output_data = output->flat<T>().data();
+
+    const int num_instructions = instructions_.size();
+    auto work = [&](int64_t begin_tile, int64_t end_tile) {
+      // One tile of scratch per op result, plus one per broadcast scalar.
+      std::vector<T> scratch((num_instructions + num_inputs) * kTileSize);
+      std::vector<const T*> values(num_inputs + num_instructions);
+      for (int i = 0; i < num_inputs; ++i) {
+        if (input_is_scalar[i]) {
+          T* broadcast = scratch.data() + (num_instructions + i) * kTileSize;
+          std::fill(broadcast, broadcast + kTileSize, *input_data[i]);
+          values[i] = broadcast;
+        }
+      }
+      for (int64_t tile = begin_tile; tile < end_tile; ++tile) {
+        const int64_t start = tile * kTileSize;
+        const int64_t size = std::min(kTileSize, num_elements - start);
+        for (int i = 0; i < num_inputs; ++i) {
+          if (!input_is_scalar[i]) values[i] = input_data[i] + start;
+        }
+        for (int i = 0; i < num_instructions; ++i) {
+          // The last op writes directly into the output.
+          T* result = i == num_instructions - 1
+                          ? output_data + start
+                          : scratch.data() + i * kTileSize;
+          Evaluate(instructions_[i], values, size, result);
+          values[num_inputs + i] = result;
+        }
+      }
+    };
+    const int64_t num_tiles = (num_elements + kTileSize - 1) / kTileSize;
+    const int64_t cost_per_tile = kTileSize * num_instructions * 4;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_tiles,
+          cost_per_tile, work);
+  }
+
+ private:
+  static constexpr int64_t kTileSize = 1024;
+
+  struct Instruction {
+    Opcode opcode;
+    int a;
+    int b;
+  };
+
+  using Array = Eigen::Array<T, Eigen::Dynamic, 1>;
+  using ConstMap = Eigen::Map<const Array>;
+  using Map = Eigen::Map<Array>;
+
+  static void Evaluate(const Instruction& instruction,
+                       const std::vector<const T*>& values, int64_t size,
+                       T* result) {
+    Map out(result, size);
+    ConstMap a(values[instruction.a], size);
+    switch (instruction.opcode) {
+      case Opcode::kAbs:
+        out = a.abs();
+        return;
+      case Opcode::kExp:
+        out = a.exp();
+        return;
+      case Opcode::kLog:
+        out = a.log();
+        return;
+      case Opcode::kNeg:
+        out = -a;
+        return;
+      case Opcode::kRelu:
+        out = a.max(T(0));
+        return;
+      case Opcode::kRelu6:
+        out = a.max(T(0)).min(T(6));
+        return;
+      case Opcode::kRsqrt:
+        out = a.rsqrt();
+        return;
+      case Opcode::kSigmoid:
+        out = a.logistic();
+        return;
+      case Opcode::kSqrt:
+        out = a.sqrt();
+        return;
+      case Opcode::kSquare:
+        out = a.square();
+        return;
+      case Opcode::kTanh:
+        out = a.tanh();
+        return;
+      default:
+        break;
+    }
+    ConstMap b(values[instruction.b], size);
+    switch (instruction.opcode) {
+      case Opcode::kAdd:
+        out = a + b;
+        return;
+      case Opcode::kMaximum:
+        out = a.max(b);
+        return;
+      case Opcode::kMinimum:
+        out = a.min(b);
+        return;
+      case Opcode::kMul:
+        out = a * b;
+        return;
+      case Opcode::kRealDiv:
+        out = a / b;
+        return;
+      case Opcode::kSquaredDifference:
+        out = (a - b).square();
+        return;
+      case Opcode::kSub:
+        out = a - b;
+        return;
+      default:
+        LOG(FATAL) << "Unexpected opcode "  // Crash OK
+                   << static_cast<int>(instruction.opcode);
+    }
+  }
+
+  std::vector<Instruction> instructions_;
+};
+
+#define REGISTER_FUSED_ELEMENTWISE(type)                   \
+  REGISTER_KERNEL_BUILDER(Name("_FusedElementwise")        \
+                              .Device(DEVICE_CPU)          \
+                              .TypeConstraint<type>("T"), \
+                          FusedElementwiseOp<type>);
+
+TF_CALL_float(REGISTER_FUSED_ELEMENTWISE);
+TF_CALL_double(REGISTER_FUSED_ELEMENTWISE);
+
+#undef REGISTER_FUSED_ELEMENTWISE
+
+}  // namespace tensorflow
@@ -0,0 +1,107 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class FusedElementwiseOpTest : public OpsTestBase {
+ protected:
+  Status Init(DataType dtype, int num_inputs, const std::vector<string>& ops,
+              const std::vector<int>& operands) {
+    TF_RETURN_IF_ERROR(NodeDefBuilder("fused", "_FusedElementwise")
+                           .Input(FakeInput(num_inputs, dtype))
+                           .Attr("ops", ops)
+                           .Attr("operands", operands)
+                           .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+// relu(a * b + c), with a scalar `c`.
+TEST_F(FusedElementwiseOpTest, MulAddReluWithScalar) {
+  TF_ASSERT_OK(
+      Init(DT_FLOAT, 3, {"Mul", "AddV2", "Relu"}, {0, 1, 3, 2, 4, -1}));
+  AddInputFromArray<float>(TensorShape({2, 3}), {1, 2, 3, 4, 5, 6});
+  AddInputFromArray<float>(TensorShape({2, 3}), {1, -1, 1, -1, 1, -1});
+  AddInputFromArray<float>(TensorShape({}), {-2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 3}));
+  test::FillValues<float>(&expected, {0, 0, 1, 0, 3, 0});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+// An op result may be used several times: (a - b)^2 + (a - b).
+TEST_F(FusedElementwiseOpTest, ReusedIntermediate) {
+  TF_ASSERT_OK(
+      Init(DT_DOUBLE, 2, {"Sub", "Square", "Add"}, {0, 1, 2, -1, 3, 2}));
+  AddInputFromArray<double>(TensorShape({4}), {3, 2, 1, 0});
+  AddInputFromArray<double>(TensorShape({4}), {0, 1, 2, 3});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_DOUBLE, TensorShape({4}));
+  test::FillValues<double>(&expected, {12, 2, 0, 6});
+  test::ExpectTensorEqual<double>(expected, *GetOutput(0));
+}
+
+// Inputs larger than a tile are evaluated in several tiles.
+TEST_F(FusedElementwiseOpTest, MultipleTiles) {
+  TF_ASSERT_OK(Init(DT_FLOAT, 2, {"Maximum", "Tanh"}, {0, 1, 2, -1}));
+  const int n = 5000;
+  std::vector<float> a(n), b(n), values(n);
+  for (int i = 0; i < n; ++i) {
+    a[i] = 0.001f * (i - n / 2);
+    b[i] = 0.0005f * (n / 2 - i);
+    values[i] = std::tanh(std::max(a[i], b[i]));
+  }
+  AddInputFromArray<float>(TensorShape({n}), a);
+  AddInputFromArray<float>(TensorShape({n}), b);
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({n}));
+  test::FillValues<float>(&expected, values);
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-5);
+}
+
+TEST_F(FusedElementwiseOpTest, InvalidOperand) {
+  EXPECT_FALSE(Init(DT_FLOAT, 1, {"Exp", "Mul"}, {0, -1, 1, 2}).ok());
+}
+
+TEST_F(FusedElementwiseOpTest, UnsupportedOp) {
+  EXPECT_FALSE(Init(DT_FLOAT, 1, {"Cast"}, {0, -1}).ok());
+}
+
+TEST_F(FusedElementwiseOpTest, MismatchedShapes) {
+  TF_ASSERT_OK(Init(DT_FLOAT, 2, {"Add"}, {0, 1}));
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({3}), {1, 2, 3});
+  EXPECT_FALSE(RunOpKernel().ok());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,141 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/array_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include <cstdint>
+
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Gathers rows of a table quantized with one scale and bias per row, and
+// dequantizes them directly into the output:
+//
+//   output[i, ...] = params[indices[i], ...] * scales[indices[i]] +
+//                    biases[indices[i]]
+//
+// This lets embedding tables be stored in 8 bits per value while lookups still
+// produce floating point rows, without a separate dequantized copy of the
+// table.
+template <typename Tparams, typename Index, typename T>
+class GatherDequantizeOp : public OpKernel {
+ public:
+  explicit GatherDequantizeOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& params = context->input(0);
+    const Tensor& scales = context->input(1);
+    const Tensor& biases = context->input(2);
+    const Tensor& indices = context->input(3);
+    OP_REQUIRES(context, TensorShapeUtils::IsVectorOrHigher(params.shape()),
+                errors::InvalidArgument("params must be at least 1-D, got ",
+                                        params.shape().DebugString()));
+    const int64_t num_rows = params.dim_size(0);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(scales.shape()) &&
+                    scales.dim_size(0) == num_rows,
+                errors::InvalidArgument("scales must be a vector of size ",
+                                        num_rows, ", got shape ",
+                                        scales.shape().DebugString()));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(biases.shape()) &&
+                    biases.dim_size(0) == num_rows,
+                errors::InvalidArgument("biases must be a vector of size ",
+                                        num_rows, ", got shape ",
+                                        biases.shape().DebugString()));
+
+    TensorShape output_shape = indices.shape();
+    for (int d = 1; d < params.dims(); ++d) {
+      OP_REQUIRES_OK(context,
+                     output_shape.AddDimWithStatus(params.dim_size(d)));
+    }
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, output_shape, &output));
+    const int64_t num_indices = indices.NumElements();
+    if (num_indices == 0) return;
+
+    const int64_t row_size = num_rows > 0 ? params.NumElements() / num_rows : 0;
+    const auto indices_flat = indices.flat<Index>();
+    for (int64_t i = 0; i < num_indices; ++i) {
+      OP_REQUIRES(context, FastBoundsCheck(indices_flat(i), num_rows),
+                  errors::InvalidArgument("indices[", i, "] = ",
+                                          indices_flat(i), " is not in [0, ",
+                                          num_rows, ")"));
+    }
+    if (row_size == 0) return;
+
+    const Tparams* params_data = params.flat<Tparams>().data();
+    const float* scales_data = scales.flat<float>().data();
+    const float* biases_data = biases.flat<float>().data();
+    T* output_data = output->flat<T>().data();
+    auto gather_rows = [&](int64_t start, int64_t limit) {
+      for (int64_t i = start; i < limit; ++i) {
+        const int64_t row = indices_flat(i);
+        const Tparams* in = params_data + row * row_size;
+        const float scale = scales_data[row];
+        const float bias = biases_data[row];
+        T* out = output_data + i * row_size;
+        for (int64_t j = 0; j < row_size; ++j) {
+          out[j] = static_cast<T>(static_cast<float>(in[j]) * scale + bias);
+        }
+      }
+    };
+    // Each value is read, converted, scaled and written once.
+    const int64_t cost_per_row = row_size * 4;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_indices,
+          cost_per_row, gather_rows);
+  }
+};
+
+#define REGISTER_KERNEL(Tparams, Index, T)                      \
+  REGISTER_KERNEL_BUILDER(Name("GatherDequantize")                \
+                              .Device(DEVICE_CPU)                 \
+                              .TypeConstraint<Tparams>("Tparams") \
+                              .TypeConstraint<Index>("Tindices")  \
+                              .TypeConstraint<T>("dtype"),        \
+                          GatherDequantizeOp<Tparams, Index, T>)
+#define REGISTER_KERNELS_FOR_OUTPUT(Tparams, T) \
+  REGISTER_KERNEL(Tparams, int32, T);           \
+  REGISTER_KERNEL(Tparams, int64_t, T)
+#define REGISTER_KERNELS(Tparams)                    \
+  REGISTER_KERNELS_FOR_OUTPUT(Tparams, Eigen::half); \
+  REGISTER_KERNELS_FOR_OUTPUT(Tparams, bfloat16);    \
+  REGISTER_KERNELS_FOR_OUTPUT(Tparams, float)
+
+REGISTER_KERNELS(int8);
+REGISTER_KERNELS(uint8);
+REGISTER_KERNELS(float8_e4m3fn);
+REGISTER_KERNELS(float8_e5m2);
+
+#undef REGISTER_KERNELS
+#undef REGISTER_KERNELS_FOR_OUTPUT
+#undef REGISTER_KERNEL
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,90 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class GatherDequantizeOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(DataType params_type, DataType dtype) {
+    TF_ASSERT_OK(NodeDefBuilder("op", "GatherDequantize")
+                     .Input(FakeInput(params_type))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("dtype", dtype)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(GatherDequantizeOpTest, DequantizesGatheredRows) {
+  MakeOp(DT_INT8, DT_FLOAT);
+  AddInputFromArray<int8>(TensorShape({3, 2}), {1, -1, 2, -2, 127, -128});
+  AddInputFromArray<float>(TensorShape({3}), {0.5, 1, 0.25});
+  AddInputFromArray<float>(TensorShape({3}), {0, 10, -1});
+  AddInputFromArray<int32>(TensorShape({2, 2}), {2, 0, 1, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 2, 2}));
+  test::FillValues<float>(&expected,
+                          {30.75, -33, 0.5, -0.5, 12, 8, 30.75, -33});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(GatherDequantizeOpTest, DequantizesFloat8ToBfloat16) {
+  MakeOp(DT_FLOAT8_E4M3FN, DT_BFLOAT16);
+  AddInputFromList<float8_e4m3fn>(
+      TensorShape({2, 2}), {float8_e4m3fn(1.5f), float8_e4m3fn(-2.0f),
+                            float8_e4m3fn(0.5f), float8_e4m3fn(4.0f)});
+  AddInputFromArray<float>(TensorShape({2}), {2, 1});
+  AddInputFromArray<float>(TensorShape({2}), {1, 0});
+  AddInputFromArray<int32>(TensorShape({1}), {0});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_BFLOAT16, TensorShape({1, 2}));
+  test::FillValues<bfloat16>(&expected, {bfloat16(4.0f), bfloat16(-3.0f)});
+  test::ExpectTensorEqual<bfloat16>(expected, *GetOutput(0));
+}
+
+TEST_F(GatherDequantizeOpTest, FailsForOutOfRangeIndex) {
+  MakeOp(DT_UINT8, DT_FLOAT);
+  AddInputFromArray<uint8>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({2}), {1, 1});
+  AddInputFromArray<float>(TensorShape({2}), {0, 0});
+  AddInputFromArray<int32>(TensorShape({1}), {2});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+TEST_F(GatherDequantizeOpTest, FailsForMismatchedScales) {
+  MakeOp(DT_INT8, DT_FLOAT);
+  AddInputFromArray<int8>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({1}), {1});
+  AddInputFromArray<float>(TensorShape({2}), {0, 0});
+  AddInputFromArray<int32>(TensorShape({1}), {0});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,267 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "absl/base/prefetch.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/training_op_helpers.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+using CPUDevice = Eigen::ThreadPoolDevice;
+
+// Number of indices ahead of the current one whose rows are prefetched.
+constexpr int64_t kPrefetchDistance = 8;
+// Rows are prefetched up to this many bytes.
+constexpr int64_t kMaxPrefetchBytes = 512;
+constexpr int64_t kCacheLineSize = 64;
+
+enum class Combiner { kSum, kMean, kSqrtN };
+
+// Reduces the rows of many embedding tables at once. Bag `b` of table `t`
+// reduces the rows `params[t][indices[t][offsets[t][b]:offsets[t][b + 1]]]`.
+//
+// All bags of all tables are partitioned across the worker threads together,
+// so that a model with hundreds of small lookups runs one kernel instead of a
+// gather and a segment reduction per table.
+//
+// The tables of ResourceGroupedSparseSegmentReduce are resource variables,
+// whose rows are read in place rather than from a copy of each variable.
+template <typename T, typename Index>
+class GroupedSparseSegmentReduceOp : public OpKernel {
+ public:
+  // Low precision values are accumulated in float.
+  using Accum =
+      typename std::conditional<std::is_same<T, Eigen::half>::value ||
+                                    std::is_same<T, bfloat16>::value,
+                                float, T>::type;
+
+  explicit GroupedSparseSegmentReduceOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::string combiner;
+    OP_REQUIRES_OK(context, context->GetAttr("combiner", &combiner));
+    if (combiner == "mean") {
+      combiner_ = Combiner::kMean;
+    } else if (combiner == "sqrtn") {
+      combiner_ = Combiner::kSqrtN;
+    } else {
+      combiner_ = Combiner::kSum;
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    OpInputList indices, offsets;
+    OP_REQUIRES_OK(context, context->input_list("indices", &indices));
+    OP_REQUIRES_OK(context, context->input_list("offsets", &offsets));
+    OpOutputList outputs;
+    OP_REQUIRES_OK(context, context->output_list("output", &outputs));
+    const int num_tables = indices.size();
+
+    // The variables are read under shared locks, acquired in address order
+    // and held until all bags are reduced. This does nothing for dense tables.
+    std::vector<int> params_inputs(num_tables);
+    std::iota(params_inputs.begin(), params_inputs.end(), 0);
+    auto variable_locks = MaybeLockVariableInputMutexesInOrder<CPUDevice, T>(
+        context, /*do_lock=*/false, /*sparse=*/true, params_inputs);
+    std::vector<Tensor> params(num_tables);
+    for (int t = 0; t < num_tables; ++t) {
+      if (context->input_dtype(t) == DT_RESOURCE) {
+        OP_REQUIRES_OK(context, GetInputTensorFromVariable<CPUDevice, T>(
+                                    context, t, /*lock_held=*/true,
+                                    /*sparse=*/true, &params[t]));
+      } else {
+        params[t] = context->input(t);
+      }
+    }
+
+    std::vector<Table> tables(num_tables);
+    // `bag_starts[t]` is the global index of the first bag of table `t`.
+    std::vector<int64_t> bag_starts(num_tables + 1, 0);
+    int64_t total_cost = 0;
+    for (int t = 0; t < num_tables; ++t) {
+      OP_REQUIRES_OK(context, InitTable(t, params[t], indices[t], offsets[t],
+                                        &outputs, &tables[t]));
+      bag_starts[t + 1] = bag_starts[t] + tables[t].num_bags;
+      total_cost += tables[t].indices.size() * tables[t].num_col;
+    }
+    const int64_t total_bags = bag_starts[num_tables];
+    if (total_bags == 0) return;
+
+    auto reduce_bags = [&](int64_t begin, int64_t end) {
+      std::vector<Accum> accum;
+      int t = std::upper_bound(bag_starts.begin(), bag_starts.end(), begin) -
+              bag_starts.begin() - 1;
+      for (int64_t global_bag = begin; global_bag < end; ++global_bag) {
+        while (global_bag >= bag_starts[t + 1]) ++t;
+        ReduceBag(tables[t], global_bag - bag_starts[t], &accum);
+      }
+    };
+    const int64_t cost_per_bag =
+        std::max<int64_t>(total_cost / total_bags, 1) * 4;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, total_bags,
+          cost_per_bag, reduce_bags);
+  }
+
+ private:
+  struct Table {
+    typename TTypes<T>::ConstMatrix params{nullptr, 0, 0};
+    typename TTypes<Index>::ConstVec indices{nullptr, 0};
+    typename TTypes<Index>::ConstVec offsets{nullptr, 0};
+    typename TTypes<T>::Matrix output{nullptr, 0, 0};
+    int64_t num_bags = 0;
+    int64_t num_col = 0;
+  };
+
+  // Validates the inputs of table `t` and allocates its output.
+  Status InitTable(int t, const Tensor& params, const Tensor& indices,
+                   const Tensor& offsets, OpOutputList* outputs,
+                   Table* table) {
+    if (!TensorShapeUtils::IsVectorOrHigher(params.shape())) {
+      return errors::InvalidArgument("params[", t,
+                                     "] must be at least 1-D, got ",
+                                     params.shape().DebugString());
+    }
+    if (!TensorShapeUtils::IsVector(indices.shape())) {
+      return errors::InvalidArgument("indices[", t, "] must be a vector, got ",
+                                     indices.shape().DebugString());
+    }
+    if (!TensorShapeUtils::IsVector(offsets.shape()) ||
+        offsets.NumElements() == 0) {
+      return errors::InvalidArgument("offsets[", t,
+                                     "] must be a non-empty vector, got ",
+                                     offsets.shape().DebugString());
+    }
+    table->params = params.flat_outer_dims<T>();
+    table->indices = indices.vec<Index>();
+    table->offsets = offsets.vec<Index>();
+    table->num_bags = offsets.NumElements() - 1;
+    table->num_col = table->params.dimension(1);
+
+    const int64_t num_rows = table->params.dimension(0);
+    const int64_t num_indices = indices.NumElements();
+    for (int64_t i = 0; i < num_indices; ++i) {
+      const Index index = internal::SubtleMustCopy(table->indices(i));
+      if (!FastBoundsCheck(index, num_rows)) {
+        return errors::InvalidArgument("indices[", t, "][", i, "] == ", index,
+                                       " out of range [0, ", num_rows, ")");
+      }
+    }
+    if (table->offsets(0) != 0 ||
+        table->offsets(table->num_bags) != num_indices) {
+      return errors::InvalidArgument(
+          "offsets[", t, "] must start at 0 and end at the size of indices[",
+          t, "], ", num_indices);
+    }
+    for (int64_t b = 0; b < table->num_bags; ++b) {
+      if (table->offsets(b) > table->offsets(b + 1)) {
+        return errors::InvalidArgument("offsets[", t,
+                                       "] must be non-decreasing");
+      }
+    }
+
+    TensorShape output_shape = params.shape();
+    TF_RETURN_IF_ERROR(output_shape.SetDimWithStatus(0, table->num_bags));
+    Tensor* output = nullptr;
+    TF_RETURN_IF_ERROR(outputs->allocate(t, output_shape, &output));
+    table->output = output->flat_outer_dims<T>();
+    return absl::OkStatus();
+  }
+
+  void ReduceBag(const Table& table, int64_t bag,
+                 std::vector<Accum>* accum) const {
+    const int64_t num_col = table.num_col;
+    accum->assign(num_col, Accum(0));
+    const int64_t begin = table.offsets(bag);
+    const int64_t end = table.offsets(bag + 1);
+    const int64_t prefetch_bytes =
+        std::min<int64_t>(num_col * sizeof(T), kMaxPrefetchBytes);
+    for (int64_t i = begin; i < end; ++i) {
+      if (i + kPrefetchDistance < end) {
+        const char* next = reinterpret_cast<const char*>(
+            &table.params(table.indices(i + kPrefetchDistance), 0));
+        for (int64_t offset = 0; offset < prefetch_bytes;
+             offset += kCacheLineSize) {
+          absl::PrefetchToLocalCache(next + offset);
+        }
+      }
+      const T* row = &table.params(table.indices(i), 0);
+      for (int64_t j = 0; j < num_col; ++j) {
+        (*accum)[j] += static_cast<Accum>(row[j]);
+      }
+    }
+    Accum scale = 1;
+    if (end > begin) {
+      if (combiner_ == Combiner::kMean) {
+        scale = Accum(1) / static_cast<Accum>(end - begin);
+      } else if (combiner_ == Combiner::kSqrtN) {
+        scale = Accum(1) / std::sqrt(static_cast<Accum>(end - begin));
+      }
+    }
+    T* out = &table.output(bag, 0);
+    for (int64_t j = 0; j < num_col; ++j) {
+      out[j] = static_cast<T>((*accum)[j] * scale);
+    }
+  }
+
+  Combiner combiner_;
+};
+
+#define REGISTER_KERNELS(type, index_type)                                 \
+  REGISTER_KERNEL_BUILDER(Name("GroupedSparseSegmentReduce")               \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<type>("T")                   \
+                              .TypeConstraint<index_type>("Tidx"),         \
+                          GroupedSparseSegmentReduceOp<type, index_type>); \
+  REGISTER_KERNEL_BUILDER(Name("ResourceGroupedSparseSegmentReduce")       \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<type>("dtype")               \
+                              .TypeConstraint<index_type>("Tidx"),         \
+                          GroupedSparseSegmentReduceOp<type, index_type>)
+#define REGISTER_KERNELS_FOR_INDEX_TYPES(type) \
+  REGISTER_KERNELS(type, int32);               \
+  REGISTER_KERNELS(type, int64_t);
+
+TF_CALL_half(REGISTER_KERNELS_FOR_INDEX_TYPES);
+TF_CALL_bfloat16(REGISTER_KERNELS_FOR_INDEX_TYPES);
+TF_CALL_float(REGISTER_KERNELS_FOR_INDEX_TYPES);
+TF_CALL_double(REGISTER_KERNELS_FOR_INDEX_TYPES);
+
+#undef REGISTER_KERNELS_FOR_INDEX_TYPES
+#undef REGISTER_KERNELS
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,133 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/resource_var.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class GroupedSparseSegmentReduceOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const string& combiner) {
+    TF_ASSERT_OK(NodeDefBuilder("op", "GroupedSparseSegmentReduce")
+                     .Input(FakeInput(2, DT_FLOAT))
+                     .Input(FakeInput(2, DT_INT32))
+                     .Input(FakeInput(2, DT_INT32))
+                     .Attr("combiner", combiner)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(GroupedSparseSegmentReduceOpTest, ReducesEachTable) {
+  MakeOp("sum");
+  AddInputFromArray<float>(TensorShape({3, 2}), {1, 2, 10, 20, 100, 200});
+  AddInputFromArray<float>(TensorShape({2, 1}), {5, 7});
+  AddInputFromArray<int32>(TensorShape({4}), {0, 2, 1, 1});
+  AddInputFromArray<int32>(TensorShape({1}), {1});
+  // The second bag of the first table is empty.
+  AddInputFromArray<int32>(TensorShape({4}), {0, 2, 2, 4});
+  AddInputFromArray<int32>(TensorShape({3}), {0, 0, 1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected0(allocator(), DT_FLOAT, TensorShape({3, 2}));
+  test::FillValues<float>(&expected0, {101, 202, 0, 0, 20, 40});
+  test::ExpectTensorEqual<float>(expected0, *GetOutput(0));
+  Tensor expected1(allocator(), DT_FLOAT, TensorShape({2, 1}));
+  test::FillValues<float>(&expected1, {0, 7});
+  test::ExpectTensorEqual<float>(expected1, *GetOutput(1));
+}
+
+TEST_F(GroupedSparseSegmentReduceOpTest, AveragesBags) {
+  MakeOp("mean");
+  AddInputFromArray<float>(TensorShape({2, 1}), {2, 4});
+  AddInputFromArray<float>(TensorShape({1, 1}), {3});
+  AddInputFromArray<int32>(TensorShape({3}), {0, 1, 1});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 0});
+  AddInputFromArray<int32>(TensorShape({3}), {0, 1, 3});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected0(allocator(), DT_FLOAT, TensorShape({2, 1}));
+  test::FillValues<float>(&expected0, {2, 4});
+  test::ExpectTensorEqual<float>(expected0, *GetOutput(0));
+  Tensor expected1(allocator(), DT_FLOAT, TensorShape({1, 1}));
+  test::FillValues<float>(&expected1, {3});
+  test::ExpectTensorEqual<float>(expected1, *GetOutput(1));
+}
+
+TEST_F(GroupedSparseSegmentReduceOpTest, ReadsResourceVariables) {
+  TF_ASSERT_OK(NodeDefBuilder("op", "ResourceGroupedSparseSegmentReduce")
+                   .Input(FakeInput(2, DT_RESOURCE))
+                   .Input(FakeInput(2, DT_INT32))
+                   .Input(FakeInput(2, DT_INT32))
+                   .Attr("dtype", DT_FLOAT)
+                   .Attr("combiner", "sum")
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  Var* table0 = new Var(DT_FLOAT);
+  *table0->tensor() = test::AsTensor<float>({1, 2, 10, 20}, {2, 2});
+  table0->is_initialized = true;
+  Var* table1 = new Var(DT_FLOAT);
+  *table1->tensor() = test::AsTensor<float>({5, 7}, {2, 1});
+  table1->is_initialized = true;
+  AddResourceInput("", "table0", table0);
+  AddResourceInput("", "table1", table1);
+  AddInputFromArray<int32>(TensorShape({3}), {0, 1, 1});
+  AddInputFromArray<int32>(TensorShape({1}), {1});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 3});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected0(allocator(), DT_FLOAT, TensorShape({1, 2}));
+  test::FillValues<float>(&expected0, {21, 42});
+  test::ExpectTensorEqual<float>(expected0, *GetOutput(0));
+  Tensor expected1(allocator(), DT_FLOAT, TensorShape({1, 1}));
+  test::FillValues<float>(&expected1, {7});
+  test::ExpectTensorEqual<float>(expected1, *GetOutput(1));
+}
+
+TEST_F(GroupedSparseSegmentReduceOpTest, FailsForOutOfRangeIndex) {
+  MakeOp("sum");
+  AddInputFromArray<float>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<int32>(TensorShape({1}), {0});
+  AddInputFromArray<int32>(TensorShape({1}), {2});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 1});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 1});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+TEST_F(GroupedSparseSegmentReduceOpTest, FailsForDecreasingOffsets) {
+  MakeOp("sum");
+  AddInputFromArray<float>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<int32>(TensorShape({2}), {0, 1});
+  AddInputFromArray<int32>(TensorShape({1}), {1});
+  AddInputFromArray<int32>(TensorShape({3}), {0, 2, 2});
+  AddInputFromArray<int32>(TensorShape({3}), {0, 2, 1});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,288 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/util/image_resizer_state.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Source rows or columns and weight of one output row or column.
+struct Interpolation {
+  int64_t lower;
+  int64_t upper;
+  float lerp;
+};
+
+// The crop starts `crop_start` pixels into the `in_size` decoded pixels and
+// spans `crop_size` of them. Both may be fractional when the image is
+// downscaled while decoding.
+template <typename Scaler>
+std::vector<Interpolation> ComputeInterpolation(const Scaler& scaler,
+                                                int64_t out_size,
+                                                int64_t in_size,
+                                                float crop_start,
+                                                float crop_size,
+                                                int64_t stride) {
+  const float scale = crop_size / out_size;
+  std::vector<Interpolation> interpolation(out_size);
+  for (int64_t i = 0; i < out_size; ++i) {
+    const float in = crop_start + scaler(i, scale);
+    const float in_f = std::floor(in);
+    interpolation[i].lower =
+        std::min<int64_t>(std::max<int64_t>(in_f, 0), in_size - 1) * stride;
+    interpolation[i].upper =
+        std::min<int64_t>(std::ceil(in), in_size - 1) * stride;
+    interpolation[i].lerp = in - in_f;
+  }
+  return interpolation;
+}
+
+// Resizes one output row. The channel count is a template argument so that
+// the inner loop is unrolled and vectorized across pixels.
+template <int kChannels>
+void ResizeRow(const uint8* top, const uint8* bottom, float y_lerp,
+               const std::vector<Interpolation>& xs, int channels,
+               float* out) {
+  const int c_count = kChannels > 0 ? kChannels : channels;
+  for (const Interpolation& x : xs) {
+    for (int c = 0; c < c_count; ++c) {
+      const float top_left = top[x.lower + c];
+      const float top_right = top[x.upper + c];
+      const float bottom_left = bottom[x.lower + c];
+      const float bottom_right = bottom[x.upper + c];
+      const float top_value = top_left + (top_right - top_left) * x.lerp;
+      const float bottom_value =
+          bottom_left + (bottom_right - bottom_left) * x.lerp;
+      out[c] = top_value + (bottom_value - top_value) * y_lerp;
+    }
+    out += c_count;
+  }
+}
+
+// Decodes the crop window of a JPEG image and resizes it bilinearly.
+//
+// The image is downscaled while decoding by the largest power of two that
+// keeps the crop window at least as large as the output, so that most of the
+// image is neither decoded at full resolution nor resized, and only the rows
+// and columns overlapping the crop window are decoded.
+class DecodeCropAndResizeJpegOp : public OpKernel {
+ public:
+  explicit DecodeCropAndResizeJpegOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 0 || channels_ == 1 || channels_ == 3,
+                errors::InvalidArgument("channels must be 0, 1, or 3, got ",
+                                        channels_));
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        errors::InvalidArgument("dct_method must be one of "
+                                "{'', 'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    // As in `DecodeJpeg`, the default is the fast IDCT.
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+    OP_REQUIRES_OK(context, context->GetAttr("half_pixel_centers",
+                                             &half_pixel_centers_));
+    flags_.components = channels_;
+    flags_.crop = true;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsScalar(contents.shape()),
+                errors::InvalidArgument("contents must be scalar, got shape ",
+                                        contents.shape().DebugString()));
+    const Tensor& crop_window = context->input(1);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(crop_window.shape()) &&
+                    crop_window.NumElements() == 4,
+                errors::InvalidArgument(
+                    "crop_window must have four elements, got shape ",
+                    crop_window.shape().DebugString()));
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(size.shape()) &&
+                    size.NumElements() == 2,
+                errors::InvalidArgument("size must have two elements, got ",
+                                        size.shape().DebugString()));
+    const auto size_vec = size.vec<int32>();
+    const int64_t out_height = size_vec(0);
+    const int64_t out_width = size_vec(1);
+    OP_REQUIRES(context, out_height > 0 && out_width > 0,
+                errors::InvalidArgument("size must be positive, got [",
+                                        out_height, ", ", out_width, "]"));
+
+    const StringPiece input = contents.scalar<tstring>()();
+    OP_REQUIRES(context, input.size() <= std::numeric_limits<int>::max(),
+                errors::InvalidArgument("JPEG contents are too large for int: ",
+                                        input.size()));
+    int image_width, image_height;
+    OP_REQUIRES(context,
+                jpeg::GetImageInfo(input.data(), input.size(), &image_width,
+                                   &image_height, nullptr),
+                errors::InvalidArgument("Invalid JPEG data, size ",
+                                        input.size()));
+
+    const auto crop_vec = crop_window.vec<int32>();
+    const int64_t crop_y = crop_vec(0);
+    const int64_t crop_x = crop_vec(1);
+    const int64_t crop_height = crop_vec(2);
+    const int64_t crop_width = crop_vec(3);
+    OP_REQUIRES(context,
+                crop_y >= 0 && crop_x >= 0 && crop_height > 0 &&
+                    crop_width > 0 && crop_y + crop_height <= image_height &&
+                    crop_x + crop_width <= image_width,
+                errors::InvalidArgument(
+                    "Invalid crop window [", crop_y, ", ", crop_x, ", ",
+                    crop_height, ", ", crop_width, "] for image of size ",
+                    image_height, "x", image_width));
+
+    jpeg::UncompressFlags flags = flags_;
+    flags.ratio = DecodeRatio(crop_height, crop_width, out_height, out_width);
+    // libjpeg rounds the scaled image size up.
+    const int64_t scaled_height =
+        (image_height + flags.ratio - 1) / flags.ratio;
+    const int64_t scaled_width = (image_width + flags.ratio - 1) / flags.ratio;
+    flags.crop_y = crop_y / flags.ratio;
+    flags.crop_x = crop_x / flags.ratio;
+    flags.crop_height =
+        std::min(scaled_height, (crop_y + crop_height + flags.ratio - 1) /
+                                    flags.ratio) -
+        flags.crop_y;
+    flags.crop_width =
+        std::min(scaled_width,
+                 (crop_x + crop_width + flags.ratio - 1) / flags.ratio) -
+        flags.crop_x;
+
+    std::unique_ptr<uint8[]> buffer;
+    int64_t in_height = 0, in_width = 0, channels = 0;
+    Tensor* output = nullptr;
+    const bool decoded =
+        jpeg::Uncompress(
+            input.data(), input.size(), flags, nullptr /* nwarn */,
+            [&](int width, int height, int components) -> uint8* {
+              Status status = context->allocate_output(
+                  0, TensorShape({out_height, out_width, components}),
+                  &output);
+              if (!status.ok()) {
+                VLOG(1) << status;
+                context->SetStatus(status);
+                return nullptr;
+              }
+              in_height = height;
+              in_width = width;
+              channels = components;
+              buffer.reset(new uint8[height * width * components]);
+              return buffer.get();
+            }) != nullptr;
+    if (!context->status().ok()) return;
+    OP_REQUIRES(
+        context, decoded,
+        errors::InvalidArgument(
+            "jpeg::Uncompress failed. Invalid JPEG data or crop window."));
+
+    // The decoded window is rounded out to whole scaled pixels, so the crop
+    // starts and ends at fractional positions within it.
+    const float ratio = flags.ratio;
+    const float crop_start_y = crop_y / ratio - flags.crop_y;
+    const float crop_start_x = crop_x / ratio - flags.crop_x;
+    const float crop_size_y = crop_height / ratio;
+    const float crop_size_x = crop_width / ratio;
+    std::vector<Interpolation> ys, xs;
+    if (half_pixel_centers_) {
+      ys = ComputeInterpolation(HalfPixelScaler(), out_height, in_height,
+                                crop_start_y, crop_size_y,
+                                in_width * channels);
+      xs = ComputeInterpolation(HalfPixelScaler(), out_width, in_width,
+                                crop_start_x, crop_size_x, channels);
+    } else {
+      ys = ComputeInterpolation(LegacyScaler(), out_height, in_height,
+                                crop_start_y, crop_size_y,
+                                in_width * channels);
+      xs = ComputeInterpolation(LegacyScaler(), out_width, in_width,
+                                crop_start_x, crop_size_x, channels);
+    }
+
+    const uint8* in = buffer.get();
+    float* out = output->flat<float>().data();
+    const int64_t out_row_size = out_width * channels;
+    auto resize_rows = [&](int64_t start, int64_t limit) {
+      for (int64_t y = start; y < limit; ++y) {
+        const uint8* top = in + ys[y].lower;
+        const uint8* bottom = in + ys[y].upper;
+        float* out_row = out + y * out_row_size;
+        if (channels == 3) {
+          ResizeRow<3>(top, bottom, ys[y].lerp, xs, channels, out_row);
+        } else if (channels == 1) {
+          ResizeRow<1>(top, bottom, ys[y].lerp, xs, channels, out_row);
+        } else {
+          ResizeRow<0>(top, bottom, ys[y].lerp, xs, channels, out_row);
+        }
+      }
+    };
+    // Each output value reads four input values and interpolates three times.
+    const int64_t cost_per_row = out_row_size * 12;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, out_height,
+          cost_per_row, resize_rows);
+  }
+
+ private:
+  // Returns the largest IDCT scaling denominator that keeps a crop of
+  // `crop_height`x`crop_width` at least `out_height`x`out_width`.
+  static int DecodeRatio(int64_t crop_height, int64_t crop_width,
+                         int64_t out_height, int64_t out_width) {
+    for (int ratio : {8, 4, 2}) {
+      if (crop_height >= out_height * ratio &&
+          crop_width >= out_width * ratio) {
+        return ratio;
+      }
+    }
+    return 1;
+  }
+
+  int channels_;
+  bool half_pixel_centers_;
+  jpeg::UncompressFlags flags_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("DecodeCropAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeCropAndResizeJpegOp);
+
+}  // namespace
+}  // namespace tensorflow
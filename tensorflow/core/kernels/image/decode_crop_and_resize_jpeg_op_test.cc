@@ -0,0 +1,123 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class DecodeCropAndResizeJpegTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("decode_op", "DecodeCropAndResizeJpeg")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("channels", 3)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Returns a `height`x`width` RGB JPEG whose left and right halves are dark
+  // and light.
+  static tstring MakeJpeg(int height, int width) {
+    std::vector<uint8> image(height * width * 3);
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < 3; ++c) {
+          image[(y * width + x) * 3 + c] = x < width / 2 ? 40 : 200;
+        }
+      }
+    }
+    jpeg::CompressFlags flags;
+    flags.format = jpeg::FORMAT_RGB;
+    flags.quality = 100;
+    return jpeg::Compress(image.data(), width, height, flags);
+  }
+};
+
+TEST_F(DecodeCropAndResizeJpegTest, DecodesCropAtOutputSize) {
+  MakeOp();
+  // The crop is eight times the output, so it is decoded at 1/8 scale.
+  AddInputFromList<tstring>(TensorShape({}), {MakeJpeg(256, 256)});
+  AddInputFromArray<int32>(TensorShape({4}), {64, 0, 128, 256});
+  AddInputFromArray<int32>(TensorShape({2}), {16, 32});
+  TF_ASSERT_OK(RunOpKernel());
+
+  const Tensor& image = *GetOutput(0);
+  ASSERT_EQ(image.shape(), TensorShape({16, 32, 3}));
+  const auto pixels = image.tensor<float, 3>();
+  for (int y = 0; y < 16; ++y) {
+    for (int c = 0; c < 3; ++c) {
+      EXPECT_NEAR(pixels(y, 4, c), 40, 4);
+      EXPECT_NEAR(pixels(y, 28, c), 200, 4);
+    }
+  }
+}
+
+TEST_F(DecodeCropAndResizeJpegTest, KeepsFractionalCropOffset) {
+  MakeOp();
+  // At 1/8 scale the crop starts at column 12.875 of the scaled image and the
+  // edge between the halves is at column 16, i.e. 3.125 output columns in.
+  AddInputFromList<tstring>(TensorShape({}), {MakeJpeg(256, 256)});
+  AddInputFromArray<int32>(TensorShape({4}), {0, 103, 64, 64});
+  AddInputFromArray<int32>(TensorShape({2}), {8, 8});
+  TF_ASSERT_OK(RunOpKernel());
+
+  const Tensor& image = *GetOutput(0);
+  ASSERT_EQ(image.shape(), TensorShape({8, 8, 3}));
+  const auto pixels = image.tensor<float, 3>();
+  for (int y = 0; y < 8; ++y) {
+    for (int c = 0; c < 3; ++c) {
+      EXPECT_NEAR(pixels(y, 2, c), 40, 4);
+      // Interpolates 7/8 of the way from the dark to the light column.
+      EXPECT_NEAR(pixels(y, 3, c), 180, 8);
+      EXPECT_NEAR(pixels(y, 4, c), 200, 4);
+    }
+  }
+}
+
+TEST_F(DecodeCropAndResizeJpegTest, UpscalesSmallCrop) {
+  MakeOp();
+  AddInputFromList<tstring>(TensorShape({}), {MakeJpeg(32, 32)});
+  AddInputFromArray<int32>(TensorShape({4}), {0, 0, 8, 8});
+  AddInputFromArray<int32>(TensorShape({2}), {24, 24});
+  TF_ASSERT_OK(RunOpKernel());
+
+  const Tensor& image = *GetOutput(0);
+  ASSERT_EQ(image.shape(), TensorShape({24, 24, 3}));
+  const auto pixels = image.tensor<float, 3>();
+  EXPECT_NEAR(pixels(12, 12, 0), 40, 4);
+}
+
+TEST_F(DecodeCropAndResizeJpegTest, FailsForCropOutsideImage) {
+  MakeOp();
+  AddInputFromList<tstring>(TensorShape({}), {MakeJpeg(32, 32)});
+  AddInputFromArray<int32>(TensorShape({4}), {16, 0, 17, 32});
+  AddInputFromArray<int32>(TensorShape({2}), {8, 8});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
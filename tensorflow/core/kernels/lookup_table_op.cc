@@ -16,9 +16,15 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
@@ -27,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace lookup {
@@ -36,12 +43,27 @@ std::string UniqueNodeName(const std::string& base) {
   return strings::StrCat(base, "/", counter.fetch_add(1), "/", random::New64());
 }
 
+// Returns a hash of `key` for partitioning and sketching tables.
+inline uint64 HashTableKey(const tstring& key, uint64 seed = 0) {
+  return Hash64(key.data(), key.size(), seed);
+}
+template <typename T>
+inline uint64 HashTableKey(const T& key, uint64 seed = 0) {
+  return Hash64(reinterpret_cast<const char*>(&key), sizeof(key), seed);
+}
+
 // Lookup table that wraps an unordered_map, where the key and value data type
 // is specified. Each individual value must be a scalar. If vector values are
 // required, use MutableHashTableOfTensors.
 //
 // This table is mutable and thread safe - Insert can be called at any time.
 //
+// If the `num_shards` attr is greater than one, the keys are partitioned by
+// hash into that many maps with their own locks, so that inserts only block
+// lookups of keys in the same shard, and large lookups are parallelized over
+// the intra-op thread pool. A batch of inserts or removals is then no longer
+// applied atomically, and exports are only consistent per shard.
+//
 // Sample use case:
 //
 // MutableHashTableOfScalars<int64, int64> table;  // int64 -> int64.
@@ -53,11 +75,24 @@ std::string UniqueNodeName(const std::string& base) {
 template <class K, class V>
 class MutableHashTableOfScalars final : public LookupInterface {
  public:
-  MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
+  MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {
+    int64_t num_shards = 1;
+    if (TryGetNodeAttr(kernel->def(), "num_shards", &num_shards)) {
+      OP_REQUIRES(ctx, num_shards >= 1,
+                  errors::InvalidArgument("num_shards must be positive, got ",
+                                          num_shards));
+    }
+    num_shards_ = num_shards;
+    shards_ = std::make_unique<TableShard[]>(num_shards_);
+  }
 
   size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
+    size_t size = 0;
+    for (int64_t i = 0; i < num_shards_; ++i) {
+      tf_shared_lock l(shards_[i].mu);
+      size += shards_[i].table.size();
+    }
+    return size;
   }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
@@ -70,17 +105,28 @@ class MutableHashTableOfScalars final : public LookupInterface {
     int64_t default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      // is_full_size_default is true:
-      //   Each key has an independent default value, key_values(i)
-      //   corresponding uses default_flat(i) as its default value.
-      //
-      // is_full_size_default is false:
-      //   All keys will share the default_flat(0) as default value.
-      value_values(i) = gtl::FindWithDefault(
-          table_, SubtleMustCopyIfIntegral(key_values(i)),
-          is_full_size_default ? default_flat(i) : default_flat(0));
+    auto find = [&](int64_t begin, int64_t end) {
+      ForEachKey<tf_shared_lock>(
+          key_values, begin, end,
+          [&](int64_t i, const K& key, std::unordered_map<K, V>& table) {
+            // is_full_size_default is true:
+            //   Each key has an independent default value, key_values(i)
+            //   corresponding uses default_flat(i) as its default value.
+            //
+            // is_full_size_default is false:
+            //   All keys will share the default_flat(0) as default value.
+            value_values(i) = gtl::FindWithDefault(
+                table, key,
+                is_full_size_default ? default_flat(i) : default_flat(0));
+          });
+    };
+    if (num_shards_ > 1 && ctx != nullptr) {
+      // Only lookups in sharded tables can proceed concurrently.
+      auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+      Shard(worker_threads->num_threads, worker_threads->workers,
+            key_values.size(), kFindCostPerKey, find);
+    } else {
+      find(0, key_values.size());
     }
 
     return absl::OkStatus();
@@ -90,14 +136,20 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = keys.flat<K>();
     const auto value_values = values.flat<V>();
 
-    mutex_lock l(mu_);
     if (clear) {
-      table_.clear();
-    }
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          SubtleMustCopyIfIntegral(value_values(i)));
+      AllShardsLock l(this, /*shared=*/false);
+      for (int64_t i = 0; i < num_shards_; ++i) {
+        shards_[i].table.clear();
+      }
+      InsertAllLocked(key_values, value_values);
+      return absl::OkStatus();
     }
+    ForEachKey<mutex_lock>(
+        key_values, 0, key_values.size(),
+        [&](int64_t i, const K& key, std::unordered_map<K, V>& table) {
+          gtl::InsertOrUpdate(&table, key,
+                              SubtleMustCopyIfIntegral(value_values(i)));
+        });
     return absl::OkStatus();
   }
 
@@ -109,10 +161,11 @@ class MutableHashTableOfScalars final : public LookupInterface {
   Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
-    }
+    ForEachKey<mutex_lock>(
+        key_values, 0, key_values.size(),
+        [](int64_t i, const K& key, std::unordered_map<K, V>& table) {
+          table.erase(key);
+        });
     return absl::OkStatus();
   }
 
@@ -122,8 +175,8 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    AllShardsLock l(this, /*shared=*/true);
+    int64_t size = SizeLocked();
 
     Tensor* keys;
     Tensor* values;
@@ -145,21 +198,25 @@ class MutableHashTableOfScalars final : public LookupInterface {
 
   int64_t MemoryUsed() const override {
     int64_t ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
+    for (int64_t s = 0; s < num_shards_; ++s) {
+      tf_shared_lock l(shards_[s].mu);
+      const std::unordered_map<K, V>& table = shards_[s].table;
+      for (unsigned i = 0; i < table.bucket_count(); ++i) {
+        size_t bucket_size = table.bucket_size(i);
+        if (bucket_size == 0) {
+          ret++;
+        } else {
+          ret += bucket_size;
+        }
       }
     }
-    return sizeof(MutableHashTableOfScalars) + ret;
+    return sizeof(MutableHashTableOfScalars) +
+           num_shards_ * sizeof(TableShard) + ret;
   }
 
   Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    AllShardsLock l(this, /*shared=*/true);
+    int64_t size = SizeLocked();
     Tensor keys(key_dtype(), TensorShape({size}));
     Tensor values(value_dtype(), TensorShape({size}));
     ExportKeysAndValues(&keys, &values);
@@ -170,13 +227,18 @@ class MutableHashTableOfScalars final : public LookupInterface {
     // is created in.
     // TODO(b/181695913): Provide a mechanism for deleting this resource
     // earlier when appropriate.
-    Node* table = ops::SourceOp(
-        "MutableHashTableV2",
+    const GraphDefBuilder::Options table_opts =
         builder->opts()
             .WithName(UniqueNodeName("MutableHashTableFromGraphDef"))
             .WithAttr("use_node_name_sharing", true)
             .WithAttr("key_dtype", key_dtype())
-            .WithAttr("value_dtype", value_dtype()));
+            .WithAttr("value_dtype", value_dtype());
+    // Leave out the default so that the graph remains loadable by binaries
+    // without sharded tables.
+    Node* table = ops::SourceOp(
+        "MutableHashTableV2",
+        num_shards_ > 1 ? table_opts.WithAttr("num_shards", num_shards_)
+                        : table_opts);
     Node* keys_node = ops::SourceOp(
         "Const",
         builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
@@ -195,25 +257,116 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
  private:
+  // Estimated cost of looking up one key, for sharding `Find` over threads.
+  static constexpr int64_t kFindCostPerKey = 250;
+
+  // Aligned to avoid false sharing of the locks of neighboring shards.
+  struct alignas(64) TableShard {
+    mutable mutex mu;
+    std::unordered_map<K, V> table TF_GUARDED_BY(mu);
+  };
+
+  // Holds the locks of all shards, acquired in shard order.
+  class AllShardsLock {
+   public:
+    AllShardsLock(const MutableHashTableOfScalars* table, bool shared)
+        TF_NO_THREAD_SAFETY_ANALYSIS : table_(table),
+                                       shared_(shared) {
+      for (int64_t i = 0; i < table_->num_shards_; ++i) {
+        if (shared_) {
+          table_->shards_[i].mu.lock_shared();
+        } else {
+          table_->shards_[i].mu.lock();
+        }
+      }
+    }
+
+    ~AllShardsLock() TF_NO_THREAD_SAFETY_ANALYSIS {
+      for (int64_t i = table_->num_shards_ - 1; i >= 0; --i) {
+        if (shared_) {
+          table_->shards_[i].mu.unlock_shared();
+        } else {
+          table_->shards_[i].mu.unlock();
+        }
+      }
+    }
+
+   private:
+    const MutableHashTableOfScalars* const table_;
+    const bool shared_;
+  };
+
+  // Calls `fn(i, key, table)` for the keys in [`begin`, `end`) with the table
+  // of the shard of each key locked by a `Lock`. With a single shard the lock
+  // is held across all keys, so that a batch is applied atomically.
+  template <typename Lock, typename Fn>
+  void ForEachKey(const typename TTypes<K>::ConstFlat& keys, int64_t begin,
+                  int64_t end, Fn fn) const TF_NO_THREAD_SAFETY_ANALYSIS {
+    if (num_shards_ == 1) {
+      Lock l(shards_[0].mu);
+      for (int64_t i = begin; i < end; ++i) {
+        fn(i, SubtleMustCopyIfIntegral(keys(i)), shards_[0].table);
+      }
+      return;
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      const K key = SubtleMustCopyIfIntegral(keys(i));
+      TableShard& shard = shards_[HashTableKey(key) % num_shards_];
+      Lock l(shard.mu);
+      fn(i, key, shard.table);
+    }
+  }
+
+  int64_t SizeLocked() const TF_NO_THREAD_SAFETY_ANALYSIS {
+    int64_t size = 0;
+    for (int64_t i = 0; i < num_shards_; ++i) {
+      size += shards_[i].table.size();
+    }
+    return size;
+  }
+
+  void InsertAllLocked(const typename TTypes<K>::ConstFlat& keys,
+                       const typename TTypes<V>::ConstFlat& values)
+      TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (int64_t i = 0; i < keys.size(); ++i) {
+      const K key = SubtleMustCopyIfIntegral(keys(i));
+      gtl::InsertOrUpdate(&shards_[HashTableKey(key) % num_shards_].table, key,
+                          SubtleMustCopyIfIntegral(values(i)));
+    }
+  }
+
   // Writes all keys and values into `keys` and `values`. `keys` and `values`
-  // must point to tensors of size `table_.size()`.
+  // must point to tensors of size `SizeLocked()`. The locks of all shards must
+  // be held.
   void ExportKeysAndValues(Tensor* keys, Tensor* values) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) {
+      TF_NO_THREAD_SAFETY_ANALYSIS {
     auto keys_data = keys->flat<K>();
     auto values_data = values->flat<V>();
     int64_t i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      keys_data(i) = it->first;
-      values_data(i) = it->second;
+    for (int64_t s = 0; s < num_shards_; ++s) {
+      const std::unordered_map<K, V>& table = shards_[s].table;
+      for (auto it = table.begin(); it != table.end(); ++it, ++i) {
+        keys_data(i) = it->first;
+        values_data(i) = it->second;
+      }
     }
   }
 
-  mutable mutex mu_;
-  std::unordered_map<K, V> table_ TF_GUARDED_BY(mu_);
+  int64_t num_shards_;
+  std::unique_ptr<TableShard[]> shards_;
 };
 
 // Lookup table that wraps an unordered_map. Behaves identical to
 // MutableHashTableOfScalars except that each value must be a vector.
+//
+// The table can be bounded for dynamic vocabularies such as embeddings:
+// - If `admission_threshold` is greater than one, a new key is only inserted
+//   once it has been inserted that many times, as estimated by a count-min
+//   sketch whose counts are periodically halved.
+// - If `max_size` is positive, the entries that were looked up least often
+//   ('lfu') or least recently ('lru') are evicted when an insert makes the
+//   table grow beyond `max_size`.
+// Imports are neither subject to admission nor counted by the sketch.
 template <class K, class V>
 class MutableHashTableOfTensors final : public LookupInterface {
  public:
@@ -224,6 +377,31 @@ class MutableHashTableOfTensors final : public LookupInterface {
         ctx, TensorShapeUtils::IsVector(value_shape_),
         errors::InvalidArgument("Default value must be a vector, got shape ",
                                 value_shape_.DebugString()));
+    if (TryGetNodeAttr(kernel->def(), "max_size", &max_size_)) {
+      OP_REQUIRES(ctx, max_size_ >= 0,
+                  errors::InvalidArgument("max_size must be non-negative, got ",
+                                          max_size_));
+    }
+    if (TryGetNodeAttr(kernel->def(), "admission_threshold",
+                       &admission_threshold_)) {
+      OP_REQUIRES(ctx, admission_threshold_ >= 1,
+                  errors::InvalidArgument(
+                      "admission_threshold must be positive, got ",
+                      admission_threshold_));
+    }
+    std::string eviction_policy = "lfu";
+    TryGetNodeAttr(kernel->def(), "eviction_policy", &eviction_policy);
+    OP_REQUIRES(
+        ctx, eviction_policy == "lfu" || eviction_policy == "lru",
+        errors::InvalidArgument("eviction_policy must be 'lfu' or 'lru', got ",
+                                eviction_policy));
+    evict_least_recently_used_ = eviction_policy == "lru";
+    if (admission_threshold_ > 1) {
+      // Size the sketch for about as many distinct keys as the table holds.
+      sketch_width_ = std::clamp<int64_t>(max_size_ > 0 ? max_size_ : 1 << 16,
+                                          1 << 12, 1 << 24);
+      sketch_.resize(kSketchDepth * sketch_width_);
+    }
   }
 
   size_t size() const override {
@@ -242,13 +420,19 @@ class MutableHashTableOfTensors final : public LookupInterface {
     int64_t default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
+    const int64_t now =
+        max_size_ > 0 ? clock_.fetch_add(1, std::memory_order_relaxed) : 0;
     tf_shared_lock l(mu_);
     for (int64_t i = 0; i < key_values.size(); ++i) {
-      ValueArray* value_vec =
+      const Entry* entry =
           gtl::FindOrNull(table_, SubtleMustCopyIfIntegral(key_values(i)));
-      if (value_vec != nullptr) {
+      if (entry != nullptr) {
         for (int64_t j = 0; j < value_dim; j++) {
-          value_values(i, j) = value_vec->at(j);
+          value_values(i, j) = entry->value.at(j);
+        }
+        if (max_size_ > 0) {
+          entry->frequency.fetch_add(1, std::memory_order_relaxed);
+          entry->last_access.store(now, std::memory_order_relaxed);
         }
       } else {
         // is_full_size_default is true:
@@ -272,18 +456,30 @@ class MutableHashTableOfTensors final : public LookupInterface {
     const auto value_values = values.flat_inner_dims<V, 2>();
     int64_t value_dim = value_shape_.dim_size(0);
 
+    const int64_t now = clock_.fetch_add(1, std::memory_order_relaxed);
     mutex_lock l(mu_);
     if (clear) {
       table_.clear();
     }
     for (int64_t i = 0; i < key_values.size(); ++i) {
-      ValueArray value_vec;
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto it = table_.find(key);
+      if (it == table_.end()) {
+        if (!clear && !AdmitLocked(key)) continue;
+        it = table_.try_emplace(key).first;
+        it->second.frequency.store(new_entry_frequency_,
+                                   std::memory_order_relaxed);
+        it->second.last_access.store(now, std::memory_order_relaxed);
+      }
+      ValueArray& value_vec = it->second.value;
+      value_vec.clear();
       for (int64_t j = 0; j < value_dim; j++) {
         V value = value_values(i, j);
         value_vec.push_back(value);
       }
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          value_vec);
+    }
+    if (max_size_ > 0 && table_.size() > static_cast<size_t>(max_size_)) {
+      EvictLocked();
     }
     return absl::OkStatus();
   }
@@ -342,7 +538,8 @@ class MutableHashTableOfTensors final : public LookupInterface {
         ret += bucket_size;
       }
     }
-    return sizeof(MutableHashTableOfTensors) + ret;
+    return sizeof(MutableHashTableOfTensors) + ret +
+           sketch_.size() * sizeof(uint32);
   }
 
   Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
@@ -358,14 +555,23 @@ class MutableHashTableOfTensors final : public LookupInterface {
     // manager it is created in.
     // TODO(b/181695913): Provide a mechanism for deleting this resource
     // earlier when appropriate.
-    Node* table =
-        ops::SourceOp("MutableHashTableOfTensorsV2",
-                      builder->opts()
-                          .WithName(UniqueNodeName("MutableHashTableOfTensors"))
-                          .WithAttr("use_node_name_sharing", true)
-                          .WithAttr("key_dtype", key_dtype())
-                          .WithAttr("value_dtype", value_dtype())
-                          .WithAttr("value_shape", value_shape_));
+    const GraphDefBuilder::Options table_opts =
+        builder->opts()
+            .WithName(UniqueNodeName("MutableHashTableOfTensors"))
+            .WithAttr("use_node_name_sharing", true)
+            .WithAttr("key_dtype", key_dtype())
+            .WithAttr("value_dtype", value_dtype())
+            .WithAttr("value_shape", value_shape_);
+    // Leave out the defaults so that the graph remains loadable by binaries
+    // without bounded tables.
+    Node* table = ops::SourceOp(
+        "MutableHashTableOfTensorsV2",
+        max_size_ > 0 || admission_threshold_ > 1
+            ? table_opts.WithAttr("max_size", max_size_)
+                  .WithAttr("admission_threshold", admission_threshold_)
+                  .WithAttr("eviction_policy",
+                            evict_least_recently_used_ ? "lru" : "lfu")
+            : table_opts);
     Node* keys_node = ops::SourceOp(
         "Const",
         builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
@@ -384,6 +590,83 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
  private:
+  typedef gtl::InlinedVector<V, 4> ValueArray;
+
+  struct Entry {
+    ValueArray value;
+    // Usage statistics for eviction. Lookups update them under a shared lock.
+    mutable std::atomic<int64_t> frequency{0};
+    mutable std::atomic<int64_t> last_access{0};
+  };
+
+  // Number of rows of the count-min sketch.
+  static constexpr int kSketchDepth = 4;
+
+  // Records an insert of `key`, which is not in the table, and returns
+  // whether it has been inserted often enough to be admitted.
+  bool AdmitLocked(const K& key) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (admission_threshold_ <= 1) return true;
+    uint32 count = std::numeric_limits<uint32>::max();
+    for (int row = 0; row < kSketchDepth; ++row) {
+      uint32& counter =
+          sketch_[row * sketch_width_ +
+                  HashTableKey(key, /*seed=*/row) % sketch_width_];
+      if (counter < std::numeric_limits<uint32>::max()) ++counter;
+      count = std::min(count, counter);
+    }
+    // Halve all counts periodically, so that keys that were frequent long ago
+    // do not stay admissible forever.
+    if (++sketch_increments_ >= 10 * sketch_width_) {
+      for (uint32& counter : sketch_) counter /= 2;
+      sketch_increments_ = 0;
+    }
+    return count >= admission_threshold_;
+  }
+
+  // Evicts the least used entries until the table is somewhat smaller than
+  // `max_size_`, so that the cost of finding them is amortized over inserts.
+  //
+  // With LFU eviction, the frequencies of the remaining entries are then
+  // halved, so that entries that were popular long ago eventually make room,
+  // and new entries start at the halved frequency of the least used
+  // remaining entry. Otherwise a new entry would be the first to be evicted
+  // from a full table the next time, before it had a chance to be looked up.
+  void EvictLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const int64_t target_size = max_size_ - max_size_ / 16;
+    std::vector<typename std::unordered_map<K, Entry>::iterator> entries;
+    entries.reserve(table_.size());
+    for (auto it = table_.begin(); it != table_.end(); ++it) {
+      entries.push_back(it);
+    }
+    const int64_t num_evicted =
+        static_cast<int64_t>(entries.size()) - target_size;
+    // Ties in frequency are broken by recency.
+    auto usage = [this](const typename std::unordered_map<K, Entry>::iterator&
+                            it) {
+      return std::make_pair(
+          evict_least_recently_used_
+              ? 0
+              : it->second.frequency.load(std::memory_order_relaxed),
+          it->second.last_access.load(std::memory_order_relaxed));
+    };
+    std::nth_element(entries.begin(), entries.begin() + num_evicted,
+                     entries.end(), [&](const auto& a, const auto& b) {
+                       return usage(a) < usage(b);
+                     });
+    for (int64_t i = 0; i < num_evicted; ++i) {
+      table_.erase(entries[i]);
+    }
+    if (evict_least_recently_used_ || table_.empty()) return;
+    int64_t min_frequency = std::numeric_limits<int64_t>::max();
+    for (auto& [key, entry] : table_) {
+      const int64_t frequency =
+          entry.frequency.load(std::memory_order_relaxed) / 2;
+      entry.frequency.store(frequency, std::memory_order_relaxed);
+      min_frequency = std::min(min_frequency, frequency);
+    }
+    new_entry_frequency_ = min_frequency;
+  }
+
   // Writes all keys and values into `keys` and `values`. `keys` and `values`
   // must point to tensors of size `table_.size()`.
   void ExportKeysAndValues(Tensor* keys, Tensor* values) const
@@ -394,7 +677,7 @@ class MutableHashTableOfTensors final : public LookupInterface {
     int64_t i = 0;
     for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
       K key = it->first;
-      ValueArray value = it->second;
+      const ValueArray& value = it->second.value;
       keys_data(i) = key;
       for (int64_t j = 0; j < value_dim; j++) {
         values_data(i, j) = value[j];
@@ -403,9 +686,18 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
   TensorShape value_shape_;
+  int64_t max_size_ = 0;
+  int64_t admission_threshold_ = 1;
+  bool evict_least_recently_used_ = false;
   mutable mutex mu_;
-  typedef gtl::InlinedVector<V, 4> ValueArray;
-  std::unordered_map<K, ValueArray> table_ TF_GUARDED_BY(mu_);
+  std::unordered_map<K, Entry> table_ TF_GUARDED_BY(mu_);
+  // Logical time of lookups and inserts, for LRU eviction.
+  mutable std::atomic<int64_t> clock_{0};
+  int64_t sketch_width_ = 0;
+  std::vector<uint32> sketch_ TF_GUARDED_BY(mu_);
+  int64_t sketch_increments_ TF_GUARDED_BY(mu_) = 0;
+  // Frequency that new entries start at with LFU eviction.
+  int64_t new_entry_frequency_ TF_GUARDED_BY(mu_) = 0;
 };
 
 namespace {
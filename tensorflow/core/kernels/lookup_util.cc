@@ -34,6 +34,8 @@ using InitializerSerializer =
     ::tensorflow::lookup::InitializableLookupTable::InitializerSerializer;
 
 static const int kInputBufferSize = 1 * 1024 * 1024; /* bytes */
+// Number of lines parsed into the keys and values tensors of one iteration.
+static const int kLinesPerBatch = 1024;
 static const int kLineNumber = -1;
 static const int kWholeLine = -2;
 
@@ -57,9 +59,10 @@ Status GetNumLinesInTextFile(Env* env, const string& vocab_file,
   return absl::OkStatus();
 }
 
-// Iterator that reads a text file. Each iteration process one line, it parses
-// the line and populates the keys and values tensors used for initialization
-// with a single key and corresponding value.
+// Iterator that reads a text file. Each iteration processes up to
+// kLinesPerBatch lines, it parses the lines and populates the keys and values
+// tensors used for initialization with one key and corresponding value per
+// line, so that the table inserts them in batches.
 //
 // What information of the line to populate the key or values is specified by
 // providing key_index and value_index.
@@ -87,8 +90,8 @@ class TextFileLineIterator
     filename_ = filename;
     vocab_size_ = vocab_size;
     delimiter_ = delimiter;
-    key_ = Tensor(key_dtype, TensorShape({}));
-    value_ = Tensor(value_dtype, TensorShape({}));
+    key_ = Tensor(key_dtype, TensorShape({kLinesPerBatch}));
+    value_ = Tensor(value_dtype, TensorShape({kLinesPerBatch}));
     key_index_ = key_index;
     value_index_ = value_index;
     env_ = env;
@@ -108,69 +111,36 @@ class TextFileLineIterator
   void Next() override {
     if (!valid_) return;
 
-    string line;
-    status_ = input_buffer_->ReadLine(&line);
-    if (!status_.ok()) {
-      if (absl::IsOutOfRange(status_) && vocab_size_ != -1 &&
-          next_id_ != vocab_size_) {
-        status_ = errors::InvalidArgument("Invalid vocab_size in ", filename_,
-                                          ": expected ", vocab_size_,
-                                          " but got ", next_id_);
-      }
+    // The line that ended the previous batch early ends the iteration.
+    if (!end_status_.ok()) {
+      status_ = end_status_;
       valid_ = false;
       return;
     }
-    if (vocab_size_ != -1 && next_id_ >= vocab_size_) {
-      LOG(WARNING) << "Truncated " << filename_ << " before its end at "
-                   << vocab_size_ << " records.";
-      LOG(WARNING) << "next_id_  : " << next_id_;
-      status_ = errors::OutOfRange("Finished reading ", vocab_size_,
-                                   " of lines from ", filename_);
-      valid_ = false;
-      return;
-    }
-    if (line.empty()) {
-      status_ = errors::InvalidArgument("Invalid content in ", filename_,
-                                        ": empty line found at position ",
-                                        input_buffer_->Tell(), ".");
-      valid_ = false;
-      return;
-    }
-
-    std::vector<string> tokens;
-    if (!ignore_split_) {
-      tokens = str_util::Split(line, delimiter_);
-      const auto expected_size =
-          static_cast<size_t>(std::max(key_index_, value_index_) + 1);
-      if (tokens.size() < expected_size) {
-        status_ = errors::InvalidArgument(
-            "Invalid number of columns in ", filename_, " line ", next_id_,
-            " (", line, ") : expected at least ", expected_size, " got ",
-            tokens.size());
-        valid_ = false;
-        return;
+    int64_t batch_size = 0;
+    while (batch_size < kLinesPerBatch) {
+      Status s = ReadLine(batch_size);
+      if (!s.ok()) {
+        end_status_ = s;
+        break;
       }
+      ++batch_size;
     }
-
-    status_ = SetValue(line, tokens, key_index_, &key_);
-    if (!status_.ok()) {
+    if (batch_size == 0) {
+      status_ = end_status_;
       valid_ = false;
       return;
     }
-    status_ = SetValue(line, tokens, value_index_, &value_);
-    if (!status_.ok()) {
-      valid_ = false;
-      return;
-    }
-
-    next_id_++;
+    status_ = absl::OkStatus();
+    batch_keys_ = key_.Slice(0, batch_size);
+    batch_values_ = value_.Slice(0, batch_size);
   }
 
   bool Valid() const override { return valid_; }
 
-  const Tensor& keys() const override { return key_; }
+  const Tensor& keys() const override { return batch_keys_; }
 
-  const Tensor& values() const override { return value_; }
+  const Tensor& values() const override { return batch_values_; }
 
   Status status() const override { return status_; }
 
@@ -188,8 +158,12 @@ class TextFileLineIterator
   }
 
  private:
+  // Buffers of kLinesPerBatch keys and values, and the slices of them that
+  // hold the current batch.
   Tensor key_;
   Tensor value_;
+  Tensor batch_keys_;
+  Tensor batch_values_;
   bool valid_;  // true if the iterator points to an existing range.
   int64_t key_index_;
   int64_t value_index_;
@@ -200,16 +174,64 @@ class TextFileLineIterator
   string filename_;
   char delimiter_;
   Status status_;
+  // The status of the line that ended the current batch, if any.
+  Status end_status_;
   bool ignore_split_;
   std::unique_ptr<RandomAccessFile> file_;  // must outlive input_buffer_
   std::unique_ptr<io::InputBuffer> input_buffer_;
 
-  // Set the corresponding value from line or tokens based on 'index' into the
-  // tensor 't'. The value is transformed to the given data type 'dtype'.
+  // Reads the next line and parses it into element 'i' of key_ and value_.
+  Status ReadLine(int64_t i) {
+    string line;
+    Status s = input_buffer_->ReadLine(&line);
+    if (!s.ok()) {
+      if (absl::IsOutOfRange(s) && vocab_size_ != -1 &&
+          next_id_ != vocab_size_) {
+        return errors::InvalidArgument("Invalid vocab_size in ", filename_,
+                                       ": expected ", vocab_size_, " but got ",
+                                       next_id_);
+      }
+      return s;
+    }
+    if (vocab_size_ != -1 && next_id_ >= vocab_size_) {
+      LOG(WARNING) << "Truncated " << filename_ << " before its end at "
+                   << vocab_size_ << " records.";
+      LOG(WARNING) << "next_id_  : " << next_id_;
+      return errors::OutOfRange("Finished reading ", vocab_size_,
+                                " of lines from ", filename_);
+    }
+    if (line.empty()) {
+      return errors::InvalidArgument("Invalid content in ", filename_,
+                                     ": empty line found at position ",
+                                     input_buffer_->Tell(), ".");
+    }
+
+    std::vector<string> tokens;
+    if (!ignore_split_) {
+      tokens = str_util::Split(line, delimiter_);
+      const auto expected_size =
+          static_cast<size_t>(std::max(key_index_, value_index_) + 1);
+      if (tokens.size() < expected_size) {
+        return errors::InvalidArgument(
+            "Invalid number of columns in ", filename_, " line ", next_id_,
+            " (", line, ") : expected at least ", expected_size, " got ",
+            tokens.size());
+      }
+    }
+
+    TF_RETURN_IF_ERROR(SetValue(line, tokens, key_index_, i, &key_));
+    TF_RETURN_IF_ERROR(SetValue(line, tokens, value_index_, i, &value_));
+    next_id_++;
+    return absl::OkStatus();
+  }
+
+  // Set the corresponding value from line or tokens based on 'index' into
+  // element 'i' of the tensor 't'. The value is transformed to the given data
+  // type 'dtype'.
   Status SetValue(const string& line, const std::vector<string>& tokens,
-                  int64_t index, Tensor* tensor) {
+                  int64_t index, int64_t i, Tensor* tensor) {
     if (index == kLineNumber) {
-      tensor->flat<int64_t>()(0) = next_id_ + offset_;
+      tensor->flat<int64_t>()(i) = next_id_ + offset_;
       return absl::OkStatus();
     }
     const string& token = (index == kWholeLine) ? line : tokens[index];
@@ -218,44 +240,39 @@ class TextFileLineIterator
       case DT_INT32: {
         int32_t value;
         if (!strings::safe_strto32(token.c_str(), &value)) {
-          valid_ = false;
           return errors::InvalidArgument("Field ", token, " in line ", next_id_,
                                          " is not a valid int32.");
         }
-        tensor->flat<int32>()(0) = value + offset_;
+        tensor->flat<int32>()(i) = value + offset_;
       } break;
       case DT_INT64: {
         int64_t value;
         if (!strings::safe_strto64(token.c_str(), &value)) {
-          valid_ = false;
           return errors::InvalidArgument("Field ", token, " in line ", next_id_,
                                          " is not a valid int64.");
         }
-        tensor->flat<int64_t>()(0) = value;
+        tensor->flat<int64_t>()(i) = value;
       } break;
       case DT_FLOAT: {
         float value;
         if (!strings::safe_strtof(token.c_str(), &value)) {
-          valid_ = false;
           return errors::InvalidArgument("Field ", token, " in line ", next_id_,
                                          " is not a valid float.");
         }
-        tensor->flat<float>()(0) = value;
+        tensor->flat<float>()(i) = value;
       } break;
       case DT_DOUBLE: {
         double value;
         if (!strings::safe_strtod(token.c_str(), &value)) {
-          valid_ = false;
           return errors::InvalidArgument("Field ", token, " in line ", next_id_,
                                          " is not a valid double.");
         }
-        tensor->flat<double>()(0) = value;
+        tensor->flat<double>()(i) = value;
       } break;
       case DT_STRING:
-        tensor->flat<tstring>()(0) = token;
+        tensor->flat<tstring>()(i) = token;
         break;
       default:
-        valid_ = false;
         return errors::InvalidArgument("Data type ", DataTypeString(dtype),
                                        " not supported.");
     }
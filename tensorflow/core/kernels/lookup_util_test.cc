@@ -0,0 +1,143 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/lookup_util.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/lookup_table_op.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace lookup {
+namespace {
+
+// Column indices of the line number and of the whole line.
+constexpr int32_t kLineNumber = -1;
+constexpr int32_t kWholeLine = -2;
+
+using Table = HashTable<int64_t, tstring>;
+
+// Writes `lines` to a file named `name` and returns its path.
+std::string WriteVocabFile(const std::string& name,
+                           const std::vector<std::string>& lines) {
+  const std::string filename = io::JoinPath(testing::TmpDir(), name);
+  std::string contents;
+  for (const std::string& line : lines) {
+    absl::StrAppend(&contents, line, "\n");
+  }
+  TF_CHECK_OK(WriteStringToFile(Env::Default(), filename, contents));
+  return filename;
+}
+
+// Returns "word<i>" for each of the `num_words` first lines.
+std::vector<std::string> Words(int num_words) {
+  std::vector<std::string> words;
+  for (int i = 0; i < num_words; ++i) {
+    words.push_back(absl::StrCat("word", i));
+  }
+  return words;
+}
+
+// Looks up `keys` in `table`, with "UNK" as the default value.
+Tensor Find(Table* table, const std::vector<int64_t>& keys) {
+  Tensor key_tensor = test::AsTensor<int64_t>(keys);
+  Tensor values(DT_STRING, TensorShape({static_cast<int64_t>(keys.size())}));
+  TF_CHECK_OK(table->Find(/*ctx=*/nullptr, key_tensor, &values,
+                          test::AsScalar<tstring>("UNK")));
+  return values;
+}
+
+// The iterator parses 1024 lines per batch, so these files span several
+// batches.
+
+TEST(InitializeTableFromTextFileTest, InitializesFromSeveralBatches) {
+  const std::string filename = WriteVocabFile("several_batches", Words(2500));
+  core::RefCountPtr<Table> table(new Table(nullptr, nullptr));
+  TF_ASSERT_OK(InitializeTableFromTextFile(
+      filename, /*vocab_size=*/-1, /*delimiter=*/'\t', kLineNumber,
+      kWholeLine, /*offset=*/0, Env::Default(), table.get()));
+  EXPECT_EQ(table->size(), 2500u);
+  test::ExpectTensorEqual<tstring>(
+      Find(table.get(), {0, 1023, 1024, 2047, 2048, 2499, 2500}),
+      test::AsTensor<tstring>({"word0", "word1023", "word1024", "word2047",
+                               "word2048", "word2499", "UNK"}));
+}
+
+TEST(InitializeTableFromTextFileTest, FailsForParseErrorAfterFirstBatch) {
+  std::vector<std::string> lines;
+  for (int i = 0; i < 1500; ++i) {
+    lines.push_back(absl::StrCat(i, "\tword", i));
+  }
+  lines[1200] = "not_a_number\tword1200";
+  const std::string filename = WriteVocabFile("parse_error", lines);
+  core::RefCountPtr<Table> table(new Table(nullptr, nullptr));
+  const Status s = InitializeTableFromTextFile(
+      filename, /*vocab_size=*/-1, /*delimiter=*/'\t', /*key_index=*/0,
+      /*value_index=*/1, /*offset=*/0, Env::Default(), table.get());
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), "not a valid int64")) << s;
+  EXPECT_FALSE(table->is_initialized());
+}
+
+TEST(InitializeTableFromTextFileTest, FailsForEmptyLineAfterFirstBatch) {
+  std::vector<std::string> lines = Words(1500);
+  lines[1100] = "";
+  const std::string filename = WriteVocabFile("empty_line", lines);
+  core::RefCountPtr<Table> table(new Table(nullptr, nullptr));
+  const Status s = InitializeTableFromTextFile(
+      filename, /*vocab_size=*/-1, /*delimiter=*/'\t', kLineNumber,
+      kWholeLine, /*offset=*/0, Env::Default(), table.get());
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), "empty line")) << s;
+  EXPECT_FALSE(table->is_initialized());
+}
+
+TEST(InitializeTableFromTextFileTest, TruncatesToVocabSizeWithinBatch) {
+  const std::string filename = WriteVocabFile("truncated", Words(2000));
+  core::RefCountPtr<Table> table(new Table(nullptr, nullptr));
+  TF_ASSERT_OK(InitializeTableFromTextFile(
+      filename, /*vocab_size=*/1100, /*delimiter=*/'\t', kLineNumber,
+      kWholeLine, /*offset=*/0, Env::Default(), table.get()));
+  EXPECT_EQ(table->size(), 1100u);
+  test::ExpectTensorEqual<tstring>(
+      Find(table.get(), {1023, 1024, 1099, 1100}),
+      test::AsTensor<tstring>({"word1023", "word1024", "word1099", "UNK"}));
+}
+
+TEST(InitializeTableFromTextFileTest, FailsForVocabSizeBeyondEndOfFile) {
+  const std::string filename = WriteVocabFile("too_short", Words(1500));
+  core::RefCountPtr<Table> table(new Table(nullptr, nullptr));
+  const Status s = InitializeTableFromTextFile(
+      filename, /*vocab_size=*/2000, /*delimiter=*/'\t', kLineNumber,
+      kWholeLine, /*offset=*/0, Env::Default(), table.get());
+  EXPECT_TRUE(errors::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), "Invalid vocab_size")) << s;
+}
+
+}  // namespace
+}  // namespace lookup
+}  // namespace tensorflow
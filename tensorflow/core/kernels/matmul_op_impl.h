@@ -40,7 +40,9 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/matmul_autotune.h"
 #include "tensorflow/core/util/matmul_bcast.h"
@@ -73,6 +75,13 @@ namespace tensorflow {
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
 
+// The small-matrix kernel below is also compiled for AVX2 and AVX-512, which
+// are picked at runtime on x86-64 hosts that support them.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(_WIN32)
+#define TF_SMALL_MATMUL_ISA_DISPATCH 1
+#endif
+
 namespace {
 
 // Returns the pair of dimensions along which to perform Tensor contraction to
@@ -256,6 +265,138 @@ struct SequentialMatMulKernel {
   }
 };
 
+// Sequential batch matmul kernel for many small real matrices. The general
+// matrix product packs its operands for every multiplication, which dominates
+// the cost for tiny matrices, so each product is computed by a loop nest
+// that keeps an output row in registers instead.
+template <typename Scalar>
+struct SmallMatMulKernel {
+  // Largest number of rows, columns and depth supported.
+  static constexpr int64_t kMaxSize = 32;
+
+  using MultiplyFn = void (*)(const Scalar*, const Scalar*, int64_t, int64_t,
+                              int64_t, Scalar*);
+
+  static bool CanUse(int64_t m, int64_t k, int64_t n) {
+    return !Eigen::NumTraits<Scalar>::IsComplex && m <= kMaxSize &&
+           k <= kMaxSize && n <= kMaxSize;
+  }
+
+  // Computes the row-major [m, n] product of the row-major [m, k] `x` and
+  // [k, n] `y`. `N` is the number of columns if it is known at compile time,
+  // or zero otherwise.
+  template <int N>
+  static EIGEN_ALWAYS_INLINE void MultiplyImpl(const Scalar* x, const Scalar* y,
+                                               int64_t m, int64_t k, int64_t n,
+                                               Scalar* z) {
+    const int64_t cols = N > 0 ? N : n;
+    for (int64_t i = 0; i < m; ++i) {
+      Scalar acc[N > 0 ? N : kMaxSize];
+      std::fill_n(acc, cols, Scalar(0));
+      const Scalar* x_row = x + i * k;
+      for (int64_t p = 0; p < k; ++p) {
+        const Scalar a = x_row[p];
+        const Scalar* y_row = y + p * cols;
+        for (int64_t j = 0; j < cols; ++j) acc[j] += a * y_row[j];
+      }
+      std::copy_n(acc, cols, z + i * cols);
+    }
+  }
+
+  template <int N>
+  static void Multiply(const Scalar* x, const Scalar* y, int64_t m, int64_t k,
+                       int64_t n, Scalar* z) {
+    MultiplyImpl<N>(x, y, m, k, n, z);
+  }
+
+#ifdef TF_SMALL_MATMUL_ISA_DISPATCH
+  // Copies of `Multiply` compiled for wider vectors than the baseline ISA of
+  // the build, so that a generic build uses them on hosts that support them.
+  template <int N>
+  __attribute__((target("avx2,fma"))) static void MultiplyAvx2(
+      const Scalar* x, const Scalar* y, int64_t m, int64_t k, int64_t n,
+      Scalar* z) {
+    MultiplyImpl<N>(x, y, m, k, n, z);
+  }
+
+  template <int N>
+  __attribute__((target("avx512f,avx2,fma"))) static void MultiplyAvx512(
+      const Scalar* x, const Scalar* y, int64_t m, int64_t k, int64_t n,
+      Scalar* z) {
+    MultiplyImpl<N>(x, y, m, k, n, z);
+  }
+#endif  // TF_SMALL_MATMUL_ISA_DISPATCH
+
+  // Returns the `Multiply` variant for the widest ISA supported by the host.
+  template <int N>
+  static MultiplyFn SelectMultiply() {
+#ifdef TF_SMALL_MATMUL_ISA_DISPATCH
+    if (port::TestCPUFeature(port::CPUFeature::AVX512F)) {
+      return &MultiplyAvx512<N>;
+    }
+    if (port::TestCPUFeature(port::CPUFeature::AVX2) &&
+        port::TestCPUFeature(port::CPUFeature::FMA)) {
+      return &MultiplyAvx2<N>;
+    }
+#endif  // TF_SMALL_MATMUL_ISA_DISPATCH
+    return &Multiply<N>;
+  }
+
+  template <int N>
+  static void DispatchMultiply(const Scalar* x, const Scalar* y, int64_t m,
+                               int64_t k, int64_t n, Scalar* z) {
+    static const MultiplyFn multiply = SelectMultiply<N>();
+    multiply(x, y, m, k, n, z);
+  }
+
+  static void Run(const Tensor& in_x, const Tensor& in_y, bool trans_x,
+                  bool trans_y, const MatMulBCast& bcast, Tensor* out,
+                  int start, int limit) {
+    const int64_t m = out->dim_size(1);
+    const int64_t n = out->dim_size(2);
+    const int64_t k = trans_x ? in_x.dim_size(1) : in_x.dim_size(2);
+    const bool should_bcast = bcast.IsBroadcastingRequired();
+    const auto& x_batch_indices = bcast.x_batch_indices();
+    const auto& y_batch_indices = bcast.y_batch_indices();
+
+    // Transposed operands are copied into row-major order first.
+    Scalar x_buf[kMaxSize * kMaxSize];
+    Scalar y_buf[kMaxSize * kMaxSize];
+    for (int64_t i = start; i < limit; ++i) {
+      const int64_t x_batch_index = should_bcast ? x_batch_indices[i] : i;
+      const int64_t y_batch_index = should_bcast ? y_batch_indices[i] : i;
+      const Scalar* x = in_x.flat<Scalar>().data() + x_batch_index * m * k;
+      const Scalar* y = in_y.flat<Scalar>().data() + y_batch_index * k * n;
+      Scalar* z = out->flat<Scalar>().data() + i * m * n;
+      if (trans_x) {
+        for (int64_t p = 0; p < k; ++p) {
+          for (int64_t r = 0; r < m; ++r) x_buf[r * k + p] = x[p * m + r];
+        }
+        x = x_buf;
+      }
+      if (trans_y) {
+        for (int64_t c = 0; c < n; ++c) {
+          for (int64_t p = 0; p < k; ++p) y_buf[p * n + c] = y[c * k + p];
+        }
+        y = y_buf;
+      }
+      switch (n) {
+        case 8:
+          DispatchMultiply<8>(x, y, m, k, n, z);
+          break;
+        case 16:
+          DispatchMultiply<16>(x, y, m, k, n, z);
+          break;
+        case 32:
+          DispatchMultiply<32>(x, y, m, k, n, z);
+          break;
+        default:
+          DispatchMultiply<0>(x, y, m, k, n, z);
+      }
+    }
+  }
+};
+
 // For single-batch multiplications, manually parallize by splitting the output
 // matrix.
 template <typename Scalar>
@@ -443,6 +584,23 @@ struct LaunchBatchMatMul<CPUDevice, Scalar> {
     } else if (batch_size > 1) {
       // Parallelize over outer dims. For small matrices and large batches, it
       // is counter-productive to parallelize the inner matrix multiplies.
+      if constexpr (!Eigen::NumTraits<Scalar>::IsComplex) {
+        const int64_t k =
+            trans_x || adj_x ? in_x.dim_size(1) : in_x.dim_size(2);
+        if (SmallMatMulKernel<Scalar>::CanUse(out->dim_size(1), k,
+                                              out->dim_size(2))) {
+          // Adjoint and transpose are the same for real matrices.
+          Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
+                cost_per_unit,
+                [&in_x, &in_y, adj_x, adj_y, trans_x, trans_y, &bcast, out](
+                    int start, int limit) {
+                  SmallMatMulKernel<Scalar>::Run(in_x, in_y, adj_x || trans_x,
+                                                 adj_y || trans_y, bcast, out,
+                                                 start, limit);
+                });
+          return;
+        }
+      }
       Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
             cost_per_unit,
             [&in_x, &in_y, adj_x, adj_y, trans_x, trans_y, &bcast, out](
@@ -900,6 +1058,11 @@ class BaseBatchMatMulOp : public OpKernel {
       adj_y_ = false;
       OP_REQUIRES_OK(context, context->GetAttr("grad_a", &grad_input_1_));
       OP_REQUIRES_OK(context, context->GetAttr("grad_b", &grad_input_2_));
+      // Set by the remapper when the right operand is a constant.
+      if (context->HasAttr("_rhs_is_const")) {
+        OP_REQUIRES_OK(context,
+                       context->GetAttr("_rhs_is_const", &rhs_is_const_));
+      }
     } else {
       OP_REQUIRES_OK(context, context->GetAttr("adj_x", &adj_x_));
       OP_REQUIRES_OK(context, context->GetAttr("adj_y", &adj_y_));
@@ -985,8 +1148,6 @@ class BaseBatchMatMulOp : public OpKernel {
       Tensor in0_reshaped_float, in1_reshaped_float, out_reshaped_float;
       OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, in0_reshaped.shape(),
                                              &in0_reshaped_float));
-      OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, in1_reshaped.shape(),
-                                             &in1_reshaped_float));
       OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, out_reshaped.shape(),
                                              &out_reshaped_float));
 
@@ -994,9 +1155,29 @@ class BaseBatchMatMulOp : public OpKernel {
       FastConvertToFloat(in0_reshaped.flat<Ta>().data(),
                          in0_reshaped_float.flat<float>().data(),
                          in0_reshaped.NumElements());
-      FastConvertToFloat(in1_reshaped.flat<Tb>().data(),
-                         in1_reshaped_float.flat<float>().data(),
-                         in1_reshaped.NumElements());
+      if (rhs_is_const_) {
+        // Converting the right operand costs as much as a matrix-vector
+        // product, so a constant one is converted only once.
+        mutex_lock l(mu_);
+        if (cached_rhs_source_.data() != in1_reshaped.data() ||
+            cached_rhs_source_.shape() != in1_reshaped.shape()) {
+          OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, in1_reshaped.shape(),
+                                                 &cached_rhs_));
+          FastConvertToFloat(in1_reshaped.flat<Tb>().data(),
+                             cached_rhs_.flat<float>().data(),
+                             in1_reshaped.NumElements());
+          // Holding the source keeps its buffer from being reused for other
+          // values.
+          cached_rhs_source_ = in1_reshaped;
+        }
+        in1_reshaped_float = cached_rhs_;
+      } else {
+        OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, in1_reshaped.shape(),
+                                               &in1_reshaped_float));
+        FastConvertToFloat(in1_reshaped.flat<Tb>().data(),
+                           in1_reshaped_float.flat<float>().data(),
+                           in1_reshaped.NumElements());
+      }
 
       LaunchBatchMatMul<Device, float>::Launch(
           ctx, in0_reshaped_float, in1_reshaped_float, adj_x_, adj_y_, trans_x_,
@@ -1031,6 +1212,13 @@ class BaseBatchMatMulOp : public OpKernel {
   bool trans_y_ = false;
   bool grad_input_1_ = false;
   bool grad_input_2_ = false;
+  bool rhs_is_const_ = false;
+
+  // The right operand converted to float, and the tensor it was converted
+  // from, if the right operand is a constant.
+  mutex mu_;
+  Tensor cached_rhs_ TF_GUARDED_BY(mu_);
+  Tensor cached_rhs_source_ TF_GUARDED_BY(mu_);
 
   // Cast `t` from `SrcT` to `DstT`.
   template <typename SrcT, typename DstT>
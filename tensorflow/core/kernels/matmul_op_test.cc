@@ -21,6 +21,8 @@ limitations under the License.
 #include "tensorflow/cc/ops/nn_ops_internal.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/ops_util.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
@@ -166,6 +168,36 @@ class FusedMatMulOpTest : public OpsTestBase {
       ops::Sigmoid(root.WithOpName("with_activation"), with_bias);
     } else if (activation_type == "Tanh") {
       ops::Tanh(root.WithOpName("with_activation"), with_bias);
+    } else if (activation_type == "GeluApproximate") {
+      // 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))).
+      auto scalar = [&](float value) {
+        return ops::Cast(root, ops::Const(root, value),
+                         DataTypeToEnum<T>::v());
+      };
+      auto cube = ops::Multiply(root, with_bias, ops::Square(root, with_bias));
+      auto inner = ops::Multiply(
+          root,
+          ops::AddV2(root, with_bias,
+                     ops::Multiply(root, cube, scalar(0.044715f))),
+          scalar(0.7978845608f));
+      auto tanh_plus_one =
+          ops::AddV2(root, ops::Tanh(root, inner), scalar(1.0f));
+      ops::Multiply(root.WithOpName("with_activation"),
+                    ops::Multiply(root, with_bias, scalar(0.5f)),
+                    tanh_plus_one);
+    } else if (activation_type == "GeluExact") {
+      // 0.5 * x * (1 + erf(x / sqrt(2))).
+      auto scalar = [&](float value) {
+        return ops::Cast(root, ops::Const(root, value),
+                         DataTypeToEnum<T>::v());
+      };
+      auto erf_plus_one = ops::AddV2(
+          root,
+          ops::Erf(root, ops::Multiply(root, with_bias, scalar(0.7071067812f))),
+          scalar(1.0f));
+      ops::Multiply(root.WithOpName("with_activation"),
+                    ops::Multiply(root, with_bias, scalar(0.5f)),
+                    erf_plus_one);
     } else {
       ops::Identity(root.WithOpName("with_activation"), with_bias);
     }
@@ -367,7 +399,8 @@ static auto GetActivations(DataType dtype) {
       // TODO: not sure how to add GeluExact op ??
       return std::vector{/*"GeluExact",*/ "Tanh", "Sigmoid"};
     default:
-      return std::vector{"Relu", "Relu6", "Elu", "LeakyRelu"};
+      return std::vector{"Relu", "Relu6", "Elu", "LeakyRelu",
+                         "GeluApproximate", "GeluExact"};
   }
 }
 
@@ -420,6 +453,63 @@ using FusedBiasAddDataTypes = ::testing::Types<float, Eigen::half>;
 INSTANTIATE_TYPED_TEST_SUITE_P(Test, FusedMatMulWithBiasOpTest,
                                FusedBiasAddDataTypes);
 
+class MatMulOpTest : public OpsTestBase {};
+
+TEST_F(MatMulOpTest, ConstantBfloat16Rhs) {
+  TF_ASSERT_OK(NodeDefBuilder("matmul", "MatMul")
+                   .Input(FakeInput(DT_BFLOAT16))
+                   .Input(FakeInput(DT_BFLOAT16))
+                   .Attr("_rhs_is_const", true)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromList<bfloat16>(TensorShape({1, 3}),
+                             {bfloat16(1), bfloat16(2), bfloat16(3)});
+  AddInputFromList<bfloat16>(TensorShape({3, 2}),
+                             {bfloat16(1), bfloat16(-1), bfloat16(2),
+                              bfloat16(0.5), bfloat16(-1), bfloat16(4)});
+  Tensor expected(DT_BFLOAT16, TensorShape({1, 2}));
+  test::FillValues<bfloat16>(&expected, {bfloat16(2), bfloat16(12)});
+
+  // The second run reuses the converted right operand.
+  for (int run = 0; run < 2; ++run) {
+    TF_ASSERT_OK(RunOpKernel());
+    test::ExpectTensorEqual<bfloat16>(expected, *GetOutput(0));
+  }
+}
+
+TEST_F(MatMulOpTest, BatchOfSmallMatrices) {
+  TF_ASSERT_OK(NodeDefBuilder("matmul", "BatchMatMulV2")
+                   .Input(FakeInput(DT_FLOAT))
+                   .Input(FakeInput(DT_FLOAT))
+                   .Attr("adj_x", true)
+                   .Attr("adj_y", true)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  // The right operand is broadcast across the batch.
+  Tensor x(DT_FLOAT, TensorShape({6, 7, 5}));
+  x.flat<float>().setRandom();
+  Tensor y(DT_FLOAT, TensorShape({1, 8, 7}));
+  y.flat<float>().setRandom();
+  AddInputFromArray<float>(x.shape(), x.flat<float>());
+  AddInputFromArray<float>(y.shape(), y.flat<float>());
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({6, 5, 8}));
+  auto x_t = x.tensor<float, 3>();
+  auto y_t = y.tensor<float, 3>();
+  auto expected_t = expected.tensor<float, 3>();
+  for (int b = 0; b < 6; ++b) {
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 8; ++j) {
+        float sum = 0;
+        for (int p = 0; p < 7; ++p) sum += x_t(b, p, i) * y_t(0, j, p);
+        expected_t(b, i, j) = sum;
+      }
+    }
+  }
+  test::ExpectClose(expected, *GetOutput(0));
+}
+
 //----------------------------------------------------------------------------//
 // Performance benchmarks are below.                                          //
 //----------------------------------------------------------------------------//
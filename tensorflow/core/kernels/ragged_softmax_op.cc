@@ -0,0 +1,124 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tsl/platform/errors.h"
+
+namespace tensorflow {
+
+using errors::InvalidArgument;
+
+// Computes the softmax of each row of a ragged tensor whose rows are given by
+// `row_splits` over the flat `logits`, without padding the rows to a dense
+// tensor. Rows are processed in parallel.
+template <typename T, typename SPLITS_TYPE>
+class RaggedSoftmaxOp : public OpKernel {
+ public:
+  // Low precision values are accumulated in float.
+  using Accum =
+      typename std::conditional<std::is_same<T, Eigen::half>::value ||
+                                    std::is_same<T, bfloat16>::value,
+                                float, T>::type;
+
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& logits_in = context->input(0);
+    const Tensor& splits_in = context->input(1);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(logits_in.shape()),
+                InvalidArgument("logits must be a vector, got shape ",
+                                logits_in.shape().DebugString()));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(splits_in.shape()),
+                InvalidArgument("row_splits must be a vector, got shape ",
+                                splits_in.shape().DebugString()));
+    const auto splits = splits_in.vec<SPLITS_TYPE>();
+    const int64_t num_values = logits_in.NumElements();
+    const int64_t num_rows = splits.size() - 1;
+    OP_REQUIRES(context, num_rows >= 0,
+                InvalidArgument("row_splits must not be empty"));
+    OP_REQUIRES(context, splits(0) == 0,
+                InvalidArgument("row_splits must start with 0, got ",
+                                splits(0)));
+    for (int64_t row = 0; row < num_rows; ++row) {
+      OP_REQUIRES(context, splits(row) <= splits(row + 1),
+                  InvalidArgument("row_splits must be non-decreasing, got ",
+                                  splits(row), " before ", splits(row + 1)));
+    }
+    OP_REQUIRES(context, splits(num_rows) == num_values,
+                InvalidArgument("row_splits must end with the number of "
+                                "logits ",
+                                num_values, ", got ", splits(num_rows)));
+
+    Tensor* softmax_out = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, logits_in.shape(),
+                                                     &softmax_out));
+    const T* logits = logits_in.flat<T>().data();
+    T* softmax = softmax_out->flat<T>().data();
+    auto softmax_rows = [&](int64_t start_row, int64_t limit_row) {
+      for (int64_t row = start_row; row < limit_row; ++row) {
+        const int64_t begin = splits(row);
+        const int64_t end = splits(row + 1);
+        if (begin == end) continue;
+        Accum max_logit = static_cast<Accum>(logits[begin]);
+        for (int64_t i = begin + 1; i < end; ++i) {
+          max_logit = std::max(max_logit, static_cast<Accum>(logits[i]));
+        }
+        Accum sum = 0;
+        for (int64_t i = begin; i < end; ++i) {
+          sum += std::exp(static_cast<Accum>(logits[i]) - max_logit);
+        }
+        const Accum inv_sum = Accum(1) / sum;
+        for (int64_t i = begin; i < end; ++i) {
+          softmax[i] = static_cast<T>(
+              std::exp(static_cast<Accum>(logits[i]) - max_logit) * inv_sum);
+        }
+      }
+    };
+    // Each value is read three times and exponentiated twice.
+    const int64_t cost_per_row =
+        std::max<int64_t>(1, num_values / std::max<int64_t>(num_rows, 1)) * 50;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_rows,
+          cost_per_row, softmax_rows);
+  }
+};
+
+#define REGISTER_CPU_KERNEL(TYPE)                                  \
+  REGISTER_KERNEL_BUILDER(Name("RaggedSoftmax")                    \
+                              .Device(DEVICE_CPU)                  \
+                              .TypeConstraint<TYPE>("T")           \
+                              .TypeConstraint<int32>("Tsplits"),   \
+                          RaggedSoftmaxOp<TYPE, int32>);           \
+  REGISTER_KERNEL_BUILDER(Name("RaggedSoftmax")                    \
+                              .Device(DEVICE_CPU)                  \
+                              .TypeConstraint<TYPE>("T")           \
+                              .TypeConstraint<int64_t>("Tsplits"), \
+                          RaggedSoftmaxOp<TYPE, int64_t>);
+TF_CALL_half(REGISTER_CPU_KERNEL);
+TF_CALL_bfloat16(REGISTER_CPU_KERNEL);
+TF_CALL_float(REGISTER_CPU_KERNEL);
+TF_CALL_double(REGISTER_CPU_KERNEL);
+#undef REGISTER_CPU_KERNEL
+
+}  // namespace tensorflow
@@ -0,0 +1,107 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class RaggedSoftmaxOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(DataType splits_type) {
+    TF_ASSERT_OK(NodeDefBuilder("ragged_softmax", "RaggedSoftmax")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(splits_type))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(RaggedSoftmaxOpTest, SoftmaxOfEachRow) {
+  MakeOp(DT_INT64);
+  // rows = [[1, 2, 3], [], [1000, 1000], [-5]]
+  AddInputFromArray<float>(TensorShape({6}), {1, 2, 3, 1000, 1000, -5});
+  AddInputFromArray<int64_t>(TensorShape({5}), {0, 3, 3, 5, 6});
+  TF_ASSERT_OK(RunOpKernel());
+
+  const float sum = std::exp(-2.0f) + std::exp(-1.0f) + 1.0f;
+  test::ExpectTensorNear<float>(
+      *GetOutput(0),
+      test::AsTensor<float>({std::exp(-2.0f) / sum, std::exp(-1.0f) / sum,
+                             1.0f / sum, 0.5f, 0.5f, 1.0f}),
+      1e-6);
+}
+
+TEST_F(RaggedSoftmaxOpTest, Int32Splits) {
+  MakeOp(DT_INT32);
+  AddInputFromArray<float>(TensorShape({4}), {0, 0, 0, 0});
+  AddInputFromArray<int32>(TensorShape({3}), {0, 1, 4});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorNear<float>(
+      *GetOutput(0), test::AsTensor<float>({1, 1.0f / 3, 1.0f / 3, 1.0f / 3}),
+      1e-6);
+}
+
+TEST_F(RaggedSoftmaxOpTest, ManyRows) {
+  MakeOp(DT_INT64);
+  constexpr int kNumRows = 10000;
+  std::vector<float> logits;
+  std::vector<int64_t> splits = {0};
+  for (int row = 0; row < kNumRows; ++row) {
+    for (int i = 0; i <= row % 7; ++i) logits.push_back(i);
+    splits.push_back(logits.size());
+  }
+  AddInputFromArray<float>(TensorShape({static_cast<int64_t>(logits.size())}),
+                           logits);
+  AddInputFromArray<int64_t>(TensorShape({kNumRows + 1}), splits);
+  TF_ASSERT_OK(RunOpKernel());
+
+  const auto softmax = GetOutput(0)->vec<float>();
+  for (int row = 0; row < kNumRows; ++row) {
+    float sum = 0;
+    for (int64_t i = splits[row]; i < splits[row + 1]; ++i) {
+      sum += softmax(i);
+    }
+    EXPECT_NEAR(sum, 1.0f, 1e-5);
+  }
+}
+
+TEST_F(RaggedSoftmaxOpTest, InvalidSplits) {
+  MakeOp(DT_INT64);
+  AddInputFromArray<float>(TensorShape({3}), {1, 2, 3});
+  AddInputFromArray<int64_t>(TensorShape({3}), {0, 2, 1});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+TEST_F(RaggedSoftmaxOpTest, SplitsDoNotMatchLogits) {
+  MakeOp(DT_INT64);
+  AddInputFromArray<float>(TensorShape({3}), {1, 2, 3});
+  AddInputFromArray<int64_t>(TensorShape({2}), {0, 4});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
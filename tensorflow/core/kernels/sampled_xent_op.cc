@@ -0,0 +1,219 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/nn_ops.cc.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+// Computes the sampled softmax cross entropy loss and its gradient with
+// respect to the true and sampled logits in a single pass over each example.
+//
+// The log expected counts are subtracted from the logits, sampled classes that
+// equal one of the example's true classes are optionally excluded, and each of
+// the `num_true` true classes has the target probability `1 / num_true`. This
+// matches `tf.nn.sampled_softmax_loss` without materializing the concatenated
+// logits and labels.
+template <typename T>
+class SampledSoftmaxXentWithLogitsOp : public OpKernel {
+ public:
+  // Low precision logits are accumulated in float.
+  using Accum =
+      typename std::conditional<std::is_same<T, Eigen::half>::value ||
+                                    std::is_same<T, bfloat16>::value,
+                                float, T>::type;
+
+  explicit SampledSoftmaxXentWithLogitsOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("remove_accidental_hits",
+                                             &remove_accidental_hits_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& true_logits_in = context->input(0);
+    const Tensor& sampled_logits_in = context->input(1);
+    const Tensor& true_expected_count_in = context->input(2);
+    const Tensor& sampled_expected_count_in = context->input(3);
+    const Tensor& labels_in = context->input(4);
+    const Tensor& sampled_candidates_in = context->input(5);
+
+    OP_REQUIRES(context, TensorShapeUtils::IsMatrix(true_logits_in.shape()),
+                errors::InvalidArgument("true_logits must be 2-D, got shape ",
+                                        true_logits_in.shape().DebugString()));
+    OP_REQUIRES(
+        context, TensorShapeUtils::IsMatrix(sampled_logits_in.shape()),
+        errors::InvalidArgument("sampled_logits must be 2-D, got shape ",
+                                sampled_logits_in.shape().DebugString()));
+    const int64_t batch_size = true_logits_in.dim_size(0);
+    const int64_t num_true = true_logits_in.dim_size(1);
+    const int64_t num_sampled = sampled_logits_in.dim_size(1);
+    OP_REQUIRES(context, sampled_logits_in.dim_size(0) == batch_size,
+                errors::InvalidArgument(
+                    "true_logits and sampled_logits must have the same batch "
+                    "size, got ",
+                    batch_size, " and ", sampled_logits_in.dim_size(0)));
+    OP_REQUIRES(context, num_true > 0,
+                errors::InvalidArgument("true_logits must have at least one "
+                                        "true class per example"));
+    OP_REQUIRES(context,
+                true_expected_count_in.shape() == true_logits_in.shape(),
+                errors::InvalidArgument(
+                    "true_expected_count must have the shape of true_logits ",
+                    true_logits_in.shape().DebugString(), ", got ",
+                    true_expected_count_in.shape().DebugString()));
+    OP_REQUIRES(context, labels_in.shape() == true_logits_in.shape(),
+                errors::InvalidArgument(
+                    "labels must have the shape of true_logits ",
+                    true_logits_in.shape().DebugString(), ", got ",
+                    labels_in.shape().DebugString()));
+    const TensorShape sampled_shape({num_sampled});
+    OP_REQUIRES(context, sampled_expected_count_in.shape() == sampled_shape,
+                errors::InvalidArgument(
+                    "sampled_expected_count must have shape ",
+                    sampled_shape.DebugString(), ", got ",
+                    sampled_expected_count_in.shape().DebugString()));
+    OP_REQUIRES(context, sampled_candidates_in.shape() == sampled_shape,
+                errors::InvalidArgument(
+                    "sampled_candidates must have shape ",
+                    sampled_shape.DebugString(), ", got ",
+                    sampled_candidates_in.shape().DebugString()));
+
+    Tensor* loss_out = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({batch_size}), &loss_out));
+    Tensor* true_backprop_out = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(1, true_logits_in.shape(),
+                                            &true_backprop_out));
+    Tensor* sampled_backprop_out = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(2, sampled_logits_in.shape(),
+                                            &sampled_backprop_out));
+    if (batch_size == 0) return;
+
+    // The sampled correction is shared by all examples.
+    const auto sampled_expected_count =
+        sampled_expected_count_in.vec<float>();
+    std::vector<Accum> sampled_log_q(num_sampled);
+    for (int64_t j = 0; j < num_sampled; ++j) {
+      sampled_log_q[j] =
+          static_cast<Accum>(std::log(sampled_expected_count(j)));
+    }
+
+    const auto true_logits = true_logits_in.matrix<T>();
+    const auto sampled_logits = sampled_logits_in.matrix<T>();
+    const auto true_expected_count = true_expected_count_in.matrix<float>();
+    const auto labels = labels_in.matrix<int64_t>();
+    const auto sampled_candidates = sampled_candidates_in.vec<int64_t>();
+    auto loss = loss_out->vec<T>();
+    auto true_backprop = true_backprop_out->matrix<T>();
+    auto sampled_backprop = sampled_backprop_out->matrix<T>();
+    const bool remove_accidental_hits = remove_accidental_hits_;
+
+    auto compute_examples = [&](int64_t start, int64_t limit) {
+      // Exponentiated logits of one example, true classes first.
+      std::vector<Accum> logits(num_true + num_sampled);
+      std::vector<Accum> true_corrected(num_true);
+      std::vector<bool> hit(num_sampled);
+      for (int64_t b = start; b < limit; ++b) {
+        Accum max_logit = -std::numeric_limits<Accum>::infinity();
+        for (int64_t i = 0; i < num_true; ++i) {
+          true_corrected[i] =
+              static_cast<Accum>(true_logits(b, i)) -
+              static_cast<Accum>(std::log(true_expected_count(b, i)));
+          max_logit = std::max(max_logit, true_corrected[i]);
+        }
+        for (int64_t j = 0; j < num_sampled; ++j) {
+          bool is_hit = false;
+          if (remove_accidental_hits) {
+            for (int64_t i = 0; i < num_true && !is_hit; ++i) {
+              is_hit = sampled_candidates(j) == labels(b, i);
+            }
+          }
+          hit[j] = is_hit;
+          logits[num_true + j] =
+              static_cast<Accum>(sampled_logits(b, j)) - sampled_log_q[j];
+          if (!is_hit) max_logit = std::max(max_logit, logits[num_true + j]);
+        }
+
+        Accum sum_exp = 0;
+        for (int64_t i = 0; i < num_true; ++i) {
+          logits[i] = std::exp(true_corrected[i] - max_logit);
+          sum_exp += logits[i];
+        }
+        for (int64_t j = 0; j < num_sampled; ++j) {
+          Accum& value = logits[num_true + j];
+          value = hit[j] ? Accum(0) : std::exp(value - max_logit);
+          sum_exp += value;
+        }
+
+        // The loss is the mean over the true classes of logsumexp minus the
+        // corrected true logit, and the gradient is the softmax minus the
+        // target probabilities.
+        const Accum inv_sum_exp = Accum(1) / sum_exp;
+        const Accum log_sum_exp = max_logit + std::log(sum_exp);
+        const Accum target = Accum(1) / static_cast<Accum>(num_true);
+        Accum example_loss = 0;
+        for (int64_t i = 0; i < num_true; ++i) {
+          example_loss += log_sum_exp - true_corrected[i];
+          true_backprop(b, i) =
+              static_cast<T>(logits[i] * inv_sum_exp - target);
+        }
+        for (int64_t j = 0; j < num_sampled; ++j) {
+          sampled_backprop(b, j) =
+              static_cast<T>(logits[num_true + j] * inv_sum_exp);
+        }
+        loss(b) = static_cast<T>(example_loss * target);
+      }
+    };
+    // Each logit is read once, exponentiated once and written once.
+    const int64_t cost_per_example =
+        (num_true + num_sampled) * (30 + (remove_accidental_hits ? num_true
+                                                                 : 0));
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, batch_size,
+          cost_per_example, compute_examples);
+  }
+
+ private:
+  bool remove_accidental_hits_;
+};
+
+#define REGISTER_CPU(T)                                  \
+  REGISTER_KERNEL_BUILDER(                               \
+      Name("SampledSoftmaxCrossEntropyWithLogits")       \
+          .Device(DEVICE_CPU)                            \
+          .TypeConstraint<T>("T"),                       \
+      SampledSoftmaxXentWithLogitsOp<T>);
+TF_CALL_half(REGISTER_CPU);
+TF_CALL_bfloat16(REGISTER_CPU);
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_double(REGISTER_CPU);
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
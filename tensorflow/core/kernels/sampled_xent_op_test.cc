@@ -0,0 +1,126 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class SampledSoftmaxXentTest : public OpsTestBase {
+ protected:
+  void MakeOp(bool remove_accidental_hits) {
+    TF_ASSERT_OK(NodeDefBuilder("sampled_xent",
+                                "SampledSoftmaxCrossEntropyWithLogits")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_INT64))
+                     .Input(FakeInput(DT_INT64))
+                     .Attr("remove_accidental_hits", remove_accidental_hits)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(SampledSoftmaxXentTest, MatchesSoftmaxOfCorrectedLogits) {
+  MakeOp(/*remove_accidental_hits=*/true);
+  // Example 1 samples its own label 7, which is removed.
+  AddInputFromArray<float>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({2, 2}), {0, 3, 1, 5});
+  AddInputFromArray<float>(TensorShape({2, 1}), {1, 1});
+  AddInputFromArray<float>(TensorShape({2}), {1, std::exp(1.0f)});
+  AddInputFromArray<int64_t>(TensorShape({2, 1}), {4, 7});
+  AddInputFromArray<int64_t>(TensorShape({2}), {5, 7});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Corrected logits: [1 | 0, 2] and [2 | 1, removed].
+  const float sum0 = std::exp(1.0f) + std::exp(0.0f) + std::exp(2.0f);
+  const float sum1 = std::exp(2.0f) + std::exp(1.0f);
+  test::ExpectTensorNear<float>(
+      *GetOutput(0),
+      test::AsTensor<float>({std::log(sum0) - 1, std::log(sum1) - 2}), 1e-5);
+  test::ExpectTensorNear<float>(
+      *GetOutput(1),
+      test::AsTensor<float>({std::exp(1.0f) / sum0 - 1,
+                             std::exp(2.0f) / sum1 - 1},
+                            {2, 1}),
+      1e-5);
+  test::ExpectTensorNear<float>(
+      *GetOutput(2),
+      test::AsTensor<float>(
+          {1 / sum0, std::exp(2.0f) / sum0, std::exp(1.0f) / sum1, 0}, {2, 2}),
+      1e-5);
+}
+
+TEST_F(SampledSoftmaxXentTest, KeepsAccidentalHits) {
+  MakeOp(/*remove_accidental_hits=*/false);
+  AddInputFromArray<float>(TensorShape({1, 2}), {0, 0});
+  AddInputFromArray<float>(TensorShape({1, 2}), {0, 0});
+  AddInputFromArray<float>(TensorShape({1, 2}), {1, 1});
+  AddInputFromArray<float>(TensorShape({2}), {1, 1});
+  AddInputFromArray<int64_t>(TensorShape({1, 2}), {3, 4});
+  AddInputFromArray<int64_t>(TensorShape({2}), {3, 9});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Two true classes, each with target probability 1/2.
+  test::ExpectTensorNear<float>(*GetOutput(0),
+                                test::AsTensor<float>({std::log(4.0f)}), 1e-5);
+  test::ExpectTensorNear<float>(
+      *GetOutput(1), test::AsTensor<float>({-0.25f, -0.25f}, {1, 2}), 1e-5);
+  test::ExpectTensorNear<float>(
+      *GetOutput(2), test::AsTensor<float>({0.25f, 0.25f}, {1, 2}), 1e-5);
+}
+
+TEST_F(SampledSoftmaxXentTest, LargeLogitsAreStable) {
+  MakeOp(/*remove_accidental_hits=*/true);
+  AddInputFromArray<float>(TensorShape({1, 1}), {-1000});
+  AddInputFromArray<float>(TensorShape({1, 1}), {1000});
+  AddInputFromArray<float>(TensorShape({1, 1}), {1});
+  AddInputFromArray<float>(TensorShape({1}), {1});
+  AddInputFromArray<int64_t>(TensorShape({1, 1}), {0});
+  AddInputFromArray<int64_t>(TensorShape({1}), {1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorNear<float>(*GetOutput(0), test::AsTensor<float>({2000}),
+                                1e-3);
+  test::ExpectTensorNear<float>(*GetOutput(1),
+                                test::AsTensor<float>({-1}, {1, 1}), 1e-5);
+}
+
+TEST_F(SampledSoftmaxXentTest, MismatchedSampledShape) {
+  MakeOp(/*remove_accidental_hits=*/true);
+  AddInputFromArray<float>(TensorShape({1, 1}), {0});
+  AddInputFromArray<float>(TensorShape({1, 2}), {0, 0});
+  AddInputFromArray<float>(TensorShape({1, 1}), {1});
+  AddInputFromArray<float>(TensorShape({1}), {1});
+  AddInputFromArray<int64_t>(TensorShape({1, 1}), {0});
+  AddInputFromArray<int64_t>(TensorShape({1}), {1});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -301,6 +302,19 @@ struct RestoreOp {
     VLOG(1) << "Restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
+    const ConfigProto* config = context->session_config();
+    if (shape_and_slice.empty() && config != nullptr &&
+        config->experimental().mmap_checkpoint_tensors()) {
+      Tensor mapped_tensor;
+      bool mapped;
+      TF_RETURN_IF_ERROR(
+          reader->LookupMapped(tensor_name, &mapped_tensor, &mapped));
+      if (mapped) {
+        VLOG(1) << "Mapped tensor " << idx << " : " << tensor_name;
+        context->set_output(idx, mapped_tensor);
+        return absl::OkStatus();
+      }
+    }
     if (shape_and_slice.empty()) {
       // Lookup the full tensor.
       TF_RETURN_IF_ERROR(
@@ -417,10 +431,9 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     // we don't have any expensive operations.
     std::unique_ptr<thread::ThreadPool> reader_pool;
     if (!pool_restore_ops.empty()) {
-      // TODO(spetrovic): Instead of a fixed size 8, use the value from:
-      //    context->session_config()->intra_op_parallelism_threads()
-      reader_pool.reset(
-          new thread::ThreadPool(Env::Default(), "restore_tensors", 8));
+      reader_pool.reset(new thread::ThreadPool(
+          Env::Default(), "restore_tensors",
+          std::min<int>(CheckpointReadThreads(), pool_restore_ops.size())));
       for (auto* op : pool_restore_ops) {
         reader_pool->Schedule([op]() { op->run_with_new_reader(); });
       }
@@ -16,8 +16,10 @@ limitations under the License.
 // See docs in ../ops/io_ops.cc.
 
 #include <cstddef>
+#include <cstring>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/core/framework/bounds_check.h"
@@ -25,7 +27,9 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/async_checkpoint.h"
 #include "tensorflow/core/kernels/checkpoint_callback_manager.h"
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -90,9 +94,83 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Writes `tensors` to a bundle at `prefix`. `shape_and_slices` are parsed
+// slice specs, or empty for saves in full.
+Status WriteBundle(const string& prefix, const std::vector<string>& names,
+                   const std::vector<string>& shape_and_slices,
+                   const std::vector<Tensor>& tensors) {
+  BundleWriter::Options options;
+  options.data_alignment = CheckpointDataAlignment();
+  BundleWriter writer(Env::Default(), prefix, options);
+  TF_RETURN_IF_ERROR(writer.status());
+  VLOG(1) << "BundleWriter, prefix_string: " << prefix;
+
+  for (int i = 0; i < tensors.size(); ++i) {
+    const string& tensor_name = names[i];
+    const Tensor& tensor = tensors[i];
+    VLOG(2) << "Starting save of " << tensor_name;
+
+    if (!shape_and_slices[i].empty()) {
+      TensorShape shape;
+      TensorSlice slice(tensor.dims());
+      TensorShape slice_shape;
+      TF_RETURN_IF_ERROR(checkpoint::ParseShapeAndSlice(
+          shape_and_slices[i], &shape, &slice, &slice_shape));
+      TF_RETURN_IF_ERROR(writer.AddSlice(tensor_name, shape, slice, tensor));
+    } else {
+      TF_RETURN_IF_ERROR(writer.Add(tensor_name, tensor));
+    }
+
+    if (VLOG_IS_ON(5)) {
+      if (tensor.dtype() == DT_FLOAT) {
+        const float* t_data = tensor.flat<float>().data();
+        float min = std::numeric_limits<float>::infinity();
+        float max = -std::numeric_limits<float>::infinity();
+        double avg = 0.0;
+        for (int i = 0; i < tensor.NumElements(); ++i) {
+          if (t_data[i] < min) min = t_data[i];
+          if (t_data[i] > max) max = t_data[i];
+          avg += t_data[i];
+        }
+        VLOG(5) << " min " << min << " max " << max << " avg "
+                << avg / tensor.NumElements() << " total elts "
+                << tensor.NumElements();
+      }
+    }
+
+    VLOG(2) << "Done save of " << tensor_name;
+  }
+  TF_RETURN_IF_ERROR(writer.Finish());
+  VLOG(1) << "Done BundleWriter, prefix_string: " << prefix;
+  return absl::OkStatus();
+}
+
+// Copies `tensor` to host memory that devices can DMA from.
+Status SnapshotToHost(OpKernelContext* context, const Tensor& tensor,
+                      Tensor* snapshot) {
+  if (!DataTypeCanUseMemcpy(tensor.dtype())) {
+    *snapshot = tensor::DeepCopy(tensor);
+    return absl::OkStatus();
+  }
+  AllocatorAttributes attr;
+  attr.set_on_host(true);
+  attr.set_gpu_compatible(true);
+  TF_RETURN_IF_ERROR(
+      context->allocate_temp(tensor.dtype(), tensor.shape(), snapshot, attr));
+  if (tensor.TotalBytes() > 0) {
+    memcpy(const_cast<char*>(snapshot->tensor_data().data()),
+           tensor.tensor_data().data(), tensor.TotalBytes());
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
+//
+// With TF_ASYNC_CHECKPOINT_SAVE set, the tensors are snapshotted and written
+// in the background by checkpoint::AsyncCheckpointWriter; see
+// checkpoint::AsyncSaveMode.
 class SaveV2 : public OpKernel {
  public:
   explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {}
@@ -111,57 +189,57 @@ class SaveV2 : public OpKernel {
     const auto& tensor_names_flat = tensor_names.flat<tstring>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
 
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
+    std::vector<string> names(num_tensors);
+    std::vector<string> specs(num_tensors);
+    std::vector<Tensor> tensors(num_tensors);
     for (int i = 0; i < num_tensors; ++i) {
-      const string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
-
-      if (!shape_and_slices_flat(i).empty()) {
-        const string& shape_spec = shape_and_slices_flat(i);
+      names[i] = tensor_names_flat(i);
+      specs[i] = shape_and_slices_flat(i);
+      tensors[i] = context->input(i + kFixedInputs);
+      if (!specs[i].empty()) {
+        const Tensor& tensor = tensors[i];
         TensorShape shape;
         TensorSlice slice(tensor.dims());
         TensorShape slice_shape;
 
         OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                    shape_spec, &shape, &slice, &slice_shape));
+                                    specs[i], &shape, &slice, &slice_shape));
         OP_REQUIRES(context, slice_shape.IsSameSize(tensor.shape()),
                     errors::InvalidArgument("Slice in shape_and_slice "
                                             "specification does not match the "
                                             "shape of the tensor to  save: ",
-                                            shape_spec, ", tensor: ",
+                                            specs[i], ", tensor: ",
                                             tensor.shape().DebugString()));
-
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
-      } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
       }
+    }
 
-      if (VLOG_IS_ON(5)) {
-        if (tensor.dtype() == DT_FLOAT) {
-          const float* t_data = tensor.flat<float>().data();
-          float min = std::numeric_limits<float>::infinity();
-          float max = -std::numeric_limits<float>::infinity();
-          double avg = 0.0;
-          for (int i = 0; i < tensor.NumElements(); ++i) {
-            if (t_data[i] < min) min = t_data[i];
-            if (t_data[i] > max) max = t_data[i];
-            avg += t_data[i];
-          }
-          VLOG(5) << " min " << min << " max " << max << " avg "
-                  << avg / tensor.NumElements() << " total elts "
-                  << tensor.NumElements();
+    const checkpoint::AsyncSaveMode mode = checkpoint::GetAsyncSaveMode();
+    if (mode != checkpoint::AsyncSaveMode::kOff) {
+      // Report the failures of earlier saves that nobody waited for.
+      OP_REQUIRES_OK(context,
+                     checkpoint::AsyncCheckpointWriter::Global()
+                         ->ConsumeErrors());
+    }
+    if (mode == checkpoint::AsyncSaveMode::kOff) {
+      OP_REQUIRES_OK(context,
+                     WriteBundle(prefix_string, names, specs, tensors));
+    } else {
+      if (mode == checkpoint::AsyncSaveMode::kCopy) {
+        for (Tensor& tensor : tensors) {
+          Tensor snapshot;
+          OP_REQUIRES_OK(context, SnapshotToHost(context, tensor, &snapshot));
+          tensor = std::move(snapshot);
         }
       }
-
-      VLOG(2) << "Done save of " << tensor_name;
+      VLOG(1) << "Scheduling the async save of " << prefix_string;
+      checkpoint::AsyncCheckpointWriter::Global()->Schedule(
+          prefix_string,
+          [prefix_string, names = std::move(names), specs = std::move(specs),
+           tensors = std::move(tensors)]() {
+            return WriteBundle(prefix_string, names, specs, tensors);
+          },
+          context->coordination_service_agent());
     }
-    OP_REQUIRES_OK(context, writer.Finish());
-    VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
 
     ResourceMgr* resource_manager = context->resource_manager();
     if (resource_manager != nullptr) {
@@ -205,6 +283,10 @@ class RestoreV2 : public OpKernel {
     if (!context->status().ok()) return;
 
     const string& prefix_string = prefix.scalar<tstring>()();
+    // A checkpoint saved asynchronously by this process may still be written.
+    OP_REQUIRES_OK(context,
+                   checkpoint::AsyncCheckpointWriter::Global()->Wait(
+                       prefix_string));
 
     VLOG(2) << "Started Restore at prefix: " << prefix_string;
     // Intention: we plan to use the RestoreV2 op as a backward-compatible
@@ -287,6 +369,17 @@ class MergeV2Checkpoints : public OpKernel {
         gtl::ArraySlice<tstring>(checkpoint_prefixes.flat<tstring>());
     Env* env = Env::Default();
     const string& merged_prefix = destination_prefix.scalar<tstring>()();
+    if (checkpoint::GetAsyncSaveMode() != checkpoint::AsyncSaveMode::kOff) {
+      // Commit the checkpoint only once every shard has been written.
+      Status status =
+          checkpoint::AsyncCheckpointWriter::Global()->ConsumeErrors();
+      for (const string& input_prefix : input_prefixes) {
+        status.Update(
+            checkpoint::AsyncCheckpointWriter::Global()->WaitForAnyTask(
+                input_prefix, context->coordination_service_agent()));
+      }
+      OP_REQUIRES_OK(context, status);
+    }
     OP_REQUIRES_OK(context,
                    tensorflow::MergeBundles(env, input_prefixes, merged_prefix,
                                             allow_missing_files_));
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <complex>
+#include <cstdlib>
 #include <string>
 
 #include "tensorflow/core/framework/fake_input.h"
@@ -22,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/async_checkpoint.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -340,5 +342,43 @@ TEST_F(SaveV2OpTest, Simple) {
   }
 }
 
+TEST_F(SaveV2OpTest, AsyncCopy) {
+  const string prefix = io::JoinPath(testing::TmpDir(), "tensor_async_copy");
+  setenv("TF_ASYNC_CHECKPOINT_SAVE", "copy", 1);
+  TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                   .Input(FakeInput())  // prefix
+                   .Input(FakeInput())  // tensor_names
+                   .Input(FakeInput())  // shape_and_slices
+                   .Input(FakeInput({DT_FLOAT, DT_STRING}))  // tensors
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInput<tstring>(TensorShape({}),
+                    [&prefix](int x) -> tstring { return prefix; });
+  AddInput<tstring>(TensorShape({2}), [](int x) -> tstring {
+    return x == 0 ? "tensor_float" : "tensor_string";
+  });
+  AddInput<tstring>(TensorShape({2}), [](int x) -> tstring { return ""; });
+  AddInput<float>(TensorShape({4}),
+                  [](int x) -> float { return static_cast<float>(x); });
+  AddInput<tstring>(TensorShape({2}),
+                    [](int x) -> tstring { return x == 0 ? "a" : "b"; });
+  TF_ASSERT_OK(RunOpKernel());
+  unsetenv("TF_ASYNC_CHECKPOINT_SAVE");
+
+  // The snapshot is not affected by later updates of the inputs.
+  inputs_[3].tensor->flat<float>().setZero();
+  TF_ASSERT_OK(checkpoint::AsyncCheckpointWriter::Global()->Wait(prefix));
+
+  BundleReader reader(Env::Default(), prefix);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("tensor_float", &val));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(static_cast<float>(i), val.flat<float>()(i));
+  }
+  TF_ASSERT_OK(reader.Lookup("tensor_string", &val));
+  EXPECT_EQ("b", val.flat<tstring>()(1));
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -0,0 +1,553 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/nn_ops.cc.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "Eigen/Core"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Number of queries and keys in the blocks the score matrix is computed in.
+constexpr int64_t kQueryBlockSize = 64;
+constexpr int64_t kKeyBlockSize = 128;
+
+// Dimensions of one attention computation.
+struct AttentionDims {
+  int64_t batch;
+  int64_t heads;
+  int64_t query_length;
+  int64_t key_length;
+  int64_t depth;
+  int64_t value_depth;
+};
+
+Status ValidateAttentionInputs(const Tensor& query, const Tensor& key,
+                               const Tensor& value, const Tensor& key_lengths,
+                               AttentionDims* dims) {
+  if (query.dims() != 4 || key.dims() != 4 || value.dims() != 4) {
+    return errors::InvalidArgument(
+        "query, key and value must be 4-D, got shapes ",
+        query.shape().DebugString(), ", ", key.shape().DebugString(), " and ",
+        value.shape().DebugString());
+  }
+  dims->batch = query.dim_size(0);
+  dims->heads = query.dim_size(1);
+  dims->query_length = query.dim_size(2);
+  dims->key_length = key.dim_size(2);
+  dims->depth = query.dim_size(3);
+  dims->value_depth = value.dim_size(3);
+  if (key.dim_size(0) != dims->batch || key.dim_size(1) != dims->heads ||
+      key.dim_size(3) != dims->depth || value.dim_size(0) != dims->batch ||
+      value.dim_size(1) != dims->heads ||
+      value.dim_size(2) != dims->key_length) {
+    return errors::InvalidArgument(
+        "Incompatible shapes of query, key and value: ",
+        query.shape().DebugString(), ", ", key.shape().DebugString(), " and ",
+        value.shape().DebugString());
+  }
+  if (!TensorShapeUtils::IsVector(key_lengths.shape()) ||
+      key_lengths.NumElements() != dims->batch) {
+    return errors::InvalidArgument(
+        "key_lengths must be a vector of size ", dims->batch, ", got shape ",
+        key_lengths.shape().DebugString());
+  }
+  const auto lengths = key_lengths.vec<int32>();
+  for (int64_t b = 0; b < dims->batch; ++b) {
+    if (lengths(b) < 0 || lengths(b) > dims->key_length) {
+      return errors::InvalidArgument("key_lengths[", b, "] = ", lengths(b),
+                                     " is not in [0, ", dims->key_length,
+                                     "]");
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Number of keys that query `query_index` attends to.
+inline int64_t NumKeys(int64_t query_index, int64_t key_length, bool causal) {
+  return causal ? std::min(key_length, query_index + 1) : key_length;
+}
+
+// Returns the score block S = scale * Q * K^T of the queries [q0, q0 + nq) and
+// the keys [k0, k0 + nk), with the scores of masked keys set to -inf.
+template <typename T, typename Matrix, typename QueryMap, typename KeyMap>
+void ComputeScores(const QueryMap& query, const KeyMap& key, T scale,
+                   int64_t q0, int64_t k0, int64_t key_length, bool causal,
+                   Matrix* scores) {
+  scores->noalias() = scale * (query * key.transpose());
+  for (int64_t r = 0; r < scores->rows(); ++r) {
+    const int64_t valid =
+        std::max<int64_t>(NumKeys(q0 + r, key_length, causal) - k0, 0);
+    for (int64_t j = valid; j < scores->cols(); ++j) {
+      (*scores)(r, j) = -std::numeric_limits<T>::infinity();
+    }
+  }
+}
+
+template <typename T>
+using RowMajorMatrix =
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// Computes the attention of all batches and heads (see
+// ScaledDotProductAttentionOp) into `output` and `logsumexp`.
+template <typename T>
+void AttentionForward(OpKernelContext* context, const AttentionDims& dims,
+                      T scale, bool causal, const T* query, const T* key,
+                      const T* value, TTypes<int32>::ConstVec key_lengths,
+                      T* output, T* logsumexp) {
+  using Matrix = RowMajorMatrix<T>;
+  using ConstMatrixMap = Eigen::Map<const Matrix>;
+  using MatrixMap = Eigen::Map<Matrix>;
+
+  const int64_t num_query_blocks =
+      (dims.query_length + kQueryBlockSize - 1) / kQueryBlockSize;
+  auto compute = [&](int64_t start, int64_t limit) {
+    Matrix scores;
+    Matrix acc;
+    std::vector<T> row_max;
+    std::vector<T> row_sum;
+    for (int64_t task = start; task < limit; ++task) {
+      const int64_t bh = task / num_query_blocks;
+      const int64_t b = bh / dims.heads;
+      const int64_t q0 = task % num_query_blocks * kQueryBlockSize;
+      const int64_t nq = std::min(kQueryBlockSize, dims.query_length - q0);
+      const int64_t key_length = key_lengths(b);
+      const int64_t num_keys = NumKeys(q0 + nq - 1, key_length, causal);
+
+      ConstMatrixMap q(query + (bh * dims.query_length + q0) * dims.depth, nq,
+                       dims.depth);
+      acc.setZero(nq, dims.value_depth);
+      row_max.assign(nq, -std::numeric_limits<T>::infinity());
+      row_sum.assign(nq, T(0));
+
+      for (int64_t k0 = 0; k0 < num_keys; k0 += kKeyBlockSize) {
+        const int64_t nk = std::min(kKeyBlockSize, num_keys - k0);
+        ConstMatrixMap k(key + (bh * dims.key_length + k0) * dims.depth, nk,
+                         dims.depth);
+        ConstMatrixMap v(value + (bh * dims.key_length + k0) * dims.value_depth,
+                         nk, dims.value_depth);
+        scores.resize(nq, nk);
+        ComputeScores(q, k, scale, q0, k0, key_length, causal, &scores);
+
+        for (int64_t r = 0; r < nq; ++r) {
+          const T block_max = scores.row(r).maxCoeff();
+          if (block_max == -std::numeric_limits<T>::infinity()) {
+            // All keys of the block are masked for this query.
+            scores.row(r).setZero();
+            continue;
+          }
+          const T new_max = std::max(row_max[r], block_max);
+          const T correction = std::exp(row_max[r] - new_max);
+          row_max[r] = new_max;
+          scores.row(r) = (scores.row(r).array() - new_max).exp();
+          row_sum[r] = row_sum[r] * correction + scores.row(r).sum();
+          acc.row(r) *= correction;
+        }
+        acc.noalias() += scores * v;
+      }
+
+      MatrixMap out(output + (bh * dims.query_length + q0) * dims.value_depth,
+                    nq, dims.value_depth);
+      T* lse = logsumexp + bh * dims.query_length + q0;
+      for (int64_t r = 0; r < nq; ++r) {
+        if (row_sum[r] > T(0)) {
+          out.row(r) = acc.row(r) / row_sum[r];
+          lse[r] = row_max[r] + std::log(row_sum[r]);
+        } else {
+          // Queries that attend to no key produce zeros.
+          out.row(r).setZero();
+          lse[r] = -std::numeric_limits<T>::infinity();
+        }
+      }
+    }
+  };
+
+  const int64_t cost_per_task = kQueryBlockSize * dims.key_length *
+                                (2 * dims.depth + 2 * dims.value_depth + 20);
+  auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers,
+        dims.batch * dims.heads * num_query_blocks, cost_per_task, compute);
+}
+
+// Computes the gradients of the attention of all batches and heads (see
+// ScaledDotProductAttentionGradOp).
+template <typename T>
+void AttentionBackward(OpKernelContext* context, const AttentionDims& dims,
+                       T scale, bool causal, const T* query, const T* key,
+                       const T* value, TTypes<int32>::ConstVec key_lengths,
+                       const T* output, const T* logsumexp,
+                       const T* grad_output, T* grad_query, T* grad_key,
+                       T* grad_value) {
+  using Matrix = RowMajorMatrix<T>;
+  using ConstMatrixMap = Eigen::Map<const Matrix>;
+  using MatrixMap = Eigen::Map<Matrix>;
+
+  // Each batch and head is computed by one task, which owns its slices of
+  // all three gradients.
+  auto compute = [&](int64_t start, int64_t limit) {
+    Matrix probs;
+    Matrix grad_probs;
+    std::vector<T> delta;
+    for (int64_t bh = start; bh < limit; ++bh) {
+      const int64_t b = bh / dims.heads;
+      const int64_t key_length = key_lengths(b);
+      const int64_t query_offset = bh * dims.query_length;
+      const int64_t key_offset = bh * dims.key_length;
+
+      ConstMatrixMap o(output + query_offset * dims.value_depth,
+                       dims.query_length, dims.value_depth);
+      ConstMatrixMap grad_o(grad_output + query_offset * dims.value_depth,
+                            dims.query_length, dims.value_depth);
+      delta.resize(dims.query_length);
+      for (int64_t r = 0; r < dims.query_length; ++r) {
+        delta[r] = o.row(r).dot(grad_o.row(r));
+      }
+
+      MatrixMap grad_q(grad_query + query_offset * dims.depth,
+                       dims.query_length, dims.depth);
+      MatrixMap grad_k(grad_key + key_offset * dims.depth, dims.key_length,
+                       dims.depth);
+      MatrixMap grad_v(grad_value + key_offset * dims.value_depth,
+                       dims.key_length, dims.value_depth);
+      grad_q.setZero();
+      grad_k.setZero();
+      grad_v.setZero();
+
+      for (int64_t k0 = 0; k0 < key_length; k0 += kKeyBlockSize) {
+        const int64_t nk = std::min(kKeyBlockSize, key_length - k0);
+        ConstMatrixMap k(key + (key_offset + k0) * dims.depth, nk, dims.depth);
+        ConstMatrixMap v(value + (key_offset + k0) * dims.value_depth, nk,
+                         dims.value_depth);
+        // With a causal mask, the queries before the first key of the
+        // block do not attend to it.
+        const int64_t first_query =
+            causal ? k0 / kQueryBlockSize * kQueryBlockSize : 0;
+
+        for (int64_t q0 = first_query; q0 < dims.query_length;
+             q0 += kQueryBlockSize) {
+          const int64_t nq = std::min(kQueryBlockSize, dims.query_length - q0);
+          ConstMatrixMap q(query + (query_offset + q0) * dims.depth, nq,
+                           dims.depth);
+          probs.resize(nq, nk);
+          ComputeScores(q, k, scale, q0, k0, key_length, causal, &probs);
+          for (int64_t r = 0; r < nq; ++r) {
+            const T lse = logsumexp[query_offset + q0 + r];
+            if (lse == -std::numeric_limits<T>::infinity()) {
+              probs.row(r).setZero();
+            } else {
+              probs.row(r) = (probs.row(r).array() - lse).exp();
+            }
+          }
+
+          auto grad_o_block = grad_o.middleRows(q0, nq);
+          grad_v.middleRows(k0, nk).noalias() +=
+              probs.transpose() * grad_o_block;
+          grad_probs.noalias() = grad_o_block * v.transpose();
+          for (int64_t r = 0; r < nq; ++r) {
+            grad_probs.row(r) = probs.row(r).array() *
+                                (grad_probs.row(r).array() - delta[q0 + r]);
+          }
+          grad_q.middleRows(q0, nq).noalias() += scale * (grad_probs * k);
+          grad_k.middleRows(k0, nk).noalias() +=
+              scale * (grad_probs.transpose() * q);
+        }
+      }
+    }
+  };
+
+  const int64_t cost_per_task = dims.query_length * dims.key_length *
+                                (4 * dims.depth + 4 * dims.value_depth + 20);
+  auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers,
+        dims.batch * dims.heads, cost_per_task, compute);
+}
+
+// Attention of half and bfloat16 inputs is computed in float.
+template <typename T>
+struct AttentionComputeType {
+  using type = T;
+};
+template <>
+struct AttentionComputeType<Eigen::half> {
+  using type = float;
+};
+template <>
+struct AttentionComputeType<bfloat16> {
+  using type = float;
+};
+
+// Returns the data of `input` as `U`, casting it into `*converted` if `T` is
+// not `U`.
+template <typename T, typename U>
+Status InputAs(OpKernelContext* context, const Tensor& input,
+               Tensor* converted, const U** data) {
+  if constexpr (std::is_same_v<T, U>) {
+    *data = input.flat<U>().data();
+  } else {
+    TF_RETURN_IF_ERROR(context->allocate_temp(DataTypeToEnum<U>::value,
+                                              input.shape(), converted));
+    converted->flat<U>() = input.flat<T>().template cast<U>();
+    *data = converted->flat<U>().data();
+  }
+  return absl::OkStatus();
+}
+
+// Returns a buffer of `U` to compute `output` in: its own data if `T` is `U`,
+// otherwise `*converted`, to be cast back by CastOutput.
+template <typename T, typename U>
+Status OutputAs(OpKernelContext* context, Tensor* output, Tensor* converted,
+                U** data) {
+  if constexpr (std::is_same_v<T, U>) {
+    *data = output->flat<U>().data();
+  } else {
+    TF_RETURN_IF_ERROR(context->allocate_temp(DataTypeToEnum<U>::value,
+                                              output->shape(), converted));
+    *data = converted->flat<U>().data();
+  }
+  return absl::OkStatus();
+}
+
+template <typename T, typename U>
+void CastOutput(const Tensor& converted, Tensor* output) {
+  if constexpr (!std::is_same_v<T, U>) {
+    output->flat<T>() = converted.flat<U>().template cast<T>();
+  }
+}
+
+}  // namespace
+
+// Computes softmax(scale * Q * K^T) * V for every batch and head without
+// materializing the [query_length, key_length] attention matrix.
+//
+// The queries are processed in blocks, and the scores of a query block are
+// computed against one block of keys at a time. A running maximum and sum
+// of the exponentials per query (the online softmax) rescale the partial
+// output whenever a later key block raises the maximum. Keys at or after
+// `key_lengths[b]`, and with `causal` the keys after the query, are masked.
+// The log of the softmax denominator is returned for the gradient.
+template <typename T>
+class ScaledDotProductAttentionOp : public OpKernel {
+ public:
+  explicit ScaledDotProductAttentionOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("scale", &scale_));
+    OP_REQUIRES_OK(context, context->GetAttr("causal", &causal_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    using U = typename AttentionComputeType<T>::type;
+    const Tensor& query_in = context->input(0);
+    const Tensor& key_in = context->input(1);
+    const Tensor& value_in = context->input(2);
+    const Tensor& key_lengths_in = context->input(3);
+    AttentionDims dims;
+    OP_REQUIRES_OK(context, ValidateAttentionInputs(query_in, key_in, value_in,
+                                                    key_lengths_in, &dims));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0,
+                                TensorShape({dims.batch, dims.heads,
+                                             dims.query_length,
+                                             dims.value_depth}),
+                                &output));
+    Tensor* logsumexp = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(
+            1, TensorShape({dims.batch, dims.heads, dims.query_length}),
+            &logsumexp));
+    if (output->NumElements() == 0 && logsumexp->NumElements() == 0) return;
+
+    Tensor query_tmp, key_tmp, value_tmp, output_tmp, logsumexp_tmp;
+    const U* query;
+    const U* key;
+    const U* value;
+    U* output_data;
+    U* logsumexp_data;
+    OP_REQUIRES_OK(context,
+                   (InputAs<T, U>(context, query_in, &query_tmp, &query)));
+    OP_REQUIRES_OK(context, (InputAs<T, U>(context, key_in, &key_tmp, &key)));
+    OP_REQUIRES_OK(context,
+                   (InputAs<T, U>(context, value_in, &value_tmp, &value)));
+    OP_REQUIRES_OK(context, (OutputAs<T, U>(context, output, &output_tmp,
+                                            &output_data)));
+    OP_REQUIRES_OK(context, (OutputAs<T, U>(context, logsumexp,
+                                            &logsumexp_tmp, &logsumexp_data)));
+
+    AttentionForward<U>(context, dims, static_cast<U>(scale_), causal_, query,
+                        key, value, key_lengths_in.vec<int32>(), output_data,
+                        logsumexp_data);
+    CastOutput<T, U>(output_tmp, output);
+    CastOutput<T, U>(logsumexp_tmp, logsumexp);
+  }
+
+ private:
+  float scale_;
+  bool causal_;
+};
+
+// Computes the gradients of ScaledDotProductAttention with respect to the
+// query, key and value.
+//
+// The attention probabilities are recomputed block by block from the saved
+// log softmax denominators, so as in the forward pass the attention matrix is
+// never materialized. With P = softmax(S), dP = dO * V^T and
+// delta = rowsum(dO .* O), the score gradient is dS = P .* (dP - delta).
+//
+// A half or bfloat16 logsumexp is too coarse to recompute P from, so for
+// those types it is recomputed in float by a forward pass, along with the
+// output that delta is computed from.
+template <typename T>
+class ScaledDotProductAttentionGradOp : public OpKernel {
+ public:
+  explicit ScaledDotProductAttentionGradOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("scale", &scale_));
+    OP_REQUIRES_OK(context, context->GetAttr("causal", &causal_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    using U = typename AttentionComputeType<T>::type;
+    const Tensor& query_in = context->input(0);
+    const Tensor& key_in = context->input(1);
+    const Tensor& value_in = context->input(2);
+    const Tensor& key_lengths_in = context->input(3);
+    const Tensor& output_in = context->input(4);
+    const Tensor& logsumexp_in = context->input(5);
+    const Tensor& grad_output_in = context->input(6);
+    AttentionDims dims;
+    OP_REQUIRES_OK(context, ValidateAttentionInputs(query_in, key_in, value_in,
+                                                    key_lengths_in, &dims));
+    const TensorShape output_shape({dims.batch, dims.heads, dims.query_length,
+                                    dims.value_depth});
+    OP_REQUIRES(context,
+                output_in.shape() == output_shape &&
+                    grad_output_in.shape() == output_shape,
+                errors::InvalidArgument(
+                    "output and grad_output must have shape ",
+                    output_shape.DebugString(), ", got ",
+                    output_in.shape().DebugString(), " and ",
+                    grad_output_in.shape().DebugString()));
+    const TensorShape logsumexp_shape(
+        {dims.batch, dims.heads, dims.query_length});
+    OP_REQUIRES(context, logsumexp_in.shape() == logsumexp_shape,
+                errors::InvalidArgument("logsumexp must have shape ",
+                                        logsumexp_shape.DebugString(),
+                                        ", got ",
+                                        logsumexp_in.shape().DebugString()));
+
+    Tensor* grad_query = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, query_in.shape(), &grad_query));
+    Tensor* grad_key = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(1, key_in.shape(), &grad_key));
+    Tensor* grad_value = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(2, value_in.shape(), &grad_value));
+    if (dims.batch * dims.heads == 0) return;
+
+    Tensor query_tmp, key_tmp, value_tmp, output_tmp, logsumexp_tmp,
+        grad_output_tmp, grad_query_tmp, grad_key_tmp, grad_value_tmp;
+    const U* query;
+    const U* key;
+    const U* value;
+    const U* output;
+    const U* logsumexp;
+    const U* grad_output;
+    U* grad_query_data;
+    U* grad_key_data;
+    U* grad_value_data;
+    OP_REQUIRES_OK(context,
+                   (InputAs<T, U>(context, query_in, &query_tmp, &query)));
+    OP_REQUIRES_OK(context, (InputAs<T, U>(context, key_in, &key_tmp, &key)));
+    OP_REQUIRES_OK(context,
+                   (InputAs<T, U>(context, value_in, &value_tmp, &value)));
+    OP_REQUIRES_OK(context, (InputAs<T, U>(context, grad_output_in,
+                                           &grad_output_tmp, &grad_output)));
+    const U scale = static_cast<U>(scale_);
+    const auto key_lengths = key_lengths_in.vec<int32>();
+    if constexpr (std::is_same_v<T, U>) {
+      output = output_in.flat<U>().data();
+      logsumexp = logsumexp_in.flat<U>().data();
+    } else {
+      // The recomputed output also gives a more precise delta than the saved
+      // one.
+      OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<U>::value,
+                                                     output_shape,
+                                                     &output_tmp));
+      OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<U>::value,
+                                                     logsumexp_shape,
+                                                     &logsumexp_tmp));
+      AttentionForward<U>(context, dims, scale, causal_, query, key, value,
+                          key_lengths, output_tmp.flat<U>().data(),
+                          logsumexp_tmp.flat<U>().data());
+      output = output_tmp.flat<U>().data();
+      logsumexp = logsumexp_tmp.flat<U>().data();
+    }
+    OP_REQUIRES_OK(context, (OutputAs<T, U>(context, grad_query,
+                                            &grad_query_tmp,
+                                            &grad_query_data)));
+    OP_REQUIRES_OK(context, (OutputAs<T, U>(context, grad_key, &grad_key_tmp,
+                                            &grad_key_data)));
+    OP_REQUIRES_OK(context, (OutputAs<T, U>(context, grad_value,
+                                            &grad_value_tmp,
+                                            &grad_value_data)));
+
+    AttentionBackward<U>(context, dims, scale, causal_, query, key, value,
+                         key_lengths, output, logsumexp, grad_output,
+                         grad_query_data, grad_key_data, grad_value_data);
+    CastOutput<T, U>(grad_query_tmp, grad_query);
+    CastOutput<T, U>(grad_key_tmp, grad_key);
+    CastOutput<T, U>(grad_value_tmp, grad_value);
+  }
+
+ private:
+  float scale_;
+  bool causal_;
+};
+
+#define REGISTER_CPU(T)                                             \
+  REGISTER_KERNEL_BUILDER(Name("ScaledDotProductAttention")         \
+                              .Device(DEVICE_CPU)                   \
+                              .TypeConstraint<T>("T"),              \
+                          ScaledDotProductAttentionOp<T>);          \
+  REGISTER_KERNEL_BUILDER(Name("ScaledDotProductAttentionGrad")     \
+                              .Device(DEVICE_CPU)                   \
+                              .TypeConstraint<T>("T"),              \
+                          ScaledDotProductAttentionGradOp<T>);
+
+TF_CALL_half(REGISTER_CPU);
+TF_CALL_bfloat16(REGISTER_CPU);
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_double(REGISTER_CPU);
+
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
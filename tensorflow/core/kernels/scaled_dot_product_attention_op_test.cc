@@ -0,0 +1,211 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <limits>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class ScaledDotProductAttentionTest : public OpsTestBase {
+ protected:
+  void MakeOp(const string& op, float scale, bool causal,
+              DataType dtype = DT_FLOAT) {
+    NodeDefBuilder builder("attention", op);
+    builder.Input(FakeInput(dtype))
+        .Input(FakeInput(dtype))
+        .Input(FakeInput(dtype))
+        .Input(FakeInput(DT_INT32));
+    if (op == "ScaledDotProductAttentionGrad") {
+      builder.Input(FakeInput(dtype))
+          .Input(FakeInput(dtype))
+          .Input(FakeInput(dtype));
+    }
+    TF_ASSERT_OK(builder.Attr("scale", scale)
+                     .Attr("causal", causal)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(ScaledDotProductAttentionTest, WeightsValuesBySoftmaxOfScores) {
+  MakeOp("ScaledDotProductAttention", /*scale=*/0.5f, /*causal=*/false);
+  // One query attends to two keys with scores 0.5 * [0, 2].
+  AddInputFromArray<float>(TensorShape({1, 1, 1, 2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({1, 1, 2, 2}), {2, -1, 0, 1});
+  AddInputFromArray<float>(TensorShape({1, 1, 2, 1}), {4, 8});
+  AddInputFromArray<int32>(TensorShape({1}), {2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  const float lse = std::log(1 + std::exp(1.0f));
+  const float p1 = std::exp(1.0f - lse);
+  Tensor expected_output(DT_FLOAT, TensorShape({1, 1, 1, 1}));
+  test::FillValues<float>(&expected_output, {4 * (1 - p1) + 8 * p1});
+  test::ExpectTensorNear<float>(expected_output, *GetOutput(0), 1e-5);
+  Tensor expected_lse(DT_FLOAT, TensorShape({1, 1, 1}));
+  test::FillValues<float>(&expected_lse, {lse});
+  test::ExpectTensorNear<float>(expected_lse, *GetOutput(1), 1e-5);
+}
+
+TEST_F(ScaledDotProductAttentionTest, MasksPaddingAndFutureKeys) {
+  MakeOp("ScaledDotProductAttention", /*scale=*/1.0f, /*causal=*/true);
+  // Zero queries weight the visible keys equally. The second batch has one
+  // valid key, and the third none.
+  AddInputFromArray<float>(TensorShape({3, 1, 3, 1}), {0, 0, 0, 0, 0, 0, 0,
+                                                       0, 0});
+  AddInputFromArray<float>(TensorShape({3, 1, 3, 1}), {1, 2, 3, 1, 2, 3, 1,
+                                                       2, 3});
+  AddInputFromArray<float>(TensorShape({3, 1, 3, 1}), {3, 6, 9, 3, 6, 9, 3,
+                                                       6, 9});
+  AddInputFromArray<int32>(TensorShape({3}), {3, 1, 0});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected_output(DT_FLOAT, TensorShape({3, 1, 3, 1}));
+  test::FillValues<float>(&expected_output, {3, 4.5, 6, 3, 3, 3, 0, 0, 0});
+  test::ExpectTensorNear<float>(expected_output, *GetOutput(0), 1e-5);
+  const float inf = std::numeric_limits<float>::infinity();
+  Tensor expected_lse(DT_FLOAT, TensorShape({3, 1, 3}));
+  test::FillValues<float>(&expected_lse, {0, std::log(2.0f), std::log(3.0f),
+                                          0, 0, 0, -inf, -inf, -inf});
+  test::ExpectTensorNear<float>(expected_lse, *GetOutput(1), 1e-5);
+}
+
+TEST_F(ScaledDotProductAttentionTest, ManyBlocksMatchReference) {
+  const int query_length = 100;
+  const int key_length = 300;
+  const int depth = 3;
+  MakeOp("ScaledDotProductAttention", /*scale=*/0.7f, /*causal=*/true);
+  Tensor query(DT_FLOAT, TensorShape({1, 1, query_length, depth}));
+  query.flat<float>().setRandom();
+  Tensor key(DT_FLOAT, TensorShape({1, 1, key_length, depth}));
+  key.flat<float>().setRandom();
+  Tensor value(DT_FLOAT, TensorShape({1, 1, key_length, 1}));
+  value.flat<float>().setRandom();
+  AddInputFromArray<float>(query.shape(), query.flat<float>());
+  AddInputFromArray<float>(key.shape(), key.flat<float>());
+  AddInputFromArray<float>(value.shape(), value.flat<float>());
+  AddInputFromArray<int32>(TensorShape({1}), {250});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({1, 1, query_length, 1}));
+  for (int i = 0; i < query_length; ++i) {
+    double sum = 0;
+    double weighted = 0;
+    for (int j = 0; j <= i; ++j) {
+      double score = 0;
+      for (int d = 0; d < depth; ++d) {
+        score += query.flat<float>()(i * depth + d) *
+                 key.flat<float>()(j * depth + d);
+      }
+      const double weight = std::exp(0.7 * score);
+      sum += weight;
+      weighted += weight * value.flat<float>()(j);
+    }
+    expected.flat<float>()(i) = weighted / sum;
+  }
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-5);
+}
+
+TEST_F(ScaledDotProductAttentionTest, Gradient) {
+  MakeOp("ScaledDotProductAttentionGrad", /*scale=*/1.0f, /*causal=*/false);
+  // A zero query weights both keys by 1/2.
+  AddInputFromArray<float>(TensorShape({1, 1, 1, 1}), {0});
+  AddInputFromArray<float>(TensorShape({1, 1, 2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({1, 1, 2, 1}), {4, 8});
+  AddInputFromArray<int32>(TensorShape({1}), {2});
+  AddInputFromArray<float>(TensorShape({1, 1, 1, 1}), {6});
+  AddInputFromArray<float>(TensorShape({1, 1, 1}), {std::log(2.0f)});
+  AddInputFromArray<float>(TensorShape({1, 1, 1, 1}), {2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // dP = [8, 16] and delta = 12, so dS = [-2, 2].
+  Tensor expected_grad_query(DT_FLOAT, TensorShape({1, 1, 1, 1}));
+  test::FillValues<float>(&expected_grad_query, {-2 * 1 + 2 * 2});
+  test::ExpectTensorNear<float>(expected_grad_query, *GetOutput(0), 1e-5);
+  Tensor expected_grad_key(DT_FLOAT, TensorShape({1, 1, 2, 1}));
+  test::FillValues<float>(&expected_grad_key, {0, 0});
+  test::ExpectTensorNear<float>(expected_grad_key, *GetOutput(1), 1e-5);
+  Tensor expected_grad_value(DT_FLOAT, TensorShape({1, 1, 2, 1}));
+  test::FillValues<float>(&expected_grad_value, {1, 1});
+  test::ExpectTensorNear<float>(expected_grad_value, *GetOutput(2), 1e-5);
+}
+
+TEST_F(ScaledDotProductAttentionTest, Half) {
+  MakeOp("ScaledDotProductAttention", /*scale=*/0.5f, /*causal=*/false,
+         DT_HALF);
+  AddInputFromList<Eigen::half>(TensorShape({1, 1, 1, 2}), {1, 2});
+  AddInputFromList<Eigen::half>(TensorShape({1, 1, 2, 2}), {2, -1, 0, 1});
+  AddInputFromList<Eigen::half>(TensorShape({1, 1, 2, 1}), {4, 8});
+  AddInputFromArray<int32>(TensorShape({1}), {2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  const float lse = std::log(1 + std::exp(1.0f));
+  const float p1 = std::exp(1.0f - lse);
+  Tensor expected_output(DT_HALF, TensorShape({1, 1, 1, 1}));
+  test::FillValues<Eigen::half>(&expected_output,
+                                {Eigen::half(4 * (1 - p1) + 8 * p1)});
+  test::ExpectTensorNear<Eigen::half>(expected_output, *GetOutput(0),
+                                      Eigen::half(1e-2));
+  Tensor expected_lse(DT_HALF, TensorShape({1, 1, 1}));
+  test::FillValues<Eigen::half>(&expected_lse, {Eigen::half(lse)});
+  test::ExpectTensorNear<Eigen::half>(expected_lse, *GetOutput(1),
+                                      Eigen::half(1e-2));
+}
+
+TEST_F(ScaledDotProductAttentionTest, BFloat16Gradient) {
+  MakeOp("ScaledDotProductAttentionGrad", /*scale=*/1.0f, /*causal=*/false,
+         DT_BFLOAT16);
+  AddInputFromList<bfloat16>(TensorShape({1, 1, 1, 1}), {0});
+  AddInputFromList<bfloat16>(TensorShape({1, 1, 2, 1}), {1, 2});
+  AddInputFromList<bfloat16>(TensorShape({1, 1, 2, 1}), {4, 8});
+  AddInputFromArray<int32>(TensorShape({1}), {2});
+  AddInputFromList<bfloat16>(TensorShape({1, 1, 1, 1}), {6});
+  // The logsumexp input is recomputed in float, so its rounding to bfloat16
+  // does not reach the gradients.
+  AddInputFromList<bfloat16>(TensorShape({1, 1, 1}), {std::log(2.0f)});
+  AddInputFromList<bfloat16>(TensorShape({1, 1, 1, 1}), {2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected_grad_query(DT_BFLOAT16, TensorShape({1, 1, 1, 1}));
+  test::FillValues<bfloat16>(&expected_grad_query, {2});
+  test::ExpectTensorEqual<bfloat16>(expected_grad_query, *GetOutput(0));
+  Tensor expected_grad_key(DT_BFLOAT16, TensorShape({1, 1, 2, 1}));
+  test::FillValues<bfloat16>(&expected_grad_key, {0, 0});
+  test::ExpectTensorEqual<bfloat16>(expected_grad_key, *GetOutput(1));
+  Tensor expected_grad_value(DT_BFLOAT16, TensorShape({1, 1, 2, 1}));
+  test::FillValues<bfloat16>(&expected_grad_value, {1, 1});
+  test::ExpectTensorEqual<bfloat16>(expected_grad_value, *GetOutput(2));
+}
+
+TEST_F(ScaledDotProductAttentionTest, InvalidKeyLength) {
+  MakeOp("ScaledDotProductAttention", /*scale=*/1.0f, /*causal=*/false);
+  AddInputFromArray<float>(TensorShape({1, 1, 1, 1}), {0});
+  AddInputFromArray<float>(TensorShape({1, 1, 2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({1, 1, 2, 1}), {4, 8});
+  AddInputFromArray<int32>(TensorShape({1}), {3});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -18,7 +18,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_SEGMENT_REDUCTION_OPS_IMPL_H_
 #define TENSORFLOW_CORE_KERNELS_SEGMENT_REDUCTION_OPS_IMPL_H_
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <type_traits>
+#include <vector>
 
 #include "tensorflow/core/framework/op_requires.h"
 #include "tensorflow/core/platform/types.h"
@@ -43,6 +47,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/determinism.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -606,6 +611,20 @@ class SparseSegmentReductionOpBase : public OpKernel {
                 errors::InvalidArgument("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
+    // Large reductions are split into chunks with the same number of indices
+    // rather than by segment, so that a few huge segments do not run on a
+    // single thread.
+    const auto* worker_threads =
+        context->device()->tensorflow_cpu_worker_threads();
+    if (worker_threads->num_threads > 1 &&
+        num_indices * num_col >= kParallelReductionMinWork) {
+      OP_REQUIRES_OK(context, ValidateSortedSegments(input_flat, indices_vec,
+                                                     segment_vec, output_rows));
+      ReduceInParallel(context, input_flat, indices_vec, segment_vec,
+                       output_rows, output_flat);
+      return;
+    }
+
     Tensor temp;
     if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
       temp = tensorflow::Tensor(DT_FLOAT, output_shape);
@@ -861,6 +880,165 @@ class SparseSegmentReductionOpBase : public OpKernel {
 #undef INDEX
   }
 
+  // Below this many values the reduction runs on the calling thread.
+  static constexpr int64_t kParallelReductionMinWork = 1 << 17;
+  // Approximate number of values reduced per chunk by the parallel path. The
+  // chunks only depend on the input, so results do not depend on the number
+  // of threads.
+  static constexpr int64_t kParallelReductionChunkWork = 1 << 14;
+
+  // Low precision values are accumulated in float.
+  using Accum =
+      typename std::conditional<std::is_same<T, bfloat16>::value ||
+                                    std::is_same<T, Eigen::half>::value,
+                                float, T>::type;
+  using AccumRow = Eigen::Map<Eigen::Array<Accum, Eigen::Dynamic, 1>>;
+
+  // Checks that the segment ids are sorted and in range and that the indices
+  // are in range, with the errors of the sequential path.
+  Status ValidateSortedSegments(
+      const typename TTypes<T>::ConstMatrix& input_flat,
+      const typename TTypes<Index>::ConstVec& indices_vec,
+      const typename TTypes<SegmentId>::ConstVec& segment_vec,
+      SegmentId output_rows) {
+    const int64_t num_indices = indices_vec.size();
+    for (int64_t i = 0; i < num_indices; ++i) {
+      const SegmentId id = internal::SubtleMustCopy(segment_vec(i));
+      if (i > 0 && id < segment_vec(i - 1)) {
+        return errors::InvalidArgument("segment ids are not increasing");
+      }
+      if (!FastBoundsCheck(id, output_rows)) {
+        return errors::InvalidArgument(
+            "Segment id ", id, " out of range [0, ", output_rows,
+            "), possibly because 'segment_ids' input is not sorted.");
+      }
+      const Index index = internal::SubtleMustCopy(indices_vec(i));
+      if (!FastBoundsCheck(index, input_flat.dimension(0))) {
+        return errors::InvalidArgument("Bad: indices[", i, "] == ", index,
+                                       " out of range [0, ",
+                                       input_flat.dimension(0), ")");
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  // Writes the reduction of `count` rows whose sum is `sum` to `out`.
+  void WriteSegment(const Accum* sum, int64_t count, int64_t num_col,
+                    T* out) const {
+    const AccumRow acc(const_cast<Accum*>(sum), num_col);
+    Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>> out_row(out, num_col);
+    if (is_mean_) {
+      out_row = (acc / static_cast<Accum>(count)).template cast<T>();
+    } else if (is_sqrtn_) {
+      out_row = (acc / static_cast<Accum>(std::sqrt(count))).template cast<T>();
+    } else {
+      out_row = acc.template cast<T>();
+    }
+  }
+
+  // Reduces the segments with validated ids and indices in two passes. The
+  // first reduces fixed-size chunks of indices in parallel and writes the
+  // segments that lie within a chunk; the partial sums of the segments cut by
+  // chunk boundaries are combined in the second.
+  void ReduceInParallel(OpKernelContext* context,
+                        const typename TTypes<T>::ConstMatrix& input_flat,
+                        const typename TTypes<Index>::ConstVec& indices_vec,
+                        const typename TTypes<SegmentId>::ConstVec& segment_vec,
+                        SegmentId output_rows,
+                        typename TTypes<T>::Matrix output_flat) {
+    const int64_t num_indices = indices_vec.size();
+    const int64_t num_col = input_flat.dimension(1);
+    const int64_t chunk_size =
+        std::max<int64_t>(1, kParallelReductionChunkWork / num_col);
+    const int64_t num_chunks = (num_indices + chunk_size - 1) / chunk_size;
+    const T* input = input_flat.data();
+    T* output = output_flat.data();
+
+    // Each chunk has a slot for the segment cut by its start and one for the
+    // segment cut by its end.
+    struct Partial {
+      SegmentId id = -1;
+      int64_t count = 0;
+    };
+    std::vector<Partial> partials(2 * num_chunks);
+    std::vector<Accum> partial_sums(2 * num_chunks * num_col);
+
+    auto reduce_chunks = [&](int64_t first_chunk, int64_t last_chunk) {
+      std::vector<Accum> sum(num_col);
+      for (int64_t chunk = first_chunk; chunk < last_chunk; ++chunk) {
+        const int64_t begin = chunk * chunk_size;
+        const int64_t end = std::min(num_indices, begin + chunk_size);
+        for (int64_t start = begin; start < end;) {
+          const SegmentId id = segment_vec(start);
+          int64_t limit = start + 1;
+          while (limit < end && segment_vec(limit) == id) ++limit;
+          const bool starts_here = start == 0 || segment_vec(start - 1) != id;
+          const bool ends_here =
+              limit == num_indices || segment_vec(limit) != id;
+          if (starts_here) {
+            // Each gap is filled by the chunk holding the next segment start.
+            const SegmentId gap_start =
+                start == 0 ? 0 : segment_vec(start - 1) + 1;
+            std::fill(output + gap_start * num_col, output + id * num_col,
+                      default_value_);
+          }
+
+          Partial* partial = nullptr;
+          Accum* acc_data = sum.data();
+          if (!starts_here || !ends_here) {
+            const int64_t slot = 2 * chunk + (start == begin ? 0 : 1);
+            partial = &partials[slot];
+            acc_data = partial_sums.data() + slot * num_col;
+          }
+          AccumRow acc(acc_data, num_col);
+          acc.setZero();
+          for (int64_t i = start; i < limit; ++i) {
+            acc += Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
+                       input + indices_vec(i) * num_col, num_col)
+                       .template cast<Accum>();
+          }
+          if (partial != nullptr) {
+            partial->id = id;
+            partial->count = limit - start;
+          } else {
+            WriteSegment(acc_data, limit - start, num_col,
+                         output + id * num_col);
+          }
+          start = limit;
+        }
+      }
+    };
+    const int64_t cost_per_chunk = chunk_size * num_col * 2;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_chunks,
+          cost_per_chunk, reduce_chunks);
+
+    // The partial sums of a segment are in consecutive slots.
+    for (int64_t slot = 0; slot < 2 * num_chunks;) {
+      if (partials[slot].count == 0) {
+        ++slot;
+        continue;
+      }
+      const SegmentId id = partials[slot].id;
+      Accum* sum_data = partial_sums.data() + slot * num_col;
+      AccumRow sum(sum_data, num_col);
+      int64_t count = partials[slot].count;
+      for (++slot; slot < 2 * num_chunks &&
+                   (partials[slot].count == 0 || partials[slot].id == id);
+           ++slot) {
+        if (partials[slot].count == 0) continue;
+        sum += AccumRow(partial_sums.data() + slot * num_col, num_col);
+        count += partials[slot].count;
+      }
+      WriteSegment(sum_data, count, num_col, output + id * num_col);
+    }
+
+    // Fill the gap at the end with the default value.
+    const SegmentId last_id = segment_vec(num_indices - 1);
+    std::fill(output + (last_id + 1) * num_col, output + output_rows * num_col,
+              default_value_);
+  }
+
   const bool is_mean_;
   const bool is_sqrtn_;
   const bool has_num_segments_;
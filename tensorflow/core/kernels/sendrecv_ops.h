@@ -48,6 +48,8 @@ class RecvOp : public AsyncOpKernel {
   string key_prefix_;
   Rendezvous::ParsedKey parsed_key_;
   bool hostmem_sendrecv_;
+  // Name of the codec with which the tensor is sent over the network, if any.
+  string wire_codec_;
 
   RecvOp(const RecvOp&) = delete;
   void operator=(const RecvOp&) = delete;
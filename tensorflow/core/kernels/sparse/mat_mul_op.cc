@@ -58,6 +58,9 @@ namespace tensorflow {
 static constexpr int32_t kMaxShards = 20;
 // Number of shards allocated to each thread.
 static constexpr int32_t kNumShardsPerThread = 3;
+// Minimum number of columns of the dense operand processed at once on CPU, so
+// that the inner loop stays vectorized when the dense operand is tall.
+static constexpr int64_t kMinColBlockSize = 64;
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
@@ -156,10 +159,11 @@ class CSRMatMulOp : public OpKernel {
 
 // CPU Kernel to compute sparse-dense matrix multiplication.
 //
-// Uses Eigen SparseMatrix to compute the sparse-dense multiplication between
-// a CSR SparseMatrix `a` and dense Tensor `b`. If intra-op parallelism is
-// available, the implementation parallelizes the computation across each row
-// of the sparse matrix.
+// Computes the sparse-dense multiplication between a CSR SparseMatrix `a` and
+// dense Tensor `b`. If intra-op parallelism is available, the implementation
+// parallelizes the computation across the rows of the sparse matrix, which
+// are split into shards with about the same number of nonzeros. Eigen
+// SparseMatrix is used when `a` is transposed.
 template <typename T>
 class CSRMatMulCPUOp : public CSRMatMulOp<CPUDevice, T> {
   using SparseMatrix = Eigen::SparseMatrix<T, Eigen::RowMajor>;
@@ -194,10 +198,19 @@ class CSRMatMulCPUOp : public CSRMatMulOp<CPUDevice, T> {
       std::swap(num_lhs_rows, num_lhs_cols);
     }
 
+    // When only b is transposed and a has no more nonzeros than the inner
+    // dimension, transposing b costs more than the product, so the rows of b
+    // are read in place instead.
+    const bool gather_transposed_rhs =
+        this->transpose_b_ && !this->transpose_a_ &&
+        sparse_matrix_a->total_nnz() <= batch_size * num_rhs_cols;
+
     // Possibly transpose the dense Tensor b.
     const Tensor* rhs = &matrix_b;
     Tensor b_transposed;
-    if (this->transpose_b_) {
+    if (gather_transposed_rhs) {
+      std::swap(num_rhs_rows, num_rhs_cols);
+    } else if (this->transpose_b_) {
       OP_REQUIRES_OK(
           ctx, TransposeAndConjugateTensor(ctx, matrix_b, this->conjugate_b_,
                                            &b_transposed));
@@ -215,7 +228,11 @@ class CSRMatMulCPUOp : public CSRMatMulOp<CPUDevice, T> {
                             this->transpose_output_, &output,
                             &output_transposed, &matmul_result));
 
-    if (!this->transpose_a_) {
+    if (gather_transposed_rhs) {
+      SparseDenseMatMulWithTransposedRHS(ctx, batch_size, num_lhs_rows,
+                                         num_rhs_cols, *sparse_matrix_a,
+                                         matrix_b, matmul_result);
+    } else if (!this->transpose_a_) {
       SparseDenseMatMulWithoutTransposedLHS(
           ctx, batch_size, num_lhs_rows, *sparse_matrix_a, *rhs, matmul_result);
     } else {  // transpose_a_ == true
@@ -292,54 +309,164 @@ class CSRMatMulCPUOp : public CSRMatMulOp<CPUDevice, T> {
         csr_matrix.values_vec<T>(batch_index).data() + row_offset);
   }
 
+  // A contiguous range of rows of one batch of the CSR Sparse Matrix.
+  struct RowShard {
+    int64_t batch_idx;
+    int64_t row_begin;
+    int64_t row_end;
+  };
+
+  // Splits the rows of all batches of `lhs` into shards that have about the
+  // same number of nonzeros and rows, so that a few dense rows do not end up
+  // in one shard.
+  std::vector<RowShard> ShardRowsByNnz(const CSRSparseMatrix& lhs,
+                                       const int64_t batch_size,
+                                       const int64_t num_lhs_rows,
+                                       const int64_t num_shards) {
+    // Each row costs one unit plus one per nonzero.
+    const int64_t total_cost = lhs.total_nnz() + batch_size * num_lhs_rows;
+    const int64_t shard_cost =
+        std::max<int64_t>(1, (total_cost + num_shards - 1) / num_shards);
+    std::vector<RowShard> shards;
+    shards.reserve(num_shards + batch_size);
+    for (int64_t batch_idx = 0; batch_idx < batch_size; ++batch_idx) {
+      const auto row_ptrs = lhs.row_pointers_vec(batch_idx);
+      int64_t row_begin = 0;
+      int64_t cost = 0;
+      for (int64_t row = 0; row < num_lhs_rows; ++row) {
+        cost += 1 + row_ptrs(row + 1) - row_ptrs(row);
+        if (cost >= shard_cost) {
+          shards.push_back({batch_idx, row_begin, row + 1});
+          row_begin = row + 1;
+          cost = 0;
+        }
+      }
+      if (row_begin < num_lhs_rows) {
+        shards.push_back({batch_idx, row_begin, num_lhs_rows});
+      }
+    }
+    return shards;
+  }
+
+  // Runs `fn(batch_idx, row_begin, row_end)` for shards of rows of `lhs` with
+  // balanced numbers of nonzeros on the intra-op thread pool.
+  void ParallelForRowShards(
+      OpKernelContext* ctx, const CSRSparseMatrix& lhs,
+      const int64_t batch_size, const int64_t num_lhs_rows,
+      const std::function<void(int64_t, int64_t, int64_t)>& fn) {
+    auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+    const int64_t num_shards =
+        std::max(kMaxShards, kNumShardsPerThread * worker_threads.num_threads);
+    const std::vector<RowShard> shards =
+        ShardRowsByNnz(lhs, batch_size, num_lhs_rows, num_shards);
+    worker_threads.workers->ParallelFor(
+        shards.size() /* total */,
+        thread::ThreadPool::SchedulingParams(
+            thread::ThreadPool::SchedulingStrategy::
+                kFixedBlockSize /* strategy */,
+            absl::nullopt /* cost_per_unit */, 1 /* block_size */),
+        [&](int64_t shard_begin, int64_t shard_end) {
+          for (int64_t i = shard_begin; i < shard_end; ++i) {
+            fn(shards[i].batch_idx, shards[i].row_begin, shards[i].row_end);
+          }
+        });
+  }
+
   // Sparse-Dense Matrix Multiplication between a CSRSparseMatrix (LHS) and a
   // dense Tensor (RHS).
+  //
+  // Each output row is accumulated from the rows of the RHS selected by the
+  // nonzeros of the LHS row. The columns of the RHS are processed in blocks
+  // whose slice of the RHS fits in the L2 cache.
   void SparseDenseMatMulWithoutTransposedLHS(OpKernelContext* ctx,
                                              const int64_t batch_size,
                                              const int64_t num_lhs_rows,
                                              const CSRSparseMatrix& lhs,
                                              const Tensor& rhs,
                                              Tensor* output) {
-    // Parallelize matrix multiplication across batch dimensions and across
-    // rows in each batch.
-    auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
-    const int32_t num_threads = worker_threads.num_threads;
-    const int64_t block_size =
-        num_lhs_rows / std::max(kMaxShards, kNumShardsPerThread * num_threads);
+    using ConstRow = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>;
+    using Row = Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>;
     const int64_t num_rhs_rows = rhs.dim_size(rhs.dims() - 2);
     const int64_t num_rhs_cols = rhs.dim_size(rhs.dims() - 1);
-    worker_threads.workers->ParallelFor(
-        batch_size * num_lhs_rows /* total */,
-        thread::ThreadPool::SchedulingParams(
-            thread::ThreadPool::SchedulingStrategy::
-                kFixedBlockSize /* strategy */,
-            absl::nullopt /* cost_per_unit */, block_size),
-        [&](int64_t batch_and_row_begin, int64_t batch_and_row_end) {
-          HandleBatchAndRowRange(
-              num_lhs_rows, batch_and_row_begin, batch_and_row_end,
-              [&](int64_t batch_idx, int64_t row_begin, int64_t row_end) {
-                const int64_t num_shard_rows = row_end - row_begin;
-
-                // Define an Eigen::SparseMatrix over the row range:
-                // [row_begin, row_end) of the CSR SparseMatrix A.
-                std::vector<int32> row_ptrs;
-                auto sparse_matrix = GetSparseMatrixRef(
-                    lhs, batch_idx, row_begin, num_shard_rows, &row_ptrs);
-
-                // Map the corresponding rows of the rhs.
-                ConstMatrixMap rhs_map(rhs.flat<T>().data() + batch_idx *
-                                                                  num_rhs_rows *
-                                                                  num_rhs_cols,
-                                       num_rhs_rows, num_rhs_cols);
+    const int64_t rhs_col_bytes =
+        std::max<int64_t>(num_rhs_rows, 1) * sizeof(T);
+    const int64_t col_block_size = std::min(
+        num_rhs_cols, std::max<int64_t>(kMinColBlockSize,
+                                        Eigen::l2CacheSize() / rhs_col_bytes));
+    ParallelForRowShards(
+        ctx, lhs, batch_size, num_lhs_rows,
+        [&](int64_t batch_idx, int64_t row_begin, int64_t row_end) {
+          const auto row_ptrs = lhs.row_pointers_vec(batch_idx);
+          const int32* col_indices = lhs.col_indices_vec(batch_idx).data();
+          const T* values = lhs.values_vec<T>(batch_idx).data();
+          const T* rhs_data =
+              rhs.flat<T>().data() + batch_idx * num_rhs_rows * num_rhs_cols;
+          T* output_data = output->flat<T>().data() +
+                           batch_idx * num_lhs_rows * num_rhs_cols;
+          for (int64_t col_begin = 0; col_begin < num_rhs_cols;
+               col_begin += col_block_size) {
+            const int64_t width =
+                std::min(col_block_size, num_rhs_cols - col_begin);
+            for (int64_t row = row_begin; row < row_end; ++row) {
+              Row out(output_data + row * num_rhs_cols + col_begin, width);
+              out.setZero();
+              for (int32 i = row_ptrs(row); i < row_ptrs(row + 1); ++i) {
+                out += values[i] *
+                       ConstRow(rhs_data + col_indices[i] * num_rhs_cols +
+                                    col_begin,
+                                width);
+              }
+            }
+          }
+        });
+  }
 
-                // Write to the corresponding rows of the output matrix.
-                MatrixMap output_map(
-                    output->flat<T>().data() +
-                        batch_idx * num_lhs_rows * num_rhs_cols +
-                        row_begin * num_rhs_cols,
-                    num_shard_rows, num_rhs_cols);
-                output_map.noalias() = sparse_matrix * rhs_map;
-              });
+  // Sparse-Dense Matrix Multiplication between a CSRSparseMatrix (LHS) and
+  // the transpose of a dense Tensor `transposed_rhs`, without transposing it.
+  //
+  // Each output value is the dot product of an LHS row with a row of
+  // `transposed_rhs`. The rows of `transposed_rhs` are processed in blocks that
+  // fit in the L2 cache.
+  void SparseDenseMatMulWithTransposedRHS(OpKernelContext* ctx,
+                                          const int64_t batch_size,
+                                          const int64_t num_lhs_rows,
+                                          const int64_t num_output_cols,
+                                          const CSRSparseMatrix& lhs,
+                                          const Tensor& transposed_rhs,
+                                          Tensor* output) {
+    const int64_t inner_dim =
+        transposed_rhs.dim_size(transposed_rhs.dims() - 1);
+    const int64_t rhs_row_bytes = std::max<int64_t>(inner_dim, 1) * sizeof(T);
+    const int64_t row_block_size = std::min(
+        num_output_cols,
+        std::max<int64_t>(1, Eigen::l2CacheSize() / rhs_row_bytes));
+    const bool conjugate = this->conjugate_b_;
+    ParallelForRowShards(
+        ctx, lhs, batch_size, num_lhs_rows,
+        [&](int64_t batch_idx, int64_t row_begin, int64_t row_end) {
+          const auto row_ptrs = lhs.row_pointers_vec(batch_idx);
+          const int32* col_indices = lhs.col_indices_vec(batch_idx).data();
+          const T* values = lhs.values_vec<T>(batch_idx).data();
+          const T* rhs_data = transposed_rhs.flat<T>().data() +
+                              batch_idx * num_output_cols * inner_dim;
+          T* output_data = output->flat<T>().data() +
+                           batch_idx * num_lhs_rows * num_output_cols;
+          for (int64_t col_begin = 0; col_begin < num_output_cols;
+               col_begin += row_block_size) {
+            const int64_t col_end =
+                std::min(num_output_cols, col_begin + row_block_size);
+            for (int64_t row = row_begin; row < row_end; ++row) {
+              for (int64_t col = col_begin; col < col_end; ++col) {
+                const T* rhs_row = rhs_data + col * inner_dim;
+                T sum(0);
+                for (int32 i = row_ptrs(row); i < row_ptrs(row + 1); ++i) {
+                  const T b = rhs_row[col_indices[i]];
+                  sum += values[i] * (conjugate ? Eigen::numext::conj(b) : b);
+                }
+                output_data[row * num_output_cols + col] = sum;
+              }
+            }
+          }
         });
   }
 
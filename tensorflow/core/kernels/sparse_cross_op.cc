@@ -326,6 +326,76 @@ class StringCrosser {
   const tstring k_feature_separator_;
 };
 
+// Writes the hashed crosses of one batch row through `updater`, in the order
+// in which ProductIterator enumerates them. Every feature is hashed once per
+// row instead of once per cross it takes part in, and the FingerprintCat64
+// prefix of the leading columns is shared by all crosses that agree on them,
+// so most crosses cost a single FingerprintCat64. A null `hash_key` makes the
+// first column's hash the seed of each cross.
+void GenerateHashedCrosses(
+    const std::vector<std::unique_ptr<ColumnInterface<int64_t>>>& columns,
+    const int64_t batch_index, const uint64* hash_key,
+    const int64_t num_buckets, bool strong_hash,
+    const OutputUpdater<int64_t>& updater) {
+  const int num_columns = columns.size();
+  DCHECK_GT(num_columns, 0);
+  gtl::InlinedVector<int64_t, 8> feature_counts(num_columns);
+  gtl::InlinedVector<int64_t, 8> hash_offsets(num_columns + 1, 0);
+  for (int i = 0; i < num_columns; ++i) {
+    feature_counts[i] = columns[i]->FeatureCount(batch_index);
+    // If one column is missing any feature, there won't be any cross.
+    if (feature_counts[i] == 0) return;
+    hash_offsets[i + 1] = hash_offsets[i] + feature_counts[i];
+  }
+  gtl::InlinedVector<uint64, 32> feature_hashes(hash_offsets[num_columns]);
+  for (int i = 0; i < num_columns; ++i) {
+    for (int64_t n = 0; n < feature_counts[i]; ++n) {
+      feature_hashes[hash_offsets[i] + n] =
+          columns[i]->Feature(batch_index, n, strong_hash);
+    }
+  }
+
+  // `prefix_hashes[i]` is the hash of the cross of columns 0..i at the
+  // current position.
+  gtl::InlinedVector<int64_t, 8> position(num_columns, 0);
+  gtl::InlinedVector<uint64, 8> prefix_hashes(num_columns);
+  auto update_prefix = [&](int i) {
+    const uint64 hash_i = feature_hashes[hash_offsets[i] + position[i]];
+    if (i > 0) {
+      prefix_hashes[i] = FingerprintCat64(prefix_hashes[i - 1], hash_i);
+    } else if (hash_key != nullptr) {
+      prefix_hashes[i] = FingerprintCat64(*hash_key, hash_i);
+    } else {
+      prefix_hashes[i] = hash_i;
+    }
+  };
+  for (int i = 0; i < num_columns; ++i) update_prefix(i);
+
+  int64_t cross_count = 0;
+  while (true) {
+    const uint64 hashed_output = prefix_hashes[num_columns - 1];
+    // The return value is int64 based on the number of buckets.
+    if (num_buckets > 0) {
+      updater.Update(batch_index, cross_count, hashed_output % num_buckets);
+    } else {
+      // To prevent negative output we take modulo to max int64.
+      updater.Update(batch_index, cross_count,
+                     hashed_output % std::numeric_limits<int64_t>::max());
+    }
+    ++cross_count;
+
+    // Advances to the next cross, last column first, and rehashes only the
+    // columns from the one that changed.
+    int changed = num_columns - 1;
+    while (changed >= 0 && ++position[changed] == feature_counts[changed]) {
+      position[changed] = 0;
+      --changed;
+    }
+    if (changed < 0) return;
+    for (int i = changed; i < num_columns; ++i) update_prefix(i);
+  }
+}
+
 // Generates the sparse crosses as nested hash to avoid string manipulations.
 class HashCrosser {
  public:
@@ -335,22 +405,11 @@ class HashCrosser {
       const tstring k_feature_separator_unused)
       : columns_(columns), num_buckets_(num_buckets), hash_key_(hash_key) {}
 
-  int64_t Generate(const int64_t batch_index,
-                   const std::vector<int>& permutation,
-                   bool unused_strong_hash) const {
-    // Do the fingerprint concatenation on uint64.
-    uint64 hashed_output = hash_key_;
-    for (size_t i = 0; i < permutation.size(); ++i) {
-      uint64 hash_i = columns_[i]->Feature(batch_index, permutation[i], false);
-      hashed_output = FingerprintCat64(hashed_output, hash_i);
-    }
-    // The return value is int64 based on the number of buckets.
-    if (num_buckets_ > 0) {
-      return hashed_output % num_buckets_;
-    } else {
-      // To prevent negative output we take modulo to max int64.
-      return hashed_output % std::numeric_limits<int64_t>::max();
-    }
+  // Generates all crosses of the given batch row.
+  void GenerateRow(const int64_t batch_index, bool unused_strong_hash,
+                   const OutputUpdater<int64_t>& updater) const {
+    GenerateHashedCrosses(columns_, batch_index, &hash_key_, num_buckets_,
+                          /*strong_hash=*/false, updater);
   }
 
  private:
@@ -368,24 +427,11 @@ class HashCrosserV2 {
       const tstring k_feature_separator_unused)
       : columns_(columns), num_buckets_(num_buckets) {}
 
-  int64_t Generate(const int64_t batch_index,
-                   const std::vector<int>& permutation,
-                   bool strong_hash) const {
-    // Do the fingerprint concatenation on uint64.
-    uint64 hashed_output =
-        columns_[0]->Feature(batch_index, permutation[0], strong_hash);
-    for (size_t i = 1; i < permutation.size(); ++i) {
-      uint64 hash_i =
-          columns_[i]->Feature(batch_index, permutation[i], strong_hash);
-      hashed_output = FingerprintCat64(hashed_output, hash_i);
-    }
-    // The return value is int64 based on the number of buckets.
-    if (num_buckets_ > 0) {
-      return hashed_output % num_buckets_;
-    } else {
-      // To prevent negative output we take modulo to max int64.
-      return hashed_output % std::numeric_limits<int64_t>::max();
-    }
+  // Generates all crosses of the given batch row.
+  void GenerateRow(const int64_t batch_index, bool strong_hash,
+                   const OutputUpdater<int64_t>& updater) const {
+    GenerateHashedCrosses(columns_, batch_index, /*hash_key=*/nullptr,
+                          num_buckets_, strong_hash, updater);
   }
 
  private:
@@ -787,13 +833,17 @@ class SparseCrossOp : public OpKernel {
         output_start_indices, indices_out, values_out);
     auto do_work = [&columns, crosser, updater](int64_t begin, int64_t end) {
       for (int b = begin; b < end; b++) {
-        ProductIterator<InternalType> product_iterator(columns, b);
-        int64_t cross_count = 0;
-        while (product_iterator.HasNext()) {
-          const auto permutation = product_iterator.Next();
-          updater.Update(b, cross_count,
-                         crosser.Generate(b, permutation, false));
-          cross_count++;
+        if constexpr (HASHED_OUTPUT) {
+          crosser.GenerateRow(b, false, updater);
+        } else {
+          ProductIterator<InternalType> product_iterator(columns, b);
+          int64_t cross_count = 0;
+          while (product_iterator.HasNext()) {
+            const auto permutation = product_iterator.Next();
+            updater.Update(b, cross_count,
+                           crosser.Generate(b, permutation, false));
+            cross_count++;
+          }
         }
       }
     };
@@ -935,17 +985,10 @@ class SparseCrossHashedOp : public OpKernel {
     HashCrosserV2 crosser(columns, num_buckets, 0, unused_sep);
     OutputUpdater<int64_t> updater(output_start_indices, indices_out,
                                    values_out);
-    auto do_work = [&columns, crosser, updater, strong_hash](int64_t begin,
-                                                             int64_t end) {
+    auto do_work = [crosser, updater, strong_hash](int64_t begin,
+                                                   int64_t end) {
       for (int b = begin; b < end; b++) {
-        ProductIterator<int64_t> product_iterator(columns, b);
-        int64_t cross_count = 0;
-        while (product_iterator.HasNext()) {
-          const auto permutation = product_iterator.Next();
-          updater.Update(b, cross_count,
-                         crosser.Generate(b, permutation, strong_hash));
-          cross_count++;
-        }
+        crosser.GenerateRow(b, strong_hash, updater);
       }
     };
 
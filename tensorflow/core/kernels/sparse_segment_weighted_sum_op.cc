@@ -0,0 +1,191 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "absl/base/prefetch.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Number of indices ahead of the current one whose rows are prefetched.
+constexpr int64_t kPrefetchDistance = 8;
+// Rows are prefetched up to this many bytes, which covers typical embedding
+// widths without flooding the memory system for wide rows.
+constexpr int64_t kMaxPrefetchBytes = 512;
+constexpr int64_t kCacheLineSize = 64;
+
+// Computes `output[s] = sum_{i : segment_ids[i] == s} weights[i] *
+// data[indices[i]]` without materializing the gathered rows.
+template <typename T, typename Index, typename SegmentId>
+class SparseSegmentWeightedSumOp : public OpKernel {
+ public:
+  // Low precision values are accumulated in float.
+  using Accum =
+      typename std::conditional<std::is_same<T, Eigen::half>::value ||
+                                    std::is_same<T, bfloat16>::value,
+                                float, T>::type;
+
+  explicit SparseSegmentWeightedSumOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& data = context->input(0);
+    const Tensor& indices = context->input(1);
+    const Tensor& weights = context->input(2);
+    const Tensor& segment_ids = context->input(3);
+
+    OP_REQUIRES(context, TensorShapeUtils::IsVectorOrHigher(data.shape()),
+                errors::InvalidArgument("data must be at least 1-D, got ",
+                                        data.shape().DebugString()));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(indices.shape()),
+                errors::InvalidArgument("indices must be a vector, got ",
+                                        indices.shape().DebugString()));
+    const int64_t num_indices = indices.NumElements();
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(weights.shape()) &&
+                    weights.NumElements() == num_indices,
+                errors::InvalidArgument(
+                    "weights must be a vector of the same size as indices, "
+                    "got shapes ",
+                    weights.shape().DebugString(), " and ",
+                    indices.shape().DebugString()));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(segment_ids.shape()) &&
+                    segment_ids.NumElements() == num_indices,
+                errors::InvalidArgument(
+                    "segment_ids must be a vector of the same size as "
+                    "indices, got shapes ",
+                    segment_ids.shape().DebugString(), " and ",
+                    indices.shape().DebugString()));
+
+    const auto data_flat = data.flat_outer_dims<T>();
+    const auto indices_vec = indices.vec<Index>();
+    const auto weights_vec = weights.vec<T>();
+    const auto segment_vec = segment_ids.vec<SegmentId>();
+    const int64_t num_rows = data_flat.dimension(0);
+    const int64_t num_col = data_flat.dimension(1);
+
+    // Find the first index of each non-empty segment.
+    std::vector<int64_t> segment_starts;
+    for (int64_t i = 0; i < num_indices; ++i) {
+      const Index index = internal::SubtleMustCopy(indices_vec(i));
+      OP_REQUIRES(context, FastBoundsCheck(index, num_rows),
+                  errors::InvalidArgument("indices[", i, "] == ", index,
+                                          " out of range [0, ", num_rows,
+                                          ")"));
+      const SegmentId segment_id = internal::SubtleMustCopy(segment_vec(i));
+      if (i == 0) {
+        OP_REQUIRES(context, segment_id >= 0,
+                    errors::InvalidArgument("segment ids must be >= 0"));
+      } else if (segment_id != segment_vec(i - 1)) {
+        OP_REQUIRES(context, segment_id > segment_vec(i - 1),
+                    errors::InvalidArgument("segment ids are not increasing"));
+      } else {
+        continue;
+      }
+      segment_starts.push_back(i);
+    }
+    const int64_t num_segments = segment_starts.size();
+    segment_starts.push_back(num_indices);
+
+    TensorShape output_shape = data.shape();
+    const int64_t output_rows =
+        num_indices > 0 ? segment_vec(num_indices - 1) + 1 : 0;
+    OP_REQUIRES_OK(context, output_shape.SetDimWithStatus(0, output_rows));
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, output_shape, &output));
+    auto output_flat = output->flat_outer_dims<T>();
+    if (num_segments < output_rows) {
+      // Empty segments are zero.
+      output_flat.setZero();
+    }
+
+    const int64_t prefetch_bytes =
+        std::min<int64_t>(num_col * sizeof(T), kMaxPrefetchBytes);
+    auto reduce_segments = [&](int64_t begin, int64_t end) {
+      std::vector<Accum> accum(num_col);
+      for (int64_t s = begin; s < end; ++s) {
+        std::fill(accum.begin(), accum.end(), Accum(0));
+        for (int64_t i = segment_starts[s]; i < segment_starts[s + 1]; ++i) {
+          if (i + kPrefetchDistance < num_indices) {
+            const char* next = reinterpret_cast<const char*>(
+                &data_flat(indices_vec(i + kPrefetchDistance), 0));
+            for (int64_t offset = 0; offset < prefetch_bytes;
+                 offset += kCacheLineSize) {
+              absl::PrefetchToLocalCache(next + offset);
+            }
+          }
+          const T* row = &data_flat(indices_vec(i), 0);
+          const Accum weight = static_cast<Accum>(weights_vec(i));
+          for (int64_t j = 0; j < num_col; ++j) {
+            accum[j] += weight * static_cast<Accum>(row[j]);
+          }
+        }
+        T* out = &output_flat(segment_vec(segment_starts[s]), 0);
+        for (int64_t j = 0; j < num_col; ++j) {
+          out[j] = static_cast<T>(accum[j]);
+        }
+      }
+    };
+    const int64_t cost_per_segment =
+        num_segments > 0 ? num_indices / num_segments * num_col * 4 : 0;
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_segments,
+          cost_per_segment, reduce_segments);
+  }
+};
+
+#define REGISTER_KERNELS(type, index_type, segment_ids_type)          \
+  REGISTER_KERNEL_BUILDER(                                            \
+      Name("SparseSegmentWeightedSum")                                \
+          .Device(DEVICE_CPU)                                         \
+          .TypeConstraint<type>("T")                                  \
+          .TypeConstraint<index_type>("Tidx")                         \
+          .TypeConstraint<segment_ids_type>("Tsegmentids"),           \
+      SparseSegmentWeightedSumOp<type, index_type, segment_ids_type>)
+#define REGISTER_KERNELS_FOR_INDEX_TYPES(type) \
+  REGISTER_KERNELS(type, int32, int32);        \
+  REGISTER_KERNELS(type, int32, int64_t);      \
+  REGISTER_KERNELS(type, int64_t, int32);      \
+  REGISTER_KERNELS(type, int64_t, int64_t);
+
+TF_CALL_half(REGISTER_KERNELS_FOR_INDEX_TYPES);
+TF_CALL_bfloat16(REGISTER_KERNELS_FOR_INDEX_TYPES);
+TF_CALL_float(REGISTER_KERNELS_FOR_INDEX_TYPES);
+TF_CALL_double(REGISTER_KERNELS_FOR_INDEX_TYPES);
+
+#undef REGISTER_KERNELS_FOR_INDEX_TYPES
+#undef REGISTER_KERNELS
+
+}  // namespace
+}  // namespace tensorflow
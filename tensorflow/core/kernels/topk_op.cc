@@ -20,6 +20,8 @@ limitations under the License.
 #include "tensorflow/core/kernels/topk_op.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <numeric>
 #include <vector>
 
@@ -129,6 +131,88 @@ class TopK : public OpKernel {
 
 namespace functor {
 
+// Rows with at least this many columns, whose k is a small fraction of the
+// row, first drop the values below a threshold estimated from a sample.
+constexpr int64_t kTopKFilterMinCols = 1 << 15;
+
+// Collects in `candidates`, in increasing order, the columns of a row that
+// are not below a threshold estimated from a strided sample of the row so
+// that about 4 * k columns remain. Returns false if the k largest values of
+// the row might not all be candidates, or if the row has NaNs; a heap over
+// the whole row is needed then. If `worker_threads` is not null the row is
+// scanned in parallel.
+template <typename T, typename Tidx>
+bool FilterTopKCandidates(
+    const T* input_data, int64_t num_cols, int k,
+    const DeviceBase::CpuWorkerThreads* worker_threads,
+    std::vector<Tidx>* candidates) {
+  const int64_t num_samples = num_cols / 32;
+  const int64_t stride = num_cols / num_samples;
+  std::vector<T> samples(num_samples);
+  for (int64_t i = 0; i < num_samples; ++i) {
+    samples[i] = input_data[i * stride];
+    if (Eigen::numext::isnan(samples[i])) return false;
+  }
+  // At least 8 samples are kept so that the threshold is rarely too high for
+  // small k.
+  const int64_t rank = std::min<int64_t>(
+      num_samples,
+      std::max<int64_t>(8, (4 * int64_t{k} * num_samples + num_cols - 1) /
+                               num_cols));
+  std::nth_element(samples.begin(), samples.begin() + rank - 1, samples.end(),
+                   std::greater<T>());
+  const T threshold = samples[rank - 1];
+  // Many more candidates than expected come from ties with the threshold, in
+  // which case the heap over the whole row is as fast.
+  const int64_t max_candidates = num_cols / 4;
+
+  const int64_t num_blocks =
+      worker_threads != nullptr ? num_cols / kTopKFilterMinCols : 1;
+  std::vector<std::vector<Tidx>> block_candidates(num_blocks);
+  std::vector<char> block_overflow(num_blocks, false);
+  auto filter_blocks = [&](int64_t start_block, int64_t limit_block) {
+    for (int64_t block = start_block; block < limit_block; ++block) {
+      const int64_t start = block * num_cols / num_blocks;
+      const int64_t limit = (block + 1) * num_cols / num_blocks;
+      std::vector<Tidx>& out = block_candidates[block];
+      for (int64_t c = start; c < limit; ++c) {
+        // Candidates are rare, so the branch is almost always predicted.
+        if (!(input_data[c] < threshold)) {
+          if (static_cast<int64_t>(out.size()) == max_candidates) {
+            block_overflow[block] = true;
+            break;
+          }
+          out.push_back(c);
+        }
+      }
+    }
+  };
+  if (worker_threads != nullptr) {
+    const int64_t cost_per_block = (num_cols / num_blocks) *
+                                   Eigen::TensorOpCost::AddCost<T>();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+          cost_per_block, filter_blocks);
+  } else {
+    filter_blocks(0, num_blocks);
+  }
+
+  int64_t num_candidates = 0;
+  for (int64_t block = 0; block < num_blocks; ++block) {
+    if (block_overflow[block]) return false;
+    num_candidates += block_candidates[block].size();
+  }
+  if (num_candidates < k || num_candidates > max_candidates) return false;
+  candidates->clear();
+  candidates->reserve(num_candidates);
+  for (const std::vector<Tidx>& block : block_candidates) {
+    for (const Tidx c : block) {
+      if (Eigen::numext::isnan(input_data[c])) return false;
+      candidates->push_back(c);
+    }
+  }
+  return true;
+}
+
 template <typename T, typename Tidx>
 struct TopKFunctor<CPUDevice, T, Tidx> {
   static EIGEN_ALWAYS_INLINE Status Compute(
@@ -161,6 +245,14 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
       return OkStatus();
     }
 
+    // All values below the k largest of a sample are dropped from huge rows
+    // before the heap sees them.
+    const bool filter_rows = num_cols >= kTopKFilterMinCols &&
+                             int64_t{k} * 32 <= num_cols;
+    // Set when there are too few rows to keep the threads busy, so each row
+    // is scanned in parallel instead.
+    const DeviceBase::CpuWorkerThreads* row_worker_threads = nullptr;
+
     auto SortIndices = [&](int64_t start_batch, int64_t limit_batch) {
       for (int32_t b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
@@ -207,9 +299,19 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
         } else {
           // Use the TopN heap object to sort.
           gtl::TopN<Tidx, decltype(stable_comp)> filter(k, stable_comp);
-          filter.reserve(num_cols);
-          for (Tidx c = 0; c < num_cols; ++c) {
-            filter.push(c);
+          std::vector<Tidx> candidates;
+          if (filter_rows &&
+              FilterTopKCandidates<T, Tidx>(input_data, num_cols, k,
+                                            row_worker_threads, &candidates)) {
+            filter.reserve(candidates.size());
+            for (const Tidx c : candidates) {
+              filter.push(c);
+            }
+          } else {
+            filter.reserve(num_cols);
+            for (Tidx c = 0; c < num_cols; ++c) {
+              filter.push(c);
+            }
           }
 
           int32_t i = 0;
@@ -248,6 +350,11 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
                                    ? kint64max
                                    : static_cast<int64_t>(total_cost);
     auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    if (filter_rows && num_rows < worker_threads.num_threads) {
+      row_worker_threads = &worker_threads;
+      SortIndices(0, num_rows);
+      return OkStatus();
+    }
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
@@ -17,7 +17,11 @@ limitations under the License.
 #include "tensorflow/core/kernels/training_ops.h"
 
 #include <algorithm>  // NOLINT
+#include <cstdint>
+#include <numeric>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -40,6 +44,78 @@ inline T sgn(const T x) {
   T one(1);
   return (x == zero ? zero : (x < zero ? -one : one));
 }
+
+// The positions of `indices` grouped by distinct row. The positions of
+// `rows[k]` are `positions[starts[k]:starts[k + 1]]`.
+template <typename Tindex>
+struct RowGroups {
+  std::vector<Tindex> rows;
+  std::vector<int64_t> starts;
+  std::vector<int64_t> positions;
+};
+
+template <typename Tindex>
+Status GroupByRow(typename TTypes<Tindex>::ConstVec indices,
+                  Tindex first_dim_size, RowGroups<Tindex>* groups) {
+  const int64_t n = indices.dimension(0);
+  absl::flat_hash_map<Tindex, int64_t> slots;
+  slots.reserve(n);
+  std::vector<int64_t> slot_of(n);
+  for (int64_t i = 0; i < n; ++i) {
+    const Tindex index = internal::SubtleMustCopy(indices(i));
+    if (!FastBoundsCheck(index, first_dim_size)) {
+      return errors::InvalidArgument(strings::StrCat(
+          "Index ", index, " at offset ", i, " in indices is out of range"));
+    }
+    const int64_t num_rows = groups->rows.size();
+    const int64_t slot = slots.try_emplace(index, num_rows).first->second;
+    if (slot == num_rows) groups->rows.push_back(index);
+    slot_of[i] = slot;
+  }
+  groups->starts.assign(groups->rows.size() + 1, 0);
+  for (int64_t slot : slot_of) ++groups->starts[slot + 1];
+  std::partial_sum(groups->starts.begin(), groups->starts.end(),
+                   groups->starts.begin());
+  std::vector<int64_t> next(groups->starts.begin(), groups->starts.end() - 1);
+  groups->positions.resize(n);
+  for (int64_t i = 0; i < n; ++i) groups->positions[next[slot_of[i]]++] = i;
+  return OkStatus();
+}
+
+// Calls `update(row, grad)` once for each distinct row of `indices`, where
+// `grad` is the sum of the gradients at all positions of that row. The
+// distinct rows are partitioned across threads, so that each row is updated
+// by exactly one thread and rows never need to be locked against each other.
+template <typename T, typename Tindex, typename Update>
+Status ApplyDeduplicated(const CPUDevice& d,
+                         typename TTypes<T>::ConstMatrix grad,
+                         typename TTypes<Tindex>::ConstVec indices,
+                         Tindex first_dim_size,
+                         const Eigen::TensorOpCost& cost,
+                         const Update& update) {
+  RowGroups<Tindex> groups;
+  TF_RETURN_IF_ERROR(GroupByRow<Tindex>(indices, first_dim_size, &groups));
+  const Index inner_dim = grad.dimension(1);
+  d.parallelFor(groups.rows.size(), cost, [&](Index begin, Index end) {
+    Eigen::Tensor<T, 1, Eigen::RowMajor> sum(inner_dim);
+    typename TTypes<T>::ConstVec sum_vec(sum.data(), inner_dim);
+    for (Index k = begin; k < end; ++k) {
+      const int64_t first = groups.starts[k];
+      const int64_t last = groups.starts[k + 1];
+      if (last - first == 1) {
+        update(groups.rows[k],
+               grad.template chip<0>(groups.positions[first]));
+        continue;
+      }
+      sum = grad.template chip<0>(groups.positions[first]);
+      for (int64_t p = first + 1; p < last; ++p) {
+        sum += grad.template chip<0>(groups.positions[p]);
+      }
+      update(groups.rows[k], sum_vec);
+    }
+  });
+  return OkStatus();
+}
 }  // namespace
 
 namespace functor {
@@ -242,6 +318,42 @@ struct SparseApplyAdagrad<CPUDevice, T, Tindex, has_epsilon> {
   }
 };
 
+// Like `SparseApplyAdagrad`, but `indices` may contain duplicates, whose
+// gradients are summed and applied once per row.
+template <typename T, typename Tindex, bool has_epsilon>
+struct SparseApplyAdagradDeduplicated {
+  Status operator()(const CPUDevice& d, typename TTypes<T>::Matrix var,
+                    typename TTypes<T>::Matrix accum,
+                    typename TTypes<T>::ConstScalar lr,
+                    typename TTypes<T>::ConstScalar epsilon,
+                    typename TTypes<T>::ConstMatrix grad,
+                    typename TTypes<Tindex>::ConstVec indices,
+                    int64_t inner_dim, bool update_slots) {
+    const T lr_scalar = lr();
+    const T epsilon_scalar = epsilon();
+    const int in_bytes = inner_dim * sizeof(T) * 3;
+    const int out_bytes = inner_dim * sizeof(T) * 2;
+    const int cycles = inner_dim * (Eigen::TensorOpCost::AddCost<T>() * 3 +
+                                    Eigen::TensorOpCost::MulCost<T>() * 2);
+    const Eigen::TensorOpCost cost(in_bytes, out_bytes, cycles);
+    return ApplyDeduplicated<T, Tindex>(
+        d, grad, indices, static_cast<Tindex>(var.dimension(0)), cost,
+        [&](Tindex row, const auto& g) {
+          auto a = accum.template chip<0>(row);
+          auto v = var.template chip<0>(row);
+          if (update_slots) {
+            a += g.square();
+          }
+          if (has_epsilon) {
+            v -= g.constant(lr_scalar) * g /
+                 (a.sqrt() + a.constant(epsilon_scalar));
+          } else {
+            v -= g.constant(lr_scalar) * g * a.rsqrt();
+          }
+        });
+  }
+};
+
 template <typename T>
 struct ApplyProximalAdagrad<CPUDevice, T> {
   void operator()(const CPUDevice& d, typename TTypes<T>::Flat var,
@@ -683,6 +795,60 @@ struct SparseApplyFtrl<CPUDevice, T, Tindex, has_l2_shrinkage> {
   }
 };
 
+// Like `SparseApplyFtrl`, but `indices` may contain duplicates, whose
+// gradients are summed and applied once per row.
+template <typename T, typename Tindex, bool has_l2_shrinkage>
+struct SparseApplyFtrlDeduplicated {
+  Status operator()(const CPUDevice& d, typename TTypes<T>::Matrix var_flat,
+                    typename TTypes<T>::Matrix accum_flat,
+                    typename TTypes<T>::Matrix linear_flat,
+                    typename TTypes<T>::ConstScalar lr,
+                    typename TTypes<T>::ConstScalar l1,
+                    typename TTypes<T>::ConstScalar l2,
+                    typename TTypes<T>::ConstScalar l2_shrinkage,
+                    typename TTypes<T>::ConstScalar lr_power,
+                    typename TTypes<T>::ConstMatrix grad_flat,
+                    typename TTypes<Tindex>::ConstVec indices_vec,
+                    int64_t inner_dim, bool multiply_linear_by_lr) {
+    const T lr_scalar = lr();
+    const T l1_scalar = l1();
+    const T l2_scalar = l2();
+    const T l2_shrinkage_scalar = has_l2_shrinkage ? l2_shrinkage() : T(0);
+    const T lr_power_scalar = lr_power();
+    const int in_bytes = inner_dim * sizeof(T) * 4;
+    const int out_bytes = inner_dim * sizeof(T) * 3;
+    const int cycles = inner_dim * (Eigen::TensorOpCost::AddCost<T>() * 8 +
+                                    Eigen::TensorOpCost::MulCost<T>() * 6);
+    const Eigen::TensorOpCost cost(in_bytes, out_bytes, cycles);
+    return ApplyDeduplicated<T, Tindex>(
+        d, grad_flat, indices_vec,
+        static_cast<Tindex>(var_flat.dimension(0)), cost,
+        [&](Tindex row, const auto& grad) {
+          auto accum = accum_flat.template chip<0>(row);
+          auto linear = linear_flat.template chip<0>(row);
+          auto var = var_flat.template chip<0>(row);
+          if (has_l2_shrinkage) {
+            auto grad_with_shrinkage =
+                grad + static_cast<T>(2) * l2_shrinkage_scalar * var;
+            ComputeFtrl(/*grad=*/grad,
+                        /*grad_maybe_with_shrinkage=*/grad_with_shrinkage,
+                        /*accum=*/accum, /*linear=*/linear, /*var=*/var,
+                        /*l1_scalar=*/l1_scalar, /*l2_scalar=*/l2_scalar,
+                        /*multiply_linear_by_lr=*/multiply_linear_by_lr,
+                        /*lr_power_scalar=*/lr_power_scalar,
+                        /*lr_scalar=*/lr_scalar);
+          } else {
+            ComputeFtrl(/*grad=*/grad, /*grad_maybe_with_shrinkage=*/grad,
+                        /*accum=*/accum, /*linear=*/linear, /*var=*/var,
+                        /*l1_scalar=*/l1_scalar, /*l2_scalar=*/l2_scalar,
+                        /*multiply_linear_by_lr=*/multiply_linear_by_lr,
+                        /*lr_power_scalar=*/lr_power_scalar,
+                        /*lr_scalar=*/lr_scalar);
+          }
+        });
+  }
+};
+
 template <typename T>
 struct ApplyMomentum<CPUDevice, T> {
   void operator()(const CPUDevice& d, typename TTypes<T>::Flat var,
@@ -1884,6 +2050,13 @@ class SparseApplyAdagradOp : public OpKernel {
   explicit SparseApplyAdagradOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("update_slots", &update_slots_));
+    OP_REQUIRES_OK(
+        ctx, ctx->GetAttr("deduplicate_indices", &deduplicate_indices_));
+    OP_REQUIRES(ctx,
+                (!deduplicate_indices_ ||
+                 std::is_same<Device, CPUDevice>::value),
+                errors::InvalidArgument(
+                    "deduplicate_indices is only supported on CPU"));
   }
 
   void Compute(OpKernelContext* ctx) override TF_NO_THREAD_SAFETY_ANALYSIS {
@@ -1938,6 +2111,18 @@ class SparseApplyAdagradOp : public OpKernel {
                 errors::InvalidArgument(
                     "Inner dimension should be greater than zero."));
 
+    if (deduplicate_indices_) {
+      OP_REQUIRES_OK(
+          ctx, functor::SparseApplyAdagradDeduplicated<
+                   T, Tindex, /*has_epsilon = */ false>()(
+                   ctx->eigen_device<CPUDevice>(), var.flat_outer_dims<T>(),
+                   accum.flat_outer_dims<T>(),
+                   // Note: Passing lr as a placeholder for unused epsilon.
+                   lr.scalar<T>(), lr.scalar<T>(), grad.flat_outer_dims<T>(),
+                   indices.vec<Tindex>(), inner_dim, update_slots_));
+      MaybeForwardRefInputToRefOutput(ctx, 0, 0);
+      return;
+    }
     const Device& device = ctx->template eigen_device<Device>();
     OP_REQUIRES_OK(
         ctx, functor::SparseApplyAdagrad<Device, T, Tindex,
@@ -1953,6 +2138,7 @@ class SparseApplyAdagradOp : public OpKernel {
  private:
   bool use_exclusive_lock_;
   bool update_slots_;
+  bool deduplicate_indices_;
 };
 
 #define REGISTER_KERNELS(D, T, Tindices)                                 \
@@ -2014,6 +2200,13 @@ class SparseApplyAdagradV2Op : public OpKernel {
   explicit SparseApplyAdagradV2Op(OpKernelConstruction* ctx) : OpKernel(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("update_slots", &update_slots_));
+    OP_REQUIRES_OK(
+        ctx, ctx->GetAttr("deduplicate_indices", &deduplicate_indices_));
+    OP_REQUIRES(ctx,
+                (!deduplicate_indices_ ||
+                 std::is_same<Device, CPUDevice>::value),
+                errors::InvalidArgument(
+                    "deduplicate_indices is only supported on CPU"));
   }
 
   void Compute(OpKernelContext* ctx) override TF_NO_THREAD_SAFETY_ANALYSIS {
@@ -2072,6 +2265,17 @@ class SparseApplyAdagradV2Op : public OpKernel {
                 errors::InvalidArgument(
                     "Inner dimension should be greater than zero."));
 
+    if (deduplicate_indices_) {
+      OP_REQUIRES_OK(
+          ctx, functor::SparseApplyAdagradDeduplicated<
+                   T, Tindex, /*has_epsilon = */ true>()(
+                   ctx->eigen_device<CPUDevice>(), var.flat_outer_dims<T>(),
+                   accum.flat_outer_dims<T>(), lr.scalar<T>(),
+                   epsilon.scalar<T>(), grad.flat_outer_dims<T>(),
+                   indices.vec<Tindex>(), inner_dim, update_slots_));
+      MaybeForwardRefInputToRefOutput(ctx, 0, 0);
+      return;
+    }
     const Device& device = ctx->template eigen_device<Device>();
     OP_REQUIRES_OK(
         ctx, functor::SparseApplyAdagrad<Device, T, Tindex,
@@ -2086,6 +2290,7 @@ class SparseApplyAdagradV2Op : public OpKernel {
  private:
   bool use_exclusive_lock_;
   bool update_slots_;
+  bool deduplicate_indices_;
 };
 
 #define REGISTER_KERNELS(D, T, Tindices)                                   \
@@ -2802,6 +3007,13 @@ class SparseApplyFtrlOp : public OpKernel {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(
         ctx, ctx->GetAttr("multiply_linear_by_lr", &multiply_linear_by_lr_));
+    OP_REQUIRES_OK(
+        ctx, ctx->GetAttr("deduplicate_indices", &deduplicate_indices_));
+    OP_REQUIRES(ctx,
+                (!deduplicate_indices_ ||
+                 std::is_same<Device, CPUDevice>::value),
+                errors::InvalidArgument(
+                    "deduplicate_indices is only supported on CPU"));
   }
 
   void Compute(OpKernelContext* ctx) override TF_NO_THREAD_SAFETY_ANALYSIS {
@@ -2917,8 +3129,23 @@ class SparseApplyFtrlOp : public OpKernel {
                                   l2_shrinkage->shape().DebugString()));
     }
 
-    const Device& device = ctx->template eigen_device<Device>();
     auto indices_vec = indices.vec<Tindex>();
+    if (deduplicate_indices_) {
+      functor::SparseApplyFtrlDeduplicated<T, Tindex, has_l2_shrinkage>
+          apply_ftrl;
+      OP_REQUIRES_OK(
+          ctx,
+          apply_ftrl(
+              ctx->eigen_device<CPUDevice>(), var.flat_outer_dims<T>(),
+              accum.flat_outer_dims<T>(), linear.flat_outer_dims<T>(),
+              lr.scalar<T>(), l1.scalar<T>(), l2.scalar<T>(),
+              has_l2_shrinkage ? l2_shrinkage->scalar<T>() : l2.scalar<T>(),
+              lr_power.scalar<T>(), grad.flat_outer_dims<T>(), indices_vec,
+              inner_dim, multiply_linear_by_lr_));
+      MaybeForwardRefInputToRefOutput(ctx, 0, 0);
+      return;
+    }
+    const Device& device = ctx->template eigen_device<Device>();
     OP_REQUIRES_OK(
         ctx, functor::SparseApplyFtrl<Device, T, Tindex, has_l2_shrinkage>()(
                  device, var.flat_outer_dims<T>(), accum.flat_outer_dims<T>(),
@@ -2936,6 +3163,7 @@ class SparseApplyFtrlOp : public OpKernel {
  private:
   bool use_exclusive_lock_;
   bool multiply_linear_by_lr_;
+  bool deduplicate_indices_;
 };
 
 #define REGISTER_KERNELS(D, T, Tindices)                                      \
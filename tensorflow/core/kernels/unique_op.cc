@@ -13,9 +13,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -26,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -68,6 +73,188 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
   using map_type = std::unordered_map<bfloat16, TIndex>;
 };
 
+// Inputs with at least this many elements are uniquified in parallel.
+constexpr int64_t kParallelUniqueMinSize = 1 << 16;
+
+// Integer ids, for which equality is bitwise, can be uniquified in parallel.
+template <typename T>
+constexpr bool kSupportsParallelUnique =
+    std::is_same<T, int32>::value || std::is_same<T, int64_t>::value;
+
+// The finalizer of MurmurHash3, which mixes all bits of `x` into all bits of
+// the result.
+inline uint64_t MixBits(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// Computes the outputs of `UniqueOp` for the 1-D `input` of `n` elements with
+// the worker threads, in the same order of first appearance as the sequential
+// implementation.
+//
+// The elements are partitioned by the high bits of their hash, each partition
+// is deduplicated independently with a linear probing table, and the output
+// position of each unique element is its rank among the first appearances,
+// computed with a prefix sum.
+template <typename T, typename TIndex>
+Status ParallelUnique(OpKernelContext* context, const T* input, int64_t n,
+                      TensorShape output_shape, int64_t axis,
+                      bool with_counts, TIndex* idx) {
+  const auto* worker_threads =
+      context->device()->tensorflow_cpu_worker_threads();
+  const int num_threads = worker_threads->num_threads;
+  int num_partitions = 1;
+  while (num_partitions < 4 * num_threads && num_partitions < 256) {
+    num_partitions *= 2;
+  }
+  const auto partition_of = [num_partitions](uint64_t hash) {
+    return static_cast<int>(hash >> 56) & (num_partitions - 1);
+  };
+  const int64_t num_chunks = std::min<int64_t>(4 * num_threads, n);
+  const int64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+  const auto run_chunks = [&](int64_t cost_per_chunk,
+                              const std::function<void(int64_t, int64_t,
+                                                       int64_t)>& fn) {
+    Shard(num_threads, worker_threads->workers, num_chunks, cost_per_chunk,
+          [&](int64_t begin, int64_t end) {
+            for (int64_t c = begin; c < end; ++c) {
+              fn(c, c * chunk_size, std::min(n, (c + 1) * chunk_size));
+            }
+          });
+  };
+
+  // Scatter the positions of the elements into their partitions, keeping
+  // the positions of each partition in increasing order.
+  std::vector<uint8_t> partitions(n);
+  std::vector<int64_t> offsets(num_chunks * num_partitions, 0);
+  run_chunks(chunk_size * 20, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t* chunk_counts = &offsets[c * num_partitions];
+    for (int64_t i = begin; i < end; ++i) {
+      partitions[i] = partition_of(MixBits(static_cast<uint64_t>(input[i])));
+      ++chunk_counts[partitions[i]];
+    }
+  });
+  std::vector<int64_t> partition_starts(num_partitions + 1, 0);
+  for (int p = 0; p < num_partitions; ++p) {
+    partition_starts[p + 1] = partition_starts[p];
+    for (int64_t c = 0; c < num_chunks; ++c) {
+      const int64_t count = offsets[c * num_partitions + p];
+      offsets[c * num_partitions + p] = partition_starts[p + 1];
+      partition_starts[p + 1] += count;
+    }
+  }
+  std::vector<int64_t> positions(n);
+  run_chunks(chunk_size * 5, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t* chunk_offsets = &offsets[c * num_partitions];
+    for (int64_t i = begin; i < end; ++i) {
+      positions[chunk_offsets[partitions[i]]++] = i;
+    }
+  });
+
+  // Deduplicate each partition. For each position of the partition, record
+  // the partition-local id of its element, and for each local id the first
+  // position of its element.
+  std::vector<int64_t> local_ids(n);
+  std::vector<int64_t> first_positions(n);
+  // 1 at first appearances, later replaced by the output position.
+  std::vector<int64_t> ranks(n, 0);
+  std::vector<int64_t> num_local_uniques(num_partitions);
+  struct Slot {
+    T key;
+    int64_t id;
+  };
+  const auto for_each_partition =
+      [&](const std::function<void(int, int64_t, int64_t)>& fn) {
+        Shard(num_threads, worker_threads->workers, num_partitions,
+              (n / num_partitions + 1) * 50, [&](int64_t begin, int64_t end) {
+                for (int64_t p = begin; p < end; ++p) {
+                  fn(p, partition_starts[p], partition_starts[p + 1]);
+                }
+              });
+      };
+  for_each_partition([&](int p, int64_t begin, int64_t end) {
+    int64_t capacity = 16;
+    while (capacity < 2 * (end - begin)) capacity *= 2;
+    const uint64_t mask = capacity - 1;
+    std::vector<Slot> table(capacity, Slot{T(), -1});
+    int64_t num_local = 0;
+    for (int64_t k = begin; k < end; ++k) {
+      const int64_t pos = positions[k];
+      const T key = input[pos];
+      uint64_t h = MixBits(static_cast<uint64_t>(key)) & mask;
+      while (true) {
+        Slot& slot = table[h];
+        if (slot.id < 0) {
+          slot.key = key;
+          slot.id = num_local;
+          first_positions[begin + num_local] = pos;
+          ranks[pos] = 1;
+          local_ids[k] = num_local++;
+          break;
+        }
+        if (slot.key == key) {
+          local_ids[k] = slot.id;
+          break;
+        }
+        h = (h + 1) & mask;
+      }
+    }
+    num_local_uniques[p] = num_local;
+  });
+
+  // Rank the first appearances in input order.
+  std::vector<int64_t> chunk_bases(num_chunks + 1, 0);
+  run_chunks(chunk_size, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t count = 0;
+    for (int64_t i = begin; i < end; ++i) count += ranks[i];
+    chunk_bases[c + 1] = count;
+  });
+  for (int64_t c = 0; c < num_chunks; ++c) {
+    chunk_bases[c + 1] += chunk_bases[c];
+  }
+  run_chunks(chunk_size, [&](int64_t c, int64_t begin, int64_t end) {
+    int64_t rank = chunk_bases[c];
+    for (int64_t i = begin; i < end; ++i) {
+      if (ranks[i]) ranks[i] = rank++;
+    }
+  });
+  const int64_t uniq_size = chunk_bases[num_chunks];
+
+  output_shape.set_dim(axis, uniq_size);
+  Tensor* output = nullptr;
+  TF_RETURN_IF_ERROR(context->allocate_output(0, output_shape, &output));
+  T* out = output->flat<T>().data();
+  TIndex* counts = nullptr;
+  if (with_counts) {
+    Tensor* count_output = nullptr;
+    TF_RETURN_IF_ERROR(context->allocate_output(2, TensorShape({uniq_size}),
+                                                &count_output));
+    counts = count_output->flat<TIndex>().data();
+  }
+
+  // Each output position belongs to exactly one partition, so the partitions
+  // write their outputs and counts without synchronization.
+  for_each_partition([&](int p, int64_t begin, int64_t end) {
+    for (int64_t u = 0; u < num_local_uniques[p]; ++u) {
+      const int64_t pos = first_positions[begin + u];
+      const int64_t rank = ranks[pos];
+      out[rank] = input[pos];
+      if (counts != nullptr) counts[rank] = 0;
+      first_positions[begin + u] = rank;
+    }
+    for (int64_t k = begin; k < end; ++k) {
+      const int64_t rank = first_positions[begin + local_ids[k]];
+      idx[positions[k]] = rank;
+      if (counts != nullptr) ++counts[rank];
+    }
+  });
+  return OkStatus();
+}
+
 // `UniqueOp` computes the unique elements in the input tensor.
 //
 // * `T` is the element type.
@@ -143,6 +330,18 @@ class UniqueOp : public OpKernel {
     auto idx_vec = idx->template vec<TIndex>();
 
     int64_t uniq_size;
+    if constexpr (kSupportsParallelUnique<T>) {
+      if (new_sizes[0] == 1 && new_sizes[2] == 1 &&
+          new_sizes[1] >= kParallelUniqueMinSize &&
+          context->device()->tensorflow_cpu_worker_threads()->num_threads >
+              1) {
+        OP_REQUIRES_OK(context, ParallelUnique<T, TIndex>(
+                                    context, input.flat<T>().data(),
+                                    new_sizes[1], input.shape(), axis,
+                                    num_outputs() > 2, idx_vec.data()));
+        return;
+      }
+    }
     if (new_sizes[0] == 1 && new_sizes[2] == 1) {
       // Specialized and faster implementation when unique is run over single
       // elements. Here we put T directly into the map rather than ints pointing
@@ -0,0 +1,261 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/winograd_conv2d.h"
+
+#include <cstring>
+#include <utility>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+// Applies the 1-D filter transform G (6x3)
+//
+//   [  1/4     0     0  ]
+//   [ -1/6  -1/6  -1/6  ]
+//   [ -1/6   1/6  -1/6  ]
+//   [  1/24  1/12  1/6  ]
+//   [  1/24 -1/12  1/6  ]
+//   [   0     0     1   ]
+//
+// to `size` vectors of three values.
+void FilterTransform(const float* const in[3], float* const out[6],
+                     int64_t size) {
+  for (int64_t i = 0; i < size; ++i) {
+    const float g0 = in[0][i];
+    const float g1 = in[1][i];
+    const float g2 = in[2][i];
+    const float even = g0 + g2;
+    const float quarter = g0 * (1.0f / 24) + g2 * (1.0f / 6);
+    out[0][i] = g0 * 0.25f;
+    out[1][i] = (even + g1) * (-1.0f / 6);
+    out[2][i] = (even - g1) * (-1.0f / 6);
+    out[3][i] = quarter + g1 * (1.0f / 12);
+    out[4][i] = quarter - g1 * (1.0f / 12);
+    out[5][i] = g2;
+  }
+}
+
+// Applies the 1-D input transform B^T (6x6)
+//
+//   [ 4   0  -5   0   1   0 ]
+//   [ 0  -4  -4   1   1   0 ]
+//   [ 0   4  -4  -1   1   0 ]
+//   [ 0  -2  -1   2   1   0 ]
+//   [ 0   2  -1  -2   1   0 ]
+//   [ 0   4   0  -5   0   1 ]
+//
+// to `size` vectors of six values.
+void InputTransform(const float* const in[6], float* const out[6],
+                    int64_t size) {
+  for (int64_t i = 0; i < size; ++i) {
+    const float d0 = in[0][i];
+    const float d1 = in[1][i];
+    const float d2 = in[2][i];
+    const float d3 = in[3][i];
+    const float d4 = in[4][i];
+    const float d5 = in[5][i];
+    const float a = d4 - 4.0f * d2;
+    const float b = d3 - 4.0f * d1;
+    const float c = d4 - d2;
+    const float d = 2.0f * (d3 - d1);
+    out[0][i] = 4.0f * d0 - 5.0f * d2 + d4;
+    out[1][i] = a + b;
+    out[2][i] = a - b;
+    out[3][i] = c + d;
+    out[4][i] = c - d;
+    out[5][i] = 4.0f * d1 - 5.0f * d3 + d5;
+  }
+}
+
+// Applies the 1-D output transform A^T (4x6)
+//
+//   [ 1   1   1   1   1   0 ]
+//   [ 0   1  -1   2  -2   0 ]
+//   [ 0   1   1   4   4   0 ]
+//   [ 0   1  -1   8  -8   1 ]
+//
+// to `size` vectors of six values.
+void OutputTransform(const float* const in[6], float* const out[4],
+                     int64_t size) {
+  for (int64_t i = 0; i < size; ++i) {
+    const float m0 = in[0][i];
+    const float m1 = in[1][i];
+    const float m2 = in[2][i];
+    const float m3 = in[3][i];
+    const float m4 = in[4][i];
+    const float m5 = in[5][i];
+    const float sum12 = m1 + m2;
+    const float diff12 = m1 - m2;
+    const float sum34 = m3 + m4;
+    const float diff34 = m3 - m4;
+    out[0][i] = m0 + sum12 + sum34;
+    out[1][i] = diff12 + 2.0f * diff34;
+    out[2][i] = sum12 + 4.0f * sum34;
+    out[3][i] = diff12 + 8.0f * diff34 + m5;
+  }
+}
+
+}  // namespace
+
+bool CanUseWinogradConv2D(int64_t in_depth, int64_t out_depth,
+                          int64_t out_rows, int64_t out_cols) {
+  // Shallow convolutions are dominated by the transforms, and are not worth
+  // the lower precision of the Winograd algorithm.
+  if (in_depth < 16 || out_depth < 16) return false;
+
+  static const bool enabled = [] {
+    bool enabled = true;
+    Status status =
+        ReadBoolFromEnvVar("TF_USE_WINOGRAD_CONV2D", true, &enabled);
+    if (!status.ok()) {
+      LOG(WARNING) << "Ignoring TF_USE_WINOGRAD_CONV2D: " << status;
+      enabled = true;
+    }
+    return enabled;
+  }();
+  if (!enabled) return false;
+
+  // Partial tiles at the bottom and right are computed in full.
+  const int64_t num_tiles =
+      ((out_rows + kWinogradOutputTileSize - 1) / kWinogradOutputTileSize) *
+      ((out_cols + kWinogradOutputTileSize - 1) / kWinogradOutputTileSize);
+  const int64_t winograd_cost =
+      num_tiles * (kWinogradTilePoints * in_depth * out_depth +
+                   200 * in_depth + 150 * out_depth);
+  const int64_t direct_cost = out_rows * out_cols * 9 * in_depth * out_depth;
+
+  VLOG(2) << "CanUseWinogradConv2D"
+          << " winograd_cost: " << winograd_cost
+          << " direct_cost: " << direct_cost;
+  return winograd_cost < direct_cost;
+}
+
+void WinogradTransformFilter(const float* filter, int64_t in_depth,
+                             int64_t out_depth, float* transformed) {
+  // Every filter position is a contiguous [in_depth, out_depth] matrix, so
+  // the transforms are applied to all of them at once.
+  const int64_t size = in_depth * out_depth;
+  std::vector<float> rows(kWinogradInputTileSize * 3 * size);
+  for (int c = 0; c < 3; ++c) {
+    const float* in[3];
+    float* out[6];
+    for (int r = 0; r < 3; ++r) in[r] = filter + (r * 3 + c) * size;
+    for (int r = 0; r < 6; ++r) out[r] = rows.data() + (r * 3 + c) * size;
+    FilterTransform(in, out, size);
+  }
+  for (int r = 0; r < 6; ++r) {
+    const float* in[3];
+    float* out[6];
+    for (int c = 0; c < 3; ++c) in[c] = rows.data() + (r * 3 + c) * size;
+    for (int c = 0; c < 6; ++c) out[c] = transformed + (r * 6 + c) * size;
+    FilterTransform(in, out, size);
+  }
+}
+
+Status WinogradFilterCache::Get(OpKernelContext* ctx, const Tensor& filter,
+                                Tensor* transformed) {
+  mutex_lock l(mu_);
+  if (!filter_.IsInitialized() || !filter.SharesBufferWith(filter_) ||
+      filter.shape() != filter_.shape()) {
+    const int64_t in_depth = filter.dim_size(2);
+    const int64_t out_depth = filter.dim_size(3);
+    Tensor new_transformed;
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(
+        DT_FLOAT, TensorShape({kWinogradTilePoints, in_depth, out_depth}),
+        &new_transformed));
+    WinogradTransformFilter(filter.flat<float>().data(), in_depth, out_depth,
+                            new_transformed.flat<float>().data());
+    filter_ = filter;
+    transformed_ = std::move(new_transformed);
+  }
+  *transformed = transformed_;
+  return absl::OkStatus();
+}
+
+void WinogradTransformInputTile(const float* input, int64_t in_rows,
+                                int64_t in_cols, int64_t in_depth, int64_t row,
+                                int64_t col, int64_t stride, float* scratch,
+                                float* transformed) {
+  float* tile = scratch;
+  float* cols = scratch + kWinogradTilePoints * in_depth;
+  for (int r = 0; r < 6; ++r) {
+    for (int c = 0; c < 6; ++c) {
+      float* point = tile + (r * 6 + c) * in_depth;
+      const int64_t y = row + r;
+      const int64_t x = col + c;
+      if (y >= 0 && y < in_rows && x >= 0 && x < in_cols) {
+        std::memcpy(point, input + (y * in_cols + x) * in_depth,
+                    in_depth * sizeof(float));
+      } else {
+        std::memset(point, 0, in_depth * sizeof(float));
+      }
+    }
+  }
+
+  for (int c = 0; c < 6; ++c) {
+    const float* in[6];
+    float* out[6];
+    for (int r = 0; r < 6; ++r) {
+      in[r] = tile + (r * 6 + c) * in_depth;
+      out[r] = cols + (r * 6 + c) * in_depth;
+    }
+    InputTransform(in, out, in_depth);
+  }
+  for (int r = 0; r < 6; ++r) {
+    const float* in[6];
+    float* out[6];
+    for (int c = 0; c < 6; ++c) {
+      in[c] = cols + (r * 6 + c) * in_depth;
+      out[c] = transformed + (r * 6 + c) * stride;
+    }
+    InputTransform(in, out, in_depth);
+  }
+}
+
+void WinogradTransformOutputTile(const float* transformed, int64_t stride,
+                                 int64_t out_rows, int64_t out_cols,
+                                 int64_t out_depth, int64_t row, int64_t col,
+                                 float* scratch, float* output) {
+  float* rows = scratch;
+  // Values outside of the image are written here and dropped.
+  float* dropped = scratch + 24 * out_depth;
+
+  for (int c = 0; c < 6; ++c) {
+    const float* in[6];
+    float* out[4];
+    for (int r = 0; r < 6; ++r) in[r] = transformed + (r * 6 + c) * stride;
+    for (int r = 0; r < 4; ++r) out[r] = rows + (r * 6 + c) * out_depth;
+    OutputTransform(in, out, out_depth);
+  }
+  for (int r = 0; r < 4; ++r) {
+    const float* in[6];
+    float* out[4];
+    for (int c = 0; c < 6; ++c) in[c] = rows + (r * 6 + c) * out_depth;
+    for (int c = 0; c < 4; ++c) {
+      const int64_t y = row + r;
+      const int64_t x = col + c;
+      out[c] = y < out_rows && x < out_cols
+                   ? output + (y * out_cols + x) * out_depth
+                   : dropped + (r * 4 + c) * out_depth;
+    }
+    OutputTransform(in, out, out_depth);
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,228 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_WINOGRAD_CONV2D_H_
+#define TENSORFLOW_CORE_KERNELS_WINOGRAD_CONV2D_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Eigen/Core"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/fused_eigen_output_kernels.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+// Winograd F(4x4, 3x3) convolution for NHWC float inputs and HWIO filters.
+//
+// Each 6x6 input tile is transformed into 36 points, each point is multiplied
+// by the transformed filter as an [in_depth, out_depth] matrix, and the
+// products are transformed back into a 4x4 output tile. The output kernel of
+// a fused computation (bias, batch norm, activation) is applied to each tile
+// right after the output transform, while it is still in cache.
+//
+// Details:
+// *) Fast Algorithms for Convolutional Neural Networks: Lavin, Gray
+
+// Number of points in a transformed tile.
+inline constexpr int kWinogradTilePoints = 36;
+// Height and width of an input tile.
+inline constexpr int kWinogradInputTileSize = 6;
+// Height and width of an output tile.
+inline constexpr int kWinogradOutputTileSize = 4;
+
+// Returns true if a 3x3 convolution with stride and dilation 1 and the given
+// depths and output size is expected to be faster with Winograd F(4x4, 3x3)
+// than with the im2col based spatial convolution.
+bool CanUseWinogradConv2D(int64_t in_depth, int64_t out_depth,
+                          int64_t out_rows, int64_t out_cols);
+
+// Transforms a [3, 3, in_depth, out_depth] filter into
+// [36, in_depth, out_depth].
+void WinogradTransformFilter(const float* filter, int64_t in_depth,
+                             int64_t out_depth, float* transformed);
+
+// Keeps the transformed filter of a kernel between its invocations, so that
+// a constant filter is transformed once. The filter must not be updated in
+// place, as a variable may be.
+class WinogradFilterCache {
+ public:
+  // Sets `transformed` to the transformed `filter`, transforming it into a
+  // tensor allocated with `ctx` unless it is cached.
+  Status Get(OpKernelContext* ctx, const Tensor& filter, Tensor* transformed);
+
+ private:
+  mutex mu_;
+  Tensor filter_ TF_GUARDED_BY(mu_);
+  Tensor transformed_ TF_GUARDED_BY(mu_);
+};
+
+// Transforms the 6x6 input tile of image `input` ([in_rows, in_cols,
+// in_depth]) whose top left corner is at (`row`, `col`), which may be in the
+// padding. Point `p` of the tile is written to `transformed + p * stride`.
+// `scratch` must hold 72 * in_depth values.
+void WinogradTransformInputTile(const float* input, int64_t in_rows,
+                                int64_t in_cols, int64_t in_depth, int64_t row,
+                                int64_t col, int64_t stride, float* scratch,
+                                float* transformed);
+
+// Transforms the points of a tile (point `p` at `transformed + p * stride`)
+// back into a 4x4 output tile of image `output` ([out_rows, out_cols,
+// out_depth]) whose top left corner is at (`row`, `col`). Values outside of
+// the image are dropped. `scratch` must hold 40 * out_depth values.
+void WinogradTransformOutputTile(const float* transformed, int64_t stride,
+                                 int64_t out_rows, int64_t out_cols,
+                                 int64_t out_depth, int64_t row, int64_t col,
+                                 float* scratch, float* output);
+
+// Computes a 3x3 convolution with stride and dilation 1 of `input` and
+// `filter` into `output`, and applies `output_kernel` to the result. The input
+// is padded by `pad_rows` at the top and by `pad_cols` at the left, and with
+// zeros at the bottom and right as far as the output size requires. The
+// transformed filter is taken from `filter_cache` if it is not null.
+template <typename OutputKernel>
+void WinogradConv2D(OpKernelContext* ctx, const Tensor& input,
+                    const Tensor& filter, int64_t pad_rows, int64_t pad_cols,
+                    const OutputKernel& output_kernel,
+                    WinogradFilterCache* filter_cache, Tensor* output) {
+  using Matrix =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  const int64_t batch = input.dim_size(0);
+  const int64_t in_rows = input.dim_size(1);
+  const int64_t in_cols = input.dim_size(2);
+  const int64_t in_depth = input.dim_size(3);
+  const int64_t out_rows = output->dim_size(1);
+  const int64_t out_cols = output->dim_size(2);
+  const int64_t out_depth = output->dim_size(3);
+
+  Tensor transformed_filter;
+  if (filter_cache != nullptr) {
+    OP_REQUIRES_OK(ctx, filter_cache->Get(ctx, filter, &transformed_filter));
+  } else {
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(
+                            DT_FLOAT,
+                            TensorShape({kWinogradTilePoints, in_depth,
+                                         out_depth}),
+                            &transformed_filter));
+    WinogradTransformFilter(filter.flat<float>().data(), in_depth, out_depth,
+                            transformed_filter.flat<float>().data());
+  }
+  const float* filter_points = transformed_filter.flat<float>().data();
+
+  const int64_t tile_rows = (out_rows + kWinogradOutputTileSize - 1) /
+                            kWinogradOutputTileSize;
+  const int64_t tile_cols = (out_cols + kWinogradOutputTileSize - 1) /
+                            kWinogradOutputTileSize;
+  const int64_t tiles_per_image = tile_rows * tile_cols;
+  const int64_t num_tiles = batch * tiles_per_image;
+
+  // Transform as many tiles at once as keep the transformed input and output
+  // of a block in L2, but not so few that the per point products get small.
+  constexpr int64_t kBlockValues = 1 << 16;
+  const int64_t block_size = std::min(
+      num_tiles,
+      std::max<int64_t>(8, kBlockValues / (kWinogradTilePoints *
+                                           (in_depth + out_depth))));
+  const int64_t num_blocks = (num_tiles + block_size - 1) / block_size;
+
+  const float* input_data = input.flat<float>().data();
+  float* output_data = output->flat<float>().data();
+  const int64_t input_image_size = in_rows * in_cols * in_depth;
+  const int64_t output_image_size = out_rows * out_cols * out_depth;
+
+  const Eigen::TensorContractionParams params{/*swapped_arguments=*/true};
+
+  auto compute_blocks = [&](int64_t start, int64_t limit) {
+    std::vector<float> input_points(kWinogradTilePoints * block_size *
+                                    in_depth);
+    std::vector<float> output_points(kWinogradTilePoints * block_size *
+                                     out_depth);
+    std::vector<float> scratch(
+        std::max(72 * in_depth, 40 * out_depth));
+    const int64_t input_stride = block_size * in_depth;
+    const int64_t output_stride = block_size * out_depth;
+
+    for (int64_t block = start; block < limit; ++block) {
+      const int64_t first_tile = block * block_size;
+      const int64_t block_tiles =
+          std::min(block_size, num_tiles - first_tile);
+
+      for (int64_t t = 0; t < block_tiles; ++t) {
+        const int64_t tile = first_tile + t;
+        const int64_t b = tile / tiles_per_image;
+        const int64_t r = (tile % tiles_per_image) / tile_cols;
+        const int64_t c = tile % tile_cols;
+        WinogradTransformInputTile(
+            input_data + b * input_image_size, in_rows, in_cols, in_depth,
+            r * kWinogradOutputTileSize - pad_rows,
+            c * kWinogradOutputTileSize - pad_cols, input_stride,
+            scratch.data(), input_points.data() + t * in_depth);
+      }
+
+      for (int p = 0; p < kWinogradTilePoints; ++p) {
+        Eigen::Map<const Matrix> lhs(input_points.data() + p * input_stride,
+                                     block_tiles, in_depth);
+        Eigen::Map<const Matrix> rhs(filter_points + p * in_depth * out_depth,
+                                     in_depth, out_depth);
+        Eigen::Map<Matrix> product(output_points.data() + p * output_stride,
+                                   block_tiles, out_depth);
+        product.noalias() = lhs * rhs;
+      }
+
+      for (int64_t t = 0; t < block_tiles; ++t) {
+        const int64_t tile = first_tile + t;
+        const int64_t b = tile / tiles_per_image;
+        const int64_t row = (tile % tiles_per_image) / tile_cols *
+                            kWinogradOutputTileSize;
+        const int64_t col = tile % tile_cols * kWinogradOutputTileSize;
+        float* image = output_data + b * output_image_size;
+        WinogradTransformOutputTile(output_points.data() + t * out_depth,
+                                    output_stride, out_rows, out_cols,
+                                    out_depth, row, col, scratch.data(),
+                                    image);
+
+        const int64_t num_cols =
+            std::min<int64_t>(kWinogradOutputTileSize, out_cols - col);
+        const int64_t row_limit =
+            std::min<int64_t>(row + kWinogradOutputTileSize, out_rows);
+        for (int64_t y = row; y < row_limit; ++y) {
+          ContractionOutputMapper<float, Eigen::Index> output_mapper(
+              image + (y * out_cols + col) * out_depth, out_depth);
+          output_kernel(output_mapper, params, 0, 0, out_depth, num_cols);
+        }
+      }
+    }
+  };
+
+  // Multiply-adds of the per point products, plus the input and output
+  // transforms.
+  const int64_t cost_per_block =
+      block_size * (kWinogradTilePoints * in_depth * out_depth +
+                    200 * in_depth + 150 * out_depth);
+  auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+        cost_per_block, compute_blocks);
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_WINOGRAD_CONV2D_H_
@@ -3095,6 +3095,35 @@ REGISTER_OP("Dequantize")
       return absl::OkStatus();
     });
 
+REGISTER_OP("GatherDequantize")
+    .Input("params: Tparams")
+    .Input("scales: float")
+    .Input("biases: float")
+    .Input("indices: Tindices")
+    .Output("output: dtype")
+    .Attr("Tparams: {int8, uint8, float8_e4m3fn, float8_e5m2}")
+    .Attr("Tindices: {int32, int64}")
+    .Attr("dtype: {half, bfloat16, float} = DT_FLOAT")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle params_shape;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(0), 1, &params_shape));
+      ShapeHandle scales_shape;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &scales_shape));
+      ShapeHandle biases_shape;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &biases_shape));
+      DimensionHandle unused;
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(params_shape, 0), c->Dim(scales_shape, 0), &unused));
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(params_shape, 0), c->Dim(biases_shape, 0), &unused));
+      ShapeHandle row_shape;
+      TF_RETURN_IF_ERROR(c->Subshape(params_shape, 1, &row_shape));
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(c->Concatenate(c->input(3), row_shape, &out));
+      c->set_output(0, out);
+      return absl::OkStatus();
+    });
+
 REGISTER_OP("QuantizedConcat")
     .Input("concat_dim: int32")
     .Input("values: N * T")
@@ -60,6 +60,18 @@ REGISTER_OP("BatchFunction")
     // NOTE: Support for `enable_large_batch_splitting == true` is still
     // developed in progress.
     .Attr("enable_large_batch_splitting: bool = false")
+    // If non-empty, inputs are batched with inputs of the same sequence length
+    // bucket only, and the `sequence_input_indices` inputs are padded along
+    // dimension 1 to the bucket.
+    .Attr("sequence_length_buckets: list(int) = []")
+    .Attr("sequence_input_indices: list(int) = []")
+    .Attr("sequence_output_indices: list(int) = []")
+    .Attr("sequence_mask: bool = false")
+    // If 'max_func_batch_shards' is greater than 1 and large batch splitting is
+    // enabled, a batch is cut into up to that many shards of at least
+    // 'min_func_batch_shard_size' elements, and `f` runs on them concurrently.
+    .Attr("max_func_batch_shards: int = 1")
+    .Attr("min_func_batch_shard_size: int = 32")
     // TODO(apassos): Fix this shape inference function. It requires shape
     // inference of function calls.
     .SetShapeFn(shape_inference::UnknownShape)
@@ -401,6 +401,7 @@ REGISTER_OP("MutableHashTableV2")
     .Attr("use_node_name_sharing: bool = false")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
+    .Attr("num_shards: int >= 1 = 1")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableShapeFn);
 
@@ -408,6 +409,7 @@ REGISTER_OP("AnonymousMutableHashTable")
     .Output("table_handle: resource")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
+    .Attr("num_shards: int >= 1 = 1")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableShapeFn);
 
@@ -430,6 +432,9 @@ REGISTER_OP("MutableHashTableOfTensorsV2")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
     .Attr("value_shape: shape = {}")
+    .Attr("max_size: int >= 0 = 0")
+    .Attr("admission_threshold: int >= 1 = 1")
+    .Attr("eviction_policy: {'lfu', 'lru'} = 'lfu'")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
@@ -438,6 +443,9 @@ REGISTER_OP("AnonymousMutableHashTableOfTensors")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
     .Attr("value_shape: shape = {}")
+    .Attr("max_size: int >= 0 = 0")
+    .Attr("admission_threshold: int >= 1 = 1")
+    .Attr("eviction_policy: {'lfu', 'lru'} = 'lfu'")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
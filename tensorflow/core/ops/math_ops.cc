@@ -1033,6 +1033,44 @@ _FusedConv2D output.
 expected to create these operators.
 )doc");
 
+REGISTER_OP("_FusedElementwise")
+    .Input("inputs: N * T")
+    .Output("output: T")
+    .Attr("T: {float, double}")
+    .Attr("N: int >= 1")
+    .Attr("ops: list(string) >= 1")
+    .Attr("operands: list(int)")
+    .SetShapeFn([](InferenceContext* c) {
+      // Every input is either a scalar or has the shape of the output.
+      ShapeHandle out = c->Scalar();
+      bool all_scalars = true;
+      for (int i = 0; i < c->num_inputs(); ++i) {
+        ShapeHandle input = c->input(i);
+        if (c->RankKnown(input) && c->Rank(input) == 0) continue;
+        if (all_scalars) {
+          out = input;
+          all_scalars = false;
+        } else {
+          TF_RETURN_IF_ERROR(c->Merge(out, input, &out));
+        }
+      }
+      c->set_output(0, out);
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Evaluates an expression of elementwise ops over `inputs`.
+
+`ops` lists the names of the TF ops in the expression (e.g. "Mul", "Relu"), in
+an order where every op comes after the ops it consumes. `operands` holds two
+entries per op: the operands of op `i` are `operands[2 * i]` and, for binary
+ops, `operands[2 * i + 1]`, and are either the index of an input (if less than
+`N`) or `N` plus the index of an earlier op. The output is the result of the
+last op. Every input must be a scalar or have the shape of the output.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
 // --------------------------------------------------------------------------
 
 // For operations where the output is a reduction function along some
@@ -1450,6 +1488,63 @@ REGISTER_OP("SparseSegmentSumWithNumSegments")
     .Attr("sparse_gradient: bool = false")
     .SetShapeFn(SparseSegmentReductionWithNumSegmentsShapeFn);
 
+REGISTER_OP("SparseSegmentWeightedSum")
+    .Input("data: T")
+    .Input("indices: Tidx")
+    .Input("weights: T")
+    .Input("segment_ids: Tsegmentids")
+    .Output("output: T")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("Tidx: {int32, int64} = DT_INT32")
+    .Attr("Tsegmentids: {int32, int64} = DT_INT32")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));
+      TF_RETURN_IF_ERROR(c->Merge(c->input(1), c->input(2), &unused));
+      ShapeHandle data_shape;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(0), 1, &data_shape));
+      ShapeHandle subshape;
+      TF_RETURN_IF_ERROR(c->Subshape(data_shape, 1, &subshape));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 1, &unused));
+      TF_RETURN_IF_ERROR(c->Merge(c->input(1), c->input(3), &unused));
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(c->Concatenate(
+          c->Vector(InferenceContext::kUnknownDim), subshape, &out));
+      c->set_output(0, out);
+      return absl::OkStatus();
+    });
+
+REGISTER_OP("GroupedSparseSegmentReduce")
+    .Input("params: N * T")
+    .Input("indices: N * Tidx")
+    .Input("offsets: N * Tidx")
+    .Output("output: N * T")
+    .Attr("N: int >= 1")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("Tidx: {int32, int64} = DT_INT32")
+    .Attr("combiner: {'sum', 'mean', 'sqrtn'} = 'sum'")
+    .SetShapeFn([](InferenceContext* c) {
+      int64_t num_tables;
+      TF_RETURN_IF_ERROR(c->GetAttr("N", &num_tables));
+      for (int64_t t = 0; t < num_tables; ++t) {
+        ShapeHandle params_shape;
+        TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(t), 1, &params_shape));
+        ShapeHandle unused;
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(num_tables + t), 1, &unused));
+        ShapeHandle offsets_shape;
+        TF_RETURN_IF_ERROR(
+            c->WithRank(c->input(2 * num_tables + t), 1, &offsets_shape));
+        DimensionHandle num_bags;
+        TF_RETURN_IF_ERROR(c->Subtract(c->Dim(offsets_shape, 0), 1, &num_bags));
+        ShapeHandle subshape;
+        TF_RETURN_IF_ERROR(c->Subshape(params_shape, 1, &subshape));
+        ShapeHandle out;
+        TF_RETURN_IF_ERROR(c->Concatenate(c->Vector(num_bags), subshape, &out));
+        c->set_output(t, out);
+      }
+      return absl::OkStatus();
+    });
+
 REGISTER_OP("SparseSegmentSumGrad")
     .Input("grad: T")
     .Input("indices: Tidx")
@@ -1358,6 +1358,145 @@ REGISTER_OP("SparseSoftmaxCrossEntropyWithLogits")
 
 // --------------------------------------------------------------------------
 
+REGISTER_OP("SampledSoftmaxCrossEntropyWithLogits")
+    .Input("true_logits: T")
+    .Input("sampled_logits: T")
+    .Input("true_expected_count: float")
+    .Input("sampled_expected_count: float")
+    .Input("labels: int64")
+    .Input("sampled_candidates: int64")
+    .Output("loss: T")
+    .Output("true_backprop: T")
+    .Output("sampled_backprop: T")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("remove_accidental_hits: bool = true")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle true_logits;
+      ShapeHandle sampled_logits;
+      ShapeHandle sampled_candidates;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 2, &true_logits));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 2, &sampled_logits));
+      TF_RETURN_IF_ERROR(c->Merge(true_logits, c->input(2), &true_logits));
+      TF_RETURN_IF_ERROR(c->Merge(true_logits, c->input(4), &true_logits));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(5), 1, &sampled_candidates));
+      TF_RETURN_IF_ERROR(
+          c->Merge(sampled_candidates, c->input(3), &sampled_candidates));
+
+      DimensionHandle batch_size;
+      TF_RETURN_IF_ERROR(c->Merge(c->Dim(true_logits, 0),
+                                  c->Dim(sampled_logits, 0), &batch_size));
+      DimensionHandle num_sampled;
+      TF_RETURN_IF_ERROR(c->Merge(c->Dim(sampled_logits, 1),
+                                  c->Dim(sampled_candidates, 0),
+                                  &num_sampled));
+      TF_RETURN_IF_ERROR(
+          c->ReplaceDim(true_logits, 0, batch_size, &true_logits));
+
+      c->set_output(0, c->Vector(batch_size));
+      c->set_output(1, true_logits);
+      c->set_output(2, c->Matrix(batch_size, num_sampled));
+      return absl::OkStatus();
+    });
+
+// --------------------------------------------------------------------------
+
+namespace {
+
+// Checks that `query`, `key` and `value` are [batch, heads, length, depth]
+// tensors of one attention computation, and that `key_lengths` has one entry
+// per batch.
+Status ScaledDotProductAttentionInputs(InferenceContext* c,
+                                       ShapeHandle* query, ShapeHandle* key,
+                                       ShapeHandle* value) {
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 4, query));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 4, key));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 4, value));
+  ShapeHandle key_lengths;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 1, &key_lengths));
+
+  // Batch and heads are shared by all inputs, the keys and values have the
+  // same length, and the queries and keys have the same depth.
+  ShapeHandle batch_and_heads;
+  TF_RETURN_IF_ERROR(c->Subshape(*query, 0, 2, &batch_and_heads));
+  ShapeHandle key_batch_and_heads;
+  TF_RETURN_IF_ERROR(c->Subshape(*key, 0, 2, &key_batch_and_heads));
+  TF_RETURN_IF_ERROR(
+      c->Merge(batch_and_heads, key_batch_and_heads, &batch_and_heads));
+  ShapeHandle key_prefix;
+  TF_RETURN_IF_ERROR(c->Subshape(*key, 0, 3, &key_prefix));
+  ShapeHandle value_prefix;
+  TF_RETURN_IF_ERROR(c->Subshape(*value, 0, 3, &value_prefix));
+  TF_RETURN_IF_ERROR(c->Merge(key_prefix, value_prefix, &key_prefix));
+  DimensionHandle unused;
+  TF_RETURN_IF_ERROR(c->Merge(c->Dim(*query, 3), c->Dim(*key, 3), &unused));
+  TF_RETURN_IF_ERROR(
+      c->Merge(c->Dim(batch_and_heads, 0), c->Dim(key_lengths, 0), &unused));
+
+  TF_RETURN_IF_ERROR(c->ReplaceDim(*query, 0, c->Dim(batch_and_heads, 0),
+                                   query));
+  TF_RETURN_IF_ERROR(c->ReplaceDim(*query, 1, c->Dim(batch_and_heads, 1),
+                                   query));
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+REGISTER_OP("ScaledDotProductAttention")
+    .Input("query: T")
+    .Input("key: T")
+    .Input("value: T")
+    .Input("key_lengths: int32")
+    .Output("output: T")
+    .Output("logsumexp: T")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("scale: float")
+    .Attr("causal: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle query, key, value;
+      TF_RETURN_IF_ERROR(
+          ScaledDotProductAttentionInputs(c, &query, &key, &value));
+      ShapeHandle output;
+      TF_RETURN_IF_ERROR(c->ReplaceDim(query, 3, c->Dim(value, 3), &output));
+      ShapeHandle logsumexp;
+      TF_RETURN_IF_ERROR(c->Subshape(query, 0, 3, &logsumexp));
+      c->set_output(0, output);
+      c->set_output(1, logsumexp);
+      return absl::OkStatus();
+    });
+
+REGISTER_OP("ScaledDotProductAttentionGrad")
+    .Input("query: T")
+    .Input("key: T")
+    .Input("value: T")
+    .Input("key_lengths: int32")
+    .Input("output: T")
+    .Input("logsumexp: T")
+    .Input("grad_output: T")
+    .Output("grad_query: T")
+    .Output("grad_key: T")
+    .Output("grad_value: T")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("scale: float")
+    .Attr("causal: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle query, key, value;
+      TF_RETURN_IF_ERROR(
+          ScaledDotProductAttentionInputs(c, &query, &key, &value));
+      ShapeHandle output;
+      TF_RETURN_IF_ERROR(c->ReplaceDim(query, 3, c->Dim(value, 3), &output));
+      TF_RETURN_IF_ERROR(c->Merge(output, c->input(4), &output));
+      TF_RETURN_IF_ERROR(c->Merge(output, c->input(6), &output));
+      ShapeHandle logsumexp;
+      TF_RETURN_IF_ERROR(c->Subshape(query, 0, 3, &logsumexp));
+      TF_RETURN_IF_ERROR(c->Merge(logsumexp, c->input(5), &logsumexp));
+      c->set_output(0, query);
+      c->set_output(1, key);
+      c->set_output(2, value);
+      return absl::OkStatus();
+    });
+
+// --------------------------------------------------------------------------
+
 REGISTER_OP("InTopK")
     .Input("predictions: float")
     .Input("targets: T")
@@ -38,6 +38,21 @@ REGISTER_OP("RaggedRange")
     .Attr("Tsplits: {int32, int64} = DT_INT64")
     .SetShapeFn(RaggedRangeShapeFn);
 
+REGISTER_OP("RaggedSoftmax")
+    .Input("logits: T")
+    .Input("row_splits: Tsplits")
+    .Output("softmax: T")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("Tsplits: {int32, int64} = DT_INT64")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle logits;
+      ShapeHandle row_splits;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &logits));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &row_splits));
+      c->set_output(0, logits);
+      return absl::OkStatus();
+    });
+
 //==============================================================================
 // Shape Functions
 //==============================================================================
@@ -318,6 +318,49 @@ REGISTER_OP("ResourceGatherNd")
     .Attr("Tindices: {int32,int64}")
     .SetShapeFn(shape_inference::GatherNdShape);
 
+REGISTER_OP("ResourceGroupedSparseSegmentReduce")
+    .Input("resources: N * resource")
+    .Input("indices: N * Tidx")
+    .Input("offsets: N * Tidx")
+    .Output("output: N * dtype")
+    .Attr("N: int >= 1")
+    .Attr("dtype: {half, bfloat16, float, double}")
+    .Attr("Tidx: {int32, int64} = DT_INT32")
+    .Attr("combiner: {'sum', 'mean', 'sqrtn'} = 'sum'")
+    .SetShapeFn([](InferenceContext* c) {
+      int64_t num_tables;
+      TF_RETURN_IF_ERROR(c->GetAttr("N", &num_tables));
+      DataType dtype;
+      TF_RETURN_IF_ERROR(c->GetAttr("dtype", &dtype));
+      for (int64_t t = 0; t < num_tables; ++t) {
+        ShapeHandle params_shape = c->UnknownShape();
+        auto* handle_data = c->input_handle_shapes_and_types(t);
+        if (handle_data != nullptr && !handle_data->empty()) {
+          if ((*handle_data)[0].dtype != dtype) {
+            return errors::InvalidArgument(
+                "Trying to read variable ", t, " with wrong dtype. Expected ",
+                DataTypeString((*handle_data)[0].dtype), " got ",
+                DataTypeString(dtype));
+          }
+          params_shape = (*handle_data)[0].shape;
+        }
+        TF_RETURN_IF_ERROR(c->WithRankAtLeast(params_shape, 1, &params_shape));
+        ShapeHandle unused;
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(num_tables + t), 1, &unused));
+        ShapeHandle offsets_shape;
+        TF_RETURN_IF_ERROR(
+            c->WithRank(c->input(2 * num_tables + t), 1, &offsets_shape));
+        DimensionHandle num_bags;
+        TF_RETURN_IF_ERROR(c->Subtract(c->Dim(offsets_shape, 0), 1, &num_bags));
+        ShapeHandle subshape;
+        TF_RETURN_IF_ERROR(c->Subshape(params_shape, 1, &subshape));
+        ShapeHandle out;
+        TF_RETURN_IF_ERROR(c->Concatenate(c->Vector(num_bags), subshape, &out));
+        c->set_output(t, out);
+      }
+      return absl::OkStatus();
+    });
+
 namespace {
 
 Status ResourceScatterUpdateShape(InferenceContext* c) {
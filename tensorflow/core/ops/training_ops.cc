@@ -288,6 +288,7 @@ REGISTER_OP("SparseApplyAdagrad")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("update_slots: bool = true")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(ApplyAdagradShapeFn</*is_sparse=*/true, /*is_resource=*/false>);
 
 REGISTER_OP("ResourceSparseApplyAdagrad")
@@ -300,6 +301,7 @@ REGISTER_OP("ResourceSparseApplyAdagrad")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("update_slots: bool = true")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(ApplyAdagradShapeFn</*is_sparse=*/true, /*is_resource=*/true>);
 
 template <bool is_sparse, bool is_resource>
@@ -355,6 +357,7 @@ REGISTER_OP("SparseApplyAdagradV2")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("update_slots: bool = true")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(
         ApplyAdagradV2ShapeFn</*is_sparse=*/true, /*is_resource=*/false>);
 
@@ -369,6 +372,7 @@ REGISTER_OP("ResourceSparseApplyAdagradV2")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("update_slots: bool = true")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(
         ApplyAdagradV2ShapeFn</*is_sparse=*/true, /*is_resource=*/true>);
 
@@ -577,6 +581,7 @@ REGISTER_OP("SparseApplyFtrl")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("multiply_linear_by_lr: bool = false")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(ApplyFtrlShapeFn</*is_sparse=*/true, /*is_resource=*/false>);
 
 REGISTER_OP("ResourceApplyFtrl")
@@ -607,6 +612,7 @@ REGISTER_OP("ResourceSparseApplyFtrl")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("multiply_linear_by_lr: bool = false")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(ApplyFtrlShapeFn</*is_sparse=*/true, /*is_resource=*/true>);
 
 REGISTER_OP("ApplyFtrlV2")
@@ -641,6 +647,7 @@ REGISTER_OP("SparseApplyFtrlV2")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("multiply_linear_by_lr: bool = false")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(ApplyFtrlShapeFn</*is_sparse=*/true, /*is_resource=*/false>);
 
 REGISTER_OP("ResourceApplyFtrlV2")
@@ -673,6 +680,7 @@ REGISTER_OP("ResourceSparseApplyFtrlV2")
     .Attr("Tindices: {int32, int64}")
     .Attr("use_locking: bool = false")
     .Attr("multiply_linear_by_lr: bool = false")
+    .Attr("deduplicate_indices: bool = false")
     .SetShapeFn(ApplyFtrlShapeFn</*is_sparse=*/true, /*is_resource=*/true>);
 
 template <bool is_sparse, bool is_resource>
@@ -25,11 +25,15 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/device.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/platform/threadpool_interface.h"
+#include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/tfrt/fallback/device_with_custom_allocator.h"
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 #include "tensorflow/core/tfrt/utils/fallback_tensor.h"
 #include "tfrt/host_context/resource_context.h"  // from @tf_runtime
@@ -141,6 +145,41 @@ KernelFallbackCompatRequestState::KernelFallbackCompatRequestState(
           runner_table, resource_array, user_intra_op_threadpool,
           model_metadata, pflr) {}
 
+namespace {
+
+// Allocates host memory that is not shared with other devices through a
+// per-request allocator.
+class RequestAllocatorDevice : public tfrt_stub::DeviceWithCustomAllocator {
+ public:
+  RequestAllocatorDevice(tensorflow::Device* device,
+                         tensorflow::Allocator* allocator)
+      : DeviceWithCustomAllocator(device, allocator), device_(device) {}
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    if (attr.gpu_compatible() || attr.nic_compatible()) {
+      return device_->GetAllocator(attr);
+    }
+    return DeviceWithCustomAllocator::GetAllocator(attr);
+  }
+
+ private:
+  tensorflow::Device* device_ = nullptr;
+};
+
+}  // namespace
+
+void KernelFallbackCompatRequestState::set_request_allocator(
+    core::RefCountPtr<tfrt_stub::RequestArenaAllocator> allocator) {
+  DCHECK(!request_allocator_);
+  request_allocator_ = std::move(allocator);
+  host_cpu_device_ = device_manager_->HostCPU();
+  // `cpu_device_` already is the custom device for the intra op threadpool,
+  // if any.
+  request_allocator_device_ = std::make_unique<RequestAllocatorDevice>(
+      cpu_device_, request_allocator_.get());
+  cpu_device_ = request_allocator_device_.get();
+}
+
 static std::function<void(std::function<void()>)>* GetDefaultRunner() {
   static auto* const default_runner =
       new std::function<void(std::function<void()>)>(
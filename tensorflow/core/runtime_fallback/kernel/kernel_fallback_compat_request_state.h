@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/op_kernel_runner.h"
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 #include "tensorflow/core/tfrt/utils/fallback_tensor.h"
 #include "tfrt/host_context/async_value_ref.h"  // from @tf_runtime
@@ -104,8 +105,11 @@ class KernelFallbackCompatRequestState {
   int64_t step_id() const { return step_id_; }
 
   // Returns the user-specified custom device corresponding to the given device.
-  // It is currently only used for configure per-request intra op threadpool.
+  // It is used to configure per-request intra op threadpool and allocator.
   tensorflow::Device* custom_device(const tensorflow::Device* device) const {
+    if (request_allocator_device_ != nullptr && device == host_cpu_device_) {
+      return request_allocator_device_.get();
+    }
     auto it = custom_device_.find(device);
     if (it == custom_device_.end()) return nullptr;
     return it->second.get();
@@ -181,6 +185,16 @@ class KernelFallbackCompatRequestState {
     return runtime_config_;
   }
 
+  // Makes the kernels on the host CPU device allocate host memory from
+  // `allocator` for the rest of this request.
+  void set_request_allocator(
+      core::RefCountPtr<tfrt_stub::RequestArenaAllocator> allocator);
+
+  // Returns the allocator set by `set_request_allocator`, or nullptr.
+  tfrt_stub::RequestArenaAllocator* request_allocator() const {
+    return request_allocator_.get();
+  }
+
  private:
   int64_t step_id_ = 0;
   // Below are resources needed by current tensorflow.
@@ -223,6 +237,11 @@ class KernelFallbackCompatRequestState {
   tfrt::ResourceContext* client_graph_resource_context_ = nullptr;
 
   const tensorflow::tfrt_stub::RuntimeConfig* runtime_config_ = nullptr;
+
+  // Declared before `request_allocator_device_`, which uses it.
+  core::RefCountPtr<tfrt_stub::RequestArenaAllocator> request_allocator_;
+  const tensorflow::Device* host_cpu_device_ = nullptr;
+  std::unique_ptr<tensorflow::Device> request_allocator_device_;
 };
 
 // Set up fallback context with common tensorflow states such as devices,
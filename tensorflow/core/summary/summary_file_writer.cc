@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/summary/summary_converter.h"
 #include "tensorflow/core/util/events_writer.h"
 
@@ -55,26 +56,47 @@ class SummaryFileWriter : public SummaryWriterInterface {
     string sep = absl::StartsWith(filename_suffix, ".") ? "" : ".";
     const string uniquified_filename_suffix = absl::StrCat(
         ".", pid, ".", file_id_counter.fetch_add(1), sep, filename_suffix);
+    {
+      mutex_lock wl(write_mu_);
+      events_writer_ =
+          std::make_unique<EventsWriter>(io::JoinPath(logdir, "events"));
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(
+          events_writer_->InitWithSuffix(uniquified_filename_suffix),
+          "Could not initialize events writer.");
+    }
     mutex_lock ml(mu_);
-    events_writer_ =
-        std::make_unique<EventsWriter>(io::JoinPath(logdir, "events"));
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(
-        events_writer_->InitWithSuffix(uniquified_filename_suffix),
-        "Could not initialize events writer.");
     last_flush_ = env_->NowMicros();
     is_initialized_ = true;
+    if (flush_millis_ > 0) {
+      flush_thread_.reset(env_->StartThread(ThreadOptions(),
+                                            "summary_file_writer_flush",
+                                            [this]() { FlushLoop(); }));
+    }
     return OkStatus();
   }
 
   Status Flush() override {
-    mutex_lock ml(mu_);
-    if (!is_initialized_) {
-      return errors::FailedPrecondition("Class was not properly initialized.");
+    {
+      mutex_lock ml(mu_);
+      if (!is_initialized_) {
+        return errors::FailedPrecondition(
+            "Class was not properly initialized.");
+      }
     }
-    return InternalFlush();
+    Status s = InternalFlush();
+    mutex_lock ml(mu_);
+    s.Update(background_status_);
+    background_status_ = OkStatus();
+    return s;
   }
 
   ~SummaryFileWriter() override {
+    {
+      mutex_lock ml(mu_);
+      shutdown_ = true;
+      shutdown_cv_.notify_all();
+    }
+    flush_thread_.reset();
     (void)Flush();  // Ignore errors.
   }
 
@@ -151,13 +173,22 @@ class SummaryFileWriter : public SummaryWriterInterface {
   }
 
   Status WriteEvent(std::unique_ptr<Event> event) override {
-    mutex_lock ml(mu_);
-    queue_.emplace_back(std::move(event));
-    if (queue_.size() > max_queue_ ||
-        env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
+    {
+      mutex_lock ml(mu_);
+      queue_.emplace_back(std::move(event));
+      // With a positive flush_millis, the flush thread flushes on time, so
+      // only a full queue makes the caller wait for a flush.
+      const bool flush =
+          queue_.size() > max_queue_ ||
+          (flush_thread_ == nullptr &&
+           env_->NowMicros() - last_flush_ > 1000 * flush_millis_);
+      if (!flush) {
+        Status s = background_status_;
+        background_status_ = OkStatus();
+        return s;
+      }
     }
-    return OkStatus();
+    return Flush();
   }
 
   string DebugString() const override { return "SummaryFileWriter"; }
@@ -167,26 +198,63 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
-  Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    for (const std::unique_ptr<Event>& e : queue_) {
+  // Writes and flushes the queued events. Holding write_mu_ while taking the
+  // queue keeps events in order across concurrent flushes, and lets events be
+  // queued while the file is being written.
+  Status InternalFlush() TF_LOCKS_EXCLUDED(mu_, write_mu_) {
+    mutex_lock wl(write_mu_);
+    std::vector<std::unique_ptr<Event>> events;
+    {
+      mutex_lock ml(mu_);
+      events.swap(queue_);
+    }
+    for (const std::unique_ptr<Event>& e : events) {
       events_writer_->WriteEvent(*e);
     }
-    queue_.clear();
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(events_writer_->Flush(),
-                                    "Could not flush events file.");
-    last_flush_ = env_->NowMicros();
+    Status s = events_writer_->Flush();
+    {
+      mutex_lock ml(mu_);
+      last_flush_ = env_->NowMicros();
+    }
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(s, "Could not flush events file.");
     return OkStatus();
   }
 
+  // Flushes the queued events every flush_millis_ until shutdown_ is set.
+  // Errors are returned by the next Flush() or WriteEvent().
+  void FlushLoop() {
+    while (true) {
+      {
+        mutex_lock ml(mu_);
+        if (!shutdown_) {
+          WaitForMilliseconds(&ml, &shutdown_cv_, flush_millis_);
+        }
+        if (shutdown_) return;
+        if (queue_.empty()) continue;
+      }
+      Status s = InternalFlush();
+      mutex_lock ml(mu_);
+      background_status_.Update(s);
+    }
+  }
+
   bool is_initialized_;
   const int max_queue_;
   const int flush_millis_;
-  uint64 last_flush_;
+  uint64 last_flush_ TF_GUARDED_BY(mu_);
   Env* env_;
   mutex mu_;
   std::vector<std::unique_ptr<Event>> queue_ TF_GUARDED_BY(mu_);
+  // The first error of a background flush that was not returned yet.
+  Status background_status_ TF_GUARDED_BY(mu_);
+  bool shutdown_ TF_GUARDED_BY(mu_) = false;
+  condition_variable shutdown_cv_;
+  // Flushes on time when flush_millis_ is positive.
+  std::unique_ptr<Thread> flush_thread_;
+  // Serializes writes to the file. Acquired before mu_.
+  mutex write_mu_ TF_ACQUIRED_BEFORE(mu_);
   // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(write_mu_);
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       TF_GUARDED_BY(mu_);
 };
@@ -259,6 +259,45 @@ TEST_F(SummaryFileWriterTest, WallTime) {
       [](const Event& e) { EXPECT_EQ(e.wall_time(), 7.023); }));
 }
 
+TEST_F(SummaryFileWriterTest, FlushesOnTimeInBackground) {
+  // Keep unique with all other test names in this file.
+  const string test_name = "flush_in_background_test";
+  SummaryWriterInterface* writer;
+  TF_CHECK_OK(CreateSummaryFileWriter(/*max_queue=*/1000, /*flush_millis=*/1,
+                                      testing::TmpDir(), test_name, &env_,
+                                      &writer));
+  core::ScopedUnref deleter(writer);
+  std::unique_ptr<Event> e{new Event};
+  e->set_step(7);
+  TF_CHECK_OK(writer->WriteEvent(std::move(e)));
+
+  std::vector<string> files;
+  TF_CHECK_OK(env_.GetChildren(testing::TmpDir(), &files));
+  string filename;
+  for (const string& f : files) {
+    if (absl::StrContains(f, test_name)) filename = f;
+  }
+  ASSERT_FALSE(filename.empty());
+
+  // The event is written without a Flush() or another WriteEvent().
+  Event event;
+  for (int attempt = 0; attempt < 10000 && event.step() != 7; ++attempt) {
+    Env::Default()->SleepForMicroseconds(1000);
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env_.NewRandomAccessFile(
+        io::JoinPath(testing::TmpDir(), filename), &read_file));
+    io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+    tstring record;
+    uint64 offset = 0;
+    // The first event is irrelevant.
+    if (reader.ReadRecord(&offset, &record).ok() &&
+        reader.ReadRecord(&offset, &record).ok()) {
+      event.ParseFromString(record);
+    }
+  }
+  EXPECT_EQ(event.step(), 7);
+}
+
 TEST_F(SummaryFileWriterTest, AvoidFilenameCollision) {
   // Keep unique with all other test names in this file.
   string test_name = "avoid_filename_collision_test";
@@ -0,0 +1,164 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tsl/framework/allocator.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+namespace {
+
+// Allocations larger than this fraction of a chunk bypass the arena, which
+// bounds the space wasted at the end of each chunk.
+constexpr size_t kMaxChunkFraction = 8;
+
+size_t RoundUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+RequestArenaAllocator::RequestArenaAllocator(tsl::Allocator* base_allocator,
+                                             size_t chunk_size)
+    : base_allocator_(base_allocator), chunk_size_(chunk_size) {
+  DCHECK(base_allocator_);
+}
+
+RequestArenaAllocator::~RequestArenaAllocator() {
+  mutex_lock l(mu_);
+  for (const Chunk& chunk : chunks_) {
+    if (chunk.data != nullptr) base_allocator_->DeallocateRaw(chunk.data);
+  }
+}
+
+void RequestArenaAllocator::UseChunk(size_t chunk_index) {
+  current_ = chunk_index;
+  next_ = chunks_[chunk_index].data;
+  end_ = next_ + chunk_size_;
+}
+
+void* RequestArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  alignment = std::max(alignment, alignof(Header));
+  const size_t header_size = RoundUp(sizeof(Header), alignment);
+  char* ptr = nullptr;
+  void* base_ptr = nullptr;
+  size_t chunk_index = 0;
+  if (header_size + num_bytes <= chunk_size_ / kMaxChunkFraction) {
+    mutex_lock l(mu_);
+    auto aligned = [&]() {
+      return reinterpret_cast<char*>(
+          RoundUp(reinterpret_cast<uintptr_t>(next_) + sizeof(Header),
+                  alignment));
+    };
+    ptr = aligned();
+    if (next_ == nullptr || ptr + num_bytes > end_) {
+      // The current chunk, if any, has live allocations: it is reused once
+      // they are freed.
+      if (!free_chunks_.empty()) {
+        UseChunk(free_chunks_.back());
+        free_chunks_.pop_back();
+      } else {
+        void* data = base_allocator_->AllocateRaw(
+            tsl::Allocator::kAllocatorAlignment, chunk_size_);
+        if (data == nullptr) return nullptr;
+        chunks_.push_back({static_cast<char*>(data), 0});
+        ++num_chunks_;
+        UseChunk(chunks_.size() - 1);
+      }
+      ptr = aligned();
+    }
+    next_ = ptr + num_bytes;
+    chunk_index = current_;
+    ++chunks_[chunk_index].num_live;
+  } else {
+    base_ptr = base_allocator_->AllocateRaw(alignment, header_size + num_bytes);
+    if (base_ptr == nullptr) return nullptr;
+    ptr = static_cast<char*>(base_ptr) + header_size;
+  }
+  Header* header = reinterpret_cast<Header*>(ptr) - 1;
+  header->base_ptr = base_ptr;
+  header->chunk_index = chunk_index;
+  Ref();
+  return ptr;
+}
+
+void RequestArenaAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) return;
+  const Header* header = static_cast<Header*>(ptr) - 1;
+  if (header->base_ptr != nullptr) {
+    base_allocator_->DeallocateRaw(header->base_ptr);
+  } else {
+    mutex_lock l(mu_);
+    const size_t chunk_index = header->chunk_index;
+    Chunk& chunk = chunks_[chunk_index];
+    if (--chunk.num_live == 0) {
+      if (chunk_index == current_) {
+        // Start over at the beginning of the current chunk.
+        next_ = chunk.data;
+      } else if (request_ended_) {
+        base_allocator_->DeallocateRaw(chunk.data);
+        chunk.data = nullptr;
+      } else {
+        free_chunks_.push_back(chunk_index);
+      }
+    }
+  }
+  // This may delete `this`.
+  Unref();
+}
+
+void RequestArenaAllocator::EndRequest() {
+  mutex_lock l(mu_);
+  request_ended_ = true;
+  for (size_t chunk_index : free_chunks_) {
+    base_allocator_->DeallocateRaw(chunks_[chunk_index].data);
+    chunks_[chunk_index].data = nullptr;
+  }
+  free_chunks_.clear();
+  // Allocations after the request ended, if any, use a new chunk.
+  if (next_ != nullptr && chunks_[current_].num_live == 0) {
+    base_allocator_->DeallocateRaw(chunks_[current_].data);
+    chunks_[current_].data = nullptr;
+  }
+  next_ = nullptr;
+  end_ = nullptr;
+  current_ = chunks_.size();
+}
+
+bool RequestArenaAllocator::InArena(const void* ptr) const {
+  const char* p = static_cast<const char*>(ptr);
+  mutex_lock l(mu_);
+  for (const Chunk& chunk : chunks_) {
+    if (chunk.data != nullptr && p >= chunk.data &&
+        p < chunk.data + chunk_size_) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t RequestArenaAllocator::num_chunks() const {
+  mutex_lock l(mu_);
+  return num_chunks_;
+}
+
+}  // namespace tfrt_stub
+}  // namespace tensorflow
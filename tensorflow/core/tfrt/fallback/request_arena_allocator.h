@@ -0,0 +1,106 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// This file defines an allocator that serves the tensors of one request out
+// of a per-request arena.
+
+#ifndef TENSORFLOW_CORE_TFRT_FALLBACK_REQUEST_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_TFRT_FALLBACK_REQUEST_ARENA_ALLOCATOR_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tsl/framework/allocator.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+
+// Thread-safe.
+// Carves small allocations out of large chunks obtained from
+// `base_allocator`, so that they are not malloc'ed and freed one by one.
+// Allocations that do not fit in a fraction of a chunk are forwarded to
+// `base_allocator`. A chunk is reused once all of its allocations are freed.
+// Every live allocation holds a reference, so tensors that escape the request
+// stay valid after the request drops its own. After EndRequest(), chunks are
+// returned to `base_allocator` as soon as they are empty, so an escaping
+// tensor only keeps its own chunk alive.
+class RequestArenaAllocator : public tsl::Allocator, public core::RefCounted {
+ public:
+  static constexpr size_t kDefaultChunkSize = 1 << 20;
+
+  explicit RequestArenaAllocator(tsl::Allocator* base_allocator,
+                                 size_t chunk_size = kDefaultChunkSize);
+  ~RequestArenaAllocator() override;
+
+  std::string Name() override { return "request_arena"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  tsl::AllocatorMemoryType GetMemoryType() const override {
+    return base_allocator_->GetMemoryType();
+  }
+
+  // Called when the request ends. Frees the empty chunks, and from then on
+  // every chunk once its last allocation is freed.
+  void EndRequest();
+
+  // Returns whether `ptr` points into one of the chunks.
+  bool InArena(const void* ptr) const;
+
+  // Returns the number of chunks allocated so far.
+  size_t num_chunks() const;
+
+ private:
+  struct Chunk {
+    char* data = nullptr;
+    // The number of allocations in the chunk that are not freed yet.
+    int num_live = 0;
+  };
+
+  // Stored right before each allocation.
+  struct Header {
+    // The allocation from `base_allocator_`, or nullptr if the allocation is
+    // in a chunk.
+    void* base_ptr;
+    // The index of the chunk in `chunks_`, if `base_ptr` is nullptr.
+    size_t chunk_index;
+  };
+
+  // Makes `chunk_index` the chunk that allocations are carved out of.
+  void UseChunk(size_t chunk_index) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  tsl::Allocator* const base_allocator_;
+  const size_t chunk_size_;
+
+  mutable tensorflow::mutex mu_;
+  // Freed chunks keep their slot, with `data` set to nullptr.
+  std::vector<Chunk> chunks_ TF_GUARDED_BY(mu_);
+  // Indices of the empty chunks in `chunks_` other than the current one.
+  std::vector<size_t> free_chunks_ TF_GUARDED_BY(mu_);
+  size_t num_chunks_ TF_GUARDED_BY(mu_) = 0;
+  bool request_ended_ TF_GUARDED_BY(mu_) = false;
+  // The current chunk and its free space.
+  size_t current_ TF_GUARDED_BY(mu_) = 0;
+  char* next_ TF_GUARDED_BY(mu_) = nullptr;
+  char* end_ TF_GUARDED_BY(mu_) = nullptr;
+};
+
+}  // namespace tfrt_stub
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_TFRT_FALLBACK_REQUEST_ARENA_ALLOCATOR_H_
@@ -0,0 +1,165 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/core/platform/refcount.h"
+#include "tsl/framework/allocator.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+namespace {
+
+class CountingAllocator : public tsl::AllocatorWrapper {
+ public:
+  CountingAllocator() : tsl::AllocatorWrapper(tsl::cpu_allocator()) {}
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_live_allocations_;
+    return wrapped()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    --num_live_allocations_;
+    wrapped()->DeallocateRaw(ptr);
+  }
+
+  int num_live_allocations() const { return num_live_allocations_; }
+
+ private:
+  int num_live_allocations_ = 0;
+};
+
+TEST(RequestArenaAllocatorTest, SmallAllocationsShareChunks) {
+  CountingAllocator base_allocator;
+  auto* allocator = new RequestArenaAllocator(&base_allocator,
+                                              /*chunk_size=*/1024);
+  void* a = allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/16);
+  void* b = allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/16);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 64, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0);
+  EXPECT_NE(a, b);
+  std::memset(a, 1, 16);
+  std::memset(b, 2, 16);
+  EXPECT_EQ(allocator->num_chunks(), 1);
+  EXPECT_EQ(base_allocator.num_live_allocations(), 1);
+
+  allocator->DeallocateRaw(a);
+  allocator->DeallocateRaw(b);
+  // The chunk is kept until the request drops its reference.
+  EXPECT_EQ(base_allocator.num_live_allocations(), 1);
+  allocator->Unref();
+  EXPECT_EQ(base_allocator.num_live_allocations(), 0);
+}
+
+TEST(RequestArenaAllocatorTest, AllocatesNewChunkWhenFull) {
+  CountingAllocator base_allocator;
+  core::RefCountPtr<RequestArenaAllocator> allocator(
+      new RequestArenaAllocator(&base_allocator, /*chunk_size=*/1024));
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/64));
+  }
+  EXPECT_GT(allocator->num_chunks(), 1);
+  EXPECT_EQ(base_allocator.num_live_allocations(), allocator->num_chunks());
+  for (void* ptr : ptrs) allocator->DeallocateRaw(ptr);
+}
+
+TEST(RequestArenaAllocatorTest, ReusesFreedSpace) {
+  CountingAllocator base_allocator;
+  core::RefCountPtr<RequestArenaAllocator> allocator(
+      new RequestArenaAllocator(&base_allocator, /*chunk_size=*/1024));
+  for (int i = 0; i < 64; ++i) {
+    allocator->DeallocateRaw(
+        allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/64));
+  }
+  EXPECT_EQ(allocator->num_chunks(), 1);
+
+  // Fill two chunks, then free the first one: it is reused instead of
+  // allocating a third chunk.
+  std::vector<void*> first_chunk;
+  void* ptr = allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/64);
+  while (allocator->num_chunks() == 1) {
+    first_chunk.push_back(ptr);
+    ptr = allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/64);
+  }
+  std::vector<void*> second_chunk = {ptr};
+  for (void* p : first_chunk) allocator->DeallocateRaw(p);
+  for (int i = 0; i < 8; ++i) {
+    second_chunk.push_back(
+        allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/64));
+  }
+  EXPECT_EQ(allocator->num_chunks(), 2);
+  EXPECT_TRUE(allocator->InArena(second_chunk.back()));
+  for (void* p : second_chunk) allocator->DeallocateRaw(p);
+}
+
+TEST(RequestArenaAllocatorTest, EscapingAllocationPinsOnlyItsChunk) {
+  CountingAllocator base_allocator;
+  auto* allocator = new RequestArenaAllocator(&base_allocator,
+                                              /*chunk_size=*/1024);
+  void* escaping = allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/64);
+  std::vector<void*> temporaries;
+  while (allocator->num_chunks() < 3) {
+    temporaries.push_back(
+        allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/64));
+  }
+  for (void* ptr : temporaries) allocator->DeallocateRaw(ptr);
+  EXPECT_EQ(base_allocator.num_live_allocations(), 3);
+
+  // The request ends while `escaping` is still in use.
+  allocator->EndRequest();
+  allocator->Unref();
+  EXPECT_EQ(base_allocator.num_live_allocations(), 1);
+  std::memset(escaping, 1, 64);
+  allocator->DeallocateRaw(escaping);
+  EXPECT_EQ(base_allocator.num_live_allocations(), 0);
+}
+
+TEST(RequestArenaAllocatorTest, LargeAllocationsBypassArena) {
+  CountingAllocator base_allocator;
+  core::RefCountPtr<RequestArenaAllocator> allocator(
+      new RequestArenaAllocator(&base_allocator, /*chunk_size=*/1024));
+  void* ptr = allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/4096);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0);
+  std::memset(ptr, 1, 4096);
+  EXPECT_EQ(allocator->num_chunks(), 0);
+  EXPECT_EQ(base_allocator.num_live_allocations(), 1);
+  allocator->DeallocateRaw(ptr);
+  EXPECT_EQ(base_allocator.num_live_allocations(), 0);
+}
+
+TEST(RequestArenaAllocatorTest, AllocationOutlivesRequest) {
+  CountingAllocator base_allocator;
+  auto* allocator = new RequestArenaAllocator(&base_allocator,
+                                              /*chunk_size=*/1024);
+  void* ptr = allocator->AllocateRaw(/*alignment=*/64, /*num_bytes=*/16);
+  // The request ends while `ptr` is still in use.
+  allocator->Unref();
+  std::memset(ptr, 1, 16);
+  EXPECT_EQ(base_allocator.num_live_allocations(), 1);
+  allocator->DeallocateRaw(ptr);
+  EXPECT_EQ(base_allocator.num_live_allocations(), 0);
+}
+
+}  // namespace
+}  // namespace tfrt_stub
+}  // namespace tensorflow
@@ -96,6 +96,12 @@ struct GraphExecutionOptions {
     // Number of times to record costs before resetting Op cost estimates.
     // However, a reset always occurs after the first execution.
     int updates_per_interval = 1;
+
+    // If true, the executable is recompiled with the recorded costs on a
+    // background thread, and requests keep running the current executable
+    // until the recompiled one is swapped in. Otherwise, the recompilation
+    // blocks the request that triggers it.
+    bool recompile_in_background = false;
   };
 
   CostAnalysisOptions cost_analysis_options;
@@ -104,6 +110,13 @@ struct GraphExecutionOptions {
   // This option is experimental.
   bool enable_mlrt = false;
 
+  // If true, the host tensors allocated by the fallback kernels of a request
+  // are carved out of a per-request arena that is freed all at once, instead
+  // of being malloc'ed and freed one by one. Outputs are copied out of the
+  // arena; other tensors that outlive the request keep their chunk alive
+  // until they are released.
+  bool enable_request_arena_allocator = false;
+
   tensorflow::TfrtCompileOptions compile_options;
 };
 
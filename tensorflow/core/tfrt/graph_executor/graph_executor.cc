@@ -60,8 +60,10 @@ limitations under the License.
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/sampler.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
@@ -77,6 +79,7 @@ limitations under the License.
 #include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
 #include "tensorflow/core/tfrt/fallback/op_kernel_runner.h"
+#include "tensorflow/core/tfrt/fallback/request_arena_allocator.h"
 #include "tensorflow/core/tfrt/graph_executor/executable_context.h"
 #include "tensorflow/core/tfrt/graph_executor/export_mlir.h"
 #include "tensorflow/core/tfrt/graph_executor/graph_execution_options.h"
@@ -133,6 +136,26 @@ StepId GetNextStepId() {
   return gen.GetNextStepId();
 }
 
+// Ends the request's use of its arena allocator, if any. Outputs in the arena
+// are copied out of it first, so that they do not keep its chunks alive.
+void EndRequestArena(const RequestInfo& request_info,
+                     std::vector<tensorflow::Tensor>* outputs) {
+  const auto* fallback_request_state =
+      request_info.tfrt_request_context
+          ->GetDataIfExists<tfd::KernelFallbackCompatRequestState>();
+  if (fallback_request_state == nullptr) return;
+  RequestArenaAllocator* allocator =
+      fallback_request_state->request_allocator();
+  if (allocator == nullptr) return;
+  for (tensorflow::Tensor& output : *outputs) {
+    if (output.IsInitialized() && output.TotalBytes() > 0 &&
+        allocator->InArena(output.tensor_data().data())) {
+      output = tensor::DeepCopy(output);
+    }
+  }
+  allocator->EndRequest();
+}
+
 }  // namespace
 
 tensorflow::Status RunMlrtFunction(
@@ -236,7 +259,8 @@ absl::StatusOr<std::unique_ptr<RequestInfo>> CreateRequestInfo(
     request_id = GetNextStepId().id;
     // Otherwise we use the global queue in `runtime`.
     TF_ASSIGN_OR_RETURN(request_info->request_queue_owner,
-                        runtime.CreateRequestQueue(request_id));
+                        runtime.CreateRequestQueue(request_id,
+                                                   run_options.priority));
     request_info->request_queue = request_info->request_queue_owner.get();
   }
   auto* request_queue = request_info->request_queue;
@@ -269,6 +293,11 @@ absl::StatusOr<std::unique_ptr<RequestInfo>> CreateRequestInfo(
   fallback_request_state.set_runtime_config(&options.runtime_config);
   fallback_request_state.set_cancellation_manager(
       &request_info->cancellation_manager);
+  if (options.enable_request_arena_allocator) {
+    fallback_request_state.set_request_allocator(
+        core::RefCountPtr<RequestArenaAllocator>(new RequestArenaAllocator(
+            fallback_state.device_manager().HostCPU()->GetAllocator({}))));
+  }
 
   // Set priority in the builder.
   tfrt::RequestOptions request_options;
@@ -377,10 +406,12 @@ tensorflow::Status GraphExecutionRunOnFunction(
           "Function not found in MLRT executable: ", signature_name));
     }
 
-    return RunMlrtFunction(function, *loaded_executable,
-                           request_info->tfrt_request_context,
-                           *request_info->request_queue, inputs, outputs,
-                           /*sync_resource_state=*/nullptr);
+    Status status = RunMlrtFunction(function, *loaded_executable,
+                                    request_info->tfrt_request_context,
+                                    *request_info->request_queue, inputs,
+                                    outputs, /*sync_resource_state=*/nullptr);
+    EndRequestArena(*request_info, outputs);
+    return status;
   }
 
   DCHECK(func);
@@ -458,6 +489,7 @@ tensorflow::Status GraphExecutionRunOnFunction(
     // point to the same underlying tensor.
     outputs->push_back(host_tensor);
   }
+  EndRequestArena(*request_info, outputs);
 
   // Check if error is due to cancellation.
   // TODO(tfrt-devs): report cancellation reason from runtime.
@@ -485,6 +517,13 @@ GraphExecutor::GraphExecutor(
   SetSessionCreatedMetric();
 }
 
+GraphExecutor::~GraphExecutor() {
+  // Destroy the loaded client graphs first, because they wait for background
+  // cost updates that use this executor.
+  tensorflow::mutex_lock lock(loaded_client_graphs_mu_);
+  loaded_client_graphs_.clear();
+}
+
 absl::StatusOr<std::unique_ptr<GraphExecutor>> GraphExecutor::Create(
     Options options, std::unique_ptr<FallbackState> fallback_state,
     std::unique_ptr<tfrt::ResourceContext> resource_context,
@@ -635,14 +674,20 @@ tensorflow::Status GraphExecutor::Run(
       &req_deadline_tracker_, loaded_client_graph.stream_callback_id(),
       cost_recorder));
 
-  if (do_recompilation) {
-    TF_RETURN_IF_ERROR(
-        loaded_client_graph.UpdateCost(*cost_recorder, runtime()));
-    tensorflow::mutex_lock l(num_recompilations_mu_);
-    num_recompilations_ += 1;
-  }
-  if (cost_recorder != nullptr) {
-    loaded_client_graph.UpdateCostAnalysisData(now, do_recompilation);
+  if (do_recompilation &&
+      options_.cost_analysis_options.recompile_in_background) {
+    // `UpdateCostAnalysisData()` is called once the recompilation is done.
+    loaded_client_graph.ScheduleCostUpdate(*cost_recorder, now);
+  } else {
+    if (do_recompilation) {
+      TF_RETURN_IF_ERROR(
+          loaded_client_graph.UpdateCost(*cost_recorder, runtime()));
+      tensorflow::mutex_lock l(num_recompilations_mu_);
+      num_recompilations_ += 1;
+    }
+    if (cost_recorder != nullptr) {
+      loaded_client_graph.UpdateCostAnalysisData(now, do_recompilation);
+    }
   }
   // Create the outputs from the actual function results, which are sorted
   // according to the output tensor names.
@@ -1140,6 +1185,37 @@ GraphExecutor::LoadedClientGraph::LoadedClientGraph(
   }
 }
 
+GraphExecutor::LoadedClientGraph::~LoadedClientGraph() {
+  tensorflow::mutex_lock lock(cost_analysis_data_.mu);
+  while (cost_analysis_data_.num_background_updates > 0) {
+    cost_analysis_data_.background_update_done.wait(lock);
+  }
+}
+
+void GraphExecutor::LoadedClientGraph::ScheduleCostUpdate(
+    const CostRecorder& cost_recorder, absl::Time now) {
+  {
+    tensorflow::mutex_lock lock(cost_analysis_data_.mu);
+    cost_analysis_data_.num_background_updates += 1;
+  }
+  // `cost_recorder` is not handed out again until `UpdateCostAnalysisData()`
+  // makes it available, so it is safe to read it on another thread.
+  Env::Default()->SchedClosure([this, &cost_recorder, now]() {
+    Status status = UpdateCost(cost_recorder, graph_executor_->runtime());
+    if (status.ok()) {
+      tensorflow::mutex_lock l(graph_executor_->num_recompilations_mu_);
+      graph_executor_->num_recompilations_ += 1;
+    } else {
+      LOG(ERROR) << "Failed to recompile " << name_
+                 << " with updated op costs: " << status;
+    }
+    UpdateCostAnalysisData(now, /*do_recompilation=*/true);
+    tensorflow::mutex_lock lock(cost_analysis_data_.mu);
+    cost_analysis_data_.num_background_updates -= 1;
+    cost_analysis_data_.background_update_done.notify_all();
+  });
+}
+
 void GraphExecutor::LoadedClientGraph::UpdateCostAnalysisData(
     absl::Time now, bool do_recompilation) {
   tensorflow::mutex_lock lock(cost_analysis_data_.mu);
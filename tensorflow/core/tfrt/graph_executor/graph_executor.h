@@ -160,6 +160,8 @@ class GraphExecutor {
                       std::optional<StreamCallbackId> stream_callback_id,
                       bool is_restore, FunctionLibraryDefinition flib_def,
                       tensorflow::monitoring::SamplerCell* latency_sampler);
+    // Waits for the pending background cost update, if any.
+    ~LoadedClientGraph();
 
     // Returns this instance's CostRecorder if it is time to update costs,
     // else returns nullptr. Only allows one non-null return value at a time
@@ -173,6 +175,11 @@ class GraphExecutor {
     // Updates `cost_analysis_data_` to make it accurate for the next execution.
     // Assumes a cost update occurred this cycle.
     void UpdateCostAnalysisData(absl::Time now, bool do_recompilation);
+    // Recompiles with the costs in `cost_recorder` on a background thread and
+    // then updates `cost_analysis_data_` for the next execution. Requests that
+    // arrive meanwhile run the current executable and do not record costs.
+    void ScheduleCostUpdate(const CostRecorder& cost_recorder,
+                            absl::Time now);
     // Getters.
     std::shared_ptr<ExecutableContext> executable_context() const {
       tensorflow::mutex_lock lock(executable_context_mu_);
@@ -221,6 +228,9 @@ class GraphExecutor {
       absl::Time start_time TF_GUARDED_BY(mu) = absl::Now();
       // Cost recordings within the current measurement cycle.
       int num_cost_updates TF_GUARDED_BY(mu) = 0;
+      // Number of recompilations running in the background.
+      int num_background_updates TF_GUARDED_BY(mu) = 0;
+      tensorflow::condition_variable background_update_done;
     };
     CostAnalysisData cost_analysis_data_;
 
@@ -266,6 +276,7 @@ class GraphExecutor {
                 std::unique_ptr<tensorflow::tfrt_stub::TfrtGraphExecutionState>
                     graph_execution_state,
                 std::unique_ptr<mlrt::KernelRegistry> kernel_registry);
+  ~GraphExecutor();
 
   // Runs on the graph according to given input/output.
   tensorflow::Status Run(
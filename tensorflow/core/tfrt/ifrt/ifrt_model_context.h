@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/compiler/tf2xla/xla_helpers.h"
 #include "xla/python/ifrt/array.h"
 #include "xla/python/ifrt/client.h"
+#include "tensorflow/core/tfrt/ifrt/ifrt_config.pb.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_executable_registry.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_loaded_variable_registry.h"
 #include "tsl/concurrency/ref_count.h"
@@ -75,6 +76,22 @@ class IfrtModelContext {
 
   const Eigen::ThreadPoolDevice& GetThreadPoolDevice() const;
 
+  // Sets the batch size buckets of the IFRT programs of this model, keyed by
+  // the name of their entry function. Must be called before the model is
+  // compiled.
+  void SetShapeBucketingConfigs(
+      absl::flat_hash_map<std::string, ShapeBucketingConfigProto> configs) {
+    shape_bucketing_configs_ = std::move(configs);
+  }
+
+  // Returns the batch size buckets of the IFRT program whose entry function is
+  // `program_name`, or nullptr if it has none.
+  const ShapeBucketingConfigProto* GetShapeBucketingConfig(
+      absl::string_view program_name) const {
+    auto it = shape_bucketing_configs_.find(program_name);
+    return it == shape_bucketing_configs_.end() ? nullptr : &it->second;
+  }
+
   const IfrtLoadedVariableRegistry& GetLoadedVariableRegistry() const {
     return loaded_variable_registry_;
   }
@@ -88,6 +105,9 @@ class IfrtModelContext {
   tensorflow::XlaHelpers::ShapeRepresentationFn shape_representation_fn_ =
       tensorflow::IdentityShapeRepresentationFn();
 
+  absl::flat_hash_map<std::string, ShapeBucketingConfigProto>
+      shape_bucketing_configs_;
+
   std::vector<ServingExecutableRegistry::Handle> handles_;
 
   IfrtLoadedVariableRegistry loaded_variable_registry_;
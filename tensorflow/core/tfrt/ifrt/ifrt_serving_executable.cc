@@ -13,8 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+// Enable definition of Eigen::ThreadPoolDevice instead of just declaration.
+#define EIGEN_USE_THREADS
+
 #include "tensorflow/core/tfrt/ifrt/ifrt_serving_executable.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <string>
@@ -27,8 +33,10 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "mlir/IR/OwningOpRef.h"  // from @llvm-project
 #include "tensorflow/compiler/mlir/tfrt/transforms/ifrt/tf2hlo.h"
 #include "tensorflow/compiler/tf2xla/xla_helpers.h"
@@ -49,11 +57,13 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/protobuf/tpu/compile_metadata.pb.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_loaded_variable_registry.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_tensor_utils.h"
 #include "tensorflow/core/tfrt/ifrt/sharding_utils.h"
+#include "tensorflow/core/util/batch_util.h"
 #include "tsl/concurrency/ref_count.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
@@ -141,8 +151,103 @@ absl::StatusOr<std::vector<xla::ifrt::Device*>> GetAssignedDevices(
   return devices;
 }
 
+// Returns the common leading dimension size of the arguments at
+// `batched_arg_indices`.
+absl::StatusOr<int64_t> GetBatchSize(
+    absl::Span<const tensorflow::Tensor> inputs,
+    absl::Span<const int> batched_arg_indices) {
+  int64_t batch_size = -1;
+  for (const int i : batched_arg_indices) {
+    if (i < 0 || i >= inputs.size()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Batched argument index ", i, " is out of range for ", inputs.size(),
+          " inputs"));
+    }
+    if (inputs[i].dims() == 0) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Expected batched argument ", i,
+                       " to have a leading dimension, but got a scalar"));
+    }
+    if (batch_size >= 0 && inputs[i].dim_size(0) != batch_size) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected batched arguments to have the same batch size ",
+          batch_size, ", but argument ", i, " has shape ",
+          inputs[i].shape().DebugString()));
+    }
+    batch_size = inputs[i].dim_size(0);
+  }
+  return batch_size;
+}
+
+// Returns the index of the smallest bucket in `batch_sizes` that fits
+// `batch_size`, or -1 if there is none.
+int FindBucket(absl::Span<const int64_t> batch_sizes, int64_t batch_size) {
+  auto it = std::lower_bound(batch_sizes.begin(), batch_sizes.end(),
+                             batch_size);
+  return it == batch_sizes.end() ? -1 : it - batch_sizes.begin();
+}
+
+// Returns `tensor` padded with zeros along the leading dimension to
+// `batch_size`.
+absl::StatusOr<tensorflow::Tensor> PadBatch(const tensorflow::Tensor& tensor,
+                                             int64_t batch_size) {
+  tensorflow::TensorShape shape = tensor.shape();
+  const int64_t num_slices = shape.dim_size(0);
+  shape.set_dim(0, batch_size);
+  tensorflow::Tensor padded(tensor.dtype(), shape);
+  TF_RETURN_IF_ERROR(tensorflow::batch_util::CopyContiguousSlices(
+      tensor, /*src_offset=*/0, /*dst_offset=*/0, num_slices, &padded));
+  // Non memcpy-able types such as strings are already default-initialized.
+  if (tensorflow::DataTypeCanUseMemcpy(tensor.dtype())) {
+    const size_t offset = tensor.TotalBytes();
+    std::memset(static_cast<char*>(padded.data()) + offset, 0,
+                padded.TotalBytes() - offset);
+  }
+  return padded;
+}
+
 }  // namespace
 
+absl::StatusOr<IfrtServingExecutable::ShapeBucketing>
+IfrtServingExecutable::ShapeBucketing::FromProto(
+    const ShapeBucketingConfigProto& proto) {
+  ShapeBucketing bucketing;
+  bucketing.batch_sizes.assign(proto.batch_sizes().begin(),
+                               proto.batch_sizes().end());
+  bucketing.batched_arg_indices.assign(proto.batched_arg_indices().begin(),
+                                       proto.batched_arg_indices().end());
+  bucketing.precompile_next_bucket = !proto.disable_precompile_next_bucket();
+  for (int i = 0; i < bucketing.batch_sizes.size(); ++i) {
+    if (bucketing.batch_sizes[i] <= 0 ||
+        (i > 0 && bucketing.batch_sizes[i] <= bucketing.batch_sizes[i - 1])) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Expected positive batch sizes in ascending order, but "
+                       "got ",
+                       absl::StrJoin(bucketing.batch_sizes, ", ")));
+    }
+  }
+  for (int i = 0; i < bucketing.batched_arg_indices.size(); ++i) {
+    if (bucketing.batched_arg_indices[i] < 0 ||
+        (i > 0 && bucketing.batched_arg_indices[i] <=
+                      bucketing.batched_arg_indices[i - 1])) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected non-negative batched argument indices in ascending "
+          "order, but got ",
+          absl::StrJoin(bucketing.batched_arg_indices, ", ")));
+    }
+  }
+  return bucketing;
+}
+
+IfrtServingExecutable::~IfrtServingExecutable() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(
+      +[](int* num_pending_compilations) {
+        return *num_pending_compilations == 0;
+      },
+      &num_pending_compilations_));
+}
+
 absl::StatusOr<tsl::RCReference<xla::ifrt::Array>>
 IfrtServingExecutable::ConvertTensorToArray(
     const tensorflow::Tensor& tensor, const xla::ifrt::DeviceList& device_list,
@@ -212,11 +317,7 @@ IfrtServingExecutable::CreateExecutableSynchronously(
 xla::ifrt::Future<absl::StatusOr<IfrtServingExecutable::CachedExecutableBundle>>
 IfrtServingExecutable::LookUpOrCreateExecutable(
     absl::Span<const DtypeAndShape> dtypes_and_shapes) {
-  std::vector<tensorflow::TensorShape> input_shapes;
-  for (const auto& dtype_and_shape : dtypes_and_shapes) {
-    input_shapes.push_back(dtype_and_shape.shape);
-  }
-  Key key = {input_shapes};
+  Key key = MakeKey(dtypes_and_shapes);
 
   xla::ifrt::Promise<absl::StatusOr<CachedExecutableBundle>> promise;
   xla::ifrt::Future<absl::StatusOr<CachedExecutableBundle>> future;
@@ -245,6 +346,37 @@ IfrtServingExecutable::LookUpOrCreateExecutable(
   return future;
 }
 
+void IfrtServingExecutable::CreateExecutableInBackground(
+    std::vector<DtypeAndShape> dtypes_and_shapes) {
+  xla::ifrt::Promise<absl::StatusOr<CachedExecutableBundle>> promise;
+  {
+    absl::MutexLock lock(&mutex_);
+    Key key = MakeKey(dtypes_and_shapes);
+    if (executable_bundles_.contains(key)) return;
+    promise = xla::ifrt::Future<
+        absl::StatusOr<CachedExecutableBundle>>::CreatePromise();
+    executable_bundles_.emplace(
+        std::move(key),
+        xla::ifrt::Future<absl::StatusOr<CachedExecutableBundle>>(promise));
+    ++num_pending_compilations_;
+  }
+  thread_pool_device_.getPool()->Schedule(
+      [this, promise = std::move(promise),
+       dtypes_and_shapes = std::move(dtypes_and_shapes)]() mutable {
+        // Errors are reported to requests that look up the same executable.
+        absl::StatusOr<CachedExecutableBundle> executable_bundle =
+            CreateExecutableSynchronously(
+                absl::MakeConstSpan(dtypes_and_shapes));
+        if (!executable_bundle.ok()) {
+          LOG(WARNING) << "Background compilation failed: "
+                       << executable_bundle.status();
+        }
+        promise.Set(std::move(executable_bundle));
+        absl::MutexLock lock(&mutex_);
+        --num_pending_compilations_;
+      });
+}
+
 absl::StatusOr<std::vector<tensorflow::Tensor>> IfrtServingExecutable::Execute(
     absl::Span<const tensorflow::Tensor> inputs,
     absl::Span<const int> variable_arg_indices) {
@@ -280,6 +412,44 @@ absl::StatusOr<std::vector<tensorflow::Tensor>> IfrtServingExecutable::Execute(
   TF_ASSIGN_OR_RETURN(std::vector<DtypeAndShape> dtypes_and_shapes,
                       BuildDtypeAndShape(inputs, variable_arg_indices,
                                          ifrt_loaded_variable_registry_));
+
+  // Pad the batched arguments up to the smallest bucket that fits them.
+  std::vector<tensorflow::Tensor> padded_inputs;
+  int64_t batch_size = -1;
+  int64_t padded_batch_size = -1;
+  int bucket_index = -1;
+  if (!shape_bucketing_.batch_sizes.empty()) {
+    TF_ASSIGN_OR_RETURN(
+        batch_size,
+        GetBatchSize(inputs, shape_bucketing_.batched_arg_indices));
+    if (batch_size >= 0) {
+      bucket_index = FindBucket(shape_bucketing_.batch_sizes, batch_size);
+    }
+  }
+  if (bucket_index >= 0 &&
+      shape_bucketing_.batch_sizes[bucket_index] > batch_size) {
+    padded_batch_size = shape_bucketing_.batch_sizes[bucket_index];
+    padded_inputs.assign(inputs.begin(), inputs.end());
+    for (const int i : shape_bucketing_.batched_arg_indices) {
+      TF_ASSIGN_OR_RETURN(padded_inputs[i],
+                          PadBatch(inputs[i], padded_batch_size));
+      dtypes_and_shapes[i].shape = padded_inputs[i].shape();
+    }
+    inputs = padded_inputs;
+  }
+
+  if (bucket_index >= 0 && shape_bucketing_.precompile_next_bucket &&
+      bucket_index + 1 < shape_bucketing_.batch_sizes.size()) {
+    // Traffic reaching a bucket usually grows into the next one, so compile
+    // the next bucket before it is needed.
+    std::vector<DtypeAndShape> next_dtypes_and_shapes = dtypes_and_shapes;
+    for (const int i : shape_bucketing_.batched_arg_indices) {
+      next_dtypes_and_shapes[i].shape.set_dim(
+          0, shape_bucketing_.batch_sizes[bucket_index + 1]);
+    }
+    CreateExecutableInBackground(std::move(next_dtypes_and_shapes));
+  }
+
   TF_ASSIGN_OR_RETURN(
       CachedExecutableBundle executable_bundle,
       LookUpOrCreateExecutable(absl::MakeSpan(dtypes_and_shapes)).Await());
@@ -355,6 +525,10 @@ absl::StatusOr<std::vector<tensorflow::Tensor>> IfrtServingExecutable::Execute(
         tensorflow::Tensor tensor,
         MakeTensorFromArray(*ifrt_client_, *array_for_copy, hlo_sharding,
                             device_list, thread_pool_device_));
+    if (padded_batch_size > batch_size && tensor.dims() > 0 &&
+        tensor.dim_size(0) == padded_batch_size) {
+      tensor = tensor.Slice(0, batch_size);
+    }
     outputs.push_back(std::move(tensor));
   }
 
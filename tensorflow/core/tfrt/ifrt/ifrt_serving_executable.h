@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_TFRT_IFRT_IFRT_SERVING_EXECUTABLE_H_
 #define TENSORFLOW_CORE_TFRT_IFRT_IFRT_SERVING_EXECUTABLE_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -43,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/protobuf/tpu/compile_metadata.pb.h"
+#include "tensorflow/core/tfrt/ifrt/ifrt_config.pb.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_loaded_variable_registry.h"
 #include "tsl/concurrency/ref_count.h"
 
@@ -51,6 +53,29 @@ namespace ifrt_serving {
 
 class IfrtServingExecutable {
  public:
+  // Batch size buckets for programs that are batch-parallel along the leading
+  // dimension of some of their arguments.
+  struct ShapeBucketing {
+    // Leading dimension sizes to compile for, in ascending order. A request is
+    // padded up to the smallest bucket that fits it; larger requests are
+    // compiled for their exact shape.
+    std::vector<int64_t> batch_sizes;
+    // Indices of the arguments whose leading dimension is the batch
+    // dimension, in ascending order. All of them must have the same batch
+    // size. Outputs whose leading dimension equals the bucket size are sliced
+    // back to the batch size of the request.
+    std::vector<int> batched_arg_indices;
+    // If true, the first use of a bucket also compiles the next larger bucket
+    // in the background, so that traffic growing past a bucket does not block
+    // on compilation.
+    bool precompile_next_bucket = true;
+
+    // Converts `proto`, and checks that its batch sizes are positive and that
+    // both of its lists are ascending.
+    static absl::StatusOr<ShapeBucketing> FromProto(
+        const ShapeBucketingConfigProto& proto);
+  };
+
   IfrtServingExecutable(
       absl::string_view model_name, absl::string_view signature_name,
       mlir::OwningOpRef<mlir::ModuleOp> module,
@@ -67,6 +92,8 @@ class IfrtServingExecutable {
         shape_representation_fn_(std::move(shape_representation_fn)) {}
 
   // Movable but not copyable.
+  ~IfrtServingExecutable();
+
   IfrtServingExecutable(IfrtServingExecutable&& other) = default;
   IfrtServingExecutable& operator=(IfrtServingExecutable&& other) = default;
   IfrtServingExecutable(const IfrtServingExecutable& other) = delete;
@@ -75,6 +102,12 @@ class IfrtServingExecutable {
   absl::string_view model_name() const { return model_name_; }
   absl::string_view signature_name() const { return signature_name_; }
 
+  // Enables padding the inputs to the buckets in `bucketing`. Must be called
+  // before the first `Execute`.
+  void set_shape_bucketing(ShapeBucketing bucketing) {
+    shape_bucketing_ = std::move(bucketing);
+  }
+
   // Executes the computation.
   // variable_arg_indices are in sorted order.
   absl::StatusOr<std::vector<tensorflow::Tensor>> Execute(
@@ -105,6 +138,15 @@ class IfrtServingExecutable {
     }
   };
 
+  static Key MakeKey(absl::Span<const DtypeAndShape> dtypes_and_shapes) {
+    Key key;
+    key.input_shapes.reserve(dtypes_and_shapes.size());
+    for (const auto& dtype_and_shape : dtypes_and_shapes) {
+      key.input_shapes.push_back(dtype_and_shape.shape);
+    }
+    return key;
+  }
+
   struct CachedExecutableBundle {
     std::shared_ptr<xla::ifrt::LoadedExecutable> ifrt_executable;
     tensorflow::tpu::TPUCompileMetadataProto compile_metadata;
@@ -122,10 +164,14 @@ class IfrtServingExecutable {
   const IfrtLoadedVariableRegistry& ifrt_loaded_variable_registry_;
   tensorflow::XlaHelpers::ShapeRepresentationFn shape_representation_fn_;
 
+  ShapeBucketing shape_bucketing_;
+
   mutable absl::Mutex mutex_;
   absl::flat_hash_map<Key,
                       xla::ifrt::Future<absl::StatusOr<CachedExecutableBundle>>>
       executable_bundles_ ABSL_GUARDED_BY(mutex_);
+  // Number of background compilations that have not finished yet.
+  int num_pending_compilations_ ABSL_GUARDED_BY(mutex_) = 0;
 
   absl::StatusOr<tsl::RCReference<xla::ifrt::Array>> ConvertTensorToArray(
       const tensorflow::Tensor& tensor,
@@ -134,6 +180,12 @@ class IfrtServingExecutable {
 
   xla::ifrt::Future<absl::StatusOr<CachedExecutableBundle>>
   LookUpOrCreateExecutable(absl::Span<const DtypeAndShape> dtypes_and_shapes);
+  // Compiles the executable for `dtypes_and_shapes` on `thread_pool_device_`
+  // unless it is already cached or being compiled. The cache entry is added
+  // before this returns, so concurrent requests wait for this compilation
+  // rather than starting their own.
+  void CreateExecutableInBackground(
+      std::vector<DtypeAndShape> dtypes_and_shapes);
   absl::StatusOr<IfrtServingExecutable::CachedExecutableBundle>
   CreateExecutableSynchronously(
       absl::Span<const DtypeAndShape> dtypes_and_shapes);
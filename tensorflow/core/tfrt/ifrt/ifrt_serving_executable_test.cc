@@ -50,6 +50,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/platform/resource_loader.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/tfrt/ifrt/ifrt_config.pb.h"
 #include "tensorflow/core/tfrt/ifrt/ifrt_loaded_variable_registry.h"
 #include "tensorflow/core/tfrt/ifrt/sharding_utils.h"
 #include "tsl/concurrency/ref_count.h"
@@ -185,6 +186,85 @@ TEST(IfrtServingExecutableTest, MultipleShapes) {
   EXPECT_THAT(outputs2, ElementsAre(TensorEq(expected_out2)));
 }
 
+TEST(IfrtServingExecutableTest, ShapeBucketing) {
+  // Create test input module
+  constexpr absl::string_view kDataDirectory =
+      "tensorflow/core/tfrt/ifrt/testdata";
+  std::string mlir_module_path = tensorflow::GetDataDependencyFilepath(
+      absl::StrCat(kDataDirectory, "/executable.mlir"));
+
+  mlir::DialectRegistry registry;
+  mlir::registerAllDialects(registry);
+  mlir::RegisterAllTensorFlowDialects(registry);
+
+  mlir::MLIRContext context(registry);
+
+  mlir::OwningOpRef<mlir::ModuleOp> mlir_module =
+      mlir::parseSourceFile<mlir::ModuleOp>(mlir_module_path, &context);
+
+  ASSERT_TRUE(mlir_module);
+
+  // Create contexts required for the compiler execution.
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<xla::ifrt::Client> client,
+                          xla::ifrt::test_util::GetClient());
+  Eigen::ThreadPoolDevice thread_pool_device = GetThreadPoolDevice();
+
+  IfrtLoadedVariableRegistry ifrt_loaded_variable_registry;
+
+  IfrtServingExecutable executable("test", "main", std::move(mlir_module),
+                                   client, &thread_pool_device,
+                                   &ifrt_loaded_variable_registry,
+                                   tensorflow::IdentityShapeRepresentationFn());
+  executable.set_shape_bucketing({.batch_sizes = {2, 4},
+                                  .batched_arg_indices = {0},
+                                  .precompile_next_bucket = true});
+
+  auto y = AsTensor<int32_t>({1, 2, 3}, tensorflow::TensorShape({3, 1}));
+
+  // Batch sizes 1 and 2 share the executable of bucket 2.
+  auto x1 = AsTensor<int32_t>({1, 2, 3}, tensorflow::TensorShape({1, 3}));
+  std::vector<tensorflow::Tensor> inputs1{x1, y};
+  TF_ASSERT_OK_AND_ASSIGN(auto outputs1,
+                          executable.Execute(absl::MakeSpan(inputs1), {}));
+  EXPECT_THAT(outputs1, ElementsAre(TensorEq(AsTensor<int32_t>(
+                            {14}, tensorflow::TensorShape({1, 1})))));
+
+  auto x2 = AsTensor<int32_t>({1, 2, 3, 3, 2, 1},
+                              tensorflow::TensorShape({2, 3}));
+  std::vector<tensorflow::Tensor> inputs2{x2, y};
+  TF_ASSERT_OK_AND_ASSIGN(auto outputs2,
+                          executable.Execute(absl::MakeSpan(inputs2), {}));
+  EXPECT_THAT(outputs2, ElementsAre(TensorEq(AsTensor<int32_t>(
+                            {14, 10}, tensorflow::TensorShape({2, 1})))));
+
+  // Batch size 3 uses the executable of bucket 4, which has been compiled in
+  // the background or is compiled now.
+  auto x3 = AsTensor<int32_t>({1, 2, 3, 3, 2, 1, 1, 1, 1},
+                              tensorflow::TensorShape({3, 3}));
+  std::vector<tensorflow::Tensor> inputs3{x3, y};
+  TF_ASSERT_OK_AND_ASSIGN(auto outputs3,
+                          executable.Execute(absl::MakeSpan(inputs3), {}));
+  EXPECT_THAT(outputs3, ElementsAre(TensorEq(AsTensor<int32_t>(
+                            {14, 10, 6}, tensorflow::TensorShape({3, 1})))));
+
+  EXPECT_EQ(executable.num_executables(), 2);
+}
+
+TEST(IfrtServingExecutableTest, ShapeBucketingFromProto) {
+  ShapeBucketingConfigProto proto;
+  proto.add_batch_sizes(2);
+  proto.add_batch_sizes(4);
+  proto.add_batched_arg_indices(0);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto bucketing, IfrtServingExecutable::ShapeBucketing::FromProto(proto));
+  EXPECT_THAT(bucketing.batch_sizes, ElementsAre(2, 4));
+  EXPECT_THAT(bucketing.batched_arg_indices, ElementsAre(0));
+  EXPECT_TRUE(bucketing.precompile_next_bucket);
+
+  proto.add_batch_sizes(3);
+  EXPECT_FALSE(IfrtServingExecutable::ShapeBucketing::FromProto(proto).ok());
+}
+
 TEST(IfrtServingExecutableTest, Spmd) {
   // Create test input module
   constexpr absl::string_view kDataDirectory =
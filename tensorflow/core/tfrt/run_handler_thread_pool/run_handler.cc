@@ -48,6 +48,13 @@ namespace {
 typedef typename internal::RunHandlerEnvironment::Task Task;
 typedef Eigen::RunQueue<Task, 1024> Queue;
 
+auto* task_queueing_time = tensorflow::monitoring::Sampler<1>::New(
+    {"/tfrt/run_handler/task_queueing_time",
+     "Time in microseconds that tasks wait in the queues of a RunHandler, by "
+     "request priority.",
+     "priority"},
+    tensorflow::monitoring::Buckets::Exponential(1, 2, 24));
+
 }  // namespace
 
 namespace internal {
@@ -82,6 +89,7 @@ RunHandlerEnvironment::Task RunHandlerEnvironment::CreateTask(TaskFunction f) {
           std::move(f),
           tensorflow::Context(tensorflow::ContextKind::kThread),
           id,
+          tensorflow::EnvTime::NowMicros(),
       }),
   };
 }
@@ -141,6 +149,7 @@ ThreadWorkSource::ThreadWorkSource()
       non_blocking_inflight_(0),
       pending_tasks_(0),
       traceme_id_(0),
+      queueing_time_cell_(nullptr),
       version_(0),
       sub_thread_pool_waiter_(nullptr) {
   queue_waiters_.next = &queue_waiters_;
@@ -275,6 +284,18 @@ int64_t ThreadWorkSource::GetTracemeId() {
 
 void ThreadWorkSource::SetTracemeId(int64_t value) { traceme_id_ = value; }
 
+void ThreadWorkSource::SetPriority(int64_t priority) {
+  queueing_time_cell_.store(
+      task_queueing_time->GetCell(tensorflow::strings::StrCat(priority)),
+      std::memory_order_relaxed);
+}
+
+void ThreadWorkSource::RecordQueueingTime(const Task& t) {
+  auto* cell = queueing_time_cell_.load(std::memory_order_relaxed);
+  if (cell == nullptr) return;
+  cell->Add(tensorflow::EnvTime::NowMicros() - t.f->enqueue_time_us);
+}
+
 void ThreadWorkSource::SetWaiter(uint64_t version, Waiter* waiter,
                                  tensorflow::mutex* mutex) {
   {
@@ -356,6 +377,7 @@ RunHandlerThreadPool::RunHandlerThreadPool(
       blocking_thread_max_waiting_time_(
           options.blocking_threads_max_sleep_time_micro_sec),
       enable_wake_up_(options.enable_wake_up),
+      strict_priority_(options.strict_priority),
       thread_data_(num_threads_),
       env_(env, thread_options, name),
       name_(name),
@@ -484,7 +506,11 @@ Task RunHandlerThreadPool::FindTask(
     const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources,
     bool* task_from_blocking_queue, ThreadWorkSource** tws) {
   Task t;
-  int current_index = thread_data_[thread_id].current_index;
+  // The work sources are sorted by priority, so starting from the beginning of
+  // the range serves the highest priority requests first.
+  int current_index = strict_priority_
+                          ? searching_range_start
+                          : thread_data_[thread_id].current_index;
   *task_from_blocking_queue = false;
 
   for (int i = 0; i < searching_range_end - searching_range_start; ++i) {
@@ -581,6 +607,7 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
     if (t.f) {
       VLOG(2) << "Running " << (task_from_blocking_queue ? "inter" : "intra")
               << " work from " << tws->GetTracemeId();
+      tws->RecordQueueingTime(t);
       tws->IncrementInflightTaskCount(task_from_blocking_queue);
       env_.ExecuteTask(t);
       tws->DecrementInflightTaskCount(task_from_blocking_queue);
@@ -724,17 +751,9 @@ class RunHandlerPool::Impl {
         waiters_mu_(options.num_sub_thread_pool),
         queue_waiters_(options.num_sub_thread_pool),
         run_handler_thread_pool_(new internal::RunHandlerThreadPool(
-            internal::RunHandlerThreadPool::Options(
-                options.num_inter_op_threads, options.num_intra_op_threads,
-                options.wait_if_no_active_request,
-                options.non_blocking_threads_sleep_time_micro_sec,
-                options.blocking_threads_max_sleep_time_micro_sec,
-                options.use_adaptive_waiting_time, options.enable_wake_up,
-                options.max_concurrent_handler,
-                options.num_threads_in_sub_thread_pool,
-                options.sub_thread_request_percentage),
-            tensorflow::Env::Default(), tensorflow::ThreadOptions(),
-            "tf_run_handler_pool", &waiters_mu_, &queue_waiters_)),
+            ThreadPoolOptions(options), tensorflow::Env::Default(),
+            tensorflow::ThreadOptions(), "tf_run_handler_pool", &waiters_mu_,
+            &queue_waiters_)),
         iterations_(0),
         version_(0),
         wait_if_no_active_request_(options.wait_if_no_active_request),
@@ -772,6 +791,20 @@ class RunHandlerPool::Impl {
     return run_handler_thread_pool_.get();
   }
 
+  static internal::RunHandlerThreadPool::Options ThreadPoolOptions(
+      const Options& options) {
+    internal::RunHandlerThreadPool::Options thread_pool_options(
+        options.num_inter_op_threads, options.num_intra_op_threads,
+        options.wait_if_no_active_request,
+        options.non_blocking_threads_sleep_time_micro_sec,
+        options.blocking_threads_max_sleep_time_micro_sec,
+        options.use_adaptive_waiting_time, options.enable_wake_up,
+        options.max_concurrent_handler, options.num_threads_in_sub_thread_pool,
+        options.sub_thread_request_percentage);
+    thread_pool_options.strict_priority = options.strict_priority;
+    return thread_pool_options;
+  }
+
   bool has_free_handler() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     return !free_handlers_.empty();
   }
@@ -1016,6 +1049,7 @@ void RunHandler::Impl::Reset(int64_t step_id,
   step_id_ = step_id;
   options_ = options;
   tws_.SetTracemeId(step_id);
+  tws_.SetPriority(options.priority);
 }
 
 int RunHandler::Impl::RunHandlerEigenThreadPool::NumThreads() const {
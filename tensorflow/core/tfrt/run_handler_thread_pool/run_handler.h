@@ -27,6 +27,7 @@ limitations under the License.
 
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/histogram/histogram.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -108,6 +109,13 @@ class RunHandlerPool {
 
     // If true, threads will be waken up by new tasks.
     bool enable_wake_up = true;
+
+    // If true, threads always look for tasks from the handlers with the
+    // highest priority first, so that lower priority requests only run when
+    // higher priority ones have no runnable task, and yield to them whenever a
+    // task finishes. Otherwise, threads go through the handlers in a round
+    // robin fashion.
+    bool strict_priority = false;
   };
   explicit RunHandlerPool(Options options);
   ~RunHandlerPool();
@@ -141,7 +149,7 @@ class RunHandlerPool {
 // RunHandler can be used to schedule inter/intra-op closures to run on a global
 // pool shared across all Session::Run(s). The closures are enqueued to a
 // handler specific queue, from which the work is stolen in a priority order
-// (time of the Get() call).
+// (`RunHandlerOptions::priority`, then time of the Get() call).
 //
 // It can only be created via RunHandlerPool::Get().
 //
@@ -182,6 +190,7 @@ class RunHandlerEnvironment {
     TaskFunction f;
     tensorflow::Context context;
     uint64_t trace_id;
+    uint64_t enqueue_time_us;
   };
   tensorflow::Env* const env_;
   const tensorflow::ThreadOptions thread_options_;
@@ -239,6 +248,12 @@ class ThreadWorkSource {
 
   void SetTracemeId(int64_t value);
 
+  // Sets the priority of the request, which labels the queueing time metric.
+  void SetPriority(int64_t priority);
+
+  // Records the time `t` spent in the queues.
+  void RecordQueueingTime(const Task& t);
+
   void SetWaiter(uint64_t version, Waiter* waiter, tensorflow::mutex* mutex);
 
   int64_t GetInflightTaskCount(bool is_blocking);
@@ -280,6 +295,7 @@ class ThreadWorkSource {
   tensorflow::mutex waiters_mu_;
   Waiter queue_waiters_ TF_GUARDED_BY(waiters_mu_);
   std::atomic<int64_t> traceme_id_;
+  std::atomic<tensorflow::monitoring::SamplerCell*> queueing_time_cell_;
 
   tensorflow::mutex run_handler_waiter_mu_;
   uint64_t version_ TF_GUARDED_BY(run_handler_waiter_mu_);
@@ -301,6 +317,7 @@ class RunHandlerThreadPool {
     int max_concurrent_handler;
     std::vector<int> num_threads_in_sub_thread_pool;
     std::vector<double> sub_thread_request_percentage;
+    bool strict_priority = false;
     Options(int num_blocking_threads, int num_non_blocking_threads,
             bool wait_if_no_active_request,
             int non_blocking_threads_sleep_time_micro_sec,
@@ -399,6 +416,7 @@ class RunHandlerThreadPool {
   const int non_blocking_thread_sleep_time_;
   const int blocking_thread_max_waiting_time_;
   const bool enable_wake_up_;
+  const bool strict_priority_;
   Eigen::MaxSizeVector<ThreadData> thread_data_;
   internal::RunHandlerEnvironment env_;
   std::atomic<bool> cancelled_;
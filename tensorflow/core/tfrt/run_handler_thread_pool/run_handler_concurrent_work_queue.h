@@ -79,6 +79,10 @@ class RunHandlerThreadWorkQueue
 
     // If true, threads will be waken up by new tasks.
     bool enable_wake_up = true;
+
+    // If true, the tasks of higher priority requests always run first. See
+    // `RunHandlerPool::Options::strict_priority`.
+    bool strict_priority = false;
   };
 
   explicit RunHandlerThreadWorkQueue(const Options& options);
@@ -94,6 +98,9 @@ class RunHandlerThreadWorkQueue
   tensorflow::StatusOr<
       std::unique_ptr<tensorflow::tfrt_stub::WorkQueueInterface>>
   InitializeRequest(int64_t request_id) const override;
+  tensorflow::StatusOr<
+      std::unique_ptr<tensorflow::tfrt_stub::WorkQueueInterface>>
+  InitializeRequest(int64_t request_id, int priority) const override;
 
   int GetParallelismLevel() const override {
     return options_.num_main_threads + options_.num_complementary_threads;
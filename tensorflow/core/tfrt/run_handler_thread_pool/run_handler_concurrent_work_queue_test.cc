@@ -16,10 +16,13 @@ limitations under the License.
 
 #include <cstdio>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -173,6 +176,38 @@ TEST_F(RunHandlerThreadWorkQueueTest, IsWorkerThreadOk) {
   EXPECT_TRUE(queue_->IsInWorkerThread());
 }
 
+TEST(RunHandlerThreadWorkQueuePriorityTest, RunsHigherPriorityRequestFirst) {
+  RunHandlerThreadWorkQueue::Options options;
+  options.num_complementary_threads = 0;
+  options.num_main_threads = 1;
+  options.init_timeout_ms = 100;
+  options.strict_priority = true;
+  auto pool = std::make_unique<RunHandlerThreadWorkQueue>(options);
+  auto low_queue = pool->InitializeRequest(/*request_id=*/1, /*priority=*/1);
+  ASSERT_TRUE(low_queue.ok()) << low_queue.status();
+  auto high_queue = pool->InitializeRequest(/*request_id=*/2, /*priority=*/2);
+  ASSERT_TRUE(high_queue.ok()) << high_queue.status();
+
+  // The only thread is busy with `blocker` until both requests have queued
+  // their task, so it then picks the task of the higher priority request.
+  absl::Notification release;
+  tensorflow::mutex m;
+  std::vector<std::string> order;
+  (*low_queue)->AddTask(
+      TaskFunction([&release] { release.WaitForNotification(); }));
+  (*low_queue)->AddTask(TaskFunction([&m, &order] {
+    tensorflow::mutex_lock lock(m);
+    order.push_back("low");
+  }));
+  (*high_queue)->AddTask(TaskFunction([&m, &order] {
+    tensorflow::mutex_lock lock(m);
+    order.push_back("high");
+  }));
+  release.Notify();
+  pool->Quiesce();
+  EXPECT_EQ(order, std::vector<std::string>({"high", "low"}));
+}
+
 TEST_F(RunHandlerThreadWorkQueueTest, NoHandlerReturnsError) {
   RunHandlerThreadWorkQueue::Options options;
   options.num_complementary_threads = 0;
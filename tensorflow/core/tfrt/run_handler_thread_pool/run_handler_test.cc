@@ -479,6 +479,60 @@ TEST_P(RunHandlerThreadPoolTest, FindTask) {
   }
 }
 
+TEST_P(RunHandlerThreadPoolTest, FindTaskWithStrictPriority) {
+  Eigen::MaxSizeVector<tensorflow::mutex> waiters_mu(2);
+  waiters_mu.resize(2);
+  Eigen::MaxSizeVector<internal::Waiter> waiters(2);
+  waiters.resize(2);
+  internal::RunHandlerThreadPool::Options options(
+      /*num_blocking_threads=*/1, /*num_non_blocking_threads=*/0,
+      /*wait_if_no_active_request=*/true,
+      /*non_blocking_threads_sleep_time_micro_sec=*/250,
+      /*blocking_threads_max_sleep_time_micro_sec=*/250,
+      /*use_adaptive_waiting_time=*/true, /*enable_wake_up=*/true,
+      /*max_concurrent_handler=*/128,
+      /*num_threads_in_sub_thread_pool=*/{1},
+      /*sub_thread_request_percentage=*/{1});
+  options.strict_priority = true;
+  internal::RunHandlerThreadPool run_handler_thread_pool(
+      options, tensorflow::Env::Default(), tensorflow::ThreadOptions(),
+      "tf_run_handler_pool", &waiters_mu, &waiters);
+
+  Eigen::MaxSizeVector<internal::ThreadWorkSource*> thread_work_sources(5);
+  thread_work_sources.resize(5);
+  for (int i = 0; i < 5; ++i) {
+    thread_work_sources[i] = new internal::ThreadWorkSource();
+    thread_work_sources[i]->SetWaiter(1, &waiters[0], &waiters_mu[0]);
+  }
+
+  // The thread drains the first (i.e. highest priority) work source before
+  // moving on to the next one.
+  int result = -1;
+  for (int i : {2, 2, 3, 3}) {
+    run_handler_thread_pool.AddWorkToQueue(
+        thread_work_sources[i],
+        /*is_blocking=*/true, TaskFunction([&result, i] { result = i; }));
+  }
+  for (int expected : {2, 2, 3, 3}) {
+    bool task_from_blocking_queue;
+    internal::ThreadWorkSource* tws;
+    internal::Task t = run_handler_thread_pool.FindTask(
+        /*searching_range_start=*/0, /*searching_range_end=*/5,
+        /*thread_id=*/0,
+        /*sub_thread_pool_id=*/0, /*max_blocking_inflight=*/10,
+        /*may_steal_blocking_work=*/true, thread_work_sources,
+        &task_from_blocking_queue, &tws);
+    ASSERT_NE(t.f, nullptr);
+    EXPECT_EQ(tws, thread_work_sources[expected]);
+    t.f->f();
+    EXPECT_EQ(result, expected);
+  }
+
+  for (int i = 0; i < 5; ++i) {
+    delete thread_work_sources[i];
+  }
+}
+
 TEST_P(RunHandlerThreadPoolTest, RoundRobinExecution) {
   Eigen::MaxSizeVector<tensorflow::mutex> waiters_mu(1);
   waiters_mu.resize(1);
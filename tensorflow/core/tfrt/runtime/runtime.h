@@ -194,17 +194,30 @@ class Runtime {
   void SetCreateRequestQueueFn(
       std::function<StatusOr<std::unique_ptr<WorkQueueInterface>>(int64_t)>
           create_request_queue_fn) {
+    create_request_queue_fn_ =
+        [create_request_queue_fn = std::move(create_request_queue_fn)](
+            int64_t request_id, int priority) {
+          return create_request_queue_fn(request_id);
+        };
+  }
+
+  // Same as above, and `create_request_queue_fn` also takes the priority of
+  // the request.
+  void SetCreateRequestQueueFn(
+      std::function<StatusOr<std::unique_ptr<WorkQueueInterface>>(int64_t, int)>
+          create_request_queue_fn) {
     create_request_queue_fn_ = std::move(create_request_queue_fn);
   }
 
-  // Creates a work queue for a request.
+  // Creates a work queue for a request. Larger `priority` means higher
+  // priority, if the work queue supports it.
   StatusOr<std::unique_ptr<WorkQueueInterface>> CreateRequestQueue(
-      int64_t request_id) const {
+      int64_t request_id, int priority = 0) const {
     if (create_request_queue_fn_) {
-      return create_request_queue_fn_(request_id);
+      return create_request_queue_fn_(request_id, priority);
     }
 
-    return work_queue_->InitializeRequest(request_id);
+    return work_queue_->InitializeRequest(request_id, priority);
   }
 
  private:
@@ -212,7 +225,7 @@ class Runtime {
                    WorkQueueInterface* work_queue);
 
   std::unique_ptr<tfrt::CoreRuntime> core_runtime_;
-  std::function<StatusOr<std::unique_ptr<WorkQueueInterface>>(int64_t)>
+  std::function<StatusOr<std::unique_ptr<WorkQueueInterface>>(int64_t, int)>
       create_request_queue_fn_;
   WorkQueueInterface* work_queue_ = nullptr;
   std::vector<std::function<absl::Status(ModelRuntimeContext&)>>
@@ -14,7 +14,13 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/tfrt/runtime/runtime.h"
 
+#include <cstdint>
+#include <memory>
+
 #include <gtest/gtest.h>
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/tfrt/runtime/work_queue_interface.h"
+#include "tfrt/host_context/concurrent_work_queue.h"  // from @tf_runtime
 
 namespace tensorflow {
 namespace tfrt_stub {
@@ -30,6 +36,23 @@ TEST(RuntimeTest, GlobalRuntimeWorks) {
   EXPECT_EQ(GetGlobalRuntime(), GetGlobalRuntime());
 }
 
+TEST(RuntimeTest, CreateRequestQueuePassesPriority) {
+  auto runtime = Runtime::Create(/*num_inter_op_threads=*/1);
+  int64_t queue_request_id = -1;
+  int queue_priority = -1;
+  runtime->SetCreateRequestQueueFn(
+      [&](int64_t request_id, int priority)
+          -> StatusOr<std::unique_ptr<WorkQueueInterface>> {
+        queue_request_id = request_id;
+        queue_priority = priority;
+        return WrapDefaultWorkQueue(tfrt::CreateSingleThreadedWorkQueue());
+      });
+  TF_ASSERT_OK(runtime->CreateRequestQueue(/*request_id=*/3, /*priority=*/5)
+                   .status());
+  EXPECT_EQ(queue_request_id, 3);
+  EXPECT_EQ(queue_priority, 5);
+}
+
 }  // namespace
 }  // namespace tfrt_stub
 }  // namespace tensorflow
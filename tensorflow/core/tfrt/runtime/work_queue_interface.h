@@ -61,6 +61,14 @@ class WorkQueueInterface : public tfrt::ConcurrentWorkQueue {
     return {nullptr};
   }
 
+  // Same as above, and the work queue may use `priority` to order the work of
+  // concurrent requests. Larger number means higher priority.
+  ABSL_DEPRECATED("Create the instance directly instead.")
+  virtual StatusOr<std::unique_ptr<WorkQueueInterface>> InitializeRequest(
+      int64_t request_id, int priority) const {
+    return InitializeRequest(request_id);
+  }
+
  private:
   int64_t id_ = 0;
   thread::ThreadPoolInterface* intra_op_threadpool_ = nullptr;
@@ -346,14 +346,25 @@ tensorflow::Status PreprocessSignature(
   return OkStatus();
 }
 
-bool AotPackageExists(absl::string_view saved_model_dir) {
+bool AotPackageExists(absl::string_view saved_model_dir, bool enable_mlrt) {
   Env* env = Env::Default();
   const std::string aot_package_path = GetAotPackagePath(saved_model_dir);
   const std::string aot_mlir_path = GetMlirFilePath(aot_package_path);
-  const std::string aot_bef_path = GetBefFilePath(aot_package_path);
-  return env->FileExists(aot_package_path).ok() &&
-         env->FileExists(aot_mlir_path).ok() &&
-         env->FileExists(aot_bef_path).ok();
+  const std::string aot_executable_path =
+      enable_mlrt ? GetMlrtByteCodeFilePath(aot_package_path)
+                  : GetBefFilePath(aot_package_path);
+  if (!env->FileExists(aot_package_path).ok() ||
+      !env->FileExists(aot_mlir_path).ok() ||
+      !env->FileExists(aot_executable_path).ok()) {
+    return false;
+  }
+  if (enable_mlrt && !IsAotMlrtBytecodeUpToDate(saved_model_dir)) {
+    LOG(WARNING) << "Ignoring the AOT package in " << aot_package_path
+                 << " as it can't be verified to be compiled from this "
+                    "SavedModel.";
+    return false;
+  }
+  return true;
 }
 
 }  // namespace
@@ -458,7 +469,8 @@ SavedModelImpl::LoadSavedModel(Options options,
   UpdateTpuTargetByBridgeCompatibility(options.graph_execution_options,
                                        meta_graph_def.graph_def());
   UpdateCompileOptions(options);
-  const bool aot_exist = AotPackageExists(saved_model_dir);
+  const bool aot_exist = AotPackageExists(
+      saved_model_dir, options.graph_execution_options.enable_mlrt);
   options.enable_lazy_loading = options.enable_lazy_loading && !aot_exist;
 
   if (aot_exist || options.aot_generation) {
@@ -581,11 +593,18 @@ SavedModelImpl::LoadSavedModel(Options options,
   mlrt::bc::Buffer bytecode;
   tfrt::BefBuffer bef;
   if (aot_exist) {
-    LOG(INFO) << "Found AOT package. Load and deserialize BEF.";
     if (options.graph_execution_options.enable_mlrt) {
-      // TODO(b/303504882): Add deserialization for mlrt path
-      return absl::InternalError("AOT is not supported in MLRT");
+      LOG(INFO) << "Found AOT package. Load and deserialize MLRT bytecode.";
+      tensorflow::tf_mlrt::RegisterTfMlrtKernels(*kernel_registry);
+      tensorflow::tf_mlrt::RegisterTfMlrtBatchKernels(*kernel_registry);
+      ASSIGN_OR_RETURN_IN_COMPILE(
+          bytecode,
+          LoadMlrtAndMlir(options.graph_execution_options.compile_options,
+                          mlir_module.get(), saved_model_dir_string,
+                          fallback_state.get()));
+      metrics::UpdateAotMlrtMlirLoadCount();
     } else {
+      LOG(INFO) << "Found AOT package. Load and deserialize BEF.";
       ASSIGN_OR_RETURN_IN_COMPILE(
           bef, LoadBefAndMlir(options.graph_execution_options.compile_options,
                               mlir_module.get(), saved_model_dir_string,
@@ -602,6 +621,16 @@ SavedModelImpl::LoadSavedModel(Options options,
           bytecode, tensorflow::mlrt_compiler::ConvertTfMlirToBytecode(
                         options.graph_execution_options.compile_options,
                         *fallback_state, mlir_module.get(), model_context));
+      const auto& compile_options =
+          options.graph_execution_options.compile_options;
+      if (compile_options.serialize_mlrt_bytecode_to_aot_packages) {
+        TF_RETURN_IF_ERROR(SerializeMLRTBytecode(
+            bytecode, compile_options.aot_mlrt_bytecode_file));
+        TF_RETURN_IF_ERROR(SerializeMlrtFingerprint(
+            saved_model_dir,
+            io::JoinPath(io::Dirname(compile_options.aot_mlrt_bytecode_file),
+                         kMlrtFingerprintFileName)));
+      }
     } else {
       RETURN_IF_ERROR_IN_COMPILE(tensorflow::ConvertTfMlirToBef(
           options.graph_execution_options.compile_options, mlir_module.get(),
@@ -28,6 +28,7 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -39,6 +40,7 @@ limitations under the License.
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
 #include "mlir/IR/OwningOpRef.h"  // from @llvm-project
+#include "tensorflow/cc/saved_model/fingerprinting.h"
 #include "tensorflow/cc/saved_model/reader.h"
 #include "tensorflow/compiler/mlir/tensorflow/ir/tf_saved_model.h"
 #include "tensorflow/compiler/mlir/tensorflow/translate/import_model.h"
@@ -57,6 +59,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
+#include "tensorflow/core/tfrt/mlrt/bytecode/bytecode.h"
 #include "tensorflow/core/tfrt/saved_model/saved_model_import_input.h"
 #include "tensorflow/core/tfrt/saved_model/utils/serialize_utils.h"
 #include "tsl/platform/env.h"
@@ -326,6 +329,73 @@ absl::StatusOr<tfrt::BefBuffer> LoadBefAndMlir(
   return bef;
 }
 
+std::string GetMlrtByteCodeFilePath(const std::string& aot_package_directory) {
+  return tsl::io::JoinPath(aot_package_directory, kMlrtBufferFileName);
+}
+
+std::string GetMlrtFingerprintFilePath(
+    const std::string& aot_package_directory) {
+  return tsl::io::JoinPath(aot_package_directory, kMlrtFingerprintFileName);
+}
+
+absl::StatusOr<mlrt::bc::Buffer> LoadMlrtAndMlir(
+    const TfrtCompileOptions& options, mlir::ModuleOp mlir_module,
+    const std::string& saved_model_dir,
+    tfrt_stub::FallbackState* fallback_state) {
+  const std::string aot_package_directory = GetAotPackagePath(saved_model_dir);
+  const std::string mlrt_file_path =
+      GetMlrtByteCodeFilePath(aot_package_directory);
+  TF_ASSIGN_OR_RETURN(mlrt::bc::Buffer bytecode,
+                      DeserializeMLRTBytecodeBuffer(mlrt_file_path));
+
+  if (bytecode.empty()) {
+    return absl::InternalError("MLRT bytecode is empty.");
+  }
+
+  if (options.device_target == TfrtDeviceInfraTarget::kGpu) {
+    TF_RETURN_IF_ERROR(AddXlaFunctions(fallback_state, mlir_module));
+  }
+
+  return bytecode;
+}
+
+absl::Status SerializeMlrtFingerprint(absl::string_view saved_model_dir,
+                                      const std::string& filepath) {
+  absl::StatusOr<std::string> fingerprint =
+      saved_model::fingerprinting::Singleprint(saved_model_dir);
+  if (!fingerprint.ok()) {
+    LOG(WARNING) << "Not recording the fingerprint of the MLRT bytecode: "
+                 << fingerprint.status();
+    return absl::OkStatus();
+  }
+  return tsl::WriteStringToFile(tsl::Env::Default(), filepath, *fingerprint);
+}
+
+bool IsAotMlrtBytecodeUpToDate(absl::string_view saved_model_dir) {
+  const std::string fingerprint_file_path =
+      GetMlrtFingerprintFilePath(GetAotPackagePath(saved_model_dir));
+  if (!tsl::Env::Default()->FileExists(fingerprint_file_path).ok()) {
+    LOG(WARNING) << "The MLRT bytecode has no recorded fingerprint.";
+    return false;
+  }
+  std::string recorded_fingerprint;
+  absl::Status status = tsl::ReadFileToString(
+      tsl::Env::Default(), fingerprint_file_path, &recorded_fingerprint);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to read the fingerprint of the MLRT bytecode: "
+                 << status;
+    return false;
+  }
+  absl::StatusOr<std::string> fingerprint =
+      saved_model::fingerprinting::Singleprint(saved_model_dir);
+  if (!fingerprint.ok()) {
+    LOG(WARNING) << "Failed to read the fingerprint of the SavedModel: "
+                 << fingerprint.status();
+    return false;
+  }
+  return *fingerprint == recorded_fingerprint;
+}
+
 absl::Status DeserializeAotMlirModule(
     absl::string_view saved_model_dir, mlir::MLIRContext* context,
     mlir::OwningOpRef<mlir::ModuleOp>* mlir_module) {
@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
 #include "tensorflow/core/tfrt/graph_executor/graph_execution_options.h"
 #include "tensorflow/core/tfrt/graph_executor/graph_executor.h"
+#include "tensorflow/core/tfrt/mlrt/bytecode/bytecode.h"
 #include "tensorflow/core/tfrt/runtime/runtime.h"
 #include "tsl/platform/protobuf.h"
 #include "tfrt/host_context/function.h"  // from @tf_runtime
@@ -52,6 +53,11 @@ inline constexpr char kBefBufferFileName[] = "serialized_bef.mlir.bef";
 // Filename for serialized MLRT bytecode Buffer.
 inline constexpr char kMlrtBufferFileName[] = "serialized_mlrt.mlir.mlrt";
 
+// Filename for the fingerprint of the SavedModel that the serialized MLRT
+// bytecode Buffer was compiled from.
+inline constexpr char kMlrtFingerprintFileName[] =
+    "serialized_mlrt.fingerprint";
+
 // Filename for serialized MLIR_MODULE.
 inline constexpr char kMlirModuleFilename[] = "serialized_mlir.mlir";
 
@@ -127,6 +133,11 @@ std::string GetBefFilePath(std::string aot_package_directory);
 
 std::string GetMlirFilePath(const std::string& aot_package_directory);
 
+std::string GetMlrtByteCodeFilePath(const std::string& aot_package_directory);
+
+std::string GetMlrtFingerprintFilePath(
+    const std::string& aot_package_directory);
+
 // TODO(b/295241000): Implement MLIR deserialization to skip it AoT and remove
 // redundant steps
 absl::StatusOr<tfrt::BefBuffer> LoadBefAndMlir(
@@ -134,6 +145,23 @@ absl::StatusOr<tfrt::BefBuffer> LoadBefAndMlir(
     const std::string& saved_model_dir,
     tfrt_stub::FallbackState* fallback_state);
 
+absl::StatusOr<mlrt::bc::Buffer> LoadMlrtAndMlir(
+    const TfrtCompileOptions& options, mlir::ModuleOp mlir_module,
+    const std::string& saved_model_dir,
+    tfrt_stub::FallbackState* fallback_state);
+
+// Writes the fingerprint of the SavedModel in `saved_model_dir` to `filepath`,
+// so that `IsAotMlrtBytecodeUpToDate` can detect stale bytecode. Does nothing
+// if the SavedModel has no fingerprint, in which case the bytecode is never
+// loaded.
+absl::Status SerializeMlrtFingerprint(absl::string_view saved_model_dir,
+                                      const std::string& filepath);
+
+// Returns whether the MLRT bytecode in the AOT package of `saved_model_dir` was
+// compiled from this SavedModel, i.e. whether the fingerprints match. Bytecode
+// without a recorded fingerprint is assumed to be stale.
+bool IsAotMlrtBytecodeUpToDate(absl::string_view saved_model_dir);
+
 absl::Status DeserializeAotMlirModule(
     absl::string_view saved_model_dir, mlir::MLIRContext* context,
     mlir::OwningOpRef<mlir::ModuleOp>* mlir_module);
@@ -15,16 +15,19 @@ limitations under the License.
 
 #include "tensorflow/core/tfrt/saved_model/utils/serialize_utils.h"
 
+#include <cstring>
 #include <memory>
 #include <string>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "mlir/Support/FileUtilities.h"  // from @llvm-project
 #include "tensorflow/compiler/mlir/tensorflow/utils/dump_mlir_util.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/tfrt/mlrt/bytecode/bytecode.h"
 #include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
 #include "tfrt/bef/bef_buffer.h"  // from @tf_runtime
 
 namespace tensorflow {
@@ -62,5 +65,21 @@ absl::Status SerializeMLRTBytecode(const mlrt::bc::Buffer &bytecode,
   return absl::OkStatus();
 }
 
+absl::StatusOr<mlrt::bc::Buffer> DeserializeMLRTBytecodeBuffer(
+    const std::string &filepath) {
+  std::string data;
+  TF_RETURN_IF_ERROR(ReadFileToString(tsl::Env::Default(), filepath, &data));
+  mlrt::bc::Buffer bytecode;
+  if (!data.empty()) {
+    // `Buffer` can only be grown through an `Allocator`.
+    mlrt::bc::Allocator allocator(&bytecode);
+    const auto address = allocator.Allocate(data.size(), /*alignment=*/8);
+    memcpy(bytecode.Get(address), data.data(), data.size());
+  }
+  LOG(INFO) << "Successfully loaded serialized MLRTBytecode from: "
+            << filepath;
+  return bytecode;
+}
+
 }  // namespace tfrt_stub
 }  // namespace tensorflow
@@ -44,6 +44,10 @@ absl::StatusOr<tfrt::BefBuffer> DeserializeBEFBuffer(
 absl::Status SerializeMLRTBytecode(const mlrt::bc::Buffer &byteCode,
                                    const std::string &filepath);
 
+// Deserializes MLRT bytecode file from filepath into a MLRTBytecodeBuffer.
+absl::StatusOr<mlrt::bc::Buffer> DeserializeMLRTBytecodeBuffer(
+    const std::string &filepath);
+
 }  // namespace tfrt_stub
 }  // namespace tensorflow
 
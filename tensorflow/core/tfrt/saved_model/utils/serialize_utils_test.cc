@@ -136,6 +136,50 @@ TEST(SerializeMLRTTest, HandlesSerializeProcess) {
   // Check that MLRT Bytecode is not empty
   ASSERT_NE(buffer.size(), 0);
 }
+
+TEST(SerializeMLRTTest, HandlesCompleteProcess) {
+  const std::string saved_model_mlir_path =
+      "third_party/tensorflow/compiler/mlir/tfrt/tests/saved_model/testdata/"
+      "test.mlir";
+
+  mlir::DialectRegistry registry;
+  mlir::RegisterAllTensorFlowDialects(registry);
+  mlir::MLIRContext context(registry);
+  auto module =
+      mlir::parseSourceFile<mlir::ModuleOp>(saved_model_mlir_path, &context);
+  ASSERT_TRUE(module);
+  mlir::OwningOpRef<mlir::ModuleOp> module_with_op_keys;
+  std::unique_ptr<Runtime> runtime =
+      tensorflow::tfrt_stub::Runtime::Create(/*num_inter_op_threads=*/1);
+  tfrt_stub::GraphExecutionOptions options(runtime.get());
+  options.enable_mlrt = true;
+  tfrt::ResourceContext resource_context;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<tfrt_stub::FallbackState> fallback_state,
+      tfrt_stub::FallbackState::Create(SessionOptions(), FunctionDefLibrary()));
+  tfrt_stub::ModelRuntimeContext model_context(
+      &options, options.compile_options.saved_model_dir, &resource_context);
+  TF_ASSERT_OK_AND_ASSIGN(
+      const mlrt::bc::Buffer old_bytecode,
+      mlrt_compiler::ConvertTfMlirToBytecode(options.compile_options,
+                                             *fallback_state, module.get(),
+                                             model_context,
+                                             &module_with_op_keys));
+  ASSERT_NE(old_bytecode.size(), 0);
+
+  const std::string filepath =
+      io::JoinPath(getenv("TEST_UNDECLARED_OUTPUTS_DIR"),
+                   std::string("roundtrip_mlrt.mlir.mlrt"));
+  TF_ASSERT_OK(SerializeMLRTBytecode(old_bytecode, filepath));
+
+  TF_ASSERT_OK_AND_ASSIGN(const mlrt::bc::Buffer bytecode,
+                          DeserializeMLRTBytecodeBuffer(filepath));
+
+  // Check for any data loss during deserialization process
+  ASSERT_EQ(old_bytecode.size(), bytecode.size());
+  EXPECT_EQ(std::string(old_bytecode.data(), old_bytecode.size()),
+            std::string(bytecode.data(), bytecode.size()));
+}
 }  // namespace
 }  // namespace tfrt_stub
 }  // namespace tensorflow
@@ -113,6 +113,35 @@ uint8 PeekTag(protobuf::io::CodedInputStream* stream) {
   return *static_cast<const uint8*>(ptr);
 }
 
+// Returns the number of varints in [begin, end), which is the number of bytes
+// without the continuation bit. The loop has no branches, so that compilers
+// vectorize it.
+inline size_t CountVarints(const uint8* begin, const uint8* end) {
+  size_t count = 0;
+  for (const uint8* p = begin; p < end; ++p) {
+    count += (*p & 0x80) == 0;
+  }
+  return count;
+}
+
+// Decodes the varint at `*p`, which must end before `end`, and advances `*p`
+// past it. Single-byte varints, the most common ones, take a single branch.
+inline bool DecodeVarint64(const uint8** p, const uint8* end, uint64* value) {
+  uint64 result = *(*p)++;
+  if (result & 0x80) {
+    result &= 0x7f;
+    for (int shift = 7;; shift += 7) {
+      // A varint has at most 10 bytes.
+      if (*p == end || shift > 63) return false;
+      const uint8 byte = *(*p)++;
+      result |= static_cast<uint64>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) break;
+    }
+  }
+  *value = result;
+  return true;
+}
+
 constexpr uint8 kVarintTag(uint32 tag) { return (tag << 3) | 0; }
 constexpr uint8 kDelimitedTag(uint32 tag) { return (tag << 3) | 2; }
 constexpr uint8 kFixed32Tag(uint32 tag) { return (tag << 3) | 5; }
@@ -303,15 +332,34 @@ class Feature {
         if (!stream.ExpectTag(kDelimitedTag(1))) return false;  // packed tag
         uint32 packed_length;
         if (!stream.ReadVarint32(&packed_length)) return false;
-        auto packed_limit = stream.PushLimit(packed_length);
 
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64_t>(n));
+        // Decode the varints straight from the serialized buffer, and resize
+        // the output once for all of them instead of pushing them back one
+        // by one.
+        const void* buffer;
+        int buffer_size;
+        if (packed_length > 0 &&
+            (!stream.GetDirectBufferPointer(&buffer, &buffer_size) ||
+             buffer_size < packed_length)) {
+          return false;
         }
-
-        stream.PopLimit(packed_limit);
+        const uint8* begin = static_cast<const uint8*>(buffer);
+        const uint8* end = begin + packed_length;
+        if (packed_length > 0 && (end[-1] & 0x80)) return false;
+        const size_t num_elements = CountVarints(begin, end);
+        const size_t initial_size = int64_list->size();
+        int64_list->resize(initial_size + num_elements);
+        // A `LimitedArraySlice` may hold fewer elements than requested, which
+        // its caller reports.
+        const size_t num_to_write = int64_list->size() - initial_size;
+        int64_t* out = int64_list->data() + initial_size;
+        const uint8* p = begin;
+        for (size_t i = 0; i < num_to_write; ++i) {
+          uint64 n;
+          if (!DecodeVarint64(&p, end, &n)) return false;
+          out[i] = static_cast<int64_t>(n);
+        }
+        if (!stream.Skip(packed_length)) return false;
       } else {  // non-packed
         while (!stream.ExpectAtEnd()) {
           if (!stream.ExpectTag(kVarintTag(1))) return false;
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
+#include <limits>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -219,6 +220,32 @@ TEST(FastParse, SingleInt64) {
   TestCorrectness(Serialize(example));
 }
 
+TEST(FastParse, PackedInt64Varints) {
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["int64_list"]
+          .mutable_int64_list();
+  for (int64_t value :
+       {int64_t{0}, int64_t{1}, int64_t{127}, int64_t{128}, int64_t{-1},
+        int64_t{1} << 35, std::numeric_limits<int64_t>::min(),
+        std::numeric_limits<int64_t>::max()}) {
+    int64_list->add_value(value);
+  }
+  TestCorrectness(Serialize(example));
+}
+
+TEST(FastParse, TruncatedPackedInt64Varint) {
+  // An Example with the feature {"a": int64_list {value: [<0x80>]}}, whose
+  // only varint is missing its last byte.
+  const string serialized(
+      "\x0a\x0c\x0a\x0a\x0a\x01"
+      "a\x12\x05\x1a\x03\x0a\x01\x80",
+      14);
+  Example example;
+  EXPECT_FALSE(example.ParseFromString(serialized));
+  EXPECT_FALSE(TestFastParse(serialized, &example));
+}
+
 static string ExampleWithSomeFeatures() {
   Example example;
 
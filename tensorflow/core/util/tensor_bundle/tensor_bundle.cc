@@ -15,11 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <utility>
 
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -73,13 +75,57 @@ static const int kBufferSize = 1024 * 1024;
 // bundle.
 const char* const kHeaderEntryKey = "";
 
-// The size threshold for multi-threaded tensor loading.
-const int64_t kLargeTensorThreshold = static_cast<int64_t>(1) << 32;
-// Maximum number of threads to load the tensor from the file.
+// Default maximum number of threads to load a tensor from the file.
 const int kMaxFileReadThreads = 8;
-// Minimum size of a file section handled by each thread.
+// Default minimum size of a file section handled by each thread.  Tensors of
+// at least two sections are loaded by multiple threads.
 const int64_t kMinSectionSize = static_cast<int64_t>(1) << 31;
 
+int CheckpointReadThreads() {
+  static const int threads = [] {
+    int64_t value;
+    if (!ReadInt64FromEnvVar("TF_CHECKPOINT_READ_THREADS", kMaxFileReadThreads,
+                             &value)
+             .ok() ||
+        value <= 0) {
+      LOG(ERROR) << "Invalid TF_CHECKPOINT_READ_THREADS, using "
+                 << kMaxFileReadThreads;
+      value = kMaxFileReadThreads;
+    }
+    return static_cast<int>(value);
+  }();
+  return threads;
+}
+
+int64_t CheckpointReadSectionBytes() {
+  static const int64_t section_bytes = [] {
+    int64_t value;
+    if (!ReadInt64FromEnvVar("TF_CHECKPOINT_READ_SECTION_BYTES",
+                             kMinSectionSize, &value)
+             .ok() ||
+        value <= 0) {
+      LOG(ERROR) << "Invalid TF_CHECKPOINT_READ_SECTION_BYTES, using "
+                 << kMinSectionSize;
+      value = kMinSectionSize;
+    }
+    return value;
+  }();
+  return section_bytes;
+}
+
+int CheckpointDataAlignment() {
+  static const int alignment = [] {
+    int64_t value;
+    if (!ReadInt64FromEnvVar("TF_CHECKPOINT_DATA_ALIGNMENT", 1, &value).ok() ||
+        value <= 0) {
+      LOG(ERROR) << "Invalid TF_CHECKPOINT_DATA_ALIGNMENT, using 1";
+      value = 1;
+    }
+    return static_cast<int>(value);
+  }();
+  return alignment;
+}
+
 namespace {
 
 // Reads "num_elements" string elements from file[offset, offset+size) into the
@@ -869,6 +915,82 @@ Status BundleReader::GetBundleEntryProto(StringPiece key,
   return OkStatus();
 }
 
+Status BundleReader::GetDataFile(int32_t shard_id, io::InputBuffer** file) {
+  // Open the data file if it has not been opened.
+  io::InputBuffer*& buffered_file = data_[shard_id];
+  if (buffered_file == nullptr) {
+    std::unique_ptr<RandomAccessFile> raw_file = nullptr;
+    TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(
+        DataFilename(prefix_, shard_id, num_shards_), &raw_file));
+    // The InputBuffer and RandomAccessFile objects are both released in dtor.
+    buffered_file = new io::InputBuffer(raw_file.release(), kBufferSize);
+  }
+  *file = buffered_file;
+  return OkStatus();
+}
+
+Status BundleReader::ReadRange(int32_t shard_id, int64_t offset,
+                               int64_t size, char* dst) {
+  const int64_t section_bytes = CheckpointReadSectionBytes();
+  if (!enable_multi_threading_for_testing_ && size < 2 * section_bytes) {
+    io::InputBuffer* buffered_file;
+    TF_RETURN_IF_ERROR(GetDataFile(shard_id, &buffered_file));
+    StringPiece sp;
+    TF_RETURN_IF_ERROR(buffered_file->file()->Read(offset, size, &sp, dst));
+    if (sp.data() != dst) {
+      memmove(dst, sp.data(), size);
+    }
+    return OkStatus();
+  }
+
+  // Issues a range read per section, each on its own file so that they can be
+  // served concurrently.
+  const int max_threads = CheckpointReadThreads();
+  int64_t section_size = section_bytes;
+  int64_t thread_pool_size = (size + section_bytes - 1) / section_bytes;
+  if (thread_pool_size > max_threads || enable_multi_threading_for_testing_) {
+    thread_pool_size = max_threads;
+    section_size = (size + max_threads - 1) / max_threads;
+  }
+
+  std::vector<Status> statuses(thread_pool_size);
+  auto reader_pool = std::make_unique<thread::ThreadPool>(
+      Env::Default(), "restore_large_tensor", thread_pool_size);
+
+  for (int i = 0; i < thread_pool_size; ++i) {
+    reader_pool->Schedule([&, i]() {
+      int64_t section_offset = i * section_size;
+      int64_t section_length = i == thread_pool_size - 1
+                                   ? size - section_offset
+                                   : section_size;
+      if (section_length <= 0) return;
+      std::unique_ptr<RandomAccessFile> section_reader = nullptr;
+      StringPiece sp;
+      if (auto file_status = env_->NewRandomAccessFile(
+              DataFilename(prefix_, shard_id, num_shards_), &section_reader);
+          !file_status.ok()) {
+        statuses[i] = file_status;
+        return;
+      }
+
+      auto backing_buffer_current_pos = dst + section_offset;
+      auto status = section_reader->Read(offset + section_offset,
+                                         section_length, &sp,
+                                         backing_buffer_current_pos);
+      if (sp.data() != backing_buffer_current_pos) {
+        memmove(backing_buffer_current_pos, sp.data(), section_length);
+      }
+      statuses[i] = std::move(status);
+    });
+  }
+  reader_pool = nullptr;  // Wait for reads to finish
+
+  for (const auto& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return OkStatus();
+}
+
 Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
   Tensor* ret = val;
   const TensorShape stored_shape(TensorShape(entry.shape()));
@@ -898,18 +1020,8 @@ Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
     }
   }
 
-  // Open the data file if it has not been opened.
-  io::InputBuffer* buffered_file = data_[entry.shard_id()];
-  if (buffered_file == nullptr) {
-    std::unique_ptr<RandomAccessFile> file = nullptr;
-    TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(
-        DataFilename(prefix_, entry.shard_id(), num_shards_), &file));
-    buffered_file = new io::InputBuffer(file.release(), kBufferSize);
-    // The InputBuffer and RandomAccessFile objects are both released in dtor.
-    data_[entry.shard_id()] = buffered_file;
-  }
-  CHECK(buffered_file != nullptr);
-
+  io::InputBuffer* buffered_file;
+  TF_RETURN_IF_ERROR(GetDataFile(entry.shard_id(), &buffered_file));
   TF_RETURN_IF_ERROR(buffered_file->Seek(entry.offset()));
   uint32 actual_crc32c = 0;
 
@@ -917,59 +1029,8 @@ Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
     char* backing_buffer = const_cast<char*>((ret->tensor_data().data()));
     size_t unused_bytes_read;
     if (entry.size() > kBufferSize || enable_multi_threading_for_testing_) {
-      StringPiece sp;
-      if (!enable_multi_threading_for_testing_ &&
-          entry.size() < kLargeTensorThreshold) {
-        TF_RETURN_IF_ERROR(buffered_file->file()->Read(
-            entry.offset(), entry.size(), &sp, backing_buffer));
-        if (sp.data() != backing_buffer) {
-          memmove(backing_buffer, sp.data(), entry.size());
-        }
-      } else {
-        int64_t section_size = kMinSectionSize;
-        int64_t thread_pool_size =
-            (entry.size() + kMinSectionSize - 1) / kMinSectionSize;
-        if (thread_pool_size > kMaxFileReadThreads ||
-            enable_multi_threading_for_testing_) {
-          thread_pool_size = kMaxFileReadThreads;
-          section_size =
-              (entry.size() + kMaxFileReadThreads - 1) / kMaxFileReadThreads;
-        }
-
-        std::vector<Status> statuses(thread_pool_size);
-        auto reader_pool = std::make_unique<thread::ThreadPool>(
-            Env::Default(), "restore_large_tensor", thread_pool_size);
-
-        for (int i = 0; i < thread_pool_size; ++i) {
-          reader_pool->Schedule([&, i]() {
-            int64_t offset = i * section_size;
-            int64_t size = i == thread_pool_size - 1 ? entry.size() - offset
-                                                     : section_size;
-            std::unique_ptr<RandomAccessFile> section_reader = nullptr;
-            StringPiece sp;
-            if (auto file_status = env_->NewRandomAccessFile(
-                    DataFilename(prefix_, entry.shard_id(), num_shards_),
-                    &section_reader);
-                !file_status.ok()) {
-              statuses[i] = file_status;
-              return;
-            }
-
-            auto backing_buffer_current_pos = backing_buffer + offset;
-            auto status = section_reader->Read(entry.offset() + offset, size,
-                                               &sp, backing_buffer_current_pos);
-            if (sp.data() != backing_buffer_current_pos) {
-              memmove(backing_buffer_current_pos, sp.data(), size);
-            }
-            statuses[i] = std::move(status);
-          });
-        }
-        reader_pool = nullptr;  // Wait for reads to finish
-
-        for (const auto& status : statuses) {
-          TF_RETURN_IF_ERROR(status);
-        }
-      }
+      TF_RETURN_IF_ERROR(ReadRange(entry.shard_id(), entry.offset(),
+                                   entry.size(), backing_buffer));
     } else {
       TF_RETURN_IF_ERROR(buffered_file->ReadNBytes(entry.size(), backing_buffer,
                                                    &unused_bytes_read));
@@ -1012,6 +1073,73 @@ Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
   return OkStatus();
 }
 
+namespace {
+
+// A read-only tensor buffer in a memory mapped data file.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                     uint64_t offset, uint64_t size)
+      : TensorBuffer(const_cast<char*>(
+            static_cast<const char*>(region->data()) + offset)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(
+      AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("bundle_mmap");
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
+}  // namespace
+
+Status BundleReader::LookupMapped(StringPiece key, Tensor* val,
+                                  bool* mapped) {
+  *mapped = false;
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  const TensorShape shape(entry.shape());
+  if (!entry.slices().empty() || !DataTypeCanUseMemcpy(entry.dtype()) ||
+      need_to_swap_bytes_ ||
+      entry.size() != shape.num_elements() * DataTypeSize(entry.dtype()) ||
+      entry.offset() % std::max(EIGEN_MAX_ALIGN_BYTES, 1) != 0) {
+    return OkStatus();
+  }
+
+  auto it = mapped_data_.find(entry.shard_id());
+  if (it == mapped_data_.end()) {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    Status s = env_->NewReadOnlyMemoryRegionFromFile(
+        DataFilename(prefix_, entry.shard_id(), num_shards_), &region);
+    if (!s.ok()) {
+      VLOG(1) << "Reading " << prefix_ << " shard " << entry.shard_id()
+              << " instead of mapping it: " << s;
+    }
+    it = mapped_data_.emplace(entry.shard_id(), std::move(region)).first;
+  }
+  const std::shared_ptr<ReadOnlyMemoryRegion>& region = it->second;
+  if (region == nullptr) return OkStatus();
+  if (entry.offset() + entry.size() > region->length()) {
+    return errors::DataLoss("Tensor ", key, " at ", prefix_, " shard ",
+                            entry.shard_id(), " extends past the end of the ",
+                            region->length(), " byte data file");
+  }
+  // The mapping itself is page aligned.
+  auto* buffer = new MappedTensorBuffer(region, entry.offset(), entry.size());
+  core::ScopedUnref unref(buffer);
+  *val = Tensor(entry.dtype(), shape, buffer);
+  *mapped = true;
+  return OkStatus();
+}
+
 Status BundleReader::Lookup(StringPiece key, Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1064,6 +1192,77 @@ Status BundleReader::LookupSlice(StringPiece full_tensor_key,
   return GetSliceValue(full_tensor_key, entry, slice_spec, val);
 }
 
+namespace {
+
+// The rows [*begin, *end) of dimension 0 of the tensor of shape "full_shape"
+// covered by "slice", if it spans all of the other dimensions.
+bool SliceRows(const TensorShape& full_shape, const TensorSlice& slice,
+               int64_t* begin, int64_t* end) {
+  for (int d = 1; d < full_shape.dims(); ++d) {
+    if (!slice.IsFullAt(d) &&
+        (slice.start(d) != 0 || slice.length(d) != full_shape.dim_size(d))) {
+      return false;
+    }
+  }
+  *begin = slice.IsFullAt(0) ? 0 : slice.start(0);
+  *end = slice.IsFullAt(0) ? full_shape.dim_size(0) : slice.end(0);
+  return true;
+}
+
+}  // namespace
+
+Status BundleReader::ReadSliceRows(const BundleEntryProto& stored_slice_entry,
+                                   const TensorShape& full_shape,
+                                   const TensorSlice& stored_slice,
+                                   const TensorSlice& slice_spec, Tensor* val,
+                                   bool* done) {
+  *done = false;
+  const DataType dtype = stored_slice_entry.dtype();
+  if (!DataTypeCanUseMemcpy(dtype) || need_to_swap_bytes_ ||
+      full_shape.dims() == 0 || val->dtype() != dtype) {
+    return OkStatus();
+  }
+  int64_t stored_begin, stored_end, spec_begin, spec_end;
+  if (!SliceRows(full_shape, stored_slice, &stored_begin, &stored_end) ||
+      !SliceRows(full_shape, slice_spec, &spec_begin, &spec_end)) {
+    return OkStatus();
+  }
+  const int64_t begin = std::max(stored_begin, spec_begin);
+  const int64_t end = std::min(stored_end, spec_end);
+  if (begin >= end) return OkStatus();
+
+  const int64_t row_bytes =
+      full_shape.num_elements() / full_shape.dim_size(0) * DataTypeSize(dtype);
+  if (stored_slice_entry.size() != (stored_end - stored_begin) * row_bytes) {
+    return errors::DataLoss("Invalid size in bundle entry: key ", key(),
+                            "; stored size ", stored_slice_entry.size(),
+                            "; expected size ",
+                            (stored_end - stored_begin) * row_bytes);
+  }
+  const int64_t size = (end - begin) * row_bytes;
+  char* dst = const_cast<char*>(val->tensor_data().data()) +
+              (begin - spec_begin) * row_bytes;
+  VLOG(1) << "Reading rows [" << begin << ", " << end << ") of "
+          << slice_spec.DebugString() << " from stored slice "
+          << stored_slice.DebugString();
+  TF_RETURN_IF_ERROR(ReadRange(stored_slice_entry.shard_id(),
+                               stored_slice_entry.offset() +
+                                   (begin - stored_begin) * row_bytes,
+                               size, dst));
+  if (size == stored_slice_entry.size()) {
+    const uint32 actual_crc32c = crc32c::Value(dst, size);
+    if (crc32c::Unmask(stored_slice_entry.crc32c()) != actual_crc32c) {
+      return errors::DataLoss(
+          "TensorBundle at ", prefix_, " shard ", stored_slice_entry.shard_id(),
+          " (", size, " bytes): Checksum does not match: stored ",
+          strings::Printf("%08u", crc32c::Unmask(stored_slice_entry.crc32c())),
+          " vs. calculated on the restored bytes ", actual_crc32c);
+    }
+  }
+  *done = true;
+  return OkStatus();
+}
+
 Status BundleReader::GetSliceValue(StringPiece full_tensor_key,
                                    const BundleEntryProto& full_tensor_entry,
                                    const TensorSlice& slice_spec, Tensor* val) {
@@ -1142,6 +1341,12 @@ Status BundleReader::GetSliceValue(StringPiece full_tensor_key,
       return status_;
     }
 
+    bool done = false;
+    status_ = ReadSliceRows(stored_slice_entry, full_shape, stored_slice,
+                            slice_spec, val, &done);
+    if (!status_.ok()) return status_;
+    if (done) continue;
+
     Tensor stored_slice_tensor(stored_slice_entry.dtype(), stored_slice_shape);
     status_ = GetValue(stored_slice_entry, &stored_slice_tensor);
     if (!status_.ok()) return status_;
@@ -194,6 +194,23 @@ Status MergeBundles(Env* env, gtl::ArraySlice<tstring> prefixes,
                     absl::string_view merged_prefix,
                     bool allow_missing_files = false);
 
+// The maximum number of concurrent range reads of one tensor, from
+// TF_CHECKPOINT_READ_THREADS (8 by default).  RestoreV2 also reads this many
+// tensors concurrently.
+int CheckpointReadThreads();
+
+// The size of the range reads of large tensors, from
+// TF_CHECKPOINT_READ_SECTION_BYTES (2 GiB by default).  Tensors of at least
+// two sections are read concurrently.  Smaller sections help storage with
+// high per-request latency, like GCS.
+int64_t CheckpointReadSectionBytes();
+
+// The alignment of the tensors SaveV2 writes, from
+// TF_CHECKPOINT_DATA_ALIGNMENT (1, unpadded, by default).  Checkpoints
+// written with EIGEN_MAX_ALIGN_BYTES or more can be mapped by
+// BundleReader::LookupMapped().
+int CheckpointDataAlignment();
+
 // On construction, silently attempts to read the metadata associated with
 // "prefix".  If caller intends to call any function afterwards, "status()"
 // must be checked.
@@ -251,6 +268,20 @@ class BundleReader {
   // REQUIRES: status().ok()
   Status Lookup(absl::string_view key, Tensor* val) TF_MUST_USE_RESULT;
 
+  // Like "Lookup()", but if the tensor keyed by "key" is stored in full, has
+  // a dtype that can be memcpy'd, and its data is aligned to
+  // EIGEN_MAX_ALIGN_BYTES, sets "*val" to a tensor backed by a read-only
+  // memory mapping of the data file, and "*mapped" to true.  Pages are then
+  // read on first use, and shared with other processes mapping the same
+  // file.  The tensor must not be written to, and its checksum is not
+  // verified since that would read every page.
+  //
+  // Otherwise, including when the file system does not support memory
+  // mapping, sets "*mapped" to false and leaves "*val" untouched.
+  // REQUIRES: status().ok()
+  Status LookupMapped(absl::string_view key, Tensor* val,
+                      bool* mapped) TF_MUST_USE_RESULT;
+
   // Looks up the tensor pointed to by the internal iterator.
   //
   // On error, "val" may contain nonsense data.
@@ -309,6 +340,25 @@ class BundleReader {
   Status GetValue(const BundleEntryProto& entry,
                   Tensor* val) TF_MUST_USE_RESULT;
 
+  // Returns the buffered data file of shard "shard_id", opening it if needed.
+  Status GetDataFile(int32_t shard_id,
+                     io::InputBuffer** file) TF_MUST_USE_RESULT;
+
+  // Reads [offset, offset + size) of data shard "shard_id" into "dst", with
+  // concurrent range reads if it is large.
+  Status ReadRange(int32_t shard_id, int64_t offset, int64_t size,
+                   char* dst) TF_MUST_USE_RESULT;
+
+  // If "stored_slice" of the tensor of shape "full_shape" and "slice_spec"
+  // both span whole rows, reads the rows of "slice_spec" stored in
+  // "stored_slice_entry" straight into "val", and sets "*done".  The checksum
+  // is only verified when the whole stored slice is read.
+  Status ReadSliceRows(const BundleEntryProto& stored_slice_entry,
+                       const TensorShape& full_shape,
+                       const TensorSlice& stored_slice,
+                       const TensorSlice& slice_spec, Tensor* val,
+                       bool* done) TF_MUST_USE_RESULT;
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -327,6 +377,10 @@ class BundleReader {
   table::Iterator* iter_;
   // Owned the InputBuffer objects and their underlying RandomAccessFile's.
   std::unordered_map<int32_t, io::InputBuffer*> data_;
+  // Memory mappings of the data files, shared with the tensors that
+  // LookupMapped() returns.  Null if a file cannot be mapped.
+  std::unordered_map<int32_t, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
 
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
@@ -648,6 +648,85 @@ TEST(TensorBundleTest, PartitionedVariables) {
   }
 }
 
+TEST(TensorBundleTest, RowSlices) {
+  const TensorShape kFullShape({6, 3});
+  Tensor full(DT_FLOAT, kFullShape);
+  test::FillIota<float>(&full, 0.f);
+  // Row slices of `full` may be unaligned, so they are copied.
+  auto rows = [&full](int64_t begin, int64_t end) {
+    return tensor::DeepCopy(full.Slice(begin, end));
+  };
+  {
+    BundleWriter writer(Env::Default(), Prefix("rows"));
+    TF_ASSERT_OK(writer.Add("full", full));
+    TF_ASSERT_OK(writer.AddSlice("partitioned", kFullShape,
+                                 TensorSlice::ParseOrDie("0,3:-"),
+                                 rows(0, 3)));
+    TF_ASSERT_OK(writer.AddSlice("partitioned", kFullShape,
+                                 TensorSlice::ParseOrDie("3,3:0,3"),
+                                 rows(3, 6)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader reader(Env::Default(), Prefix("rows"));
+  TF_ASSERT_OK(reader.status());
+  // Reads rows from the middle of a tensor saved in full.
+  {
+    Tensor val(DT_FLOAT, TensorShape({2, 3}));
+    TF_ASSERT_OK(
+        reader.LookupSlice("full", TensorSlice::ParseOrDie("1,2:-"), &val));
+    test::ExpectTensorEqual<float>(val, rows(1, 3));
+  }
+  // Reads rows across both stored slices.
+  {
+    Tensor val(DT_FLOAT, TensorShape({3, 3}));
+    TF_ASSERT_OK(reader.LookupSlice("partitioned",
+                                    TensorSlice::ParseOrDie("2,3:-"), &val));
+    test::ExpectTensorEqual<float>(val, rows(2, 5));
+  }
+  // Reads a whole stored slice, and a column slice that spans no rows.
+  {
+    Tensor val(DT_FLOAT, TensorShape({3, 3}));
+    TF_ASSERT_OK(reader.LookupSlice("partitioned",
+                                    TensorSlice::ParseOrDie("3,3:-"), &val));
+    test::ExpectTensorEqual<float>(val, rows(3, 6));
+
+    Tensor column(DT_FLOAT, TensorShape({6, 1}));
+    TF_ASSERT_OK(reader.LookupSlice("partitioned",
+                                    TensorSlice::ParseOrDie("-:1,1"), &column));
+    test::ExpectTensorEqual<float>(
+        column, test::AsTensor<float>({1, 4, 7, 10, 13, 16}, {6, 1}));
+  }
+}
+
+TEST(TensorBundleTest, LookupMapped) {
+  Tensor floats(DT_FLOAT, TensorShape({4, 5}));
+  test::FillIota<float>(&floats, 0.f);
+  const Tensor strings = test::AsTensor<tstring>({"a", "b"});
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = std::max(EIGEN_MAX_ALIGN_BYTES, 1);
+    BundleWriter writer(Env::Default(), Prefix("mapped"), opts);
+    TF_ASSERT_OK(writer.Add("floats", floats));
+    TF_ASSERT_OK(writer.Add("strings", strings));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader reader(Env::Default(), Prefix("mapped"));
+  TF_ASSERT_OK(reader.status());
+
+  Tensor val;
+  bool mapped = false;
+  TF_ASSERT_OK(reader.LookupMapped("floats", &val, &mapped));
+  ASSERT_TRUE(mapped);
+  test::ExpectTensorEqual<float>(val, floats);
+
+  // Strings are not stored contiguously, so they are never mapped.
+  TF_ASSERT_OK(reader.LookupMapped("strings", &val, &mapped));
+  EXPECT_FALSE(mapped);
+
+  EXPECT_TRUE(
+      errors::IsNotFound(reader.LookupMapped("missing", &val, &mapped)));
+}
+
 TEST(TensorBundleTest, EquivalentSliceTest) {
   const TensorShape kFullShape({5, 10});
   const Tensor kExpected(Constant<float>(1., kFullShape));
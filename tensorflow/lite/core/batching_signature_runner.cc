@@ -0,0 +1,192 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/batching_signature_runner.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/core/c/c_api_types.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/signature_runner.h"
+#include "tensorflow/lite/minimal_logging.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite {
+namespace impl {
+
+std::unique_ptr<BatchingSignatureRunner> BatchingSignatureRunner::Create(
+    SignatureRunner* signature_runner, const Options& options) {
+  if (signature_runner == nullptr || options.max_batch_size < 1) {
+    TFLITE_LOG(TFLITE_LOG_ERROR,
+               "BatchingSignatureRunner needs a signature runner and a "
+               "positive max_batch_size.");
+    return nullptr;
+  }
+  const std::vector<int>& allowed = options.allowed_batch_sizes;
+  if (!allowed.empty() &&
+      (allowed.front() < 1 || allowed.back() != options.max_batch_size ||
+       std::adjacent_find(allowed.begin(), allowed.end(),
+                          std::greater_equal<int>()) != allowed.end())) {
+    TFLITE_LOG(TFLITE_LOG_ERROR,
+               "allowed_batch_sizes must be positive, strictly increasing and "
+               "end with max_batch_size.");
+    return nullptr;
+  }
+  std::vector<std::vector<int>> input_dims;
+  std::vector<size_t> input_bytes;
+  for (const char* name : signature_runner->input_names()) {
+    const TfLiteTensor* tensor = signature_runner->input_tensor(name);
+    size_t bytes = 0;
+    if (tensor->dims->size < 1 ||
+        GetSizeOfType(nullptr, tensor->type, &bytes) != kTfLiteOk ||
+        tensor->type == kTfLiteString) {
+      TFLITE_LOG(TFLITE_LOG_ERROR,
+                 "Input %s has no batch dimension or no fixed element size.",
+                 name);
+      return nullptr;
+    }
+    for (int i = 1; i < tensor->dims->size; ++i) {
+      bytes *= tensor->dims->data[i];
+    }
+    input_dims.emplace_back(tensor->dims->data,
+                            tensor->dims->data + tensor->dims->size);
+    input_bytes.push_back(bytes);
+  }
+  return std::unique_ptr<BatchingSignatureRunner>(new BatchingSignatureRunner(
+      signature_runner, options, std::move(input_dims),
+      std::move(input_bytes)));
+}
+
+BatchingSignatureRunner::BatchingSignatureRunner(
+    SignatureRunner* signature_runner, const Options& options,
+    std::vector<std::vector<int>> input_dims, std::vector<size_t> input_bytes)
+    : signature_runner_(signature_runner),
+      options_(options),
+      input_dims_(std::move(input_dims)),
+      input_bytes_(std::move(input_bytes)) {}
+
+TfLiteStatus BatchingSignatureRunner::Run(
+    const std::vector<const void*>& inputs,
+    std::vector<std::vector<char>>* outputs) {
+  if (inputs.size() != input_bytes_.size()) {
+    TFLITE_LOG(TFLITE_LOG_ERROR, "Expected %d inputs, got %d.",
+               static_cast<int>(input_bytes_.size()),
+               static_cast<int>(inputs.size()));
+    return kTfLiteError;
+  }
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_.push_back(&request);
+  cond_var_.notify_all();
+  while (!request.done) {
+    if (running_ || queue_.front() != &request) {
+      // Another request leads the next batch, which may include this one.
+      cond_var_.wait(lock);
+      continue;
+    }
+    // This request leads the next batch, and waits for it to fill up.
+    cond_var_.wait_for(
+        lock, std::chrono::microseconds(options_.batch_timeout_micros), [this] {
+          return queue_.size() >= static_cast<size_t>(options_.max_batch_size);
+        });
+    const size_t batch_size =
+        std::min(queue_.size(), static_cast<size_t>(options_.max_batch_size));
+    std::vector<Request*> batch(queue_.begin(), queue_.begin() + batch_size);
+    queue_.erase(queue_.begin(), queue_.begin() + batch_size);
+    running_ = true;
+    lock.unlock();
+    const TfLiteStatus status = RunBatch(batch);
+    lock.lock();
+    running_ = false;
+    for (Request* r : batch) {
+      r->status = status;
+      r->done = true;
+    }
+    cond_var_.notify_all();
+  }
+  return request.status;
+}
+
+int BatchingSignatureRunner::PaddedBatchSize(int num_requests) const {
+  for (int allowed : options_.allowed_batch_sizes) {
+    if (allowed >= num_requests) return allowed;
+  }
+  return num_requests;
+}
+
+TfLiteStatus BatchingSignatureRunner::RunBatch(
+    const std::vector<Request*>& batch) {
+  const int batch_size = PaddedBatchSize(batch.size());
+  const std::vector<const char*>& input_names =
+      signature_runner_->input_names();
+  if (batch_size != allocated_batch_size_) {
+    allocated_batch_size_ = 0;
+    for (size_t i = 0; i < input_names.size(); ++i) {
+      input_dims_[i][0] = batch_size;
+      TF_LITE_ENSURE_STATUS(
+          signature_runner_->ResizeInputTensor(input_names[i], input_dims_[i]));
+    }
+    TF_LITE_ENSURE_STATUS(signature_runner_->AllocateTensors());
+    allocated_batch_size_ = batch_size;
+  }
+
+  for (size_t i = 0; i < input_names.size(); ++i) {
+    char* data = signature_runner_->input_tensor(input_names[i])->data.raw;
+    for (const Request* request : batch) {
+      std::memcpy(data, (*request->inputs)[i], input_bytes_[i]);
+      data += input_bytes_[i];
+    }
+    std::memset(data, 0, (batch_size - batch.size()) * input_bytes_[i]);
+  }
+
+  TF_LITE_ENSURE_STATUS(signature_runner_->Invoke());
+
+  const std::vector<const char*>& output_names =
+      signature_runner_->output_names();
+  for (const Request* request : batch) {
+    request->outputs->resize(output_names.size());
+  }
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    const TfLiteTensor* tensor =
+        signature_runner_->output_tensor(output_names[i]);
+    if (tensor->dims->size < 1 || tensor->dims->data[0] != batch_size) {
+      TFLITE_LOG(TFLITE_LOG_ERROR,
+                 "Output %s does not have the batch size %d as its first "
+                 "dimension.",
+                 output_names[i], batch_size);
+      return kTfLiteError;
+    }
+    const size_t bytes = tensor->bytes / batch_size;
+    const char* data = tensor->data.raw_const;
+    for (const Request* request : batch) {
+      (*request->outputs)[i].assign(data, data + bytes);
+      data += bytes;
+    }
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace impl
+}  // namespace tflite
@@ -0,0 +1,139 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_CORE_BATCHING_SIGNATURE_RUNNER_H_
+#define TENSORFLOW_LITE_CORE_BATCHING_SIGNATURE_RUNNER_H_
+/// \file
+///
+/// A thread-safe wrapper of `SignatureRunner` that runs concurrent requests
+/// as one batch.
+///
+/// WARNING: This is an experimental API and subject to change.
+
+#include <condition_variable>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/signature_runner.h"
+
+namespace tflite {
+namespace impl {
+
+/// Coalesces concurrent `Run` calls into one invocation of a signature whose
+/// inputs and outputs all have the batch as their first dimension.
+///
+/// Each request holds one element of the batch. The first request to arrive
+/// waits until `max_batch_size` requests are queued or `batch_timeout_micros`
+/// has passed, then copies every request's inputs in, invokes the signature
+/// once and copies each request's slice of the outputs back.
+///
+/// If `allowed_batch_sizes` is not empty, the batch dimension is padded with
+/// zeros up to the smallest of them that holds the batch, and the outputs of
+/// the padding are discarded. The interpreter is thus allocated for one of a
+/// few fixed batch sizes, and only reallocated when a batch needs a different
+/// one than the previous batch. Otherwise, batches are run at their exact
+/// size.
+///
+/// Usage:
+///
+/// <pre><code>
+/// BatchingSignatureRunner::Options options;
+/// options.max_batch_size = 16;
+/// auto batching_runner = BatchingSignatureRunner::Create(
+///     interpreter->GetSignatureRunner("serving_default"), options);
+///
+/// // From any number of threads:
+/// std::vector<std::vector<char>> outputs;
+/// if (batching_runner->Run({input_data}, &outputs) != kTfLiteOk) {
+///   // Return error.
+/// }
+/// </code></pre>
+class BatchingSignatureRunner {
+ public:
+  struct Options {
+    // The largest number of requests run as one batch.
+    int max_batch_size = 32;
+    // How long the first request of a batch waits for more requests.
+    int64_t batch_timeout_micros = 1000;
+    // Batch sizes that batches are padded to, in increasing order. If not
+    // empty, the last one must be `max_batch_size`. If empty, batches are not
+    // padded.
+    std::vector<int> allowed_batch_sizes;
+  };
+
+  /// Returns a runner of `signature_runner`, or nullptr if an input of the
+  /// signature has no batch dimension or has a type without a fixed size, or
+  /// if `options` are invalid.
+  /// `signature_runner` must outlive the returned runner and must not be used
+  /// by anything else while it exists.
+  static std::unique_ptr<BatchingSignatureRunner> Create(
+      SignatureRunner* signature_runner, const Options& options);
+
+  /// Runs one element of a batch and blocks until its outputs are ready.
+  /// `inputs` holds one buffer per signature input, in the order of
+  /// `SignatureRunner::input_names()`, each of `input_bytes(i)` bytes. On
+  /// success, `outputs` holds one buffer per signature output in the order of
+  /// `SignatureRunner::output_names()`. Thread safe.
+  TfLiteStatus Run(const std::vector<const void*>& inputs,
+                   std::vector<std::vector<char>>* outputs);
+
+  /// Returns the size in bytes of one element of input `i`.
+  size_t input_bytes(size_t i) const { return input_bytes_[i]; }
+
+ private:
+  struct Request {
+    const std::vector<const void*>* inputs;
+    std::vector<std::vector<char>>* outputs;
+    TfLiteStatus status = kTfLiteOk;
+    bool done = false;
+  };
+
+  BatchingSignatureRunner(SignatureRunner* signature_runner,
+                          const Options& options,
+                          std::vector<std::vector<int>> input_dims,
+                          std::vector<size_t> input_bytes);
+
+  // Returns the batch size that a batch of `num_requests` is padded to.
+  int PaddedBatchSize(int num_requests) const;
+
+  // Runs `batch` as one invocation of the signature. Must be called by one
+  // thread at a time.
+  TfLiteStatus RunBatch(const std::vector<Request*>& batch);
+
+  SignatureRunner* const signature_runner_;
+  const Options options_;
+  // Shapes of the inputs, the first dimension of which is the batch.
+  std::vector<std::vector<int>> input_dims_;
+  // Size in bytes of one element of each input.
+  const std::vector<size_t> input_bytes_;
+  // Batch size that the interpreter is allocated for, if any.
+  int allocated_batch_size_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  // Requests that have not started running, in order of arrival.
+  std::deque<Request*> queue_;
+  // Whether a batch is being run.
+  bool running_ = false;
+};
+
+}  // namespace impl
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CORE_BATCHING_SIGNATURE_RUNNER_H_
@@ -0,0 +1,134 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/batching_signature_runner.h"
+
+#include <cstring>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/interpreter_builder.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/core/model_builder.h"
+#include "tensorflow/lite/core/signature_runner.h"
+#include "tensorflow/lite/testing/util.h"
+
+namespace tflite {
+namespace impl {
+namespace {
+
+class BatchingSignatureRunnerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = FlatBufferModel::BuildFromFile(
+        "tensorflow/lite/testdata/multi_signatures.bin", &reporter_);
+    ASSERT_TRUE(model_);
+    ops::builtin::BuiltinOpResolver resolver;
+    ASSERT_EQ(InterpreterBuilder(*model_, resolver)(&interpreter_), kTfLiteOk);
+    // Adds 2 to each element of the one-dimensional input "x".
+    add_runner_ = interpreter_->GetSignatureRunner("add");
+    ASSERT_NE(add_runner_, nullptr);
+    ASSERT_EQ(add_runner_->ResizeInputTensor("x", {1}), kTfLiteOk);
+    ASSERT_EQ(add_runner_->AllocateTensors(), kTfLiteOk);
+  }
+
+  static float RunAdd(BatchingSignatureRunner* runner, float x) {
+    std::vector<std::vector<char>> outputs;
+    EXPECT_EQ(runner->Run({&x}, &outputs), kTfLiteOk);
+    EXPECT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs[0].size(), sizeof(float));
+    float y = 0;
+    std::memcpy(&y, outputs[0].data(), sizeof(float));
+    return y;
+  }
+
+  TestErrorReporter reporter_;
+  std::unique_ptr<FlatBufferModel> model_;
+  std::unique_ptr<Interpreter> interpreter_;
+  SignatureRunner* add_runner_ = nullptr;
+};
+
+TEST_F(BatchingSignatureRunnerTest, RunsSingleRequest) {
+  auto runner = BatchingSignatureRunner::Create(
+      add_runner_, BatchingSignatureRunner::Options());
+  ASSERT_NE(runner, nullptr);
+  EXPECT_EQ(runner->input_bytes(0), sizeof(float));
+  EXPECT_EQ(RunAdd(runner.get(), 3), 5);
+  EXPECT_EQ(RunAdd(runner.get(), -1), 1);
+}
+
+TEST_F(BatchingSignatureRunnerTest, RunsConcurrentRequests) {
+  BatchingSignatureRunner::Options options;
+  options.max_batch_size = 4;
+  options.batch_timeout_micros = 10000;
+  auto runner = BatchingSignatureRunner::Create(add_runner_, options);
+  ASSERT_NE(runner, nullptr);
+
+  constexpr int kNumRequests = 10;
+  std::vector<float> results(kNumRequests);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumRequests; ++i) {
+    threads.emplace_back(
+        [&, i] { results[i] = RunAdd(runner.get(), static_cast<float>(i)); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < kNumRequests; ++i) {
+    EXPECT_EQ(results[i], i + 2);
+  }
+}
+
+TEST_F(BatchingSignatureRunnerTest, RunsExactBatchSizeWithoutAllowedSizes) {
+  BatchingSignatureRunner::Options options;
+  options.max_batch_size = 4;
+  auto runner = BatchingSignatureRunner::Create(add_runner_, options);
+  ASSERT_NE(runner, nullptr);
+  EXPECT_EQ(RunAdd(runner.get(), 3), 5);
+  EXPECT_EQ(add_runner_->input_tensor("x")->dims->data[0], 1);
+}
+
+TEST_F(BatchingSignatureRunnerTest, PadsToAllowedBatchSize) {
+  BatchingSignatureRunner::Options options;
+  options.max_batch_size = 8;
+  options.allowed_batch_sizes = {2, 8};
+  auto runner = BatchingSignatureRunner::Create(add_runner_, options);
+  ASSERT_NE(runner, nullptr);
+  EXPECT_EQ(RunAdd(runner.get(), 3), 5);
+  EXPECT_EQ(add_runner_->input_tensor("x")->dims->data[0], 2);
+}
+
+TEST_F(BatchingSignatureRunnerTest, FailsForInvalidAllowedBatchSizes) {
+  BatchingSignatureRunner::Options options;
+  options.max_batch_size = 8;
+  options.allowed_batch_sizes = {4, 2, 8};
+  EXPECT_EQ(BatchingSignatureRunner::Create(add_runner_, options), nullptr);
+  options.allowed_batch_sizes = {2, 4};
+  EXPECT_EQ(BatchingSignatureRunner::Create(add_runner_, options), nullptr);
+}
+
+TEST_F(BatchingSignatureRunnerTest, FailsForWrongNumberOfInputs) {
+  auto runner = BatchingSignatureRunner::Create(
+      add_runner_, BatchingSignatureRunner::Options());
+  ASSERT_NE(runner, nullptr);
+  std::vector<std::vector<char>> outputs;
+  EXPECT_EQ(runner->Run({}, &outputs), kTfLiteError);
+}
+
+}  // namespace
+}  // namespace impl
+}  // namespace tflite
@@ -6503,6 +6503,7 @@ void StatefulNnApiDelegate::StatefulNnApiDelegateConstructorImpl(
   delegate_data_.disallow_nnapi_cpu = options.disallow_nnapi_cpu;
   delegate_data_.max_number_delegated_partitions =
       options.max_number_delegated_partitions;
+  delegate_data_.min_nodes_per_partition = options.min_nodes_per_partition;
   delegate_data_.allow_fp16 = options.allow_fp16;
   delegate_data_.execution_priority = options.execution_priority;
   delegate_data_.max_compilation_timeout_duration_ns =
@@ -6579,6 +6580,7 @@ const StatefulNnApiDelegate::Options StatefulNnApiDelegate::GetOptions(
   options.disallow_nnapi_cpu = delegate_data->disallow_nnapi_cpu;
   options.max_number_delegated_partitions =
       delegate_data->max_number_delegated_partitions;
+  options.min_nodes_per_partition = delegate_data->min_nodes_per_partition;
   options.allow_fp16 = delegate_data->allow_fp16;
   options.execution_priority = delegate_data->execution_priority;
   options.max_compilation_timeout_duration_ns =
@@ -6719,9 +6721,29 @@ TfLiteStatus StatefulNnApiDelegate::GetNodesSupportedByAccelerator(
 
 // static
 TfLiteStatus StatefulNnApiDelegate::LimitDelegatedPartitions(
-    int max_partitions,
+    int max_partitions, int min_nodes_per_partition,
     std::vector<TfLiteDelegateParams> partition_params_array,
     std::vector<int>* nodes_to_delegate) {
+  if (min_nodes_per_partition > 1) {
+    auto is_too_small = [min_nodes_per_partition](
+                            const TfLiteDelegateParams& partition_params) {
+      return partition_params.nodes_to_replace->size < min_nodes_per_partition;
+    };
+    for (const TfLiteDelegateParams& partition_params :
+         partition_params_array) {
+      if (!is_too_small(partition_params)) continue;
+      for (int node : TfLiteIntArrayView(partition_params.nodes_to_replace)) {
+        nodes_to_delegate->erase(std::remove(nodes_to_delegate->begin(),
+                                             nodes_to_delegate->end(), node),
+                                 nodes_to_delegate->end());
+      }
+    }
+    partition_params_array.erase(
+        std::remove_if(partition_params_array.begin(),
+                       partition_params_array.end(), is_too_small),
+        partition_params_array.end());
+  }
+
   int num_partitions = partition_params_array.size();
   if (max_partitions <= 0 || num_partitions <= max_partitions) {
     return kTfLiteOk;
@@ -7033,6 +7055,7 @@ TfLiteStatus StatefulNnApiDelegate::DoPrepare(TfLiteContext* context,
 
   TF_LITE_ENSURE_STATUS(
       LimitDelegatedPartitions(delegate_options.max_number_delegated_partitions,
+                               delegate_options.min_nodes_per_partition,
                                std::vector<TfLiteDelegateParams>(
                                    params_array, params_array + num_partitions),
                                &nodes_to_delegate));
@@ -93,6 +93,14 @@ class StatefulNnApiDelegate : public TfLiteDelegate {
     // of number of nodes and selecting them until the limit is reached.
     int max_number_delegated_partitions = 3;
 
+    // Specifies the min number of nodes in a delegated partition. A value <= 1
+    // means no limit.
+    // Partitions with fewer nodes are left to the CPU kernels, since the cost
+    // of moving their inputs and outputs between the CPU and the accelerator
+    // may exceed the time they save. This is applied before
+    // <max_number_delegated_partitions>.
+    int min_nodes_per_partition = 0;
+
     // allow fp32 computation to be run in fp16.
     bool allow_fp16 = false;
 
@@ -326,6 +334,9 @@ class StatefulNnApiDelegate : public TfLiteDelegate {
     // Maximum number of NNAPI partition to delegate. Zero or negative means
     // no limit. Copied from StatefulNnApiDelegate::Options
     int max_number_delegated_partitions;
+    // Minimum number of nodes in a delegated partition. Copied from
+    // StatefulNnApiDelegate::Options
+    int min_nodes_per_partition = 0;
     // allow fp32 computation to be run in fp16.
     bool allow_fp16;
     // Specifies the relative priority for executions of the model.
@@ -425,9 +436,12 @@ class StatefulNnApiDelegate : public TfLiteDelegate {
       std::vector<int>* device_supported_nodes, int* num_partitions,
       TfLiteDelegateParams** params_array, int* nnapi_errno);
 
-  // Alters the given array of nodes_to_delegate to limit the number of NNAPI
-  // owned partition to be less or equal than num_partitions. If num_partitions
-  // is less or equal to zero the input is left unaltered.
+  // Alters the given array of nodes_to_delegate to drop the NNAPI owned
+  // partitions with less than min_nodes_per_partition nodes, and then to limit
+  // the number of remaining partitions to be less or equal than
+  // max_partitions. If max_partitions is less or equal to zero and
+  // min_nodes_per_partition is less or equal to one the input is left
+  // unaltered.
   // The nodes_to_delegate array is expected to contain at element 0 the number
   // of nodes to delegate and in remaining elements the set of nodes
   // that would be delegated to NNAPI if this function wouldn't be
@@ -435,7 +449,7 @@ class StatefulNnApiDelegate : public TfLiteDelegate {
   // nodes to actually delegate and in the remainder of the array the indexes.
   // The params_array params might be altered during the functions execution.
   static TfLiteStatus LimitDelegatedPartitions(
-      int max_partitions,
+      int max_partitions, int min_nodes_per_partition,
       std::vector<TfLiteDelegateParams> partition_params_array,
       std::vector<int>* nodes_to_delegate);
 
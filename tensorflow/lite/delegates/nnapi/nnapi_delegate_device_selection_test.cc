@@ -221,10 +221,12 @@ class AcceleratedModel {
  protected:
   // build a delegate with a target accelerator name.
   AcceleratedModel(const NnApi* nnapi, const std::string& accelerator_name,
-                   int max_nnapi_partitions = 0) {
+                   int max_nnapi_partitions = 0,
+                   int min_nodes_per_partition = 0) {
     StatefulNnApiDelegate::Options options;
     options.accelerator_name = accelerator_name.c_str();
     options.max_number_delegated_partitions = max_nnapi_partitions;
+    options.min_nodes_per_partition = min_nodes_per_partition;
     stateful_delegate_ =
         std::make_unique<StatefulNnApiDelegate>(nnapi, options);
   }
@@ -810,9 +812,10 @@ class LongIdentityModel : public MultiOpModel, public AcceleratedModel {
   LongIdentityModel(const std::vector<int>& input_shape, int graph_size,
                     const std::unordered_set<int>& custom_nodes_indexes,
                     const NnApi* nnapi, const std::string& accelerator_name,
-                    int max_nnapi_partitions)
+                    int max_nnapi_partitions, int min_nodes_per_partition = 0)
       : MultiOpModel(),
-        AcceleratedModel(nnapi, accelerator_name, max_nnapi_partitions) {
+        AcceleratedModel(nnapi, accelerator_name, max_nnapi_partitions,
+                         min_nodes_per_partition) {
     Init(input_shape, graph_size, custom_nodes_indexes);
   }
 
@@ -955,7 +958,7 @@ class DelegatePartitionLimitTest
   void Init(int max_nnapi_partitions,
             const std::vector<int>& nnapi_partition_sizes,
             const std::vector<int>& input_shape,
-            bool specify_accelerator = true) {
+            bool specify_accelerator = true, int min_nodes_per_partition = 0) {
     // The graph will have as number of nodes the sum of nodes in the NNAPI
     // partitions plus nnapi_partition_sizes.size() - 1 nodes that will be
     // not supported by NNAPI and will cause the
@@ -992,7 +995,8 @@ class DelegatePartitionLimitTest
           input_shape, graph_size_,
           /*custom_nodes_indexes=*/std::unordered_set<int>(),
           nnapi_mock_->GetNnApi(),
-          /*accelerator_name=*/"test-device", max_nnapi_partitions);
+          /*accelerator_name=*/"test-device", max_nnapi_partitions,
+          min_nodes_per_partition);
     } else {
       // Building a model containing custom nodes that won't be supported
       // by the delegate and generate the partitions.
@@ -1084,5 +1088,20 @@ TEST_F(DelegatePartitionLimitTest,
       OriginalGraphSize() - (kLargestModelSize + kSecondLargestModelSize));
 }
 
+TEST_F(DelegatePartitionLimitTest, ShouldNotDelegatePartitionsBelowMinSize) {
+  int kLargestModelSize = 5;
+  int kSecondLargestModelSize = 4;
+  Init(/*max_nnapi_partitions=*/0,
+       /*nnapi_partition_sizes=*/
+       {1, kLargestModelSize, 2, kSecondLargestModelSize},
+       /*input_shape=*/{1, 2, 2, 1}, /*specify_accelerator=*/true,
+       /*min_nodes_per_partition=*/3);
+
+  EXPECT_EQ(model_->CountNnApiPartitions(), 2);
+  EXPECT_EQ(
+      model_->CountOpsExecutedByCpuKernel(),
+      OriginalGraphSize() - (kLargestModelSize + kSecondLargestModelSize));
+}
+
 }  // namespace
 }  // namespace tflite
@@ -124,6 +124,95 @@ void UnaryElementwiseTester::Test(tflite::BuiltinOperator unary_op,
   }
 }
 
+void UnaryElementwiseTester::TestReshaping(tflite::BuiltinOperator unary_op,
+                                           TfLiteDelegate* delegate) const {
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto input_rng =
+      std::bind(std::uniform_real_distribution<float>(-15.0f, 15.0f),
+                std::ref(rng));
+
+  std::vector<char> buffer = CreateTfLiteModel(unary_op);
+  const Model* model = GetModel(buffer.data());
+
+  std::unique_ptr<Interpreter> delegate_interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          model,
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &delegate_interpreter),
+      kTfLiteOk);
+  std::unique_ptr<Interpreter> default_interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          model,
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &default_interpreter),
+      kTfLiteOk);
+
+  ASSERT_TRUE(delegate_interpreter);
+  ASSERT_TRUE(default_interpreter);
+
+  ASSERT_EQ(delegate_interpreter->AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(default_interpreter->AllocateTensors(), kTfLiteOk);
+
+  ASSERT_EQ(delegate_interpreter->ModifyGraphWithDelegate(delegate), kTfLiteOk);
+
+  std::vector<int32_t> larger_shape = Shape();
+  larger_shape.back() += 1;
+
+  // Resizing the input and back before allocating prepares the delegate
+  // again with the shape of its last reshape.
+  ASSERT_EQ(delegate_interpreter->ResizeInputTensor(
+                delegate_interpreter->inputs()[0], larger_shape),
+            kTfLiteOk);
+  ASSERT_EQ(delegate_interpreter->ResizeInputTensor(
+                delegate_interpreter->inputs()[0], Shape()),
+            kTfLiteOk);
+
+  for (const std::vector<int32_t>& shape : {Shape(), larger_shape}) {
+    ASSERT_EQ(delegate_interpreter->ResizeInputTensor(
+                  delegate_interpreter->inputs()[0], shape),
+              kTfLiteOk);
+    ASSERT_EQ(default_interpreter->ResizeInputTensor(
+                  default_interpreter->inputs()[0], shape),
+              kTfLiteOk);
+    ASSERT_EQ(delegate_interpreter->AllocateTensors(), kTfLiteOk);
+    ASSERT_EQ(default_interpreter->AllocateTensors(), kTfLiteOk);
+
+    const int32_t size = ComputeSize(shape);
+    float* default_input_data =
+        default_interpreter->typed_input_tensor<float>(0);
+    std::generate_n(default_input_data, size, std::ref(input_rng));
+
+    float* delegate_input_data =
+        delegate_interpreter->typed_input_tensor<float>(0);
+    std::copy_n(default_input_data, size, delegate_input_data);
+
+    ASSERT_EQ(default_interpreter->Invoke(), kTfLiteOk);
+    ASSERT_EQ(delegate_interpreter->Invoke(), kTfLiteOk);
+
+    const TfLiteTensor* delegate_output =
+        delegate_interpreter->tensor(delegate_interpreter->outputs()[0]);
+    ASSERT_EQ(std::vector<int32_t>(delegate_output->dims->data,
+                                   delegate_output->dims->data +
+                                       delegate_output->dims->size),
+              shape);
+
+    float* default_output_data =
+        default_interpreter->typed_output_tensor<float>(0);
+    float* delegate_output_data =
+        delegate_interpreter->typed_output_tensor<float>(0);
+    for (int32_t i = 0; i < size; i++) {
+      ASSERT_NEAR(
+          default_output_data[i], delegate_output_data[i],
+          std::numeric_limits<float>::epsilon() *
+              std::max(std::abs(default_output_data[i]) * RelativeTolerance(),
+                       1.0f));
+    }
+  }
+}
+
 std::vector<char> UnaryElementwiseTester::CreateTfLiteModel(
     tflite::BuiltinOperator unary_op) const {
   flatbuffers::FlatBufferBuilder builder;
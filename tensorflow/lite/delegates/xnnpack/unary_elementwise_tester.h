@@ -54,6 +54,12 @@ class UnaryElementwiseTester {
 
   void Test(tflite::BuiltinOperator unary_op, TfLiteDelegate* delegate) const;
 
+  // Tests `unary_op` when the interpreter prepares `delegate` again, first
+  // with an unchanged input shape and then with a larger one. `delegate` must
+  // enable subgraph reshaping.
+  void TestReshaping(tflite::BuiltinOperator unary_op,
+                     TfLiteDelegate* delegate) const;
+
  private:
   std::vector<char> CreateTfLiteModel(tflite::BuiltinOperator unary_op) const;
 
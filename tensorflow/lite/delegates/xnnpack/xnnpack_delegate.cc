@@ -1096,6 +1096,12 @@ class Subgraph {
   TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node,
                        bool enable_subgraph_reshaping) {
     if (enable_subgraph_reshaping) {
+      // The runtime keeps the shapes of its last reshape, so there is nothing
+      // to do when the interpreter prepares again with the same input shapes.
+      if (!InputShapesChanged(context)) {
+        return kTfLiteOk;
+      }
+      prepared_input_dims_.clear();
       xnn_status status = xnn_status_invalid_state;
       for (int i = 0; i < inputs_.size(); ++i) {
         const TfLiteTensor* tensor = &context->tensors[inputs_[i]];
@@ -1144,6 +1150,11 @@ class Subgraph {
           return kTfLiteError;
         }
       }
+      for (int i = 0; i < inputs_.size(); ++i) {
+        const TfLiteIntArray* dims = context->tensors[inputs_[i]].dims;
+        prepared_input_dims_.emplace_back(&dims->data[0],
+                                          &dims->data[dims->size]);
+      }
       return kTfLiteOk;
     } else {
       return kTfLiteOk;
@@ -6652,6 +6663,23 @@ class Subgraph {
   }
 
  private:
+  // Returns true if the shape of any input differs from its shape when the
+  // runtime was last reshaped, or if the runtime was never reshaped.
+  bool InputShapesChanged(const TfLiteContext* context) const {
+    if (prepared_input_dims_.size() != inputs_.size()) {
+      return true;
+    }
+    for (int i = 0; i < inputs_.size(); ++i) {
+      const TfLiteIntArray* dims = context->tensors[inputs_[i]].dims;
+      if (!std::equal(prepared_input_dims_[i].begin(),
+                      prepared_input_dims_[i].end(), &dims->data[0],
+                      &dims->data[dims->size])) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   Subgraph(const Delegate& delegate, xnn_runtime_t runtime,
            const std::unordered_set<int>& externals, std::vector<int>& inputs,
            std::vector<int>& outputs,
@@ -6692,6 +6720,8 @@ class Subgraph {
   bool has_variables_ = false;
   bool variables_set_up_ = false;
   bool enable_subgraph_reshaping_ = false;
+  // Shapes of the input tensors at the last successful reshape of the runtime.
+  std::vector<std::vector<int>> prepared_input_dims_;
 };
 
 TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
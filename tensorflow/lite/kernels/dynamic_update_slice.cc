@@ -16,6 +16,7 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
 #include "tensorflow/lite/core/c/c_api_types.h"
@@ -130,16 +131,26 @@ void DynamicUpdateSlice(const TfLiteTensor* input, const TfLiteTensor* update,
     return;
   }
 
+  if (input_dims == 0) {
+    output_data[0] = update_data[0];
+    return;
+  }
+
+  // Overwrites update to output one innermost row at a time, since the rows
+  // of the update are contiguous in both the update and the output. This
+  // keeps small updates of large tensors, such as a decoding step written to
+  // a KV cache, cheap.
+  const int row_size = update_shape.Dims(input_dims - 1);
   std::vector<int> current_dim(input_dims, 0);
-  // Overwrites update to output.
   do {
     int flat_update_index =
         TensorIndexToFlat(current_dim.data(), input_dims, update_shape);
     int flat_input_index =
         TensorIndexToFlat(current_dim.data(), input_dims, input_shape,
                           clamped_start_indices.data());
-    output_data[flat_input_index] = update_data[flat_update_index];
-  } while (NextIndex(input_dims,
+    memcpy(output_data + flat_input_index, update_data + flat_update_index,
+           row_size * sizeof(T));
+  } while (NextIndex(input_dims - 1,
                      reinterpret_cast<const int*>(update_shape.DimsData()),
                      current_dim.data()));
 }
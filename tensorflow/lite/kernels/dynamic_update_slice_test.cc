@@ -214,6 +214,22 @@ TEST(DynamicUpdateSliceOpTest, BoundaryTest) {
                                                7, -3, -4})));
 }
 
+TEST(DynamicUpdateSliceOpTest, MultiDimRowsTestF32) {
+  // Writes one step of a [heads, steps, depth] cache.
+  DynamicUpdateSliceOpModel m({TensorType_FLOAT32, {2, 3, 2}},
+                              {TensorType_FLOAT32, {2, 1, 2}},
+                              {TensorType_INT32, {3}});
+  m.SetInput<float>({1, 2, 3, 4, 5, 6,  //
+                     7, 8, 9, 10, 11, 12});
+  m.SetUpdate<float>({-1, -2,  //
+                      -3, -4});
+  m.SetStartIndices<int32_t>({0, 1, 0});
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  EXPECT_THAT(m.GetOutput<float>(),
+              ElementsAreArray(ArrayFloatNear({1, 2, -1, -2, 5, 6,  //
+                                               7, 8, -3, -4, 11, 12})));
+}
+
 TEST(DynamicUpdateSliceOpTest, UpdateShapeTooLargeTest) {
   EXPECT_DEATH_IF_SUPPORTED(
       DynamicUpdateSliceOpModel({TensorType_FLOAT32, {3, 3}},
@@ -25,7 +25,9 @@ limitations under the License.
 //   Output.dim[0] == Tensor[0].dim[0], num of lookups
 //   Output.dim[1] == Tensor[1].dim[1],  num of items per row
 //   Each item in output is a raw bytes copy of the corresponding item in input,
-//   or a dequantized value in the case of a uint8 input.
+//   or a dequantized value in the case of a uint8, int8 or int4 input.
+//   Int4 inputs are packed two values per byte, lower nibble first, and may
+//   have one scale per row.
 //   When indices are out of bound, the ops will not succeed.
 //
 
@@ -57,6 +59,16 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
   TfLiteTensor* output;
   TF_LITE_ENSURE_OK(context, GetOutputSafe(context, node, 0, &output));
+  if (value->type == kTfLiteInt4) {
+    TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteFloat32);
+    const auto* quantization =
+        static_cast<TfLiteAffineQuantization*>(value->quantization.params);
+    if (quantization != nullptr && quantization->scale->size > 1) {
+      TF_LITE_ENSURE_EQ(context, quantization->quantized_dimension, 0);
+      TF_LITE_ENSURE_EQ(context, quantization->scale->size,
+                        SizeOfDimension(value, 0));
+    }
+  }
   TfLiteIntArray* outputSize = TfLiteIntArrayCreate(NumDimensions(value));
 
   outputSize->data[0] = SizeOfDimension(lookup, 0);
@@ -135,6 +147,54 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+TfLiteStatus EvalHybridInt4(TfLiteContext* context, TfLiteNode* node,
+                            const TfLiteTensor* lookup,
+                            const TfLiteTensor* value, TfLiteTensor* output) {
+  const int row_size = SizeOfDimension(value, 0);
+  const auto* quantization =
+      static_cast<TfLiteAffineQuantization*>(value->quantization.params);
+  // Prepare checked that there is either one scale or one scale per row.
+  const float* row_scales = nullptr;
+  if (quantization != nullptr && quantization->scale->size > 1) {
+    row_scales = quantization->scale->data;
+  }
+
+  // col_size after we flatten tensor into 2D.
+  int col_size = 1;
+  for (int i = 1; i < NumDimensions(value); i++) {
+    col_size *= SizeOfDimension(value, i);
+  }
+
+  float* output_ptr = GetTensorData<float>(output);
+  const int8_t* value_ptr = GetTensorData<int8_t>(value);
+  const int32_t* lookup_data = GetTensorData<int32_t>(lookup);
+
+  for (int i = 0; i < SizeOfDimension(lookup, 0); i++) {
+    int idx = lookup_data[i];
+    if (idx >= row_size || idx < 0) {
+      TF_LITE_KERNEL_LOG(context,
+                         "Embedding Lookup: index out of bounds. "
+                         "Got %d, and bounds are [0, %d]",
+                         idx, row_size - 1);
+      return kTfLiteError;
+    }
+    const float scaling_factor =
+        row_scales != nullptr ? row_scales[idx] : value->params.scale;
+    // Rows start at a nibble rather than a byte boundary when col_size is odd.
+    const int row_start = idx * col_size;
+    for (int j = 0; j < col_size; j++) {
+      const int element = row_start + j;
+      const int8_t byte = value_ptr[element / 2];
+      // Shift left first so that the sign of the lower nibble is extended.
+      const int8_t q = element % 2 == 0 ? static_cast<int8_t>(byte << 4) >> 4
+                                        : byte >> 4;
+      output_ptr[j + i * col_size] = q * scaling_factor;
+    }
+  }
+
+  return kTfLiteOk;
+}
+
 TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteTensor* lookup;
   TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, 0, &lookup));
@@ -152,6 +212,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       } else {
         return EvalSimple(context, node, lookup, value, output);
       }
+    case kTfLiteInt4:
+      return EvalHybridInt4(context, node, lookup, value, output);
     default:
       TF_LITE_KERNEL_LOG(context, "Type not currently supported.");
       return kTfLiteError;
@@ -49,6 +49,15 @@ class BaseEmbeddingLookupOpModel : public SingleOpModel {
     BuildInterpreter({index_shape, weight_shape});
   }
 
+  BaseEmbeddingLookupOpModel(std::initializer_list<int> index_shape,
+                             const TensorData& weight) {
+    input_ = AddInput(TensorType_INT32);
+    weight_ = AddInput(weight);
+    output_ = AddOutput(TensorType_FLOAT32);
+    SetBuiltinOp(BuiltinOperator_EMBEDDING_LOOKUP, BuiltinOptions_NONE, 0);
+    BuildInterpreter({index_shape, weight.shape});
+  }
+
   void SetInput(std::initializer_list<int> data) {
     PopulateTensor(input_, data);
   }
@@ -101,6 +110,19 @@ class HybridEmbeddingLookupOpModel : public BaseEmbeddingLookupOpModel {
   }
 };
 
+class Int4EmbeddingLookupOpModel : public BaseEmbeddingLookupOpModel {
+ public:
+  using BaseEmbeddingLookupOpModel::BaseEmbeddingLookupOpModel;
+
+  void SetWeight(const std::vector<float>& data) {
+    SignedSymmetricQuantizeAndPopulate4Bit(weight_, data);
+  }
+
+  void SetPerRowWeight(const std::vector<float>& data) {
+    PerChannelSymmetricQuantizeAndPopulate(weight_, data);
+  }
+};
+
 // TODO(ahentz): write more tests that exercise the details of the op, such as
 // lookup errors and variable input shapes.
 TEST(EmbeddingLookupOpTest, SimpleTest) {
@@ -119,7 +141,7 @@ TEST(EmbeddingLookupOpTest, SimpleTest) {
               })));
 }
 
-TEST(HybridEmbeddingLookupHybridOpTest, Simple2DTestUint8) {
+TEST(EmbeddingLookupHybridOpTest, Simple2DTestUint8) {
   HybridEmbeddingLookupOpModel m({3}, {3, 8}, TensorType_UINT8);
   m.SetInput({1, 0, 2});
   m.SetWeight({
@@ -140,7 +162,7 @@ TEST(HybridEmbeddingLookupHybridOpTest, Simple2DTestUint8) {
                   kTestTolerance)));
 }
 
-TEST(HybridEmbeddingLookupHybridOpTest, Simple3DTestUint8) {
+TEST(EmbeddingLookupHybridOpTest, Simple3DTestUint8) {
   HybridEmbeddingLookupOpModel m({3}, {3, 2, 4}, TensorType_UINT8);
   m.SetInput({1, 0, 2});
   m.SetWeight({
@@ -161,7 +183,7 @@ TEST(HybridEmbeddingLookupHybridOpTest, Simple3DTestUint8) {
                   kTestTolerance)));
 }
 
-TEST(HybridEmbeddingLookupHybridOpTest, Simple4DTestUint8) {
+TEST(EmbeddingLookupHybridOpTest, Simple4DTestUint8) {
   HybridEmbeddingLookupOpModel m({3}, {3, 2, 2, 2}, TensorType_UINT8);
   m.SetInput({1, 0, 2});
   m.SetWeight({
@@ -182,7 +204,7 @@ TEST(HybridEmbeddingLookupHybridOpTest, Simple4DTestUint8) {
                   kTestTolerance)));
 }
 
-TEST(HybridEmbeddingLookupHybridOpTest, Simple2DTestInt8) {
+TEST(EmbeddingLookupHybridOpTest, Simple2DTestInt8) {
   HybridEmbeddingLookupOpModel m({3}, {3, 8}, TensorType_INT8);
   m.SetInput({1, 0, 2});
   m.SetSignedWeight({
@@ -203,7 +225,7 @@ TEST(HybridEmbeddingLookupHybridOpTest, Simple2DTestInt8) {
                   kTestTolerance)));
 }
 
-TEST(HybridEmbeddingLookupHybridOpTest, Simple3DTestInt8) {
+TEST(EmbeddingLookupHybridOpTest, Simple3DTestInt8) {
   HybridEmbeddingLookupOpModel m({3}, {3, 2, 4}, TensorType_INT8);
   m.SetInput({1, 0, 2});
   m.SetSignedWeight({
@@ -224,7 +246,7 @@ TEST(HybridEmbeddingLookupHybridOpTest, Simple3DTestInt8) {
                   kTestTolerance)));
 }
 
-TEST(HybridEmbeddingLookupHybridOpTest, Simple4DTestInt8) {
+TEST(EmbeddingLookupHybridOpTest, Simple4DTestInt8) {
   HybridEmbeddingLookupOpModel m({3}, {3, 2, 2, 2}, TensorType_INT8);
   m.SetInput({1, 0, 2});
   m.SetSignedWeight({
@@ -261,5 +283,53 @@ TEST(EmbeddingLookupHybridOpTest, Simple3DTestQuantized) {
               }));
 }
 
+TEST(EmbeddingLookupInt4OpTest, Simple2DTestInt4) {
+  // Rows of three values do not start at byte boundaries.
+  Int4EmbeddingLookupOpModel m(
+      {3}, {TensorType_INT4, {3, 3}, 0.0, 0.0, /*scale=*/0.5});
+  m.SetInput({2, 0, 1});
+  m.SetWeight({
+      0.5, -1.0, 1.5,   // Row 0
+      -2.0, 2.5, -3.0,  // Row 1
+      3.5, 0.0, -0.5,   // Row 2
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput<float>(), ElementsAreArray(ArrayFloatNear({
+                                        3.5, 0.0, -0.5,   // Row 2
+                                        0.5, -1.0, 1.5,   // Row 0
+                                        -2.0, 2.5, -3.0,  // Row 1
+                                    })));
+}
+
+TEST(EmbeddingLookupInt4OpTest, PerRowScalesTestInt4) {
+  Int4EmbeddingLookupOpModel m(
+      {3}, {TensorType_INT4,
+            {3, 2},
+            0.0,
+            0.0,
+            0.0,
+            0,
+            /*per_channel_quantization=*/true,
+            /*per_channel_quantization_scales=*/{0.5, 1.0, 2.0},
+            /*per_channel_quantization_offsets=*/{0, 0, 0},
+            /*channel_index=*/0});
+  m.SetInput({1, 2, 0});
+  m.SetPerRowWeight({
+      0.5, -1.5,  // Row 0
+      3.0, -4.0,  // Row 1
+      8.0, -14.0  // Row 2
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput<float>(), ElementsAreArray(ArrayFloatNear({
+                                        3.0, -4.0,   // Row 1
+                                        8.0, -14.0,  // Row 2
+                                        0.5, -1.5,   // Row 0
+                                    })));
+}
+
 }  // namespace
 }  // namespace tflite
@@ -19,10 +19,13 @@ limitations under the License.
 #include <unistd.h>
 #endif  // __linux__
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "tensorflow/lite/profiling/memory_info.h"
 #include "tensorflow/lite/profiling/time.h"
@@ -34,6 +37,7 @@ namespace benchmark {
 using tensorflow::Stat;
 
 constexpr int kMemoryCheckIntervalMs = 50;
+constexpr int kDeviceStateCheckIntervalMs = 100;
 
 #ifdef __linux__
 void GetRssStats(size_t* vsize, size_t* rss, size_t* shared, size_t* code) {
@@ -52,6 +56,38 @@ void GetRssStats(size_t* vsize, size_t* rss, size_t* shared, size_t* code) {
 }
 #endif  // __linux__
 
+namespace {
+
+std::string JoinValues(const std::vector<int64_t>& values) {
+  std::stringstream stream;
+  for (size_t i = 0; i < values.size(); ++i) {
+    stream << (i == 0 ? "" : ", ") << values[i];
+  }
+  return stream.str();
+}
+
+// Logs the CPU frequencies and the thermal zone temperatures of the device at
+// the given point of the benchmark.
+void LogDeviceState(const std::vector<int>& cpus, const std::string& point) {
+  const std::vector<int64_t> cpu_freqs_khz = util::GetCpuFrequenciesKhz(cpus);
+  if (std::all_of(cpu_freqs_khz.begin(), cpu_freqs_khz.end(),
+                  [](int64_t freq_khz) { return freq_khz == 0; })) {
+    TFLITE_LOG(WARN) << "CPU frequencies are not available.";
+  } else {
+    TFLITE_LOG(INFO) << "CPU frequencies (kHz) at the " << point
+                     << " of the benchmark: [" << JoinValues(cpu_freqs_khz)
+                     << "]";
+  }
+  const std::vector<int64_t> temperatures = util::GetThermalZoneTemperatures();
+  if (!temperatures.empty()) {
+    TFLITE_LOG(INFO) << "Thermal zone temperatures (millidegree Celsius) at "
+                     << "the " << point << " of the benchmark: ["
+                     << JoinValues(temperatures) << "]";
+  }
+}
+
+}  // namespace
+
 BenchmarkParams BenchmarkModel::DefaultParams() {
   BenchmarkParams params;
   params.AddParam("num_runs", BenchmarkParam::Create<int32_t>(50));
@@ -71,6 +107,7 @@ BenchmarkParams BenchmarkModel::DefaultParams() {
                   BenchmarkParam::Create<bool>(false));
   params.AddParam("memory_footprint_check_interval_ms",
                   BenchmarkParam::Create<int32_t>(kMemoryCheckIntervalMs));
+  params.AddParam("report_device_state", BenchmarkParam::Create<bool>(false));
   return params;
 }
 
@@ -171,7 +208,13 @@ std::vector<Flag> BenchmarkModel::GetFlags() {
       CreateFlag<int32_t>("memory_footprint_check_interval_ms", &params_,
                           "The interval in millisecond between two consecutive "
                           "memory footprint checks. This is only used when "
-                          "--report_peak_memory_footprint is set to true.")};
+                          "--report_peak_memory_footprint is set to true."),
+      CreateFlag<bool>(
+          "report_device_state", &params_,
+          "Report the CPU frequencies and the thermal zone temperatures of the "
+          "device before and after the benchmark, and warn if the CPU "
+          "frequencies sampled during the runs fell below their maximum, "
+          "which suggests thermal throttling.")};
 }
 
 void BenchmarkModel::LogParams() {
@@ -198,6 +241,8 @@ void BenchmarkModel::LogParams() {
                       "Report the peak memory footprint", verbose);
   LOG_BENCHMARK_PARAM(int32_t, "memory_footprint_check_interval_ms",
                       "Memory footprint check interval (ms)", verbose);
+  LOG_BENCHMARK_PARAM(bool, "report_device_state",
+                      "Report CPU frequencies and temperatures", verbose);
 }
 
 TfLiteStatus BenchmarkModel::PrepareInputData() { return kTfLiteOk; }
@@ -313,6 +358,17 @@ TfLiteStatus BenchmarkModel::Run() {
     params_.Set("min_secs", -1.0f);
   }
 
+  const bool report_device_state = params_.Get<bool>("report_device_state");
+  const std::vector<int> cpus =
+      report_device_state ? util::GetPresentCpus() : std::vector<int>();
+  std::unique_ptr<util::CpuFrequencyMonitor> cpu_frequency_monitor;
+  if (report_device_state) {
+    LogDeviceState(cpus, "start");
+    cpu_frequency_monitor = std::make_unique<util::CpuFrequencyMonitor>(
+        cpus, kDeviceStateCheckIntervalMs);
+    cpu_frequency_monitor->Start();
+  }
+
   listeners_.OnBenchmarkStart(params_);
   Stat<int64_t> warmup_time_us =
       Run(params_.Get<int32_t>("warmup_runs"),
@@ -328,6 +384,21 @@ TfLiteStatus BenchmarkModel::Run() {
   const auto overall_mem_usage =
       profiling::memory::GetMemoryUsage() - start_mem_usage;
 
+  if (report_device_state) {
+    cpu_frequency_monitor->Stop();
+    LogDeviceState(cpus, "end");
+    const double ratio = cpu_frequency_monitor->lowest_peak_frequency_ratio();
+    if (ratio >= 0) {
+      TFLITE_LOG(INFO) << "Lowest sampled frequency of the fastest CPU: "
+                       << ratio * 100 << "% of its maximum.";
+      if (ratio < 0.9) {
+        TFLITE_LOG(WARN) << "The CPUs ran below 90% of their maximum frequency "
+                            "during the benchmark. The results may be affected "
+                            "by thermal throttling.";
+      }
+    }
+  }
+
   float peak_mem_mb = profiling::memory::MemoryUsageMonitor::kInvalidMemUsageMB;
   if (peak_memory_reporter != nullptr) {
     peak_memory_reporter->Stop();
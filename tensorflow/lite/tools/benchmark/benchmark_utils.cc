@@ -15,11 +15,56 @@ limitations under the License.
 
 #include "tensorflow/lite/tools/benchmark/benchmark_utils.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
 #include "tensorflow/lite/profiling/time.h"
 
 namespace tflite {
 namespace benchmark {
 namespace util {
+namespace {
+
+// Reads the integer of each file 'prefix' + i + 'suffix' for i = 0, 1, ... up
+// to the first file that can't be read.
+std::vector<int64_t> ReadIndexedValues(const std::string& prefix,
+                                       const std::string& suffix) {
+  std::vector<int64_t> values;
+  for (int i = 0;; ++i) {
+    std::ifstream file(prefix + std::to_string(i) + suffix);
+    int64_t value;
+    if (!(file >> value)) break;
+    values.push_back(value);
+  }
+  return values;
+}
+
+// Reads the cpufreq file 'name' of each CPU in 'cpus', or 0 if it can't be
+// read.
+std::vector<int64_t> ReadCpuValues(const std::vector<int>& cpus,
+                                   const std::string& sysfs_root,
+                                   const std::string& name) {
+  std::vector<int64_t> values;
+  values.reserve(cpus.size());
+  for (int cpu : cpus) {
+    std::ifstream file(sysfs_root + "/devices/system/cpu/cpu" +
+                       std::to_string(cpu) + "/cpufreq/" + name);
+    int64_t value;
+    values.push_back(file >> value ? value : 0);
+  }
+  return values;
+}
+
+}  // namespace
 
 void SleepForSeconds(double sleep_seconds) {
   if (sleep_seconds <= 0.0) {
@@ -32,6 +77,85 @@ void SleepForSeconds(double sleep_seconds) {
       static_cast<uint64_t>(sleep_seconds * 1e6));
 }
 
+std::vector<int> GetPresentCpus(const std::string& sysfs_root) {
+  std::vector<int> cpus;
+  std::ifstream file(sysfs_root + "/devices/system/cpu/present");
+  std::string ranges;
+  if (!std::getline(file, ranges)) return cpus;
+  std::istringstream input(ranges);
+  for (std::string range; std::getline(input, range, ',');) {
+    int first, last;
+    char dash;
+    std::istringstream to_parse(range);
+    if (!(to_parse >> first)) return {};
+    if (to_parse >> dash) {
+      if (dash != '-' || !(to_parse >> last) || last < first) return {};
+    } else {
+      last = first;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+std::vector<int64_t> GetCpuFrequenciesKhz(const std::vector<int>& cpus,
+                                          const std::string& sysfs_root) {
+  return ReadCpuValues(cpus, sysfs_root, "scaling_cur_freq");
+}
+
+std::vector<int64_t> GetMaxCpuFrequenciesKhz(const std::vector<int>& cpus,
+                                             const std::string& sysfs_root) {
+  return ReadCpuValues(cpus, sysfs_root, "cpuinfo_max_freq");
+}
+
+std::vector<int64_t> GetThermalZoneTemperatures(const std::string& sysfs_root) {
+  return ReadIndexedValues(sysfs_root + "/class/thermal/thermal_zone", "/temp");
+}
+
+CpuFrequencyMonitor::CpuFrequencyMonitor(std::vector<int> cpus,
+                                         int sampling_interval_ms,
+                                         const std::string& sysfs_root)
+    : cpus_(std::move(cpus)),
+      sysfs_root_(sysfs_root),
+      max_freqs_khz_(GetMaxCpuFrequenciesKhz(cpus_, sysfs_root_)),
+      sampling_interval_(absl::Milliseconds(sampling_interval_ms)) {}
+
+void CpuFrequencyMonitor::Start() {
+  if (sampling_thread_ != nullptr) return;
+  stop_signal_ = std::make_unique<absl::Notification>();
+  sampling_thread_ = std::make_unique<std::thread>([this]() {
+    while (true) {
+      const double ratio = SamplePeakFrequencyRatio();
+      if (ratio >= 0 && (lowest_ratio_ < 0 || ratio < lowest_ratio_)) {
+        lowest_ratio_ = ratio;
+      }
+      if (stop_signal_->WaitForNotificationWithTimeout(sampling_interval_)) {
+        break;
+      }
+    }
+  });
+}
+
+void CpuFrequencyMonitor::Stop() {
+  if (sampling_thread_ == nullptr) return;
+  stop_signal_->Notify();
+  sampling_thread_->join();
+  sampling_thread_.reset();
+  stop_signal_.reset();
+}
+
+double CpuFrequencyMonitor::SamplePeakFrequencyRatio() const {
+  const std::vector<int64_t> freqs_khz =
+      GetCpuFrequenciesKhz(cpus_, sysfs_root_);
+  double peak_ratio = -1;
+  for (size_t i = 0; i < cpus_.size(); ++i) {
+    if (freqs_khz[i] <= 0 || max_freqs_khz_[i] <= 0) continue;
+    peak_ratio = std::max(
+        peak_ratio, static_cast<double>(freqs_khz[i]) / max_freqs_khz_[i]);
+  }
+  return peak_ratio;
+}
+
 }  // namespace util
 }  // namespace benchmark
 }  // namespace tflite
@@ -16,10 +16,16 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_UTILS_H_
 #define TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_UTILS_H_
 
+#include <cstdint>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+
 namespace tflite {
 namespace benchmark {
 namespace util {
@@ -28,6 +34,56 @@ namespace util {
 // simply return if 'sleep_seconds' is negative.
 void SleepForSeconds(double sleep_seconds);
 
+// Returns the CPUs listed in 'sysfs_root'/devices/system/cpu/present, e.g.
+// {0, 1, 2, 3, 6} for "0-3,6", or an empty list if it can't be read.
+std::vector<int> GetPresentCpus(const std::string& sysfs_root = "/sys");
+
+// Returns the current frequency in kHz of each CPU in 'cpus', or 0 for the CPUs
+// whose frequency isn't reported under 'sysfs_root', e.g. because they are
+// offline or the kernel has no cpufreq support.
+std::vector<int64_t> GetCpuFrequenciesKhz(
+    const std::vector<int>& cpus, const std::string& sysfs_root = "/sys");
+
+// Returns the maximum frequency in kHz of each CPU in 'cpus', or 0 for the CPUs
+// whose maximum frequency isn't reported under 'sysfs_root'.
+std::vector<int64_t> GetMaxCpuFrequenciesKhz(
+    const std::vector<int>& cpus, const std::string& sysfs_root = "/sys");
+
+// Returns the temperature in millidegrees Celsius of thermal zone 0, 1, ... up
+// to the first zone that isn't reported under 'sysfs_root'.
+std::vector<int64_t> GetThermalZoneTemperatures(
+    const std::string& sysfs_root = "/sys");
+
+// Samples the CPU frequencies on a separate thread while the benchmark runs.
+// The CPUs running the benchmark should stay close to their maximum
+// frequency, so each sample records the highest ratio of a CPU's current
+// frequency to its cpuinfo_max_freq, and the monitor keeps the lowest such
+// ratio over the run.
+class CpuFrequencyMonitor {
+ public:
+  CpuFrequencyMonitor(std::vector<int> cpus, int sampling_interval_ms,
+                      const std::string& sysfs_root = "/sys");
+  ~CpuFrequencyMonitor() { Stop(); }
+
+  void Start();
+  void Stop();
+
+  // Returns the lowest sampled ratio, or a negative value if the frequencies
+  // couldn't be read. Only valid once the monitor is stopped.
+  double lowest_peak_frequency_ratio() const { return lowest_ratio_; }
+
+ private:
+  double SamplePeakFrequencyRatio() const;
+
+  const std::vector<int> cpus_;
+  const std::string sysfs_root_;
+  const std::vector<int64_t> max_freqs_khz_;
+  const absl::Duration sampling_interval_;
+  std::unique_ptr<absl::Notification> stop_signal_;
+  std::unique_ptr<std::thread> sampling_thread_;
+  double lowest_ratio_ = -1;
+};
+
 // Split the 'str' according to 'delim', and store each splitted element into
 // 'values'.
 template <typename T>
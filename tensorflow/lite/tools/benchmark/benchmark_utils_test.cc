@@ -14,6 +14,14 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/tools/benchmark/benchmark_utils.h"
 
+#ifdef __linux__
+#include <sys/stat.h>
+#endif  // __linux__
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -75,6 +83,96 @@ TEST(BenchmarkHelpersTest, SplitAndParseInts) {
   EXPECT_EQ(2, results[1]);
 }
 
+TEST(BenchmarkHelpersTest, GetDeviceStateWithoutSysfs) {
+  EXPECT_TRUE(util::GetPresentCpus("/nonexistent").empty());
+  EXPECT_THAT(util::GetCpuFrequenciesKhz({0, 1}, "/nonexistent"),
+              ::testing::ElementsAre(0, 0));
+  EXPECT_TRUE(util::GetThermalZoneTemperatures("/nonexistent").empty());
+
+  util::CpuFrequencyMonitor monitor({0, 1}, /*sampling_interval_ms=*/1,
+                                    "/nonexistent");
+  monitor.Start();
+  tflite::profiling::time::SleepForMicros(10000);
+  monitor.Stop();
+  EXPECT_LT(monitor.lowest_peak_frequency_ratio(), 0);
+}
+
+#ifdef __linux__
+// Writes 'value' to 'sysfs_root'/'dir'/'file', creating the directories.
+template <typename T>
+void WriteSysfsValue(const std::string& sysfs_root, const std::string& dir,
+                     const std::string& file, const T& value) {
+  std::string path = sysfs_root;
+  std::istringstream components(dir);
+  for (std::string component; std::getline(components, component, '/');) {
+    path += "/" + component;
+    mkdir(path.c_str(), 0755);
+  }
+  std::ofstream(path + "/" + file) << value << "\n";
+}
+
+TEST(BenchmarkHelpersTest, GetDeviceStateFromSysfs) {
+  const std::string sysfs_root = ::testing::TempDir() + "/fake_sysfs";
+  mkdir(sysfs_root.c_str(), 0755);
+  WriteSysfsValue(sysfs_root, "devices/system/cpu", "present",
+                  std::string("0-1,3"));
+  WriteSysfsValue(sysfs_root, "devices/system/cpu/cpu0/cpufreq",
+                  "scaling_cur_freq", 1800000);
+  WriteSysfsValue(sysfs_root, "devices/system/cpu/cpu0/cpufreq",
+                  "cpuinfo_max_freq", 2000000);
+  // CPU 1 is offline, so it has no frequency.
+  WriteSysfsValue(sysfs_root, "devices/system/cpu/cpu3/cpufreq",
+                  "scaling_cur_freq", 2400000);
+  WriteSysfsValue(sysfs_root, "devices/system/cpu/cpu3/cpufreq",
+                  "cpuinfo_max_freq", 2800000);
+  WriteSysfsValue(sysfs_root, "class/thermal/thermal_zone0", "temp", 41000);
+
+  const std::vector<int> cpus = util::GetPresentCpus(sysfs_root);
+  EXPECT_THAT(cpus, ::testing::ElementsAre(0, 1, 3));
+  EXPECT_THAT(util::GetCpuFrequenciesKhz(cpus, sysfs_root),
+              ::testing::ElementsAre(1800000, 0, 2400000));
+  EXPECT_THAT(util::GetMaxCpuFrequenciesKhz(cpus, sysfs_root),
+              ::testing::ElementsAre(2000000, 0, 2800000));
+  EXPECT_THAT(util::GetThermalZoneTemperatures(sysfs_root),
+              ::testing::ElementsAre(41000));
+}
+
+// Replaces the current frequency of 'cpu' at once, so that the monitor never
+// reads a partially written file.
+void SetCpuFrequencyKhz(const std::string& sysfs_root, int cpu,
+                        int64_t freq_khz) {
+  const std::string dir =
+      "devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq";
+  WriteSysfsValue(sysfs_root, dir, "scaling_cur_freq.tmp", freq_khz);
+  std::rename((sysfs_root + "/" + dir + "/scaling_cur_freq.tmp").c_str(),
+              (sysfs_root + "/" + dir + "/scaling_cur_freq").c_str());
+}
+
+TEST(BenchmarkHelpersTest, CpuFrequencyMonitorKeepsLowestPeakRatio) {
+  const std::string sysfs_root = ::testing::TempDir() + "/monitored_sysfs";
+  mkdir(sysfs_root.c_str(), 0755);
+  WriteSysfsValue(sysfs_root, "devices/system/cpu/cpu0/cpufreq",
+                  "cpuinfo_max_freq", 2000000);
+  WriteSysfsValue(sysfs_root, "devices/system/cpu/cpu1/cpufreq",
+                  "cpuinfo_max_freq", 1000000);
+  SetCpuFrequencyKhz(sysfs_root, 0, 2000000);
+  SetCpuFrequencyKhz(sysfs_root, 1, 500000);
+
+  util::CpuFrequencyMonitor monitor({0, 1}, /*sampling_interval_ms=*/1,
+                                    sysfs_root);
+  monitor.Start();
+  tflite::profiling::time::SleepForMicros(50000);
+  // CPU 0 throttles to 60% of its maximum, which is still above the 50% of
+  // CPU 1, so the peak ratio drops to 0.6.
+  SetCpuFrequencyKhz(sysfs_root, 0, 1200000);
+  tflite::profiling::time::SleepForMicros(50000);
+  SetCpuFrequencyKhz(sysfs_root, 0, 2000000);
+  tflite::profiling::time::SleepForMicros(50000);
+  monitor.Stop();
+  EXPECT_DOUBLE_EQ(monitor.lowest_peak_frequency_ratio(), 0.6);
+}
+#endif  // __linux__
+
 }  // namespace
 }  // namespace benchmark
 }  // namespace tflite
@@ -620,6 +620,70 @@ TfLiteStatus SymmetricQuantizeTensorPerChannel(ModelT* model, TensorT* tensor,
                                model, tensor, error_reporter);
 }
 
+TfLiteStatus SymmetricQuantizeTensorPerChannelInt4(
+    ModelT* model, TensorT* tensor, int32_t channel_dim_index,
+    ErrorReporter* error_reporter) {
+  if (tensor->shape.size() > kPerChannelMaxDim) {
+    TF_LITE_REPORT_ERROR(
+        error_reporter,
+        "SymmetricQuantizeTensorPerChannelInt4 requires tensor with less than "
+        "%d dimensions, but got %d dimension(s).",
+        kPerChannelMaxDim + 1, tensor->shape.size());
+    return kTfLiteError;
+  }
+
+  // Get dimensions.
+  uint64_t num_elements;
+  TF_LITE_ENSURE_STATUS(NumElements(*tensor, &num_elements));
+  const int32_t channel_dim_size = tensor->shape[channel_dim_index];
+
+  // Get input float data.
+  const BufferT* buffer = model->buffers[tensor->buffer].get();
+  const float* float_input_data =
+      reinterpret_cast<const float*>(buffer->data.data());
+
+  // Fill per channel max and min values if needed.
+  if (tensor->quantization == nullptr) {
+    tensor->quantization = std::make_unique<QuantizationParametersT>();
+  }
+  if (!HasMinMax(tensor)) {
+    TF_LITE_ENSURE_STATUS(FillPerChannelMinMax(
+        float_input_data, tensor->shape, channel_dim_index,
+        tensor->quantization.get(), error_reporter));
+  }
+
+  // Calculate scales per channel using max and min values from tensor.
+  std::vector<float> scales(channel_dim_size);
+  std::vector<float> scale_invs(channel_dim_size);
+  const float half_scale = kMaxQuantizedValue4bit;
+  for (int channel_idx = 0; channel_idx < channel_dim_size; channel_idx++) {
+    const float half_range =
+        std::max(std::abs(tensor->quantization->min[channel_idx]),
+                 std::abs(tensor->quantization->max[channel_idx]));
+    scales[channel_idx] = half_range / half_scale;
+    scale_invs[channel_idx] = half_range == 0 ? 0 : half_scale / half_range;
+  }
+
+  // Quantize the input data with respect to channel_dim_index.
+  std::vector<int8_t> quantized_values(num_elements);
+  SymmetricPerChannelQuantizeValues(float_input_data, scale_invs,
+                                    tensor->shape, channel_dim_index,
+                                    &quantized_values, kTfLiteInt4);
+
+  // Pack two values per byte, lower nibble first.
+  std::vector<uint8_t> packed_buffer((num_elements + 1) / 2, 0);
+  for (uint64_t i = 0; i < num_elements; ++i) {
+    const uint8_t nibble = static_cast<uint8_t>(quantized_values[i]) & 0x0F;
+    packed_buffer[i / 2] |= i % 2 == 0 ? nibble : nibble << 4;
+  }
+
+  // Set the buffers and output type.
+  std::vector<int64_t> zero_point(scales.size(), 0);
+  return AddQuantizationParams(scales, zero_point, channel_dim_index,
+                               packed_buffer.data(), packed_buffer.size(),
+                               TensorType_INT4, model, tensor, error_reporter);
+}
+
 template <class BiasType>
 std::vector<BiasType> SymmetricBiasQuantize(const float* data,
                                             uint64_t num_elements,
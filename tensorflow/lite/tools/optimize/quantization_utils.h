@@ -109,6 +109,12 @@ TfLiteStatus SymmetricQuantizeTensorPerChannel(ModelT* model, TensorT* tensor,
                                                int32_t channel_dim_index,
                                                ErrorReporter* error_reporter);
 
+// Quantizes tensor to int4 with per channel scales. The values are densely
+// packed, two per byte with the lower nibble first.
+TfLiteStatus SymmetricQuantizeTensorPerChannelInt4(
+    ModelT* model, TensorT* tensor, int32_t channel_dim_index,
+    ErrorReporter* error_reporter);
+
 // Symmetrically quantizes float to 16bits.
 TfLiteStatus SymmetricQuantizeFloatsToInt16(ModelT* model, TensorT* tensor,
                                             float scaling_factor,
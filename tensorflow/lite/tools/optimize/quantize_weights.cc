@@ -50,6 +50,7 @@ struct TensorPerChannel {
   TensorT* t;
   bool is_per_channel;
   int channel_dim;
+  bool is_int4 = false;
 };
 
 // The default minimum number of elements a weights array must have to be
@@ -205,13 +206,34 @@ bool CheckAllOpInputsQuantized(const SubGraphT* subgraph, const OperatorT* op,
   return true;
 }
 
+// Returns true if the tensor can be quantized to int4, i.e. it is only used as
+// the value table of EMBEDDING_LOOKUP ops, and it is not a subgraph output.
+bool IsInt4EmbeddingTable(const ModelT* model, const SubGraphT* subgraph,
+                          int32_t tensor_idx) {
+  if (std::find(subgraph->outputs.begin(), subgraph->outputs.end(),
+                tensor_idx) != subgraph->outputs.end()) {
+    return false;
+  }
+  for (const ConsumerOpInfo& consumer :
+       GetTensorConsumers(model, subgraph, tensor_idx)) {
+    if (GetBuiltinCode(
+            model->operator_codes[consumer.op->opcode_index].get()) !=
+            BuiltinOperator_EMBEDDING_LOOKUP ||
+        consumer.op_input_idx != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Inserts Tensors for each input tensor of op that should be
 // quantized into tensor_map.
 TfLiteStatus InsertQuantizableInputTensorsFromOperator(
     const ModelT* model, OperatorT* op, uint64_t weights_min_num_elements,
     const CustomOpMap& custom_op_map,
     absl::flat_hash_map<int32_t, TensorPerChannel>* tensor_map,
-    int subgraph_index, bool use_updated_hybrid_scheme) {
+    int subgraph_index, bool use_updated_hybrid_scheme,
+    bool int4_embedding_tables) {
   SubGraphT* subgraph = model->subgraphs.at(subgraph_index).get();
   const OperatorCodeT* op_code = model->operator_codes[op->opcode_index].get();
   auto builtin_code = GetBuiltinCode(op_code);
@@ -250,7 +272,13 @@ TfLiteStatus InsertQuantizableInputTensorsFromOperator(
       continue;
     }
 
-    if (builtin_code == BuiltinOperator_DEPTHWISE_CONV_2D) {
+    if (int4_embedding_tables &&
+        builtin_code == BuiltinOperator_EMBEDDING_LOOKUP &&
+        IsInt4EmbeddingTable(model, subgraph, tensor_idx)) {
+      tensor_map->insert({tensor_idx,
+                          {tensor, /*is_per_channel=*/true, /*dim=*/0,
+                           /*is_int4=*/true}});
+    } else if (builtin_code == BuiltinOperator_DEPTHWISE_CONV_2D) {
       tensor_map->insert({tensor_idx,
                           {tensor, /*is_per_channel=*/use_updated_hybrid_scheme,
                            /*dim=*/3}});
@@ -392,13 +420,17 @@ inline bool IsOpDenylisted(const flat_hash_set<BuiltinOperator>& op_denylist,
   return op_denylist.find(op_code) != op_denylist.end();
 }
 
+// If int4_embedding_tables is true, the value tables of EMBEDDING_LOOKUP ops
+// are quantized to int4 instead of int8.
 TfLiteStatus QuantizeWeightsInt8(
     flatbuffers::FlatBufferBuilder* builder, const Model* input_model,
     bool use_hybrid_evaluation, uint64_t weights_min_num_elements,
     const CustomOpMap& custom_op_map, bool use_updated_hybrid_scheme,
-    const flat_hash_set<BuiltinOperator>& op_denylist = {}) {
+    const flat_hash_set<BuiltinOperator>& op_denylist = {},
+    bool int4_embedding_tables = false) {
   std::unique_ptr<ModelT> model;
   model.reset(input_model->UnPack());
+  bool has_int4_embedding_table = false;
 
   for (int subgraph_index = 0, end = model->subgraphs.size();
        subgraph_index < end; ++subgraph_index) {
@@ -409,12 +441,17 @@ TfLiteStatus QuantizeWeightsInt8(
       OperatorT* op = subgraph->operators[i].get();
       TF_LITE_ENSURE_STATUS(InsertQuantizableInputTensorsFromOperator(
           model.get(), op, weights_min_num_elements, custom_op_map, &tensor_map,
-          subgraph_index, use_updated_hybrid_scheme));
+          subgraph_index, use_updated_hybrid_scheme, int4_embedding_tables));
     }
 
     for (std::pair<int32_t, TensorPerChannel> tensor_pair : tensor_map) {
       // Quantize the tensor.
-      if (tensor_pair.second.is_per_channel) {
+      if (tensor_pair.second.is_int4) {
+        TF_LITE_ENSURE_STATUS(utils::SymmetricQuantizeTensorPerChannelInt4(
+            model.get(), tensor_pair.second.t, tensor_pair.second.channel_dim,
+            nullptr));
+        has_int4_embedding_table = true;
+      } else if (tensor_pair.second.is_per_channel) {
         TF_LITE_ENSURE_STATUS(utils::SymmetricQuantizeTensorPerChannel(
             model.get(), tensor_pair.second.t, tensor_pair.second.channel_dim,
             nullptr));
@@ -426,6 +463,8 @@ TfLiteStatus QuantizeWeightsInt8(
 
     // Examine the tensor consumers to determine which require dequantize ops.
     for (const auto& tensor_pair : tensor_map) {
+      // EMBEDDING_LOOKUP dequantizes the rows of int4 tables it looks up.
+      if (tensor_pair.second.is_int4) continue;
       int32_t tensor_idx = tensor_pair.first;
       TensorT* tensor = tensor_pair.second.t;
       std::vector<ConsumerOpInfo> consumer_op_infos =
@@ -512,6 +551,13 @@ TfLiteStatus QuantizeWeightsInt8(
 
   // Update the modified operator code versions.
   UpdateInt8OperatorVersions(model.get(), use_updated_hybrid_scheme);
+  if (has_int4_embedding_table) {
+    for (auto& op_code : model->operator_codes) {
+      if (GetBuiltinCode(op_code.get()) == BuiltinOperator_EMBEDDING_LOOKUP) {
+        op_code->version = 4;
+      }
+    }
+  }
 
   flatbuffers::Offset<Model> output_model_location =
       Model::Pack(*builder, model.get());
@@ -637,6 +683,10 @@ TfLiteStatus QuantizeWeights(flatbuffers::FlatBufferBuilder* builder,
   // By default we require that only weights with more than
   // kWeightsMinSizeDefault elements are quantized.
   if (quantizer_type == QuantizerType::MLIR_QUANTIZER) {
+    if (quant_type == BufferType::QUANTIZED_INT4) {
+      LOG(ERROR) << "QUANTIZED_INT4 is not supported by the MLIR quantizer.";
+      return kTfLiteError;
+    }
     return mlir::lite::QuantizeWeights(builder, input_model,
                                        (mlir::lite::BufferType)quant_type,
                                        use_updated_hybrid_scheme);
@@ -650,6 +700,13 @@ TfLiteStatus QuantizeWeights(flatbuffers::FlatBufferBuilder* builder,
     }
     case BufferType::QUANTIZED_FLOAT16:
       return QuantizeWeightsFloat16(builder, input_model);
+    case BufferType::QUANTIZED_INT4: {
+      CustomOpMap custom_op_map;
+      return QuantizeWeightsInt8(builder, input_model, true,
+                                 kWeightsMinNumElementsDefault, custom_op_map,
+                                 use_updated_hybrid_scheme, /*op_denylist=*/{},
+                                 /*int4_embedding_tables=*/true);
+    }
   }
 }
 
@@ -30,8 +30,11 @@ namespace tflite {
 namespace optimize {
 using absl::flat_hash_set;
 
-// Supported resulting types from quantization process.
-enum class BufferType { QUANTIZED_INT8, QUANTIZED_FLOAT16 };
+// Supported resulting types from quantization process. QUANTIZED_INT4 is the
+// same as QUANTIZED_INT8, except that the value tables of EMBEDDING_LOOKUP
+// ops, which dequantize int4 directly, are quantized to int4 with one scale
+// per row. Only the OLD_QUANTIZER supports it.
+enum class BufferType { QUANTIZED_INT8, QUANTIZED_FLOAT16, QUANTIZED_INT4 };
 enum class QuantizerType { OLD_QUANTIZER, MLIR_QUANTIZER };
 
 // Stores information about how to quantize a user-specified custom operation.
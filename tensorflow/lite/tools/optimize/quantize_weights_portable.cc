@@ -637,6 +637,9 @@ TfLiteStatus QuantizeWeights(flatbuffers::FlatBufferBuilder* builder,
     }
     case BufferType::QUANTIZED_FLOAT16:
       return QuantizeWeightsFloat16(builder, input_model);
+    case BufferType::QUANTIZED_INT4:
+      LOG(ERROR) << "Portable targets cannot quantize weights to int4.";
+      return kTfLiteError;
   }
 }
 
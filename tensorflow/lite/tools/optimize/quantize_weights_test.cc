@@ -17,6 +17,8 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -668,6 +670,84 @@ TEST_F(QuantizeWeightsTest, DequantizeConvBlocklisted) {
   }
 }
 
+TEST(QuantizeWeightsInt4Test, QuantizesEmbeddingTablePerRow) {
+  // lookup = [2], table = [kNumRows, 4], output = EMBEDDING_LOOKUP(lookup,
+  // table). The table is large enough to be quantized by default.
+  constexpr int kNumRows = 256;
+  ModelT model;
+  auto op_code = std::make_unique<OperatorCodeT>();
+  op_code->builtin_code = BuiltinOperator_EMBEDDING_LOOKUP;
+  op_code->deprecated_builtin_code = BuiltinOperator_EMBEDDING_LOOKUP;
+  op_code->version = 1;
+  model.operator_codes.push_back(std::move(op_code));
+
+  // Row r is (r + 1) * {-7, -3, 0, 7}.
+  std::vector<float> table;
+  for (int r = 0; r < kNumRows; ++r) {
+    for (float value : {-7.0f, -3.0f, 0.0f, 7.0f}) {
+      table.push_back((r + 1) * value);
+    }
+  }
+  model.buffers.push_back(std::make_unique<BufferT>());
+  model.buffers.push_back(std::make_unique<BufferT>());
+  const auto* table_data = reinterpret_cast<const uint8_t*>(table.data());
+  model.buffers[1]->data.assign(table_data,
+                                table_data + table.size() * sizeof(float));
+
+  auto subgraph = std::make_unique<SubGraphT>();
+  auto add_tensor = [&](TensorType type, std::vector<int32_t> shape,
+                        uint32_t buffer) {
+    auto tensor = std::make_unique<TensorT>();
+    tensor->type = type;
+    tensor->shape = std::move(shape);
+    tensor->buffer = buffer;
+    subgraph->tensors.push_back(std::move(tensor));
+  };
+  add_tensor(TensorType_INT32, {2}, 0);
+  add_tensor(TensorType_FLOAT32, {kNumRows, 4}, 1);
+  add_tensor(TensorType_FLOAT32, {2, 4}, 0);
+  auto op = std::make_unique<OperatorT>();
+  op->opcode_index = 0;
+  op->inputs = {0, 1};
+  op->outputs = {2};
+  subgraph->operators.push_back(std::move(op));
+  subgraph->inputs = {0};
+  subgraph->outputs = {2};
+  model.subgraphs.push_back(std::move(subgraph));
+
+  flatbuffers::FlatBufferBuilder input_builder;
+  FinishModelBuffer(input_builder, Model::Pack(input_builder, &model));
+  const Model* input_model = GetModel(input_builder.GetBufferPointer());
+
+  flatbuffers::FlatBufferBuilder builder;
+  ASSERT_EQ(QuantizeWeights(&builder, input_model, BufferType::QUANTIZED_INT4),
+            kTfLiteOk);
+  const Model* output_model = GetModel(builder.GetBufferPointer());
+  ASSERT_TRUE(output_model);
+
+  // The lookup reads the int4 table directly, without a Dequantize op.
+  const auto* quantized_graph = output_model->subgraphs()->Get(0);
+  ASSERT_EQ(quantized_graph->operators()->size(), 1);
+  EXPECT_EQ(output_model->operator_codes()->Get(0)->version(), 4);
+  const auto* table_tensor = quantized_graph->tensors()->Get(
+      quantized_graph->operators()->Get(0)->inputs()->Get(1));
+  EXPECT_EQ(table_tensor->type(), TensorType_INT4);
+  const auto* quantization = table_tensor->quantization();
+  EXPECT_EQ(quantization->quantized_dimension(), 0);
+  ASSERT_EQ(quantization->scale()->size(), kNumRows);
+  EXPECT_FLOAT_EQ(quantization->scale()->Get(0), 1.0f);
+  EXPECT_FLOAT_EQ(quantization->scale()->Get(kNumRows - 1), kNumRows);
+
+  // Each row {-7, -3, 0, 7} is packed lower nibble first.
+  const auto* data =
+      output_model->buffers()->Get(table_tensor->buffer())->data();
+  ASSERT_EQ(data->size(), kNumRows * 2);
+  EXPECT_EQ(data->Get(0), 0xD9);
+  EXPECT_EQ(data->Get(1), 0x70);
+  EXPECT_EQ(data->Get(kNumRows * 2 - 2), 0xD9);
+  EXPECT_EQ(data->Get(kNumRows * 2 - 1), 0x70);
+}
+
 }  // namespace
 }  // namespace optimize
 }  // namespace tflite
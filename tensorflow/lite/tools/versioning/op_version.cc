@@ -1073,6 +1073,12 @@ int GetBuiltinOperatorVersion(const OpSignature& op_sig) {
         return 2;
       }
       return 1;
+    // Versions 2 and 3 (hybrid lookups) are set by the weight quantizer.
+    case BuiltinOperator_EMBEDDING_LOOKUP:
+      if (op_sig.inputs.at(1).type == kTfLiteInt4) {
+        return 4;
+      }
+      return 1;
     default:
       return 1;
   }
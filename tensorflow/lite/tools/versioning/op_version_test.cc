@@ -1369,6 +1369,18 @@ TEST(OpVersionTest, VersioningGeluTest) {
   EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 2);
 }
 
+TEST(OpVersionTest, VersioningEmbeddingLookupTest) {
+  OpSignature fake_op_sig = {};
+  fake_op_sig.op = BuiltinOperator_EMBEDDING_LOOKUP;
+  fake_op_sig.inputs = CreateOpSignatureTensorSpecs(
+      std::vector<TfLiteType>{kTfLiteInt32, kTfLiteFloat32});
+  EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 1);
+
+  fake_op_sig.inputs = CreateOpSignatureTensorSpecs(
+      std::vector<TfLiteType>{kTfLiteInt32, kTfLiteInt4});
+  EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 4);
+}
+
 TEST(OpVersionTest, VersioningUnidirectionalLstmTest) {
   TfLiteUnidirectionalSequenceLSTMParams params = {};
   OpSignature fake_op_sig = {};
@@ -629,6 +629,22 @@ class CacheCheckpointTest(checkpoint_test_base.CheckpointTestBase,
         ds_fn, [], self.num_outputs, verify_exhausted=False)
     self.assertSequenceEqual(outputs, list(range(10)) * 3)
 
+  @combinations.generate(
+      combinations.times(
+          test_base.default_test_combinations(),
+          checkpoint_test_base.default_test_combinations(),
+          combinations.combine(symbolic_checkpoint=[True, False])))
+  def testMemoryCacheSymbolicCheckpoint(self, verify_fn, symbolic_checkpoint):
+
+    def ds_fn():
+      dataset = dataset_ops.Dataset.range(self.range_size).cache().repeat(
+          self.num_repeats)
+      options = options_lib.Options()
+      options.experimental_symbolic_checkpoint = symbolic_checkpoint
+      return dataset.with_options(options)
+
+    verify_fn(self, ds_fn, self.num_outputs)
+
 
 class CacheRandomAccessTest(test_base.DatasetTestBase, parameterized.TestCase):
 
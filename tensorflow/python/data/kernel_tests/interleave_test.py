@@ -16,6 +16,7 @@
 import multiprocessing
 import os
 import sys
+import time
 
 from absl.testing import parameterized
 import numpy as np
@@ -26,10 +27,12 @@ from tensorflow.python.data.kernel_tests import test_base
 from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.ops import options as options_lib
 from tensorflow.python.framework import combinations
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import errors
 from tensorflow.python.framework import sparse_tensor
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import script_ops
 from tensorflow.python.ops import sparse_ops
 from tensorflow.python.ops import stateless_random_ops
 from tensorflow.python.platform import test
@@ -361,6 +364,42 @@ class InterleaveTest(test_base.DatasetTestBase, parameterized.TestCase):
 
     self.checkDeterminism(dataset_fn, expect_determinism, elements)
 
+  @combinations.generate(test_base.default_test_combinations())
+  def testDeterministicReadahead(self):
+    # The first value of cycle element 0 is slow. Meanwhile, cycle element 1
+    # produces more than its 3 buffered outputs into the reorder buffer.
+    produced = []
+    produced_while_blocked = []
+
+    def produce(v):
+      if v == 0:
+        time.sleep(1)
+        produced_while_blocked.append(len(produced))
+      produced.append(v)
+      return v
+
+    def interleave_fn(x):
+      return dataset_ops.Dataset.range(x * 100, x * 100 + 20).map(
+          lambda v: script_ops.py_func(produce, [v], dtypes.int64))
+
+    with test.mock.patch.dict(
+        os.environ, {
+            "TF_JOB_NAME": "test_job",
+            "TF_TASK_ID": "0",
+            "TF_DATA_EXPERIMENT_OPT_IN": "deterministic_interleave_readahead"
+        }):
+      dataset = dataset_ops.Dataset.range(2).interleave(
+          interleave_fn,
+          cycle_length=2,
+          num_parallel_calls=2,
+          deterministic=True)
+      self.assertDatasetProduces(
+          dataset,
+          expected_output=[
+              v for pair in zip(range(20), range(100, 120)) for v in pair
+          ])
+    self.assertGreater(produced_while_blocked[0], 3)
+
   @combinations.generate(
       combinations.times(test_base.default_test_combinations(),
                          combinations.combine(num_parallel_calls=[None, 1])))
@@ -169,6 +169,7 @@ class OptionsTest(test_base.DatasetTestBase, parameterized.TestCase):
     options.framework_type = ["TFDS", "TfGrain"]
     options.threading.max_intra_op_parallelism = 30
     options.threading.private_threadpool_size = 40
+    options.threading.numa_node = 1
     pb = options._to_proto()
     result = options_lib.Options()
     result._from_proto(pb)
@@ -297,6 +298,23 @@ class OptionsTest(test_base.DatasetTestBase, parameterized.TestCase):
     dataset = dataset.map(lambda x: x*x)
     self.assertDatasetProduces(dataset, expected_output=[0, 1, 4, 9, 16, 25])
 
+  @combinations.generate(combinations.times(
+      test_base.default_test_combinations(),
+      combinations.combine(numa_node=[0, 1024])))
+  def testNumaNode(self, numa_node):
+    # The iterator binds its threads and host allocations to a node that
+    # exists, and ignores one that does not.
+    dataset = dataset_ops.Dataset.range(100)
+    dataset = dataset.map(lambda x: x * 2, num_parallel_calls=4)
+    dataset = dataset.prefetch(2)
+    options = options_lib.Options()
+    options.threading.numa_node = numa_node
+    options.threading.private_threadpool_size = 2
+    dataset = dataset.with_options(options)
+    self.assertEqual(self._get_options(dataset).threading.numa_node, numa_node)
+    self.assertDatasetProduces(
+        dataset, expected_output=[x * 2 for x in range(100)])
+
   @combinations.generate(test_base.default_test_combinations())
   def testName(self):
     dataset = dataset_ops.Dataset.from_tensors(42)
@@ -1765,6 +1765,12 @@ class Context:
     self.ensure_initialized()
     pywrap_tfe.TFE_ResetMemoryStats(self._context_handle, dev)
 
+  def release_free_memory(self, dev):
+    """Releases the device's cached free memory and returns its size."""
+    self._initialize_physical_devices()
+    self.ensure_initialized()
+    return pywrap_tfe.TFE_ReleaseFreeMemory(self._context_handle, dev)
+
   def get_memory_growth(self, dev):
     """Get if memory growth is enabled for a PhysicalDevice."""
     self._initialize_physical_devices()
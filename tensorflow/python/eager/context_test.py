@@ -155,6 +155,15 @@ class ContextTest(test.TestCase, parameterized.TestCase):
     with self.assertRaisesRegex(ValueError, 'Failed parsing device name'):
       context.context().get_memory_info('GPU:CPU')
 
+  @test_util.run_gpu_only
+  @test_util.disable_tfrt('b/169293680: TFE_GetTotalMemoryUsage is unsupported')
+  def testReleaseFreeMemory(self):
+    array_ops.zeros([10])  # Allocate some memory on the GPU.
+    released = context.context().release_free_memory('GPU:0')
+    self.assertGreaterEqual(released, 0)
+    # The regions freed above are back with the system.
+    self.assertEqual(context.context().release_free_memory('GPU:0'), 0)
+
   def testListFunctionNames(self):
 
     @def_function.function
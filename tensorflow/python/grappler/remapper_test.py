@@ -101,6 +101,9 @@ class RemapperTest(test.TestCase, parameterized.TestCase):
     if mode == 'mkl' and not test_util.IsMklEnabled():
       self.skipTest('MKL is not enabled.')
 
+    if mode == 'cpu' and test_util.IsMklEnabled():
+      self.skipTest('MKL is enabled.')
+
   def _VerifyNoFusion(self, model_fn):
     ops.add_to_collection('train_op', model_fn)
     mg = meta_graph.create_meta_graph_def(graph=model_fn.graph)
@@ -154,7 +157,7 @@ class RemapperTest(test.TestCase, parameterized.TestCase):
 
     return graph
 
-  @parameterized.parameters(['cuda', 'mkl'])
+  @parameterized.parameters(['cuda', 'mkl', 'cpu'])
   @test_util.run_deprecated_v1
   @test_util.disable_xla('This test does not pass with XLA')
   @test_util.run_without_tensor_float_32('Avoid TF32 convs on A100+ GPUs')
@@ -184,6 +187,9 @@ class RemapperTest(test.TestCase, parameterized.TestCase):
       if _pywrap_utils.IsDataTypeSupportedByOneDNNOnThisCPU(dtypes.bfloat16):
         config.append((dtypes.bfloat16, gelu_approximate, b'GeluApproximate'))
         config.append((dtypes.bfloat16, gelu_exact, b'GeluExact'))
+    elif mode == 'cpu':
+      config.append((dtypes.float32, gelu_exact, b'GeluExact'))
+      config.append((dtypes.float32, gelu_approximate, b'GeluApproximate'))
     elif mode == 'cuda':
       config.append((dtypes.float32, gelu_approximate, b'GeluApproximate'))
       if use_fp16:
@@ -19,6 +19,7 @@ import threading
 import time
 from absl.testing import parameterized
 
+from tensorflow.core.framework import attr_value_pb2
 from tensorflow.python.compat import v2_compat
 from tensorflow.python.data.experimental.ops import testing as dataset_testing
 from tensorflow.python.data.ops import dataset_ops
@@ -1858,6 +1859,81 @@ class CollectiveOpsV3Test(test.TestCase, parameterized.TestCase):
     self.assertAllClose(result[0], [3.0, 1.0], rtol=1e-5, atol=1e-5)
 
 
+class BucketingTest(test.TestCase):
+
+  def setUp(self):
+    _setup_context()
+    super().setUp()
+
+  def testBucketedAllReduce(self):
+    devices = ['/device:CPU:0', '/device:CPU:1']
+    inputs = [
+        constant_op.constant([1., 2.]),
+        constant_op.constant([3., 4., 5.]),
+        constant_op.constant([[6.]]),
+    ]
+    # The attributes normally set by the collective_bucketing optimizer.
+    bucket_attrs = {
+        '_collective_bucket': attr_value_pb2.AttrValue(s=b'bucket'),
+        '_collective_bucket_size': attr_value_pb2.AttrValue(i=len(inputs)),
+    }
+
+    @def_function.function
+    def run():
+      results = []
+      for i, device in enumerate(devices):
+        with ops.device(device):
+          with ops.get_default_graph()._attr_scope(bucket_attrs):
+            results.append([
+                _collective_ops.all_reduce_v2(
+                    t * (i + 1),
+                    group_size=len(devices),
+                    group_key=1,
+                    instance_key=k + 1,
+                    merge_op='Add',
+                    final_op='Div') for k, t in enumerate(inputs)
+            ])
+      return results
+
+    for device_results in run():
+      for result, t in zip(device_results, inputs):
+        self.assertAllClose(result, t * 1.5)
+
+  def testAbortFailsIncompleteBucket(self):
+    # Only one of the two reductions of the bucket is issued, so it waits for
+    # the other one until the collective ops are aborted.
+    bucket_attrs = {
+        '_collective_bucket': attr_value_pb2.AttrValue(s=b'bucket'),
+        '_collective_bucket_size': attr_value_pb2.AttrValue(i=2),
+    }
+
+    @def_function.function
+    def run():
+      with ops.device('/device:CPU:0'):
+        with ops.get_default_graph()._attr_scope(bucket_attrs):
+          return _collective_ops.all_reduce_v2(
+              constant_op.constant([1.]),
+              group_size=1,
+              group_key=1,
+              instance_key=1)
+
+    def abort_fn():
+      time.sleep(2)
+      context.context().abort_collective_ops(errors.UNAVAILABLE, 'peer down')
+
+    t = threading.Thread(target=abort_fn)
+    t.start()
+    with self.assertRaisesRegex(errors.UnavailableError, 'peer down'):
+      run()
+    t.join()
+
+    # Reductions issued after the abort fail immediately.
+    with self.assertRaisesRegex(errors.UnavailableError, 'peer down'):
+      run()
+    # Reset the context in order to reset the collective executor.
+    _setup_context()
+
+
 def _setup_context(num_devices=4):
   context._reset_context()
   test_util.set_logical_devices_to_at_least('CPU', num_devices)
@@ -3369,6 +3369,157 @@ class MutableHashTableOpTest(test.TestCase):
     self.assertAllEqual([b"brain", b"salad", b"surgery"], sorted_keys)
     self.assertAllEqual([0, 1, 2], sorted_values)
 
+  def testShardedMutableHashTable(self, is_anonymous):
+    if is_anonymous and not tf2.enabled():
+      self.skipTest(SKIP_ANONYMOUS_IN_TF1_REASON)
+    default_val = -1
+    keys = constant_op.constant(["brain", "salad", "surgery", "tarkus"])
+    values = constant_op.constant([0, 1, 2, 3], dtypes.int64)
+    table = lookup_ops.MutableHashTable(
+        dtypes.string,
+        dtypes.int64,
+        default_val,
+        experimental_is_anonymous=is_anonymous,
+        experimental_num_shards=3)
+    self.evaluate(table.insert(keys, values))
+    self.assertAllEqual(4, self.evaluate(table.size()))
+
+    self.evaluate(table.remove(constant_op.constant(["tarkus", "tank"])))
+    self.assertAllEqual(3, self.evaluate(table.size()))
+
+    output = table.lookup(constant_op.constant(["brain", "salad", "tank"]))
+    self.assertAllEqual([0, 1, -1], self.evaluate(output))
+
+    exported_keys, exported_values = table.export()
+    self.assertAllEqual([b"brain", b"salad", b"surgery"],
+                        np.sort(self.evaluate(exported_keys)))
+    self.assertAllEqual([0, 1, 2], np.sort(self.evaluate(exported_values)))
+
+    # Importing replaces the contents of all shards.
+    self.evaluate(
+        gen_lookup_ops.lookup_table_import_v2(
+            table.resource_handle, constant_op.constant(["tank"]),
+            constant_op.constant([4], dtypes.int64)))
+    self.assertAllEqual(1, self.evaluate(table.size()))
+    output = table.lookup(constant_op.constant(["brain", "tank"]))
+    self.assertAllEqual([-1, 4], self.evaluate(output))
+
+  def testShardedMutableHashTableRequiresScalarValues(self, is_anonymous):
+    with self.assertRaisesRegex(ValueError, "experimental_num_shards"):
+      lookup_ops.MutableHashTable(
+          dtypes.string,
+          dtypes.int64, [-1, -1],
+          experimental_is_anonymous=is_anonymous,
+          experimental_num_shards=2)
+
+  def testMutableHashTableAdmission(self, is_anonymous):
+    if is_anonymous and not tf2.enabled():
+      self.skipTest(SKIP_ANONYMOUS_IN_TF1_REASON)
+    table = lookup_ops.MutableHashTable(
+        dtypes.int64,
+        dtypes.float32, [-1.0, -1.0],
+        experimental_is_anonymous=is_anonymous,
+        experimental_admission_threshold=2)
+    keys = constant_op.constant([1, 2], dtypes.int64)
+    values = constant_op.constant([[1.0, 1.0], [2.0, 2.0]])
+    self.evaluate(table.insert(keys, values))
+    self.assertAllEqual(0, self.evaluate(table.size()))
+
+    # Only key 1 has been inserted twice.
+    self.evaluate(table.insert(keys[:1], values[:1]))
+    self.assertAllEqual(1, self.evaluate(table.size()))
+    self.assertAllEqual([[1.0, 1.0], [-1.0, -1.0]],
+                        self.evaluate(table.lookup(keys)))
+
+  def testMutableHashTableEviction(self, is_anonymous):
+    if is_anonymous and not tf2.enabled():
+      self.skipTest(SKIP_ANONYMOUS_IN_TF1_REASON)
+    table = lookup_ops.MutableHashTable(
+        dtypes.int64,
+        dtypes.float32, [-1.0],
+        experimental_is_anonymous=is_anonymous,
+        experimental_max_size=2)
+    self.evaluate(
+        table.insert(
+            constant_op.constant([1, 2], dtypes.int64),
+            constant_op.constant([[1.0], [2.0]])))
+    # Key 1 is used more often than key 2, so key 2 is evicted.
+    for _ in range(3):
+      self.evaluate(table.lookup(constant_op.constant([1], dtypes.int64)))
+    self.evaluate(
+        table.insert(
+            constant_op.constant([3], dtypes.int64),
+            constant_op.constant([[3.0]])))
+    self.assertAllEqual(2, self.evaluate(table.size()))
+    self.assertAllEqual([[1.0], [-1.0], [3.0]],
+                        self.evaluate(
+                            table.lookup(
+                                constant_op.constant([1, 2, 3],
+                                                     dtypes.int64))))
+
+  def testMutableHashTableEvictionDecaysFrequencies(self, is_anonymous):
+    if is_anonymous and not tf2.enabled():
+      self.skipTest(SKIP_ANONYMOUS_IN_TF1_REASON)
+    table = lookup_ops.MutableHashTable(
+        dtypes.int64,
+        dtypes.float32, [-1.0],
+        experimental_is_anonymous=is_anonymous,
+        experimental_max_size=2)
+    self.evaluate(
+        table.insert(
+            constant_op.constant([1, 2], dtypes.int64),
+            constant_op.constant([[1.0], [2.0]])))
+    for key in [1, 2]:
+      for _ in range(4):
+        self.evaluate(table.lookup(constant_op.constant([key], dtypes.int64)))
+    # Key 3 has not been used yet, so it is evicted. This halves the
+    # frequencies of keys 1 and 2.
+    self.evaluate(
+        table.insert(
+            constant_op.constant([3], dtypes.int64),
+            constant_op.constant([[3.0]])))
+    # Key 4 starts at the frequency of keys 1 and 2, and key 1, the least
+    # recently used of the three, is evicted.
+    self.evaluate(
+        table.insert(
+            constant_op.constant([4], dtypes.int64),
+            constant_op.constant([[4.0]])))
+    self.assertAllEqual([[-1.0], [2.0], [-1.0], [4.0]],
+                        self.evaluate(
+                            table.lookup(
+                                constant_op.constant([1, 2, 3, 4],
+                                                     dtypes.int64))))
+
+  @test_util.run_v2_only
+  def testMutableHashTableCopyToCpuKeepsOptions(self, is_anonymous):
+    table = lookup_ops.MutableHashTable(
+        dtypes.int64,
+        dtypes.float32, [-1.0],
+        experimental_is_anonymous=is_anonymous,
+        experimental_max_size=2,
+        experimental_admission_threshold=2,
+        experimental_eviction_policy="lru")
+    keys = constant_op.constant([1, 2], dtypes.int64)
+    values = constant_op.constant([[1.0], [2.0]])
+    self.evaluate(table.insert(keys, values))
+    self.evaluate(table.insert(keys, values))
+
+    object_map = {}
+    table._copy_trackable_to_cpu(object_map)  # pylint: disable=protected-access
+    copy = object_map[table]
+    self.assertEqual(2, copy._max_size)  # pylint: disable=protected-access
+    self.assertEqual(2, copy._admission_threshold)  # pylint: disable=protected-access
+    self.assertEqual("lru", copy._eviction_policy)  # pylint: disable=protected-access
+    self.assertAllEqual([[1.0], [2.0]], self.evaluate(copy.lookup(keys)))
+
+    # The copy still evicts once key 3 is admitted.
+    for _ in range(2):
+      self.evaluate(
+          copy.insert(
+              constant_op.constant([3], dtypes.int64),
+              constant_op.constant([[3.0]])))
+    self.assertAllEqual(2, self.evaluate(copy.size()))
+
   # TODO(https://github.com/tensorflow/tensorflow/issues/24439): remove exepectedFailure when fixed
   @unittest.expectedFailure
   @test_util.run_v2_only
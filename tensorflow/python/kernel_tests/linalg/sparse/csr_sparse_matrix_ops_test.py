@@ -707,6 +707,46 @@ class CSRSparseMatrixOpsTest(test.TestCase, parameterized.TestCase):
 
     self.assertAllClose(c_t_value, c_dense_t_value, atol=1e-5, rtol=1e-5)
 
+  @test_util.run_in_graph_and_eager_modes
+  def testSparseMatrixMatMulSkewedRowsOnCPU(self):
+    # One dense row and rows with a single nonzero each, times a b whose
+    # columns do not fit in cache at once.
+    a_mats = np.zeros([2, 40, 4096], dtype=np.float32)
+    a_mats[:, 0, :] = np.random.randn(2, 4096)
+    a_mats[:, np.arange(1, 40), np.random.randint(0, 4096, size=39)] = (
+        1. + np.random.rand(2, 39))
+    b_mats = np.random.randn(2, 4096, 200).astype(np.float32)
+    with ops.device(CPU):
+      a_sm = dense_to_csr_sparse_matrix(a_mats)
+      c_t = sparse_csr_matrix_ops.sparse_matrix_mat_mul(a_sm, b_mats)
+    c_value = self.evaluate(c_t)
+
+    c_dense = np.matmul(a_mats.astype(np.float64), b_mats.astype(np.float64))
+    self.assertAllClose(c_value, c_dense, atol=1e-3, rtol=1e-4)
+
+  @parameterized.product(
+      dtype=[np.float32, np.complex64], adjoint_b=[False, True])
+  @test_util.run_in_graph_and_eager_modes
+  def testVerySparseMatrixMatMulTransposedDenseOnCPU(self, dtype, adjoint_b):
+    # a has fewer nonzeros than its inner dimension, so b is read without
+    # being transposed first.
+    a_mats = np.zeros([2, 30, 50], dtype=dtype)
+    a_mats[:, np.arange(20), np.random.randint(0, 50, size=20)] = (
+        1. + np.random.rand(2, 20))
+    b_mats = np.random.randn(2, 70, 50).astype(dtype)
+    if dtype == np.complex64:
+      a_mats *= 1. + 1.j
+      b_mats += 1.j * np.random.randn(2, 70, 50).astype(dtype)
+    with ops.device(CPU):
+      a_sm = dense_to_csr_sparse_matrix(a_mats)
+      c_t = sparse_csr_matrix_ops.sparse_matrix_mat_mul(
+          a_sm, b_mats, transpose_b=not adjoint_b, adjoint_b=adjoint_b)
+    c_value = self.evaluate(c_t)
+
+    b_t = np.swapaxes(b_mats, -1, -2)
+    c_dense = np.matmul(a_mats, np.conj(b_t) if adjoint_b else b_t)
+    self.assertAllClose(c_value, c_dense, atol=1e-5, rtol=1e-5)
+
   @test_util.run_in_graph_and_eager_modes
   def testSparseMatrixSparseMatMul(self):
     a_indices = np.array([[0, 0], [2, 3]])
@@ -26,6 +26,8 @@ from tensorflow.python.framework import errors_impl
 from tensorflow.python.framework import indexed_slices
 from tensorflow.python.framework import ops
 from tensorflow.python.framework import test_util
+from tensorflow.python.ops import gen_math_ops
+from tensorflow.python.ops import gen_resource_variable_ops
 from tensorflow.python.ops import gradient_checker
 from tensorflow.python.ops import gradient_checker_v2
 from tensorflow.python.ops import gradients
@@ -728,6 +730,34 @@ class SparseSegmentReductionOpTest(SparseSegmentReductionHelper):
         tf_ans = self.evaluate(s)
         self.assertAllClose(np_ans, tf_ans)
 
+  def testLargeSkewedSegments(self):
+    # Large enough for the CPU kernel to split the indices into chunks, with
+    # one segment spanning many chunks, holes and empty trailing segments.
+    np.random.seed(0)
+    np_x = np.random.rand(1000, 16).astype(np.float32)
+    segment_sizes = [15000, 1, 0, 7, 300, 0, 0, 2] + [1] * 2000 + [4000]
+    segment_ids = np.repeat(np.arange(len(segment_sizes)), segment_sizes)
+    indices = np.random.randint(0, 1000, len(segment_ids))
+    num_segments = len(segment_sizes) + 3
+    counts = np.bincount(segment_ids, minlength=num_segments)
+    np_sum = np.zeros([num_segments, 16], np.float64)
+    np.add.at(np_sum, segment_ids, np_x[indices])
+    nonempty = np.maximum(counts, 1)[:, np.newaxis]
+    ops_list = [
+        (math_ops.sparse_segment_sum_with_num_segments, np_sum),
+        (math_ops.sparse_segment_mean_with_num_segments, np_sum / nonempty),
+        (math_ops.sparse_segment_sqrt_n_with_num_segments,
+         np_sum / np.sqrt(nonempty)),
+    ]
+    with self.session(use_gpu=False):
+      for tf_op, np_ans in ops_list:
+        s = tf_op(
+            data=np_x,
+            indices=indices,
+            segment_ids=segment_ids,
+            num_segments=num_segments)
+        self.assertAllClose(np_ans, self.evaluate(s), rtol=1e-4, atol=1e-4)
+
   def testWithNumSegments(self):
     tf_x, np_x = self._input([10, 4], dtype=dtypes_lib.float32)
     ops_list = [(np.add, None, math_ops.sparse_segment_sum_with_num_segments),
@@ -1357,6 +1387,86 @@ class SparseSegmentReductionOpTest(SparseSegmentReductionHelper):
           self.evaluate([s, j])
 
 
+class GroupedSparseSegmentReduceTest(test.TestCase, parameterized.TestCase):
+
+  @parameterized.parameters("sum", "mean", "sqrtn")
+  def testMatchesSparseSegmentReduction(self, combiner):
+    tables = [
+        np.arange(12, dtype=np.float32).reshape(6, 2),
+        np.arange(4, dtype=np.float32).reshape(4, 1),
+    ]
+    indices = [np.array([5, 0, 0, 2]), np.array([3])]
+    offsets = [np.array([0, 3, 3, 4]), np.array([0, 0, 1])]
+    reductions = {
+        "sum": math_ops.sparse_segment_sum,
+        "mean": math_ops.sparse_segment_mean,
+        "sqrtn": math_ops.sparse_segment_sqrt_n,
+    }
+    with test_util.force_cpu():
+      outputs = gen_math_ops.grouped_sparse_segment_reduce(
+          tables, indices, offsets, combiner=combiner)
+      for table, table_indices, table_offsets, output in zip(
+          tables, indices, offsets, outputs):
+        segment_ids = np.repeat(
+            np.arange(len(table_offsets) - 1), np.diff(table_offsets))
+        expected = reductions[combiner](
+            table, table_indices, segment_ids,
+            num_segments=len(table_offsets) - 1)
+        self.assertAllClose(expected, output)
+
+  @parameterized.parameters("sum", "mean", "sqrtn")
+  def testGradient(self, combiner):
+    tables = [
+        np.random.rand(6, 2).astype(np.float64),
+        np.random.rand(4, 3).astype(np.float64),
+    ]
+    indices = [np.array([5, 0, 0, 2]), np.array([3, 1])]
+    offsets = [np.array([0, 3, 3, 4]), np.array([0, 2])]
+
+    def f(table0, table1):
+      outputs = gen_math_ops.grouped_sparse_segment_reduce(
+          [table0, table1], indices, offsets, combiner=combiner)
+      return outputs[0] * 2. + math_ops.reduce_sum(outputs[1])
+
+    with test_util.force_cpu():
+      theoretical, numerical = gradient_checker_v2.compute_gradient(f, tables)
+      self.assertAllClose(theoretical, numerical)
+
+  @test_util.run_in_graph_and_eager_modes
+  def testResourceVariables(self):
+    tables = [
+        np.arange(12, dtype=np.float32).reshape(6, 2),
+        np.arange(4, dtype=np.float32).reshape(4, 1),
+    ]
+    indices = [np.array([5, 0, 0, 2]), np.array([3])]
+    offsets = [np.array([0, 3, 3, 4]), np.array([0, 0, 1])]
+    with test_util.force_cpu():
+      table_vars = [variables.Variable(table) for table in tables]
+      self.evaluate(variables.global_variables_initializer())
+      with gradients.GradientTape() as tape:
+        outputs = (
+            gen_resource_variable_ops.resource_grouped_sparse_segment_reduce(
+                [v.handle for v in table_vars], indices, offsets,
+                dtype=dtypes_lib.float32, combiner="mean"))
+        loss = outputs[0] * 2. + math_ops.reduce_sum(outputs[1])
+      table_grads = tape.gradient(loss, table_vars)
+
+      constant_tables = [constant_op.constant(table) for table in tables]
+      with gradients.GradientTape() as tape:
+        tape.watch(constant_tables)
+        expected = gen_math_ops.grouped_sparse_segment_reduce(
+            constant_tables, indices, offsets, combiner="mean")
+        expected_loss = expected[0] * 2. + math_ops.reduce_sum(expected[1])
+      expected_grads = tape.gradient(expected_loss, constant_tables)
+
+      self.assertAllClose(self.evaluate(expected), self.evaluate(outputs))
+      for grad, expected_grad in zip(table_grads, expected_grads):
+        self.assertIsInstance(grad, indexed_slices.IndexedSlices)
+        self.assertAllClose(
+            self.evaluate(ops.convert_to_tensor(expected_grad)),
+            self.evaluate(ops.convert_to_tensor(grad)))
+
+
 class SegmentReductionOpBenchmark(test.Benchmark):
   outer_dim_options = [2**x for x in range(9, 14, 2)]
   ratio_options = [2**x for x in range(1, 6, 2)]
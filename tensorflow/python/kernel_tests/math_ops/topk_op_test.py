@@ -183,6 +183,26 @@ class TopKTest(test.TestCase):
     self._testMediumTopK(np.float16)
     self._testMediumTopK(dtypes.bfloat16.as_numpy_dtype)
 
+  def testHugeRowsTopK(self):
+    # Rows this long are pre-filtered, one or a few of them in parallel.
+    n = 1 << 17
+    for b in [1, 8]:
+      for k in [2, 100, 1000]:
+        inputs = np.random.permutation(
+            np.linspace(0, 100, b * n, dtype=np.float32)).reshape(b, n)
+        indices = np.argsort(-inputs, axis=1)[:, :k]
+        values = -np.sort(-inputs, axis=1)[:, :k]
+        self._validateTopK(inputs, k, values, indices)
+
+  def testHugeRowsStableSort(self):
+    # Many ties with the sampled threshold fall back to the full heap.
+    n = 1 << 16
+    for k in [5, 500]:
+      inputs = np.random.randint(0, 4, size=(2, n)).astype(np.int32)
+      indices = np.argsort(-inputs, axis=1, kind="mergesort")[:, :k]
+      values = -np.sort(-inputs, axis=1)[:, :k]
+      self._validateTopK(inputs, k, values, indices)
+
   def testStableSort(self):
     b = 5
     n = 500
@@ -1011,6 +1011,46 @@ class EmbeddingLookupSparseTest(test.TestCase, parameterized.TestCase):
         self.assertAllEqual(actual_indices, expected_indices)
         self.assertAllClose(actual_values, expected_values)
 
+  @parameterized.parameters(
+      itertools.product(
+          ["sum", "mean", "sqrtn"], [dtypes.float32, dtypes.float64]
+      )
+  )
+  def testFusedWeightedSumOnCpu(self, combiner, dtype):
+    vocab_size = 13
+    batch_size = 10
+    sp_ids, sp_weights, ids, weights, vals_per_batch_entry = (
+        self._RandomIdsAndWeights(batch_size, vocab_size)
+    )
+    np_type = "f" if dtype == dtypes.float32 else "d"
+    np_params = np.random.uniform(size=[vocab_size, 4]).astype(np_type)
+
+    with ops.Graph().as_default() as g, self.session(), (
+        forward_compat.forward_compatibility_horizon(2024, 3, 21)
+    ):
+      with ops.device("/CPU:0"):
+        params = constant_op.constant(np_params)
+      embeddings = embedding_ops.embedding_lookup_sparse(
+          params, sp_ids, sp_weights, combiner=combiner
+      )
+      self.assertIn(
+          "SparseSegmentWeightedSum", [op.type for op in g.get_operations()]
+      )
+      tf_embeddings = self.evaluate(embeddings)
+
+    np_embeddings = np.zeros([batch_size, 4])
+    index = 0
+    for batch_entry, num_vals in enumerate(vals_per_batch_entry):
+      entry_ids = ids[index:index + num_vals]
+      entry_weights = weights[index:index + num_vals]
+      index += num_vals
+      np_embeddings[batch_entry] = np.dot(entry_weights, np_params[entry_ids])
+      if combiner == "mean":
+        np_embeddings[batch_entry] /= np.sum(entry_weights)
+      elif combiner == "sqrtn":
+        np_embeddings[batch_entry] /= np.sqrt(np.sum(entry_weights**2))
+    self.assertAllClose(np_embeddings, tf_embeddings, rtol=1e-5, atol=1e-5)
+
 
 class SafeEmbeddingLookupSparseTest(test.TestCase, parameterized.TestCase):
 
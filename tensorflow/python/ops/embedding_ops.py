@@ -28,7 +28,9 @@ from tensorflow.python.ops import clip_ops
 # Imports gradient definitions.
 from tensorflow.python.ops import data_flow_grad  # pylint: disable=unused-import
 from tensorflow.python.ops import data_flow_ops
+from tensorflow.python.ops import gen_math_ops
 from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import nn_ops
 from tensorflow.python.ops import resource_variable_ops
 from tensorflow.python.ops import sparse_ops
 from tensorflow.python.ops import variables
@@ -1052,6 +1054,13 @@ def embedding_lookup_sparse_impl(
       params[0], (core.Tensor, composite_tensor.CompositeTensor)
   ):
     params = [ops.convert_to_tensor(params[0], name="params")]
+  # The fused weighted reduction only has a CPU kernel.
+  use_fused_weighted_sum = (
+      not ignore_weights
+      and compat.forward_compatible(2024, 3, 20)
+      and all(nn_ops._can_use_cpu_only_kernel(p) for p in params)  # pylint: disable=protected-access
+      and params[0].dtype.base_dtype in (dtypes.float32, dtypes.float64)
+  )
   # Note that if the params are on a different device (e.g., CPU), we must use
   # embedding_lookup() so that the gather operation is colocated with them.
   if (
@@ -1078,7 +1087,37 @@ def embedding_lookup_sparse_impl(
         params, ids, partition_strategy=partition_strategy, max_norm=max_norm
     )
 
-  if not ignore_weights:
+  if use_fused_weighted_sum:
+    if segment_ids.dtype not in (dtypes.int32, dtypes.int64):
+      segment_ids = math_ops.cast(segment_ids, dtypes.int32)
+
+    weights = sp_weights.values
+    if weights.dtype != embeddings.dtype:
+      weights = math_ops.cast(weights, embeddings.dtype)
+    # Accumulates the weighted rows directly into the output instead of
+    # gathering them first.
+    if combiner == "sum":
+      embeddings = gen_math_ops.sparse_segment_weighted_sum(
+          embeddings, idx, weights, segment_ids, name=name
+      )
+    elif combiner in ("mean", "sqrtn"):
+      embeddings = gen_math_ops.sparse_segment_weighted_sum(
+          embeddings, idx, weights, segment_ids
+      )
+      if combiner == "sqrtn":
+        weights = math_ops.pow(weights, 2)
+      weight_sum = math_ops.segment_sum(weights, segment_ids)
+      if combiner == "sqrtn":
+        weight_sum = math_ops.sqrt(weight_sum)
+      ones_shape = array_ops.expand_dims(array_ops.rank(embeddings) - 1, 0)
+      ones = array_ops.ones(ones_shape, dtype=dtypes.int32)
+      weight_sum = array_ops.reshape(
+          weight_sum, array_ops.concat([array_ops.shape(weight_sum), ones], 0)
+      )
+      embeddings = math_ops.div_no_nan(embeddings, weight_sum, name=name)
+    else:
+      assert False, "Unrecognized combiner"
+  elif not ignore_weights:
     if segment_ids.dtype != dtypes.int32:
       segment_ids = math_ops.cast(segment_ids, dtypes.int32)
 
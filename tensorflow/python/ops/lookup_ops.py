@@ -1832,7 +1832,11 @@ class MutableHashTable(LookupInterface):
                default_value,
                name="MutableHashTable",
                checkpoint=True,
-               experimental_is_anonymous=False):
+               experimental_is_anonymous=False,
+               experimental_num_shards=1,
+               experimental_max_size=0,
+               experimental_admission_threshold=1,
+               experimental_eviction_policy="lfu"):
     """Creates an empty `MutableHashTable` object.
 
     Creates a table, the type of its keys and values are specified by key_dtype
@@ -1852,16 +1856,46 @@ class MutableHashTable(LookupInterface):
         be looked up by a name. When all resource handles pointing to
         that resource are gone, the resource will be deleted
         automatically.
+      experimental_num_shards: The number of independently locked partitions
+        of the table (default is 1). More partitions let lookups proceed
+        concurrently with inserts of keys in other partitions, at the cost of
+        inserts no longer being applied atomically. Only supported for scalar
+        values.
+      experimental_max_size: If positive, the least used entries are evicted
+        when an insert makes the table grow beyond this size (default is 0).
+        Only supported for non-scalar values.
+      experimental_admission_threshold: The number of times a key must be
+        inserted before it is added to the table, as estimated by a count-min
+        sketch (default is 1). Only supported for non-scalar values.
+      experimental_eviction_policy: Whether to evict the entries looked up least
+        often ("lfu", the default) or least recently ("lru"). With "lfu", the
+        lookup counts are halved at every eviction.
 
     Returns:
       A `MutableHashTable` object.
 
     Raises:
-      ValueError: If checkpoint is True and no name was specified.
+      ValueError: If checkpoint is True and no name was specified, if
+        `experimental_num_shards` is not 1 for non-scalar values, or if
+        `experimental_max_size` or `experimental_admission_threshold` are set
+        for scalar values.
     """
     self._default_value = ops.convert_to_tensor(
         default_value, dtype=value_dtype)
     self._value_shape = self._default_value.get_shape()
+    if experimental_num_shards != 1 and self._value_shape.ndims != 0:
+      raise ValueError("`experimental_num_shards` is only supported for scalar "
+                       "values, but got default value of shape "
+                       f"{self._value_shape}.")
+    if ((experimental_max_size != 0 or experimental_admission_threshold != 1)
+        and self._value_shape.ndims == 0):
+      raise ValueError("`experimental_max_size` and "
+                       "`experimental_admission_threshold` are only supported "
+                       "for non-scalar values.")
+    self._num_shards = experimental_num_shards
+    self._max_size = experimental_max_size
+    self._admission_threshold = experimental_admission_threshold
+    self._eviction_policy = experimental_eviction_policy
     self._checkpoint = checkpoint
     self._key_dtype = key_dtype
     self._value_dtype = value_dtype
@@ -1888,12 +1922,16 @@ class MutableHashTable(LookupInterface):
         table_ref = gen_lookup_ops.anonymous_mutable_hash_table(
             key_dtype=self._key_dtype,
             value_dtype=self._value_dtype,
+            num_shards=self._num_shards,
             name=self._name)
       else:
         table_ref = gen_lookup_ops.anonymous_mutable_hash_table_of_tensors(
             key_dtype=self._key_dtype,
             value_dtype=self._value_dtype,
             value_shape=self._default_value.get_shape(),
+            max_size=self._max_size,
+            admission_threshold=self._admission_threshold,
+            eviction_policy=self._eviction_policy,
             name=self._name)
     else:
       # The table must be shared if checkpointing is requested for multi-worker
@@ -1906,6 +1944,7 @@ class MutableHashTable(LookupInterface):
             use_node_name_sharing=use_node_name_sharing,
             key_dtype=self._key_dtype,
             value_dtype=self._value_dtype,
+            num_shards=self._num_shards,
             name=self._name)
       else:
         table_ref = gen_lookup_ops.mutable_hash_table_of_tensors_v2(
@@ -1914,6 +1953,9 @@ class MutableHashTable(LookupInterface):
             key_dtype=self._key_dtype,
             value_dtype=self._value_dtype,
             value_shape=self._default_value.get_shape(),
+            max_size=self._max_size,
+            admission_threshold=self._admission_threshold,
+            eviction_policy=self._eviction_policy,
             name=self._name)
 
     if context.executing_eagerly():
@@ -2076,7 +2118,11 @@ class MutableHashTable(LookupInterface):
           self._default_value,
           self._name,
           self._checkpoint,
-          self._is_anonymous
+          self._is_anonymous,
+          experimental_num_shards=self._num_shards,
+          experimental_max_size=self._max_size,
+          experimental_admission_threshold=self._admission_threshold,
+          experimental_eviction_policy=self._eviction_policy,
       )
 
     # Copy values from `self` to copy of `self`
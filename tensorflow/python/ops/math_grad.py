@@ -26,6 +26,7 @@ from tensorflow.python.framework import tensor_util
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import gen_array_ops
 from tensorflow.python.ops import gen_math_ops
+from tensorflow.python.ops import gen_resource_variable_ops
 from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import special_math_ops
 
@@ -453,6 +454,89 @@ def _SparseSegmentSqrtNWithNumSegmentsGrad(op: ops.Operation, grad):
                                               dim0), None, None, None)
 
 
+@ops.RegisterGradient("SparseSegmentWeightedSum")
+def _SparseSegmentWeightedSumGrad(op: ops.Operation, grad):
+  """Gradient for SparseSegmentWeightedSum."""
+  data, indices, weights, segment_ids = op.inputs
+  # The gradient of the output for each selected row.
+  selected_grad = array_ops.gather(grad, segment_ids)
+  ones = array_ops.ones(
+      array_ops.expand_dims(array_ops.rank(data) - 1, 0), dtype=dtypes.int32)
+  bcast_weights_shape = array_ops.concat([array_ops.shape(weights), ones], 0)
+  weighted_grad = selected_grad * array_ops.reshape(weights,
+                                                    bcast_weights_shape)
+  # Sum the gradients of repeated indices, so that there is one row per
+  # distinct selected row.
+  unique_indices, unique_idx = array_ops.unique(indices)
+  data_grad = indexed_slices_lib.IndexedSlices(
+      math_ops.unsorted_segment_sum(weighted_grad, unique_idx,
+                                    array_ops.size(unique_indices)),
+      unique_indices, array_ops.shape(data))
+  selected_products = selected_grad * array_ops.gather(data, indices)
+  weights_grad = math_ops.reduce_sum(
+      selected_products,
+      axis=math_ops.range(1, array_ops.rank(selected_products)))
+  return data_grad, None, weights_grad, None
+
+
+def _GroupedSparseSegmentReduceTableGrads(op: ops.Operation, grads,
+                                          table_shapes):
+  """Returns the IndexedSlices gradients of the tables of a grouped reduce."""
+  num_tables = op.get_attr("N")
+  combiner = op.get_attr("combiner").decode()
+  indices = op.inputs[num_tables:2 * num_tables]
+  offsets = op.inputs[2 * num_tables:]
+  params_grads = []
+  for table_shape, table_indices, table_offsets, grad in zip(
+      table_shapes, indices, offsets, grads):
+    bag_sizes = table_offsets[1:] - table_offsets[:-1]
+    # The bag of each index.
+    segment_ids = array_ops.repeat(
+        math_ops.range(array_ops.size(bag_sizes), dtype=bag_sizes.dtype),
+        bag_sizes)
+    if combiner == "sum":
+      bag_grad = grad
+    else:
+      scale = math_ops.cast(math_ops.maximum(bag_sizes, 1), grad.dtype)
+      if combiner == "sqrtn":
+        scale = math_ops.sqrt(scale)
+      ones = array_ops.ones(
+          array_ops.expand_dims(array_ops.rank(grad) - 1, 0),
+          dtype=dtypes.int32)
+      bag_grad = grad / array_ops.reshape(
+          scale, array_ops.concat([array_ops.shape(scale), ones], 0))
+    params_grads.append(
+        indexed_slices_lib.IndexedSlices(
+            array_ops.gather(bag_grad, segment_ids), table_indices,
+            table_shape))
+  return params_grads
+
+
+@ops.RegisterGradient("GroupedSparseSegmentReduce")
+def _GroupedSparseSegmentReduceGrad(op: ops.Operation, *grads):
+  """Gradient for GroupedSparseSegmentReduce."""
+  num_tables = op.get_attr("N")
+  table_shapes = [
+      array_ops.shape(table, out_type=op.get_attr("Tidx"))
+      for table in op.inputs[:num_tables]
+  ]
+  return _GroupedSparseSegmentReduceTableGrads(
+      op, grads, table_shapes) + [None] * (2 * num_tables)
+
+
+@ops.RegisterGradient("ResourceGroupedSparseSegmentReduce")
+def _ResourceGroupedSparseSegmentReduceGrad(op: ops.Operation, *grads):
+  """Gradient for ResourceGroupedSparseSegmentReduce."""
+  num_tables = op.get_attr("N")
+  table_shapes = [
+      gen_resource_variable_ops.variable_shape(
+          handle, out_type=op.get_attr("Tidx"))
+      for handle in op.inputs[:num_tables]
+  ]
+  return _GroupedSparseSegmentReduceTableGrads(
+      op, grads, table_shapes) + [None] * (2 * num_tables)
+
+
 def _SegmentMinOrMaxGrad(op: ops.Operation, grad):
   """ Gradient for SegmentMin and SegmentMax. """
   zeros = array_ops.zeros_like(op.inputs[0], dtype=op.inputs[0].dtype)
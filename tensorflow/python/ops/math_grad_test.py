@@ -27,6 +27,7 @@ from tensorflow.python.framework import test_util
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import gradient_checker
 from tensorflow.python.ops import gradient_checker_v2
+from tensorflow.python.ops import gen_math_ops
 from tensorflow.python.ops import gradients
 from tensorflow.python.ops import math_grad
 from tensorflow.python.ops import math_ops
@@ -435,6 +436,27 @@ class SegmentProdGradientTest(test.TestCase):
     self._run_gradient_check(data, segment_ids)
 
 
+@test_util.run_all_in_graph_and_eager_modes
+class SparseSegmentWeightedSumGradientTest(test.TestCase):
+
+  def testGradient(self):
+    data = constant_op.constant(
+        [[1, 2, 3], [4, 3, 2], [5, 6, 7], [0, -1, 2]], dtype=dtypes.float64)
+    weights = constant_op.constant([0.5, -2, 1.5, 3, 1], dtype=dtypes.float64)
+    # Row 1 is selected twice, and segment 1 is empty.
+    indices = constant_op.constant([1, 0, 1, 3, 2])
+    segment_ids = constant_op.constant([0, 0, 2, 2, 3])
+
+    def _weighted_sum(data, weights):
+      with ops.device("/CPU:0"):
+        return gen_math_ops.sparse_segment_weighted_sum(
+            data, indices, weights, segment_ids)
+
+    err = gradient_checker_v2.max_error(*gradient_checker_v2.compute_gradient(
+        _weighted_sum, [data, weights]))
+    self.assertLess(err, 1e-8)
+
+
 class FloorModGradientTest(test.TestCase):
 
   @test_util.run_deprecated_v1
@@ -563,6 +563,68 @@ def _SparseSoftmaxCrossEntropyWithLogitsGrad(op: ops.Operation,
   return grad, None
 
 
+@ops.RegisterGradient("SampledSoftmaxCrossEntropyWithLogits")
+def _SampledSoftmaxCrossEntropyWithLogitsGrad(op: ops.Operation, grad_loss,
+                                              grad_true_grad,
+                                              grad_sampled_grad):
+  """Gradient function for SampledSoftmaxCrossEntropyWithLogits."""
+  # grad_loss is the backprop for cost, and we multiply it with the gradients
+  # (which are output[1] and output[2])
+  # grad_true_grad and grad_sampled_grad are the backprops for the gradients.
+  # There is no gradient for the expected counts and the class ids.
+  #
+  # Second derivative is the softmax derivative w.r.t. the true logits
+  # followed by the sampled logits.
+  true_backprop = op.outputs[1]
+  sampled_backprop = op.outputs[2]
+  true_grad = _BroadcastMul(grad_loss, true_backprop)
+  sampled_grad = _BroadcastMul(grad_loss, sampled_backprop)
+
+  def _IsZero(grad_grad):
+    return grad_grad is None or getattr(grad_grad, "_is_zeros_tensor", False)
+
+  if not (_IsZero(grad_true_grad) and _IsZero(grad_sampled_grad)):
+    if grad_true_grad is None:
+      grad_true_grad = array_ops.zeros_like(true_backprop)
+    if grad_sampled_grad is None:
+      grad_sampled_grad = array_ops.zeros_like(sampled_backprop)
+    # The backprop is the softmax minus 1 / num_true for each true class, and
+    # the softmax of removed accidental hits is 0.
+    num_true = math_ops.cast(
+        array_ops.shape(true_backprop)[1], true_backprop.dtype)
+    true_softmax = true_backprop + math_ops.reciprocal(num_true)
+    sampled_softmax = sampled_backprop
+    dot = (
+        math_ops.reduce_sum(grad_true_grad * true_softmax, 1, keepdims=True) +
+        math_ops.reduce_sum(
+            grad_sampled_grad * sampled_softmax, 1, keepdims=True))
+    true_grad += (grad_true_grad - dot) * true_softmax
+    sampled_grad += (grad_sampled_grad - dot) * sampled_softmax
+
+  return true_grad, sampled_grad, None, None, None, None
+
+
+@ops.RegisterGradient("ScaledDotProductAttention")
+def _ScaledDotProductAttentionGrad(op: ops.Operation, grad_output,
+                                   unused_grad_logsumexp):
+  """Gradient function for ScaledDotProductAttention."""
+  # logsumexp is only saved for the gradient, so it has no gradient itself.
+  query, key, value, key_lengths = op.inputs
+  output, logsumexp = op.outputs
+  grad_query, grad_key, grad_value = (
+      gen_nn_ops.scaled_dot_product_attention_grad(
+          query,
+          key,
+          value,
+          key_lengths,
+          output,
+          logsumexp,
+          grad_output,
+          scale=op.get_attr("scale"),
+          causal=op.get_attr("causal")))
+  return grad_query, grad_key, grad_value, None
+
+
 @ops.RegisterGradient("Conv2D")
 def _Conv2DGrad(op: ops.Operation, grad):
   """Gradient function for Conv2D."""
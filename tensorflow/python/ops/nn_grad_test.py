@@ -267,5 +267,28 @@ class SwishGradOpTest(test.TestCase):
       self.assertLess(error, 1e-4)
 
 
+class ScaledDotProductAttentionGradOpTest(test.TestCase):
+
+  def testScaledDotProductAttentionGrad(self):
+    np.random.seed(1)
+    query = constant_op.constant(
+        np.random.randn(2, 2, 5, 3), dtype=dtypes.float64)
+    key = constant_op.constant(
+        np.random.randn(2, 2, 7, 3), dtype=dtypes.float64)
+    value = constant_op.constant(
+        np.random.randn(2, 2, 7, 4), dtype=dtypes.float64)
+    key_lengths = constant_op.constant([7, 4])
+
+    def f(query, key, value):
+      return gen_nn_ops.scaled_dot_product_attention(
+          query, key, value, key_lengths, scale=0.5, causal=True)[0]
+
+    with self.cached_session():
+      theoretical, numerical = gradient_checker_v2.compute_gradient(
+          f, [query, key, value])
+      error = gradient_checker_v2.max_error(theoretical, numerical)
+      self.assertLess(error, 1e-6)
+
+
 if __name__ == "__main__":
   test.main()
@@ -16,6 +16,7 @@
 
 import math
 
+from tensorflow.python.compat import compat
 from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
@@ -1711,6 +1712,98 @@ def _sum_rows(x):
   return array_ops.reshape(math_ops.matmul(x, ones), [-1])
 
 
+def _sampled_logits_parts(weights, biases, labels, inputs, num_sampled,
+                          num_classes, num_true, sampled_values,
+                          partition_strategy, seed):
+  """Computes the uncorrected true and sampled logits.
+
+  See `_compute_sampled_logits` for the arguments. `weights` must be a list.
+
+  Returns:
+    A tuple `(labels, sampled, true_expected_count, sampled_expected_count,
+    true_logits, sampled_logits)`, where `labels` and `sampled` are `int64`,
+    `true_logits` has shape `[batch_size, num_true]` and `sampled_logits` has
+    shape `[batch_size, num_sampled]`.
+  """
+  if labels.dtype != dtypes.int64:
+    labels = math_ops.cast(labels, dtypes.int64)
+  labels_flat = array_ops.reshape(labels, [-1])
+
+  # Sample the negative labels.
+  #   sampled shape: [num_sampled] tensor
+  #   true_expected_count shape = [batch_size, 1] tensor
+  #   sampled_expected_count shape = [num_sampled] tensor
+  if sampled_values is None:
+    sampled_values = candidate_sampling_ops.log_uniform_candidate_sampler(
+        true_classes=labels,
+        num_true=num_true,
+        num_sampled=num_sampled,
+        unique=True,
+        range_max=num_classes,
+        seed=seed)
+  # NOTE: pylint cannot tell that 'sampled_values' is a sequence
+  # pylint: disable=unpacking-non-sequence
+  sampled, true_expected_count, sampled_expected_count = (
+      array_ops.stop_gradient(s) for s in sampled_values)
+  # pylint: enable=unpacking-non-sequence
+  sampled = math_ops.cast(sampled, dtypes.int64)
+
+  # labels_flat is a [batch_size * num_true] tensor
+  # sampled is a [num_sampled] int tensor
+  all_ids = array_ops.concat([labels_flat, sampled], 0)
+
+  # Retrieve the true weights and the logits of the sampled weights.
+
+  # weights shape is [num_classes, dim]
+  all_w = embedding_ops.embedding_lookup(
+      weights, all_ids, partition_strategy=partition_strategy)
+  if all_w.dtype != inputs.dtype:
+    all_w = math_ops.cast(all_w, inputs.dtype)
+
+  # true_w shape is [batch_size * num_true, dim]
+  true_w = array_ops.slice(all_w, [0, 0],
+                           array_ops_stack.stack(
+                               [array_ops.shape(labels_flat)[0], -1]))
+
+  sampled_w = array_ops.slice(
+      all_w,
+      array_ops_stack.stack([array_ops.shape(labels_flat)[0], 0]), [-1, -1])
+  # inputs has shape [batch_size, dim]
+  # sampled_w has shape [num_sampled, dim]
+  # Apply X*W', which yields [batch_size, num_sampled]
+  sampled_logits = math_ops.matmul(inputs, sampled_w, transpose_b=True)
+
+  # Retrieve the true and sampled biases, compute the true logits, and
+  # add the biases to the true and sampled logits.
+  all_b = embedding_ops.embedding_lookup(
+      biases, all_ids, partition_strategy=partition_strategy)
+  if all_b.dtype != inputs.dtype:
+    all_b = math_ops.cast(all_b, inputs.dtype)
+  # true_b is a [batch_size * num_true] tensor
+  # sampled_b is a [num_sampled] float tensor
+  true_b = array_ops.slice(all_b, [0], array_ops.shape(labels_flat))
+  sampled_b = array_ops.slice(all_b, array_ops.shape(labels_flat), [-1])
+
+  # inputs shape is [batch_size, dim]
+  # true_w shape is [batch_size * num_true, dim]
+  # row_wise_dots is [batch_size, num_true, dim]
+  dim = array_ops.shape(true_w)[1:2]
+  new_true_w_shape = array_ops.concat([[-1, num_true], dim], 0)
+  row_wise_dots = math_ops.multiply(
+      array_ops.expand_dims(inputs, 1),
+      array_ops.reshape(true_w, new_true_w_shape))
+  # We want the row-wise dot plus biases which yields a
+  # [batch_size, num_true] tensor of true_logits.
+  dots_as_matrix = array_ops.reshape(row_wise_dots,
+                                     array_ops.concat([[-1], dim], 0))
+  true_logits = array_ops.reshape(_sum_rows(dots_as_matrix), [-1, num_true])
+  true_b = array_ops.reshape(true_b, [-1, num_true])
+  true_logits += true_b
+  sampled_logits += sampled_b
+  return (labels, sampled, true_expected_count, sampled_expected_count,
+          true_logits, sampled_logits)
+
+
 def _compute_sampled_logits(weights,
                             biases,
                             labels,
@@ -1778,81 +1871,10 @@ def _compute_sampled_logits(weights,
 
   with ops.name_scope(name, "compute_sampled_logits",
                       weights + [biases, inputs, labels]):
-    if labels.dtype != dtypes.int64:
-      labels = math_ops.cast(labels, dtypes.int64)
-    labels_flat = array_ops.reshape(labels, [-1])
-
-    # Sample the negative labels.
-    #   sampled shape: [num_sampled] tensor
-    #   true_expected_count shape = [batch_size, 1] tensor
-    #   sampled_expected_count shape = [num_sampled] tensor
-    if sampled_values is None:
-      sampled_values = candidate_sampling_ops.log_uniform_candidate_sampler(
-          true_classes=labels,
-          num_true=num_true,
-          num_sampled=num_sampled,
-          unique=True,
-          range_max=num_classes,
-          seed=seed)
-    # NOTE: pylint cannot tell that 'sampled_values' is a sequence
-    # pylint: disable=unpacking-non-sequence
-    sampled, true_expected_count, sampled_expected_count = (
-        array_ops.stop_gradient(s) for s in sampled_values)
-    # pylint: enable=unpacking-non-sequence
-    sampled = math_ops.cast(sampled, dtypes.int64)
-
-    # labels_flat is a [batch_size * num_true] tensor
-    # sampled is a [num_sampled] int tensor
-    all_ids = array_ops.concat([labels_flat, sampled], 0)
-
-    # Retrieve the true weights and the logits of the sampled weights.
-
-    # weights shape is [num_classes, dim]
-    all_w = embedding_ops.embedding_lookup(
-        weights, all_ids, partition_strategy=partition_strategy)
-    if all_w.dtype != inputs.dtype:
-      all_w = math_ops.cast(all_w, inputs.dtype)
-
-    # true_w shape is [batch_size * num_true, dim]
-    true_w = array_ops.slice(all_w, [0, 0],
-                             array_ops_stack.stack(
-                                 [array_ops.shape(labels_flat)[0], -1]))
-
-    sampled_w = array_ops.slice(
-        all_w,
-        array_ops_stack.stack([array_ops.shape(labels_flat)[0], 0]), [-1, -1])
-    # inputs has shape [batch_size, dim]
-    # sampled_w has shape [num_sampled, dim]
-    # Apply X*W', which yields [batch_size, num_sampled]
-    sampled_logits = math_ops.matmul(inputs, sampled_w, transpose_b=True)
-
-    # Retrieve the true and sampled biases, compute the true logits, and
-    # add the biases to the true and sampled logits.
-    all_b = embedding_ops.embedding_lookup(
-        biases, all_ids, partition_strategy=partition_strategy)
-    if all_b.dtype != inputs.dtype:
-      all_b = math_ops.cast(all_b, inputs.dtype)
-    # true_b is a [batch_size * num_true] tensor
-    # sampled_b is a [num_sampled] float tensor
-    true_b = array_ops.slice(all_b, [0], array_ops.shape(labels_flat))
-    sampled_b = array_ops.slice(all_b, array_ops.shape(labels_flat), [-1])
-
-    # inputs shape is [batch_size, dim]
-    # true_w shape is [batch_size * num_true, dim]
-    # row_wise_dots is [batch_size, num_true, dim]
-    dim = array_ops.shape(true_w)[1:2]
-    new_true_w_shape = array_ops.concat([[-1, num_true], dim], 0)
-    row_wise_dots = math_ops.multiply(
-        array_ops.expand_dims(inputs, 1),
-        array_ops.reshape(true_w, new_true_w_shape))
-    # We want the row-wise dot plus biases which yields a
-    # [batch_size, num_true] tensor of true_logits.
-    dots_as_matrix = array_ops.reshape(row_wise_dots,
-                                       array_ops.concat([[-1], dim], 0))
-    true_logits = array_ops.reshape(_sum_rows(dots_as_matrix), [-1, num_true])
-    true_b = array_ops.reshape(true_b, [-1, num_true])
-    true_logits += true_b
-    sampled_logits += sampled_b
+    (labels, sampled, true_expected_count, sampled_expected_count,
+     true_logits, sampled_logits) = _sampled_logits_parts(
+         weights, biases, labels, inputs, num_sampled, num_classes, num_true,
+         sampled_values, partition_strategy, seed)
 
     if remove_accidental_hits:
       acc_hits = candidate_sampling_ops.compute_accidental_hits(
@@ -2290,6 +2312,37 @@ def sampled_softmax_loss(weights,
       (https://aclanthology.coli.uni-saarland.de/papers/P15-1001/p15-1001)
       ([pdf](http://aclweb.org/anthology/P15-1001))
   """
+  # The fused op only has a CPU kernel.
+  if (inputs.dtype in (dtypes.float16, dtypes.bfloat16, dtypes.float32,
+                       dtypes.float64) and
+      compat.forward_compatible(2024, 3, 20) and
+      nn_ops._can_use_cpu_only_kernel(inputs)):  # pylint: disable=protected-access
+    # Computes the loss directly from the true and sampled logits, without
+    # concatenating them or materializing the labels.
+    if isinstance(weights, variables.PartitionedVariable):
+      weights = list(weights)
+    if not isinstance(weights, list):
+      weights = [weights]
+    with ops.name_scope(name, "sampled_softmax_loss",
+                        weights + [biases, inputs, labels]):
+      (labels, sampled, true_expected_count, sampled_expected_count,
+       true_logits, sampled_logits) = _sampled_logits_parts(
+           weights, biases, labels, inputs, num_sampled, num_classes,
+           num_true, sampled_values, partition_strategy, seed)
+      sampled_losses, _, _ = (
+          gen_nn_ops.sampled_softmax_cross_entropy_with_logits(
+              true_logits=true_logits,
+              sampled_logits=sampled_logits,
+              true_expected_count=array_ops.broadcast_to(
+                  math_ops.cast(true_expected_count, dtypes.float32),
+                  array_ops.shape(true_logits)),
+              sampled_expected_count=math_ops.cast(sampled_expected_count,
+                                                   dtypes.float32),
+              labels=labels,
+              sampled_candidates=sampled,
+              remove_accidental_hits=remove_accidental_hits))
+      return sampled_losses
+
   logits, labels = _compute_sampled_logits(
       weights=weights,
       biases=biases,
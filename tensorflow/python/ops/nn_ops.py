@@ -173,6 +173,7 @@ import numpy as np
 from tensorflow.python.eager import context
 from tensorflow.python.framework import config
 from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import device_spec
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import errors_impl
 from tensorflow.python.framework import graph_util
@@ -184,6 +185,7 @@ from tensorflow.python.framework import tensor_util
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import array_ops_stack
 from tensorflow.python.ops import check_ops
+from tensorflow.python.ops import control_flow_util
 from tensorflow.python.ops import gen_math_ops
 from tensorflow.python.ops import gen_nn_ops
 from tensorflow.python.ops import math_ops
@@ -218,6 +220,29 @@ _CHANNELS_LAST_FORMATS = frozenset({
 })
 
 
+def _can_use_cpu_only_kernel(value):
+  """Returns whether an op with only a CPU kernel should consume `value`.
+
+  That is the case outside of XLA and TPU compilation, if `value` is placed on
+  a CPU, or has no device and there are no accelerators to place it on.
+
+  Args:
+    value: A `Tensor`.
+
+  Returns:
+    A Python bool.
+  """
+  if device_context.enclosing_tpu_context() is not None:
+    return False
+  if control_flow_util.GraphOrParentsInXlaContext(ops.get_default_graph()):
+    return False
+  if value.device:
+    device = device_spec.DeviceSpecV2.from_string(value.device)
+    return device.device_type == "CPU"
+  return not (config.list_logical_devices("GPU") or
+              config.list_logical_devices("TPU"))
+
+
 def _get_sequence(value, n, channel_index, name):
   """Formats a value input for gen_nn_ops."""
   # Performance is fast-pathed for common cases:
@@ -5732,6 +5757,76 @@ def general_dropout(x, rate, uniform_sampler, noise_shape=None, name=None):
                   default_name="general_dropout")
 
 
+@tf_export("nn.experimental.scaled_dot_product_attention")
+@dispatch.add_dispatch_support
+def scaled_dot_product_attention(query,
+                                 key,
+                                 value,
+                                 key_lengths=None,
+                                 scale=None,
+                                 causal=False,
+                                 name=None):
+  """Computes scaled dot-product attention.
+
+  Computes `softmax(scale * query * key^T) * value` for every batch entry and
+  head. The fused kernel works on blocks of queries and keys, so the
+  `[query_length, key_length]` attention matrix is never materialized. It is
+  only available on CPU.
+
+  >>> query = tf.ones([1, 1, 2, 4])
+  >>> key = tf.ones([1, 1, 2, 4])
+  >>> value = tf.constant([[[[0.], [2.]]]])
+  >>> tf.nn.experimental.scaled_dot_product_attention(query, key, value)
+  <tf.Tensor: shape=(1, 1, 2, 1), dtype=float32, numpy=
+  array([[[[1.],
+           [1.]]]], dtype=float32)>
+
+  Args:
+    query: A 4-D `Tensor` of type `half`, `bfloat16`, `float32` or `float64`
+      and shape `[batch, heads, query_length, depth]`.
+    key: A `Tensor` of the same type as `query` and shape
+      `[batch, heads, key_length, depth]`.
+    value: A `Tensor` of the same type as `query` and shape
+      `[batch, heads, key_length, value_depth]`.
+    key_lengths: An optional 1-D int32 `Tensor` of shape `[batch]`. The number
+      of valid keys of each batch entry; the keys after them are masked.
+      Defaults to `key_length` for every batch entry.
+    scale: An optional float the query-key dot products are multiplied by.
+      Defaults to `1 / sqrt(depth)`.
+    causal: If true, query `i` only attends to the keys `j <= i`.
+    name: A name for the operation (optional).
+
+  Returns:
+    A `Tensor` of the same type as `query` and shape
+    `[batch, heads, query_length, value_depth]`. Queries that attend to no key
+    produce zeros.
+
+  Raises:
+    ValueError: If `query` is not 4-D, or if `scale` is not given and the depth
+      of `query` is unknown.
+  """
+  with ops.name_scope(name, "scaled_dot_product_attention",
+                      [query, key, value, key_lengths]) as name:
+    query = ops.convert_to_tensor(query, name="query")
+    key = ops.convert_to_tensor(key, dtype=query.dtype, name="key")
+    value = ops.convert_to_tensor(value, dtype=query.dtype, name="value")
+    if scale is None:
+      depth = tensor_shape.dimension_value(query.shape.with_rank(4)[-1])
+      if depth is None:
+        raise ValueError("`scale` is required when the depth of `query` is "
+                         f"unknown. Received: query.shape={query.shape}")
+      scale = 1.0 / np.sqrt(depth)
+    if key_lengths is None:
+      key_shape = array_ops.shape(key)
+      key_lengths = array_ops.fill(key_shape[:1], key_shape[2])
+    else:
+      key_lengths = ops.convert_to_tensor(
+          key_lengths, dtype=dtypes.int32, name="key_lengths")
+    output, _ = gen_nn_ops.scaled_dot_product_attention(
+        query, key, value, key_lengths, scale=scale, causal=causal, name=name)
+    return output
+
+
 def _dropout(x, rate, noise_shape, uniform_sampler, dummy_rng_step, name,
              default_name):
   """Shared implementation of the various dropout functions.
@@ -20,6 +20,8 @@ import math
 from absl.testing import parameterized
 import numpy as np
 
+from tensorflow.python.compat import compat
+from tensorflow.python.eager import backprop
 from tensorflow.python.eager import context
 from tensorflow.python.eager import def_function
 from tensorflow.python.framework import constant_op
@@ -973,6 +975,59 @@ class ComputeSampledLogitsTest(test_lib.TestCase):
     self.assertAllClose(exp_sampled_softmax_loss,
                         self.evaluate(got_sampled_softmax_loss), 1e-1)
 
+  def testSampledSoftmaxLossFusedMatchesUnfused(self):
+    np.random.seed(0)
+    num_classes = 6
+    batch_size = 4
+    num_true = 2
+    labels = [0, 1, 2, 3, 4, 5, 1, 3]
+    sampled = [1, 5, 2]
+    weights, biases, hidden_acts, sampled_vals, _, _ = self._GenerateTestData(
+        num_classes=num_classes,
+        dim=8,
+        batch_size=batch_size,
+        num_true=num_true,
+        labels=labels,
+        sampled=sampled,
+        subtract_log_q=True)
+    sampled_vals = (sampled_vals[0],
+                    np.full([batch_size, num_true], 0.5, dtype=np.float32),
+                    sampled_vals[2])
+    weights = constant_op.constant(weights)
+    biases = constant_op.constant(biases)
+    hidden_acts = constant_op.constant(hidden_acts)
+
+    def _LossAndGradients():
+      # The fused op is only used on the CPU.
+      with ops.device("/cpu:0"):
+        with backprop.GradientTape() as outer_tape:
+          outer_tape.watch(hidden_acts)
+          with backprop.GradientTape() as tape:
+            tape.watch([weights, biases, hidden_acts])
+            loss = nn_impl.sampled_softmax_loss_v2(
+                weights=weights,
+                biases=biases,
+                labels=constant_op.constant(
+                    labels, shape=(batch_size, num_true), dtype=dtypes.int64),
+                inputs=hidden_acts,
+                num_sampled=len(sampled),
+                num_classes=num_classes,
+                num_true=num_true,
+                sampled_values=sampled_vals,
+                remove_accidental_hits=True)
+          gradients = tape.gradient(loss, [weights, biases, hidden_acts])
+          # Differentiates the gradients again, through the backprop outputs.
+          gradient_norm = math_ops.reduce_sum(math_ops.square(gradients[2]))
+        second_order = outer_tape.gradient(gradient_norm, hidden_acts)
+      return [loss] + [ops.convert_to_tensor(g) for g in gradients
+                      ] + [second_order]
+
+    expected = self.evaluate(_LossAndGradients())
+    with compat.forward_compatibility_horizon(2024, 3, 21):
+      fused = self.evaluate(_LossAndGradients())
+    for expected_value, fused_value in zip(expected, fused):
+      self.assertAllClose(expected_value, fused_value, 1e-4)
+
 
 class CReluTest(test_lib.TestCase):
 
@@ -1131,6 +1186,53 @@ class SwishTest(test_lib.TestCase):
       self.assertAllClose(theoretical, numerical)
 
 
+@test_util.run_all_in_graph_and_eager_modes
+class ScaledDotProductAttentionTest(test_lib.TestCase):
+
+  def _attention(self, query, key, value, key_lengths, scale, causal):
+    scores = scale * np.einsum("bhqd,bhkd->bhqk", query, key)
+    query_length, key_length = scores.shape[2:]
+    positions = np.arange(key_length)
+    mask = positions[None, None, None, :] < np.reshape(key_lengths,
+                                                       [-1, 1, 1, 1])
+    if causal:
+      mask = mask & (positions[None, :] <= np.arange(query_length)[:, None])
+    scores = np.where(mask, scores, -np.inf)
+    probs = np.exp(scores - np.max(scores, axis=-1, keepdims=True))
+    probs /= np.sum(probs, axis=-1, keepdims=True)
+    return np.einsum("bhqk,bhkd->bhqd", probs, value)
+
+  def testValues(self):
+    np.random.seed(1)
+    query = np.random.randn(2, 3, 5, 4).astype(np.float32)
+    key = np.random.randn(2, 3, 7, 4).astype(np.float32)
+    value = np.random.randn(2, 3, 7, 6).astype(np.float32)
+    with ops.device("/CPU:0"):
+      output = nn_ops.scaled_dot_product_attention(query, key, value)
+    self.assertAllClose(
+        self._attention(query, key, value, [7, 7], 0.5, causal=False),
+        self.evaluate(output), rtol=1e-5, atol=1e-5)
+
+  def testKeyLengthsAndCausal(self):
+    np.random.seed(2)
+    query = np.random.randn(2, 1, 5, 4).astype(np.float32)
+    key = np.random.randn(2, 1, 5, 4).astype(np.float32)
+    value = np.random.randn(2, 1, 5, 3).astype(np.float32)
+    with ops.device("/CPU:0"):
+      output = nn_ops.scaled_dot_product_attention(
+          query, key, value, key_lengths=[5, 3], scale=0.3, causal=True)
+    self.assertAllClose(
+        self._attention(query, key, value, [5, 3], 0.3, causal=True),
+        self.evaluate(output), rtol=1e-5, atol=1e-5)
+
+  def testRequiresScaleForUnknownDepth(self):
+    with ops.Graph().as_default():
+      query = array_ops.placeholder_with_default(
+          np.ones([1, 1, 2, 4], np.float32), shape=[1, 1, 2, None])
+      with self.assertRaisesRegex(ValueError, "`scale` is required"):
+        nn_ops.scaled_dot_product_attention(query, query, query)
+
+
 class MomentsTest(test_lib.TestCase):
 
   def doOutputTest(self,
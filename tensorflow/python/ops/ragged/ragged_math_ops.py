@@ -19,6 +19,7 @@ import typing
 
 import numpy as np
 
+from tensorflow.python.compat import compat
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import errors
 from tensorflow.python.framework import ops
@@ -1079,12 +1080,48 @@ def softmax(logits: ragged_tensor.Ragged, axis=None, name=None):
     axis = -1
 
   with ops.name_scope(name, 'RaggedSoftmax', [logits]) as name:
+    if _can_use_ragged_softmax_kernel(logits, axis):
+      # Softmax over the single ragged dimension, computed row by row on the
+      # flat values without padding.
+      return logits.with_flat_values(
+          gen_ragged_math_ops.ragged_softmax(
+              logits.flat_values, logits.nested_row_splits[-1], name=name))
     max_input = reduce_max(logits, axis=axis, keepdims=True)
     logits_exp = math_ops.exp(math_ops.subtract(logits, max_input))
     denominator = reduce_sum(logits_exp, axis=axis, keepdims=True)
     return math_ops.divide(logits_exp, denominator)
 
 
+def _can_use_ragged_softmax_kernel(logits, axis):
+  """Returns true if `RaggedSoftmax` can compute `softmax(logits, axis)`."""
+  if not isinstance(logits, ragged_tensor.RaggedTensor):
+    return False
+  if logits.flat_values.shape.rank != 1:
+    return False
+  if not isinstance(axis, int) or axis not in (-1, logits.ragged_rank):
+    return False
+  if logits.dtype not in (dtypes.float16, dtypes.bfloat16, dtypes.float32,
+                          dtypes.float64):
+    return False
+  if not compat.forward_compatible(2024, 3, 20):
+    return False
+  # `RaggedSoftmax` only has a CPU kernel.
+  return nn_ops._can_use_cpu_only_kernel(logits.flat_values)  # pylint: disable=protected-access
+
+
+@ops.RegisterGradient('RaggedSoftmax')
+def _ragged_softmax_grad(op, grad):
+  """Gradients for RaggedSoftmax."""
+  softmax = op.outputs[0]
+  row_splits = op.inputs[1]
+  row_ids = segment_id_ops.row_splits_to_segment_ids(row_splits)
+  row_sums = math_ops.unsorted_segment_sum(
+      grad * softmax, row_ids, array_ops.shape(row_splits)[0] - 1)
+  d_logits = softmax * (grad - array_ops.gather(row_sums, row_ids))
+  # d_logits, d_row_splits.
+  return [d_logits, None]
+
+
 # ===============================================================================
 # ragged.add_n
 # ===============================================================================
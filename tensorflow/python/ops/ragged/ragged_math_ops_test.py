@@ -17,7 +17,10 @@
 from absl.testing import parameterized
 import numpy as np
 
+from tensorflow.python.compat import compat
+from tensorflow.python.eager import backprop
 from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import ops
 from tensorflow.python.framework import test_util
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import math_ops
@@ -104,6 +107,38 @@ class RaggedSoftmaxTest(test_util.TensorFlowTestCase, parameterized.TestCase):
     y_tf = nn_ops.softmax_v2(x_tf)
     self.assertAllClose(y_tf, y_expected_from_numpy, eps)
 
+  @test_util.run_in_graph_and_eager_modes
+  def testNestedRaggedTensor(self):
+    x_list = [[[1., 2.], [], [3.]], [[4., 5., 6.]]]
+    with compat.forward_compatibility_horizon(2024, 3, 21):
+      y_tf = nn_ops.softmax_v2(ragged_factory_ops.constant(x_list), axis=2)
+    y_expected = [[self._softmax(np.array([row]))[0].tolist() for row in rows]
+                  for rows in x_list]
+    self.assertAllClose(y_tf, ragged_factory_ops.constant(y_expected), 1e-5)
+
+  @test_util.run_in_graph_and_eager_modes
+  def testGradient(self):
+    x_list = [[1., 2., 3.], [], [-1., 4.]]
+    weights_list = [[0.5, -1., 2.], [], [3., 1.]]
+    # RaggedSoftmax is only used on the CPU.
+    with ops.device('/cpu:0'), compat.forward_compatibility_horizon(
+        2024, 3, 21):
+      x = ragged_factory_ops.constant(x_list)
+      weights = ragged_factory_ops.constant(weights_list)
+      with backprop.GradientTape() as tape:
+        tape.watch(x.flat_values)
+        y = nn_ops.softmax_v2(x)
+        loss = math_ops.reduce_sum(y.flat_values * weights.flat_values)
+      dx = tape.gradient(loss, x.flat_values)
+    dx_expected = []
+    for row, w in zip(x_list, weights_list):
+      if not row:
+        continue
+      y_row = self._softmax(np.array([row]))[0]
+      w = np.array(w)
+      dx_expected.extend(y_row * (w - np.sum(w * y_row)))
+    self.assertAllClose(dx, dx_expected, 1e-5)
+
 
 def _cumsum_slow(rt, axis=0, exclusive=False, reverse=False, name=None):
   dense = rt.to_tensor()
@@ -184,7 +184,8 @@ class AdagradOptimizer(optimizer.Optimizer):
         grad.indices,
         use_locking=self._use_locking)
 
-  def _resource_apply_sparse(self, grad, var, indices):
+  def _resource_apply_sparse(self, grad, var, indices,
+                             deduplicate_indices=False):
     acc = self.get_slot(var, "accumulator")
     return gen_training_ops.resource_sparse_apply_adagrad(
         var.handle,
@@ -192,4 +193,13 @@ class AdagradOptimizer(optimizer.Optimizer):
         math_ops.cast(self._learning_rate_tensor, grad.dtype),
         grad,
         indices,
-        use_locking=self._use_locking)
+        use_locking=self._use_locking,
+        deduplicate_indices=deduplicate_indices)
+
+  def _resource_apply_sparse_duplicate_indices(self, grad, handle, indices):
+    # pylint: disable=protected-access
+    if optimizer._can_deduplicate_in_sparse_apply(handle):
+      return self._resource_apply_sparse(
+          grad, handle, indices, deduplicate_indices=True)
+    return super()._resource_apply_sparse_duplicate_indices(
+        grad, handle, indices)
@@ -16,6 +16,7 @@
 
 import numpy as np
 
+from tensorflow.python.compat import compat
 from tensorflow.python.eager import context
 from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
@@ -229,6 +230,40 @@ class AdagradOptimizerTest(test.TestCase):
             self.assertAllCloseAccordingToType(
                 self.evaluate(var_repeated), self.evaluate(var_aggregated))
 
+  def testSparseRepeatedIndicesDeduplicatedInKernel(self):
+    with ops.Graph().as_default(), compat.forward_compatibility_horizon(
+        2024, 3, 21):
+      for dtype in [dtypes.float32, dtypes.float64]:
+        with self.cached_session() as sess:
+          initial_value = [[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]]
+          with ops.device("/device:CPU:0"):
+            var_repeated = resource_variable_ops.ResourceVariable(
+                initial_value, dtype=dtype)
+            var_aggregated = resource_variable_ops.ResourceVariable(
+                initial_value, dtype=dtype)
+          loss_repeated = math_ops.reduce_sum(
+              embedding_ops.embedding_lookup(var_repeated, [2, 0, 2, 2]))
+          loss_aggregated = math_ops.reduce_sum(
+              constant_op.constant([[1.0], [3.0]], dtype=dtype) *
+              embedding_ops.embedding_lookup(var_aggregated, [0, 2]))
+          update_op_repeated = adagrad.AdagradOptimizer(
+              2.0).minimize(loss_repeated)
+          update_op_aggregated = adagrad.AdagradOptimizer(
+              2.0).minimize(loss_aggregated)
+          apply_ops = [
+              op for op in sess.graph.get_operations()
+              if op.type == "ResourceSparseApplyAdagrad"
+          ]
+          self.assertLen(apply_ops, 2)
+          for op in apply_ops:
+            self.assertTrue(op.get_attr("deduplicate_indices"))
+          self.evaluate(variables.global_variables_initializer())
+          for _ in range(3):
+            update_op_repeated.run()
+            update_op_aggregated.run()
+            self.assertAllCloseAccordingToType(
+                self.evaluate(var_repeated), self.evaluate(var_aggregated))
+
   def testSparseStability(self):
     with ops.Graph().as_default():
       for dtype in [dtypes.half, dtypes.float32, dtypes.float64]:
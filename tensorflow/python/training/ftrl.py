@@ -258,7 +258,8 @@ class FtrlOptimizer(optimizer.Optimizer):
           math_ops.cast(self._learning_rate_power_tensor, var.dtype.base_dtype),
           use_locking=self._use_locking)
 
-  def _resource_apply_sparse(self, grad, var, indices):
+  def _resource_apply_sparse(self, grad, var, indices,
+                             deduplicate_indices=False):
     accum = self.get_slot(var, "accum")
     linear = self.get_slot(var, "linear")
     if self._l2_shrinkage_regularization_strength <= 0.0:
@@ -273,7 +274,8 @@ class FtrlOptimizer(optimizer.Optimizer):
           math_ops.cast(self._adjusted_l2_regularization_strength_tensor,
                         grad.dtype),
           math_ops.cast(self._learning_rate_power_tensor, grad.dtype),
-          use_locking=self._use_locking)
+          use_locking=self._use_locking,
+          deduplicate_indices=deduplicate_indices)
     else:
       return gen_training_ops.resource_sparse_apply_ftrl_v2(
           var.handle,
@@ -288,4 +290,13 @@ class FtrlOptimizer(optimizer.Optimizer):
           math_ops.cast(self._l2_shrinkage_regularization_strength_tensor,
                         grad.dtype),
           math_ops.cast(self._learning_rate_power_tensor, grad.dtype),
-          use_locking=self._use_locking)
+          use_locking=self._use_locking,
+          deduplicate_indices=deduplicate_indices)
+
+  def _resource_apply_sparse_duplicate_indices(self, grad, handle, indices):
+    # pylint: disable=protected-access
+    if optimizer._can_deduplicate_in_sparse_apply(handle):
+      return self._resource_apply_sparse(
+          grad, handle, indices, deduplicate_indices=True)
+    return super()._resource_apply_sparse_duplicate_indices(
+        grad, handle, indices)
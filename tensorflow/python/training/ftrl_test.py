@@ -16,6 +16,7 @@
 
 import numpy as np
 
+from tensorflow.python.compat import compat
 from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import indexed_slices
@@ -127,6 +128,46 @@ class FtrlOptimizerTest(test.TestCase):
                                              self.evaluate(var0),
                                              atol=0.01)
 
+  def testSparseRepeatedIndicesDeduplicatedInKernel(self):
+    with ops.Graph().as_default(), compat.forward_compatibility_horizon(
+        2024, 3, 21):
+      for l2_shrinkage in [0.0, 0.1]:
+        with self.cached_session() as sess:
+          initial_value = [[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]]
+          with ops.device("/device:CPU:0"):
+            var_repeated = resource_variable_ops.ResourceVariable(
+                initial_value, dtype=dtypes.float32)
+            var_aggregated = resource_variable_ops.ResourceVariable(
+                initial_value, dtype=dtypes.float32)
+          loss_repeated = math_ops.reduce_sum(
+              embedding_ops.embedding_lookup(var_repeated, [2, 0, 2, 2]))
+          loss_aggregated = math_ops.reduce_sum(
+              constant_op.constant([[1.0], [3.0]]) *
+              embedding_ops.embedding_lookup(var_aggregated, [0, 2]))
+          update_op_repeated = ftrl.FtrlOptimizer(
+              1.0,
+              l1_regularization_strength=0.1,
+              l2_shrinkage_regularization_strength=l2_shrinkage).minimize(
+                  loss_repeated)
+          update_op_aggregated = ftrl.FtrlOptimizer(
+              1.0,
+              l1_regularization_strength=0.1,
+              l2_shrinkage_regularization_strength=l2_shrinkage).minimize(
+                  loss_aggregated)
+          apply_ops = [
+              op for op in sess.graph.get_operations()
+              if op.type.startswith("ResourceSparseApplyFtrl")
+          ]
+          self.assertLen(apply_ops, 2)
+          for op in apply_ops:
+            self.assertTrue(op.get_attr("deduplicate_indices"))
+          self.evaluate(variables.global_variables_initializer())
+          for _ in range(3):
+            update_op_repeated.run()
+            update_op_aggregated.run()
+            self.assertAllClose(
+                self.evaluate(var_repeated), self.evaluate(var_aggregated))
+
   def testFtrlWithL1(self):
     # The v1 optimizers do not support eager execution
     with ops.Graph().as_default():
@@ -18,6 +18,7 @@
 
 import abc
 
+from tensorflow.python.compat import compat
 from tensorflow.python.distribute import distribute_lib
 from tensorflow.python.distribute import distribute_utils
 from tensorflow.python.distribute import reduce_util as ds_reduce_util
@@ -31,6 +32,7 @@ from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import control_flow_ops
 from tensorflow.python.ops import gradients
 from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import nn_ops
 from tensorflow.python.ops import resource_variable_ops
 from tensorflow.python.ops import state_ops
 from tensorflow.python.ops import variable_v1
@@ -76,6 +78,23 @@ def _deduplicate_indexed_slices(values, indices):
   return (summed_values, unique_indices)
 
 
+def _can_deduplicate_in_sparse_apply(var):
+  """Returns whether sparse apply kernels can sum duplicate indices of `var`.
+
+  Such kernels avoid the `unique` and `unsorted_segment_sum` of
+  `_deduplicate_indexed_slices`, but they are only available on CPU.
+
+  Args:
+    var: The variable to update.
+
+  Returns:
+    Whether `deduplicate_indices=True` can be passed to the sparse apply op.
+  """
+  if not compat.forward_compatible(2024, 3, 20):
+    return False
+  return nn_ops._can_use_cpu_only_kernel(var)  # pylint: disable=protected-access
+
+
 def _var_key(var):
   """Returns slot key for `var`."""
   # pylint: disable=protected-access
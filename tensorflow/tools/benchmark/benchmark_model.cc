@@ -20,10 +20,15 @@ limitations under the License.
 
 #include "tensorflow/tools/benchmark/benchmark_model.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/graph_constructor.h"
@@ -39,7 +44,9 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/init_main.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/platform.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/util/command_line_flags.h"
@@ -369,6 +376,56 @@ Status TimeMultipleRuns(double sleep_seconds, int num_runs, double max_time_s,
   return OkStatus();
 }
 
+Status TimeConcurrentRuns(int num_clients, int num_runs, double max_time_s,
+                          const std::vector<InputLayerInfo>& inputs,
+                          const std::vector<string>& outputs,
+                          const std::vector<string>& targets, Session* session,
+                          std::vector<int64_t>* latencies_us,
+                          int64_t* wall_time_us) {
+  LOG(INFO) << "Running benchmark for max " << num_runs << " iterations, max "
+            << max_time_s << " seconds from " << num_clients
+            << " concurrent clients";
+
+  latencies_us->clear();
+  mutex mu;
+  Status status;
+  std::atomic<int64_t> num_started(0);
+  const int64_t start_us = Env::Default()->NowMicros();
+  const int64_t deadline_us =
+      max_time_s > 0.0 ? start_us + static_cast<int64_t>(max_time_s * 1e6)
+                       : std::numeric_limits<int64_t>::max();
+  {
+    thread::ThreadPool clients(Env::Default(), "benchmark_clients",
+                               num_clients);
+    for (int i = 0; i < num_clients; ++i) {
+      clients.Schedule([&]() {
+        while ((num_runs <= 0 || num_started.fetch_add(1) < num_runs) &&
+               Env::Default()->NowMicros() < deadline_us) {
+          int64_t time;
+          Status run_status =
+              RunBenchmark(inputs, outputs, targets, session, nullptr, &time);
+          mutex_lock l(mu);
+          if (!run_status.ok()) {
+            status.Update(run_status);
+            return;
+          }
+          latencies_us->push_back(time);
+        }
+      });
+    }
+  }
+  *wall_time_us = Env::Default()->NowMicros() - start_us;
+  return status;
+}
+
+int64_t Percentile(const std::vector<int64_t>& sorted_values,
+                   double percentile) {
+  const int64_t rank = static_cast<int64_t>(
+      std::ceil(percentile / 100.0 * sorted_values.size()));
+  return sorted_values[std::clamp<int64_t>(rank - 1, 0,
+                                           sorted_values.size() - 1)];
+}
+
 int Main(int argc, char** argv) {
   string graph = "/data/local/tmp/tensorflow_inception_graph.pb";
   string init_ops_string = "";
@@ -396,6 +453,7 @@ int Main(int argc, char** argv) {
   bool show_summary = true;
   bool show_flops = false;
   int warmup_runs = 1;
+  int num_clients = 0;
 
   std::vector<Flag> flag_list = {
       Flag("graph", &graph, "graph file name"),
@@ -431,6 +489,9 @@ int Main(int argc, char** argv) {
            "whether to show a summary of the stats"),
       Flag("show_flops", &show_flops, "whether to estimate the model's FLOPs"),
       Flag("warmup_runs", &warmup_runs, "how many runs to initialize model"),
+      Flag("num_clients", &num_clients,
+           "if positive, also run the model from this many concurrent clients "
+           "and report latency percentiles"),
   };
   string usage = Flags::Usage(argv[0], flag_list);
   const bool parse_result = Flags::Parse(&argc, argv, flag_list);
@@ -488,6 +549,7 @@ int Main(int argc, char** argv) {
   LOG(INFO) << "Output prefix: [" << output_prefix << "]";
   LOG(INFO) << "Show sizes: [" << show_sizes << "]";
   LOG(INFO) << "Warmup runs: [" << warmup_runs << "]";
+  LOG(INFO) << "Num clients: [" << num_clients << "]";
 
   std::unique_ptr<Session> session;
   std::unique_ptr<StatSummarizer> stats;
@@ -619,6 +681,33 @@ int Main(int argc, char** argv) {
             << "no stats: " << no_stat_time_us / no_stat_num_runs << ", "
             << "with stats: " << stat_time_us / stat_num_runs;
 
+  // If requested, measure the latency distribution and throughput of the model
+  // under concurrent load, as seen by a server.
+  std::vector<int64_t> concurrent_latencies_us;
+  int64_t concurrent_time_us = 0;
+  if (num_clients > 0) {
+    SleepSeconds(inter_benchmark_sleep_seconds);
+    Status concurrent_status = TimeConcurrentRuns(
+        num_clients, max_num_runs, max_benchmark_time_seconds, inputs,
+        output_layers, target_layers, session.get(), &concurrent_latencies_us,
+        &concurrent_time_us);
+    if (!concurrent_status.ok()) {
+      LOG(ERROR) << "Timing failed with " << concurrent_status;
+      return -1;
+    }
+    std::sort(concurrent_latencies_us.begin(), concurrent_latencies_us.end());
+  }
+  if (!concurrent_latencies_us.empty()) {
+    LOG(INFO) << "Concurrent inference latencies in us with " << num_clients
+              << " clients: "
+              << "p50: " << Percentile(concurrent_latencies_us, 50) << ", "
+              << "p90: " << Percentile(concurrent_latencies_us, 90) << ", "
+              << "p99: " << Percentile(concurrent_latencies_us, 99) << ", "
+              << "p99.9: " << Percentile(concurrent_latencies_us, 99.9);
+    LOG(INFO) << "Concurrent inferences/second: "
+              << concurrent_latencies_us.size() * 1e6 / concurrent_time_us;
+  }
+
   stats->PrintStepStats();
 
   if (show_sizes) {
@@ -683,6 +772,22 @@ int Main(int argc, char** argv) {
         output_prefix, benchmark_name, "meta-init-plus-first-inference", 1,
         initialization_time_s + (warmup_time_us / 1000000.0) / warmup_runs);
 
+    // Concurrent inference throughput and latency percentiles.
+    if (!concurrent_latencies_us.empty()) {
+      RecordBenchmarkEntry(output_prefix, benchmark_name, "concurrent",
+                           concurrent_latencies_us.size(),
+                           concurrent_time_us / 1000000.0);
+      for (const auto& [postfix, percentile] :
+           std::vector<std::pair<string, double>>{{"concurrent-p50", 50},
+                                                  {"concurrent-p90", 90},
+                                                  {"concurrent-p99", 99},
+                                                  {"concurrent-p99.9", 99.9}}) {
+        RecordBenchmarkEntry(
+            output_prefix, benchmark_name, postfix, 1,
+            Percentile(concurrent_latencies_us, percentile) / 1000000.0);
+      }
+    }
+
     std::map<std::string, int64_t> node_type_map_count;
     std::map<std::string, int64_t> node_type_map_time;
     std::map<std::string, int64_t> node_type_map_memory;
@@ -49,6 +49,21 @@ Status TimeMultipleRuns(double sleep_seconds, int num_runs, double max_time_s,
                         StatSummarizer* stats, int64_t* total_time_us,
                         int64_t* actual_num_runs);
 
+// Runs the model from `num_clients` threads at once until `num_runs` runs have
+// started or `max_time_s` seconds have passed, keeping track of the latency of
+// every run and of the elapsed wall time.
+Status TimeConcurrentRuns(int num_clients, int num_runs, double max_time_s,
+                          const std::vector<InputLayerInfo>& inputs,
+                          const std::vector<string>& outputs,
+                          const std::vector<string>& targets, Session* session,
+                          std::vector<int64_t>* latencies_us,
+                          int64_t* wall_time_us);
+
+// Returns the `percentile` (between 0 and 100) of the non-empty, ascending
+// `sorted_values`, using the nearest-rank method.
+int64_t Percentile(const std::vector<int64_t>& sorted_values,
+                   double percentile);
+
 // Handles all setup and argument parsing.
 int Main(int argc, char** argv);
 
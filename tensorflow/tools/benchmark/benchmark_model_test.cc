@@ -100,5 +100,37 @@ TEST(BenchmarkModeTest, TextProto) {
   ASSERT_EQ(num_runs, 10);
 }
 
+TEST(BenchmarkModelTest, TimeConcurrentRuns) {
+  const string dir = testing::TmpDir();
+  const string filename_pb = io::JoinPath(dir, "graphdef.pb");
+  auto root = Scope::NewRootScope().ExitOnError();
+
+  benchmark_model::InputLayerInfo input;
+  string output_name;
+  GraphDef graph_def;
+  CreateTestGraph(root, &input, &output_name, &graph_def);
+  TF_ASSERT_OK(WriteBinaryProto(Env::Default(), filename_pb, graph_def));
+
+  std::unique_ptr<Session> session;
+  std::unique_ptr<GraphDef> loaded_graph_def;
+  TF_ASSERT_OK(benchmark_model::InitializeSession(1, filename_pb, &session,
+                                                  &loaded_graph_def));
+  std::vector<int64_t> latencies_us;
+  int64_t wall_time_us;
+  TF_ASSERT_OK(benchmark_model::TimeConcurrentRuns(
+      4, 10, 0.0, {input}, {output_name}, {}, session.get(), &latencies_us,
+      &wall_time_us));
+  ASSERT_EQ(latencies_us.size(), 10);
+}
+
+TEST(BenchmarkModelTest, Percentile) {
+  const std::vector<int64_t> values = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  EXPECT_EQ(benchmark_model::Percentile(values, 0), 1);
+  EXPECT_EQ(benchmark_model::Percentile(values, 50), 5);
+  EXPECT_EQ(benchmark_model::Percentile(values, 90), 9);
+  EXPECT_EQ(benchmark_model::Percentile(values, 99), 10);
+  EXPECT_EQ(benchmark_model::Percentile(values, 100), 10);
+}
+
 }  // namespace
 }  // namespace tensorflow
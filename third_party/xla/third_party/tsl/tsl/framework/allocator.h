@@ -226,6 +226,10 @@ class Allocator {
   // REQUIRES: GetStats is overridden.
   virtual bool ClearStats() TF_MUST_USE_RESULT { return false; }
 
+  // If implemented, returns the cached memory that holds no allocations to
+  // the system. Returns the number of bytes released.
+  virtual size_t ReleaseFreeMemory() { return 0; }
+
   virtual void SetSafeFrontier(uint64 count) {}
 
   // For allocator that are stream aware, allow to specify the compute
@@ -289,6 +293,8 @@ class AllocatorWrapper : public Allocator {
     return wrapped_->AllocatedSizeSlow(ptr);
   }
 
+  size_t ReleaseFreeMemory() override { return wrapped_->ReleaseFreeMemory(); }
+
   AllocatorMemoryType GetMemoryType() const override {
     return wrapped_->GetMemoryType();
   }
@@ -327,28 +327,9 @@ bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes)
     return false;
   }
 
-  // Searching for free regions.
-  absl::flat_hash_set<void*> free_region_ptrs;
   size_t total_free_bytes = 0;
-  for (const AllocationRegion& region : region_manager_.regions()) {
-    ChunkHandle h = region_manager_.get_handle(region.ptr());
-    bool any_use = false;
-    while (h != kInvalidChunkHandle) {
-      const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
-        any_use = true;
-        break;
-      }
-      h = c->next;
-    }
-
-    if (!any_use) {
-      VLOG(2) << "Found free region with ptr = " << region.ptr();
-      free_region_ptrs.insert(region.ptr());
-      total_free_bytes += region.memory_size();
-    }
-  }
-
+  absl::flat_hash_set<void*> free_region_ptrs =
+      FindFreeRegions(&total_free_bytes);
   if (total_free_bytes == 0) {
     return false;
   }
@@ -376,6 +357,47 @@ bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes)
   return true;
 }
 
+size_t BFCAllocator::ReleaseFreeMemory() {
+  mutex_lock l(lock_);
+  size_t total_free_bytes = 0;
+  absl::flat_hash_set<void*> free_region_ptrs =
+      FindFreeRegions(&total_free_bytes);
+  if (total_free_bytes > 0) {
+    VLOG(1) << Name() << " releasing " << free_region_ptrs.size()
+            << " free regions of " << total_free_bytes << " bytes";
+    DeallocateRegions(free_region_ptrs);
+  }
+  return total_free_bytes;
+}
+
+absl::flat_hash_set<void*> BFCAllocator::FindFreeRegions(
+    size_t* total_free_bytes) {
+  absl::flat_hash_set<void*> free_region_ptrs;
+  *total_free_bytes = 0;
+  for (const AllocationRegion& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    bool any_use = false;
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      // Chunks freed after the safe frontier may still be read by pending
+      // device work.
+      if (c->in_use() || (c->freed_at_count > 0 &&
+                          c->freed_at_count >= safe_frontier_)) {
+        any_use = true;
+        break;
+      }
+      h = c->next;
+    }
+
+    if (!any_use) {
+      VLOG(2) << "Found free region with ptr = " << region.ptr();
+      free_region_ptrs.insert(region.ptr());
+      *total_free_bytes += region.memory_size();
+    }
+  }
+  return free_region_ptrs;
+}
+
 void BFCAllocator::DeallocateRegions(
     const absl::flat_hash_set<void*>& region_ptrs)
     TF_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
@@ -508,6 +530,7 @@ int64_t BFCAllocator::LargestFreeChunk() {
 double BFCAllocator::GetFragmentation() {
   int64_t bytes_available = *stats_.pool_bytes - stats_.bytes_in_use;
   DCHECK_GE(bytes_available, 0);
+  if (bytes_available == 0) return 0;
   return static_cast<double>(bytes_available - LargestFreeChunk()) /
          bytes_available;
 }
@@ -1207,7 +1230,9 @@ MemoryDump BFCAllocator::RecordMemoryMapInternal() {
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
   mutex_lock l(lock_);
-  return stats_;
+  AllocatorStats stats = stats_;
+  stats.largest_free_block_bytes = LargestFreeChunk();
+  return stats;
 }
 
 bool BFCAllocator::ClearStats() {
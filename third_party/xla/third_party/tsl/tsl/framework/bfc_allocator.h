@@ -101,6 +101,13 @@ class BFCAllocator : public Allocator {
 
   void SetSafeFrontier(uint64 count) override;
 
+  // Returns the regions that hold no allocations to the sub-allocator, so that
+  // later allocations are served from new regions rather than from the free
+  // chunks left between long-lived allocations. Meant to be called at step
+  // boundaries when the stats show that `largest_free_block_bytes` is a small
+  // part of the free memory. Returns the number of bytes released.
+  size_t ReleaseFreeMemory() override;
+
   AllocatorMemoryType GetMemoryType() const override;
 
   bool ShouldRecordOpName() const { return true; }
@@ -462,6 +469,11 @@ class BFCAllocator : public Allocator {
   // found and freed; false otherwise.
   bool DeallocateFreeRegions(size_t rounded_bytes);
 
+  // Returns the regions that hold no allocations and sets `total_free_bytes`
+  // to their total size.
+  absl::flat_hash_set<void*> FindFreeRegions(size_t* total_free_bytes)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Helper function to deallocate regions.
   void DeallocateRegions(const absl::flat_hash_set<void*>& region_ptrs)
       TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
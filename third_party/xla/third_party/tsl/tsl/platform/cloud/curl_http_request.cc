@@ -20,6 +20,7 @@ limitations under the License.
 #include "tsl/lib/gtl/map_util.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/macros.h"
+#include "tsl/platform/mutex.h"
 #include "tsl/platform/scanner.h"
 #include "tsl/platform/str_util.h"
 #include "tsl/platform/types.h"
@@ -45,6 +46,12 @@ class LibCurlProxy : public LibCurl {
     return libcurl;
   }
 
+  // Returns the share handle through which all requests made with the real
+  // libcurl share their connection cache, DNS cache and TLS sessions, so a
+  // new request reuses a connection opened by an earlier one. Null if curl
+  // could not create it.
+  CURLSH* share() const { return share_; }
+
   CURL* curl_easy_init() override { return ::curl_easy_init(); }
 
   CURLcode curl_easy_setopt(CURL* curl, CURLoption option,
@@ -112,10 +119,47 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_free(void* p) override { ::curl_free(p); }
+
+ private:
+  LibCurlProxy() {
+    share_ = curl_share_init();
+    if (share_ == nullptr) {
+      LOG(WARNING) << "Couldn't initialize a curl share; connections will not "
+                      "be reused across requests.";
+      return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &LibCurlProxy::LockShare);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC,
+                      &LibCurlProxy::UnlockShare);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  }
+
+  static void LockShare(CURL* curl, curl_lock_data data,
+                        curl_lock_access access, void* userptr) {
+    static_cast<LibCurlProxy*>(userptr)->share_mu_[data].lock();
+  }
+
+  static void UnlockShare(CURL* curl, curl_lock_data data, void* userptr) {
+    static_cast<LibCurlProxy*>(userptr)->share_mu_[data].unlock();
+  }
+
+  CURLSH* share_ = nullptr;
+  // One mutex per kind of shared data, so that e.g. DNS lookups do not
+  // serialize behind connection cache accesses.
+  mutex share_mu_[CURL_LOCK_DATA_LAST];
 };
 }  // namespace
 
-CurlHttpRequest::CurlHttpRequest() : CurlHttpRequest(LibCurlProxy::Load()) {}
+CurlHttpRequest::CurlHttpRequest() : CurlHttpRequest(LibCurlProxy::Load()) {
+  CURLSH* share = LibCurlProxy::Load()->share();
+  if (share != nullptr) {
+    CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_SHARE,
+                                             static_cast<void*>(share)));
+  }
+}
 
 CurlHttpRequest::CurlHttpRequest(LibCurl* libcurl, Env* env)
     : libcurl_(libcurl), env_(env) {
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
 
 #ifndef _WIN32
 #include <unistd.h>
@@ -30,6 +31,7 @@ limitations under the License.
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -846,6 +848,11 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
     max_bytes = value * 1024 * 1024;
   }
 
+  if (GetEnvVar(kReadParallelism, strings::safe_strtou64, &value) &&
+      value > 0) {
+    SetReadParallelism(value);
+  }
+
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
@@ -1091,6 +1098,18 @@ std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
   return file_block_cache;
 }
 
+void GcsFileSystem::SetReadParallelism(size_t read_parallelism,
+                                       size_t min_chunk_size) {
+  read_parallelism_ = std::max<size_t>(1, read_parallelism);
+  min_parallel_read_chunk_size_ = std::max<size_t>(1, min_chunk_size);
+  read_thread_pool_.reset();
+  // The first chunk of every split read is sent on the reading thread.
+  if (read_parallelism_ > 1) {
+    read_thread_pool_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "gcs_read", read_parallelism_ - 1);
+  }
+}
+
 // A helper function to actually read the data from GCS.
 Status GcsFileSystem::LoadBufferFromGCS(const string& fname, size_t offset,
                                         size_t n, char* buffer,
@@ -1103,24 +1122,58 @@ Status GcsFileSystem::LoadBufferFromGCS(const string& fname, size_t offset,
   profiler::TraceMe activity(
       [fname]() { return absl::StrCat("LoadBufferFromGCS ", fname); });
 
-  std::unique_ptr<HttpRequest> request;
-  TF_RETURN_WITH_CONTEXT_IF_ERROR(CreateHttpRequest(&request),
-                                  "when reading gs://", bucket, "/", object);
-
-  request->SetUri(strings::StrCat("https://", kStorageHost, "/", bucket, "/",
-                                  request->EscapeString(object)));
-  request->SetRange(offset, offset + n - 1);
-  request->SetResultBufferDirect(buffer, n);
-  request->SetTimeouts(timeouts_.connect, timeouts_.idle, timeouts_.read);
+  // Large reads are split into up to `read_parallelism_` range requests of at
+  // least `min_parallel_read_chunk_size_` bytes each, which are sent
+  // concurrently.
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min(read_parallelism_, n / min_parallel_read_chunk_size_));
+  const size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+  std::vector<std::unique_ptr<HttpRequest>> requests(num_chunks);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    const size_t chunk_offset = i * chunk_size;
+    const size_t chunk_n = std::min(chunk_size, n - chunk_offset);
+    std::unique_ptr<HttpRequest>& request = requests[i];
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(CreateHttpRequest(&request),
+                                    "when reading gs://", bucket, "/", object);
+
+    request->SetUri(strings::StrCat("https://", kStorageHost, "/", bucket, "/",
+                                    request->EscapeString(object)));
+    request->SetRange(offset + chunk_offset,
+                      offset + chunk_offset + chunk_n - 1);
+    request->SetResultBufferDirect(buffer + chunk_offset, chunk_n);
+    request->SetTimeouts(timeouts_.connect, timeouts_.idle, timeouts_.read);
+  }
 
   if (stats_ != nullptr) {
     stats_->RecordBlockLoadRequest(fname, offset);
   }
 
-  TF_RETURN_WITH_CONTEXT_IF_ERROR(request->Send(), " when reading gs://",
-                                  bucket, "/", object);
+  std::vector<Status> statuses(num_chunks);
+  {
+    // All but the first request are sent by the read thread pool.
+    absl::BlockingCounter pending(num_chunks - 1);
+    for (size_t i = 1; i < num_chunks; ++i) {
+      read_thread_pool_->Schedule([&requests, &statuses, &pending, i]() {
+        statuses[i] = requests[i]->Send();
+        pending.DecrementCount();
+      });
+    }
+    statuses[0] = requests[0]->Send();
+    pending.Wait();
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(status, " when reading gs://", bucket, "/",
+                                    object);
+  }
 
-  size_t bytes_read = request->GetResultBufferDirectBytesTransferred();
+  // Only the bytes up to the first short chunk are contiguous.
+  size_t bytes_read = 0;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    const size_t chunk_bytes =
+        requests[i]->GetResultBufferDirectBytesTransferred();
+    bytes_read += chunk_bytes;
+    if (chunk_bytes < std::min(chunk_size, n - i * chunk_size)) break;
+  }
   *bytes_transferred = bytes_read;
   VLOG(1) << "Successful read of gs://" << bucket << "/" << object << " @ "
           << offset << " of size: " << bytes_read;
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_TSL_PLATFORM_CLOUD_GCS_FILE_SYSTEM_H_
 #define TENSORFLOW_TSL_PLATFORM_CLOUD_GCS_FILE_SYSTEM_H_
 
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -32,6 +33,7 @@ limitations under the License.
 #include "tsl/platform/file_system.h"
 #include "tsl/platform/retrying_file_system.h"
 #include "tsl/platform/status.h"
+#include "tsl/platform/threadpool.h"
 
 namespace tsl {
 
@@ -62,6 +64,12 @@ constexpr size_t kDefaultMaxCacheSize = 0;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that overrides the maximum number of concurrent
+// range requests a single read from GCS is split into. Defaults to 1, i.e. one
+// request per read.
+constexpr char kReadParallelism[] = "GCS_READ_PARALLELISM";
+// Reads are only split into range requests of at least this many bytes.
+constexpr size_t kMinParallelReadChunkSize = 8 * 1024 * 1024;
 
 // Helper function to extract an environment variable and convert it into a
 // value of type T.
@@ -225,6 +233,15 @@ class GcsFileSystem : public FileSystem {
   uint64 stat_cache_max_age() const { return stat_cache_->max_age(); }
   size_t stat_cache_max_entries() const { return stat_cache_->max_entries(); }
 
+  size_t read_parallelism() const { return read_parallelism_; }
+
+  /// \brief Sets how many concurrent range requests a read from GCS is split
+  /// into, and the minimum size of each of them.
+  ///
+  /// Must not be called while files of this file system are being read.
+  void SetReadParallelism(size_t read_parallelism,
+                          size_t min_chunk_size = kMinParallelReadChunkSize);
+
   uint64 matching_paths_cache_max_age() const {
     return matching_paths_cache_->max_age();
   }
@@ -415,6 +432,14 @@ class GcsFileSystem : public FileSystem {
   // Reads smaller than block_size_ will trigger a read of block_size_.
   uint64 block_size_;
 
+  // The maximum number of concurrent range requests of one read from GCS, and
+  // the minimum size of each of them.
+  size_t read_parallelism_ = 1;
+  size_t min_parallel_read_chunk_size_ = kMinParallelReadChunkSize;
+  // Sends the range requests of split reads. Only set if read_parallelism_ is
+  // greater than one.
+  std::unique_ptr<thread::ThreadPool> read_thread_pool_;
+
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
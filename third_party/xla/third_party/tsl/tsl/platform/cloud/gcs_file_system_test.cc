@@ -105,6 +105,73 @@ TEST(GcsFileSystemTest, NewRandomAccessFile_NoBlockCache) {
   EXPECT_EQ("6789", result);
 }
 
+TEST(GcsFileSystemTest, NewRandomAccessFile_NoBlockCache_ParallelReads) {
+  std::vector<HttpRequest*> requests(
+      {new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com./bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 0-1\n"
+           "Timeouts: 5 1 20\n",
+           "01"),
+       new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com./bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 2-3\n"
+           "Timeouts: 5 1 20\n",
+           "23"),
+       new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com./bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 4-5\n"
+           "Timeouts: 5 1 20\n",
+           "45"),
+       new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com./bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 6-7\n"
+           "Timeouts: 5 1 20\n",
+           "67"),
+       new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com./bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 8-9\n"
+           "Timeouts: 5 1 20\n",
+           "8"),
+       new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com./bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 10-11\n"
+           "Timeouts: 5 1 20\n",
+           "")});
+  GcsFileSystem fs(
+      std::unique_ptr<AuthProvider>(new FakeAuthProvider),
+      std::unique_ptr<HttpRequest::Factory>(
+          new FakeHttpRequestFactory(&requests)),
+      std::unique_ptr<ZoneProvider>(new FakeZoneProvider), 0 /* block size */,
+      0 /* max bytes */, 0 /* max staleness */, 0 /* stat cache max age */,
+      0 /* stat cache max entries */, 0 /* matching paths cache max age */,
+      0 /* matching paths cache max entries */, kTestRetryConfig,
+      kTestTimeoutConfig, *kAllowedLocationsDefault,
+      nullptr /* gcs additional header */, false /* compose append */);
+  fs.SetReadParallelism(3, /*min_chunk_size=*/2);
+
+  std::unique_ptr<RandomAccessFile> file;
+  TF_EXPECT_OK(
+      fs.NewRandomAccessFile("gs://bucket/random_access.txt", nullptr, &file));
+
+  char scratch[6];
+  StringPiece result;
+
+  // Each read is split into three range requests of two bytes.
+  TF_EXPECT_OK(file->Read(0, sizeof(scratch), &result, scratch));
+  EXPECT_EQ("012345", result);
+
+  // The second read ends in the middle of its second range request.
+  EXPECT_TRUE(errors::IsOutOfRange(
+      file->Read(sizeof(scratch), sizeof(scratch), &result, scratch)));
+  EXPECT_EQ("678", result);
+}
+
 TEST(GcsFileSystemTest, NewRandomAccessFile_Buffered) {
   std::vector<HttpRequest*> requests({
       new FakeHttpRequest(
@@ -3657,6 +3724,13 @@ TEST(GcsFileSystemTest, OverrideCacheParameters) {
   EXPECT_EQ(1048576L, fs3.block_size());
   EXPECT_EQ(16 * 1024 * 1024, fs3.max_bytes());
   EXPECT_EQ(60, fs3.max_staleness());
+  EXPECT_EQ(1, fs3.read_parallelism());
+
+  // Verify read parallelism override.
+  setenv("GCS_READ_PARALLELISM", "4", 1);
+  GcsFileSystem fs_parallel;
+  EXPECT_EQ(4, fs_parallel.read_parallelism());
+  unsetenv("GCS_READ_PARALLELISM");
 
   // Verify StatCache and MatchingPathsCache overrides.
   setenv("GCS_STAT_CACHE_MAX_AGE", "60", 1);
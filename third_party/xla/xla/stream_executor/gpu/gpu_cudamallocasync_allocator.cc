@@ -28,6 +28,7 @@ limitations under the License.
 #include "xla/stream_executor/cuda/cuda_activation.h"
 #endif  // GOOGLE_CUDA
 
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "xla/stream_executor/gpu/gpu_init.h"  // IWYU pragma: keep
@@ -36,6 +37,8 @@ limitations under the License.
 #include "tsl/framework/device_id.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/mutex.h"
+#include "tsl/profiler/lib/scoped_memory_debug_annotation.h"
+#include "tsl/profiler/lib/traceme.h"
 #include "tsl/util/env_var.h"  // IWYU pragma: keep
 
 namespace stream_executor {
@@ -180,7 +183,17 @@ GpuCudaMallocAsyncAllocator::GpuCudaMallocAsyncAllocator(
   VLOG(1) << Name() << " CudaMallocAsync initialized on platform: "
           << platform_device_id.value() << " with pool size of: " << pool_size
           << " this ptr: " << this;
-  uint64_t pool_size_64 = pool_size;
+  int64_t release_threshold = 0;
+  absl::Status threshold_status = tsl::ReadInt64FromEnvVar(
+      "TF_CUDA_MALLOC_ASYNC_RELEASE_THRESHOLD", pool_size, &release_threshold);
+  if (!threshold_status.ok() || release_threshold < 0) {
+    LOG(ERROR) << "Invalid TF_CUDA_MALLOC_ASYNC_RELEASE_THRESHOLD, the pool "
+                  "size is used instead: "
+               << threshold_status;
+    release_threshold = pool_size;
+  }
+  uint64_t pool_size_64 = release_threshold;
+  VLOG(1) << Name() << " release threshold: " << pool_size_64;
   if (auto status = cuMemPoolSetAttribute(
           pool_, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD, &pool_size_64))
     LOG(FATAL) <<  // Crash OK.
@@ -333,6 +346,7 @@ void* GpuCudaMallocAsyncAllocator::AllocateRaw(size_t alignment,
         std::max<std::size_t>(stats_->largest_alloc_size, num_bytes);
     bool ptr_inserted = size_map_.emplace(ptr, num_bytes).second;
     DCHECK(ptr_inserted);
+    AddTraceMe("MemoryAllocation", ptr, num_bytes);
   }
   VLOG(10) << Name() << " Allocated " << num_bytes << " at " << ptr;
   return ptr;
@@ -375,6 +389,7 @@ void GpuCudaMallocAsyncAllocator::DeallocateRaw(void* ptr) {
     size_t size = size_map_[ptr];
     stats_->bytes_in_use -= size;
     size_map_.erase(ptr);
+    AddTraceMe("MemoryDeallocation", ptr, size);
   }
 
   VLOG(10) << Name() << " Freed ptr: " << ptr;
@@ -397,10 +412,54 @@ size_t GpuCudaMallocAsyncAllocator::AllocatedSize(const void* ptr) const {
   return size_map_.at(ptr);
 }
 
+void GpuCudaMallocAsyncAllocator::AddTraceMe(absl::string_view traceme_name,
+                                             const void* ptr,
+                                             int64_t num_bytes) {
+  tsl::profiler::TraceMe::InstantActivity(
+      [this, traceme_name, ptr, num_bytes]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+        const auto& annotation =
+            tsl::profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation();
+        const auto op_name = annotation.pending_op_name
+                                 ? annotation.pending_op_name
+                                 : "(null)";
+        const auto region_type = annotation.pending_region_type
+                                     ? annotation.pending_region_type
+                                     : "(null)";
+        return tsl::profiler::TraceMeEncode(
+            traceme_name, {{"allocator_name", name_},
+                           {"bytes_allocated", stats_->bytes_in_use},
+                           {"peak_bytes_in_use", stats_->peak_bytes_in_use},
+                           {"requested_bytes", num_bytes},
+                           {"allocation_bytes", num_bytes},
+                           {"addr", reinterpret_cast<uint64_t>(ptr)},
+                           {"tf_op", op_name},
+                           {"id", annotation.pending_step_id},
+                           {"region_type", region_type},
+                           {"data_type", annotation.pending_data_type},
+                           {"shape", annotation.pending_shape_func()}});
+      },
+      /*level=*/tsl::profiler::TraceMeLevel::kInfo);
+}
+
 std::optional<tsl::AllocatorStats> GpuCudaMallocAsyncAllocator::GetStats() {
   if (!stats_) return std::nullopt;
   tsl::mutex_lock l(lock_);
-  return *stats_;
+  tsl::AllocatorStats stats = *stats_;
+#if TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  // The pool holds freed memory up to the release threshold, which is
+  // reported as held by the allocator while not in use.
+  uint64_t reserved_current = 0;
+  uint64_t reserved_high = 0;
+  if (pool_ != nullptr &&
+      cuMemPoolGetAttribute(pool_, CU_MEMPOOL_ATTR_RESERVED_MEM_CURRENT,
+                            &reserved_current) == CUDA_SUCCESS &&
+      cuMemPoolGetAttribute(pool_, CU_MEMPOOL_ATTR_RESERVED_MEM_HIGH,
+                            &reserved_high) == CUDA_SUCCESS) {
+    stats.pool_bytes = reserved_current;
+    stats.peak_pool_bytes = reserved_high;
+  }
+#endif  // TF_CUDA_MALLOC_ASYNC_SUPPORTED
+  return stats;
 }
 
 bool GpuCudaMallocAsyncAllocator::ClearStats() {
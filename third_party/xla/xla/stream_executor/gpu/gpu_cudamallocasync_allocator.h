@@ -18,12 +18,14 @@ limitations under the License.
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "xla/stream_executor/stream_executor.h"  // IWYU pragma: keep
 #include "tsl/framework/allocator.h"
 #include "tsl/framework/device_id.h"
@@ -64,6 +66,11 @@ namespace stream_executor {
 // Here, the pool_size isn't the absolute max as for [Gpu]BFCAllocator.
 // The pool can grow above that up to the total GPU memory.  But the
 // driver can return the excess memory to other processes.
+// `TF_CUDA_MALLOC_ASYNC_RELEASE_THRESHOLD=nb_bytes` keeps a smaller local
+// pool than pool_size, so that more freed memory is returned to the driver.
+//
+// The stats report the memory held by the pool as `pool_bytes`, so the
+// memory kept free in the pool is `pool_bytes - bytes_in_use`.
 class GpuCudaMallocAsyncAllocator : public tsl::Allocator {
  public:
   explicit GpuCudaMallocAsyncAllocator(tsl::PlatformDeviceId platform_device_id,
@@ -97,6 +104,10 @@ class GpuCudaMallocAsyncAllocator : public tsl::Allocator {
  private:
   void PrintAllocatorStatisticsNoLock() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Records an allocation event for the memory profiler. Requires stats.
+  void AddTraceMe(absl::string_view traceme_name, const void* ptr,
+                  int64_t num_bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
 #if TF_CUDA_MALLOC_ASYNC_SUPPORTED
   StreamExecutor* stream_exec_;  // Not owned.
 
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "xla/stream_executor/integrations/gpu_virtual_mem_allocator.h"  // IWYU pragma: keep
 
+#include <algorithm>
+
 #include "absl/strings/str_format.h"  // IWYU pragma: keep
 #include "xla/stream_executor/stream_executor.h"  // IWYU pragma: keep
 #include "tsl/platform/numbers.h"  // IWYU pragma: keep
@@ -141,7 +143,14 @@ void* GpuVirtualMemAllocator::Alloc(size_t alignment, size_t num_bytes,
   if (num_bytes == 0) return nullptr;
   size_t padded_bytes = (num_bytes + granularity_ - 1) & ~(granularity_ - 1);
 
-  GpuDevicePtr next_va = vmem_.base + next_alloc_offset_;
+  // Use the first hole left by `Free` that is large enough, so that memory
+  // returned to the driver can be mapped again, or allocate at the end.
+  GpuDevicePtr next_va = vmem_.base;
+  auto insert_it = mappings_.begin();
+  for (; insert_it != mappings_.end(); ++insert_it) {
+    if (insert_it->va - next_va >= padded_bytes) break;
+    next_va = insert_it->va + insert_it->physical.bytes;
+  }
 
   // TODO(imintz): Attempt to extend the vmem allocation by reserving additional
   // virtual memory at the specific address at the end of the initial vmem
@@ -171,8 +180,9 @@ void* GpuVirtualMemAllocator::Alloc(size_t alignment, size_t num_bytes,
     GpuDriver::ReleaseMemoryHandle(&gpu_context_, std::move(handle));
     return nullptr;
   }
-  next_alloc_offset_ += handle.bytes;
-  mappings_.push_back({next_va, std::move(handle)});
+  next_alloc_offset_ =
+      std::max<size_t>(next_alloc_offset_, next_va + handle.bytes - vmem_.base);
+  mappings_.insert(insert_it, {next_va, std::move(handle)});
   VisitAlloc(reinterpret_cast<void*>(next_va), gpu_id_.value(), padded_bytes);
   *bytes_received = padded_bytes;
   return reinterpret_cast<void*>(next_va);
@@ -196,7 +206,7 @@ void GpuVirtualMemAllocator::Free(void* ptr, size_t num_bytes) {
   }
 
   int num_mappings_to_free = 0;
-  int total_bytes = 0;
+  size_t total_bytes = 0;
   for (auto it = mapping_it; it != mappings_.end() && total_bytes < num_bytes;
        ++it) {
     ++num_mappings_to_free;
@@ -218,12 +228,13 @@ void GpuVirtualMemAllocator::Free(void* ptr, size_t num_bytes) {
     GpuDriver::ReleaseMemoryHandle(&gpu_context_, std::move(it->physical));
   }
 
-  // Move back the next_alloc_offset_ if this free was at the end.
-  if (mapping_it + num_mappings_to_free == mappings_.end()) {
-    next_alloc_offset_ = mapping_it->va - vmem_.base;
-  }
-
   mappings_.erase(mapping_it, mapping_it + num_mappings_to_free);
+
+  // Move back the next_alloc_offset_ to the end of the last mapping.
+  next_alloc_offset_ =
+      mappings_.empty()
+          ? 0
+          : mappings_.back().va + mappings_.back().physical.bytes - vmem_.base;
   VisitFree(ptr, gpu_id_.value(), num_bytes);
 }
 
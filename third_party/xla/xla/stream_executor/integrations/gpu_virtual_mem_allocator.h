@@ -52,17 +52,13 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
   void* Alloc(size_t alignment, size_t num_bytes,
               size_t* bytes_received) override;
 
-  // Frees should only happen at the end of the contiguous memory allocations or
-  // else we introduce pointless fragmentation...But, this is supported. If the
-  // allocation happens at the end, then the next_alloc_offset_ is moved back,
-  // otherwise a hole is created.
+  // Unmaps and releases the physical memory of a previous allocation, which
+  // may span several adjacent allocations. If the allocation was at the end,
+  // then the next_alloc_offset_ is moved back, otherwise a hole is created.
   //
-  // Holes are not re-used, all allocations continue to come at the end of the
-  // next_alloc_offset_. To accommodate this, the virtual_address_space_size
-  // should be much larger than the max physical size of the allocator.
-  //
-  // In practice, since the BFC allocator coalesces adjacent AllocationRegions,
-  // this free function should never be invoked.
+  // Holes are re-used by later allocations that fit in them, so that the BFC
+  // allocator can return free regions to the driver (for example through
+  // garbage collection) without exhausting the virtual address space.
   void Free(void* ptr, size_t num_bytes) override;
 
   bool SupportsCoalescing() const override { return true; }
@@ -87,9 +83,9 @@ class GpuVirtualMemAllocator : public tsl::SubAllocator {
 
   // The virtual memory span held by this allocator.
   stream_executor::gpu::GpuDriver::VmemSpan vmem_;
-  // The next offset from the vmem base address that will be allocated. This
-  // corresponds to the size of physically pinned memory if holes haven't been
-  // created with "free".
+  // The offset from the vmem base address of the end of the last mapping. This
+  // corresponds to the size of physically pinned memory if there are no
+  // holes.
   size_t next_alloc_offset_ = 0;
 
   // Smallest allocation as determined by CUDA.
@@ -151,7 +151,27 @@ TEST(GpuVirtualMemAllocatorTest, FreeHole) {
       allocator->Alloc(/*alignment=*/0, /*num_bytes=*/k2MiB, &bytes_received);
   ASSERT_NE(third_alloc, nullptr);
 
-  // Expect that allocation still happens at the end.
+  // Expect that the hole is re-used.
+  ASSERT_EQ(third_alloc, first_alloc);
+}
+
+TEST(GpuVirtualMemAllocatorTest, FreeHoleTooSmall) {
+  auto allocator = CreateAllocator();
+  size_t bytes_received;  // Ignored in this test.
+  void* first_alloc =
+      allocator->Alloc(/*alignment=*/0, /*num_bytes=*/k2MiB, &bytes_received);
+  ASSERT_NE(first_alloc, nullptr);
+  void* second_alloc =
+      allocator->Alloc(/*alignment=*/0, /*num_bytes=*/k2MiB, &bytes_received);
+  ASSERT_NE(second_alloc, nullptr);
+
+  allocator->Free(first_alloc, k2MiB);
+
+  void* third_alloc = allocator->Alloc(
+      /*alignment=*/0, /*num_bytes=*/2 * k2MiB, &bytes_received);
+  ASSERT_NE(third_alloc, nullptr);
+
+  // Expect that the allocation happens at the end.
   ASSERT_EQ(third_alloc, reinterpret_cast<const char*>(second_alloc) + k2MiB);
 }
 